@@ -0,0 +1,196 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Network topology
+//
+//   s0 ---+                      +--- r0
+//         |      bottleneck      |
+//   s1 ---+--- left ------ right +--- r1
+//   ...   |                      |    ...
+//
+// - Each sender starts flows to all the receivers with a FlowWorkloadApplication,
+//   with Poisson arrivals that load the bottleneck at the given load.
+// - The flow sizes are drawn from the CDF file given with --cdfFile, whose mean
+//   must be given with --meanFlowSize, or from an exponential distribution.
+// - Each flow is sent on a new connection, or on persistent connections with
+//   --connectionMode=Persistent.
+// - The flows are logged to the file given with --flowLog, if any, and the mean
+//   and 99th percentile of the slowdowns of the completed flows are printed.
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpFlowWorkloadExample");
+
+/// The slowdowns of the completed flows
+static std::vector<double> g_slowdowns;
+
+/**
+ * Record the slowdown of a completed flow
+ * \param record the record of the flow
+ */
+static void
+FlowCompleted(const FlowWorkloadApplication::FlowRecord& record)
+{
+    g_slowdowns.push_back(record.slowdown);
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nHosts = 4;
+    std::string bottleneckRate = "1Gbps";
+    std::string accessRate = "10Gbps";
+    Time linkDelay = MicroSeconds(10);
+    double load = 0.6;
+    std::string cdfFile;
+    double flowSizeScale = 1;
+    double meanFlowSize = 100000;
+    uint64_t maxFlows = 250;
+    std::string flowLog;
+    std::string connectionMode = "PerFlow";
+    Time stopTime = Seconds(100);
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("nHosts", "Number of senders and of receivers", nHosts);
+    cmd.AddValue("bottleneckRate", "Rate of the bottleneck link", bottleneckRate);
+    cmd.AddValue("accessRate", "Rate of the access links", accessRate);
+    cmd.AddValue("linkDelay", "Delay of every link", linkDelay);
+    cmd.AddValue("load", "Load of the bottleneck link", load);
+    cmd.AddValue("cdfFile", "File holding the CDF of the flow sizes", cdfFile);
+    cmd.AddValue("flowSizeScale", "Bytes per unit of the sizes of the CDF file", flowSizeScale);
+    cmd.AddValue("meanFlowSize", "Mean flow size, in bytes", meanFlowSize);
+    cmd.AddValue("maxFlows", "Number of flows started by each sender", maxFlows);
+    cmd.AddValue("flowLog", "Prefix of the flow logs, one per sender", flowLog);
+    cmd.AddValue("connectionMode",
+                 "Connections of the flows (PerFlow, Persistent)",
+                 connectionMode);
+    cmd.AddValue("stopTime", "Time at which the simulation stops", stopTime);
+    cmd.Parse(argc, argv);
+
+    // datacenter settings: no delayed ACKs, a small minimum RTO, and a short
+    // TIME_WAIT, so that the ports of the closed connections are reused
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1448));
+    Config::SetDefault("ns3::TcpSocket::DelAckCount", UintegerValue(1));
+    Config::SetDefault("ns3::TcpSocketBase::MinRto", TimeValue(MilliSeconds(5)));
+    Config::SetDefault("ns3::TcpSocketBase::MaxSegLifetime", DoubleValue(0.001));
+
+    NodeContainer senders;
+    senders.Create(nHosts);
+    NodeContainer receivers;
+    receivers.Create(nHosts);
+    NodeContainer routers;
+    routers.Create(2);
+    InternetStackHelper stack;
+    stack.InstallAll();
+
+    PointToPointHelper bottleneck;
+    bottleneck.SetDeviceAttribute("DataRate", StringValue(bottleneckRate));
+    bottleneck.SetChannelAttribute("Delay", TimeValue(linkDelay));
+    PointToPointHelper access;
+    access.SetDeviceAttribute("DataRate", StringValue(accessRate));
+    access.SetChannelAttribute("Delay", TimeValue(linkDelay));
+
+    Ipv4AddressHelper address("10.1.0.0", "255.255.255.0");
+    address.Assign(bottleneck.Install(routers));
+    std::vector<Address> remotes;
+    for (uint32_t i = 0; i < nHosts; i++)
+    {
+        address.NewNetwork();
+        address.Assign(access.Install(senders.Get(i), routers.Get(0)));
+        address.NewNetwork();
+        Ipv4InterfaceContainer interfaces =
+            address.Assign(access.Install(receivers.Get(i), routers.Get(1)));
+        remotes.emplace_back(InetSocketAddress(interfaces.GetAddress(0), 5000));
+    }
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), 5000));
+    sinkHelper.SetAttribute("CloseOnPeerClose", BooleanValue(true));
+    ApplicationContainer sinkApps = sinkHelper.Install(receivers);
+
+    // the senders share the load of the bottleneck
+    DataRate rate(bottleneckRate);
+    double meanInterArrival = nHosts * 8 * meanFlowSize / (load * rate.GetBitRate());
+    Time baseRtt = 6 * linkDelay;
+
+    FlowWorkloadHelper sourceHelper("ns3::TcpSocketFactory", remotes);
+    if (cdfFile.empty())
+    {
+        std::string flowSize = "ns3::ExponentialRandomVariable[Mean=";
+        sourceHelper.SetAttribute("FlowSize",
+                                  StringValue(flowSize + std::to_string(meanFlowSize) + "]"));
+    }
+    else
+    {
+        sourceHelper.SetAttribute("FlowSizeCdfFile", StringValue(cdfFile));
+        sourceHelper.SetAttribute("FlowSizeScale", DoubleValue(flowSizeScale));
+    }
+    std::string interArrival = "ns3::ExponentialRandomVariable[Mean=";
+    sourceHelper.SetAttribute("InterArrival",
+                              StringValue(interArrival + std::to_string(meanInterArrival) + "]"));
+    sourceHelper.SetAttribute("MaxFlows", UintegerValue(maxFlows));
+    sourceHelper.SetAttribute("LinkRate", DataRateValue(rate));
+    sourceHelper.SetAttribute("BaseRtt", TimeValue(baseRtt));
+    sourceHelper.SetAttribute("ConnectionMode", StringValue(connectionMode));
+    ApplicationContainer sourceApps;
+    for (uint32_t i = 0; i < nHosts; i++)
+    {
+        if (!flowLog.empty())
+        {
+            sourceHelper.SetAttribute("FlowLog",
+                                      StringValue(flowLog + "-" + std::to_string(i) + ".log"));
+        }
+        sourceApps.Add(sourceHelper.Install(senders.Get(i)));
+    }
+    Config::ConnectWithoutContext("/NodeList/*/ApplicationList/*/$ns3::FlowWorkloadApplication/"
+                                  "FlowCompleted",
+                                  MakeCallback(&FlowCompleted));
+
+    sinkApps.Start(Seconds(0));
+    sourceApps.Start(Seconds(0.1));
+    sourceApps.Stop(stopTime);
+    Simulator::Stop(stopTime);
+
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    uint64_t nStarted = 0;
+    uint64_t nFailed = 0;
+    for (uint32_t i = 0; i < sourceApps.GetN(); i++)
+    {
+        Ptr<FlowWorkloadApplication> source =
+            DynamicCast<FlowWorkloadApplication>(sourceApps.Get(i));
+        nStarted += source->GetNStartedFlows();
+        nFailed += source->GetNFailedFlows();
+    }
+    std::cout << "Flows started: " << nStarted << ", completed: " << g_slowdowns.size()
+              << ", failed: " << nFailed << " in " << elapsed.count() << " s" << std::endl;
+    if (!g_slowdowns.empty())
+    {
+        double sum = 0;
+        for (double slowdown : g_slowdowns)
+        {
+            sum += slowdown;
+        }
+        auto p99 = g_slowdowns.begin() + g_slowdowns.size() * 99 / 100;
+        std::nth_element(g_slowdowns.begin(), p99, g_slowdowns.end());
+        std::cout << "Slowdown: mean " << sum / g_slowdowns.size() << ", 99th percentile "
+                  << *p99 << std::endl;
+    }
+
+    Simulator::Destroy();
+    return 0;
+}
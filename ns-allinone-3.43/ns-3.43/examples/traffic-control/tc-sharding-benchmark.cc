@@ -0,0 +1,149 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This example benchmarks the traffic control path of a high fan-in router,
+// with either a single root queue disc or an mq queue disc sharding the
+// traffic among several child queue discs.
+//
+// Network topology
+//
+//   s0 ----+
+//   s1 ----+
+//   ...    +---- router ------------------------------- sink
+//   sN-1 --+             point-to-point (bottleneck link)
+//                        bandwidth [40 Gbps], delay 10 us
+//
+// Each source sends flowsPerSource UDP flows, so that the bottleneck link is
+// overloaded by 10%. The root queue disc of the router on the bottleneck link
+// is a queueDiscType queue disc if shards is 0, or an mq queue disc sharding
+// the traffic among shards queueDiscType queue discs otherwise.
+//
+// The program prints the goodput, the packets dropped by the traffic control
+// layer, and the wall clock time of the simulation. For instance, compare:
+//
+//    ./ns3 run "tc-sharding-benchmark --bottleneckRate=100Gbps"
+//    ./ns3 run "tc-sharding-benchmark --bottleneckRate=100Gbps --shards=4"
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/traffic-control-module.h"
+
+#include <iomanip>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcShardingBenchmark");
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nSources = 8;
+    uint32_t flowsPerSource = 16;
+    uint32_t shards = 0;
+    uint32_t batchSize = 16;
+    uint32_t packetSize = 1448;
+    std::string bottleneckRate = "40Gbps";
+    std::string queueDiscType = "ns3::FqCoDelQueueDisc";
+    double simTime = 0.05;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("nSources", "Number of source nodes", nSources);
+    cmd.AddValue("flowsPerSource", "Number of UDP flows per source node", flowsPerSource);
+    cmd.AddValue("shards",
+                 "Number of shards of the mq queue disc (0 for a single queue disc)",
+                 shards);
+    cmd.AddValue("batchSize", "Number of packets dequeued at a time from a shard", batchSize);
+    cmd.AddValue("packetSize", "Size of the UDP payloads, in bytes", packetSize);
+    cmd.AddValue("bottleneckRate", "Rate of the bottleneck link", bottleneckRate);
+    cmd.AddValue("queueDiscType", "Type of the (child) queue discs", queueDiscType);
+    cmd.AddValue("simTime", "Simulation time, in seconds", simTime);
+    cmd.Parse(argc, argv);
+
+    DataRate rate(bottleneckRate);
+
+    NodeContainer sources;
+    sources.Create(nSources);
+    Ptr<Node> router = CreateObject<Node>();
+    Ptr<Node> sink = CreateObject<Node>();
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", DataRateValue(rate));
+    p2p.SetChannelAttribute("Delay", StringValue("10us"));
+
+    InternetStackHelper stack;
+    stack.InstallAll();
+
+    // the root queue disc of the router on the bottleneck link
+    NetDeviceContainer bottleneck = p2p.Install(router, sink);
+    TrafficControlHelper tch;
+    if (shards == 0)
+    {
+        tch.SetRootQueueDisc(queueDiscType);
+    }
+    else
+    {
+        uint16_t handle = tch.SetRootQueueDisc("ns3::MqQueueDisc",
+                                               "Sharding",
+                                               BooleanValue(true),
+                                               "BatchSize",
+                                               UintegerValue(batchSize));
+        TrafficControlHelper::ClassIdList cls =
+            tch.AddQueueDiscClasses(handle, shards, "ns3::QueueDiscClass");
+        tch.AddChildQueueDiscs(handle, cls, queueDiscType);
+    }
+    QueueDiscContainer qdiscs = tch.Install(bottleneck.Get(0));
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer sinkInterfaces = address.Assign(bottleneck);
+    for (uint32_t i = 0; i < nSources; i++)
+    {
+        address.NewNetwork();
+        address.Assign(p2p.Install(sources.Get(i), router));
+    }
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    uint16_t port = 9;
+    PacketSinkHelper sinkHelper("ns3::UdpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    ApplicationContainer sinkApp = sinkHelper.Install(sink);
+    sinkApp.Start(Seconds(0));
+
+    // overload the bottleneck link by 10%
+    uint64_t flowRate = rate.GetBitRate() * 11 / 10 / (nSources * flowsPerSource);
+    OnOffHelper onoff("ns3::UdpSocketFactory",
+                      InetSocketAddress(sinkInterfaces.GetAddress(1), port));
+    onoff.SetConstantRate(DataRate(flowRate), packetSize);
+    ApplicationContainer sourceApps;
+    for (uint32_t i = 0; i < nSources; i++)
+    {
+        for (uint32_t f = 0; f < flowsPerSource; f++)
+        {
+            sourceApps.Add(onoff.Install(sources.Get(i)));
+        }
+    }
+    sourceApps.Start(Seconds(0));
+    sourceApps.Stop(Seconds(simTime));
+
+    Simulator::Stop(Seconds(simTime));
+    SystemWallClockMs wallClock;
+    wallClock.Start();
+    Simulator::Run();
+    int64_t elapsed = std::max<int64_t>(wallClock.End(), 1);
+
+    uint64_t rxBytes = DynamicCast<PacketSink>(sinkApp.Get(0))->GetTotalRx();
+    QueueDisc::Stats stats = qdiscs.Get(0)->GetStats();
+    std::cout << std::fixed << std::setprecision(2)
+              << (shards ? std::to_string(shards) + " shards of " : "single ") << queueDiscType
+              << " at " << bottleneckRate << ": goodput " << rxBytes * 8 / simTime / 1e9
+              << " Gbps, " << stats.nTotalDroppedPackets << " packets dropped out of "
+              << stats.nTotalReceivedPackets << ", " << elapsed << " ms elapsed ("
+              << stats.nTotalReceivedPackets / elapsed << " packets/ms)" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
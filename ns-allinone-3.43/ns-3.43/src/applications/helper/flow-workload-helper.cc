@@ -0,0 +1,42 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "flow-workload-helper.h"
+
+#include <ns3/flow-workload-application.h>
+#include <ns3/string.h>
+
+namespace ns3
+{
+
+FlowWorkloadHelper::FlowWorkloadHelper(const std::string& protocol, const Address& address)
+    : ApplicationHelper("ns3::FlowWorkloadApplication")
+{
+    m_factory.Set("Protocol", StringValue(protocol));
+    m_factory.Set("Remote", AddressValue(address));
+}
+
+FlowWorkloadHelper::FlowWorkloadHelper(const std::string& protocol,
+                                       const std::vector<Address>& remotes)
+    : ApplicationHelper("ns3::FlowWorkloadApplication")
+{
+    NS_ABORT_MSG_IF(remotes.empty(), "No remote to send flows to");
+    m_factory.Set("Protocol", StringValue(protocol));
+    m_factory.Set("Remote", AddressValue(remotes.front()));
+    m_remotes.assign(remotes.begin() + 1, remotes.end());
+}
+
+Ptr<Application>
+FlowWorkloadHelper::DoInstall(Ptr<Node> node)
+{
+    Ptr<Application> app = ApplicationHelper::DoInstall(node);
+    Ptr<FlowWorkloadApplication> workload = DynamicCast<FlowWorkloadApplication>(app);
+    for (const auto& remote : m_remotes)
+    {
+        workload->AddRemote(remote);
+    }
+    return app;
+}
+
+} // namespace ns3
@@ -0,0 +1,53 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef FLOW_WORKLOAD_HELPER_H
+#define FLOW_WORKLOAD_HELPER_H
+
+#include <ns3/application-helper.h>
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup flowworkload
+ * \brief A helper to make it easier to instantiate an ns3::FlowWorkloadApplication
+ * on a set of nodes.
+ */
+class FlowWorkloadHelper : public ApplicationHelper
+{
+  public:
+    /**
+     * Create a FlowWorkloadHelper to make it easier to work with FlowWorkloadApplications
+     *
+     * \param protocol the name of the protocol to use to send traffic
+     *        by the applications. This string identifies the socket
+     *        factory type used to create sockets for the applications.
+     *        A typical value would be ns3::TcpSocketFactory.
+     * \param address the address of the remote node to send traffic
+     *        to.
+     */
+    FlowWorkloadHelper(const std::string& protocol, const Address& address);
+
+    /**
+     * Create a FlowWorkloadHelper whose applications send flows to several remotes
+     *
+     * \param protocol the name of the protocol to use to send traffic
+     *        by the applications.
+     * \param remotes the addresses of the remote nodes to send traffic to.
+     */
+    FlowWorkloadHelper(const std::string& protocol, const std::vector<Address>& remotes);
+
+  protected:
+    Ptr<Application> DoInstall(Ptr<Node> node) override;
+
+  private:
+    std::vector<Address> m_remotes; //!< Remotes added to each application
+};
+
+} // namespace ns3
+
+#endif /* FLOW_WORKLOAD_HELPER_H */
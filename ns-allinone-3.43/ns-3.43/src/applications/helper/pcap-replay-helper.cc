@@ -0,0 +1,22 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "pcap-replay-helper.h"
+
+#include <ns3/string.h>
+
+namespace ns3
+{
+
+PcapReplayHelper::PcapReplayHelper(const std::string& protocol,
+                                   const Address& address,
+                                   const std::string& traceFile)
+    : ApplicationHelper("ns3::PcapReplayApplication")
+{
+    m_factory.Set("Protocol", StringValue(protocol));
+    m_factory.Set("Remote", AddressValue(address));
+    m_factory.Set("TraceFile", StringValue(traceFile));
+}
+
+} // namespace ns3
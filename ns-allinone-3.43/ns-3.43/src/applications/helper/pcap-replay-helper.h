@@ -0,0 +1,39 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef PCAP_REPLAY_HELPER_H
+#define PCAP_REPLAY_HELPER_H
+
+#include <ns3/application-helper.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup pcapreplay
+ * \brief A helper to make it easier to instantiate an ns3::PcapReplayApplication
+ * on a set of nodes.
+ */
+class PcapReplayHelper : public ApplicationHelper
+{
+  public:
+    /**
+     * Create a PcapReplayHelper to make it easier to work with PcapReplayApplications
+     *
+     * \param protocol the name of the protocol to use to send traffic
+     *        by the applications. This string identifies the socket
+     *        factory type used to create sockets for the applications.
+     *        A typical value would be ns3::UdpSocketFactory.
+     * \param address the address of the remote node to send traffic
+     *        to.
+     * \param traceFile the name of the pcap file to replay
+     */
+    PcapReplayHelper(const std::string& protocol,
+                     const Address& address,
+                     const std::string& traceFile);
+};
+
+} // namespace ns3
+
+#endif /* PCAP_REPLAY_HELPER_H */
@@ -0,0 +1,724 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "flow-workload-application.h"
+
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowWorkloadApplication");
+
+NS_OBJECT_ENSURE_REGISTERED(FlowWorkloadApplication);
+
+namespace
+{
+
+/// The magic number at the start of a flow log
+constexpr char FLOW_LOG_MAGIC[8] = {'N', 'S', '3', 'F', 'L', 'O', 'W', '1'};
+
+/// The number of records buffered before they are written to the flow log
+constexpr std::size_t FLOW_LOG_BUFFER_SIZE = 4096;
+
+} // namespace
+
+static_assert(sizeof(FlowWorkloadApplication::FlowRecord) == 40,
+              "The records of the flow log must not be padded");
+
+TypeId
+FlowWorkloadApplication::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::FlowWorkloadApplication")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<FlowWorkloadApplication>()
+            .AddAttribute("Protocol",
+                          "The type of protocol to use. It must provide stream sockets.",
+                          TypeIdValue(TcpSocketFactory::GetTypeId()),
+                          MakeTypeIdAccessor(&FlowWorkloadApplication::m_tid),
+                          MakeTypeIdChecker())
+            .AddAttribute("Remote",
+                          "The address of the destination. More destinations can be added "
+                          "with AddRemote.",
+                          AddressValue(),
+                          MakeAddressAccessor(&FlowWorkloadApplication::m_peer),
+                          MakeAddressChecker())
+            .AddAttribute("FlowSize",
+                          "A RandomVariableStream used to pick the size of the flows, in bytes, "
+                          "if FlowSizeCdfFile is not set.",
+                          StringValue("ns3::ConstantRandomVariable[Constant=100000]"),
+                          MakePointerAccessor(&FlowWorkloadApplication::m_flowSize),
+                          MakePointerChecker<RandomVariableStream>())
+            .AddAttribute("FlowSizeCdfFile",
+                          "The name of a file holding the CDF of the flow sizes, one point per "
+                          "line: the size first, the cumulative probability last. Empty lines "
+                          "and text after a '#' are ignored. The sizes are interpolated.",
+                          StringValue(""),
+                          MakeStringAccessor(&FlowWorkloadApplication::m_flowSizeCdfFile),
+                          MakeStringChecker())
+            .AddAttribute("FlowSizeScale",
+                          "The number of bytes per unit of the sizes of FlowSizeCdfFile "
+                          "(e.g., the packet size, if the sizes are in packets).",
+                          DoubleValue(1),
+                          MakeDoubleAccessor(&FlowWorkloadApplication::m_flowSizeScale),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("InterArrival",
+                          "A RandomVariableStream used to pick the time between the arrivals "
+                          "of the flows, in seconds.",
+                          StringValue("ns3::ExponentialRandomVariable[Mean=0.01]"),
+                          MakePointerAccessor(&FlowWorkloadApplication::m_interArrival),
+                          MakePointerChecker<RandomVariableStream>())
+            .AddAttribute("MaxFlows",
+                          "The number of flows to start. The value zero means that there is "
+                          "no limit.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FlowWorkloadApplication::m_maxFlows),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("ConnectionMode",
+                          "Whether each flow is sent on a new connection, closed once the flow "
+                          "is completed, or the flows are sent on persistent connections.",
+                          EnumValue(FlowWorkloadApplication::PER_FLOW),
+                          MakeEnumAccessor<ConnectionMode>(
+                              &FlowWorkloadApplication::m_connectionMode),
+                          MakeEnumChecker(FlowWorkloadApplication::PER_FLOW,
+                                          "PerFlow",
+                                          FlowWorkloadApplication::PERSISTENT,
+                                          "Persistent"))
+            .AddAttribute("MaxConnections",
+                          "The maximum number of connections to each destination. The flows "
+                          "arriving when all of them are busy wait for one to become idle, or "
+                          "to close. The value zero means that there is no limit.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FlowWorkloadApplication::m_maxConnections),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("LinkRate",
+                          "The rate used to compute the ideal completion time of the flows.",
+                          DataRateValue(DataRate("1Gbps")),
+                          MakeDataRateAccessor(&FlowWorkloadApplication::m_linkRate),
+                          MakeDataRateChecker())
+            .AddAttribute("BaseRtt",
+                          "The round trip time added to the ideal completion time of the flows.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&FlowWorkloadApplication::m_baseRtt),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("FlowLog",
+                          "The name of the binary file the completed and failed flows are "
+                          "written to. If empty, the flows are not logged.",
+                          StringValue(""),
+                          MakeStringAccessor(&FlowWorkloadApplication::m_flowLogFile),
+                          MakeStringChecker())
+            .AddTraceSource("FlowCompleted",
+                            "A flow is completed",
+                            MakeTraceSourceAccessor(&FlowWorkloadApplication::m_flowCompletedTrace),
+                            "ns3::FlowWorkloadApplication::FlowTracedCallback");
+    return tid;
+}
+
+FlowWorkloadApplication::FlowWorkloadApplication()
+    : m_running(false),
+      m_nStarted(0),
+      m_nCompleted(0),
+      m_nFailed(0),
+      m_nConnections(0),
+      m_nOpenConnections(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_flowSizeCdf = CreateObject<EmpiricalRandomVariable>();
+    m_flowSizeCdf->SetInterpolate(true);
+    m_remoteRv = CreateObject<UniformRandomVariable>();
+}
+
+FlowWorkloadApplication::~FlowWorkloadApplication()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FlowWorkloadApplication::AddRemote(const Address& address)
+{
+    NS_LOG_FUNCTION(this << address);
+    m_addedRemotes.push_back(address);
+}
+
+uint64_t
+FlowWorkloadApplication::GetNStartedFlows() const
+{
+    return m_nStarted;
+}
+
+uint64_t
+FlowWorkloadApplication::GetNCompletedFlows() const
+{
+    return m_nCompleted;
+}
+
+uint64_t
+FlowWorkloadApplication::GetNFailedFlows() const
+{
+    return m_nFailed;
+}
+
+uint64_t
+FlowWorkloadApplication::GetNConnections() const
+{
+    return m_nConnections;
+}
+
+uint32_t
+FlowWorkloadApplication::GetNOpenConnections() const
+{
+    return m_nOpenConnections;
+}
+
+int64_t
+FlowWorkloadApplication::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_flowSize->SetStream(stream);
+    m_flowSizeCdf->SetStream(stream + 1);
+    m_interArrival->SetStream(stream + 2);
+    m_remoteRv->SetStream(stream + 3);
+    return 4;
+}
+
+void
+FlowWorkloadApplication::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_connections.clear();
+    m_freeSlots.clear();
+    m_socketIndex.clear();
+    m_remotes.clear();
+    if (m_flowLog.is_open())
+    {
+        FlushFlowLog();
+        m_flowLog.close();
+    }
+    // chain up
+    Application::DoDispose();
+}
+
+void
+FlowWorkloadApplication::StartApplication()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_remotes.empty())
+    {
+        if (!m_peer.IsInvalid())
+        {
+            m_remotes.emplace_back();
+            m_remotes.back().address = m_peer;
+        }
+        for (const auto& address : m_addedRemotes)
+        {
+            m_remotes.emplace_back();
+            m_remotes.back().address = address;
+        }
+        NS_ABORT_MSG_IF(m_remotes.empty(), "'Remote' attribute not properly set");
+
+        if (!m_flowSizeCdfFile.empty())
+        {
+            ReadFlowSizeCdf();
+        }
+    }
+
+    if (!m_flowLogFile.empty() && !m_flowLog.is_open())
+    {
+        m_flowLog.open(m_flowLogFile, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_flowLog)
+        {
+            NS_FATAL_ERROR("Cannot open flow log " << m_flowLogFile);
+        }
+        m_flowLog.write(FLOW_LOG_MAGIC, sizeof(FLOW_LOG_MAGIC));
+        m_logBuffer.reserve(FLOW_LOG_BUFFER_SIZE);
+    }
+
+    m_running = true;
+    if (m_maxFlows == 0 || m_nStarted < m_maxFlows)
+    {
+        m_arrivalEvent = Simulator::Schedule(Seconds(m_interArrival->GetValue()),
+                                             &FlowWorkloadApplication::StartFlow,
+                                             this);
+    }
+}
+
+void
+FlowWorkloadApplication::StopApplication()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_running = false;
+    m_arrivalEvent.Cancel();
+
+    // the flows in progress are not completed
+    for (uint32_t index = 0; index < m_connections.size(); index++)
+    {
+        if (m_connections[index].socket)
+        {
+            ReleaseConnection(index, true);
+        }
+    }
+    m_connections.clear();
+    m_freeSlots.clear();
+    for (auto& remote : m_remotes)
+    {
+        remote.idle.clear();
+        remote.pending.clear();
+    }
+
+    if (m_flowLog.is_open())
+    {
+        FlushFlowLog();
+        m_flowLog.flush();
+    }
+}
+
+void
+FlowWorkloadApplication::ReadFlowSizeCdf()
+{
+    NS_LOG_FUNCTION(this);
+
+    std::ifstream file(m_flowSizeCdfFile);
+    if (!file)
+    {
+        NS_FATAL_ERROR("Cannot open flow size CDF file " << m_flowSizeCdfFile);
+    }
+
+    std::string line;
+    uint32_t nPoints = 0;
+    while (std::getline(file, line))
+    {
+        std::istringstream iss(line.substr(0, line.find('#')));
+        std::vector<double> fields;
+        double field;
+        while (iss >> field)
+        {
+            fields.push_back(field);
+        }
+        if (fields.empty())
+        {
+            continue;
+        }
+        NS_ABORT_MSG_IF(fields.size() < 2,
+                        "Invalid line in " << m_flowSizeCdfFile << ": \"" << line << "\"");
+        m_flowSizeCdf->CDF(fields.front() * m_flowSizeScale, fields.back());
+        nPoints++;
+    }
+    NS_ABORT_MSG_IF(nPoints == 0, "No CDF point in " << m_flowSizeCdfFile);
+    NS_LOG_DEBUG("Read " << nPoints << " CDF points from " << m_flowSizeCdfFile);
+}
+
+void
+FlowWorkloadApplication::StartFlow()
+{
+    NS_LOG_FUNCTION(this);
+
+    double size = m_flowSizeCdfFile.empty() ? m_flowSize->GetValue() : m_flowSizeCdf->GetValue();
+
+    Flow flow;
+    flow.id = m_nStarted++;
+    flow.size = std::max<uint64_t>(1, std::llround(size));
+    flow.start = Simulator::Now();
+    flow.remote = m_remotes.size() > 1 ? m_remoteRv->GetInteger(0, m_remotes.size() - 1) : 0;
+    NS_LOG_DEBUG("Flow " << flow.id << " of " << flow.size << " bytes to remote " << flow.remote);
+    Dispatch(flow);
+
+    if (m_maxFlows == 0 || m_nStarted < m_maxFlows)
+    {
+        m_arrivalEvent = Simulator::Schedule(Seconds(m_interArrival->GetValue()),
+                                             &FlowWorkloadApplication::StartFlow,
+                                             this);
+    }
+}
+
+void
+FlowWorkloadApplication::Dispatch(const Flow& flow)
+{
+    NS_LOG_FUNCTION(this << flow.id);
+
+    Remote& remote = m_remotes[flow.remote];
+    if (m_connectionMode == PERSISTENT && !remote.idle.empty())
+    {
+        uint32_t index = remote.idle.back();
+        remote.idle.pop_back();
+        Assign(index, flow);
+    }
+    else if (m_maxConnections == 0 || remote.nConnections < m_maxConnections)
+    {
+        OpenConnection(flow);
+    }
+    else
+    {
+        NS_LOG_LOGIC("All the connections to remote " << flow.remote << " are busy");
+        remote.pending.push_back(flow);
+    }
+}
+
+void
+FlowWorkloadApplication::OpenConnection(const Flow& flow)
+{
+    NS_LOG_FUNCTION(this << flow.id);
+
+    Ptr<Socket> socket = Socket::CreateSocket(GetNode(), m_tid);
+    if (socket->GetSocketType() != Socket::NS3_SOCK_STREAM)
+    {
+        NS_FATAL_ERROR("Using FlowWorkloadApplication with an incompatible socket type. "
+                       "FlowWorkloadApplication requires SOCK_STREAM. "
+                       "In other words, use TCP instead of UDP.");
+    }
+
+    const Address& address = m_remotes[flow.remote].address;
+    int ret = Inet6SocketAddress::IsMatchingType(address) ? socket->Bind6() : socket->Bind();
+    if (ret == -1)
+    {
+        // the ephemeral ports of the node may be held by connections not yet
+        // closed by their remote, or in TIME_WAIT
+        NS_LOG_WARN("Cannot bind a socket to remote " << flow.remote << ", flow " << flow.id
+                                                      << " is not completed");
+        FailFlow(flow);
+        return;
+    }
+    socket->SetConnectCallback(MakeCallback(&FlowWorkloadApplication::ConnectionSucceeded, this),
+                               MakeCallback(&FlowWorkloadApplication::ConnectionFailed, this));
+    socket->SetCloseCallbacks(MakeCallback(&FlowWorkloadApplication::ConnectionClosed, this),
+                              MakeCallback(&FlowWorkloadApplication::ConnectionError, this));
+    socket->SetSendCallback(MakeCallback(&FlowWorkloadApplication::DataSend, this));
+
+    uint32_t index;
+    if (m_freeSlots.empty())
+    {
+        index = m_connections.size();
+        m_connections.emplace_back();
+    }
+    else
+    {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    Connection& conn = m_connections[index];
+    conn.socket = socket;
+    conn.remote = flow.remote;
+    m_socketIndex[PeekPointer(socket)] = index;
+    m_remotes[flow.remote].nConnections++;
+    m_nConnections++;
+    m_nOpenConnections++;
+    Assign(index, flow);
+
+    if (socket->Connect(address) == -1)
+    {
+        // e.g., no route to the remote
+        NS_LOG_WARN("Cannot connect to remote " << flow.remote << ", flow " << flow.id
+                                                << " is not completed");
+        FailFlow(flow);
+        ReleaseConnection(index, false);
+        return;
+    }
+    socket->ShutdownRecv();
+}
+
+void
+FlowWorkloadApplication::ReleaseConnection(uint32_t index, bool close)
+{
+    NS_LOG_FUNCTION(this << index << close);
+
+    Connection& conn = m_connections[index];
+    Ptr<Socket> socket = conn.socket;
+    socket->SetConnectCallback(MakeNullCallback<void, Ptr<Socket>>(),
+                               MakeNullCallback<void, Ptr<Socket>>());
+    socket->SetCloseCallbacks(MakeNullCallback<void, Ptr<Socket>>(),
+                              MakeNullCallback<void, Ptr<Socket>>());
+    socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+    if (close)
+    {
+        socket->Close();
+    }
+
+    m_socketIndex.erase(PeekPointer(socket));
+    m_remotes[conn.remote].nConnections--;
+    m_nOpenConnections--;
+    conn = Connection();
+    m_freeSlots.push_back(index);
+}
+
+void
+FlowWorkloadApplication::ServePending(uint32_t remote)
+{
+    NS_LOG_FUNCTION(this << remote);
+
+    // the pending flows whose connection cannot be opened fail, and the next
+    // ones are served
+    Remote& r = m_remotes[remote];
+    while (m_running && !r.pending.empty() &&
+           (m_maxConnections == 0 || r.nConnections < m_maxConnections))
+    {
+        Flow next = r.pending.front();
+        r.pending.pop_front();
+        OpenConnection(next);
+    }
+}
+
+void
+FlowWorkloadApplication::DropConnection(Ptr<Socket> socket, bool close)
+{
+    NS_LOG_FUNCTION(this << socket << close);
+
+    auto it = m_socketIndex.find(PeekPointer(socket));
+    if (it == m_socketIndex.end())
+    {
+        return;
+    }
+    uint32_t index = it->second;
+    Connection& conn = m_connections[index];
+    uint32_t remote = conn.remote;
+    if (conn.busy)
+    {
+        NS_LOG_WARN("Connection to remote " << remote << " lost, flow " << conn.flow.id
+                                            << " is not completed");
+        FailFlow(conn.flow);
+    }
+    else if (m_connectionMode == PERSISTENT)
+    {
+        auto& idle = m_remotes[remote].idle;
+        idle.erase(std::find(idle.begin(), idle.end(), index));
+    }
+    ReleaseConnection(index, close);
+    ServePending(remote);
+}
+
+void
+FlowWorkloadApplication::Assign(uint32_t index, const Flow& flow)
+{
+    NS_LOG_FUNCTION(this << index << flow.id);
+
+    Connection& conn = m_connections[index];
+    conn.busy = true;
+    conn.flow = flow;
+    conn.unsent = flow.size;
+    if (conn.connected)
+    {
+        SendData(conn);
+    }
+}
+
+void
+FlowWorkloadApplication::SendData(Connection& conn)
+{
+    NS_LOG_FUNCTION(this << conn.flow.id);
+
+    while (conn.unsent > 0)
+    {
+        uint32_t available = conn.socket->GetTxAvailable();
+        if (available == 0)
+        {
+            break;
+        }
+        // the payload is not allocated, so fill the buffer with a single packet
+        uint32_t toSend = std::min<uint64_t>(conn.unsent, available);
+        int actual = conn.socket->Send(Create<Packet>(toSend));
+        if (actual <= 0)
+        {
+            break;
+        }
+        conn.unsent -= actual;
+    }
+}
+
+void
+FlowWorkloadApplication::CompleteFlow(uint32_t index)
+{
+    Connection& conn = m_connections[index];
+    NS_LOG_FUNCTION(this << index << conn.flow.id);
+
+    const Flow& flow = conn.flow;
+    Time fct = Simulator::Now() - flow.start;
+    Time ideal = m_baseRtt;
+    if (m_linkRate.GetBitRate() > 0)
+    {
+        ideal += Seconds(flow.size * 8.0 / m_linkRate.GetBitRate());
+    }
+
+    FlowRecord record;
+    record.id = flow.id;
+    record.size = flow.size;
+    record.start = flow.start.GetNanoSeconds();
+    record.fct = fct.GetNanoSeconds();
+    record.slowdown = ideal.IsStrictlyPositive() ? fct.GetDouble() / ideal.GetDouble() : 0;
+    record.remote = flow.remote;
+    m_nCompleted++;
+    conn.busy = false;
+    uint32_t remote = conn.remote;
+
+    m_flowCompletedTrace(record);
+    LogFlow(record);
+
+    if (m_connectionMode == PER_FLOW)
+    {
+        ReleaseConnection(index, true);
+        ServePending(remote);
+    }
+    else if (!m_remotes[remote].pending.empty())
+    {
+        Flow next = m_remotes[remote].pending.front();
+        m_remotes[remote].pending.pop_front();
+        Assign(index, next);
+    }
+    else
+    {
+        m_remotes[remote].idle.push_back(index);
+    }
+}
+
+void
+FlowWorkloadApplication::FailFlow(const Flow& flow)
+{
+    NS_LOG_FUNCTION(this << flow.id);
+
+    FlowRecord record;
+    record.id = flow.id;
+    record.size = flow.size;
+    record.start = flow.start.GetNanoSeconds();
+    record.fct = -1;
+    record.slowdown = 0;
+    record.remote = flow.remote;
+    m_nFailed++;
+    LogFlow(record);
+}
+
+void
+FlowWorkloadApplication::LogFlow(const FlowRecord& record)
+{
+    if (m_flowLog.is_open())
+    {
+        m_logBuffer.push_back(record);
+        if (m_logBuffer.size() >= FLOW_LOG_BUFFER_SIZE)
+        {
+            FlushFlowLog();
+        }
+    }
+}
+
+void
+FlowWorkloadApplication::FlushFlowLog()
+{
+    NS_LOG_FUNCTION(this << m_logBuffer.size());
+
+    m_flowLog.write(reinterpret_cast<const char*>(m_logBuffer.data()),
+                    m_logBuffer.size() * sizeof(FlowRecord));
+    m_logBuffer.clear();
+}
+
+std::vector<FlowWorkloadApplication::FlowRecord>
+FlowWorkloadApplication::ReadFlowLog(const std::string& filename)
+{
+    NS_LOG_FUNCTION(filename);
+
+    std::vector<FlowRecord> records;
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        NS_LOG_WARN("Cannot open flow log " << filename);
+        return records;
+    }
+
+    std::streamoff size = file.tellg();
+    char magic[sizeof(FLOW_LOG_MAGIC)];
+    file.seekg(0);
+    if (size < static_cast<std::streamoff>(sizeof(magic)) || !file.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, FLOW_LOG_MAGIC, sizeof(magic)) != 0)
+    {
+        NS_LOG_WARN(filename << " is not a flow log");
+        return records;
+    }
+
+    records.resize((size - sizeof(magic)) / sizeof(FlowRecord));
+    file.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(FlowRecord));
+    return records;
+}
+
+void
+FlowWorkloadApplication::ConnectionSucceeded(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+
+    auto it = m_socketIndex.find(PeekPointer(socket));
+    NS_ASSERT(it != m_socketIndex.end());
+    Connection& conn = m_connections[it->second];
+    conn.connected = true;
+    conn.txBufferSize = socket->GetTxAvailable();
+    if (conn.busy)
+    {
+        SendData(conn);
+    }
+}
+
+void
+FlowWorkloadApplication::ConnectionFailed(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    DropConnection(socket, false);
+}
+
+void
+FlowWorkloadApplication::ConnectionClosed(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    // the remote will not receive more data, complete the close of the connection
+    DropConnection(socket, true);
+}
+
+void
+FlowWorkloadApplication::ConnectionError(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    DropConnection(socket, false);
+}
+
+void
+FlowWorkloadApplication::DataSend(Ptr<Socket> socket, uint32_t available)
+{
+    NS_LOG_FUNCTION(this << socket << available);
+
+    auto it = m_socketIndex.find(PeekPointer(socket));
+    if (it == m_socketIndex.end())
+    {
+        return;
+    }
+    uint32_t index = it->second;
+    Connection& conn = m_connections[index];
+    if (!conn.connected || !conn.busy)
+    {
+        return;
+    }
+    if (conn.unsent > 0)
+    {
+        SendData(conn);
+    }
+    // the flow is completed once all its bytes are acknowledged
+    if (conn.unsent == 0 && socket->GetTxAvailable() == conn.txBufferSize)
+    {
+        CompleteFlow(index);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,354 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef FLOW_WORKLOAD_APPLICATION_H
+#define FLOW_WORKLOAD_APPLICATION_H
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class Socket;
+class RandomVariableStream;
+class EmpiricalRandomVariable;
+class UniformRandomVariable;
+
+/**
+ * \ingroup applications
+ * \defgroup flowworkload FlowWorkloadApplication
+ *
+ * This traffic generator starts many finite flows and measures their
+ * completion times.
+ */
+
+/**
+ * \ingroup flowworkload
+ *
+ * \brief Generate a workload of finite TCP flows and record their
+ * completion times.
+ *
+ * Flows arrive at the intervals drawn from the "InterArrival" random
+ * variable (exponential, i.e., Poisson arrivals, by default), each one to
+ * a remote drawn uniformly among the remotes of the application.  The size
+ * of a flow is drawn from the CDF read from "FlowSizeCdfFile", if set, or
+ * from the "FlowSize" random variable otherwise.
+ *
+ * With the default "ConnectionMode", PerFlow, each flow is sent on a new
+ * connection, which is closed once the flow is completed.  With
+ * Persistent, the flows are multiplexed on persistent connections: a flow
+ * is sent on an idle connection to its remote, if any, or on a new
+ * connection.  In both modes, a flow arriving when there are
+ * "MaxConnections" busy connections to its remote waits for one of them,
+ * and its completion time includes the wait.  The connections are kept in
+ * a pool of slots, recycled when the connections close, hence the memory
+ * of the application is bounded by the number of concurrent connections,
+ * not by the number of flows, and a single event is pending for the
+ * arrivals.  The remotes only need to accept the connections and read the
+ * data, e.g., with a PacketSink.
+ *
+ * A connection that fails to open, is reset, reaches its retransmission
+ * limit or is closed by its remote before its flow is completed loses the
+ * flow, which is counted by GetNFailedFlows, and its slot is released.
+ *
+ * In PerFlow mode, a connection holds an ephemeral port of the node until
+ * both ends have closed it and its TIME_WAIT state (two "MaxSegLifetime"
+ * of the TCP socket) has expired.  As a node has 16384 ephemeral ports,
+ * many flows require remotes that close the connections closed by their
+ * peer (e.g., a PacketSink with "CloseOnPeerClose") and a short
+ * MaxSegLifetime.  A flow arriving when no port is free fails as well.
+ *
+ * A flow completes when all its bytes are acknowledged.  Its completion
+ * time (FCT) is measured from its arrival, and its slowdown is the FCT
+ * divided by the ideal FCT, i.e., "BaseRtt" plus the transmission time of
+ * the flow at "LinkRate".  The completed flows are reported by the
+ * "FlowCompleted" trace source and, if "FlowLog" is set, written to a
+ * binary log of fixed-size records, which ReadFlowLog reads back.  The
+ * failed flows are written to the log too, with a negative FCT.
+ */
+class FlowWorkloadApplication : public Application
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    FlowWorkloadApplication();
+    ~FlowWorkloadApplication() override;
+
+    /**
+     * \brief How the flows are mapped to connections
+     */
+    enum ConnectionMode
+    {
+        PER_FLOW,  //!< Each flow is sent on a new connection
+        PERSISTENT //!< The flows are sent on persistent connections
+    };
+
+    /**
+     * \brief A completed or failed flow, as written to the flow log
+     */
+    struct FlowRecord
+    {
+        uint64_t id;     //!< Identifier of the flow, in order of arrival
+        uint64_t size;   //!< Size of the flow, in bytes
+        int64_t start;   //!< Arrival time of the flow, in nanoseconds
+        int64_t fct;     //!< Completion time of the flow, in nanoseconds, -1 if failed
+        float slowdown;  //!< FCT divided by the ideal FCT
+        uint32_t remote; //!< Index of the remote of the flow
+    };
+
+    /**
+     * TracedCallback signature for completed flows.
+     *
+     * \param [in] record The record of the flow.
+     */
+    typedef void (*FlowTracedCallback)(const FlowRecord& record);
+
+    /**
+     * \brief Add a remote to send flows to, in addition to "Remote"
+     * \param address the address of the remote
+     */
+    void AddRemote(const Address& address);
+
+    /**
+     * \brief Read the records of a flow log
+     * \param filename the name of the flow log
+     * \return the records of the log, empty if the log cannot be read
+     */
+    static std::vector<FlowRecord> ReadFlowLog(const std::string& filename);
+
+    /**
+     * \return the number of flows started so far
+     */
+    uint64_t GetNStartedFlows() const;
+
+    /**
+     * \return the number of flows completed so far
+     */
+    uint64_t GetNCompletedFlows() const;
+
+    /**
+     * \return the number of flows lost because their connection failed or
+     * was closed before they were completed
+     */
+    uint64_t GetNFailedFlows() const;
+
+    /**
+     * \return the number of connections opened so far
+     */
+    uint64_t GetNConnections() const;
+
+    /**
+     * \return the number of connections currently open
+     */
+    uint32_t GetNOpenConnections() const;
+
+    int64_t AssignStreams(int64_t stream) override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    /**
+     * \brief A flow to send
+     */
+    struct Flow
+    {
+        uint64_t id;     //!< Identifier of the flow
+        uint64_t size;   //!< Size of the flow, in bytes
+        Time start;      //!< Arrival time of the flow
+        uint32_t remote; //!< Index of the remote
+    };
+
+    /**
+     * \brief A slot of the connection pool
+     */
+    struct Connection
+    {
+        Ptr<Socket> socket;       //!< The socket of the connection, null if the slot is free
+        uint32_t remote;          //!< Index of the remote
+        bool connected{false};    //!< Whether the connection is established
+        bool busy{false};         //!< Whether a flow is being sent
+        Flow flow;                //!< The flow being sent, if busy
+        uint64_t unsent{0};       //!< Bytes of the flow not yet given to the socket
+        uint32_t txBufferSize{0}; //!< Size of the empty send buffer of the socket
+    };
+
+    /**
+     * \brief The connections to a remote
+     */
+    struct Remote
+    {
+        Address address;            //!< Address of the remote
+        uint32_t nConnections{0};   //!< Number of connections to the remote
+        std::vector<uint32_t> idle; //!< Indexes of the idle connections
+        std::deque<Flow> pending;   //!< Flows waiting for a connection
+    };
+
+    /// Read the flow size CDF file
+    void ReadFlowSizeCdf();
+
+    /// Start a new flow and schedule the next arrival
+    void StartFlow();
+
+    /**
+     * \brief Send a flow on an idle or new connection, or queue it
+     * \param flow the flow
+     */
+    void Dispatch(const Flow& flow);
+
+    /**
+     * \brief Open a new connection, in a free slot of the pool, to send a flow
+     * \param flow the flow
+     */
+    void OpenConnection(const Flow& flow);
+
+    /**
+     * \brief Remove a connection from the pool and free its slot
+     * \param index the index of the connection
+     * \param close whether to close the socket of the connection
+     */
+    void ReleaseConnection(uint32_t index, bool close);
+
+    /**
+     * \brief Open a connection for the first flow waiting for a connection to
+     * a remote, if the remote has less than MaxConnections connections
+     * \param remote the index of the remote
+     */
+    void ServePending(uint32_t remote);
+
+    /**
+     * \brief Release the connection of a socket that failed or was closed,
+     * losing its flow if it was not completed
+     * \param socket the socket
+     * \param close whether to close the socket
+     */
+    void DropConnection(Ptr<Socket> socket, bool close);
+
+    /**
+     * \brief Start sending a flow on a connection
+     * \param index the index of the connection
+     * \param flow the flow
+     */
+    void Assign(uint32_t index, const Flow& flow);
+
+    /**
+     * \brief Give the socket as many bytes of the flow as its buffer holds
+     * \param conn the connection
+     */
+    void SendData(Connection& conn);
+
+    /**
+     * \brief Record the completion of the flow of a connection, then close the
+     * connection or send the next pending flow on it
+     * \param index the index of the connection
+     */
+    void CompleteFlow(uint32_t index);
+
+    /**
+     * \brief Count a flow that is not completed and log it
+     * \param flow the flow
+     */
+    void FailFlow(const Flow& flow);
+
+    /**
+     * \brief Write a record to the flow log, if any
+     * \param record the record of the flow
+     */
+    void LogFlow(const FlowRecord& record);
+
+    /**
+     * \brief Write the buffered records to the flow log
+     */
+    void FlushFlowLog();
+
+    /**
+     * \brief Connection succeeded callback
+     * \param socket the socket
+     */
+    void ConnectionSucceeded(Ptr<Socket> socket);
+
+    /**
+     * \brief Connection failed callback
+     * \param socket the socket
+     */
+    void ConnectionFailed(Ptr<Socket> socket);
+
+    /**
+     * \brief Normal close callback, called when the remote closes the connection
+     * \param socket the socket
+     */
+    void ConnectionClosed(Ptr<Socket> socket);
+
+    /**
+     * \brief Error close callback, called when the connection is reset or
+     * reaches its retransmission limit
+     * \param socket the socket
+     */
+    void ConnectionError(Ptr<Socket> socket);
+
+    /**
+     * \brief Send space available callback
+     * \param socket the socket
+     * \param available the free space in the send buffer
+     */
+    void DataSend(Ptr<Socket> socket, uint32_t available);
+
+    TypeId m_tid;                               //!< The type of protocol to use
+    Address m_peer;                             //!< Address of the first remote
+    Ptr<RandomVariableStream> m_flowSize;       //!< Flow size, in bytes
+    std::string m_flowSizeCdfFile;              //!< Name of the flow size CDF file
+    double m_flowSizeScale;                     //!< Multiplier of the sizes of the CDF file
+    Ptr<EmpiricalRandomVariable> m_flowSizeCdf; //!< Flow size, from the CDF file
+    Ptr<RandomVariableStream> m_interArrival;   //!< Time between flow arrivals, in seconds
+    Ptr<UniformRandomVariable> m_remoteRv;      //!< Remote of the flows
+    uint64_t m_maxFlows;                        //!< Number of flows to start, 0 for no limit
+    ConnectionMode m_connectionMode;            //!< How the flows are mapped to connections
+    uint32_t m_maxConnections;                  //!< Connections per remote, 0 for no limit
+    DataRate m_linkRate;                        //!< Rate of the ideal FCT
+    Time m_baseRtt;                             //!< Round trip time of the ideal FCT
+    std::string m_flowLogFile;                  //!< Name of the flow log
+
+    std::vector<Address> m_addedRemotes;   //!< Remotes added by AddRemote
+    std::vector<Remote> m_remotes;         //!< The remotes
+    std::vector<Connection> m_connections; //!< The connection pool
+    std::vector<uint32_t> m_freeSlots;     //!< Indexes of the free slots of the pool
+
+    /// Index of the connection of each socket
+    std::unordered_map<Socket*, uint32_t> m_socketIndex;
+
+    bool m_running;                      //!< Whether the application is running
+    uint64_t m_nStarted;                 //!< Number of flows started
+    uint64_t m_nCompleted;               //!< Number of flows completed
+    uint64_t m_nFailed;                  //!< Number of flows lost
+    uint64_t m_nConnections;             //!< Number of connections opened
+    uint32_t m_nOpenConnections;         //!< Number of connections currently open
+    EventId m_arrivalEvent;              //!< Event of the next flow arrival
+    std::ofstream m_flowLog;             //!< The flow log
+    std::vector<FlowRecord> m_logBuffer; //!< Records not yet written to the flow log
+
+    /// Traced Callback: completed flows
+    TracedCallback<const FlowRecord&> m_flowCompletedTrace;
+};
+
+} // namespace ns3
+
+#endif /* FLOW_WORKLOAD_APPLICATION_H */
@@ -54,6 +54,12 @@ PacketSink::GetTypeId()
                           BooleanValue(false),
                           MakeBooleanAccessor(&PacketSink::m_enableSeqTsSizeHeader),
                           MakeBooleanChecker())
+            .AddAttribute("CloseOnPeerClose",
+                          "Close the accepted sockets when their peer closes them, and release "
+                          "them, instead of keeping them until the application stops.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PacketSink::m_closeOnPeerClose),
+                          MakeBooleanChecker())
             .AddTraceSource("Rx",
                             "A packet has been received",
                             MakeTraceSourceAccessor(&PacketSink::m_rxTrace),
@@ -284,12 +290,23 @@ void
 PacketSink::HandlePeerClose(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(this << socket);
+    // the listening socket also notifies its own close
+    if (m_closeOnPeerClose && socket != m_socket)
+    {
+        // the sink never sends, so the connection can be closed right away
+        socket->Close();
+        m_socketList.remove(socket);
+    }
 }
 
 void
 PacketSink::HandlePeerError(Ptr<Socket> socket)
 {
     NS_LOG_FUNCTION(this << socket);
+    if (m_closeOnPeerClose)
+    {
+        m_socketList.remove(socket);
+    }
 }
 
 void
@@ -119,7 +119,7 @@ class PacketSink : public Application
      */
     void HandleAccept(Ptr<Socket> socket, const Address& from);
     /**
-     * \brief Handle an connection close
+     * \brief Handle an connection close, closing the socket if CloseOnPeerClose is set
      * \param socket the connected socket
      */
     void HandlePeerClose(Ptr<Socket> socket);
@@ -187,6 +187,7 @@ class PacketSink : public Application
     TypeId m_tid;         //!< Protocol TypeId
 
     bool m_enableSeqTsSizeHeader{false}; //!< Enable or disable the export of SeqTsSize header
+    bool m_closeOnPeerClose{false};      //!< Close the accepted sockets closed by their peer
 
     /// Traced Callback: received packets, source address.
     TracedCallback<Ptr<const Packet>, const Address&> m_rxTrace;
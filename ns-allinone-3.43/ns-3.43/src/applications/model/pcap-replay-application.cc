@@ -0,0 +1,211 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "pcap-replay-application.h"
+
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PcapReplayApplication");
+
+NS_OBJECT_ENSURE_REGISTERED(PcapReplayApplication);
+
+TypeId
+PcapReplayApplication::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::PcapReplayApplication")
+            .SetParent<Application>()
+            .SetGroupName("Applications")
+            .AddConstructor<PcapReplayApplication>()
+            .AddAttribute("TraceFile",
+                          "Name of the pcap file to replay.",
+                          StringValue(""),
+                          MakeStringAccessor(&PcapReplayApplication::m_traceFile),
+                          MakeStringChecker())
+            .AddAttribute("Remote",
+                          "The address of the destination",
+                          AddressValue(),
+                          MakeAddressAccessor(&PcapReplayApplication::m_peer),
+                          MakeAddressChecker())
+            .AddAttribute("Local",
+                          "The Address on which to bind the socket. If not set, it is generated "
+                          "automatically.",
+                          AddressValue(),
+                          MakeAddressAccessor(&PcapReplayApplication::m_local),
+                          MakeAddressChecker())
+            .AddAttribute("Protocol",
+                          "The type of protocol to use.",
+                          TypeIdValue(UdpSocketFactory::GetTypeId()),
+                          MakeTypeIdAccessor(&PcapReplayApplication::m_tid),
+                          MakeTypeIdChecker())
+            .AddAttribute("StripLength",
+                          "The number of octets removed from the start of every record "
+                          "before it is sent.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&PcapReplayApplication::m_stripLength),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("PadToOriginalLength",
+                          "Pad the records truncated by the snap length of the capture "
+                          "with zeros, up to their original length.",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&PcapReplayApplication::m_pad),
+                          MakeBooleanChecker())
+            .AddTraceSource("Tx",
+                            "A new packet is sent",
+                            MakeTraceSourceAccessor(&PcapReplayApplication::m_txTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+PcapReplayApplication::PcapReplayApplication()
+    : m_socket(nullptr),
+      m_currentRecord(0),
+      m_firstTimestamp(0),
+      m_sent(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+PcapReplayApplication::~PcapReplayApplication()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint64_t
+PcapReplayApplication::GetSent() const
+{
+    return m_sent;
+}
+
+void
+PcapReplayApplication::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_socket = nullptr;
+    m_trace.Close();
+    // chain up
+    Application::DoDispose();
+}
+
+void
+PcapReplayApplication::StartApplication()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_trace.IsOpen())
+    {
+        if (!m_trace.Open(m_traceFile))
+        {
+            NS_FATAL_ERROR("Cannot open pcap file " << m_traceFile);
+        }
+        m_currentRecord = 0;
+    }
+
+    if (!m_socket)
+    {
+        NS_ABORT_MSG_IF(m_peer.IsInvalid(), "'Remote' attribute not properly set");
+        m_socket = Socket::CreateSocket(GetNode(), m_tid);
+        int ret;
+        if (!m_local.IsInvalid())
+        {
+            ret = m_socket->Bind(m_local);
+        }
+        else if (Inet6SocketAddress::IsMatchingType(m_peer))
+        {
+            ret = m_socket->Bind6();
+        }
+        else
+        {
+            ret = m_socket->Bind();
+        }
+        if (ret == -1)
+        {
+            NS_FATAL_ERROR("Failed to bind socket");
+        }
+        m_socket->Connect(m_peer);
+        m_socket->ShutdownRecv();
+    }
+
+    // The replay (re)starts now, at the current record
+    if (m_currentRecord < m_trace.GetNRecords())
+    {
+        m_startTime = Simulator::Now();
+        m_firstTimestamp = m_trace.GetTimestamp(m_currentRecord);
+        ScheduleNext();
+    }
+}
+
+void
+PcapReplayApplication::StopApplication()
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_sendEvent);
+    if (m_socket)
+    {
+        m_socket->Close();
+        m_socket = nullptr;
+    }
+}
+
+void
+PcapReplayApplication::ScheduleNext()
+{
+    NS_LOG_FUNCTION(this);
+    uint64_t timestamp = std::max(m_trace.GetTimestamp(m_currentRecord), m_firstTimestamp);
+    Time delay = m_startTime + NanoSeconds(timestamp - m_firstTimestamp) - Simulator::Now();
+    // A capture is not always sorted: late records are sent right away
+    m_sendEvent = Simulator::Schedule(Max(delay, Time(0)), &PcapReplayApplication::Send, this);
+}
+
+void
+PcapReplayApplication::Send()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t inclLen = m_trace.GetCapturedLength(m_currentRecord);
+    uint32_t origLen = m_trace.GetOriginalLength(m_currentRecord);
+    uint32_t strip = std::min(m_stripLength, inclLen);
+    Ptr<Packet> p = Create<Packet>(m_trace.GetData(m_currentRecord) + strip, inclLen - strip);
+    uint32_t end = std::max(inclLen, m_stripLength);
+    if (m_pad && origLen > end)
+    {
+        // appending a zero-filled packet extends the virtual zero area of the buffer
+        p->AddAtEnd(Create<Packet>(origLen - end));
+    }
+
+    m_txTrace(p);
+    if (m_socket->Send(p) >= 0)
+    {
+        ++m_sent;
+    }
+    else
+    {
+        NS_LOG_INFO("Error while sending record " << m_currentRecord);
+    }
+
+    if (++m_currentRecord < m_trace.GetNRecords())
+    {
+        ScheduleNext();
+    }
+}
+
+} // namespace ns3
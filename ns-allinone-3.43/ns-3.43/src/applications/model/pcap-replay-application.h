@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef PCAP_REPLAY_APPLICATION_H
+#define PCAP_REPLAY_APPLICATION_H
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/mapped-pcap-file.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3
+{
+
+class Socket;
+class Packet;
+
+/**
+ * \ingroup applications
+ * \defgroup pcapreplay PcapReplayApplication
+ *
+ * This traffic generator replays the packets of a pcap capture.
+ */
+
+/**
+ * \ingroup pcapreplay
+ *
+ * \brief Replay the packets of a pcap file at their recorded times.
+ *
+ * The records of the capture are sent through a socket, the first one
+ * when the application starts and the following ones at the same offsets
+ * from the first one as in the capture.  The capture is accessed through
+ * a MappedPcapFile, so only the record index is held in memory and a
+ * single send event is pending at any time: multi-GB captures can be
+ * replayed.
+ *
+ * The "StripLength" attribute removes a fixed number of octets (e.g., the
+ * link, IP and UDP headers of the capture) from the start of every record,
+ * so that only the captured payload is sent.  Records truncated by the
+ * snap length of the capture are padded with zeros to their original
+ * length, unless "PadToOriginalLength" is false.
+ *
+ * Any socket type may be used.  With ns3::PacketSocketFactory and a
+ * PacketSocketAddress as "Remote", the captured frames are injected
+ * directly into a NetDevice of the node.
+ */
+class PcapReplayApplication : public Application
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    PcapReplayApplication();
+    ~PcapReplayApplication() override;
+
+    /**
+     * \return the number of packets sent so far
+     */
+    uint64_t GetSent() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void StartApplication() override;
+    void StopApplication() override;
+
+    /// Schedule the transmission of the current record
+    void ScheduleNext();
+
+    /// Send the current record and schedule the next one
+    void Send();
+
+    std::string m_traceFile;     //!< Name of the pcap file to replay
+    MappedPcapFile m_trace;      //!< Mapped pcap file
+    Ptr<Socket> m_socket;        //!< Associated socket
+    Address m_peer;              //!< Peer address
+    Address m_local;             //!< Local address to bind to
+    TypeId m_tid;                //!< The type of protocol to use
+    uint32_t m_stripLength;      //!< Octets removed from the start of every record
+    bool m_pad;                  //!< Pad truncated records to their original length
+    std::size_t m_currentRecord; //!< Index of the next record to send
+    Time m_startTime;            //!< Time at which the first record was sent
+    uint64_t m_firstTimestamp;   //!< Timestamp of the first record, nanoseconds
+    uint64_t m_sent;             //!< Number of packets sent
+    EventId m_sendEvent;         //!< Event to send the next packet
+
+    /// Traced Callback: sent packets
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* PCAP_REPLAY_APPLICATION_H */
@@ -0,0 +1,453 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/application-container.h"
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/error-model.h"
+#include "ns3/flow-workload-application.h"
+#include "ns3/flow-workload-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/node-container.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/pointer.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <fstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check that the flows drawn from a CDF file to two remotes are all
+ * completed, each on its own connection, with a bounded number of open
+ * connections, and that the flow log holds the completed flows.
+ */
+class FlowWorkloadCdfTestCase : public TestCase
+{
+  public:
+    FlowWorkloadCdfTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Record a completed flow
+     * \param record the record of the flow
+     */
+    void FlowCompleted(const FlowWorkloadApplication::FlowRecord& record);
+
+    Ptr<FlowWorkloadApplication> m_source;                      //!< the application
+    std::vector<FlowWorkloadApplication::FlowRecord> m_records; //!< the completed flows
+    uint32_t m_maxOpenConnections{0}; //!< the largest number of open connections
+};
+
+FlowWorkloadCdfTestCase::FlowWorkloadCdfTestCase()
+    : TestCase("Check 200 flows drawn from a CDF file to two remotes")
+{
+}
+
+void
+FlowWorkloadCdfTestCase::FlowCompleted(const FlowWorkloadApplication::FlowRecord& record)
+{
+    m_records.push_back(record);
+    m_maxOpenConnections = std::max(m_maxOpenConnections, m_source->GetNOpenConnections());
+}
+
+void
+FlowWorkloadCdfTestCase::DoRun()
+{
+    std::string cdfFile = CreateTempDirFilename("flow-size.cdf");
+    std::string logFile = CreateTempDirFilename("flows.log");
+    {
+        std::ofstream cdf(cdfFile);
+        cdf << "# size (packets) cdf\n"
+            << "1 0.0\n"
+            << "2 0.5 # half of the flows have 1 or 2 packets\n"
+            << "\n"
+            << "10 0.8\n"
+            << "100 1.0\n";
+    }
+
+    NodeContainer nodes;
+    nodes.Create(3);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
+    simpleHelper.SetChannelAttribute("Delay", StringValue("1ms"));
+    NetDeviceContainer devices = simpleHelper.Install(nodes);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer i = ipv4.Assign(devices);
+
+    uint16_t port = 9;
+    FlowWorkloadHelper sourceHelper(
+        "ns3::TcpSocketFactory",
+        std::vector<Address>{InetSocketAddress(i.GetAddress(1), port),
+                             InetSocketAddress(i.GetAddress(2), port)});
+    sourceHelper.SetAttribute("FlowSizeCdfFile", StringValue(cdfFile));
+    sourceHelper.SetAttribute("FlowSizeScale", DoubleValue(1000));
+    sourceHelper.SetAttribute("InterArrival",
+                              StringValue("ns3::ExponentialRandomVariable[Mean=0.001]"));
+    sourceHelper.SetAttribute("MaxFlows", UintegerValue(200));
+    sourceHelper.SetAttribute("MaxConnections", UintegerValue(4));
+    sourceHelper.SetAttribute("LinkRate", StringValue("100Mbps"));
+    sourceHelper.SetAttribute("BaseRtt", StringValue("2ms"));
+    sourceHelper.SetAttribute("FlowLog", StringValue(logFile));
+    ApplicationContainer sourceApp = sourceHelper.Install(nodes.Get(0));
+    sourceApp.Start(Seconds(0.0));
+    sourceApp.Stop(Seconds(20.0));
+    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    sinkHelper.SetAttribute("CloseOnPeerClose", BooleanValue(true));
+    ApplicationContainer sinkApps = sinkHelper.Install(NodeContainer(nodes.Get(1), nodes.Get(2)));
+    sinkApps.Start(Seconds(0.0));
+    sinkApps.Stop(Seconds(20.0));
+
+    m_source = DynamicCast<FlowWorkloadApplication>(sourceApp.Get(0));
+    m_source->TraceConnectWithoutContext(
+        "FlowCompleted",
+        MakeCallback(&FlowWorkloadCdfTestCase::FlowCompleted, this));
+
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_source->GetNStartedFlows(), 200, "Not all the flows were started");
+    NS_TEST_ASSERT_MSG_EQ(m_source->GetNCompletedFlows(), 200, "Not all the flows were completed");
+    NS_TEST_ASSERT_MSG_EQ(m_source->GetNFailedFlows(), 0, "Some flows failed");
+    NS_TEST_ASSERT_MSG_EQ(m_source->GetNConnections(), 200, "Not one connection per flow");
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(m_maxOpenConnections, 8, "Too many open connections");
+    for (uint32_t n = 0; n < sinkApps.GetN(); n++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(DynamicCast<PacketSink>(sinkApps.Get(n))->GetAcceptedSockets().size(),
+                              0,
+                              "The connections were not closed");
+    }
+
+    uint64_t sent = 0;
+    std::vector<uint32_t> sentTo(2, 0);
+    for (const auto& record : m_records)
+    {
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(record.size, 1000, "Flow smaller than the CDF");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(record.size, 100000, "Flow larger than the CDF");
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(record.slowdown, 1, "Flow faster than the ideal flow");
+        sent += record.size;
+        sentTo[record.remote]++;
+    }
+    uint64_t received = DynamicCast<PacketSink>(sinkApps.Get(0))->GetTotalRx() +
+                        DynamicCast<PacketSink>(sinkApps.Get(1))->GetTotalRx();
+    NS_TEST_ASSERT_MSG_EQ(received, sent, "The remotes did not receive the flows");
+    NS_TEST_ASSERT_MSG_GT(sentTo[0], 0, "No flow sent to the first remote");
+    NS_TEST_ASSERT_MSG_GT(sentTo[1], 0, "No flow sent to the second remote");
+
+    m_source = nullptr;
+    Simulator::Destroy();
+
+    std::vector<FlowWorkloadApplication::FlowRecord> logged =
+        FlowWorkloadApplication::ReadFlowLog(logFile);
+    NS_TEST_ASSERT_MSG_EQ(logged.size(), m_records.size(), "Wrong number of logged flows");
+    for (std::size_t n = 0; n < logged.size(); n++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(logged[n].id, m_records[n].id, "Wrong logged flow");
+        NS_TEST_ASSERT_MSG_EQ(logged[n].size, m_records[n].size, "Wrong logged flow size");
+        NS_TEST_ASSERT_MSG_EQ(logged[n].fct, m_records[n].fct, "Wrong logged flow FCT");
+    }
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check that flows that do not overlap are all sent on the same connection
+ * in the persistent mode.
+ */
+class FlowWorkloadReuseTestCase : public TestCase
+{
+  public:
+    FlowWorkloadReuseTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FlowWorkloadReuseTestCase::FlowWorkloadReuseTestCase()
+    : TestCase("Check that sequential flows reuse a single connection")
+{
+}
+
+void
+FlowWorkloadReuseTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    simpleHelper.SetChannelAttribute("Delay", StringValue("10ms"));
+    NetDeviceContainer devices = simpleHelper.Install(nodes);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer i = ipv4.Assign(devices);
+
+    uint16_t port = 9;
+    FlowWorkloadHelper sourceHelper("ns3::TcpSocketFactory",
+                                    InetSocketAddress(i.GetAddress(1), port));
+    sourceHelper.SetAttribute("FlowSize",
+                              StringValue("ns3::ConstantRandomVariable[Constant=50000]"));
+    sourceHelper.SetAttribute("InterArrival",
+                              StringValue("ns3::ConstantRandomVariable[Constant=1]"));
+    sourceHelper.SetAttribute("MaxFlows", UintegerValue(10));
+    sourceHelper.SetAttribute("ConnectionMode", StringValue("Persistent"));
+    ApplicationContainer sourceApp = sourceHelper.Install(nodes.Get(0));
+    sourceApp.Start(Seconds(0.0));
+    sourceApp.Stop(Seconds(20.0));
+    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    ApplicationContainer sinkApp = sinkHelper.Install(nodes.Get(1));
+    sinkApp.Start(Seconds(0.0));
+    sinkApp.Stop(Seconds(20.0));
+
+    Simulator::Run();
+
+    Ptr<FlowWorkloadApplication> source = DynamicCast<FlowWorkloadApplication>(sourceApp.Get(0));
+    NS_TEST_ASSERT_MSG_EQ(source->GetNCompletedFlows(), 10, "Not all the flows were completed");
+    NS_TEST_ASSERT_MSG_EQ(source->GetNConnections(), 1, "The connection was not reused");
+    NS_TEST_ASSERT_MSG_EQ(DynamicCast<PacketSink>(sinkApp.Get(0))->GetTotalRx(),
+                          500000,
+                          "The remote did not receive the flows");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check that the flows of the connections that are lost, after too many
+ * retransmissions or connection attempts, are counted as failed, and that
+ * their connections are released so that the pending flows are served.
+ */
+class FlowWorkloadFailureTestCase : public TestCase
+{
+  public:
+    FlowWorkloadFailureTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Record the flows and connections of the application
+     * \param source the application
+     */
+    void CheckConnections(Ptr<FlowWorkloadApplication> source);
+
+    uint64_t m_nFailedFlows{0};     //!< the failed flows
+    uint32_t m_nOpenConnections{0}; //!< the open connections
+};
+
+FlowWorkloadFailureTestCase::FlowWorkloadFailureTestCase()
+    : TestCase("Check that the flows of lost connections fail and release the connections")
+{
+}
+
+void
+FlowWorkloadFailureTestCase::CheckConnections(Ptr<FlowWorkloadApplication> source)
+{
+    m_nFailedFlows = source->GetNFailedFlows();
+    m_nOpenConnections = source->GetNOpenConnections();
+}
+
+void
+FlowWorkloadFailureTestCase::DoRun()
+{
+    Config::SetDefault("ns3::TcpSocket::DataRetries", UintegerValue(2));
+    Config::SetDefault("ns3::TcpSocket::ConnCount", UintegerValue(1));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    simpleHelper.SetChannelAttribute("Delay", StringValue("1ms"));
+    NetDeviceContainer devices = simpleHelper.Install(nodes);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer i = ipv4.Assign(devices);
+
+    uint16_t port = 9;
+    FlowWorkloadHelper sourceHelper("ns3::TcpSocketFactory",
+                                    InetSocketAddress(i.GetAddress(1), port));
+    sourceHelper.SetAttribute("FlowSize",
+                              StringValue("ns3::ConstantRandomVariable[Constant=1000000]"));
+    sourceHelper.SetAttribute("InterArrival",
+                              StringValue("ns3::ConstantRandomVariable[Constant=0.01]"));
+    sourceHelper.SetAttribute("MaxFlows", UintegerValue(2));
+    sourceHelper.SetAttribute("MaxConnections", UintegerValue(1));
+    ApplicationContainer sourceApp = sourceHelper.Install(nodes.Get(0));
+    sourceApp.Start(Seconds(0.0));
+    sourceApp.Stop(Seconds(60.0));
+    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    // the sink is not stopped, as closing its connection would retransmit the FIN
+    // to the lost source forever
+    ApplicationContainer sinkApp = sinkHelper.Install(nodes.Get(1));
+    sinkApp.Start(Seconds(0.0));
+
+    // the remote loses all the packets once the first connection is established,
+    // so that it fails after too many retransmissions and the second one to connect
+    Ptr<RateErrorModel> em = CreateObject<RateErrorModel>();
+    em->SetAttribute("ErrorRate", DoubleValue(1));
+    em->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+    Simulator::Schedule(Seconds(0.05), [&devices, em]() {
+        devices.Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(em));
+    });
+
+    Ptr<FlowWorkloadApplication> source = DynamicCast<FlowWorkloadApplication>(sourceApp.Get(0));
+    Simulator::Schedule(Seconds(59.0),
+                        &FlowWorkloadFailureTestCase::CheckConnections,
+                        this,
+                        source);
+
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(source->GetNStartedFlows(), 2, "Not all the flows were started");
+    NS_TEST_ASSERT_MSG_EQ(source->GetNCompletedFlows(), 0, "A flow was completed");
+    NS_TEST_ASSERT_MSG_EQ(m_nFailedFlows, 2, "The flows of the lost connections did not fail");
+    NS_TEST_ASSERT_MSG_EQ(m_nOpenConnections, 0, "The lost connections were not released");
+    NS_TEST_ASSERT_MSG_EQ(source->GetNConnections(), 2, "The second flow was not served");
+
+    Simulator::Destroy();
+
+    Config::SetDefault("ns3::TcpSocket::DataRetries", UintegerValue(6));
+    Config::SetDefault("ns3::TcpSocket::ConnCount", UintegerValue(6));
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Check that the flows arriving when all the ephemeral ports of the node are
+ * held by connections in TIME_WAIT fail, are counted and are logged.
+ */
+class FlowWorkloadPortExhaustionTestCase : public TestCase
+{
+  public:
+    FlowWorkloadPortExhaustionTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FlowWorkloadPortExhaustionTestCase::FlowWorkloadPortExhaustionTestCase()
+    : TestCase("Check that the flows fail when the ephemeral ports are exhausted")
+{
+}
+
+void
+FlowWorkloadPortExhaustionTestCase::DoRun()
+{
+    std::string logFile = CreateTempDirFilename("flows.log");
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetDeviceAttribute("DataRate", StringValue("1Gbps"));
+    simpleHelper.SetChannelAttribute("Delay", StringValue("10us"));
+    NetDeviceContainer devices = simpleHelper.Install(nodes);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer i = ipv4.Assign(devices);
+
+    // with the default MaxSegLifetime, the 16384 ephemeral ports of the source
+    // are held in TIME_WAIT until the end of the simulation
+    const uint32_t nPorts = 16384;
+    const uint32_t nFlows = nPorts + 500;
+    uint16_t port = 9;
+    FlowWorkloadHelper sourceHelper("ns3::TcpSocketFactory",
+                                    InetSocketAddress(i.GetAddress(1), port));
+    sourceHelper.SetAttribute("FlowSize", StringValue("ns3::ConstantRandomVariable[Constant=100]"));
+    sourceHelper.SetAttribute("InterArrival",
+                              StringValue("ns3::ConstantRandomVariable[Constant=0.001]"));
+    sourceHelper.SetAttribute("MaxFlows", UintegerValue(nFlows));
+    sourceHelper.SetAttribute("FlowLog", StringValue(logFile));
+    ApplicationContainer sourceApp = sourceHelper.Install(nodes.Get(0));
+    sourceApp.Start(Seconds(0.0));
+    sourceApp.Stop(Seconds(30.0));
+    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    sinkHelper.SetAttribute("CloseOnPeerClose", BooleanValue(true));
+    ApplicationContainer sinkApp = sinkHelper.Install(nodes.Get(1));
+    sinkApp.Start(Seconds(0.0));
+    sinkApp.Stop(Seconds(30.0));
+
+    Simulator::Stop(Seconds(30.0));
+    Simulator::Run();
+
+    Ptr<FlowWorkloadApplication> source = DynamicCast<FlowWorkloadApplication>(sourceApp.Get(0));
+    NS_TEST_ASSERT_MSG_EQ(source->GetNStartedFlows(), nFlows, "Not all the flows were started");
+    NS_TEST_ASSERT_MSG_EQ(source->GetNCompletedFlows(), nPorts, "Wrong number of completed flows");
+    NS_TEST_ASSERT_MSG_EQ(source->GetNFailedFlows(),
+                          nFlows - nPorts,
+                          "The flows without an ephemeral port did not fail");
+    NS_TEST_ASSERT_MSG_EQ(source->GetNOpenConnections(), 0, "Some connections are still open");
+
+    Simulator::Destroy();
+
+    std::vector<FlowWorkloadApplication::FlowRecord> logged =
+        FlowWorkloadApplication::ReadFlowLog(logFile);
+    NS_TEST_ASSERT_MSG_EQ(logged.size(), nFlows, "Wrong number of logged flows");
+    // the flows are logged in order of completion or failure
+    std::vector<bool> isLogged(nFlows, false);
+    uint32_t nLoggedFailed = 0;
+    for (const auto& record : logged)
+    {
+        NS_TEST_ASSERT_MSG_LT(record.id, nFlows, "Unknown logged flow");
+        NS_TEST_ASSERT_MSG_EQ(isLogged[record.id], false, "Flow logged twice");
+        isLogged[record.id] = true;
+        if (record.fct < 0)
+        {
+            NS_TEST_ASSERT_MSG_GT_OR_EQ(record.id, nPorts, "A flow with a free port failed");
+            nLoggedFailed++;
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(nLoggedFailed, nFlows - nPorts, "Wrong number of logged failed flows");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief FlowWorkloadApplication TestSuite
+ */
+class FlowWorkloadApplicationTestSuite : public TestSuite
+{
+  public:
+    FlowWorkloadApplicationTestSuite();
+};
+
+FlowWorkloadApplicationTestSuite::FlowWorkloadApplicationTestSuite()
+    : TestSuite("applications-flow-workload", Type::UNIT)
+{
+    AddTestCase(new FlowWorkloadCdfTestCase(), TestCase::Duration::QUICK);
+    AddTestCase(new FlowWorkloadReuseTestCase(), TestCase::Duration::QUICK);
+    AddTestCase(new FlowWorkloadFailureTestCase(), TestCase::Duration::QUICK);
+    AddTestCase(new FlowWorkloadPortExhaustionTestCase(), TestCase::Duration::EXTENSIVE);
+}
+
+static FlowWorkloadApplicationTestSuite
+    g_flowWorkloadApplicationTestSuite; //!< Static variable for test initialization
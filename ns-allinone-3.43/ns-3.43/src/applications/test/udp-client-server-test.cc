@@ -13,6 +13,10 @@
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/log.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/pcap-file.h"
+#include "ns3/pcap-replay-helper.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device.h"
 #include "ns3/simulator.h"
@@ -24,6 +28,7 @@
 #include "ns3/uinteger.h"
 
 #include <fstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -183,6 +188,119 @@ UdpTraceClientServerTestCase::DoRun()
                           "Did not receive expected number of packets !");
 }
 
+/**
+ * Test that the packets of a pcap file are replayed by a PcapReplayApplication
+ * at their recorded times
+ */
+
+class PcapReplayTestCase : public TestCase
+{
+  public:
+    PcapReplayTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Record a received packet
+     * \param p the packet
+     * \param from the sender address
+     */
+    void ReceivePacket(Ptr<const Packet> p, const Address& from);
+
+    std::vector<Time> m_rxTimes;     //!< Reception times
+    std::vector<uint32_t> m_rxSizes; //!< Sizes of the received packets
+};
+
+PcapReplayTestCase::PcapReplayTestCase()
+    : TestCase("Test that the packets of a pcap file are replayed by a PcapReplayApplication "
+               "at their recorded times")
+{
+}
+
+void
+PcapReplayTestCase::ReceivePacket(Ptr<const Packet> p, const Address& from)
+{
+    m_rxTimes.push_back(Simulator::Now());
+    m_rxSizes.push_back(p->GetSize());
+}
+
+void
+PcapReplayTestCase::DoRun()
+{
+    // A capture of four IPv4/UDP packets, the second one truncated by the snap length
+    std::string filename = CreateTempDirFilename("replay.pcap");
+    PcapFile f;
+    f.Open(filename, std::ios::out);
+    f.Init(101, 128); // raw IP
+    uint8_t data[128] = {};
+    f.Write(100, 0, data, 100);
+    f.Write(100, 500000, data, 300);
+    f.Write(101, 0, data, 128);
+    f.Write(102, 250000, data, 40);
+    f.Close();
+
+    NodeContainer n;
+    n.Create(2);
+
+    InternetStackHelper internet;
+    internet.Install(n);
+
+    // link the two nodes
+    Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice>();
+    Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice>();
+    n.Get(0)->AddDevice(txDev);
+    n.Get(1)->AddDevice(rxDev);
+    Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel>();
+    rxDev->SetChannel(channel1);
+    txDev->SetChannel(channel1);
+    NetDeviceContainer d;
+    d.Add(txDev);
+    d.Add(rxDev);
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer i = ipv4.Assign(d);
+
+    uint16_t port = 4000;
+    PacketSinkHelper sinkHelper("ns3::UdpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    auto sinkApp = sinkHelper.Install(n.Get(1));
+    sinkApp.Start(Seconds(1.0));
+    sinkApp.Stop(Seconds(10.0));
+    sinkApp.Get(0)->TraceConnectWithoutContext(
+        "Rx",
+        MakeCallback(&PcapReplayTestCase::ReceivePacket, this));
+
+    // only replay the payload of the UDP packets
+    PcapReplayHelper replayHelper("ns3::UdpSocketFactory",
+                                  InetSocketAddress(i.GetAddress(1), port),
+                                  filename);
+    replayHelper.SetAttribute("StripLength", UintegerValue(28));
+    auto replayApp = replayHelper.Install(n.Get(0));
+    replayApp.Start(Seconds(2.0));
+    replayApp.Stop(Seconds(10.0));
+
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_rxTimes.size(), 4, "Did not receive expected number of packets !");
+    // the first packet waits for the address resolution, which is jittered
+    NS_TEST_EXPECT_MSG_EQ_TOL(m_rxTimes[0],
+                              Seconds(2),
+                              MilliSeconds(10),
+                              "Unexpected reception time");
+    NS_TEST_EXPECT_MSG_EQ(m_rxTimes[1], Seconds(2.5), "Unexpected reception time");
+    NS_TEST_EXPECT_MSG_EQ(m_rxTimes[2], Seconds(3), "Unexpected reception time");
+    NS_TEST_EXPECT_MSG_EQ(m_rxTimes[3], Seconds(4.25), "Unexpected reception time");
+    NS_TEST_EXPECT_MSG_EQ(m_rxSizes[0], 72, "Unexpected packet size");
+    NS_TEST_EXPECT_MSG_EQ(m_rxSizes[1], 272, "Truncated record not padded");
+    NS_TEST_EXPECT_MSG_EQ(m_rxSizes[2], 100, "Unexpected packet size");
+    NS_TEST_EXPECT_MSG_EQ(m_rxSizes[3], 12, "Unexpected packet size");
+
+    remove(filename.c_str());
+}
+
 /**
  * Test that all the PacketLossCounter class checks loss correctly in different cases
  */
@@ -354,6 +472,7 @@ UdpClientServerTestSuite::UdpClientServerTestSuite()
     AddTestCase(new UdpClientServerTestCase, TestCase::Duration::QUICK);
     AddTestCase(new PacketLossCounterTestCase, TestCase::Duration::QUICK);
     AddTestCase(new UdpEchoClientSetFillTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new PcapReplayTestCase, TestCase::Duration::QUICK);
 }
 
 static UdpClientServerTestSuite
@@ -72,7 +72,7 @@ CsmaHelper::EnablePcapInternal(std::string prefix,
         return;
     }
 
-    PcapHelper pcapHelper;
+    PcapHelper pcapHelper = GetPcapHelper();
 
     std::string filename;
     if (explicitFilename)
@@ -63,7 +63,7 @@ FdNetDeviceHelper::EnablePcapInternal(std::string prefix,
         return;
     }
 
-    PcapHelper pcapHelper;
+    PcapHelper pcapHelper = GetPcapHelper();
 
     std::string filename;
     if (explicitFilename)
@@ -76,6 +76,9 @@ class Ipv4GlobalRoutingHelper : public Ipv4RoutingHelper
      * Users must first call PopulateRoutingTables() and then may subsequently
      * call RecomputeRoutingTables() at any later time in the simulation.
      *
+     * Only the routers whose shortest path tree can have changed since the
+     * previous computation run the SPF calculation again, and only the
+     * routing tables whose routes changed are rewritten.
      */
     static void RecomputeRoutingTables();
 };
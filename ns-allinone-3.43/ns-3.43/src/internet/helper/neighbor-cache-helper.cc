@@ -18,6 +18,8 @@
 #include "ns3/ptr.h"
 #include "ns3/simulator.h"
 
+#include <map>
+
 namespace ns3
 {
 
@@ -49,68 +51,11 @@ void
 NeighborCacheHelper::PopulateNeighborCache(Ptr<Channel> channel) const
 {
     NS_LOG_FUNCTION(this << channel);
-    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    std::vector<ChannelDevice> devices = GetChannelDevices(channel);
+    ChannelNeighbors neighbors = GetChannelNeighbors(devices);
+    for (const auto& device : devices)
     {
-        Ptr<NetDevice> netDevice = channel->GetDevice(i);
-        Ptr<Node> node = netDevice->GetNode();
-
-        int32_t ipv4InterfaceIndex = -1;
-        if (node->GetObject<Ipv4>())
-        {
-            ipv4InterfaceIndex = node->GetObject<Ipv4>()->GetInterfaceForDevice(netDevice);
-        }
-        int32_t ipv6InterfaceIndex = -1;
-        if (node->GetObject<Ipv6>())
-        {
-            ipv6InterfaceIndex = node->GetObject<Ipv6>()->GetInterfaceForDevice(netDevice);
-        }
-
-        for (std::size_t j = 0; j < channel->GetNDevices(); ++j)
-        {
-            Ptr<NetDevice> neighborDevice = channel->GetDevice(j);
-            Ptr<Node> neighborNode = neighborDevice->GetNode();
-
-            int32_t ipv4NeighborInterfaceIndex = -1;
-            if (neighborNode->GetObject<Ipv4>())
-            {
-                ipv4NeighborInterfaceIndex =
-                    neighborNode->GetObject<Ipv4>()->GetInterfaceForDevice(neighborDevice);
-            }
-            int32_t ipv6NeighborInterfaceIndex = -1;
-            if (neighborNode->GetObject<Ipv6>())
-            {
-                ipv6NeighborInterfaceIndex =
-                    neighborNode->GetObject<Ipv6>()->GetInterfaceForDevice(neighborDevice);
-            }
-
-            if (neighborDevice != netDevice)
-            {
-                if (ipv4InterfaceIndex != -1)
-                {
-                    Ptr<Ipv4Interface> ipv4Interface =
-                        node->GetObject<Ipv4L3Protocol>()->GetInterface(ipv4InterfaceIndex);
-                    if (ipv4NeighborInterfaceIndex != -1)
-                    {
-                        Ptr<Ipv4Interface> ipv4NeighborInterface =
-                            neighborNode->GetObject<Ipv4L3Protocol>()->GetInterface(
-                                ipv4NeighborInterfaceIndex);
-                        PopulateNeighborEntriesIpv4(ipv4Interface, ipv4NeighborInterface);
-                    }
-                }
-                if (ipv6InterfaceIndex != -1)
-                {
-                    Ptr<Ipv6Interface> ipv6Interface =
-                        node->GetObject<Ipv6L3Protocol>()->GetInterface(ipv6InterfaceIndex);
-                    if (ipv6NeighborInterfaceIndex != -1)
-                    {
-                        Ptr<Ipv6Interface> ipv6NeighborInterface =
-                            neighborNode->GetObject<Ipv6L3Protocol>()->GetInterface(
-                                ipv6NeighborInterfaceIndex);
-                        PopulateNeighborEntriesIpv6(ipv6Interface, ipv6NeighborInterface);
-                    }
-                }
-            }
-        }
+        PopulateNeighborEntries(device, neighbors);
     }
 }
 
@@ -118,69 +63,17 @@ void
 NeighborCacheHelper::PopulateNeighborCache(const NetDeviceContainer& c) const
 {
     NS_LOG_FUNCTION(this);
+    std::map<Ptr<Channel>, ChannelNeighbors> channels;
     for (uint32_t i = 0; i < c.GetN(); ++i)
     {
         Ptr<NetDevice> netDevice = c.Get(i);
         Ptr<Channel> channel = netDevice->GetChannel();
-        Ptr<Node> node = netDevice->GetNode();
-
-        int32_t ipv4InterfaceIndex = -1;
-        if (node->GetObject<Ipv4>())
-        {
-            ipv4InterfaceIndex = node->GetObject<Ipv4>()->GetInterfaceForDevice(netDevice);
-        }
-        int32_t ipv6InterfaceIndex = -1;
-        if (node->GetObject<Ipv6>())
-        {
-            ipv6InterfaceIndex = node->GetObject<Ipv6>()->GetInterfaceForDevice(netDevice);
-        }
-
-        for (std::size_t j = 0; j < channel->GetNDevices(); ++j)
+        auto it = channels.find(channel);
+        if (it == channels.end())
         {
-            Ptr<NetDevice> neighborDevice = channel->GetDevice(j);
-            Ptr<Node> neighborNode = neighborDevice->GetNode();
-
-            int32_t ipv4NeighborInterfaceIndex = -1;
-            if (neighborNode->GetObject<Ipv4>())
-            {
-                ipv4NeighborInterfaceIndex =
-                    neighborNode->GetObject<Ipv4>()->GetInterfaceForDevice(neighborDevice);
-            }
-            int32_t ipv6NeighborInterfaceIndex = -1;
-            if (neighborNode->GetObject<Ipv6>())
-            {
-                ipv6NeighborInterfaceIndex =
-                    neighborNode->GetObject<Ipv6>()->GetInterfaceForDevice(neighborDevice);
-            }
-
-            if (neighborDevice != netDevice)
-            {
-                if (ipv4InterfaceIndex != -1)
-                {
-                    Ptr<Ipv4Interface> ipv4Interface =
-                        node->GetObject<Ipv4L3Protocol>()->GetInterface(ipv4InterfaceIndex);
-                    if (ipv4NeighborInterfaceIndex != -1)
-                    {
-                        Ptr<Ipv4Interface> ipv4NeighborInterface =
-                            neighborNode->GetObject<Ipv4L3Protocol>()->GetInterface(
-                                ipv4NeighborInterfaceIndex);
-                        PopulateNeighborEntriesIpv4(ipv4Interface, ipv4NeighborInterface);
-                    }
-                }
-                if (ipv6InterfaceIndex != -1)
-                {
-                    Ptr<Ipv6Interface> ipv6Interface =
-                        node->GetObject<Ipv6L3Protocol>()->GetInterface(ipv6InterfaceIndex);
-                    if (ipv6NeighborInterfaceIndex != -1)
-                    {
-                        Ptr<Ipv6Interface> ipv6NeighborInterface =
-                            neighborNode->GetObject<Ipv6L3Protocol>()->GetInterface(
-                                ipv6NeighborInterfaceIndex);
-                        PopulateNeighborEntriesIpv6(ipv6Interface, ipv6NeighborInterface);
-                    }
-                }
-            }
+            it = channels.emplace(channel, GetChannelNeighbors(GetChannelDevices(channel))).first;
         }
+        PopulateNeighborEntries(GetChannelDevice(netDevice), it->second);
     }
 }
 
@@ -188,6 +81,7 @@ void
 NeighborCacheHelper::PopulateNeighborCache(const Ipv4InterfaceContainer& c) const
 {
     NS_LOG_FUNCTION(this);
+    std::map<Ptr<Channel>, ChannelNeighbors> channels;
     for (uint32_t i = 0; i < c.GetN(); ++i)
     {
         std::pair<Ptr<Ipv4>, uint32_t> returnValue = c.Get(i);
@@ -198,23 +92,13 @@ NeighborCacheHelper::PopulateNeighborCache(const Ipv4InterfaceContainer& c) cons
         {
             Ptr<NetDevice> netDevice = ipv4Interface->GetDevice();
             Ptr<Channel> channel = netDevice->GetChannel();
-            for (std::size_t j = 0; j < channel->GetNDevices(); ++j)
+            auto it = channels.find(channel);
+            if (it == channels.end())
             {
-                Ptr<NetDevice> neighborDevice = channel->GetDevice(j);
-                if (neighborDevice != netDevice)
-                {
-                    Ptr<Node> neighborNode = neighborDevice->GetNode();
-                    int32_t ipv4NeighborInterfaceIndex =
-                        neighborNode->GetObject<Ipv4>()->GetInterfaceForDevice(neighborDevice);
-                    if (ipv4NeighborInterfaceIndex != -1)
-                    {
-                        Ptr<Ipv4Interface> ipv4NeighborInterface =
-                            neighborNode->GetObject<Ipv4L3Protocol>()->GetInterface(
-                                ipv4NeighborInterfaceIndex);
-                        PopulateNeighborEntriesIpv4(ipv4Interface, ipv4NeighborInterface);
-                    }
-                }
+                it = channels.emplace(channel, GetChannelNeighbors(GetChannelDevices(channel)))
+                         .first;
             }
+            PopulateNeighborEntriesIpv4(ipv4Interface, it->second.arp);
         }
     }
 }
@@ -223,6 +107,7 @@ void
 NeighborCacheHelper::PopulateNeighborCache(const Ipv6InterfaceContainer& c) const
 {
     NS_LOG_FUNCTION(this);
+    std::map<Ptr<Channel>, ChannelNeighbors> channels;
     for (uint32_t i = 0; i < c.GetN(); ++i)
     {
         std::pair<Ptr<Ipv6>, uint32_t> returnValue = c.Get(i);
@@ -233,160 +118,163 @@ NeighborCacheHelper::PopulateNeighborCache(const Ipv6InterfaceContainer& c) cons
         {
             Ptr<NetDevice> netDevice = ipv6Interface->GetDevice();
             Ptr<Channel> channel = netDevice->GetChannel();
-            for (std::size_t j = 0; j < channel->GetNDevices(); ++j)
+            auto it = channels.find(channel);
+            if (it == channels.end())
             {
-                Ptr<NetDevice> neighborDevice = channel->GetDevice(j);
-                if (neighborDevice != netDevice)
-                {
-                    Ptr<Node> neighborNode = neighborDevice->GetNode();
-                    int32_t ipv6NeighborInterfaceIndex =
-                        neighborNode->GetObject<Ipv6>()->GetInterfaceForDevice(neighborDevice);
-                    if (ipv6NeighborInterfaceIndex != -1)
-                    {
-                        Ptr<Ipv6Interface> ipv6NeighborInterface =
-                            neighborNode->GetObject<Ipv6L3Protocol>()->GetInterface(
-                                ipv6NeighborInterfaceIndex);
-                        PopulateNeighborEntriesIpv6(ipv6Interface, ipv6NeighborInterface);
-                    }
-                }
+                it = channels.emplace(channel, GetChannelNeighbors(GetChannelDevices(channel)))
+                         .first;
             }
+            PopulateNeighborEntriesIpv6(ipv6Interface, it->second.ndisc);
         }
     }
 }
 
-void
-NeighborCacheHelper::PopulateNeighborEntriesIpv4(Ptr<Ipv4Interface> ipv4Interface,
-                                                 Ptr<Ipv4Interface> neighborDeviceInterface) const
+NeighborCacheHelper::ChannelDevice
+NeighborCacheHelper::GetChannelDevice(Ptr<NetDevice> netDevice) const
 {
-    uint32_t netDeviceAddresses = ipv4Interface->GetNAddresses();
-    uint32_t neighborDeviceAddresses = neighborDeviceInterface->GetNAddresses();
-    if (m_dynamicNeighborCache)
+    NS_LOG_FUNCTION(this << netDevice);
+    ChannelDevice channelDevice;
+    channelDevice.device = netDevice;
+    Ptr<Node> node = netDevice->GetNode();
+    Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
+    if (ipv4)
     {
-        ipv4Interface->RemoveAddressCallback(
-            MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv4AddressRemoved, this));
-        if (m_globalNeighborCache)
+        int32_t ipv4InterfaceIndex = ipv4->GetInterfaceForDevice(netDevice);
+        if (ipv4InterfaceIndex != -1)
         {
-            ipv4Interface->AddAddressCallback(
-                MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv4AddressAdded, this));
+            channelDevice.ipv4 = ipv4->GetInterface(ipv4InterfaceIndex);
         }
     }
-    for (uint32_t n = 0; n < netDeviceAddresses; ++n)
+    Ptr<Ipv6L3Protocol> ipv6 = node->GetObject<Ipv6L3Protocol>();
+    if (ipv6)
     {
-        Ipv4InterfaceAddress netDeviceIfAddr = ipv4Interface->GetAddress(n);
-        for (uint32_t m = 0; m < neighborDeviceAddresses; ++m)
+        int32_t ipv6InterfaceIndex = ipv6->GetInterfaceForDevice(netDevice);
+        if (ipv6InterfaceIndex != -1)
         {
-            Ipv4InterfaceAddress neighborDeviceIfAddr = neighborDeviceInterface->GetAddress(m);
-            if (netDeviceIfAddr.IsInSameSubnet(neighborDeviceIfAddr.GetLocal()))
-            {
-                Ptr<NetDevice> neighborDevice = neighborDeviceInterface->GetDevice();
-                // Add Arp entry of neighbor interface to current interface's Arp cache
-                AddEntry(ipv4Interface,
-                         neighborDeviceIfAddr.GetAddress(),
-                         neighborDevice->GetAddress());
-            }
+            channelDevice.ipv6 = ipv6->GetInterface(ipv6InterfaceIndex);
         }
     }
+    return channelDevice;
 }
 
-void
-NeighborCacheHelper::PopulateNeighborEntriesIpv6(Ptr<Ipv6Interface> ipv6Interface,
-                                                 Ptr<Ipv6Interface> neighborDeviceInterface) const
+std::vector<NeighborCacheHelper::ChannelDevice>
+NeighborCacheHelper::GetChannelDevices(Ptr<Channel> channel) const
 {
-    uint32_t netDeviceAddresses = ipv6Interface->GetNAddresses();
-    uint32_t neighborDeviceAddresses = neighborDeviceInterface->GetNAddresses();
-    if (m_dynamicNeighborCache)
+    NS_LOG_FUNCTION(this << channel);
+    std::vector<ChannelDevice> devices;
+    devices.reserve(channel->GetNDevices());
+    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
     {
-        ipv6Interface->RemoveAddressCallback(
-            MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv6AddressRemoved, this));
-        if (m_globalNeighborCache)
-        {
-            ipv6Interface->AddAddressCallback(
-                MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv6AddressAdded, this));
-        }
+        devices.push_back(GetChannelDevice(channel->GetDevice(i)));
     }
-    for (uint32_t n = 0; n < netDeviceAddresses; ++n)
+    return devices;
+}
+
+NeighborCacheHelper::ChannelNeighbors
+NeighborCacheHelper::GetChannelNeighbors(const std::vector<ChannelDevice>& devices) const
+{
+    NS_LOG_FUNCTION(this);
+    ChannelNeighbors neighbors;
+    neighbors.arp = Create<ArpCache::Neighbors>();
+    neighbors.ndisc = Create<NdiscCache::Neighbors>();
+    for (const auto& device : devices)
     {
-        Ipv6InterfaceAddress netDeviceIfAddr = ipv6Interface->GetAddress(n);
-        // Ignore if it is a linklocal address, which will be added along with the global address
-        if (netDeviceIfAddr.GetScope() == Ipv6InterfaceAddress::LINKLOCAL ||
-            netDeviceIfAddr.GetScope() == Ipv6InterfaceAddress::HOST)
+        if (device.ipv4)
         {
-            NS_LOG_LOGIC("Skip the LINKLOCAL or LOCALHOST interface " << netDeviceIfAddr);
-            continue;
+            for (uint32_t m = 0; m < device.ipv4->GetNAddresses(); ++m)
+            {
+                neighbors.arp->Add(device.ipv4->GetAddress(m).GetLocal(), device.device);
+            }
         }
-        for (uint32_t m = 0; m < neighborDeviceAddresses; ++m)
+        if (device.ipv6)
         {
-            // Ignore if it is a linklocal address, which will be added along with the global
-            // address
-            Ipv6InterfaceAddress neighborDeviceIfAddr = neighborDeviceInterface->GetAddress(m);
-            if (neighborDeviceIfAddr.GetScope() == Ipv6InterfaceAddress::LINKLOCAL ||
-                neighborDeviceIfAddr.GetScope() == Ipv6InterfaceAddress::HOST)
+            // The entry of the linklocal address is added along with the global
+            // addresses, to the caches of the devices on the subnet of one of them
+            std::vector<Ipv6Address> globalAddresses;
+            for (uint32_t m = 0; m < device.ipv6->GetNAddresses(); ++m)
             {
-                NS_LOG_LOGIC("Skip the LINKLOCAL or LOCALHOST interface " << neighborDeviceIfAddr);
-                continue;
+                Ipv6InterfaceAddress ifAddr = device.ipv6->GetAddress(m);
+                if (ifAddr.GetScope() == Ipv6InterfaceAddress::LINKLOCAL ||
+                    ifAddr.GetScope() == Ipv6InterfaceAddress::HOST)
+                {
+                    NS_LOG_LOGIC("Skip the LINKLOCAL or LOCALHOST interface " << ifAddr);
+                    continue;
+                }
+                neighbors.ndisc->Add(ifAddr.GetAddress(), device.device, {ifAddr.GetAddress()});
+                globalAddresses.push_back(ifAddr.GetAddress());
             }
-            if (netDeviceIfAddr.IsInSameSubnet(neighborDeviceIfAddr.GetAddress()))
+            if (!globalAddresses.empty())
             {
-                Ptr<NetDevice> neighborDevice = neighborDeviceInterface->GetDevice();
-                // Add neighbor's Ndisc entries of global address and linklocal address to current
-                // interface's Ndisc cache
-                AddEntry(ipv6Interface,
-                         neighborDeviceIfAddr.GetAddress(),
-                         neighborDevice->GetAddress());
-                Ipv6InterfaceAddress neighborlinkLocalAddr =
-                    neighborDeviceInterface->GetLinkLocalAddress();
-                AddEntry(ipv6Interface,
-                         neighborlinkLocalAddr.GetAddress(),
-                         neighborDevice->GetAddress());
+                neighbors.ndisc->Add(device.ipv6->GetLinkLocalAddress().GetAddress(),
+                                     device.device,
+                                     globalAddresses);
             }
         }
     }
+    return neighbors;
+}
+
+void
+NeighborCacheHelper::PopulateNeighborEntries(const ChannelDevice& netDevice,
+                                             const ChannelNeighbors& neighbors) const
+{
+    NS_LOG_FUNCTION(this << netDevice.device);
+    if (netDevice.ipv4)
+    {
+        PopulateNeighborEntriesIpv4(netDevice.ipv4, neighbors.arp);
+    }
+    if (netDevice.ipv6)
+    {
+        PopulateNeighborEntriesIpv6(netDevice.ipv6, neighbors.ndisc);
+    }
 }
 
 void
-NeighborCacheHelper::AddEntry(Ptr<Ipv4Interface> netDeviceInterface,
-                              Ipv4Address ipv4Address,
-                              Address macAddress) const
+NeighborCacheHelper::PopulateNeighborEntriesIpv4(Ptr<Ipv4Interface> ipv4Interface,
+                                                 Ptr<ArpCache::Neighbors> neighbors) const
 {
-    NS_LOG_FUNCTION(this << netDeviceInterface << ipv4Address << macAddress);
-    Ptr<ArpCache> arpCache = netDeviceInterface->GetArpCache();
+    if (m_dynamicNeighborCache)
+    {
+        ipv4Interface->RemoveAddressCallback(
+            MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv4AddressRemoved, this));
+        if (m_globalNeighborCache)
+        {
+            ipv4Interface->AddAddressCallback(
+                MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv4AddressAdded, this));
+        }
+    }
+    Ptr<ArpCache> arpCache = ipv4Interface->GetArpCache();
     if (!arpCache)
     {
         NS_LOG_LOGIC(
             "ArpCache doesn't exist, might be a point-to-point NetDevice without ArpCache");
         return;
     }
-    ArpCache::Entry* entry = arpCache->Lookup(ipv4Address);
-    if (!entry)
-    {
-        NS_LOG_FUNCTION("ADD an ARP entry");
-        entry = arpCache->Add(ipv4Address);
-    }
-    entry->SetMacAddress(macAddress);
-    entry->MarkAutoGenerated();
+    arpCache->SetNeighbors(neighbors);
 }
 
 void
-NeighborCacheHelper::AddEntry(Ptr<Ipv6Interface> netDeviceInterface,
-                              Ipv6Address ipv6Address,
-                              Address macAddress) const
+NeighborCacheHelper::PopulateNeighborEntriesIpv6(Ptr<Ipv6Interface> ipv6Interface,
+                                                 Ptr<NdiscCache::Neighbors> neighbors) const
 {
-    NS_LOG_FUNCTION(this << netDeviceInterface << ipv6Address << macAddress);
-    Ptr<NdiscCache> ndiscCache = netDeviceInterface->GetNdiscCache();
+    if (m_dynamicNeighborCache)
+    {
+        ipv6Interface->RemoveAddressCallback(
+            MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv6AddressRemoved, this));
+        if (m_globalNeighborCache)
+        {
+            ipv6Interface->AddAddressCallback(
+                MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv6AddressAdded, this));
+        }
+    }
+    Ptr<NdiscCache> ndiscCache = ipv6Interface->GetNdiscCache();
     if (!ndiscCache)
     {
         NS_LOG_LOGIC(
             "NdiscCache doesn't exist, might be a point-to-point NetDevice without NdiscCache");
         return;
     }
-    NdiscCache::Entry* entry = ndiscCache->Lookup(ipv6Address);
-    if (!entry)
-    {
-        NS_LOG_FUNCTION("ADD a NDISC entry");
-        entry = ndiscCache->Add(ipv6Address);
-    }
-    entry->SetMacAddress(macAddress);
-    entry->MarkAutoGenerated();
+    ndiscCache->SetNeighbors(neighbors);
 }
 
 void
@@ -433,28 +321,21 @@ NeighborCacheHelper::UpdateCacheByIpv4AddressRemoved(const Ptr<Ipv4Interface> in
 {
     NS_LOG_FUNCTION(this);
     Ptr<NetDevice> netDevice = interface->GetDevice();
-    Ptr<Channel> channel = netDevice->GetChannel();
-    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    std::vector<ChannelDevice> devices = GetChannelDevices(netDevice->GetChannel());
+    // update the shared addresses first, then the entries of every cache
+    for (const auto& device : devices)
     {
-        Ptr<NetDevice> neighborDevice = channel->GetDevice(i);
-        Ptr<Node> neighborNode = neighborDevice->GetNode();
-        int32_t neighborInterfaceIndex =
-            neighborNode->GetObject<Ipv4>()->GetInterfaceForDevice(neighborDevice);
-        if (neighborInterfaceIndex != -1)
+        if (device.ipv4 && device.ipv4->GetArpCache() &&
+            device.ipv4->GetArpCache()->GetNeighbors())
         {
-            Ptr<Ipv4Interface> neighborInterface =
-                neighborNode->GetObject<Ipv4L3Protocol>()->GetInterface(neighborInterfaceIndex);
-            Ptr<ArpCache> arpCache = neighborInterface->GetArpCache();
-            if (!arpCache)
-            {
-                NS_LOG_LOGIC("ArpCache doesn't exist");
-                return;
-            }
-            ArpCache::Entry* entry = arpCache->Lookup(ifAddr.GetLocal());
-            if (entry)
-            {
-                arpCache->Remove(entry);
-            }
+            device.ipv4->GetArpCache()->GetNeighbors()->Remove(ifAddr.GetLocal(), netDevice);
+        }
+    }
+    for (const auto& device : devices)
+    {
+        if (device.ipv4 && device.ipv4->GetArpCache())
+        {
+            device.ipv4->GetArpCache()->RemoveNeighbor(ifAddr.GetLocal());
         }
     }
 }
@@ -465,30 +346,21 @@ NeighborCacheHelper::UpdateCacheByIpv4AddressAdded(const Ptr<Ipv4Interface> inte
 {
     NS_LOG_FUNCTION(this);
     Ptr<NetDevice> netDevice = interface->GetDevice();
-    Ptr<Channel> channel = netDevice->GetChannel();
-    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    std::vector<ChannelDevice> devices = GetChannelDevices(netDevice->GetChannel());
+    for (const auto& device : devices)
     {
-        Ptr<NetDevice> neighborDevice = channel->GetDevice(i);
-        if (neighborDevice != netDevice)
+        if (device.ipv4 && device.ipv4->GetArpCache() &&
+            device.ipv4->GetArpCache()->GetNeighbors())
         {
-            Ptr<Node> neighborNode = neighborDevice->GetNode();
-            int32_t neighborInterfaceIndex =
-                neighborNode->GetObject<Ipv4>()->GetInterfaceForDevice(neighborDevice);
-            if (neighborInterfaceIndex != -1)
-            {
-                Ptr<Ipv4Interface> neighborInterface =
-                    neighborNode->GetObject<Ipv4L3Protocol>()->GetInterface(neighborInterfaceIndex);
-                uint32_t neighborDeviceAddresses = neighborInterface->GetNAddresses();
-                for (uint32_t m = 0; m < neighborDeviceAddresses; ++m)
-                {
-                    Ipv4InterfaceAddress neighborDeviceIfAddr = neighborInterface->GetAddress(m);
-                    if (ifAddr.IsInSameSubnet(neighborDeviceIfAddr.GetLocal()))
-                    {
-                        // Add Arp entity of current interface to its neighbor's Arp cache
-                        AddEntry(neighborInterface, ifAddr.GetAddress(), netDevice->GetAddress());
-                    }
-                }
-            }
+            device.ipv4->GetArpCache()->GetNeighbors()->Add(ifAddr.GetLocal(), netDevice);
+        }
+    }
+    for (const auto& device : devices)
+    {
+        if (device.device != netDevice && device.ipv4 && device.ipv4->GetArpCache())
+        {
+            // Add Arp entity of current interface to its neighbor's Arp cache
+            device.ipv4->GetArpCache()->UpdateNeighbor(ifAddr.GetLocal());
         }
     }
 }
@@ -499,28 +371,21 @@ NeighborCacheHelper::UpdateCacheByIpv6AddressRemoved(const Ptr<Ipv6Interface> in
 {
     NS_LOG_FUNCTION(this);
     Ptr<NetDevice> netDevice = interface->GetDevice();
-    Ptr<Channel> channel = netDevice->GetChannel();
-    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    std::vector<ChannelDevice> devices = GetChannelDevices(netDevice->GetChannel());
+    // update the shared addresses first, then the entries of every cache
+    for (const auto& device : devices)
     {
-        Ptr<NetDevice> neighborDevice = channel->GetDevice(i);
-        Ptr<Node> neighborNode = neighborDevice->GetNode();
-        int32_t neighborInterfaceIndex =
-            neighborNode->GetObject<Ipv6>()->GetInterfaceForDevice(neighborDevice);
-        if (neighborInterfaceIndex != -1)
+        if (device.ipv6 && device.ipv6->GetNdiscCache() &&
+            device.ipv6->GetNdiscCache()->GetNeighbors())
         {
-            Ptr<Ipv6Interface> neighborInterface =
-                neighborNode->GetObject<Ipv6L3Protocol>()->GetInterface(neighborInterfaceIndex);
-            Ptr<NdiscCache> ndiscCache = neighborInterface->GetNdiscCache();
-            if (!ndiscCache)
-            {
-                NS_LOG_LOGIC("ndiscCache doesn't exist");
-                return;
-            }
-            NdiscCache::Entry* entry = ndiscCache->Lookup(ifAddr.GetAddress());
-            if (entry)
-            {
-                ndiscCache->Remove(entry);
-            }
+            device.ipv6->GetNdiscCache()->GetNeighbors()->Remove(ifAddr.GetAddress(), netDevice);
+        }
+    }
+    for (const auto& device : devices)
+    {
+        if (device.ipv6 && device.ipv6->GetNdiscCache())
+        {
+            device.ipv6->GetNdiscCache()->RemoveNeighbor(ifAddr.GetAddress());
         }
     }
 }
@@ -531,30 +396,23 @@ NeighborCacheHelper::UpdateCacheByIpv6AddressAdded(const Ptr<Ipv6Interface> inte
 {
     NS_LOG_FUNCTION(this);
     Ptr<NetDevice> netDevice = interface->GetDevice();
-    Ptr<Channel> channel = netDevice->GetChannel();
-    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    std::vector<ChannelDevice> devices = GetChannelDevices(netDevice->GetChannel());
+    for (const auto& device : devices)
     {
-        Ptr<NetDevice> neighborDevice = channel->GetDevice(i);
-        if (neighborDevice != netDevice)
+        if (device.ipv6 && device.ipv6->GetNdiscCache() &&
+            device.ipv6->GetNdiscCache()->GetNeighbors())
         {
-            Ptr<Node> neighborNode = neighborDevice->GetNode();
-            int32_t neighborInterfaceIndex =
-                neighborNode->GetObject<Ipv6>()->GetInterfaceForDevice(neighborDevice);
-            if (neighborInterfaceIndex != -1)
-            {
-                Ptr<Ipv6Interface> neighborInterface =
-                    neighborNode->GetObject<Ipv6L3Protocol>()->GetInterface(neighborInterfaceIndex);
-                uint32_t neighborDeviceAddresses = neighborInterface->GetNAddresses();
-                for (uint32_t m = 0; m < neighborDeviceAddresses; ++m)
-                {
-                    Ipv6InterfaceAddress neighborDeviceIfAddr = neighborInterface->GetAddress(m);
-                    if (ifAddr.IsInSameSubnet(neighborDeviceIfAddr.GetAddress()))
-                    {
-                        // Add Arp entity of current interface to its neighbor's Arp cache
-                        AddEntry(neighborInterface, ifAddr.GetAddress(), netDevice->GetAddress());
-                    }
-                }
-            }
+            device.ipv6->GetNdiscCache()->GetNeighbors()->Add(ifAddr.GetAddress(),
+                                                              netDevice,
+                                                              {ifAddr.GetAddress()});
+        }
+    }
+    for (const auto& device : devices)
+    {
+        if (device.device != netDevice && device.ipv6 && device.ipv6->GetNdiscCache())
+        {
+            // Add Ndisc entity of current interface to its neighbor's Ndisc cache
+            device.ipv6->GetNdiscCache()->UpdateNeighbor(ifAddr.GetAddress());
         }
     }
 }
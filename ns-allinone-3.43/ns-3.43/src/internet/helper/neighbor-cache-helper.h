@@ -22,9 +22,12 @@
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv6-interface.h"
 #include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ndisc-cache.h"
 #include "ns3/net-device-container.h"
 #include "ns3/node-list.h"
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -95,40 +98,78 @@ class NeighborCacheHelper
 
   private:
     /**
-     * \brief Populate neighbor ARP entries for given IPv4 interface.
-     * \param ipv4Interface the Ipv4Interface to process
-     * \param neighborDeviceInterface the potential neighbor Ipv4Interface
+     * \brief A device attached to a channel, with its IP interfaces
      */
-    void PopulateNeighborEntriesIpv4(Ptr<Ipv4Interface> ipv4Interface,
-                                     Ptr<Ipv4Interface> neighborDeviceInterface) const;
+    struct ChannelDevice
+    {
+        Ptr<NetDevice> device;   //!< the device
+        Ptr<Ipv4Interface> ipv4; //!< the IPv4 interface of the device, if any
+        Ptr<Ipv6Interface> ipv6; //!< the IPv6 interface of the device, if any
+    };
 
     /**
-     * \brief Populate neighbor NDISC entries for given IPv6 interface.
-     * \param ipv6Interface the Ipv6Interface to process
-     * \param neighborDeviceInterface the potential neighbor Ipv6Interface
+     * \brief Find the IP interfaces of a device.
+     * \param netDevice the device
+     * \return the device with its IP interfaces
      */
-    void PopulateNeighborEntriesIpv6(Ptr<Ipv6Interface> ipv6Interface,
-                                     Ptr<Ipv6Interface> neighborDeviceInterface) const;
+    ChannelDevice GetChannelDevice(Ptr<NetDevice> netDevice) const;
+
+    /**
+     * \brief Find the IP interfaces of all the devices attached to a channel.
+     *
+     * The interfaces are looked up once per device, so that populating the
+     * caches of all the devices of a channel does not look them up for every
+     * pair of devices.
+     * \param channel the channel
+     * \return the devices of the channel, with their IP interfaces
+     */
+    std::vector<ChannelDevice> GetChannelDevices(Ptr<Channel> channel) const;
+
+    /**
+     * \brief The addresses of the devices attached to a channel, shared by
+     * their neighbor caches
+     */
+    struct ChannelNeighbors
+    {
+        Ptr<ArpCache::Neighbors> arp;     //!< the IPv4 addresses of the devices
+        Ptr<NdiscCache::Neighbors> ndisc; //!< the IPv6 addresses of the devices
+    };
 
     /**
-     * \brief Add an auto_generated entry to the ARP cache of an interface.
-     * \param netDeviceInterface the Ipv4Interface that ARP cache belongs to
-     * \param ipv4Address the IPv4 address will be added to the cache.
-     * \param macAddress the MAC address will be added to the cache.
+     * \brief Collect the addresses of the devices attached to a channel.
+     *
+     * The caches of the devices share these addresses and create the entries
+     * of their neighbors when they need them, so that populating the caches
+     * of a channel costs one entry per address and not one entry per device
+     * and neighbor.
+     * \param devices the devices of the channel
+     * \return the addresses of the devices
      */
-    void AddEntry(Ptr<Ipv4Interface> netDeviceInterface,
-                  Ipv4Address ipv4Address,
-                  Address macAddress) const;
+    ChannelNeighbors GetChannelNeighbors(const std::vector<ChannelDevice>& devices) const;
 
     /**
-     * \brief Add an auto_generated entry to the NDISC cache of an interface.
-     * \param netDeviceInterface the Ipv6Interface that NDISC cache belongs to
-     * \param ipv6Address the IPv6 address will be added to the cache.
-     * \param macAddress the MAC address will be added to the cache.
+     * \brief Populate the neighbor ARP and NDISC entries of a device.
+     * \param netDevice the device to process
+     * \param neighbors the addresses of the devices attached to the same channel
      */
-    void AddEntry(Ptr<Ipv6Interface> netDeviceInterface,
-                  Ipv6Address ipv6Address,
-                  Address macAddress) const;
+    void PopulateNeighborEntries(const ChannelDevice& netDevice,
+                                 const ChannelNeighbors& neighbors) const;
+
+    /**
+     * \brief Populate neighbor ARP entries for given IPv4 interface.
+     * \param ipv4Interface the Ipv4Interface to process
+     * \param neighbors the IPv4 addresses of the devices attached to the same channel
+     */
+    void PopulateNeighborEntriesIpv4(Ptr<Ipv4Interface> ipv4Interface,
+                                     Ptr<ArpCache::Neighbors> neighbors) const;
+
+    /**
+     * \brief Populate neighbor NDISC entries for given IPv6 interface.
+     * \param ipv6Interface the Ipv6Interface to process
+     * \param neighbors the IPv6 addresses of the devices attached to the same channel
+     */
+    void PopulateNeighborEntriesIpv6(Ptr<Ipv6Interface> ipv6Interface,
+                                     Ptr<NdiscCache::Neighbors> neighbors) const;
 
     /**
      * \brief Update neighbor caches when an address is removed from a Ipv4Interface with auto
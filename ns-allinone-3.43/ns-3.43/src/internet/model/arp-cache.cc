@@ -8,6 +8,7 @@
 #include "arp-cache.h"
 
 #include "ipv4-header.h"
+#include "ipv4-interface-address.h"
 #include "ipv4-interface.h"
 
 #include "ns3/assert.h"
@@ -19,6 +20,9 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace ns3
 {
 
@@ -186,39 +190,48 @@ void
 ArpCache::HandleWaitReplyTimeout()
 {
     NS_LOG_FUNCTION(this);
-    ArpCache::Entry* entry;
     bool restartWaitReplyTimer = false;
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    // Only the entries waiting for a reply are visited. The requests may
+    // change the state of the entries, hence the copy of their addresses.
+    std::vector<Ipv4Address> addresses;
+    addresses.reserve(m_waitReplyEntries.size());
+    for (const auto& waiting : m_waitReplyEntries)
     {
-        entry = (*i).second;
-        if (entry != nullptr && entry->IsWaitReply())
+        addresses.push_back(waiting.first);
+    }
+    for (const auto& address : addresses)
+    {
+        auto i = m_waitReplyEntries.find(address);
+        if (i == m_waitReplyEntries.end())
         {
-            if (entry->GetRetries() < m_maxRetries)
-            {
-                NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", ArpWaitTimeout for "
-                                     << entry->GetIpv4Address()
-                                     << " expired -- retransmitting arp request since retries = "
-                                     << entry->GetRetries());
-                m_arpRequestCallback(this, entry->GetIpv4Address());
-                restartWaitReplyTimer = true;
-                entry->IncrementRetries();
-            }
-            else
+            continue;
+        }
+        ArpCache::Entry* entry = i->second;
+        if (entry->GetRetries() < m_maxRetries)
+        {
+            NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", ArpWaitTimeout for "
+                                 << entry->GetIpv4Address()
+                                 << " expired -- retransmitting arp request since retries = "
+                                 << entry->GetRetries());
+            m_arpRequestCallback(this, entry->GetIpv4Address());
+            restartWaitReplyTimer = true;
+            entry->IncrementRetries();
+        }
+        else
+        {
+            NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", wait reply for "
+                                 << entry->GetIpv4Address()
+                                 << " expired -- drop since max retries exceeded: "
+                                 << entry->GetRetries());
+            entry->MarkDead();
+            entry->ClearRetries();
+            Ipv4PayloadHeaderPair pending = entry->DequeuePending();
+            while (pending.first)
             {
-                NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", wait reply for "
-                                     << entry->GetIpv4Address()
-                                     << " expired -- drop since max retries exceeded: "
-                                     << entry->GetRetries());
-                entry->MarkDead();
-                entry->ClearRetries();
-                Ipv4PayloadHeaderPair pending = entry->DequeuePending();
-                while (pending.first)
-                {
-                    // add the Ipv4 header for tracing purposes
-                    pending.first->AddHeader(pending.second);
-                    m_dropTrace(pending.first);
-                    pending = entry->DequeuePending();
-                }
+                // add the Ipv4 header for tracing purposes
+                pending.first->AddHeader(pending.second);
+                m_dropTrace(pending.first);
+                pending = entry->DequeuePending();
             }
         }
     }
@@ -238,7 +251,11 @@ ArpCache::Flush()
     {
         delete (*i).second;
     }
-    m_arpCache.erase(m_arpCache.begin(), m_arpCache.end());
+    m_arpCache.clear();
+    m_macIndex.clear();
+    m_waitReplyEntries.clear();
+    m_neighbors = nullptr;
+    m_removedNeighbors.clear();
     if (m_waitReplyTimer.IsPending())
     {
         NS_LOG_LOGIC("Stopping WaitReplyTimer at " << Simulator::Now().GetSeconds()
@@ -253,7 +270,20 @@ ArpCache::PrintArpCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    if (m_neighbors)
+    {
+        for (const auto& address : m_neighbors->GetAddresses())
+        {
+            if (m_arpCache.find(address) == m_arpCache.end())
+            {
+                AddNeighbor(address);
+            }
+        }
+    }
+
+    // print the entries in order of IPv4 address
+    std::map<Ipv4Address, ArpCache::Entry*> entries(m_arpCache.begin(), m_arpCache.end());
+    for (auto i = entries.begin(); i != entries.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -300,12 +330,109 @@ ArpCache::RemoveAutoGeneratedEntries()
         if (i->second->IsAutoGenerated())
         {
             i->second->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
-            delete i->second;
-            m_arpCache.erase(i++);
+            DeleteEntry(i->second);
+            i = m_arpCache.erase(i);
             continue;
         }
         i++;
     }
+    m_neighbors = nullptr;
+    m_removedNeighbors.clear();
+}
+
+void
+ArpCache::SetNeighbors(Ptr<Neighbors> neighbors)
+{
+    NS_LOG_FUNCTION(this << neighbors);
+    m_neighbors = neighbors;
+    m_removedNeighbors.clear();
+    for (const auto& [address, entry] : m_arpCache)
+    {
+        Ptr<NetDevice> neighbor = FindNeighbor(address);
+        if (neighbor)
+        {
+            entry->SetMacAddress(neighbor->GetAddress());
+            entry->MarkAutoGenerated();
+        }
+    }
+}
+
+Ptr<ArpCache::Neighbors>
+ArpCache::GetNeighbors() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_neighbors;
+}
+
+void
+ArpCache::RemoveNeighbor(Ipv4Address address)
+{
+    NS_LOG_FUNCTION(this << address);
+    auto it = m_arpCache.find(address);
+    if (it != m_arpCache.end())
+    {
+        Remove(it->second);
+    }
+    else if (m_neighbors && m_neighbors->Find(address, m_device))
+    {
+        m_removedNeighbors.insert(address);
+    }
+}
+
+void
+ArpCache::UpdateNeighbor(Ipv4Address address)
+{
+    NS_LOG_FUNCTION(this << address);
+    m_removedNeighbors.erase(address);
+    auto it = m_arpCache.find(address);
+    Ptr<NetDevice> neighbor = FindNeighbor(address);
+    if (it != m_arpCache.end() && neighbor)
+    {
+        it->second->SetMacAddress(neighbor->GetAddress());
+        it->second->MarkAutoGenerated();
+    }
+}
+
+Ptr<NetDevice>
+ArpCache::FindNeighbor(Ipv4Address to) const
+{
+    NS_LOG_FUNCTION(this << to);
+    if (!m_neighbors || !m_interface)
+    {
+        return nullptr;
+    }
+    Ptr<NetDevice> neighbor = m_neighbors->Find(to, m_device);
+    if (!neighbor)
+    {
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < m_interface->GetNAddresses(); ++i)
+    {
+        if (m_interface->GetAddress(i).IsInSameSubnet(to))
+        {
+            return neighbor;
+        }
+    }
+    return nullptr;
+}
+
+ArpCache::Entry*
+ArpCache::AddNeighbor(Ipv4Address to)
+{
+    NS_LOG_FUNCTION(this << to);
+    if (m_removedNeighbors.find(to) != m_removedNeighbors.end())
+    {
+        return nullptr;
+    }
+    Ptr<NetDevice> neighbor = FindNeighbor(to);
+    if (!neighbor)
+    {
+        return nullptr;
+    }
+    ArpCache::Entry* entry = Add(to);
+    entry->SetMacAddress(neighbor->GetAddress());
+    entry->MarkAutoGenerated();
+    return entry;
 }
 
 std::list<ArpCache::Entry*>
@@ -313,15 +440,23 @@ ArpCache::LookupInverse(Address to)
 {
     NS_LOG_FUNCTION(this << to);
 
-    std::list<ArpCache::Entry*> entryList;
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    if (m_neighbors)
     {
-        ArpCache::Entry* entry = (*i).second;
-        if (entry->GetMacAddress() == to)
+        for (const auto& address : m_neighbors->GetAddresses(to))
         {
-            entryList.push_back(entry);
+            if (m_arpCache.find(address) == m_arpCache.end())
+            {
+                AddNeighbor(address);
+            }
         }
     }
+
+    std::list<ArpCache::Entry*> entryList;
+    auto range = m_macIndex.equal_range(to);
+    for (auto i = range.first; i != range.second; i++)
+    {
+        entryList.push_back(i->second);
+    }
     return entryList;
 }
 
@@ -334,6 +469,10 @@ ArpCache::Lookup(Ipv4Address to)
     {
         return it->second;
     }
+    if (m_neighbors)
+    {
+        return AddNeighbor(to);
+    }
     return nullptr;
 }
 
@@ -346,6 +485,7 @@ ArpCache::Add(Ipv4Address to)
     auto entry = new ArpCache::Entry(this);
     m_arpCache[to] = entry;
     entry->SetIpv4Address(to);
+    AddToMacIndex(entry);
     return entry;
 }
 
@@ -354,19 +494,56 @@ ArpCache::Remove(ArpCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    auto it = m_arpCache.find(entry->GetIpv4Address());
+    if (it != m_arpCache.end() && it->second == entry)
     {
-        if ((*i).second == entry)
+        m_arpCache.erase(it);
+        if (m_neighbors && m_neighbors->Find(entry->GetIpv4Address(), m_device))
         {
-            m_arpCache.erase(i);
-            entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
-            delete entry;
-            return;
+            // do not create the entry again from the neighbors
+            m_removedNeighbors.insert(entry->GetIpv4Address());
         }
+        entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
+        DeleteEntry(entry);
+        return;
     }
     NS_LOG_WARN("Entry not found in this ARP Cache");
 }
 
+void
+ArpCache::AddToMacIndex(ArpCache::Entry* entry)
+{
+    NS_LOG_FUNCTION(this << entry);
+    m_macIndex.emplace(entry->GetMacAddress(), entry);
+}
+
+void
+ArpCache::RemoveFromMacIndex(ArpCache::Entry* entry)
+{
+    NS_LOG_FUNCTION(this << entry);
+    auto range = m_macIndex.equal_range(entry->GetMacAddress());
+    for (auto i = range.first; i != range.second; i++)
+    {
+        if (i->second == entry)
+        {
+            m_macIndex.erase(i);
+            return;
+        }
+    }
+}
+
+void
+ArpCache::DeleteEntry(ArpCache::Entry* entry)
+{
+    NS_LOG_FUNCTION(this << entry);
+    RemoveFromMacIndex(entry);
+    if (entry->IsWaitReply())
+    {
+        m_waitReplyEntries.erase(entry->GetIpv4Address());
+    }
+    delete entry;
+}
+
 ArpCache::Entry::Entry(ArpCache* arp)
     : m_arp(arp),
       m_state(ALIVE),
@@ -415,7 +592,7 @@ ArpCache::Entry::MarkDead()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(m_state == ALIVE || m_state == WAIT_REPLY || m_state == DEAD);
-    m_state = DEAD;
+    SetState(DEAD);
     ClearRetries();
     UpdateSeen();
 }
@@ -425,8 +602,8 @@ ArpCache::Entry::MarkAlive(Address macAddress)
 {
     NS_LOG_FUNCTION(this << macAddress);
     NS_ASSERT(m_state == WAIT_REPLY);
-    m_macAddress = macAddress;
-    m_state = ALIVE;
+    SetMacAddress(macAddress);
+    SetState(ALIVE);
     ClearRetries();
     UpdateSeen();
 }
@@ -437,7 +614,7 @@ ArpCache::Entry::MarkPermanent()
     NS_LOG_FUNCTION(this << m_macAddress);
     NS_ASSERT(!m_macAddress.IsInvalid());
 
-    m_state = PERMANENT;
+    SetState(PERMANENT);
     ClearRetries();
     UpdateSeen();
 }
@@ -448,7 +625,7 @@ ArpCache::Entry::MarkAutoGenerated()
     NS_LOG_FUNCTION(this << m_macAddress);
     NS_ASSERT(!m_macAddress.IsInvalid());
 
-    m_state = STATIC_AUTOGENERATED;
+    SetState(STATIC_AUTOGENERATED);
     ClearRetries();
     UpdateSeen();
 }
@@ -478,7 +655,7 @@ ArpCache::Entry::MarkWaitReply(Ipv4PayloadHeaderPair waiting)
     NS_ASSERT(m_pending.empty());
     NS_ASSERT_MSG(waiting.first, "Can not add a null packet to the ARP queue");
 
-    m_state = WAIT_REPLY;
+    SetState(WAIT_REPLY);
     m_pending.push_back(waiting);
     UpdateSeen();
     m_arp->StartWaitReplyTimer();
@@ -495,7 +672,9 @@ void
 ArpCache::Entry::SetMacAddress(Address macAddress)
 {
     NS_LOG_FUNCTION(this);
+    m_arp->RemoveFromMacIndex(this);
     m_macAddress = macAddress;
+    m_arp->AddToMacIndex(this);
 }
 
 Ipv4Address
@@ -509,9 +688,26 @@ void
 ArpCache::Entry::SetIpv4Address(Ipv4Address destination)
 {
     NS_LOG_FUNCTION(this << destination);
+    NS_ASSERT_MSG(m_state != WAIT_REPLY,
+                  "Cannot change the address of an entry waiting for a reply");
     m_ipv4Address = destination;
 }
 
+void
+ArpCache::Entry::SetState(ArpCacheEntryState_e state)
+{
+    NS_LOG_FUNCTION(this << state);
+    if (m_state == WAIT_REPLY && state != WAIT_REPLY)
+    {
+        m_arp->m_waitReplyEntries.erase(m_ipv4Address);
+    }
+    else if (m_state != WAIT_REPLY && state == WAIT_REPLY)
+    {
+        m_arp->m_waitReplyEntries[m_ipv4Address] = this;
+    }
+    m_state = state;
+}
+
 Time
 ArpCache::Entry::GetTimeout() const
 {
@@ -594,4 +790,87 @@ ArpCache::Entry::ClearRetries()
     m_retries = 0;
 }
 
+void
+ArpCache::Neighbors::Add(Ipv4Address address, Ptr<NetDevice> device)
+{
+    NS_LOG_FUNCTION(this << address << device);
+    std::vector<Ptr<NetDevice>>& devices = m_devices[address];
+    if (std::find(devices.begin(), devices.end(), device) == devices.end())
+    {
+        devices.push_back(device);
+        m_addresses.emplace(device->GetAddress(), address);
+    }
+}
+
+void
+ArpCache::Neighbors::Remove(Ipv4Address address, Ptr<NetDevice> device)
+{
+    NS_LOG_FUNCTION(this << address << device);
+    auto it = m_devices.find(address);
+    if (it == m_devices.end())
+    {
+        return;
+    }
+    auto position = std::find(it->second.begin(), it->second.end(), device);
+    if (position == it->second.end())
+    {
+        return;
+    }
+    it->second.erase(position);
+    if (it->second.empty())
+    {
+        m_devices.erase(it);
+    }
+    auto range = m_addresses.equal_range(device->GetAddress());
+    for (auto i = range.first; i != range.second; i++)
+    {
+        if (i->second == address)
+        {
+            m_addresses.erase(i);
+            break;
+        }
+    }
+}
+
+Ptr<NetDevice>
+ArpCache::Neighbors::Find(Ipv4Address address, Ptr<NetDevice> device) const
+{
+    auto it = m_devices.find(address);
+    if (it == m_devices.end())
+    {
+        return nullptr;
+    }
+    for (auto i = it->second.rbegin(); i != it->second.rend(); i++)
+    {
+        if (*i != device)
+        {
+            return *i;
+        }
+    }
+    return nullptr;
+}
+
+std::list<Ipv4Address>
+ArpCache::Neighbors::GetAddresses(Address mac) const
+{
+    std::list<Ipv4Address> addresses;
+    auto range = m_addresses.equal_range(mac);
+    for (auto i = range.first; i != range.second; i++)
+    {
+        addresses.push_back(i->second);
+    }
+    return addresses;
+}
+
+std::list<Ipv4Address>
+ArpCache::Neighbors::GetAddresses() const
+{
+    std::list<Ipv4Address> addresses;
+    for (const auto& neighbor : m_devices)
+    {
+        addresses.push_back(neighbor.first);
+    }
+    return addresses;
+}
+
 } // namespace ns3
@@ -17,12 +17,16 @@
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
 #include "ns3/simulator.h"
 #include "ns3/traced-callback.h"
 
 #include <list>
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace ns3
 {
@@ -37,6 +41,16 @@ class Ipv4Header;
  *
  * A cached lookup table for translating layer 3 addresses to layer 2.
  * This implementation does lookups from IPv4 to a MAC address
+ *
+ * The entries are hashed by IPv4 address, and indexed by MAC address for
+ * the inverse lookups.  The entries do not schedule any event: their
+ * expiration is checked when they are used, and a single timer per cache
+ * retransmits the requests of the entries waiting for a reply.
+ *
+ * The caches of the devices of a channel can share the addresses of their
+ * neighbors (ArpCache::Neighbors), filled once for the channel by the
+ * NeighborCacheHelper.  The auto-generated entries of the neighbors are then
+ * created when they are first looked up, inverse looked up or printed.
  */
 class ArpCache : public Object
 {
@@ -47,6 +61,7 @@ class ArpCache : public Object
      */
     static TypeId GetTypeId();
     class Entry;
+    class Neighbors;
 
     ArpCache();
     ~ArpCache() override;
@@ -158,9 +173,41 @@ class ArpCache : public Object
 
     /**
      * \brief Clear the ArpCache of all Auto-Generated entries
+     *
+     * The cache also stops using the neighbors it shares.
      */
     void RemoveAutoGeneratedEntries();
 
+    /**
+     * \brief Use the addresses of the neighbors of the device.
+     *
+     * The neighbors on the subnets of the interface are auto-generated
+     * entries of the cache, which are created when they are needed.  The
+     * entries of the cache for these neighbors become auto-generated.
+     *
+     * \param neighbors the addresses of the devices of the channel
+     */
+    void SetNeighbors(Ptr<Neighbors> neighbors);
+    /**
+     * \brief Get the addresses of the neighbors used by the cache.
+     * \return the addresses of the neighbors, or nullptr
+     */
+    Ptr<Neighbors> GetNeighbors() const;
+    /**
+     * \brief Remove the entry of a neighbor.
+     *
+     * The entry is not created again from the neighbors, unless
+     * UpdateNeighbor is called for its address.
+     *
+     * \param address the IPv4 address of the neighbor
+     */
+    void RemoveNeighbor(Ipv4Address address);
+    /**
+     * \brief Update the entry of a neighbor, after a change of its address.
+     * \param address the IPv4 address of the neighbor
+     */
+    void UpdateNeighbor(Ipv4Address address);
+
     /**
      * \brief Pair of a packet and an Ipv4 header.
      */
@@ -297,6 +344,13 @@ class ArpCache : public Object
          */
         Time GetTimeout() const;
 
+        /**
+         * \brief Changes the state of this entry, and keeps track of the
+         * entries waiting for a reply
+         * \param state the new state
+         */
+        void SetState(ArpCacheEntryState_e state);
+
         ArpCache* m_arp;              //!< pointer to the ARP cache owning the entry
         ArpCacheEntryState_e m_state; //!< state of the entry
         Time m_lastSeen;              //!< last moment a packet from that address has been seen
@@ -306,15 +360,93 @@ class ArpCache : public Object
         uint32_t m_retries;                         //!< retry counter
     };
 
+    /**
+     * \brief The IPv4 addresses of the devices of a channel.
+     *
+     * The addresses are shared by the ARP caches of the devices, which create
+     * the auto-generated entries of their neighbors from them.
+     */
+    class Neighbors : public SimpleRefCount<Neighbors>
+    {
+      public:
+        /**
+         * \brief Add an address of a device.
+         * \param address the IPv4 address
+         * \param device the device
+         */
+        void Add(Ipv4Address address, Ptr<NetDevice> device);
+        /**
+         * \brief Remove an address of a device.
+         * \param address the IPv4 address
+         * \param device the device
+         */
+        void Remove(Ipv4Address address, Ptr<NetDevice> device);
+        /**
+         * \brief Find the neighbor of a device owning an address.
+         *
+         * If several devices own the address, the last one added wins.
+         *
+         * \param address the IPv4 address
+         * \param device the device looking for its neighbor
+         * \return the neighbor, or nullptr
+         */
+        Ptr<NetDevice> Find(Ipv4Address address, Ptr<NetDevice> device) const;
+        /**
+         * \brief Get the addresses of the devices with a MAC address.
+         * \param mac the MAC address
+         * \return the IPv4 addresses
+         */
+        std::list<Ipv4Address> GetAddresses(Address mac) const;
+        /**
+         * \brief Get all the addresses.
+         * \return the IPv4 addresses
+         */
+        std::list<Ipv4Address> GetAddresses() const;
+
+      private:
+        /// the devices owning each address, in order of addition
+        std::unordered_map<Ipv4Address, std::vector<Ptr<NetDevice>>, Ipv4AddressHash> m_devices;
+        /// the addresses, by MAC address of their devices
+        std::multimap<Address, Ipv4Address> m_addresses;
+    };
+
   private:
     /**
      * \brief ARP Cache container
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*> Cache;
+    typedef std::unordered_map<Ipv4Address, ArpCache::Entry*, Ipv4AddressHash> Cache;
     /**
      * \brief ARP Cache container iterator
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*>::iterator CacheI;
+    typedef Cache::iterator CacheI;
+
+    /**
+     * \brief Add an entry to the index of MAC addresses
+     * \param entry the entry
+     */
+    void AddToMacIndex(ArpCache::Entry* entry);
+    /**
+     * \brief Remove an entry from the index of MAC addresses
+     * \param entry the entry
+     */
+    void RemoveFromMacIndex(ArpCache::Entry* entry);
+    /**
+     * \brief Delete an entry, after removing it from the indexes
+     * \param entry the entry
+     */
+    void DeleteEntry(ArpCache::Entry* entry);
+    /**
+     * \brief Find a neighbor on the subnets of the interface.
+     * \param to the IPv4 address of the neighbor
+     * \return the device of the neighbor, or nullptr
+     */
+    Ptr<NetDevice> FindNeighbor(Ipv4Address to) const;
+    /**
+     * \brief Create the auto-generated entry of a neighbor.
+     * \param to the IPv4 address of the neighbor
+     * \return the new entry, or nullptr if the address is not a neighbor
+     */
+    ArpCache::Entry* AddNeighbor(Ipv4Address to);
 
     void DoDispose() override;
 
@@ -336,8 +468,15 @@ class ArpCache : public Object
     void HandleWaitReplyTimeout();
     uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
     Cache m_arpCache;            //!< the ARP cache
+    /// the ARP cache entries, by MAC address
+    std::multimap<Address, ArpCache::Entry*> m_macIndex;
+    /// the ARP cache entries in WAIT_REPLY state, in order of IPv4 address
+    std::map<Ipv4Address, ArpCache::Entry*> m_waitReplyEntries;
     TracedCallback<Ptr<const Packet>>
         m_dropTrace; //!< trace for packets dropped by the ARP cache queue
+    Ptr<Neighbors> m_neighbors; //!< the addresses of the neighbors of the device
+    /// the neighbors whose entry was removed
+    std::unordered_set<Ipv4Address, Ipv4AddressHash> m_removedNeighbors;
 };
 
 } // namespace ns3
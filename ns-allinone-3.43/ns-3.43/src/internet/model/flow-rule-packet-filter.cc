@@ -0,0 +1,234 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "flow-rule-packet-filter.h"
+
+#include "ns3/abort.h"
+#include "ns3/hash.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowRulePacketFilter");
+
+NS_OBJECT_ENSURE_REGISTERED(FlowRulePacketFilter);
+
+FlowRulePacketFilter::Rule&
+FlowRulePacketFilter::Rule::SetSource(Ipv4Address address, Ipv4Mask mask)
+{
+    SetL3Protocol(0x0800);
+    address.CombineMask(mask).Serialize(m_value.srcAddress.data());
+    Ipv4Address(mask.Get()).Serialize(m_mask.srcAddress.data());
+    return *this;
+}
+
+FlowRulePacketFilter::Rule&
+FlowRulePacketFilter::Rule::SetDestination(Ipv4Address address, Ipv4Mask mask)
+{
+    SetL3Protocol(0x0800);
+    address.CombineMask(mask).Serialize(m_value.dstAddress.data());
+    Ipv4Address(mask.Get()).Serialize(m_mask.dstAddress.data());
+    return *this;
+}
+
+FlowRulePacketFilter::Rule&
+FlowRulePacketFilter::Rule::SetSource(Ipv6Address address, Ipv6Prefix prefix)
+{
+    SetL3Protocol(0x86DD);
+    address.CombinePrefix(prefix).Serialize(m_value.srcAddress.data());
+    prefix.GetBytes(m_mask.srcAddress.data());
+    return *this;
+}
+
+FlowRulePacketFilter::Rule&
+FlowRulePacketFilter::Rule::SetDestination(Ipv6Address address, Ipv6Prefix prefix)
+{
+    SetL3Protocol(0x86DD);
+    address.CombinePrefix(prefix).Serialize(m_value.dstAddress.data());
+    prefix.GetBytes(m_mask.dstAddress.data());
+    return *this;
+}
+
+FlowRulePacketFilter::Rule&
+FlowRulePacketFilter::Rule::SetProtocol(uint8_t protocol)
+{
+    m_value.l4Protocol = protocol;
+    m_mask.l4Protocol = 0xff;
+    return *this;
+}
+
+FlowRulePacketFilter::Rule&
+FlowRulePacketFilter::Rule::SetSourcePort(uint16_t port)
+{
+    m_value.srcPort = port;
+    m_mask.srcPort = 0xffff;
+    return *this;
+}
+
+FlowRulePacketFilter::Rule&
+FlowRulePacketFilter::Rule::SetDestinationPort(uint16_t port)
+{
+    m_value.dstPort = port;
+    m_mask.dstPort = 0xffff;
+    return *this;
+}
+
+FlowRulePacketFilter::Rule&
+FlowRulePacketFilter::Rule::SetDscp(uint8_t dscp)
+{
+    m_value.dscp = dscp;
+    m_mask.dscp = 0xff;
+    return *this;
+}
+
+FlowRulePacketFilter::Rule&
+FlowRulePacketFilter::Rule::SetEcn(uint8_t ecn)
+{
+    m_value.ecn = ecn;
+    m_mask.ecn = 0xff;
+    return *this;
+}
+
+void
+FlowRulePacketFilter::Rule::SetL3Protocol(uint16_t protocol)
+{
+    NS_ABORT_MSG_IF(m_mask.l3Protocol != 0 && m_value.l3Protocol != protocol,
+                    "A rule cannot match both IPv4 and IPv6 addresses");
+    m_value.l3Protocol = protocol;
+    m_mask.l3Protocol = 0xffff;
+}
+
+std::size_t
+FlowRulePacketFilter::DescriptorHash::operator()(const FlowDescriptor& fd) const
+{
+    uint8_t buf[41];
+    std::copy(fd.srcAddress.begin(), fd.srcAddress.end(), buf);
+    std::copy(fd.dstAddress.begin(), fd.dstAddress.end(), buf + 16);
+    buf[32] = fd.l3Protocol >> 8;
+    buf[33] = fd.l3Protocol & 0xff;
+    buf[34] = fd.srcPort >> 8;
+    buf[35] = fd.srcPort & 0xff;
+    buf[36] = fd.dstPort >> 8;
+    buf[37] = fd.dstPort & 0xff;
+    buf[38] = fd.l4Protocol;
+    buf[39] = fd.dscp;
+    buf[40] = fd.ecn;
+    return Hash32((char*)buf, 41);
+}
+
+bool
+FlowRulePacketFilter::DescriptorEqual::operator()(const FlowDescriptor& a,
+                                                  const FlowDescriptor& b) const
+{
+    return a.srcAddress == b.srcAddress && a.dstAddress == b.dstAddress &&
+           a.l3Protocol == b.l3Protocol && a.srcPort == b.srcPort && a.dstPort == b.dstPort &&
+           a.l4Protocol == b.l4Protocol && a.dscp == b.dscp && a.ecn == b.ecn;
+}
+
+TypeId
+FlowRulePacketFilter::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::FlowRulePacketFilter")
+                            .SetParent<PacketFilter>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<FlowRulePacketFilter>();
+    return tid;
+}
+
+FlowRulePacketFilter::FlowRulePacketFilter()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FlowRulePacketFilter::~FlowRulePacketFilter()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FlowDescriptor
+FlowRulePacketFilter::ApplyMask(const FlowDescriptor& fd, const FlowDescriptor& mask)
+{
+    FlowDescriptor masked;
+    for (std::size_t i = 0; i < fd.srcAddress.size(); i++)
+    {
+        masked.srcAddress[i] = fd.srcAddress[i] & mask.srcAddress[i];
+        masked.dstAddress[i] = fd.dstAddress[i] & mask.dstAddress[i];
+    }
+    masked.l3Protocol = fd.l3Protocol & mask.l3Protocol;
+    masked.srcPort = fd.srcPort & mask.srcPort;
+    masked.dstPort = fd.dstPort & mask.dstPort;
+    masked.l4Protocol = fd.l4Protocol & mask.l4Protocol;
+    masked.dscp = fd.dscp & mask.dscp;
+    masked.ecn = fd.ecn & mask.ecn;
+    return masked;
+}
+
+void
+FlowRulePacketFilter::AddRule(const Rule& rule, int32_t ret)
+{
+    NS_LOG_FUNCTION(this << ret);
+
+    uint32_t index = m_returnValues.size();
+    m_returnValues.push_back(ret);
+
+    auto group = std::find_if(m_groups.begin(), m_groups.end(), [&rule](const RuleGroup& g) {
+        return DescriptorEqual()(g.mask, rule.m_mask);
+    });
+    if (group == m_groups.end())
+    {
+        group = m_groups.insert(m_groups.end(), RuleGroup{rule.m_mask, index, {}});
+    }
+    // an earlier rule with the same fields and values takes precedence
+    group->rules.emplace(rule.m_value, index);
+}
+
+uint32_t
+FlowRulePacketFilter::GetNRules() const
+{
+    return m_returnValues.size();
+}
+
+bool
+FlowRulePacketFilter::CheckProtocol(Ptr<QueueDiscItem> item) const
+{
+    NS_LOG_FUNCTION(this << item);
+    return item->GetFlowDescriptor() != nullptr;
+}
+
+int32_t
+FlowRulePacketFilter::DoClassify(Ptr<QueueDiscItem> item) const
+{
+    NS_LOG_FUNCTION(this << item);
+
+    const FlowDescriptor* fd = item->GetFlowDescriptor();
+    uint32_t match = m_returnValues.size();
+
+    for (const auto& group : m_groups)
+    {
+        // the groups are sorted by index of their first rule, hence the remaining
+        // groups cannot contain a rule preceding the matching rule
+        if (group.firstRule >= match)
+        {
+            break;
+        }
+        auto it = group.rules.find(ApplyMask(*fd, group.mask));
+        if (it != group.rules.end())
+        {
+            match = std::min(match, it->second);
+        }
+    }
+
+    if (match == m_returnValues.size())
+    {
+        NS_LOG_LOGIC("No rule matches the packet");
+        return PF_NO_MATCH;
+    }
+    NS_LOG_LOGIC("The packet matches rule " << match);
+    return m_returnValues[match];
+}
+
+} // namespace ns3
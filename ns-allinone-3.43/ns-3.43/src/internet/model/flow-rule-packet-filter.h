@@ -0,0 +1,187 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef FLOW_RULE_PACKET_FILTER_H
+#define FLOW_RULE_PACKET_FILTER_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/packet-filter.h"
+#include "ns3/queue-item.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ * \ingroup traffic-control
+ *
+ * FlowRulePacketFilter classifies IPv4 and IPv6 packets based on a table of
+ * rules on their 5-tuple, DSCP and ECN fields. The packet is classified
+ * according to the first rule, in the order the rules have been added, that
+ * the packet matches, as if each rule was a separate filter.
+ *
+ * The fields of the packet are parsed once per packet (see
+ * QueueDiscItem::GetFlowDescriptor) and the rules are compiled into a hash
+ * table per combination of the fields (and address prefixes) that the rules
+ * compare, so that classifying a packet takes a hash lookup per combination
+ * rather than the evaluation of every rule.
+ */
+class FlowRulePacketFilter : public PacketFilter
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    FlowRulePacketFilter();
+    ~FlowRulePacketFilter() override;
+
+    /**
+     * \brief A rule of the filter. A packet matches the rule if all the fields
+     * set in the rule match the corresponding fields of the packet. The fields
+     * not set in the rule match any packet.
+     */
+    class Rule
+    {
+      public:
+        /**
+         * \brief Match the IPv4 packets whose source address has the given prefix
+         * \param address the address
+         * \param mask the mask of the prefix
+         * \return this rule
+         */
+        Rule& SetSource(Ipv4Address address, Ipv4Mask mask = Ipv4Mask::GetOnes());
+        /**
+         * \brief Match the IPv4 packets whose destination address has the given prefix
+         * \param address the address
+         * \param mask the mask of the prefix
+         * \return this rule
+         */
+        Rule& SetDestination(Ipv4Address address, Ipv4Mask mask = Ipv4Mask::GetOnes());
+        /**
+         * \brief Match the IPv6 packets whose source address has the given prefix
+         * \param address the address
+         * \param prefix the prefix
+         * \return this rule
+         */
+        Rule& SetSource(Ipv6Address address, Ipv6Prefix prefix = Ipv6Prefix(128));
+        /**
+         * \brief Match the IPv6 packets whose destination address has the given prefix
+         * \param address the address
+         * \param prefix the prefix
+         * \return this rule
+         */
+        Rule& SetDestination(Ipv6Address address, Ipv6Prefix prefix = Ipv6Prefix(128));
+        /**
+         * \brief Match the packets carrying the given L4 protocol
+         * \param protocol the L4 protocol number
+         * \return this rule
+         */
+        Rule& SetProtocol(uint8_t protocol);
+        /**
+         * \brief Match the packets with the given L4 source port
+         * \param port the port
+         * \return this rule
+         */
+        Rule& SetSourcePort(uint16_t port);
+        /**
+         * \brief Match the packets with the given L4 destination port
+         * \param port the port
+         * \return this rule
+         */
+        Rule& SetDestinationPort(uint16_t port);
+        /**
+         * \brief Match the packets with the given DiffServ codepoint
+         * \param dscp the DiffServ codepoint
+         * \return this rule
+         */
+        Rule& SetDscp(uint8_t dscp);
+        /**
+         * \brief Match the packets with the given ECN codepoint
+         * \param ecn the ECN codepoint
+         * \return this rule
+         */
+        Rule& SetEcn(uint8_t ecn);
+
+      private:
+        friend class FlowRulePacketFilter;
+
+        /**
+         * \brief Set the L3 protocol of the packets matching the rule
+         * \param protocol the L3 protocol number
+         */
+        void SetL3Protocol(uint16_t protocol);
+
+        FlowDescriptor m_value; //!< the values of the fields compared by the rule
+        FlowDescriptor m_mask;  //!< the bits of the fields compared by the rule
+    };
+
+    /**
+     * \brief Add a rule at the end of the rule table
+     * \param rule the rule
+     * \param ret the value returned for the packets matching the rule
+     */
+    void AddRule(const Rule& rule, int32_t ret);
+
+    /**
+     * \brief Get the number of rules
+     * \return the number of rules
+     */
+    uint32_t GetNRules() const;
+
+  private:
+    bool CheckProtocol(Ptr<QueueDiscItem> item) const override;
+    int32_t DoClassify(Ptr<QueueDiscItem> item) const override;
+
+    /// Hash of a flow descriptor
+    struct DescriptorHash
+    {
+        /**
+         * \param fd the flow descriptor
+         * \return the hash of the flow descriptor
+         */
+        std::size_t operator()(const FlowDescriptor& fd) const;
+    };
+
+    /// Equality of flow descriptors
+    struct DescriptorEqual
+    {
+        /**
+         * \param a a flow descriptor
+         * \param b another flow descriptor
+         * \return true if the two flow descriptors are equal
+         */
+        bool operator()(const FlowDescriptor& a, const FlowDescriptor& b) const;
+    };
+
+    /// The rules comparing the same bits of the packets
+    struct RuleGroup
+    {
+        FlowDescriptor mask; //!< the bits compared by the rules of the group
+        uint32_t firstRule;  //!< the index of the first rule of the group
+        /// the index of the first rule of the group matching each masked value
+        std::unordered_map<FlowDescriptor, uint32_t, DescriptorHash, DescriptorEqual> rules;
+    };
+
+    /**
+     * \brief Apply a mask to a flow descriptor
+     * \param fd the flow descriptor
+     * \param mask the mask
+     * \return the masked flow descriptor
+     */
+    static FlowDescriptor ApplyMask(const FlowDescriptor& fd, const FlowDescriptor& mask);
+
+    std::vector<RuleGroup> m_groups;     //!< the rule groups, by index of their first rule
+    std::vector<int32_t> m_returnValues; //!< the values returned by the rules, by index
+};
+
+} // namespace ns3
+
+#endif /* FLOW_RULE_PACKET_FILTER_H */
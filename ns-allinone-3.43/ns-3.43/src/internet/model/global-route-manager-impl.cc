@@ -12,20 +12,27 @@
 
 #include "global-route-manager-impl.h"
 
-#include "candidate-queue.h"
 #include "global-router-interface.h"
 #include "ipv4-global-routing.h"
 #include "ipv4.h"
 
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/node-list.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <queue>
+#include <span>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -34,6 +41,16 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * \brief The number of threads running the SPF calculations of the routers
+ */
+static GlobalValue g_spfThreads("GlobalRoutingSpfThreads",
+                                "The number of threads running the SPF calculations of the "
+                                "global routing (0 for the number of hardware threads)",
+                                UintegerValue(0),
+                                MakeUintegerChecker<uint32_t>());
+
 /**
  * \brief Stream insertion operator.
  *
@@ -437,6 +454,7 @@ GlobalRouteManagerLSDB::~GlobalRouteManagerLSDB()
     }
     NS_LOG_LOGIC("clear map");
     m_database.clear();
+    m_linkDataIndex.clear();
 }
 
 void
@@ -458,9 +476,22 @@ GlobalRouteManagerLSDB::Insert(Ipv4Address addr, GlobalRoutingLSA* lsa)
     {
         m_extdatabase.push_back(lsa);
     }
-    else
+    else if (m_database.insert(LSDBPair_t(addr, lsa)).second)
     {
-        m_database.insert(LSDBPair_t(addr, lsa));
+        // Index the LSA by the link data of its transit network link records,
+        // keeping the first LSA of the database for each link data
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+            if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
+            {
+                auto it = m_linkDataIndex.emplace(lr->GetLinkData(), LSDBPair_t(addr, lsa)).first;
+                if (addr < it->second.first)
+                {
+                    it->second = LSDBPair_t(addr, lsa);
+                }
+            }
+        }
     }
 }
 
@@ -485,14 +516,8 @@ GlobalRouteManagerLSDB::GetLSA(Ipv4Address addr) const
     //
     // Look up an LSA by its address.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
-    {
-        if (i->first == addr)
-        {
-            return i->second;
-        }
-    }
-    return nullptr;
+    auto i = m_database.find(addr);
+    return i != m_database.end() ? i->second : nullptr;
 }
 
 GlobalRoutingLSA*
@@ -500,23 +525,23 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this << addr);
     //
-    // Look up an LSA by its address.
+    // Look up an LSA by the link data of its transit network link records.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    auto i = m_linkDataIndex.find(addr);
+    return i != m_linkDataIndex.end() ? i->second.second : nullptr;
+}
+
+std::vector<GlobalRoutingLSA*>
+GlobalRouteManagerLSDB::GetLSAs() const
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<GlobalRoutingLSA*> lsas;
+    lsas.reserve(m_database.size());
+    for (const auto& [addr, lsa] : m_database)
     {
-        GlobalRoutingLSA* temp = i->second;
-        // Iterate among temp's Link Records
-        for (uint32_t j = 0; j < temp->GetNLinkRecords(); j++)
-        {
-            GlobalRoutingLinkRecord* lr = temp->GetLinkRecord(j);
-            if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork &&
-                lr->GetLinkData() == addr)
-            {
-                return temp;
-            }
-        }
+        lsas.push_back(lsa);
     }
-    return nullptr;
+    return lsas;
 }
 
 // ---------------------------------------------------------------------------
@@ -526,7 +551,8 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 // ---------------------------------------------------------------------------
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl()
-    : m_spfroot(nullptr)
+    : m_routesValid(false),
+      m_nSpfCalculations(0)
 {
     NS_LOG_FUNCTION(this);
     m_lsdb = new GlobalRouteManagerLSDB();
@@ -550,6 +576,7 @@ GlobalRouteManagerImpl::DebugUseLsdb(GlobalRouteManagerLSDB* lsdb)
         delete m_lsdb;
     }
     m_lsdb = lsdb;
+    m_routesValid = false;
 }
 
 void
@@ -584,6 +611,9 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes()
         delete m_lsdb;
         m_lsdb = new GlobalRouteManagerLSDB();
     }
+    m_graph = SpfGraph();
+    m_trees.clear();
+    m_routesValid = false;
 }
 
 //
@@ -677,1485 +707,892 @@ GlobalRouteManagerImpl::BuildGlobalRoutingDatabase()
 // algorithm then iterates again.  It terminates when the candidate
 // list becomes empty.
 //
+// The SPF calculations run on a flat copy of the LSDB, and the calculations
+// of the routers run in parallel (see the GlobalRoutingSpfThreads global
+// value).  The routes are then installed in the routing tables of the nodes
+// by the main thread, in the order of the node list.
+//
 void
 GlobalRouteManagerImpl::InitializeRoutes()
 {
     NS_LOG_FUNCTION(this);
-    //
-    // Walk the list of nodes in the system.
-    //
     NS_LOG_INFO("About to start SPF calculation");
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    m_graph = SpfGraph();
+    BuildSpfGraph(m_graph);
+    FindRoots(m_graph, m_trees);
+    ComputeRoutes(m_graph, m_trees, std::vector<SpfUpdate>(m_trees.size(), SPF_TREE), false);
+    m_routesValid = true;
+    NS_LOG_INFO("Finished SPF calculation");
+}
+
+void
+GlobalRouteManagerImpl::RecomputeRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_routesValid)
     {
-        Ptr<Node> node = *i;
-        //
-        // Look for the GlobalRouter interface that indicates that the node is
-        // participating in routing.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        NS_LOG_LOGIC("No previous route computation, computing all the routes");
+        DeleteGlobalRoutes();
+        BuildGlobalRoutingDatabase();
+        InitializeRoutes();
+        return;
+    }
 
-        uint32_t systemId = Simulator::GetSystemId();
-        // Ignore nodes that are not assigned to our systemId (distributed sim)
-        if (node->GetSystemId() != systemId)
+    delete m_lsdb;
+    m_lsdb = new GlobalRouteManagerLSDB();
+    BuildGlobalRoutingDatabase();
+    SpfGraph graph;
+    BuildSpfGraph(graph);
+    std::vector<SpfTree> roots;
+    FindRoots(graph, roots);
+
+    bool sameRoots = roots.size() == m_trees.size();
+    for (std::size_t i = 0; sameRoots && i < roots.size(); i++)
+    {
+        sameRoots = roots[i].root == m_trees[i].root && roots[i].node == m_trees[i].node;
+    }
+    if (!sameRoots || graph.nodes != m_graph.nodes || graph.vertices != m_graph.vertices ||
+        graph.externals != m_graph.externals)
+    {
+        NS_LOG_LOGIC("The routers, networks or external routes changed, computing all the routes");
+        DeleteGlobalRoutes();
+        BuildGlobalRoutingDatabase();
+        InitializeRoutes();
+        return;
+    }
+
+    std::vector<SpfUpdate> updates;
+    FindAffectedTrees(graph, updates);
+    for (std::size_t i = 0; i < m_trees.size(); i++)
+    {
+        // Rewrite the routing tables that were changed since they were computed
+        Ptr<GlobalRouter> router = NodeList::GetNode(m_trees[i].node)->GetObject<GlobalRouter>();
+        if (router->GetRoutingProtocol()->GetNRoutes() != m_trees[i].nRoutes)
         {
-            continue;
+            updates[i] = std::max(updates[i], SPF_ROUTES);
+            m_trees[i].nRoutes = std::numeric_limits<uint32_t>::max();
         }
+    }
+    m_graph = std::move(graph);
+    ComputeRoutes(m_graph, m_trees, updates, true);
+}
 
-        //
-        // if the node has a global router interface, then run the global routing
-        // algorithms.
-        //
-        if (rtr && rtr->GetNumLSAs())
+uint32_t
+GlobalRouteManagerImpl::GetNSpfCalculations() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_nSpfCalculations;
+}
+
+// Used for unit tests.
+void
+GlobalRouteManagerImpl::DebugSPFCalculate(Ipv4Address root)
+{
+    NS_LOG_FUNCTION(this << root);
+    SpfGraph graph;
+    BuildSpfGraph(graph);
+    auto it = graph.index.find(root.Get());
+    if (it == graph.index.end())
+    {
+        return;
+    }
+    std::vector<SpfTree> trees(1);
+    trees[0].root = it->second;
+    trees[0].node = std::numeric_limits<uint32_t>::max();
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter>();
+        if (rtr && rtr->GetRouterId() == root)
         {
-            SPFCalculate(rtr->GetRouterId());
+            trees[0].node = (*i)->GetId();
+            break;
         }
     }
-    NS_LOG_INFO("Finished SPF calculation");
+    ComputeRoutes(graph, trees, {SPF_TREE}, false);
 }
 
-//
-// This method is derived from quagga ospf_spf_next ().  See RFC2328 Section
-// 16.1 (2) for further details.
-//
-// We're passed a parameter <v> that is a vertex which is already in the SPF
-// tree.  A vertex represents a router node.  We also get a reference to the
-// SPF candidate queue, which is a priority queue containing the shortest paths
-// to the networks we know about.
-//
-// We examine the links in v's LSA and update the list of candidates with any
-// vertices not already on the list.  If a lower-cost path is found to a
-// vertex already on the candidate list, store the new (lower) cost.
-//
 void
-GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
+GlobalRouteManagerImpl::BuildSpfGraph(SpfGraph& graph) const
 {
-    NS_LOG_FUNCTION(this << v << &candidate);
+    NS_LOG_FUNCTION(this);
+    graph.nodes = NodeList::GetNNodes() > 0;
 
-    SPFVertex* w = nullptr;
-    GlobalRoutingLSA* w_lsa = nullptr;
-    GlobalRoutingLinkRecord* l = nullptr;
-    uint32_t distance = 0;
-    uint32_t numRecordsInVertex = 0;
-    //
-    // V points to a Router-LSA or Network-LSA
-    // Loop over the links in router LSA or attached routers in Network LSA
-    //
-    if (v->GetVertexType() == SPFVertex::VertexRouter)
+    // The nodes of the routers, by router ID
+    std::unordered_map<uint32_t, Ptr<Node>> routerNodes;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
     {
-        numRecordsInVertex = v->GetLSA()->GetNLinkRecords();
+        Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter>();
+        if (rtr)
+        {
+            routerNodes.emplace(rtr->GetRouterId().Get(), *i);
+        }
     }
-    if (v->GetVertexType() == SPFVertex::VertexNetwork)
+
+    std::vector<GlobalRoutingLSA*> lsas = m_lsdb->GetLSAs();
+    for (uint32_t i = 0; i < lsas.size(); i++)
     {
-        numRecordsInVertex = v->GetLSA()->GetNAttachedRouters();
+        graph.index.emplace(lsas[i]->GetLinkStateId().Get(), i);
     }
-
-    for (uint32_t i = 0; i < numRecordsInVertex; i++)
+    for (GlobalRoutingLSA* lsa : lsas)
     {
-        // Get w_lsa:  In case of V is Router-LSA
-        if (v->GetVertexType() == SPFVertex::VertexRouter)
+        graph.recordBegin.push_back(graph.records.size());
+        graph.edgeBegin.push_back(graph.edges.size());
+        graph.addrBegin.push_back(graph.addresses.size());
+        if (lsa->GetLSType() == GlobalRoutingLSA::NetworkLSA)
         {
-            NS_LOG_LOGIC("Examining link " << i << " of " << v->GetVertexId() << "'s "
-                                           << v->GetLSA()->GetNLinkRecords() << " link records");
-            //
-            // (a) If this is a link to a stub network, examine the next link in V's LSA.
-            // Links to stub networks will be considered in the second stage of the
-            // shortest path calculation.
-            //
-            l = v->GetLSA()->GetLinkRecord(i);
-            NS_ASSERT(l != nullptr);
-            if (l->GetLinkType() == GlobalRoutingLinkRecord::StubNetwork)
+            graph.vertices.push_back(
+                {lsa->GetLinkStateId().Get(), true, lsa->GetNetworkLSANetworkMask().Get()});
+            // The links of a network to its attached routers have no cost
+            for (uint32_t j = 0; j < lsa->GetNAttachedRouters(); j++)
             {
-                NS_LOG_LOGIC("Found a Stub record to " << l->GetLinkId());
-                continue;
-            }
-            //
-            // (b) Otherwise, W is a transit vertex (router or transit network).  Look up
-            // the vertex W's LSA (router-LSA or network-LSA) in Area A's link state
-            // database.
-            //
-            if (l->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint)
-            {
-                //
-                // Lookup the link state advertisement of the new link -- we call it <w> in
-                // the link state database.
-                //
-                w_lsa = m_lsdb->GetLSA(l->GetLinkId());
-                NS_ASSERT(w_lsa);
-                NS_LOG_LOGIC("Found a P2P record from " << v->GetVertexId() << " to "
-                                                        << w_lsa->GetLinkStateId());
+                GlobalRoutingLSA* w_lsa = m_lsdb->GetLSAByLinkData(lsa->GetAttachedRouter(j));
+                if (w_lsa)
+                {
+                    graph.edges.push_back({graph.index.at(w_lsa->GetLinkStateId().Get()), 0, 0});
+                }
             }
-            else if (l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
+            continue;
+        }
+
+        graph.vertices.push_back({lsa->GetLinkStateId().Get(), false, 0});
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(j);
+            graph.records.push_back(
+                {l->GetLinkType(), l->GetLinkId().Get(), l->GetLinkData().Get()});
+            // Links to stub networks are considered in the second stage of
+            // the SPF calculation
+            if (l->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint &&
+                l->GetLinkType() != GlobalRoutingLinkRecord::TransitNetwork)
             {
-                w_lsa = m_lsdb->GetLSA(l->GetLinkId());
-                NS_ASSERT(w_lsa);
-                NS_LOG_LOGIC("Found a Transit record from " << v->GetVertexId() << " to "
-                                                            << w_lsa->GetLinkStateId());
+                continue;
             }
-            else
+            auto w = graph.index.find(l->GetLinkId().Get());
+            NS_ASSERT_MSG(w != graph.index.end(), "No LSA for the link to " << l->GetLinkId());
+            if (w != graph.index.end())
             {
-                NS_ASSERT_MSG(0, "illegal Link Type");
+                graph.edges.push_back({w->second, l->GetMetric(), l->GetLinkData().Get()});
             }
         }
-        // Get w_lsa:  In case of V is Network-LSA
-        if (v->GetVertexType() == SPFVertex::VertexNetwork)
+        // The addresses of the router, in the order of GetInterfaceForPrefix
+        auto node = routerNodes.find(lsa->GetLinkStateId().Get());
+        Ptr<Ipv4> ipv4 = node != routerNodes.end() ? node->second->GetObject<Ipv4>() : nullptr;
+        for (uint32_t j = 0; ipv4 && j < ipv4->GetNInterfaces(); j++)
         {
-            w_lsa = m_lsdb->GetLSAByLinkData(v->GetLSA()->GetAttachedRouter(i));
-            if (!w_lsa)
+            for (uint32_t k = 0; k < ipv4->GetNAddresses(j); k++)
             {
-                continue;
+                graph.addresses.push_back(
+                    {ipv4->GetAddress(j, k).GetLocal().Get(), static_cast<int32_t>(j)});
             }
-            NS_LOG_LOGIC("Found a Network LSA from " << v->GetVertexId() << " to "
-                                                     << w_lsa->GetLinkStateId());
         }
+    }
+    graph.recordBegin.push_back(graph.records.size());
+    graph.edgeBegin.push_back(graph.edges.size());
+    graph.addrBegin.push_back(graph.addresses.size());
 
-        // Note:  w_lsa at this point may be either RouterLSA or NetworkLSA
-        //
-        // (c) If vertex W is already on the shortest-path tree, examine the next
-        // link in the LSA.
+    for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs(); i++)
+    {
+        GlobalRoutingLSA* extlsa = m_lsdb->GetExtLSA(i);
+        Ipv4Mask mask = extlsa->GetNetworkLSANetworkMask();
+        graph.externals.push_back({extlsa->GetAdvertisingRouter().Get(),
+                                   extlsa->GetLinkStateId().CombineMask(mask).Get(),
+                                   mask.Get()});
+    }
+}
+
+void
+GlobalRouteManagerImpl::FindRoots(const SpfGraph& graph, std::vector<SpfTree>& trees) const
+{
+    NS_LOG_FUNCTION(this);
+    trees.clear();
+    // Walk the list of nodes in the system.
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<Node> node = *i;
         //
-        // If the link is to a router that is already in the shortest path first tree
-        // then we have it covered -- ignore it.
+        // Look for the GlobalRouter interface that indicates that the node is
+        // participating in routing.
         //
-        if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
+        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+
+        uint32_t systemId = Simulator::GetSystemId();
+        // Ignore nodes that are not assigned to our systemId (distributed sim)
+        if (node->GetSystemId() != systemId)
         {
-            NS_LOG_LOGIC("Skipping ->  LSA " << w_lsa->GetLinkStateId() << " already in SPF tree");
             continue;
         }
+
         //
-        // (d) Calculate the link state cost D of the resulting path from the root to
-        // vertex W.  D is equal to the sum of the link state cost of the (already
-        // calculated) shortest path to vertex V and the advertised cost of the link
-        // between vertices V and W.
+        // if the node has a global router interface, then run the global routing
+        // algorithms.
         //
-        if (v->GetLSA()->GetLSType() == GlobalRoutingLSA::RouterLSA)
-        {
-            NS_ASSERT(l != nullptr);
-            distance = v->GetDistanceFromRoot() + l->GetMetric();
-        }
-        else
+        if (rtr && rtr->GetNumLSAs())
         {
-            distance = v->GetDistanceFromRoot();
+            auto root = graph.index.find(rtr->GetRouterId().Get());
+            NS_ASSERT_MSG(root != graph.index.end(), "No LSA for router " << rtr->GetRouterId());
+            trees.emplace_back();
+            trees.back().root = root->second;
+            trees.back().node = node->GetId();
         }
+    }
+}
 
-        NS_LOG_LOGIC("Considering w_lsa " << w_lsa->GetLinkStateId());
+void
+GlobalRouteManagerImpl::FindAffectedTrees(const SpfGraph& graph,
+                                          std::vector<SpfUpdate>& updates) const
+{
+    NS_LOG_FUNCTION(this);
+    const SpfGraph& old = m_graph;
+    const uint32_t n = graph.vertices.size();
+    updates.assign(m_trees.size(), SPF_NONE);
 
-        // Is there already vertex w in candidate list?
-        if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+    std::vector<uint32_t> treeOfRoot(n, SPF_INFINITY);
+    for (uint32_t i = 0; i < m_trees.size(); i++)
+    {
+        treeOfRoot[m_trees[i].root] = i;
+    }
+    auto markRoot = [&](uint32_t v) {
+        if (treeOfRoot[v] != SPF_INFINITY)
         {
-            // Calculate nexthop to w
-            // We need to figure out how to actually get to the new router represented
-            // by <w>.  This will (among other things) find the next hop address to send
-            // packets destined for this network to, and also find the outbound interface
-            // used to forward the packets.
-
-            // prepare vertex w
-            w = new SPFVertex(w_lsa);
-            if (SPFNexthopCalculation(v, w, l, distance))
-            {
-                w_lsa->SetStatus(GlobalRoutingLSA::LSA_SPF_CANDIDATE);
-                //
-                // Push this new vertex onto the priority queue (ordered by distance from the
-                // root node).
-                //
-                candidate.Push(w);
-                NS_LOG_LOGIC("Pushing " << w->GetVertexId()
-                                        << ", parent vertexId: " << v->GetVertexId()
-                                        << ", distance: " << w->GetDistanceFromRoot());
-            }
-            else
-            {
-                NS_ASSERT_MSG(0,
-                              "SPFNexthopCalculation never "
-                                  << "return false, but it does now!");
-            }
+            updates[treeOfRoot[v]] = SPF_TREE;
         }
-        else if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
+    };
+
+    // The vertices whose link records or links changed, and the links that
+    // changed: (from, to, metric, whether the link was removed)
+    std::vector<uint32_t> changed;
+    std::vector<std::tuple<uint32_t, uint32_t, uint32_t, bool>> links;
+    auto sortEdges = [](std::vector<SpfGraph::Edge>& edges) {
+        std::sort(edges.begin(), edges.end(), [](const auto& a, const auto& b) {
+            return std::tie(a.to, a.metric, a.linkData) < std::tie(b.to, b.metric, b.linkData);
+        });
+    };
+    for (uint32_t u = 0; u < n; u++)
+    {
+        auto oldRecords = std::span(old.records)
+                              .subspan(old.recordBegin[u],
+                                       old.recordBegin[u + 1] - old.recordBegin[u]);
+        auto newRecords = std::span(graph.records)
+                              .subspan(graph.recordBegin[u],
+                                       graph.recordBegin[u + 1] - graph.recordBegin[u]);
+        std::vector<SpfGraph::Edge> oldEdges(old.edges.begin() + old.edgeBegin[u],
+                                             old.edges.begin() + old.edgeBegin[u + 1]);
+        std::vector<SpfGraph::Edge> newEdges(graph.edges.begin() + graph.edgeBegin[u],
+                                             graph.edges.begin() + graph.edgeBegin[u + 1]);
+        if (std::ranges::equal(oldRecords, newRecords) && oldEdges == newEdges)
         {
-            //
-            // We have already considered the link represented by <w>.  What wse have to
-            // do now is to decide if this new router represents a route with a shorter
-            // distance metric.
-            //
-            // So, locate the vertex in the candidate queue and take a look at the
-            // distance.
-
-            /* (quagga-0.98.6) W is already on the candidate list; call it cw.
-             * Compare the previously calculated cost (cw->distance)
-             * with the cost we just determined (w->distance) to see
-             * if we've found a shorter path.
-             */
-            SPFVertex* cw;
-            cw = candidate.Find(w_lsa->GetLinkStateId());
-            if (cw->GetDistanceFromRoot() < distance)
-            {
-                //
-                // This is not a shorter path, so don't do anything.
-                //
-                continue;
-            }
-            else if (cw->GetDistanceFromRoot() == distance)
-            {
-                //
-                // This path is one with an equal cost.
-                //
-                NS_LOG_LOGIC("Equal cost multiple paths found.");
-
-                // At this point, there are two instances 'w' and 'cw' of the
-                // same vertex, the vertex that is currently being considered
-                // for adding into the shortest path tree. 'w' is the instance
-                // as seen from the root via vertex 'v', and 'cw' is the instance
-                // as seen from the root via some other vertices other than 'v'.
-                // These two instances are being merged in the following code.
-                // In particular, the parent nodes, the next hops, and the root's
-                // output interfaces of the two instances are being merged.
-                //
-                // Note that this is functionally equivalent to calling
-                // ospf_nexthop_merge (cw->nexthop, w->nexthop) in quagga-0.98.6
-                // (ospf_spf.c::859), although the detail implementation
-                // is very different from quagga (blame ns3::GlobalRouteManagerImpl)
-
-                // prepare vertex w
-                w = new SPFVertex(w_lsa);
-                SPFNexthopCalculation(v, w, l, distance);
-                cw->MergeRootExitDirections(w);
-                cw->MergeParent(w);
-                // SPFVertexAddParent (w) is necessary as the destructor of
-                // SPFVertex checks if the vertex and its parent is linked
-                // bidirectionally
-                SPFVertexAddParent(w);
-                delete w;
-            }
-            else // cw->GetDistanceFromRoot () > w->GetDistanceFromRoot ()
+            continue;
+        }
+        changed.push_back(u);
+
+        // The links in only one of the graphs changed.  If the other links are
+        // not in the same order, the order in which the vertices are reached
+        // may change: consider that all the links changed.
+        std::vector<SpfGraph::Edge> oldSorted = oldEdges;
+        std::vector<SpfGraph::Edge> newSorted = newEdges;
+        sortEdges(oldSorted);
+        sortEdges(newSorted);
+        std::vector<SpfGraph::Edge> removed;
+        std::vector<SpfGraph::Edge> added;
+        auto less = [](const auto& a, const auto& b) {
+            return std::tie(a.to, a.metric, a.linkData) < std::tie(b.to, b.metric, b.linkData);
+        };
+        std::ranges::set_difference(oldSorted, newSorted, std::back_inserter(removed), less);
+        std::ranges::set_difference(newSorted, oldSorted, std::back_inserter(added), less);
+        auto remaining = [less](std::vector<SpfGraph::Edge> edges,
+                                std::vector<SpfGraph::Edge> others) {
+            std::vector<SpfGraph::Edge> result;
+            std::ranges::sort(others, less);
+            for (const auto& e : edges)
             {
-                //
-                // this path represents a new, lower-cost path to <w> (the vertex we found in
-                // the current link record of the link state advertisement of the current root
-                // (vertex <v>)
-                //
-                // N.B. the nexthop_calculation is conditional, if it finds a valid nexthop
-                // it will call spf_add_parents, which will flush the old parents
-                //
-                if (SPFNexthopCalculation(v, cw, l, distance))
+                auto it = std::ranges::lower_bound(others, e, less);
+                if (it != others.end() && *it == e)
                 {
-                    //
-                    // If we've changed the cost to get to the vertex represented by <w>, we
-                    // must reorder the priority queue keyed to that cost.
-                    //
-                    candidate.Reorder();
+                    others.erase(it);
+                    continue;
                 }
-            } // new lower cost path found
-        }     // end W is already on the candidate list
-    }         // end loop over the links in V's LSA
-}
-
-//
-// This method is derived from quagga ospf_nexthop_calculation() 16.1.1.
-//
-// Calculate nexthop from root through V (parent) to vertex W (destination)
-// with given distance from root->W.
-//
-// As appropriate, set w's parent, distance, and nexthop information
-//
-// For now, this is greatly simplified from the quagga code
-//
-int
-GlobalRouteManagerImpl::SPFNexthopCalculation(SPFVertex* v,
-                                              SPFVertex* w,
-                                              GlobalRoutingLinkRecord* l,
-                                              uint32_t distance)
-{
-    NS_LOG_FUNCTION(this << v << w << l << distance);
-    //
-    // If w is a NetworkVertex, l should be null
-    /*
-      if (w->GetVertexType () == SPFVertex::VertexNetwork && l)
+                result.push_back(e);
+            }
+            return result;
+        };
+        if (remaining(oldEdges, removed) != remaining(newEdges, added))
         {
-            NS_ASSERT_MSG (0, "Error:  SPFNexthopCalculation parameter problem");
+            removed = std::move(oldEdges);
+            added = std::move(newEdges);
         }
-    */
-
-    //
-    // The vertex m_spfroot is a distinguished vertex representing the node at
-    // the root of the calculations.  That is, it is the node for which we are
-    // calculating the routes.
-    //
-    // There are two distinct cases for calculating the next hop information.
-    // First, if we're considering a hop from the root to an "adjacent" network
-    // (one that is on the other side of a point-to-point link connected to the
-    // root), then we need to store the information needed to forward down that
-    // link.  The second case is if the network is not directly adjacent.  In that
-    // case we need to use the forwarding information from the vertex on the path
-    // to the destination that is directly adjacent [node 1] in both cases of the
-    // diagram below.
-    //
-    // (1) [root] -> [point-to-point] -> [node 1]
-    // (2) [root] -> [point-to-point] -> [node 1] -> [point-to-point] -> [node 2]
-    //
-    // We call the propagation of next hop information down vertices of a path
-    // "inheriting" the next hop information.
-    //
-    // The point-to-point link information is only useful in this calculation when
-    // we are examining the root node.
-    //
-    if (v == m_spfroot)
-    {
-        //
-        // In this case <v> is the root node, which means it is the starting point
-        // for the packets forwarded by that node.  This also means that the next hop
-        // address of packets headed for some arbitrary off-network destination must
-        // be the destination at the other end of one of the links off of the root
-        // node if this root node is a router.  We then need to see if this node <w>
-        // is a router.
-        //
-        if (w->GetVertexType() == SPFVertex::VertexRouter)
+        for (const auto& e : removed)
         {
-            //
-            // In the case of point-to-point links, the link data field (m_linkData) of a
-            // Global Router Link Record contains the local IP address.  If we look at the
-            // link record describing the link from the perspective of <w> (the remote
-            // node from the viewpoint of <v>) back to the root node, we can discover the
-            // IP address of the router to which <v> is adjacent.  This is a distinguished
-            // address -- the next hop address to get from <v> to <w> and all networks
-            // accessed through that path.
-            //
-            // SPFGetNextLink () is a little odd.  used in this way it is just going to
-            // return the link record describing the link from <w> to <v>.  Think of it as
-            // SPFGetLink.
-            //
-            NS_ASSERT(l);
-            GlobalRoutingLinkRecord* linkRemote = nullptr;
-            linkRemote = SPFGetNextLink(w, v, linkRemote);
-            //
-            // At this point, <l> is the Global Router Link Record describing the point-
-            // to point link from <v> to <w> from the perspective of <v>; and <linkRemote>
-            // is the Global Router Link Record describing that same link from the
-            // perspective of <w> (back to <v>).  Now we can just copy the next hop
-            // address from the m_linkData member variable.
-            //
-            // The next hop member variable we put in <w> has the sense "in order to get
-            // from the root node to the host represented by vertex <w>, you have to send
-            // the packet to the next hop address specified in w->m_nextHop.
-            //
-            Ipv4Address nextHop = linkRemote->GetLinkData();
-            //
-            // Now find the outgoing interface corresponding to the point to point link
-            // from the perspective of <v> -- remember that <l> is the link "from"
-            // <v> "to" <w>.
-            //
-            uint32_t outIf = FindOutgoingInterfaceId(l->GetLinkData());
-
-            w->SetRootExitDirection(nextHop, outIf);
-            w->SetDistanceFromRoot(distance);
-            w->SetParent(v);
-            NS_LOG_LOGIC("Next hop from " << v->GetVertexId() << " to " << w->GetVertexId()
-                                          << " goes through next hop " << nextHop
-                                          << " via outgoing interface " << outIf
-                                          << " with distance " << distance);
-        } // end W is a router vertes
-        else
+            links.emplace_back(u, e.to, e.metric, true);
+        }
+        for (const auto& e : added)
         {
-            NS_ASSERT(w->GetVertexType() == SPFVertex::VertexNetwork);
-            // W is a directly connected network; no next hop is required
-            GlobalRoutingLSA* w_lsa = w->GetLSA();
-            NS_ASSERT(w_lsa->GetLSType() == GlobalRoutingLSA::NetworkLSA);
-            // Find outgoing interface ID for this network
-            uint32_t outIf =
-                FindOutgoingInterfaceId(w_lsa->GetLinkStateId(), w_lsa->GetNetworkLSANetworkMask());
-            // Set the next hop to 0.0.0.0 meaning "not exist"
-            Ipv4Address nextHop = Ipv4Address::GetZero();
-            w->SetRootExitDirection(nextHop, outIf);
-            w->SetDistanceFromRoot(distance);
-            w->SetParent(v);
-            NS_LOG_LOGIC("Next hop from " << v->GetVertexId() << " to network " << w->GetVertexId()
-                                          << " via outgoing interface " << outIf
-                                          << " with distance " << distance);
-            return 1;
+            links.emplace_back(u, e.to, e.metric, false);
         }
-    } // end v is the root
-    else if (v->GetVertexType() == SPFVertex::VertexNetwork)
-    {
-        // See if any of v's parents are the root
-        if (v->GetParent() == m_spfroot)
+
+        // The exits from the neighbors of a vertex to the vertex are found in
+        // the link records of the vertex
+        markRoot(u);
+        for (const auto& records : {oldRecords, newRecords})
         {
-            // 16.1.1 para 5. ...the parent vertex is a network that
-            // directly connects the calculating router to the destination
-            // router.  The list of next hops is then determined by
-            // examining the destination's router-LSA...
-            NS_ASSERT(w->GetVertexType() == SPFVertex::VertexRouter);
-            GlobalRoutingLinkRecord* linkRemote = nullptr;
-            while ((linkRemote = SPFGetNextLink(w, v, linkRemote)))
+            for (const auto& record : records)
             {
-                /* ...For each link in the router-LSA that points back to the
-                 * parent network, the link's Link Data field provides the IP
-                 * address of a next hop router.  The outgoing interface to
-                 * use can then be derived from the next hop IP address (or
-                 * it can be inherited from the parent network).
-                 */
-                Ipv4Address nextHop = linkRemote->GetLinkData();
-                uint32_t outIf = v->GetRootExitDirection().second;
-                w->SetRootExitDirection(nextHop, outIf);
-                NS_LOG_LOGIC("Next hop from " << v->GetVertexId() << " to " << w->GetVertexId()
-                                              << " goes through next hop " << nextHop
-                                              << " via outgoing interface " << outIf);
+                auto x = graph.index.find(record.linkId);
+                if (x == graph.index.end())
+                {
+                    continue;
+                }
+                if (!graph.vertices[x->second].network)
+                {
+                    markRoot(x->second);
+                    continue;
+                }
+                for (const SpfGraph* g : {&old, &graph})
+                {
+                    for (uint32_t k = g->edgeBegin[x->second]; k < g->edgeBegin[x->second + 1]; k++)
+                    {
+                        markRoot(g->edges[k].to);
+                    }
+                }
             }
         }
-        else
-        {
-            w->SetRootExitDirection(v->GetRootExitDirection());
-        }
-    }
-    else
-    {
-        //
-        // If we're calculating the next hop information from a node (v) that is
-        // *not* the root, then we need to "inherit" the information needed to
-        // forward the packet from the vertex closer to the root.  That is, we'll
-        // still send packets to the next hop address of the router adjacent to the
-        // root on the path toward <w>.
-        //
-        // Above, when we were considering the root node, we calculated the next hop
-        // address and outgoing interface required to get off of the root network.
-        // At this point, we are further away from the root network along one of the
-        // (shortest) paths.  So the next hop and outgoing interface remain the same
-        // (are inherited).
-        //
-        w->InheritAllRootExitDirections(v);
     }
-    //
-    // In all cases, we need valid values for the distance metric and a parent.
-    //
-    w->SetDistanceFromRoot(distance);
-    w->SetParent(v);
-
-    return 1;
-}
-
-//
-// This method is derived from quagga ospf_get_next_link ()
-//
-// First search the Global Router Link Records of vertex <v> for one
-// representing a point-to point link to vertex <w>.
-//
-// What is done depends on prev_link.  Contrary to appearances, prev_link just
-// acts as a flag here.  If prev_link is NULL, we return the first Global
-// Router Link Record we find that describes a point-to-point link from <v>
-// to <w>.  If prev_link is not NULL, we return a Global Router Link Record
-// representing a possible *second* link from <v> to <w>.
-//
-GlobalRoutingLinkRecord*
-GlobalRouteManagerImpl::SPFGetNextLink(SPFVertex* v,
-                                       SPFVertex* w,
-                                       GlobalRoutingLinkRecord* prev_link)
-{
-    NS_LOG_FUNCTION(this << v << w << prev_link);
+    NS_LOG_LOGIC(changed.size() << " vertices and " << links.size() << " links changed");
 
-    bool skip = true;
-    bool found_prev_link = false;
-    GlobalRoutingLinkRecord* l;
-    //
-    // If prev_link is 0, we are really looking for the first link, not the next
-    // link.
-    //
-    if (prev_link == nullptr)
-    {
-        skip = false;
-        found_prev_link = true;
-    }
-    //
-    // Iterate through the Global Router Link Records advertised by the vertex
-    // <v> looking for records representing the point-to-point links off of this
-    // vertex.
-    //
-    for (uint32_t i = 0; i < v->GetLSA()->GetNLinkRecords(); ++i)
+    for (uint32_t i = 0; i < m_trees.size(); i++)
     {
-        l = v->GetLSA()->GetLinkRecord(i);
-        //
-        // The link ID of a link record representing a point-to-point link is set to
-        // the router ID of the neighboring router -- the router to which the link
-        // connects from the perspective of <v> in this case.  The vertex ID is also
-        // set to the router ID (using the link state advertisement of a router node).
-        // We're just checking to see if the link <l> is actually the link from <v> to
-        // <w>.
-        //
-        if (l->GetLinkId() == w->GetVertexId())
+        const SpfTree& tree = m_trees[i];
+        if (tree.stub || updates[i] == SPF_TREE || old.addrBegin[tree.root + 1] -
+                                                           old.addrBegin[tree.root] !=
+                                                       graph.addrBegin[tree.root + 1] -
+                                                           graph.addrBegin[tree.root] ||
+            !std::equal(old.addresses.begin() + old.addrBegin[tree.root],
+                        old.addresses.begin() + old.addrBegin[tree.root + 1],
+                        graph.addresses.begin() + graph.addrBegin[tree.root]))
         {
-            if (!found_prev_link)
-            {
-                NS_LOG_LOGIC("Skipping links before prev_link found");
-                found_prev_link = true;
-                continue;
-            }
-
-            NS_LOG_LOGIC("Found matching link l:  linkId = " << l->GetLinkId()
-                                                             << " linkData = " << l->GetLinkData());
-            //
-            // If skip is false, don't (not too surprisingly) skip the link found -- it's
-            // the one we're interested in.  That's either because we didn't pass in a
-            // previous link, and we're interested in the first one, or because we've
-            // skipped a previous link and moved forward to the next (which is then the
-            // one we want).
-            //
-            if (!skip)
+            updates[i] = SPF_TREE;
+            continue;
+        }
+        // The tree changes if a removed link was on a shortest path, or if an
+        // added link is on a path as short as a shortest path
+        for (const auto& [u, w, metric, removed] : links)
+        {
+            uint64_t distance = static_cast<uint64_t>(tree.distance[u]) + metric;
+            if (tree.distance[u] != SPF_INFINITY &&
+                (removed ? distance == tree.distance[w] : distance <= tree.distance[w]))
             {
-                NS_LOG_LOGIC("Returning the found link");
-                return l;
+                updates[i] = SPF_TREE;
+                break;
             }
-            else
+        }
+        if (updates[i] == SPF_TREE)
+        {
+            continue;
+        }
+        // Otherwise, the routes change if the tree reaches a router whose
+        // link records changed
+        for (uint32_t u : changed)
+        {
+            if (!graph.vertices[u].network && tree.distance[u] != SPF_INFINITY)
             {
-                //
-                // Skip is true and we've found a link from <v> to <w>.  We want the next one.
-                // Setting skip to false gets us the next point-to-point global router link
-                // record in the LSA from <v>.
-                //
-                NS_LOG_LOGIC("Skipping the found link");
-                skip = false;
-                continue;
+                updates[i] = SPF_ROUTES;
+                break;
             }
         }
     }
-    return nullptr;
 }
 
-//
-// Used for unit tests.
-//
 void
-GlobalRouteManagerImpl::DebugSPFCalculate(Ipv4Address root)
+GlobalRouteManagerImpl::ComputeRoutes(const SpfGraph& graph,
+                                      std::vector<SpfTree>& trees,
+                                      const std::vector<SpfUpdate>& updates,
+                                      bool replace)
 {
-    NS_LOG_FUNCTION(this << root);
-    SPFCalculate(root);
-}
+    NS_LOG_FUNCTION(this << trees.size() << replace);
 
-//
-// Used to test if a node is a stub, from an OSPF sense.
+    UintegerValue value;
+    g_spfThreads.GetValue(value);
+    uint32_t nThreads = value.Get() ? value.Get() : std::thread::hardware_concurrency();
+
+    // The trees are computed by batches, to bound the memory used by the
+    // routes waiting to be installed
+    const std::size_t batchSize = 256;
+    m_nSpfCalculations = 0;
+    for (std::size_t first = 0; first < trees.size(); first += batchSize)
+    {
+        std::size_t last = std::min(trees.size(), first + batchSize);
+        std::vector<std::vector<SpfRoute>> routes(last - first);
+        std::vector<uint8_t> changed(last - first, 0);
+        std::atomic<std::size_t> next{first};
+
+        // The SPF calculations only read the graph, and write their own tree
+        // and routes, hence they can run in parallel
+        auto work = [&]() {
+            for (std::size_t i; (i = next++) < last;)
+            {
+                SpfTree& tree = trees[i];
+                std::vector<SpfRoute>& treeRoutes = routes[i - first];
+                if (updates[i] == SPF_NONE)
+                {
+                    continue;
+                }
+                if (updates[i] == SPF_TREE || tree.stub)
+                {
+                    // Optimize SPF calculation, for ns-3.
+                    // We do not need to calculate SPF for every node in the network if this
+                    // node has only one interface through which another router can be
+                    // reached.  Instead, short-circuit this computation and just install
+                    // a default route in the CheckForStubNode() method.
+                    tree.stub = graph.nodes && CheckForStubNode(graph, tree.root, treeRoutes);
+                    if (tree.stub)
+                    {
+                        tree.distance.clear();
+                        tree.order.clear();
+                        tree.preorder.clear();
+                        tree.exitBegin.clear();
+                        tree.exits.clear();
+                    }
+                    else
+                    {
+                        SPFCalculate(graph, tree);
+                    }
+                }
+                if (!tree.stub)
+                {
+                    SPFRoutes(graph, tree, treeRoutes);
+                }
+
+                uint64_t hash = 0;
+                for (const auto& route : treeRoutes)
+                {
+                    for (uint32_t word :
+                         {static_cast<uint32_t>(route.type),
+                          route.dest,
+                          route.mask,
+                          route.nextHop,
+                          static_cast<uint32_t>(route.outIf)})
+                    {
+                        hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+                        hash ^= hash >> 29;
+                    }
+                }
+                changed[i - first] = hash != tree.hash || treeRoutes.size() != tree.nRoutes;
+                tree.hash = hash;
+                tree.nRoutes = treeRoutes.size();
+            }
+        };
+
+        std::size_t nWorkers = 0;
+        for (std::size_t i = first; i < last; i++)
+        {
+            nWorkers += updates[i] != SPF_NONE;
+        }
+        nWorkers = std::min<std::size_t>(nWorkers, nThreads);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 1; t < nWorkers; t++)
+        {
+            threads.emplace_back(work);
+        }
+        work();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (std::size_t i = first; i < last; i++)
+        {
+            if (updates[i] == SPF_TREE && !trees[i].stub)
+            {
+                m_nSpfCalculations++;
+            }
+            if (changed[i - first])
+            {
+                InstallRoutes(trees[i].node, routes[i - first], replace);
+            }
+        }
+    }
+    NS_LOG_LOGIC("Ran " << m_nSpfCalculations << " SPF calculations for " << trees.size()
+                        << " routers");
+}
+
+// Used to test if a node is a stub, from an OSPF sense.
 // If there is only one link of type 1 or 2, then a default route
 // can safely be added to the next-hop router and SPF does not need
 // to be run
-//
 bool
-GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
+GlobalRouteManagerImpl::CheckForStubNode(const SpfGraph& graph,
+                                         uint32_t root,
+                                         std::vector<SpfRoute>& routes)
 {
-    NS_LOG_FUNCTION(this << root);
-    GlobalRoutingLSA* rlsa = m_lsdb->GetLSA(root);
-    Ipv4Address myRouterId = rlsa->GetLinkStateId();
+    uint32_t myRouterId = graph.vertices[root].id;
     int transits = 0;
-    GlobalRoutingLinkRecord* transitLink = nullptr;
-    for (uint32_t i = 0; i < rlsa->GetNLinkRecords(); i++)
+    const SpfGraph::Record* transitLink = nullptr;
+    for (uint32_t i = graph.recordBegin[root]; i < graph.recordBegin[root + 1]; i++)
     {
-        GlobalRoutingLinkRecord* l = rlsa->GetLinkRecord(i);
-        if (l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork ||
-            l->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint)
+        const SpfGraph::Record& l = graph.records[i];
+        if (l.type == GlobalRoutingLinkRecord::TransitNetwork ||
+            l.type == GlobalRoutingLinkRecord::PointToPoint)
         {
             transits++;
-            transitLink = l;
+            transitLink = &l;
         }
     }
     if (transits == 0)
     {
         // This router is not connected to any router.  Probably, global
-        // routing should not be called for this node, but we can just raise
-        // a warning here and return true.
-        NS_LOG_WARN("all nodes should have at least one transit link:" << root);
+        // routing should not be called for this node, but we can just
+        // return true.
         return true;
     }
-    if (transits == 1)
+    if (transits == 1 && transitLink->type == GlobalRoutingLinkRecord::PointToPoint)
     {
-        if (transitLink->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
+        // Install default route to next hop
+        // The link record LinkID is the router ID of the peer.
+        // The Link Data is the local IP interface address
+        auto w = graph.index.find(transitLink->linkId);
+        for (uint32_t j = w != graph.index.end() ? graph.recordBegin[w->second] : 0;
+             w != graph.index.end() && j < graph.recordBegin[w->second + 1];
+             ++j)
         {
-            // Install default route to next hop router
-            // What is the next hop?  We need to check all neighbors on the link.
-            // If there is a single router that has two transit links, then
-            // that is the default next hop.  If there are more than one
-            // routers on link with multiple transit links, return false.
-            // Not yet implemented, so simply return false
-            NS_LOG_LOGIC("TBD: Would have inserted default for transit");
-            return false;
-        }
-        else if (transitLink->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint)
-        {
-            // Install default route to next hop
-            // The link record LinkID is the router ID of the peer.
-            // The Link Data is the local IP interface address
-            GlobalRoutingLSA* w_lsa = m_lsdb->GetLSA(transitLink->GetLinkId());
-            uint32_t nLinkRecords = w_lsa->GetNLinkRecords();
-            for (uint32_t j = 0; j < nLinkRecords; ++j)
+            // Find the point-to-point link record that corresponds to our routerId
+            const SpfGraph::Record& lr = graph.records[j];
+            if (lr.type == GlobalRoutingLinkRecord::PointToPoint && lr.linkId == myRouterId)
             {
-                //
-                // We are only concerned about point-to-point links
-                //
-                GlobalRoutingLinkRecord* lr = w_lsa->GetLinkRecord(j);
-                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                    continue;
-                }
-                // Find the link record that corresponds to our routerId
-                if (lr->GetLinkId() == myRouterId)
-                {
-                    // Next hop is stored in the LinkID field of lr
-                    Ptr<GlobalRouter> router = rlsa->GetNode()->GetObject<GlobalRouter>();
-                    NS_ASSERT(router);
-                    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                    NS_ASSERT(gr);
-                    gr->AddNetworkRouteTo(Ipv4Address("0.0.0.0"),
-                                          Ipv4Mask("0.0.0.0"),
-                                          lr->GetLinkData(),
-                                          FindOutgoingInterfaceId(transitLink->GetLinkData()));
-                    NS_LOG_LOGIC("Inserting default route for node "
-                                 << myRouterId << " to next hop " << lr->GetLinkData()
-                                 << " via interface "
-                                 << FindOutgoingInterfaceId(transitLink->GetLinkData()));
-                    return true;
-                }
+                // Next hop is stored in the LinkData field of lr
+                routes.push_back({SpfRoute::NETWORK,
+                                  0,
+                                  0,
+                                  lr.linkData,
+                                  FindOutgoingInterfaceId(graph, root, transitLink->linkData)});
+                return true;
             }
         }
     }
+    // A stub router on a transit network would need a default route to the
+    // router of the network with other transit links: not yet implemented
     return false;
 }
 
 // quagga ospf_spf_calculate
 void
-GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
+GlobalRouteManagerImpl::SPFCalculate(const SpfGraph& graph, SpfTree& tree)
 {
-    NS_LOG_FUNCTION(this << root);
-
-    SPFVertex* v;
-    //
-    // Initialize the Link State Database.
-    //
-    m_lsdb->Initialize();
-    //
-    // The candidate queue is a priority queue of SPFVertex objects, with the top
-    // of the queue being the closest vertex in terms of distance from the root
-    // of the tree.  Initially, this queue is empty.
-    //
-    CandidateQueue candidate;
-    NS_ASSERT(candidate.Size() == 0);
-    //
-    // Initialize the shortest-path tree to only contain the router doing the
-    // calculation.  Each router (and corresponding network) is a vertex in the
-    // shortest path first (SPF) tree.
-    //
-    v = new SPFVertex(m_lsdb->GetLSA(root));
-    //
-    // This vertex is the root of the SPF tree and it is distance 0 from the root.
-    // We also mark this vertex as being in the SPF tree.
-    //
-    m_spfroot = v;
-    v->SetDistanceFromRoot(0);
-    v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
-    NS_LOG_LOGIC("Starting SPFCalculate for node " << root);
+    const uint32_t n = graph.vertices.size();
+    const uint32_t root = tree.root;
 
-    //
-    // Optimize SPF calculation, for ns-3.
-    // We do not need to calculate SPF for every node in the network if this
-    // node has only one interface through which another router can be
-    // reached.  Instead, short-circuit this computation and just install
-    // a default route in the CheckForStubNode() method.
-    //
-    if (NodeList::GetNNodes() > 0 && CheckForStubNode(root))
+    enum Status : uint8_t
     {
-        NS_LOG_LOGIC("SPFCalculate truncated for stub node " << root);
-        delete m_spfroot;
-        return;
-    }
-
-    for (;;)
-    {
-        //
-        // The operations we need to do are given in the OSPF RFC which we reference
-        // as we go along.
-        //
-        // RFC2328 16.1. (2).
-        //
-        // We examine the Global Router Link Records in the Link State
-        // Advertisements of the current vertex.  If there are any point-to-point
-        // links to unexplored adjacent vertices we add them to the tree and update
-        // the distance and next hop information on how to get there.  We also add
-        // the new vertices to the candidate queue (the priority queue ordered by
-        // shortest path).  If the new vertices represent shorter paths, we use them
-        // and update the path cost.
-        //
-        SPFNext(v, candidate);
-        //
-        // RFC2328 16.1. (3).
-        //
-        // If at this step the candidate list is empty, the shortest-path tree (of
-        // transit vertices) has been completely built and this stage of the
-        // procedure terminates.
-        //
-        if (candidate.Size() == 0)
+        LSA_SPF_NOT_EXPLORED,
+        LSA_SPF_CANDIDATE,
+        LSA_SPF_IN_SPFTREE
+    };
+
+    std::vector<Status> status(n, LSA_SPF_NOT_EXPLORED);
+    std::vector<uint32_t> sequence(n, 0);
+    std::vector<std::vector<SpfExit>> exits(n);
+    std::vector<std::vector<uint32_t>> parents(n);
+    std::vector<std::vector<uint32_t>> children(n);
+    tree.distance.assign(n, SPF_INFINITY);
+    tree.order.clear();
+
+    // The candidate queue is ordered by distance from the root, then networks
+    // before routers (to find all the equal-cost paths), then by the order in
+    // which the candidates were reached at their distance.  The entries of the
+    // candidates whose distance decreased are skipped.
+    typedef std::tuple<uint32_t, bool, uint32_t, uint32_t> Candidate;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> candidates;
+    uint32_t nextSequence = 0;
+
+    // Calculate nexthop from root through V (parent) to vertex W (destination),
+    // derived from quagga ospf_nexthop_calculation() 16.1.1.
+    auto nexthop = [&](uint32_t v, uint32_t w, const SpfGraph::Edge& l) {
+        std::vector<SpfExit> wExits;
+        // The first link record of vertex <w> to vertex <id>, which gives the
+        // address of <w> on that link
+        auto linkRemote = [&graph, w](uint32_t id) -> const SpfGraph::Record* {
+            for (uint32_t i = graph.recordBegin[w]; i < graph.recordBegin[w + 1]; i++)
+            {
+                if (graph.records[i].linkId == id)
+                {
+                    return &graph.records[i];
+                }
+            }
+            return nullptr;
+        };
+        if (v == root && !graph.vertices[w].network)
         {
-            break;
+            // The next hop is the address of <w> on the point-to-point link to
+            // the root, and the outgoing interface is the one of the root on
+            // that link (the link data of <l>)
+            if (const SpfGraph::Record* remote = linkRemote(graph.vertices[v].id))
+            {
+                wExits.emplace_back(remote->linkData,
+                                    FindOutgoingInterfaceId(graph, root, l.linkData));
+            }
         }
-        //
-        // Choose the vertex belonging to the candidate list that is closest to the
-        // root, and add it to the shortest-path tree (removing it from the candidate
-        // list in the process).
-        //
-        // Recall that in the previous step, we created SPFVertex structures for each
-        // of the routers found in the Global Router Link Records and added tehm to
-        // the candidate list.
-        //
-        NS_LOG_LOGIC(candidate);
-        v = candidate.Pop();
-        NS_LOG_LOGIC("Popped vertex " << v->GetVertexId());
-        //
-        // Update the status field of the vertex to indicate that it is in the SPF
-        // tree.
-        //
-        v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
-        //
-        // The current vertex has a parent pointer.  By calling this rather oddly
-        // named method (blame quagga) we add the current vertex to the list of
-        // children of that parent vertex.  In the next hop calculation called during
-        // SPFNext, the parent pointer was set but the vertex has been orphaned up
-        // to now.
-        //
-        SPFVertexAddParent(v);
-        //
-        // Note that when there is a choice of vertices closest to the root, network
-        // vertices must be chosen before router vertices in order to necessarily
-        // find all equal-cost paths.
-        //
-        // RFC2328 16.1. (4).
-        //
-        // This is the method that actually adds the routes.  It'll walk the list
-        // of nodes in the system, looking for the node corresponding to the router
-        // ID of the root of the tree -- that is the router we're building the routes
-        // for.  It looks for the Ipv4 interface of that node and remembers it.  So
-        // we are only actually adding routes to that one node at the root of the SPF
-        // tree.
-        //
-        // We're going to pop of a pointer to every vertex in the tree except the
-        // root in order of distance from the root.  For each of the vertices, we call
-        // SPFIntraAddRouter ().  Down in SPFIntraAddRouter, we look at all of the
-        // point-to-point Global Router Link Records (the links to nodes adjacent to
-        // the node represented by the vertex).  We add a route to the IP address
-        // specified by the m_linkData field of each of those link records.  This will
-        // be the *local* IP address associated with the interface attached to the
-        // link.  We use the outbound interface and next hop information present in
-        // the vertex <v> which have possibly been inherited from the root.
-        //
-        // To summarize, we're going to look at the node represented by <v> and loop
-        // through its point-to-point links, adding a *host* route to the local IP
-        // address (at the <v> side) for each of those links.
-        //
-        if (v->GetVertexType() == SPFVertex::VertexRouter)
+        else if (v == root)
         {
-            SPFIntraAddRouter(v);
+            // W is a directly connected network; no next hop is required
+            const SpfGraph::Vertex& network = graph.vertices[w];
+            wExits.emplace_back(0, FindOutgoingInterfaceId(graph, root, network.id, network.mask));
         }
-        else if (v->GetVertexType() == SPFVertex::VertexNetwork)
+        else if (graph.vertices[v].network)
         {
-            SPFIntraAddTransit(v);
+            // 16.1.1 para 5. ...the parent vertex is a network that
+            // directly connects the calculating router to the destination
+            // router.  The list of next hops is then determined by
+            // examining the destination's router-LSA...  The exits to the
+            // network through other routers are inherited.
+            const SpfGraph::Record* remote = linkRemote(graph.vertices[v].id);
+            for (const auto& [nextHop, outIf] : exits[v])
+            {
+                if (nextHop != 0)
+                {
+                    wExits.emplace_back(nextHop, outIf);
+                }
+                else if (remote)
+                {
+                    wExits.emplace_back(remote->linkData, outIf);
+                }
+            }
+            std::sort(wExits.begin(), wExits.end());
+            wExits.erase(std::unique(wExits.begin(), wExits.end()), wExits.end());
         }
         else
         {
-            NS_ASSERT_MSG(0, "illegal SPFVertex type");
-        }
-        //
-        // RFC2328 16.1. (5).
-        //
-        // Iterate the algorithm by returning to Step 2 until there are no more
-        // candidate vertices.
-
-    } // end for loop
-
-    // Second stage of SPF calculation procedure
-    SPFProcessStubs(m_spfroot);
-    for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs(); i++)
-    {
-        m_spfroot->ClearVertexProcessed();
-        GlobalRoutingLSA* extlsa = m_lsdb->GetExtLSA(i);
-        NS_LOG_LOGIC("Processing External LSA with id " << extlsa->GetLinkStateId());
-        ProcessASExternals(m_spfroot, extlsa);
-    }
-
-    //
-    // We're all done setting the routing information for the node at the root of
-    // the SPF tree.  Delete all of the vertices and corresponding resources.  Go
-    // possibly do it again for the next router.
-    //
-    delete m_spfroot;
-    m_spfroot = nullptr;
-}
-
-void
-GlobalRouteManagerImpl::ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extlsa)
-{
-    NS_LOG_FUNCTION(this << v << extlsa);
-    NS_LOG_LOGIC("Processing external for destination "
-                 << extlsa->GetLinkStateId() << ", for router " << v->GetVertexId()
-                 << ", advertised by " << extlsa->GetAdvertisingRouter());
-    if (v->GetVertexType() == SPFVertex::VertexRouter)
-    {
-        GlobalRoutingLSA* rlsa = v->GetLSA();
-        NS_LOG_LOGIC("Processing router LSA with id " << rlsa->GetLinkStateId());
-        if ((rlsa->GetLinkStateId()) == (extlsa->GetAdvertisingRouter()))
-        {
-            NS_LOG_LOGIC("Found advertising router to destination");
-            SPFAddASExternal(extlsa, v);
-        }
-    }
-    for (uint32_t i = 0; i < v->GetNChildren(); i++)
-    {
-        if (!v->GetChild(i)->IsVertexProcessed())
-        {
-            NS_LOG_LOGIC("Vertex's child " << i << " not yet processed, processing...");
-            ProcessASExternals(v->GetChild(i), extlsa);
-            v->GetChild(i)->SetVertexProcessed(true);
+            // The exits are inherited from the vertex closer to the root
+            wExits = exits[v];
         }
-    }
-}
-
-//
-// Adding external routes to routing table - modeled after
-// SPFAddIntraAddStub()
-//
-
-void
-GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v)
-{
-    NS_LOG_FUNCTION(this << extlsa << v);
-
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFAddASExternal (): Root pointer not set");
-    // Two cases to consider: We are advertising the external ourselves
-    // => No need to add anything
-    // OR find best path to the advertising router
-    if (v->GetVertexId() == m_spfroot->GetVertexId())
-    {
-        NS_LOG_LOGIC("External is on local host: " << v->GetVertexId() << "; returning");
-        return;
-    }
-    NS_LOG_LOGIC("External is on remote host: " << extlsa->GetAdvertisingRouter()
-                                                << "; installing");
+        return wExits;
+    };
 
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
-    //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    tree.distance[root] = 0;
+    status[root] = LSA_SPF_IN_SPFTREE;
+    for (uint32_t v = root;;)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        // RFC2328 16.1. (2).  Examine the links of the vertex, and update the
+        // candidates with the vertices reached at a lower or equal cost
+        for (uint32_t k = graph.edgeBegin[v]; k < graph.edgeBegin[v + 1]; k++)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
-        }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = extlsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
+            const SpfGraph::Edge& l = graph.edges[k];
+            const uint32_t w = l.to;
+            if (status[w] == LSA_SPF_IN_SPFTREE)
             {
                 continue;
             }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+            uint32_t distance = tree.distance[v] + l.metric;
+            if (status[w] == LSA_SPF_CANDIDATE && tree.distance[w] < distance)
             {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add external network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
+                continue;
+            }
+            std::vector<SpfExit> wExits = nexthop(v, w, l);
+            if (status[w] == LSA_SPF_CANDIDATE && tree.distance[w] == distance)
+            {
+                // Equal cost multiple paths: merge the parents and the exits
+                exits[w].insert(exits[w].end(), wExits.begin(), wExits.end());
+                std::sort(exits[w].begin(), exits[w].end());
+                exits[w].erase(std::unique(exits[w].begin(), exits[w].end()), exits[w].end());
+                if (std::find(parents[w].begin(), parents[w].end(), v) == parents[w].end())
                 {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
+                    parents[w].push_back(v);
                 }
+                continue;
             }
-            return;
-        } // if
-    }     // for
-}
+            // A new candidate, or a lower-cost path to a candidate
+            exits[w] = std::move(wExits);
+            parents[w].assign(1, v);
+            tree.distance[w] = distance;
+            status[w] = LSA_SPF_CANDIDATE;
+            sequence[w] = nextSequence++;
+            candidates.emplace(distance, !graph.vertices[w].network, sequence[w], w);
+        }
 
-// Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
-// stub link records will exist for point-to-point interfaces and for
-// broadcast interfaces for which no neighboring router can be found
-void
-GlobalRouteManagerImpl::SPFProcessStubs(SPFVertex* v)
-{
-    NS_LOG_FUNCTION(this << v);
-    NS_LOG_LOGIC("Processing stubs for " << v->GetVertexId());
-    if (v->GetVertexType() == SPFVertex::VertexRouter)
-    {
-        GlobalRoutingLSA* rlsa = v->GetLSA();
-        NS_LOG_LOGIC("Processing router LSA with id " << rlsa->GetLinkStateId());
-        for (uint32_t i = 0; i < rlsa->GetNLinkRecords(); i++)
+        // RFC2328 16.1. (3).  Add the closest candidate to the tree, or stop
+        // if there is none
+        v = SPF_INFINITY;
+        while (!candidates.empty() && v == SPF_INFINITY)
         {
-            NS_LOG_LOGIC("Examining link " << i << " of " << v->GetVertexId() << "'s "
-                                           << v->GetLSA()->GetNLinkRecords() << " link records");
-            GlobalRoutingLinkRecord* l = v->GetLSA()->GetLinkRecord(i);
-            if (l->GetLinkType() == GlobalRoutingLinkRecord::StubNetwork)
+            auto [distance, router, seq, w] = candidates.top();
+            candidates.pop();
+            if (status[w] == LSA_SPF_CANDIDATE && sequence[w] == seq)
             {
-                NS_LOG_LOGIC("Found a Stub record to " << l->GetLinkId());
-                SPFIntraAddStub(l, v);
-                continue;
+                v = w;
             }
         }
-    }
-    for (uint32_t i = 0; i < v->GetNChildren(); i++)
-    {
-        if (!v->GetChild(i)->IsVertexProcessed())
+        if (v == SPF_INFINITY)
         {
-            SPFProcessStubs(v->GetChild(i));
-            v->GetChild(i)->SetVertexProcessed(true);
+            break;
+        }
+        status[v] = LSA_SPF_IN_SPFTREE;
+        tree.order.push_back(v);
+        for (uint32_t parent : parents[v])
+        {
+            children[parent].push_back(v);
         }
     }
-}
-
-// RFC2328 16.1. second stage.
-void
-GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v)
-{
-    NS_LOG_FUNCTION(this << l << v);
-
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddStub (): Root pointer not set");
-
-    // XXX simplified logic for the moment.  There are two cases to consider:
-    // 1) the stub network is on this router; do nothing for now
-    //    (already handled above)
-    // 2) the stub network is on a remote router, so I should use the
-    // same next hop that I use to get to vertex v
-    if (v->GetVertexId() == m_spfroot->GetVertexId())
-    {
-        NS_LOG_LOGIC("Stub is on local host: " << v->GetVertexId() << "; returning");
-        return;
-    }
-    NS_LOG_LOGIC("Stub is on remote host: " << v->GetVertexId() << "; installing");
-    //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
 
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
-    //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    // The depth-first order of the tree, in which the routes to the stub
+    // networks are added (quagga ospf_spf_process_stubs)
+    tree.preorder.clear();
+    std::vector<uint8_t> processed(n, 0);
+    std::vector<uint32_t> stack(1, root);
+    while (!stack.empty())
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        uint32_t v = stack.back();
+        stack.pop_back();
+        if (processed[v])
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
             continue;
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
+        processed[v] = 1;
+        tree.preorder.push_back(v);
+        stack.insert(stack.end(), children[v].rbegin(), children[v].rend());
+    }
 
-        if (rtr->GetRouterId() == routerId)
-        {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask(l->GetLinkData().Get());
-            Ipv4Address tempip = l->GetLinkId();
-            tempip = tempip.CombineMask(tempmask);
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
+    tree.exitBegin.assign(1, 0);
+    tree.exits.clear();
+    for (uint32_t v = 0; v < n; v++)
+    {
+        tree.exits.insert(tree.exits.end(), exits[v].begin(), exits[v].end());
+        tree.exitBegin.push_back(tree.exits.size());
+    }
+}
 
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
+void
+GlobalRouteManagerImpl::SPFRoutes(const SpfGraph& graph,
+                                  const SpfTree& tree,
+                                  std::vector<SpfRoute>& routes)
+{
+    auto addRoutes = [&](uint32_t v, SpfRoute::Type type, uint32_t dest, uint32_t mask) {
+        // walk through all available exit directions due to ECMP,
+        // and add a route for each of the exit direction toward
+        // the vertex 'v'
+        for (uint32_t i = tree.exitBegin[v]; i < tree.exitBegin[v + 1]; i++)
+        {
+            const auto& [nextHop, outIf] = tree.exits[i];
+            if (outIf >= 0)
             {
-                continue;
+                routes.push_back({type, dest, mask, nextHop, outIf});
             }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
-}
+        }
+    };
 
-//
-// Return the interface number corresponding to a given IP address and mask
-// This is a wrapper around GetInterfaceForPrefix(), but we first
-// have to find the right node pointer to pass to that function.
-// If no such interface is found, return -1 (note:  unit test framework
-// for routing assumes -1 to be a legal return value)
-//
-int32_t
-GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask)
-{
-    NS_LOG_FUNCTION(this << a << amask);
-    //
-    // We have an IP address <a> and a vertex ID of the root of the SPF tree.
-    // The question is what interface index does this address correspond to.
-    // The answer is a little complicated since we have to find a pointer to
-    // the node corresponding to the vertex ID, find the Ipv4 interface on that
-    // node in order to iterate the interfaces and find the one corresponding to
-    // the address in question.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-    //
-    // Walk the list of nodes in the system looking for the one corresponding to
-    // the node at the root of the SPF tree.  This is the node for which we are
-    // building the routing table.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    // RFC2328 16.1. (4).  For each router, in the order it joined the tree, add
+    // a host route to the local address of each of its point-to-point links.
+    // For each transit network, add a route to the network.
+    for (uint32_t v : tree.order)
     {
-        Ptr<Node> node = *i;
-
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-        //
-        // If the node doesn't have a GlobalRouter interface it can't be the one
-        // we're interested in.
-        //
-        if (!rtr)
+        const SpfGraph::Vertex& vertex = graph.vertices[v];
+        if (vertex.network)
         {
+            addRoutes(v, SpfRoute::NETWORK, vertex.id & vertex.mask, vertex.mask);
             continue;
         }
-
-        if (rtr->GetRouterId() == routerId)
+        for (uint32_t j = graph.recordBegin[v]; j < graph.recordBegin[v + 1]; j++)
         {
-            //
-            // This is the node we're building the routing table for.  We're going to need
-            // the Ipv4 interface to look for the ipv4 interface index.  Since this node
-            // is participating in routing IP version 4 packets, it certainly must have
-            // an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Look through the interfaces on this node for one that has the IP address
-            // we're looking for.  If we find one, return the corresponding interface
-            // index, or -1 if not found.
-            //
-            int32_t interface = ipv4->GetInterfaceForPrefix(a, amask);
-
-#if 0
-          if (interface < 0)
+            const SpfGraph::Record& lr = graph.records[j];
+            if (lr.type == GlobalRoutingLinkRecord::PointToPoint)
             {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
+                addRoutes(v, SpfRoute::HOST, lr.linkData, 0xffffffff);
             }
-#endif
-            return interface;
         }
     }
-    //
-    // Couldn't find it.
-    //
-    NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
-    return -1;
-}
-
-//
-// This method is derived from quagga ospf_intra_add_router ()
-//
-// This is where we are actually going to add the host routes to the routing
-// tables of the individual nodes.
-//
-// The vertex passed as a parameter has just been added to the SPF tree.
-// This vertex must have a valid m_root_oid, corresponding to the outgoing
-// interface on the root router of the tree that is the first hop on the path
-// to the vertex.  The vertex must also have a next hop address, corresponding
-// to the next hop on the path to the vertex.  The vertex has an m_lsa field
-// that has some number of link records.  For each point to point link record,
-// the m_linkData is the local IP address of the link.  This corresponds to
-// a destination IP address, reachable from the root, to which we add a host
-// route.
-//
-void
-GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v)
-{
-    NS_LOG_FUNCTION(this << v);
 
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
-    //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
-    //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    // Second stage of SPF calculation procedure: the stub networks of the
+    // routers other than the root, which use the exits to their router
+    for (uint32_t v : tree.preorder)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        if (v == tree.root || graph.vertices[v].network)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
             continue;
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        for (uint32_t j = graph.recordBegin[v]; j < graph.recordBegin[v + 1]; j++)
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-
-            uint32_t nLinkRecords = lsa->GetNLinkRecords();
-            //
-            // Iterate through the link records on the vertex to which we're going to add
-            // routes.  To make sure we're being clear, we're going to add routing table
-            // entries to the tables on the node corresponding to the root of the SPF tree.
-            // These entries will have routes to the IP addresses we find from looking at
-            // the local side of the point-to-point links found on the node described by
-            // the vertex <v>.
-            //
-            NS_LOG_LOGIC(" Node " << node->GetId() << " found " << nLinkRecords
-                                  << " link records in LSA " << lsa << "with LinkStateId "
-                                  << lsa->GetLinkStateId());
-            for (uint32_t j = 0; j < nLinkRecords; ++j)
+            const SpfGraph::Record& l = graph.records[j];
+            if (l.type == GlobalRoutingLinkRecord::StubNetwork)
             {
-                //
-                // We are only concerned about point-to-point links
-                //
-                GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
-                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                    continue;
-                }
-                //
-                // Here's why we did all of that work.  We're going to add a host route to the
-                // host address found in the m_linkData field of the point-to-point link
-                // record.  In the case of a point-to-point link, this is the local IP address
-                // of the node connected to the link.  Each of these point-to-point links
-                // will correspond to a local interface that has an IP address to which
-                // the node at the root of the SPF tree can send packets.  The vertex <v>
-                // (corresponding to the node that has these links and interfaces) has
-                // an m_nextHop address precalculated for us that is the address to which the
-                // root node should send packets to be forwarded to these IP addresses.
-                // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-                // which the packets should be send for forwarding.
-                //
-                Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-                if (!router)
-                {
-                    continue;
-                }
-                Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                NS_ASSERT(gr);
-                // walk through all available exit directions due to ECMP,
-                // and add host route for each of the exit direction toward
-                // the vertex 'v'
-                for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-                {
-                    SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                    Ipv4Address nextHop = exit.first;
-                    int32_t outIf = exit.second;
-                    if (outIf >= 0)
-                    {
-                        gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " adding host route to " << lr->GetLinkData()
-                                               << " using next hop " << nextHop
-                                               << " and outgoing interface " << outIf);
-                    }
-                    else
-                    {
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " NOT able to add host route to "
-                                               << lr->GetLinkData() << " using next hop " << nextHop
-                                               << " since outgoing interface id is negative "
-                                               << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+                addRoutes(v, SpfRoute::NETWORK, l.linkId & l.linkData, l.linkData);
             }
-            //
-            // Done adding the routes for the selected node.
-            //
-            return;
         }
     }
-}
-
-void
-GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
-{
-    NS_LOG_FUNCTION(this << v);
-
-    NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
-    //
-    // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
 
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
-    //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    // The external routes use the exits to their advertising router, unless
+    // it is the root
+    for (const auto& external : graph.externals)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        auto v = graph.index.find(external.router);
+        if (v != graph.index.end() && v->second != tree.root &&
+            !graph.vertices[v->second].network && tree.distance[v->second] != SPF_INFINITY)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            addRoutes(v->second, SpfRoute::EXTERNAL, external.dest, external.mask);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
+    }
+}
 
-        if (rtr->GetRouterId() == routerId)
+// Return the interface number corresponding to a given IP address and mask
+// If no such interface is found, return -1 (note:  unit test framework
+// for routing assumes -1 to be a legal return value)
+int32_t
+GlobalRouteManagerImpl::FindOutgoingInterfaceId(const SpfGraph& graph,
+                                                uint32_t root,
+                                                uint32_t a,
+                                                uint32_t amask)
+{
+    for (uint32_t i = graph.addrBegin[root]; i < graph.addrBegin[root + 1]; i++)
+    {
+        if ((graph.addresses[i].local & amask) == (a & amask))
         {
-            NS_LOG_LOGIC("setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = lsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all available exit directions due to ECMP,
-            // and add host route for each of the exit direction toward
-            // the vertex 'v'
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative " << outIf);
-                }
-            }
+            return graph.addresses[i].interface;
         }
     }
+    return -1;
 }
 
-// Derived from quagga ospf_vertex_add_parents ()
-//
-// This is a somewhat oddly named method (blame quagga).  Although you might
-// expect it to add a parent *to* something, it actually adds a vertex
-// to the list of children *in* each of its parents.
-//
-// Given a pointer to a vertex, it links back to the vertex's parent that it
-// already has set and adds itself to that vertex's list of children.
-//
 void
-GlobalRouteManagerImpl::SPFVertexAddParent(SPFVertex* v)
+GlobalRouteManagerImpl::InstallRoutes(uint32_t node,
+                                      const std::vector<SpfRoute>& routes,
+                                      bool replace)
 {
-    NS_LOG_FUNCTION(this << v);
-
-    for (uint32_t i = 0;;)
+    NS_LOG_FUNCTION(node << routes.size() << replace);
+    if (node >= NodeList::GetNNodes())
     {
-        SPFVertex* parent;
-        // check if all parents of vertex v
-        if ((parent = v->GetParent(i++)) == nullptr)
+        NS_LOG_LOGIC("No node for the routes");
+        return;
+    }
+    Ptr<GlobalRouter> router = NodeList::GetNode(node)->GetObject<GlobalRouter>();
+    if (!router)
+    {
+        NS_LOG_LOGIC("No GlobalRouter interface on node " << node);
+        return;
+    }
+    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
+    NS_ASSERT(gr);
+    while (replace && gr->GetNRoutes() > 0)
+    {
+        gr->RemoveRoute(0);
+    }
+    for (const auto& route : routes)
+    {
+        NS_LOG_LOGIC("Node " << node << " adding route to " << Ipv4Address(route.dest) << "/"
+                             << Ipv4Mask(route.mask) << " using next hop "
+                             << Ipv4Address(route.nextHop) << " via interface " << route.outIf);
+        switch (route.type)
         {
+        case SpfRoute::HOST:
+            gr->AddHostRouteTo(Ipv4Address(route.dest), Ipv4Address(route.nextHop), route.outIf);
+            break;
+        case SpfRoute::NETWORK:
+            gr->AddNetworkRouteTo(Ipv4Address(route.dest),
+                                  Ipv4Mask(route.mask),
+                                  Ipv4Address(route.nextHop),
+                                  route.outIf);
+            break;
+        case SpfRoute::EXTERNAL:
+            gr->AddASExternalRouteTo(Ipv4Address(route.dest),
+                                     Ipv4Mask(route.mask),
+                                     Ipv4Address(route.nextHop),
+                                     route.outIf);
             break;
         }
-        parent->AddChild(v);
     }
 }
 
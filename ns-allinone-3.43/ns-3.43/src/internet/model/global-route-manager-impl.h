@@ -20,6 +20,7 @@
 #include <map>
 #include <queue>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -27,7 +28,6 @@ namespace ns3
 
 const uint32_t SPF_INFINITY = 0xffffffff; //!< "infinite" distance between nodes
 
-class CandidateQueue;
 class Ipv4GlobalRouting;
 
 /**
@@ -628,6 +628,14 @@ class GlobalRouteManagerLSDB
      */
     GlobalRoutingLSA* GetLSAByLinkData(Ipv4Address addr) const;
 
+    /**
+     * @brief Get the router and network Link State Advertisements of the
+     * database, in the order of their link state ID.
+     *
+     * @returns the Link State Advertisements
+     */
+    std::vector<GlobalRoutingLSA*> GetLSAs() const;
+
     /**
      * @brief Set all LSA flags to an initialized state, for SPF computation
      *
@@ -668,6 +676,8 @@ class GlobalRouteManagerLSDB
         LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
 
     LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
+    /// Link State Advertisements indexed by the link data of their transit network link records
+    std::map<Ipv4Address, LSDBPair_t> m_linkDataIndex;
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
 };
@@ -714,6 +724,30 @@ class GlobalRouteManagerImpl
      */
     virtual void InitializeRoutes();
 
+    /**
+     * @brief Recompute the routes after a change of the link state.
+     *
+     * The link state database is built again and compared with the one of the
+     * previous route computation.  The SPF calculation is only run again for
+     * the routers whose link records or interfaces changed, for the neighbors
+     * of the routers whose link records changed, and for the routers for which
+     * a link that changed was on a shortest path, or is on a path as short as
+     * the shortest path.  The routes of the other routers are computed from
+     * their previous SPF tree if they reach a router whose link records
+     * changed, and the routing table of a router is only rewritten if its
+     * routes changed.  If the routers, the transit networks or the external
+     * routes changed, or if the routes were not computed by InitializeRoutes,
+     * the routes of all the routers are computed again, as DeleteGlobalRoutes,
+     * BuildGlobalRoutingDatabase and InitializeRoutes do.
+     */
+    virtual void RecomputeRoutes();
+
+    /**
+     * @brief Get the number of SPF calculations run by the last route computation
+     * @returns the number of SPF calculations
+     */
+    uint32_t GetNSpfCalculations() const;
+
     /**
      * @brief Debugging routine; allow client code to supply a pre-built LSDB
      * @param lsdb the pre-built LSDB
@@ -727,188 +761,232 @@ class GlobalRouteManagerImpl
     void DebugSPFCalculate(Ipv4Address root);
 
   private:
-    SPFVertex* m_spfroot;           //!< the root node
-    GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+    /// An exit from the root of an SPF tree: next hop address and outgoing interface
+    typedef std::pair<uint32_t, int32_t> SpfExit;
 
     /**
-     * \brief Test if a node is a stub, from an OSPF sense.
-     *
-     * If there is only one link of type 1 or 2, then a default route
-     * can safely be added to the next-hop router and SPF does not need
-     * to be run
+     * \brief A flat copy of the link state database, without pointers
      *
-     * \param root the root node
-     * \returns true if the node is a stub
+     * The vertices are the router and network LSAs of the database, in the
+     * order of their link state ID.  The link records of the router LSAs, the
+     * transit edges of the vertices and the addresses of the routers are stored
+     * in contiguous arrays indexed by vertex, so that the SPF calculations of
+     * the routers can run in parallel on the same graph.
      */
-    bool CheckForStubNode(Ipv4Address root);
+    struct SpfGraph
+    {
+        /// A router or network LSA
+        struct Vertex
+        {
+            uint32_t id;      //!< link state ID
+            bool network;     //!< true for a network LSA, false for a router LSA
+            uint32_t mask;    //!< network mask of a network LSA
+            bool operator==(const Vertex& other) const = default; //!< equality
+        };
+
+        /// A link record of a router LSA
+        struct Record
+        {
+            GlobalRoutingLinkRecord::LinkType type; //!< link type
+            uint32_t linkId;                        //!< link ID
+            uint32_t linkData;                      //!< link data
+            bool operator==(const Record& other) const = default; //!< equality
+        };
+
+        /// A link from a vertex to a router or a transit network
+        struct Edge
+        {
+            uint32_t to;       //!< index of the vertex at the end of the link
+            uint32_t metric;   //!< cost of the link
+            uint32_t linkData; //!< link data of the link record
+            bool operator==(const Edge& other) const = default; //!< equality
+        };
+
+        /// An external route
+        struct External
+        {
+            uint32_t router; //!< link state ID of the advertising router
+            uint32_t dest;   //!< destination network
+            uint32_t mask;   //!< destination network mask
+            bool operator==(const External& other) const = default; //!< equality
+        };
+
+        /// An address of an interface of a router
+        struct Address
+        {
+            uint32_t local;    //!< local address
+            int32_t interface; //!< interface index
+            bool operator==(const Address& other) const = default; //!< equality
+        };
+
+        bool nodes{false};                 //!< whether the simulation has nodes
+        std::vector<Vertex> vertices;      //!< router and network LSAs
+        std::vector<uint32_t> recordBegin; //!< first record of each vertex, and the end
+        std::vector<Record> records;       //!< link records of the router LSAs
+        std::vector<uint32_t> edgeBegin;   //!< first edge of each vertex, and the end
+        std::vector<Edge> edges;           //!< transit links, in the order of the records
+        std::vector<uint32_t> addrBegin;   //!< first address of each vertex, and the end
+        std::vector<Address> addresses;    //!< addresses of the routers with a node
+        std::vector<External> externals;   //!< external routes
+        std::unordered_map<uint32_t, uint32_t> index; //!< vertex index by link state ID
+    };
 
-    /**
-     * \brief Calculate the shortest path first (SPF) tree
-     *
-     * Equivalent to quagga ospf_spf_calculate
-     * \param root the root node
-     */
-    void SPFCalculate(Ipv4Address root);
+    /// A route computed for the root of an SPF tree
+    struct SpfRoute
+    {
+        /// Route type
+        enum Type : uint8_t
+        {
+            HOST,
+            NETWORK,
+            EXTERNAL
+        };
+
+        Type type;        //!< route type
+        uint32_t dest;    //!< destination host or network
+        uint32_t mask;    //!< destination network mask
+        uint32_t nextHop; //!< next hop address
+        int32_t outIf;    //!< outgoing interface
+    };
 
     /**
-     * \brief Process Stub nodes
-     *
-     * Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
-     * stub link records will exist for point-to-point interfaces and for
-     * broadcast interfaces for which no neighboring router can be found
-     *
-     * \param v vertex to be processed
+     * \brief The SPF tree of a router, kept to find the routers whose tree is
+     * affected by a change of the link state, and to compute the routes of the
+     * others without running the SPF calculation again
      */
-    void SPFProcessStubs(SPFVertex* v);
+    struct SpfTree
+    {
+        uint32_t root{0};                //!< index of the root vertex
+        uint32_t node{0};                //!< ID of the root node
+        bool stub{false};                //!< whether the routes are those of a stub router
+        std::vector<uint32_t> distance;  //!< distance from the root, or SPF_INFINITY
+        std::vector<uint32_t> order;     //!< vertices, in the order they joined the tree
+        std::vector<uint32_t> preorder;  //!< vertices, in depth-first order of the tree
+        std::vector<uint32_t> exitBegin; //!< first exit of each vertex, and the end
+        std::vector<SpfExit> exits;      //!< exits from the root to the vertices
+        uint64_t hash{0};                //!< hash of the routes
+        uint32_t nRoutes{0};             //!< number of routes
+    };
 
-    /**
-     * \brief Process Autonomous Systems (AS) External LSA
-     *
-     * \param v vertex to be processed
-     * \param extlsa external LSA
-     */
-    void ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extlsa);
+    GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+    SpfGraph m_graph;               //!< graph of the last route computation
+    std::vector<SpfTree> m_trees;   //!< SPF trees of the last route computation
+    bool m_routesValid;             //!< whether m_graph and m_trees match the routing tables
+    uint32_t m_nSpfCalculations;    //!< SPF calculations run by the last route computation
 
     /**
-     * \brief Examine the links in v's LSA and update the list of candidates with any
-     *        vertices not already on the list
-     *
-     * \internal
-     *
-     * This method is derived from quagga ospf_spf_next ().  See RFC2328 Section
-     * 16.1 (2) for further details.
-     *
-     * We're passed a parameter \a v that is a vertex which is already in the SPF
-     * tree.  A vertex represents a router node.  We also get a reference to the
-     * SPF candidate queue, which is a priority queue containing the shortest paths
-     * to the networks we know about.
-     *
-     * We examine the links in v's LSA and update the list of candidates with any
-     * vertices not already on the list.  If a lower-cost path is found to a
-     * vertex already on the candidate list, store the new (lower) cost.
-     *
-     * \param v the vertex
-     * \param candidate the SPF candidate queue
+     * \brief Build the flat copy of the link state database
+     * \param graph the graph
      */
-    void SPFNext(SPFVertex* v, CandidateQueue& candidate);
+    void BuildSpfGraph(SpfGraph& graph) const;
+
+    /// What to compute again for an SPF tree
+    enum SpfUpdate : uint8_t
+    {
+        SPF_NONE,   //!< nothing
+        SPF_ROUTES, //!< the routes, from the tree
+        SPF_TREE,   //!< the tree and the routes
+    };
 
     /**
-     * \brief Calculate nexthop from root through V (parent) to vertex W (destination)
-     *        with given distance from root->W.
-     *
-     * This method is derived from quagga ospf_nexthop_calculation() 16.1.1.
-     * For now, this is greatly simplified from the quagga code
-     *
-     * \param v the parent
-     * \param w the destination
-     * \param l the link record
-     * \param distance the target distance
-     * \returns 1 on success
+     * \brief Find the routers whose routes are computed, in the order of the node list
+     * \param graph the graph
+     * \param trees the SPF trees of the routers, with only their root set
      */
-    int SPFNexthopCalculation(SPFVertex* v,
-                              SPFVertex* w,
-                              GlobalRoutingLinkRecord* l,
-                              uint32_t distance);
+    void FindRoots(const SpfGraph& graph, std::vector<SpfTree>& trees) const;
 
     /**
-     * \brief Adds a vertex to the list of children *in* each of its parents
-     *
-     * Derived from quagga ospf_vertex_add_parents ()
+     * \brief Compute the given SPF trees and their routes, in parallel, then
+     * install the routes that changed, in the order of the trees
      *
-     * This is a somewhat oddly named method (blame quagga).  Although you might
-     * expect it to add a parent *to* something, it actually adds a vertex
-     * to the list of children *in* each of its parents.
-     *
-     * Given a pointer to a vertex, it links back to the vertex's parent that it
-     * already has set and adds itself to that vertex's list of children.
-     *
-     * \param v the vertex
+     * \param graph the graph
+     * \param trees the trees
+     * \param updates what to compute again for each tree
+     * \param replace whether the routes replace those of the routing tables,
+     * or are added to them
      */
-    void SPFVertexAddParent(SPFVertex* v);
+    void ComputeRoutes(const SpfGraph& graph,
+                       std::vector<SpfTree>& trees,
+                       const std::vector<SpfUpdate>& updates,
+                       bool replace);
 
     /**
-     * \brief Search for a link between two vertices.
-     *
-     * This method is derived from quagga ospf_get_next_link ()
+     * \brief Find the SPF trees affected by the changes between the graph of
+     * the last route computation and the given one, which have the same
+     * vertices
      *
-     * First search the Global Router Link Records of vertex \a v for one
-     * representing a point-to point link to vertex \a w.
-     *
-     * What is done depends on prev_link.  Contrary to appearances, prev_link just
-     * acts as a flag here.  If prev_link is NULL, we return the first Global
-     * Router Link Record we find that describes a point-to-point link from \a v
-     * to \a w.  If prev_link is not NULL, we return a Global Router Link Record
-     * representing a possible *second* link from \a v to \a w.
-     *
-     * \param v first vertex
-     * \param w second vertex
-     * \param prev_link the previous link in the list
-     * \returns the link's record
+     * \param graph the new graph
+     * \param updates set to what to compute again for each tree
      */
-    GlobalRoutingLinkRecord* SPFGetNextLink(SPFVertex* v,
-                                            SPFVertex* w,
-                                            GlobalRoutingLinkRecord* prev_link);
+    void FindAffectedTrees(const SpfGraph& graph, std::vector<SpfUpdate>& updates) const;
 
     /**
-     * \brief Add a host route to the routing tables
-     *
-     *
-     * This method is derived from quagga ospf_intra_add_router ()
+     * \brief Run the SPF calculation of a router.
      *
-     * This is where we are actually going to add the host routes to the routing
-     * tables of the individual nodes.
-     *
-     * The vertex passed as a parameter has just been added to the SPF tree.
-     * This vertex must have a valid m_root_oid, corresponding to the outgoing
-     * interface on the root router of the tree that is the first hop on the path
-     * to the vertex.  The vertex must also have a next hop address, corresponding
-     * to the next hop on the path to the vertex.  The vertex has an m_lsa field
-     * that has some number of link records.  For each point to point link record,
-     * the m_linkData is the local IP address of the link.  This corresponds to
-     * a destination IP address, reachable from the root, to which we add a host
-     * route.
-     *
-     * \param v the vertex
+     * The vertices join the tree in the order of the candidate queue of the
+     * quagga ospf_spf_calculate: by distance, the networks before the routers,
+     * then in the order the vertices were reached at their distance.
      *
+     * \param graph the graph
+     * \param tree the tree, whose root is set
      */
-    void SPFIntraAddRouter(SPFVertex* v);
+    static void SPFCalculate(const SpfGraph& graph, SpfTree& tree);
 
     /**
-     * \brief Add a transit to the routing tables
+     * \brief Test if a router is a stub, from an OSPF sense, and compute its
+     * default route if so.
      *
-     * \param v the vertex
-     */
-    void SPFIntraAddTransit(SPFVertex* v);
-
-    /**
-     * \brief Add a stub to the routing tables
+     * If there is only one link of type 1 or 2, then a default route
+     * can safely be added to the next-hop router and SPF does not need
+     * to be run
      *
-     * \param l the global routing link record
-     * \param v the vertex
+     * \param graph the graph
+     * \param root the index of the root vertex
+     * \param routes the routes of the router
+     * \returns true if the router is a stub
      */
-    void SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v);
+    static bool CheckForStubNode(const SpfGraph& graph,
+                                 uint32_t root,
+                                 std::vector<SpfRoute>& routes);
 
     /**
-     * \brief Add an external route to the routing tables
+     * \brief Compute the routes of a router from its SPF tree: the routes to
+     * the routers and transit networks in the order they joined the tree, then
+     * the routes to the stub networks and the external routes.
      *
-     * \param extlsa the external LSA
-     * \param v the vertex
+     * \param graph the graph
+     * \param tree the tree
+     * \param routes the routes
      */
-    void SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v);
+    static void SPFRoutes(const SpfGraph& graph,
+                          const SpfTree& tree,
+                          std::vector<SpfRoute>& routes);
 
     /**
      * \brief Return the interface number corresponding to a given IP address and mask
      *
-     * This is a wrapper around GetInterfaceForPrefix(), but we first
-     * have to find the right node pointer to pass to that function.
-     * If no such interface is found, return -1 (note:  unit test framework
-     * for routing assumes -1 to be a legal return value)
+     * This is the GetInterfaceForPrefix() of the root node, on the addresses
+     * of the graph.  If no such interface is found, return -1 (note:  unit test
+     * framework for routing assumes -1 to be a legal return value)
      *
+     * \param graph the graph
+     * \param root the index of the root vertex
      * \param a the target IP address
      * \param amask the target subnet mask
      * \return the outgoing interface number
      */
-    int32_t FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask = Ipv4Mask("255.255.255.255"));
+    static int32_t FindOutgoingInterfaceId(const SpfGraph& graph,
+                                           uint32_t root,
+                                           uint32_t a,
+                                           uint32_t amask = 0xffffffff);
+
+    /**
+     * \brief Install routes in the routing table of a node
+     * \param node the node ID
+     * \param routes the routes
+     * \param replace whether the routes replace those of the routing table
+     */
+    static void InstallRoutes(uint32_t node, const std::vector<SpfRoute>& routes, bool replace);
 };
 
 } // namespace ns3
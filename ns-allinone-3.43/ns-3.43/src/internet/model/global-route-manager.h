@@ -59,6 +59,15 @@ class GlobalRouteManager
      * per-node forwarding tables
      */
     static void InitializeRoutes();
+
+    /**
+     * @brief Recompute the routes after a change of the link state, only
+     * running the SPF computation of the routers whose shortest path tree can
+     * have changed, and only rewriting the forwarding tables whose routes
+     * changed.  The routes are the same as those computed by
+     * DeleteGlobalRoutes, BuildGlobalRoutingDatabase and InitializeRoutes.
+     */
+    static void RecomputeRoutes();
 };
 
 } // namespace ns3
@@ -0,0 +1,78 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "gso-tag.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(GsoTag);
+
+GsoTag::GsoTag()
+    : m_segmentSize(0),
+      m_nSegments(0)
+{
+}
+
+GsoTag::GsoTag(uint32_t segmentSize, uint32_t nSegments)
+    : m_segmentSize(segmentSize),
+      m_nSegments(nSegments)
+{
+}
+
+uint32_t
+GsoTag::GetSegmentSize() const
+{
+    return m_segmentSize;
+}
+
+uint32_t
+GsoTag::GetNSegments() const
+{
+    return m_nSegments;
+}
+
+TypeId
+GsoTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::GsoTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<GsoTag>();
+    return tid;
+}
+
+TypeId
+GsoTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+GsoTag::GetSerializedSize() const
+{
+    return 8;
+}
+
+void
+GsoTag::Serialize(TagBuffer i) const
+{
+    i.WriteU32(m_segmentSize);
+    i.WriteU32(m_nSegments);
+}
+
+void
+GsoTag::Deserialize(TagBuffer i)
+{
+    m_segmentSize = i.ReadU32();
+    m_nSegments = i.ReadU32();
+}
+
+void
+GsoTag::Print(std::ostream& os) const
+{
+    os << "segment size=" << m_segmentSize << " segments=" << m_nSegments;
+}
+
+} // namespace ns3
@@ -0,0 +1,68 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef GSO_TAG_H
+#define GSO_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ *
+ * \brief Tag carried by a TCP super-segment built with segmentation offload
+ *
+ * A super-segment carries the data of several segments behind a single TCP
+ * header. It goes through IP and through the routing, ARP/NDISC and IP traces
+ * as a single packet, and it is split into the segments transmitted on the wire
+ * when it is handed to the traffic control layer of the outgoing device (see
+ * QueueDiscItem::Segment). The tag gives the size (TCP header included) and the
+ * number of these segments, in the way of the gso_size and gso_segs fields of
+ * the Linux skb_shared_info.
+ */
+class GsoTag : public Tag
+{
+  public:
+    GsoTag();
+
+    /**
+     * \brief Constructor
+     * \param segmentSize the size of the wire segments, TCP header included
+     * \param nSegments the number of wire segments
+     */
+    GsoTag(uint32_t segmentSize, uint32_t nSegments);
+
+    /**
+     * \brief Get the size of the wire segments, TCP header included
+     * \return the size of the wire segments
+     */
+    uint32_t GetSegmentSize() const;
+
+    /**
+     * \brief Get the number of wire segments
+     * \return the number of wire segments
+     */
+    uint32_t GetNSegments() const;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+  private:
+    uint32_t m_segmentSize; //!< size of the wire segments, TCP header included
+    uint32_t m_nSegments;   //!< number of wire segments
+};
+
+} // namespace ns3
+
+#endif /* GSO_TAG_H */
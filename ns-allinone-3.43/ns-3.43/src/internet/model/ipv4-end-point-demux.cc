@@ -13,6 +13,10 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 namespace ns3
 {
 
@@ -41,24 +45,21 @@ bool
 Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
 {
     NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        if ((*i)->GetLocalPort() == port)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_ports.find(port) != m_ports.end();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto it = m_ports.find(port);
+    if (it == m_ports.end())
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
-            (*i)->GetBoundNetDevice() == boundNetDevice)
+        return false;
+    }
+    for (Ipv4EndPoint* endP : it->second)
+    {
+        if (endP->GetLocalAddress() == addr && endP->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
         }
@@ -77,7 +78,7 @@ Ipv4EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(Ipv4Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -93,7 +94,7 @@ Ipv4EndPointDemux::Allocate(Ipv4Address address)
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -116,7 +117,7 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv4Address address,
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -129,19 +130,21 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    if (const Bucket* bucket = FindBucket(GetKey(localPort, peerAddress, peerPort)))
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (Ipv4EndPoint* endP : *bucket)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if (endP->GetLocalAddress() == localAddress &&
+                (endP->GetBoundNetDevice() == boundNetDevice || !endP->GetBoundNetDevice()))
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     auto endPoint = new Ipv4EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -156,6 +159,8 @@ Ipv4EndPointDemux::DeAllocate(Ipv4EndPoint* endPoint)
     {
         if (*i == endPoint)
         {
+            RemoveFromIndex(endPoint);
+            RemoveFromPort(endPoint, endPoint->GetLocalPort());
             delete endPoint;
             m_endPoints.erase(i);
             break;
@@ -200,10 +205,30 @@ Ipv4EndPointDemux::Lookup(Ipv4Address daddr,
     EndPoints retval4; // Exact match on all 4
 
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+
+    // Only the endpoints on the destination port whose peer address and peer
+    // port are each either the source or a wildcard can match, i.e., the
+    // endpoints in the buckets of the four combinations (the keys coincide when
+    // the source address or the source port is itself a wildcard)
+    std::vector<Ipv4EndPoint*> candidates;
+    const std::array<uint64_t, 4> keys{GetKey(dport, saddr, sport),
+                                       GetKey(dport, saddr, 0),
+                                       GetKey(dport, Ipv4Address::GetAny(), sport),
+                                       GetKey(dport, Ipv4Address::GetAny(), 0)};
+    for (auto key = keys.begin(); key != keys.end(); key++)
     {
-        Ipv4EndPoint* endP = *i;
+        if (std::find(keys.begin(), key, *key) != key)
+        {
+            continue; // bucket already examined
+        }
+        if (const Bucket* bucket = FindBucket(*key))
+        {
+            candidates.insert(candidates.end(), bucket->begin(), bucket->end());
+        }
+    }
 
+    for (Ipv4EndPoint* endP : candidates)
+    {
         NS_LOG_DEBUG("Looking at endpoint dport="
                      << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
                      << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
@@ -361,16 +386,30 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport);
 
+    if (const Bucket* bucket = FindBucket(GetKey(dport, saddr, sport)))
+    {
+        for (Ipv4EndPoint* endP : *bucket)
+        {
+            if (endP->GetLocalAddress() == daddr)
+            {
+                /* this is an exact match. */
+                return endP;
+            }
+        }
+    }
+
+    auto port = m_ports.find(dport);
+    if (port == m_ports.end())
+    {
+        return nullptr;
+    }
+
     // this code is a copy/paste version of an old BSD ip stack lookup
     // function.
     uint32_t genericity = 3;
     Ipv4EndPoint* generic = nullptr;
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    for (auto i = port->second.begin(); i != port->second.end(); i++)
     {
-        if ((*i)->GetLocalPort() != dport)
-        {
-            continue;
-        }
         if ((*i)->GetLocalAddress() == daddr && (*i)->GetPeerPort() == sport &&
             (*i)->GetPeerAddress() == saddr)
         {
@@ -418,4 +457,79 @@ Ipv4EndPointDemux::AllocateEphemeralPort()
     return port;
 }
 
+uint64_t
+Ipv4EndPointDemux::GetKey(uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort)
+{
+    return (static_cast<uint64_t>(peerAddress.Get()) << 32) |
+           (static_cast<uint64_t>(localPort) << 16) | peerPort;
+}
+
+const Ipv4EndPointDemux::Bucket*
+Ipv4EndPointDemux::FindBucket(uint64_t key) const
+{
+    auto it = m_index.find(key);
+    return it != m_index.end() ? &it->second : nullptr;
+}
+
+void
+Ipv4EndPointDemux::Insert(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_endPoints.push_back(endPoint);
+    m_ports[endPoint->GetLocalPort()].push_back(endPoint);
+    AddToIndex(endPoint,
+               endPoint->GetLocalPort(),
+               endPoint->GetPeerAddress(),
+               endPoint->GetPeerPort());
+    endPoint->SetUpdateCallback(MakeCallback(&Ipv4EndPointDemux::Update, this));
+}
+
+void
+Ipv4EndPointDemux::AddToIndex(Ipv4EndPoint* endPoint,
+                              uint16_t localPort,
+                              Ipv4Address peerAddress,
+                              uint16_t peerPort)
+{
+    NS_LOG_FUNCTION(this << endPoint << localPort << peerAddress << peerPort);
+    m_index[GetKey(localPort, peerAddress, peerPort)].push_back(endPoint);
+}
+
+void
+Ipv4EndPointDemux::RemoveFromIndex(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto it = m_index.find(
+        GetKey(endPoint->GetLocalPort(), endPoint->GetPeerAddress(), endPoint->GetPeerPort()));
+    Bucket& bucket = it->second;
+    bucket.erase(std::find(bucket.begin(), bucket.end(), endPoint));
+    if (bucket.empty())
+    {
+        m_index.erase(it);
+    }
+}
+
+void
+Ipv4EndPointDemux::RemoveFromPort(Ipv4EndPoint* endPoint, uint16_t localPort)
+{
+    NS_LOG_FUNCTION(this << endPoint << localPort);
+    auto it = m_ports.find(localPort);
+    Bucket& bucket = it->second;
+    bucket.erase(std::find(bucket.begin(), bucket.end(), endPoint));
+    if (bucket.empty())
+    {
+        m_ports.erase(it);
+    }
+}
+
+void
+Ipv4EndPointDemux::Update(Ipv4EndPoint* endPoint,
+                          uint16_t localPort,
+                          Ipv4Address peerAddress,
+                          uint16_t peerPort)
+{
+    NS_LOG_FUNCTION(this << endPoint << localPort << peerAddress << peerPort);
+    RemoveFromIndex(endPoint);
+    AddToIndex(endPoint, localPort, peerAddress, peerPort);
+}
+
 } // namespace ns3
@@ -15,6 +15,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -31,6 +33,12 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are also indexed in a hash table by local port, peer address
+ * and peer port, so that a lookup only examines the endpoints connected to
+ * the source of the packet and the endpoints open to any peer on the
+ * destination port, instead of all the endpoints.  The endpoints notify the
+ * demux when their peer changes, to keep the index up to date.
  */
 
 class Ipv4EndPointDemux
@@ -166,6 +174,70 @@ class Ipv4EndPointDemux
      */
     uint16_t AllocateEphemeralPort();
 
+    /**
+     * \brief Compute the key of the index of the endpoints.
+     * \param localPort local port
+     * \param peerAddress peer address
+     * \param peerPort peer port
+     * \returns the key
+     */
+    static uint64_t GetKey(uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort);
+
+    /**
+     * \brief End points sharing a key of the index, in order of insertion.
+     */
+    typedef std::vector<Ipv4EndPoint*> Bucket;
+
+    /**
+     * \brief Find the end points with the given key in the index.
+     * \param key the key
+     * \returns the end points, or nullptr if there is none
+     */
+    const Bucket* FindBucket(uint64_t key) const;
+
+    /**
+     * \brief Add a new end point to the list and to the index.
+     * \param endPoint the end point
+     */
+    void Insert(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Add an end point to the index.
+     * \param endPoint the end point
+     * \param localPort local port
+     * \param peerAddress peer address
+     * \param peerPort peer port
+     */
+    void AddToIndex(Ipv4EndPoint* endPoint,
+                    uint16_t localPort,
+                    Ipv4Address peerAddress,
+                    uint16_t peerPort);
+
+    /**
+     * \brief Remove an end point from the index.
+     * \param endPoint the end point
+     */
+    void RemoveFromIndex(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the end points bound to a local port.
+     * \param endPoint the end point
+     * \param localPort the local port of the end point
+     */
+    void RemoveFromPort(Ipv4EndPoint* endPoint, uint16_t localPort);
+
+    /**
+     * \brief Move an end point in the index, before its peer changes.
+     * \param endPoint the end point
+     * \param localPort local port
+     * \param peerAddress new peer address
+     * \param peerPort new peer port
+     */
+    void Update(Ipv4EndPoint* endPoint,
+                uint16_t localPort,
+                Ipv4Address peerAddress,
+                uint16_t peerPort);
+
     /**
      * \brief The ephemeral port.
      */
@@ -185,6 +257,16 @@ class Ipv4EndPointDemux
      * \brief A list of IPv4 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief The IPv4 end points, indexed by local port, peer address and peer port.
+     */
+    std::unordered_map<uint64_t, Bucket> m_index;
+
+    /**
+     * \brief The IPv4 end points bound to each local port, in order of insertion.
+     */
+    std::unordered_map<uint16_t, Bucket> m_ports;
 };
 
 } // namespace ns3
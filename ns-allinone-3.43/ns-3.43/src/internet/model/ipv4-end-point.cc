@@ -78,6 +78,10 @@ void
 Ipv4EndPoint::SetPeer(Ipv4Address address, uint16_t port)
 {
     NS_LOG_FUNCTION(this << address << port);
+    if (!m_updateCallback.IsNull())
+    {
+        m_updateCallback(this, m_localPort, address, port);
+    }
     m_peerAddr = address;
     m_peerPort = port;
 }
@@ -119,6 +123,14 @@ Ipv4EndPoint::SetDestroyCallback(Callback<void> callback)
     m_destroyCallback = callback;
 }
 
+void
+Ipv4EndPoint::SetUpdateCallback(
+    Callback<void, Ipv4EndPoint*, uint16_t, Ipv4Address, uint16_t> callback)
+{
+    NS_LOG_FUNCTION(this << &callback);
+    m_updateCallback = callback;
+}
+
 void
 Ipv4EndPoint::ForwardUp(Ptr<Packet> p,
                         const Ipv4Header& header,
@@ -85,6 +85,17 @@ class Ipv4EndPoint
      */
     void SetPeer(Ipv4Address address, uint16_t port);
 
+    /**
+     * \brief Set the callback invoked before the peer of the endpoint changes.
+     *
+     * It is used by Ipv4EndPointDemux, which indexes the endpoints by local
+     * port and peer. The callback is invoked with the endpoint, its local port,
+     * and the new peer address and port.
+     *
+     * \param callback callback function
+     */
+    void SetUpdateCallback(Callback<void, Ipv4EndPoint*, uint16_t, Ipv4Address, uint16_t> callback);
+
     /**
      * \brief Bind a socket to specific device.
      *
@@ -220,6 +231,11 @@ class Ipv4EndPoint
      */
     Callback<void> m_destroyCallback;
 
+    /**
+     * \brief The callback invoked before the peer changes.
+     */
+    Callback<void, Ipv4EndPoint*, uint16_t, Ipv4Address, uint16_t> m_updateCallback;
+
     /**
      * \brief true if the endpoint can receive packets.
      */
@@ -10,6 +10,7 @@
 #include "ipv4-header.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
+#include "prefix-trie.h"
 
 #include "ns3/ipv4-address.h"
 #include "ns3/ptr.h"
@@ -52,7 +53,9 @@ class Node;
  * and rebuilt in the middle of the simulation, while manually entered
  * routes into the Ipv4StaticRouting may need to be kept distinct.
  *
- * This class deals with Ipv4 unicast routes only.
+ * This class deals with Ipv4 unicast routes only.  The routes are looked up
+ * in a PrefixTrie of each routing table, so that the cost of a lookup does not
+ * grow with the number of routes.
  *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
@@ -254,6 +257,16 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
     typedef std::list<Ipv4RoutingTableEntry*>::iterator ASExternalRoutesI;
 
+    /// trie of Ipv4RoutingTableEntry, with their position in their routing table
+    typedef PrefixTrie<std::pair<uint32_t, Ipv4RoutingTableEntry*>, 32> RoutesTrie;
+
+    /**
+     * \brief Build the trie of a routing table, unless it is already built.
+     * \param trie the trie
+     * \param routes the routing table
+     */
+    void BuildRoutesTrie(RoutesTrie& trie, const std::list<Ipv4RoutingTableEntry*>& routes);
+
     /**
      * \brief Lookup in the forwarding table for destination.
      * \param dest destination address
@@ -266,6 +279,12 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+    // The tries are cleared whenever their routing table changes, and rebuilt
+    // by the next lookup
+    RoutesTrie m_hostRoutesTrie;       //!< Routes to hosts, indexed by destination
+    RoutesTrie m_networkRoutesTrie;    //!< Routes to networks, indexed by destination prefix
+    RoutesTrie m_ASexternalRoutesTrie; //!< External routes, indexed by destination prefix
+
     Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -10,6 +10,7 @@
 
 #include "arp-cache.h"
 #include "arp-l3-protocol.h"
+#include "gso-tag.h"
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-header.h"
 #include "ipv4-interface.h"
@@ -76,6 +77,15 @@ Ipv4L3Protocol::GetTypeId()
                           TimeValue(Seconds(1)),
                           MakeTimeAccessor(&Ipv4L3Protocol::m_purge),
                           MakeTimeChecker(Seconds(0)))
+            .AddAttribute("EnableRouteCache",
+                          "Cache the route of the forwarded packets by input interface "
+                          "and destination, so that the next packets are forwarded without "
+                          "querying the routing protocol. Only valid with a routing protocol "
+                          "choosing the route from the destination alone, e.g., static or "
+                          "global routing without RandomEcmpRouting.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&Ipv4L3Protocol::m_enableRouteCache),
+                          MakeBooleanChecker())
             .AddTraceSource("Tx",
                             "Send ipv4 packet to outgoing interface.",
                             MakeTraceSourceAccessor(&Ipv4L3Protocol::m_txTrace),
@@ -114,6 +124,11 @@ Ipv4L3Protocol::GetTypeId()
                             "and it is being forward up the stack",
                             MakeTraceSourceAccessor(&Ipv4L3Protocol::m_localDeliverTrace),
                             "ns3::Ipv4L3Protocol::SentTracedCallback")
+            .AddTraceSource("RouteCacheHit",
+                            "A unicast IPv4 packet received by this node is being "
+                            "forwarded through the route cache",
+                            MakeTraceSourceAccessor(&Ipv4L3Protocol::m_routeCacheHitTrace),
+                            "ns3::Ipv4L3Protocol::SentTracedCallback")
 
         ;
     return tid;
@@ -284,8 +299,18 @@ void
 Ipv4L3Protocol::SetRoutingProtocol(Ptr<Ipv4RoutingProtocol> routingProtocol)
 {
     NS_LOG_FUNCTION(this << routingProtocol);
+    if (m_routingProtocol)
+    {
+        m_routingProtocol->TraceDisconnectWithoutContext(
+            "RouteChange",
+            MakeCallback(&Ipv4L3Protocol::FlushRouteCache, this));
+    }
     m_routingProtocol = routingProtocol;
+    m_routingProtocol->TraceConnectWithoutContext(
+        "RouteChange",
+        MakeCallback(&Ipv4L3Protocol::FlushRouteCache, this));
     m_routingProtocol->SetIpv4(this);
+    FlushRouteCache();
 }
 
 Ptr<Ipv4RoutingProtocol>
@@ -313,7 +338,14 @@ Ipv4L3Protocol::DoDispose()
 
     m_sockets.clear();
     m_node = nullptr;
+    if (m_routingProtocol)
+    {
+        m_routingProtocol->TraceDisconnectWithoutContext(
+            "RouteChange",
+            MakeCallback(&Ipv4L3Protocol::FlushRouteCache, this));
+    }
     m_routingProtocol = nullptr;
+    m_routeCache.clear();
 
     for (auto it = m_fragments.begin(); it != m_fragments.end(); it++)
     {
@@ -380,6 +412,13 @@ Ipv4L3Protocol::SetDefaultTtl(uint8_t ttl)
     m_defaultTtl = ttl;
 }
 
+void
+Ipv4L3Protocol::FlushRouteCache()
+{
+    NS_LOG_FUNCTION(this);
+    m_routeCache.clear();
+}
+
 uint32_t
 Ipv4L3Protocol::AddInterface(Ptr<NetDevice> device)
 {
@@ -648,7 +687,20 @@ Ipv4L3Protocol::Receive(Ptr<NetDevice> device,
     }
 
     NS_ASSERT_MSG(m_routingProtocol, "Need a routing protocol object to process packets");
-    if (!m_routingProtocol->RouteInput(packet, ipHeader, device, m_ucb, m_mcb, m_lcb, m_ecb))
+    Ipv4RoutingProtocol::UnicastForwardCallback ucb = m_ucb;
+    if (m_enableRouteCache)
+    {
+        uint64_t key = (static_cast<uint64_t>(interface) << 32) | ipHeader.GetDestination().Get();
+        auto it = m_routeCache.find(key);
+        if (it != m_routeCache.end())
+        {
+            m_routeCacheHitTrace(ipHeader, packet, interface);
+            IpForward(it->second, packet, ipHeader);
+            return;
+        }
+        ucb = MakeCallback(&Ipv4L3Protocol::IpForwardAndCache, this, key);
+    }
+    if (!m_routingProtocol->RouteInput(packet, ipHeader, device, ucb, m_mcb, m_lcb, m_ecb))
     {
         NS_LOG_WARN("No route found for forwarding packet.  Drop.");
         m_dropTrace(ipHeader, packet, DROP_NO_ROUTE, this, interface);
@@ -980,10 +1032,30 @@ Ipv4L3Protocol::SendRealOut(Ptr<Ipv4Route> route, Ptr<Packet> packet, const Ipv4
     if (outInterface->IsUp())
     {
         NS_LOG_LOGIC("Send to " << targetLabel << " " << target);
-        if (packet->GetSize() + ipHeader.GetSerializedSize() > outInterface->GetDevice()->GetMtu())
+        uint16_t mtu = outInterface->GetDevice()->GetMtu();
+        GsoTag gsoTag;
+        if (packet->PeekPacketTag(gsoTag))
+        {
+            if (gsoTag.GetSegmentSize() + ipHeader.GetSerializedSize() <= mtu)
+            {
+                // The super-segment is split into wire segments by the traffic
+                // control layer, which gives them consecutive identifications:
+                // the identifications following the one of the header are reserved
+                uint64_t srcDst = ipHeader.GetDestination().Get() |
+                                  (uint64_t(ipHeader.GetSource().Get()) << 32);
+                m_identification[std::make_pair(srcDst, ipHeader.GetProtocol())] +=
+                    gsoTag.GetNSegments() - 1;
+                CallTxTrace(ipHeader, packet, this, interface);
+                outInterface->Send(packet, ipHeader, target);
+                return;
+            }
+            // The segments do not fit the MTU: the super-segment is fragmented
+            packet->RemovePacketTag(gsoTag);
+        }
+        if (packet->GetSize() + ipHeader.GetSerializedSize() > mtu)
         {
             std::list<Ipv4PayloadHeaderPair> listFragments;
-            DoFragmentation(packet, ipHeader, outInterface->GetDevice()->GetMtu(), listFragments);
+            DoFragmentation(packet, ipHeader, mtu, listFragments);
             for (auto it = listFragments.begin(); it != listFragments.end(); it++)
             {
                 NS_LOG_LOGIC("Sending fragment " << *(it->first));
@@ -1074,6 +1146,17 @@ Ipv4L3Protocol::IpForward(Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ipv
     SendRealOut(rtentry, packet, ipHeader);
 }
 
+void
+Ipv4L3Protocol::IpForwardAndCache(uint64_t key,
+                                  Ptr<Ipv4Route> rtentry,
+                                  Ptr<const Packet> p,
+                                  const Ipv4Header& header)
+{
+    NS_LOG_FUNCTION(this << key << rtentry << p << header);
+    m_routeCache[key] = rtentry;
+    IpForward(rtentry, p, header);
+}
+
 void
 Ipv4L3Protocol::LocalDeliver(Ptr<const Packet> packet, const Ipv4Header& ip, uint32_t iif)
 {
@@ -1143,6 +1226,7 @@ Ipv4L3Protocol::AddAddress(uint32_t i, Ipv4InterfaceAddress address)
     NS_LOG_FUNCTION(this << i << address);
     Ptr<Ipv4Interface> interface = GetInterface(i);
     bool retVal = interface->AddAddress(address);
+    FlushRouteCache();
     if (m_routingProtocol)
     {
         m_routingProtocol->NotifyAddAddress(i, address);
@@ -1172,6 +1256,7 @@ Ipv4L3Protocol::RemoveAddress(uint32_t i, uint32_t addressIndex)
     Ipv4InterfaceAddress address = interface->RemoveAddress(addressIndex);
     if (address != Ipv4InterfaceAddress())
     {
+        FlushRouteCache();
         if (m_routingProtocol)
         {
             m_routingProtocol->NotifyRemoveAddress(i, address);
@@ -1195,6 +1280,7 @@ Ipv4L3Protocol::RemoveAddress(uint32_t i, Ipv4Address address)
     Ipv4InterfaceAddress ifAddr = interface->RemoveAddress(address);
     if (ifAddr != Ipv4InterfaceAddress())
     {
+        FlushRouteCache();
         if (m_routingProtocol)
         {
             m_routingProtocol->NotifyRemoveAddress(i, ifAddr);
@@ -1335,6 +1421,7 @@ Ipv4L3Protocol::SetUp(uint32_t i)
     if (interface->GetDevice()->GetMtu() >= 68)
     {
         interface->SetUp();
+        FlushRouteCache();
 
         if (m_routingProtocol)
         {
@@ -1356,6 +1443,7 @@ Ipv4L3Protocol::SetDown(uint32_t ifaceIndex)
     NS_LOG_FUNCTION(this << ifaceIndex);
     Ptr<Ipv4Interface> interface = GetInterface(ifaceIndex);
     interface->SetDown();
+    FlushRouteCache();
 
     if (m_routingProtocol)
     {
@@ -1377,6 +1465,7 @@ Ipv4L3Protocol::SetForwarding(uint32_t i, bool val)
     NS_LOG_FUNCTION(this << i);
     Ptr<Ipv4Interface> interface = GetInterface(i);
     interface->SetForwarding(val);
+    FlushRouteCache();
 }
 
 Ptr<NetDevice>
@@ -1394,6 +1483,7 @@ Ipv4L3Protocol::SetIpForward(bool forward)
     {
         (*i)->SetForwarding(forward);
     }
+    FlushRouteCache();
 }
 
 bool
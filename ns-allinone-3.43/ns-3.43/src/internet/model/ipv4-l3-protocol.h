@@ -24,6 +24,7 @@
 #include <list>
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 class Ipv4L3ProtocolTestCase;
@@ -134,6 +135,15 @@ class Ipv4L3Protocol : public Ipv4
      */
     void SetDefaultTtl(uint8_t ttl);
 
+    /**
+     * \brief Remove all the entries of the forwarding route cache.
+     *
+     * The cache is flushed automatically when the interfaces, their addresses
+     * or the routing protocol change, and whenever the routing protocol fires
+     * its RouteChange trace source (Ipv4RoutingProtocol::NotifyRouteChange).
+     */
+    void FlushRouteCache();
+
     /**
      * Lower layer calls this method after calling L3Demux::Lookup
      * The ARP subclass needs to know from which NetDevice this
@@ -341,6 +351,18 @@ class Ipv4L3Protocol : public Ipv4
      */
     void IpForward(Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ipv4Header& header);
 
+    /**
+     * \brief Forward a packet, and store its route in the forwarding route cache.
+     * \param key key of the route in the cache
+     * \param rtentry route
+     * \param p packet to forward
+     * \param header IPv4 header to add to the packet
+     */
+    void IpForwardAndCache(uint64_t key,
+                           Ptr<Ipv4Route> rtentry,
+                           Ptr<const Packet> p,
+                           const Ipv4Header& header);
+
     /**
      * \brief Forward a multicast packet.
      * \param mrtentry route
@@ -478,6 +500,8 @@ class Ipv4L3Protocol : public Ipv4
     TracedCallback<const Ipv4Header&, Ptr<const Packet>, uint32_t> m_multicastForwardTrace;
     /// Trace of locally delivered packets
     TracedCallback<const Ipv4Header&, Ptr<const Packet>, uint32_t> m_localDeliverTrace;
+    /// Trace of unicast packets forwarded through the route cache
+    TracedCallback<const Ipv4Header&, Ptr<const Packet>, uint32_t> m_routeCacheHitTrace;
 
     // The following two traces pass a packet with an IP header
     /// Trace of transmitted packets
@@ -639,6 +663,10 @@ class Ipv4L3Protocol : public Ipv4
     Ipv4RoutingProtocol::MulticastForwardCallback m_mcb; ///< Multicast forward callback
     Ipv4RoutingProtocol::LocalDeliverCallback m_lcb;     ///< Local delivery callback
     Ipv4RoutingProtocol::ErrorCallback m_ecb;            ///< Error callback
+
+    bool m_enableRouteCache; //!< Cache the routes of the forwarded packets
+    /// Routes of the forwarded packets, by input interface and destination
+    std::unordered_map<uint64_t, Ptr<Ipv4Route>> m_routeCache;
 };
 
 } // Namespace ns3
@@ -242,6 +242,9 @@ Ipv4ListRouting::AddRoutingProtocol(Ptr<Ipv4RoutingProtocol> routingProtocol, in
     NS_LOG_FUNCTION(this << routingProtocol->GetInstanceTypeId() << priority);
     m_routingProtocols.emplace_back(priority, routingProtocol);
     m_routingProtocols.sort(Compare);
+    routingProtocol->TraceConnectWithoutContext(
+        "RouteChange",
+        MakeCallback(&Ipv4ListRouting::NotifyRouteChange, this));
     if (m_ipv4)
     {
         routingProtocol->SetIpv4(m_ipv4);
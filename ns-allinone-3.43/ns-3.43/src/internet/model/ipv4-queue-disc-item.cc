@@ -6,11 +6,15 @@
 
 #include "ipv4-queue-disc-item.h"
 
+#include "gso-tag.h"
 #include "tcp-header.h"
+#include "tcp-l4-protocol.h"
 #include "udp-header.h"
 
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -83,6 +87,7 @@ Ipv4QueueDiscItem::Mark()
     if (!m_headerAdded && m_header.GetEcn() != Ipv4Header::ECN_NotECT)
     {
         m_header.SetEcn(Ipv4Header::ECN_CE);
+        ResetFlowDescriptor();
         return true;
     }
     return false;
@@ -109,28 +114,11 @@ Ipv4QueueDiscItem::Hash(uint32_t perturbation) const
 {
     NS_LOG_FUNCTION(this << perturbation);
 
-    Ipv4Address src = m_header.GetSource();
-    Ipv4Address dest = m_header.GetDestination();
-    uint8_t prot = m_header.GetProtocol();
-    uint16_t fragOffset = m_header.GetFragmentOffset();
-
-    TcpHeader tcpHdr;
-    UdpHeader udpHdr;
-    uint16_t srcPort = 0;
-    uint16_t destPort = 0;
+    const FlowDescriptor* fd = GetFlowDescriptor();
+    uint8_t prot = fd->l4Protocol;
+    uint16_t srcPort = fd->srcPort;
+    uint16_t destPort = fd->dstPort;
 
-    if (prot == 6 && fragOffset == 0) // TCP
-    {
-        GetPacket()->PeekHeader(tcpHdr);
-        srcPort = tcpHdr.GetSourcePort();
-        destPort = tcpHdr.GetDestinationPort();
-    }
-    else if (prot == 17 && fragOffset == 0) // UDP
-    {
-        GetPacket()->PeekHeader(udpHdr);
-        srcPort = udpHdr.GetSourcePort();
-        destPort = udpHdr.GetDestinationPort();
-    }
     if (prot != 6 && prot != 17)
     {
         NS_LOG_WARN("Unknown transport protocol, no port number included in hash computation");
@@ -138,8 +126,8 @@ Ipv4QueueDiscItem::Hash(uint32_t perturbation) const
 
     /* serialize the 5-tuple and the perturbation in buf */
     uint8_t buf[17];
-    src.Serialize(buf);
-    dest.Serialize(buf + 4);
+    std::copy_n(fd->srcAddress.begin(), 4, buf);
+    std::copy_n(fd->dstAddress.begin(), 4, buf + 4);
     buf[8] = prot;
     buf[9] = (srcPort >> 8) & 0xff;
     buf[10] = srcPort & 0xff;
@@ -159,4 +147,60 @@ Ipv4QueueDiscItem::Hash(uint32_t perturbation) const
     return hash;
 }
 
+std::vector<Ptr<QueueDiscItem>>
+Ipv4QueueDiscItem::Segment() const
+{
+    GsoTag gsoTag;
+    if (m_headerAdded || m_header.GetProtocol() != TcpL4Protocol::PROT_NUMBER ||
+        !GetPacket()->PeekPacketTag(gsoTag))
+    {
+        return {};
+    }
+    NS_LOG_FUNCTION(this);
+
+    std::vector<Ptr<QueueDiscItem>> items;
+    uint16_t identification = m_header.GetIdentification();
+    for (const auto& segment : TcpL4Protocol::SplitSuperSegment(GetPacket(),
+                                                                m_header.GetSource(),
+                                                                m_header.GetDestination()))
+    {
+        Ipv4Header header = m_header;
+        header.SetPayloadSize(segment->GetSize());
+        header.SetIdentification(identification++);
+        items.push_back(Create<Ipv4QueueDiscItem>(segment, GetAddress(), GetProtocol(), header));
+    }
+    return items;
+}
+
+bool
+Ipv4QueueDiscItem::ParseFlowDescriptor(FlowDescriptor& descriptor) const
+{
+    NS_LOG_FUNCTION(this);
+
+    m_header.GetSource().Serialize(descriptor.srcAddress.data());
+    m_header.GetDestination().Serialize(descriptor.dstAddress.data());
+    descriptor.l3Protocol = 0x0800; // IPv4
+    descriptor.l4Protocol = m_header.GetProtocol();
+    descriptor.dscp = m_header.GetDscp();
+    descriptor.ecn = m_header.GetEcn();
+
+    uint16_t fragOffset = m_header.GetFragmentOffset();
+
+    if (descriptor.l4Protocol == 6 && fragOffset == 0) // TCP
+    {
+        TcpHeader tcpHdr;
+        GetPacket()->PeekHeader(tcpHdr);
+        descriptor.srcPort = tcpHdr.GetSourcePort();
+        descriptor.dstPort = tcpHdr.GetDestinationPort();
+    }
+    else if (descriptor.l4Protocol == 17 && fragOffset == 0) // UDP
+    {
+        UdpHeader udpHdr;
+        GetPacket()->PeekHeader(udpHdr);
+        descriptor.srcPort = udpHdr.GetSourcePort();
+        descriptor.dstPort = udpHdr.GetDestinationPort();
+    }
+    return true;
+}
+
 } // namespace ns3
@@ -8,6 +8,7 @@
 
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/trace-source-accessor.h"
 
 namespace ns3
 {
@@ -20,8 +21,21 @@ TypeId
 Ipv4RoutingProtocol::GetTypeId()
 {
     static TypeId tid =
-        TypeId("ns3::Ipv4RoutingProtocol").SetParent<Object>().SetGroupName("Internet");
+        TypeId("ns3::Ipv4RoutingProtocol")
+            .SetParent<Object>()
+            .SetGroupName("Internet")
+            .AddTraceSource("RouteChange",
+                            "The routes chosen by the protocol may have changed",
+                            MakeTraceSourceAccessor(&Ipv4RoutingProtocol::m_routeChangeTrace),
+                            "ns3::Ipv4RoutingProtocol::RouteChangeTracedCallback");
     return tid;
 }
 
+void
+Ipv4RoutingProtocol::NotifyRouteChange()
+{
+    NS_LOG_FUNCTION(this);
+    m_routeChangeTrace();
+}
+
 } // namespace ns3
@@ -16,6 +16,7 @@
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/packet.h"
 #include "ns3/socket.h"
+#include "ns3/traced-callback.h"
 
 namespace ns3
 {
@@ -170,6 +171,25 @@ class Ipv4RoutingProtocol : public Object
      */
     virtual void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                                    Time::Unit unit = Time::S) const = 0;
+
+    /**
+     * TracedCallback signature for the changes of the routes.
+     */
+    typedef void (*RouteChangeTracedCallback)();
+
+  protected:
+    /**
+     * \brief Fire the RouteChange trace source.
+     *
+     * The protocols call this method whenever the route they choose for a
+     * destination may have changed, e.g., after a change of their forwarding
+     * table, so that the route cache of Ipv4L3Protocol is flushed.
+     */
+    void NotifyRouteChange();
+
+  private:
+    /// Trace of the changes of the routes
+    TracedCallback<> m_routeChangeTrace;
 };
 
 } // namespace ns3
@@ -69,6 +69,8 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
     {
         auto routePtr = new Ipv4RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesTrie.Clear();
+        NotifyRouteChange();
     }
 }
 
@@ -87,6 +89,8 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
         auto routePtr = new Ipv4RoutingTableEntry(route);
 
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesTrie.Clear();
+        NotifyRouteChange();
     }
 }
 
@@ -142,6 +146,8 @@ Ipv4StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv4Mask networkMask("240.0.0.0");
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
     m_networkRoutes.emplace_back(route, 0);
+    m_networkRoutesTrie.Clear();
+    NotifyRouteChange();
 }
 
 uint32_t
@@ -233,8 +239,6 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
 {
     NS_LOG_FUNCTION(this << dest << " " << oif);
     Ptr<Ipv4Route> rtentry = nullptr;
-    uint16_t longest_mask = 0;
-    uint32_t shortest_metric = 0xffffffff;
     /* when sending on local multicast, there have to be interface specified */
     if (dest.IsLocalMulticast())
     {
@@ -250,18 +254,29 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
         return rtentry;
     }
 
-    for (auto i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
+    if (m_networkRoutesTrie.IsEmpty())
     {
-        Ipv4RoutingTableEntry* j = i->first;
-        uint32_t metric = i->second;
-        Ipv4Mask mask = (j)->GetDestNetworkMask();
-        uint16_t masklen = mask.GetPrefixLength();
-        Ipv4Address entry = (j)->GetDestNetwork();
-        NS_LOG_LOGIC("Searching for route to " << dest << ", checking against route to " << entry
-                                               << "/" << masklen);
-        if (mask.IsMatch(dest, entry))
+        for (const auto& route : m_networkRoutes)
         {
-            NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
+            uint8_t network[4];
+            route.first->GetDestNetwork().Serialize(network);
+            m_networkRoutesTrie.Insert(network,
+                                       route.first->GetDestNetworkMask().GetPrefixLength(),
+                                       route);
+        }
+    }
+
+    // The routes are visited from the longest matching prefix to the shortest
+    // one, and the routes to the same prefix in routing table order
+    uint8_t address[4];
+    dest.Serialize(address);
+    m_networkRoutesTrie.Lookup(address, [&](const NetworkRoutesTrie::Values& routes) {
+        Ipv4RoutingTableEntry* route = nullptr;
+        uint32_t shortest_metric = 0xffffffff;
+        for (const auto& [j, metric] : routes)
+        {
+            NS_LOG_LOGIC("Found global network route " << j << ", mask length "
+                                                       << j->GetDestNetworkMask().GetPrefixLength()
                                                        << ", metric " << metric);
             if (oif)
             {
@@ -271,35 +286,30 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
                     continue;
                 }
             }
-            if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-                NS_LOG_LOGIC("Previous match longer, skipping");
-                continue;
-            }
-            if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-                shortest_metric = 0xffffffff;
-            }
-            longest_mask = masklen;
             if (metric > shortest_metric)
             {
                 NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
                 continue;
             }
             shortest_metric = metric;
-            Ipv4RoutingTableEntry* route = (j);
-            uint32_t interfaceIdx = route->GetInterface();
-            rtentry = Create<Ipv4Route>();
-            rtentry->SetDestination(route->GetDest());
-            rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
-            rtentry->SetGateway(route->GetGateway());
-            rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
-            if (masklen == 32)
+            route = j;
+            if (j->IsHost())
             {
                 break;
             }
         }
-    }
+        if (!route)
+        {
+            return false;
+        }
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv4Route>();
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
+        return true;
+    });
     if (rtentry)
     {
         NS_LOG_LOGIC("Matching route via " << rtentry->GetGateway() << " at the end");
@@ -448,6 +458,8 @@ Ipv4StaticRouting::RemoveRoute(uint32_t index)
         {
             delete j->first;
             m_networkRoutes.erase(j);
+            m_networkRoutesTrie.Clear();
+            NotifyRouteChange();
             return;
         }
         tmp++;
@@ -581,6 +593,7 @@ Ipv4StaticRouting::DoDispose()
     {
         delete (j->first);
     }
+    m_networkRoutesTrie.Clear();
     for (auto i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
     {
@@ -622,6 +635,8 @@ Ipv4StaticRouting::NotifyInterfaceDown(uint32_t i)
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_networkRoutesTrie.Clear();
+            NotifyRouteChange();
         }
         else
         {
@@ -667,6 +682,8 @@ Ipv4StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_networkRoutesTrie.Clear();
+            NotifyRouteChange();
         }
         else
         {
@@ -12,6 +12,10 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 namespace ns3
 {
 
@@ -40,24 +44,21 @@ bool
 Ipv6EndPointDemux::LookupPortLocal(uint16_t port)
 {
     NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        if ((*i)->GetLocalPort() == port)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_ports.find(port) != m_ports.end();
 }
 
 bool
 Ipv6EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto it = m_ports.find(port);
+    if (it == m_ports.end())
     {
-        if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
-            (*i)->GetBoundNetDevice() == boundNetDevice)
+        return false;
+    }
+    for (Ipv6EndPoint* endP : it->second)
+    {
+        if (endP->GetLocalAddress() == addr && endP->GetBoundNetDevice() == boundNetDevice)
         {
             return true;
         }
@@ -76,7 +77,7 @@ Ipv6EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(Ipv6Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -92,7 +93,7 @@ Ipv6EndPointDemux::Allocate(Ipv6Address address)
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -115,7 +116,7 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv6Address address,
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -128,19 +129,21 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    if (const Bucket* bucket = FindBucket(Key(localPort, peerAddress, peerPort)))
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (Ipv6EndPoint* endP : *bucket)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if (endP->GetLocalAddress() == localAddress &&
+                (endP->GetBoundNetDevice() == boundNetDevice || !endP->GetBoundNetDevice()))
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     auto endPoint = new Ipv6EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -155,6 +158,8 @@ Ipv6EndPointDemux::DeAllocate(Ipv6EndPoint* endPoint)
     {
         if (*i == endPoint)
         {
+            RemoveFromIndex(endPoint);
+            RemoveFromPort(endPoint, endPoint->GetLocalPort());
             delete endPoint;
             m_endPoints.erase(i);
             break;
@@ -182,10 +187,30 @@ Ipv6EndPointDemux::Lookup(Ipv6Address daddr,
     EndPoints retval4; /* Exact match on all 4 */
 
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+
+    // Only the endpoints on the destination port whose peer address and peer
+    // port are each either the source or a wildcard can match, i.e., the
+    // endpoints in the buckets of the four combinations (the keys coincide when
+    // the source address or the source port is itself a wildcard)
+    std::vector<Ipv6EndPoint*> candidates;
+    const std::array<Key, 4> keys{Key(dport, saddr, sport),
+                                  Key(dport, saddr, 0),
+                                  Key(dport, Ipv6Address::GetAny(), sport),
+                                  Key(dport, Ipv6Address::GetAny(), 0)};
+    for (auto key = keys.begin(); key != keys.end(); key++)
     {
-        Ipv6EndPoint* endP = *i;
+        if (std::find(keys.begin(), key, *key) != key)
+        {
+            continue; // bucket already examined
+        }
+        if (const Bucket* bucket = FindBucket(*key))
+        {
+            candidates.insert(candidates.end(), bucket->begin(), bucket->end());
+        }
+    }
 
+    for (Ipv6EndPoint* endP : candidates)
+    {
         NS_LOG_DEBUG("Looking at endpoint dport="
                      << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
                      << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
@@ -299,18 +324,31 @@ Ipv6EndPointDemux::Lookup(Ipv6Address daddr,
 Ipv6EndPoint*
 Ipv6EndPointDemux::SimpleLookup(Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+    if (const Bucket* bucket = FindBucket(Key(dport, src, sport)))
+    {
+        for (Ipv6EndPoint* endP : *bucket)
+        {
+            if (endP->GetLocalAddress() == dst)
+            {
+                /* this is an exact match. */
+                return endP;
+            }
+        }
+    }
+
+    auto port = m_ports.find(dport);
+    if (port == m_ports.end())
+    {
+        return nullptr;
+    }
+
     uint32_t genericity = 3;
     Ipv6EndPoint* generic = nullptr;
 
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    for (auto i = port->second.begin(); i != port->second.end(); i++)
     {
         uint32_t tmp = 0;
 
-        if ((*i)->GetLocalPort() != dport)
-        {
-            continue;
-        }
-
         if ((*i)->GetLocalAddress() == dst && (*i)->GetPeerPort() == sport &&
             (*i)->GetPeerAddress() == src)
         {
@@ -365,4 +403,84 @@ Ipv6EndPointDemux::GetEndPoints() const
     return m_endPoints;
 }
 
+size_t
+Ipv6EndPointDemux::KeyHash::operator()(const Key& key) const
+{
+    uint64_t ports = (static_cast<uint64_t>(std::get<0>(key)) << 16) | std::get<2>(key);
+    return Ipv6AddressHash()(std::get<1>(key)) ^ (ports * 0x9e3779b97f4a7c15ULL);
+}
+
+const Ipv6EndPointDemux::Bucket*
+Ipv6EndPointDemux::FindBucket(const Key& key) const
+{
+    auto it = m_index.find(key);
+    return it != m_index.end() ? &it->second : nullptr;
+}
+
+void
+Ipv6EndPointDemux::Insert(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_endPoints.push_back(endPoint);
+    m_ports[endPoint->GetLocalPort()].push_back(endPoint);
+    AddToIndex(endPoint,
+               endPoint->GetLocalPort(),
+               endPoint->GetPeerAddress(),
+               endPoint->GetPeerPort());
+    endPoint->SetUpdateCallback(MakeCallback(&Ipv6EndPointDemux::Update, this));
+}
+
+void
+Ipv6EndPointDemux::AddToIndex(Ipv6EndPoint* endPoint,
+                              uint16_t localPort,
+                              Ipv6Address peerAddress,
+                              uint16_t peerPort)
+{
+    NS_LOG_FUNCTION(this << endPoint << localPort << peerAddress << peerPort);
+    m_index[Key(localPort, peerAddress, peerPort)].push_back(endPoint);
+}
+
+void
+Ipv6EndPointDemux::RemoveFromIndex(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto it = m_index.find(
+        Key(endPoint->GetLocalPort(), endPoint->GetPeerAddress(), endPoint->GetPeerPort()));
+    Bucket& bucket = it->second;
+    bucket.erase(std::find(bucket.begin(), bucket.end(), endPoint));
+    if (bucket.empty())
+    {
+        m_index.erase(it);
+    }
+}
+
+void
+Ipv6EndPointDemux::RemoveFromPort(Ipv6EndPoint* endPoint, uint16_t localPort)
+{
+    NS_LOG_FUNCTION(this << endPoint << localPort);
+    auto it = m_ports.find(localPort);
+    Bucket& bucket = it->second;
+    bucket.erase(std::find(bucket.begin(), bucket.end(), endPoint));
+    if (bucket.empty())
+    {
+        m_ports.erase(it);
+    }
+}
+
+void
+Ipv6EndPointDemux::Update(Ipv6EndPoint* endPoint,
+                          uint16_t localPort,
+                          Ipv6Address peerAddress,
+                          uint16_t peerPort)
+{
+    NS_LOG_FUNCTION(this << endPoint << localPort << peerAddress << peerPort);
+    RemoveFromIndex(endPoint);
+    AddToIndex(endPoint, localPort, peerAddress, peerPort);
+    if (localPort != endPoint->GetLocalPort())
+    {
+        RemoveFromPort(endPoint, endPoint->GetLocalPort());
+        m_ports[localPort].push_back(endPoint);
+    }
+}
+
 } /* namespace ns3 */
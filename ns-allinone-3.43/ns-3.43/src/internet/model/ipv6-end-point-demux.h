@@ -15,6 +15,9 @@
 
 #include <list>
 #include <stdint.h>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -25,6 +28,12 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The endpoints are indexed in a hash table by local port, peer address and
+ * peer port, so that a lookup only examines the endpoints connected to the
+ * source of the packet and the endpoints open to any peer on the destination
+ * port, instead of all the endpoints.  The endpoints notify the demux when
+ * their local port or their peer change, to keep the index up to date.
  */
 class Ipv6EndPointDemux
 {
@@ -156,6 +165,80 @@ class Ipv6EndPointDemux
      */
     uint16_t AllocateEphemeralPort();
 
+    /**
+     * \brief Key of the index of the end points: local port, peer address and peer port.
+     */
+    typedef std::tuple<uint16_t, Ipv6Address, uint16_t> Key;
+
+    /**
+     * \brief Hash function of the keys of the index of the end points.
+     */
+    class KeyHash
+    {
+      public:
+        /**
+         * \brief Returns the hash of a key.
+         * \param key the key
+         * \returns the hash of the key
+         */
+        size_t operator()(const Key& key) const;
+    };
+
+    /**
+     * \brief End points sharing a key of the index, in order of insertion.
+     */
+    typedef std::vector<Ipv6EndPoint*> Bucket;
+
+    /**
+     * \brief Find the end points with the given key in the index.
+     * \param key the key
+     * \returns the end points, or nullptr if there is none
+     */
+    const Bucket* FindBucket(const Key& key) const;
+
+    /**
+     * \brief Add a new end point to the list and to the index.
+     * \param endPoint the end point
+     */
+    void Insert(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Add an end point to the index.
+     * \param endPoint the end point
+     * \param localPort local port
+     * \param peerAddress peer address
+     * \param peerPort peer port
+     */
+    void AddToIndex(Ipv6EndPoint* endPoint,
+                    uint16_t localPort,
+                    Ipv6Address peerAddress,
+                    uint16_t peerPort);
+
+    /**
+     * \brief Remove an end point from the index.
+     * \param endPoint the end point
+     */
+    void RemoveFromIndex(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the end points bound to a local port.
+     * \param endPoint the end point
+     * \param localPort the local port of the end point
+     */
+    void RemoveFromPort(Ipv6EndPoint* endPoint, uint16_t localPort);
+
+    /**
+     * \brief Move an end point in the index, before its local port or its peer change.
+     * \param endPoint the end point
+     * \param localPort new local port
+     * \param peerAddress new peer address
+     * \param peerPort new peer port
+     */
+    void Update(Ipv6EndPoint* endPoint,
+                uint16_t localPort,
+                Ipv6Address peerAddress,
+                uint16_t peerPort);
+
     /**
      * \brief The ephemeral port.
      */
@@ -175,6 +258,16 @@ class Ipv6EndPointDemux
      * \brief A list of IPv6 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief The IPv6 end points, indexed by local port, peer address and peer port.
+     */
+    std::unordered_map<Key, Bucket, KeyHash> m_index;
+
+    /**
+     * \brief The IPv6 end points bound to each local port, in order of insertion.
+     */
+    std::unordered_map<uint16_t, Bucket> m_ports;
 };
 
 } /* namespace ns3 */
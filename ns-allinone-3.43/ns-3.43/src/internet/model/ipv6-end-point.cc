@@ -58,6 +58,10 @@ Ipv6EndPoint::GetLocalPort() const
 void
 Ipv6EndPoint::SetLocalPort(uint16_t port)
 {
+    if (!m_updateCallback.IsNull())
+    {
+        m_updateCallback(this, port, m_peerAddr, m_peerPort);
+    }
     m_localPort = port;
 }
 
@@ -88,6 +92,10 @@ Ipv6EndPoint::GetBoundNetDevice() const
 void
 Ipv6EndPoint::SetPeer(Ipv6Address addr, uint16_t port)
 {
+    if (!m_updateCallback.IsNull())
+    {
+        m_updateCallback(this, m_localPort, addr, port);
+    }
     m_peerAddr = addr;
     m_peerPort = port;
 }
@@ -112,6 +120,13 @@ Ipv6EndPoint::SetDestroyCallback(Callback<void> callback)
     m_destroyCallback = callback;
 }
 
+void
+Ipv6EndPoint::SetUpdateCallback(
+    Callback<void, Ipv6EndPoint*, uint16_t, Ipv6Address, uint16_t> callback)
+{
+    m_updateCallback = callback;
+}
+
 void
 Ipv6EndPoint::ForwardUp(Ptr<Packet> p,
                         Ipv6Header header,
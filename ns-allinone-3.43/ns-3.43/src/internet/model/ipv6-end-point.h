@@ -91,6 +91,18 @@ class Ipv6EndPoint
      */
     void SetPeer(Ipv6Address addr, uint16_t port);
 
+    /**
+     * \brief Set the callback invoked before the local port or the peer of the
+     * endpoint change.
+     *
+     * It is used by Ipv6EndPointDemux, which indexes the endpoints by local
+     * port and peer. The callback is invoked with the endpoint, and its new
+     * local port, peer address and peer port.
+     *
+     * \param callback callback function
+     */
+    void SetUpdateCallback(Callback<void, Ipv6EndPoint*, uint16_t, Ipv6Address, uint16_t> callback);
+
     /**
      * \brief Bind a socket to specific device.
      *
@@ -224,6 +236,11 @@ class Ipv6EndPoint
      */
     Callback<void> m_destroyCallback;
 
+    /**
+     * \brief The callback invoked before the local port or the peer change.
+     */
+    Callback<void, Ipv6EndPoint*, uint16_t, Ipv6Address, uint16_t> m_updateCallback;
+
     /**
      * \brief true if the endpoint can receive packets.
      */
@@ -8,6 +8,7 @@
 
 #include "ipv6-l3-protocol.h"
 
+#include "gso-tag.h"
 #include "icmpv6-l4-protocol.h"
 #include "ipv6-autoconfigured-prefix.h"
 #include "ipv6-extension-demux.h"
@@ -21,6 +22,7 @@
 #include "ipv6-routing-protocol.h"
 #include "loopback-net-device.h"
 #include "ndisc-cache.h"
+#include "tcp-l4-protocol.h"
 
 #include "ns3/boolean.h"
 #include "ns3/callback.h"
@@ -1219,7 +1221,24 @@ Ipv6L3Protocol::SendRealOut(Ptr<Ipv6Route> route, Ptr<Packet> packet, const Ipv6
         targetMtu = dev->GetMtu();
     }
 
-    if (packet->GetSize() + ipHeader.GetSerializedSize() > targetMtu)
+    bool tooBig = packet->GetSize() + ipHeader.GetSerializedSize() > targetMtu;
+    GsoTag gsoTag;
+    if (tooBig && packet->PeekPacketTag(gsoTag))
+    {
+        if (ipHeader.GetNextHeader() == TcpL4Protocol::PROT_NUMBER &&
+            gsoTag.GetSegmentSize() + ipHeader.GetSerializedSize() <= targetMtu)
+        {
+            // The super-segment is split into wire segments by the traffic control layer
+            tooBig = false;
+        }
+        else
+        {
+            // The segments do not fit the MTU: the super-segment is fragmented
+            packet->RemovePacketTag(gsoTag);
+        }
+    }
+
+    if (tooBig)
     {
         // Router => drop
         if (!fromMe)
@@ -6,11 +6,15 @@
 
 #include "ipv6-queue-disc-item.h"
 
+#include "gso-tag.h"
 #include "tcp-header.h"
+#include "tcp-l4-protocol.h"
 #include "udp-header.h"
 
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -83,6 +87,7 @@ Ipv6QueueDiscItem::Mark()
     if (!m_headerAdded && m_header.GetEcn() != Ipv6Header::ECN_NotECT)
     {
         m_header.SetEcn(Ipv6Header::ECN_CE);
+        ResetFlowDescriptor();
         return true;
     }
     return false;
@@ -109,27 +114,11 @@ Ipv6QueueDiscItem::Hash(uint32_t perturbation) const
 {
     NS_LOG_FUNCTION(this << perturbation);
 
-    Ipv6Address src = m_header.GetSource();
-    Ipv6Address dest = m_header.GetDestination();
-    uint8_t prot = m_header.GetNextHeader();
-
-    TcpHeader tcpHdr;
-    UdpHeader udpHdr;
-    uint16_t srcPort = 0;
-    uint16_t destPort = 0;
+    const FlowDescriptor* fd = GetFlowDescriptor();
+    uint8_t prot = fd->l4Protocol;
+    uint16_t srcPort = fd->srcPort;
+    uint16_t destPort = fd->dstPort;
 
-    if (prot == 6) // TCP
-    {
-        GetPacket()->PeekHeader(tcpHdr);
-        srcPort = tcpHdr.GetSourcePort();
-        destPort = tcpHdr.GetDestinationPort();
-    }
-    else if (prot == 17) // UDP
-    {
-        GetPacket()->PeekHeader(udpHdr);
-        srcPort = udpHdr.GetSourcePort();
-        destPort = udpHdr.GetDestinationPort();
-    }
     if (prot != 6 && prot != 17)
     {
         NS_LOG_WARN("Unknown transport protocol, no port number included in hash computation");
@@ -137,8 +126,8 @@ Ipv6QueueDiscItem::Hash(uint32_t perturbation) const
 
     /* serialize the 5-tuple and the perturbation in buf */
     uint8_t buf[41];
-    src.Serialize(buf);
-    dest.Serialize(buf + 16);
+    std::copy_n(fd->srcAddress.begin(), 16, buf);
+    std::copy_n(fd->dstAddress.begin(), 16, buf + 16);
     buf[32] = prot;
     buf[33] = (srcPort >> 8) & 0xff;
     buf[34] = srcPort & 0xff;
@@ -158,4 +147,56 @@ Ipv6QueueDiscItem::Hash(uint32_t perturbation) const
     return hash;
 }
 
+std::vector<Ptr<QueueDiscItem>>
+Ipv6QueueDiscItem::Segment() const
+{
+    GsoTag gsoTag;
+    if (m_headerAdded || m_header.GetNextHeader() != TcpL4Protocol::PROT_NUMBER ||
+        !GetPacket()->PeekPacketTag(gsoTag))
+    {
+        return {};
+    }
+    NS_LOG_FUNCTION(this);
+
+    std::vector<Ptr<QueueDiscItem>> items;
+    for (const auto& segment : TcpL4Protocol::SplitSuperSegment(GetPacket(),
+                                                                m_header.GetSource(),
+                                                                m_header.GetDestination()))
+    {
+        Ipv6Header header = m_header;
+        header.SetPayloadLength(segment->GetSize());
+        items.push_back(Create<Ipv6QueueDiscItem>(segment, GetAddress(), GetProtocol(), header));
+    }
+    return items;
+}
+
+bool
+Ipv6QueueDiscItem::ParseFlowDescriptor(FlowDescriptor& descriptor) const
+{
+    NS_LOG_FUNCTION(this);
+
+    m_header.GetSource().Serialize(descriptor.srcAddress.data());
+    m_header.GetDestination().Serialize(descriptor.dstAddress.data());
+    descriptor.l3Protocol = 0x86DD; // IPv6
+    descriptor.l4Protocol = m_header.GetNextHeader();
+    descriptor.dscp = m_header.GetDscp();
+    descriptor.ecn = m_header.GetEcn();
+
+    if (descriptor.l4Protocol == 6) // TCP
+    {
+        TcpHeader tcpHdr;
+        GetPacket()->PeekHeader(tcpHdr);
+        descriptor.srcPort = tcpHdr.GetSourcePort();
+        descriptor.dstPort = tcpHdr.GetDestinationPort();
+    }
+    else if (descriptor.l4Protocol == 17) // UDP
+    {
+        UdpHeader udpHdr;
+        GetPacket()->PeekHeader(udpHdr);
+        descriptor.srcPort = udpHdr.GetSourcePort();
+        descriptor.dstPort = udpHdr.GetDestinationPort();
+    }
+    return true;
+}
+
 } // namespace ns3
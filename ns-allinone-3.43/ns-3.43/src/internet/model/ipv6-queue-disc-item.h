@@ -94,6 +94,29 @@ class Ipv6QueueDiscItem : public QueueDiscItem
      */
     uint32_t Hash(uint32_t perturbation) const override;
 
+    /**
+     * \brief Split a TCP super-segment into the wire segments
+     *
+     * If the packet carries a GsoTag and the next header of the header is TCP,
+     * the super-segment is split by TcpL4Protocol::SplitSuperSegment and each
+     * segment is given a copy of the IPv6 header.
+     *
+     * \return the items containing the wire segments, or an empty list if the
+     *         packet is not a super-segment
+     */
+    std::vector<Ptr<QueueDiscItem>> Segment() const override;
+
+  protected:
+    /**
+     * \brief Parse the addresses, protocol number, DSCP and ECN fields of the
+     * IPv6 header and, if the transport protocol is either UDP or TCP, the
+     * source and destination port
+     *
+     * \param [out] descriptor the fields of the packet
+     * \return true
+     */
+    bool ParseFlowDescriptor(FlowDescriptor& descriptor) const override;
+
   private:
     Ipv6Header m_header; //!< The IPv6 header.
     bool m_headerAdded;  //!< True if the header has already been added to the packet.
@@ -172,6 +172,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
     {
         auto routePtr = new Ipv6RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesTrie.Clear();
     }
 }
 
@@ -199,6 +200,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
     {
         auto routePtr = new Ipv6RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesTrie.Clear();
     }
 }
 
@@ -216,6 +218,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
     {
         auto routePtr = new Ipv6RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesTrie.Clear();
     }
 }
 
@@ -258,6 +261,7 @@ Ipv6StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv6Prefix networkMask = Ipv6Prefix(8);
     *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
     m_networkRoutes.emplace_back(route, 0);
+    m_networkRoutesTrie.Clear();
 }
 
 uint32_t
@@ -373,8 +377,6 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address dst, Ptr<NetDevice> interface)
 {
     NS_LOG_FUNCTION(this << dst << interface);
     Ptr<Ipv6Route> rtentry = nullptr;
-    uint16_t longestMask = 0;
-    uint32_t shortestMetric = 0xffffffff;
 
     /* when sending on link-local multicast, there have to be interface specified */
     if (dst.IsLinkLocalMulticast())
@@ -391,71 +393,73 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address dst, Ptr<NetDevice> interface)
         return rtentry;
     }
 
-    for (auto it = m_networkRoutes.begin(); it != m_networkRoutes.end(); it++)
+    if (m_networkRoutesTrie.IsEmpty())
     {
-        Ipv6RoutingTableEntry* j = it->first;
-        uint32_t metric = it->second;
-        Ipv6Prefix mask = j->GetDestNetworkPrefix();
-        uint16_t maskLen = mask.GetPrefixLength();
-        Ipv6Address entry = j->GetDestNetwork();
-
-        NS_LOG_LOGIC("Searching for route to " << dst << ", mask length " << maskLen << ", metric "
-                                               << metric);
+        for (const auto& route : m_networkRoutes)
+        {
+            uint8_t network[16];
+            route.first->GetDestNetwork().GetBytes(network);
+            m_networkRoutesTrie.Insert(network,
+                                       route.first->GetDestNetworkPrefix().GetPrefixLength(),
+                                       route);
+        }
+    }
 
-        if (mask.IsMatch(dst, entry))
+    // The routes are visited from the longest matching prefix to the shortest
+    // one, and the routes to the same prefix in routing table order
+    uint8_t address[16];
+    dst.GetBytes(address);
+    m_networkRoutesTrie.Lookup(address, [&](const NetworkRoutesTrie::Values& routes) {
+        Ipv6RoutingTableEntry* route = nullptr;
+        uint32_t shortestMetric = 0xffffffff;
+        for (const auto& [j, metric] : routes)
         {
-            NS_LOG_LOGIC("Found global network route " << *j << ", mask length " << maskLen
-                                                       << ", metric " << metric);
+            NS_LOG_LOGIC("Found global network route "
+                         << *j << ", mask length " << j->GetDestNetworkPrefix().GetPrefixLength()
+                         << ", metric " << metric);
 
             /* if interface is given, check the route will output on this interface */
-            if (!interface || interface == m_ipv6->GetNetDevice(j->GetInterface()))
+            if (interface && interface != m_ipv6->GetNetDevice(j->GetInterface()))
             {
-                if (maskLen < longestMask)
-                {
-                    NS_LOG_LOGIC("Previous match longer, skipping");
-                    continue;
-                }
-
-                if (maskLen > longestMask)
-                {
-                    shortestMetric = 0xffffffff;
-                }
-
-                longestMask = maskLen;
-                if (metric > shortestMetric)
-                {
-                    NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
-                    continue;
-                }
-
-                shortestMetric = metric;
-                Ipv6RoutingTableEntry* route = j;
-                uint32_t interfaceIdx = route->GetInterface();
-                rtentry = Create<Ipv6Route>();
+                continue;
+            }
+            if (metric > shortestMetric)
+            {
+                NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
+                continue;
+            }
+            shortestMetric = metric;
+            route = j;
+            if (j->GetDestNetworkPrefix().GetPrefixLength() == 128)
+            {
+                break;
+            }
+        }
+        if (!route)
+        {
+            return false;
+        }
 
-                if (route->GetGateway().IsAny() || !route->GetDest().IsAny())
-                {
-                    rtentry->SetSource(
-                        m_ipv6->SourceAddressSelection(interfaceIdx, route->GetDest()));
-                }
-                else
-                {
-                    // Default route
-                    rtentry->SetSource(m_ipv6->SourceAddressSelection(
-                        interfaceIdx,
-                        route->GetPrefixToUse().IsAny() ? dst : route->GetPrefixToUse()));
-                }
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv6Route>();
 
-                rtentry->SetDestination(route->GetDest());
-                rtentry->SetGateway(route->GetGateway());
-                rtentry->SetOutputDevice(m_ipv6->GetNetDevice(interfaceIdx));
-                if (maskLen == 128)
-                {
-                    break;
-                }
-            }
+        if (route->GetGateway().IsAny() || !route->GetDest().IsAny())
+        {
+            rtentry->SetSource(m_ipv6->SourceAddressSelection(interfaceIdx, route->GetDest()));
         }
-    }
+        else
+        {
+            // Default route
+            rtentry->SetSource(m_ipv6->SourceAddressSelection(
+                interfaceIdx,
+                route->GetPrefixToUse().IsAny() ? dst : route->GetPrefixToUse()));
+        }
+
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv6->GetNetDevice(interfaceIdx));
+        return true;
+    });
 
     if (rtentry)
     {
@@ -475,6 +479,7 @@ Ipv6StaticRouting::DoDispose()
         delete j->first;
     }
     m_networkRoutes.clear();
+    m_networkRoutesTrie.Clear();
 
     for (auto i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
@@ -634,6 +639,7 @@ Ipv6StaticRouting::RemoveRoute(uint32_t index)
         {
             delete it->first;
             m_networkRoutes.erase(it);
+            m_networkRoutesTrie.Clear();
             return;
         }
         tmp++;
@@ -657,6 +663,7 @@ Ipv6StaticRouting::RemoveRoute(Ipv6Address network,
         {
             delete it->first;
             m_networkRoutes.erase(it);
+            m_networkRoutesTrie.Clear();
             return;
         }
     }
@@ -799,6 +806,7 @@ Ipv6StaticRouting::NotifyInterfaceDown(uint32_t i)
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_networkRoutesTrie.Clear();
         }
         else
         {
@@ -837,6 +845,7 @@ Ipv6StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv6InterfaceAddress
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_networkRoutesTrie.Clear();
         }
         else
         {
@@ -895,6 +904,7 @@ Ipv6StaticRouting::NotifyRemoveRoute(Ipv6Address dst,
             {
                 delete j->first;
                 j = m_networkRoutes.erase(j);
+                m_networkRoutesTrie.Clear();
             }
             else
             {
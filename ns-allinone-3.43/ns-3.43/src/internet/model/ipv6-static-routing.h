@@ -12,6 +12,7 @@
 #include "ipv6-header.h"
 #include "ipv6-routing-protocol.h"
 #include "ipv6.h"
+#include "prefix-trie.h"
 
 #include "ns3/ipv6-address.h"
 #include "ns3/ptr.h"
@@ -45,6 +46,10 @@ class Ipv6MulticastRoutingTableEntry;
  * Ipv6RoutingProtocol that defines the interface methods that a routing
  * protocol must support.
  *
+ * The unicast routes are looked up in a PrefixTrie of the network routes, so
+ * that the cost of the longest prefix match does not grow with the size of
+ * the routing table.
+ *
  * \see Ipv6RoutingProtocol
  * \see Ipv6ListRouting
  * \see Ipv6ListRouting::AddRoutingProtocol
@@ -286,6 +291,9 @@ class Ipv6StaticRouting : public Ipv6RoutingProtocol
     /// Iterator for container for the network routes
     typedef std::list<std::pair<Ipv6RoutingTableEntry*, uint32_t>>::iterator NetworkRoutesI;
 
+    /// Trie of the network routes, for the longest prefix match
+    typedef PrefixTrie<std::pair<Ipv6RoutingTableEntry*, uint32_t>, 128> NetworkRoutesTrie;
+
     /// Container for the multicast routes
     typedef std::list<Ipv6MulticastRoutingTableEntry*> MulticastRoutes;
 
@@ -325,6 +333,14 @@ class Ipv6StaticRouting : public Ipv6RoutingProtocol
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief the network routes, indexed by destination prefix.
+     *
+     * It is cleared whenever the network routes change, and rebuilt by the
+     * next lookup.
+     */
+    NetworkRoutesTrie m_networkRoutesTrie;
+
     /**
      * \brief the forwarding table for multicast.
      */
@@ -17,6 +17,8 @@
 #include "ns3/node.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -47,6 +49,7 @@ NdiscCache::~NdiscCache()
 {
     NS_LOG_FUNCTION(this);
     Flush();
+    m_nudTimersEvent.Cancel();
 }
 
 void
@@ -54,6 +57,7 @@ NdiscCache::DoDispose()
 {
     NS_LOG_FUNCTION(this);
     Flush();
+    m_nudTimersEvent.Cancel();
     m_device = nullptr;
     m_interface = nullptr;
     m_icmpv6 = nullptr;
@@ -90,13 +94,18 @@ NdiscCache::Lookup(Ipv6Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
 
-    if (m_ndCache.find(dst) != m_ndCache.end())
+    auto it = m_ndCache.find(dst);
+    if (it != m_ndCache.end())
     {
-        NdiscCache::Entry* entry = m_ndCache[dst];
+        NdiscCache::Entry* entry = it->second;
         NS_LOG_LOGIC("Found an entry: " << *entry);
 
         return entry;
     }
+    if (m_neighbors)
+    {
+        return AddNeighbor(dst);
+    }
     NS_LOG_LOGIC("Nothing found");
     return nullptr;
 }
@@ -106,16 +115,24 @@ NdiscCache::LookupInverse(Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
 
-    std::list<NdiscCache::Entry*> entryList;
-    for (auto i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    if (m_neighbors)
     {
-        NdiscCache::Entry* entry = (*i).second;
-        if (entry->GetMacAddress() == dst)
+        for (const auto& address : m_neighbors->GetAddresses(dst))
         {
-            NS_LOG_LOGIC("Found an entry:" << (*entry));
-            entryList.push_back(entry);
+            if (m_ndCache.find(address) == m_ndCache.end())
+            {
+                AddNeighbor(address);
+            }
         }
     }
+
+    std::list<NdiscCache::Entry*> entryList;
+    auto range = m_macIndex.equal_range(dst);
+    for (auto i = range.first; i != range.second; i++)
+    {
+        NS_LOG_LOGIC("Found an entry:" << (*i->second));
+        entryList.push_back(i->second);
+    }
     return entryList;
 }
 
@@ -128,6 +145,7 @@ NdiscCache::Add(Ipv6Address to)
     auto entry = new NdiscCache::Entry(this);
     entry->SetIpv6Address(to);
     m_ndCache[to] = entry;
+    AddToMacIndex(entry);
     return entry;
 }
 
@@ -136,13 +154,38 @@ NdiscCache::Remove(NdiscCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (auto i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    auto it = m_ndCache.find(entry->GetIpv6Address());
+    if (it != m_ndCache.end() && it->second == entry)
     {
-        if ((*i).second == entry)
+        m_ndCache.erase(it);
+        if (m_neighbors && m_neighbors->Find(entry->GetIpv6Address(), m_device))
         {
-            m_ndCache.erase(i);
-            entry->ClearWaitingPacket();
-            delete entry;
+            // do not create the entry again from the neighbors
+            m_removedNeighbors.insert(entry->GetIpv6Address());
+        }
+        RemoveFromMacIndex(entry);
+        entry->ClearWaitingPacket();
+        delete entry;
+    }
+}
+
+void
+NdiscCache::AddToMacIndex(NdiscCache::Entry* entry)
+{
+    NS_LOG_FUNCTION(this << entry);
+    m_macIndex.emplace(entry->GetMacAddress(), entry);
+}
+
+void
+NdiscCache::RemoveFromMacIndex(NdiscCache::Entry* entry)
+{
+    NS_LOG_FUNCTION(this << entry);
+    auto range = m_macIndex.equal_range(entry->GetMacAddress());
+    for (auto i = range.first; i != range.second; i++)
+    {
+        if (i->second == entry)
+        {
+            m_macIndex.erase(i);
             return;
         }
     }
@@ -158,7 +201,41 @@ NdiscCache::Flush()
         delete (*i).second; /* delete the pointer NdiscCache::Entry */
     }
 
-    m_ndCache.erase(m_ndCache.begin(), m_ndCache.end());
+    m_ndCache.clear();
+    m_macIndex.clear();
+    m_neighbors = nullptr;
+    m_removedNeighbors.clear();
+}
+
+void
+NdiscCache::ScheduleNudTimers()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_nudTimers.empty())
+    {
+        return;
+    }
+    Time expiry = m_nudTimers.begin()->first;
+    if (m_nudTimersEvent.IsPending() && TimeStep(m_nudTimersEvent.GetTs()) <= expiry)
+    {
+        return;
+    }
+    m_nudTimersEvent.Cancel();
+    m_nudTimersEvent =
+        Simulator::Schedule(expiry - Simulator::Now(), &NdiscCache::HandleNudTimers, this);
+}
+
+void
+NdiscCache::HandleNudTimers()
+{
+    NS_LOG_FUNCTION(this);
+    // The timers expiring together are handled in the order they were
+    // scheduled.  A timeout may remove entries or start other timers.
+    while (!m_nudTimers.empty() && m_nudTimers.begin()->first <= Simulator::Now())
+    {
+        m_nudTimers.begin()->second->FunctionNudTimeout();
+    }
+    ScheduleNudTimers();
 }
 
 void
@@ -181,7 +258,20 @@ NdiscCache::PrintNdiscCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (auto i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    if (m_neighbors)
+    {
+        for (const auto& address : m_neighbors->GetAddresses())
+        {
+            if (m_ndCache.find(address) == m_ndCache.end())
+            {
+                AddNeighbor(address);
+            }
+        }
+    }
+
+    // print the entries in order of IPv6 address
+    std::map<Ipv6Address, NdiscCache::Entry*> entries(m_ndCache.begin(), m_ndCache.end());
+    for (auto i = entries.begin(); i != entries.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -236,13 +326,19 @@ NdiscCache::Entry::Entry(NdiscCache* nd)
     : m_ndCache(nd),
       m_waiting(),
       m_router(false),
-      m_nudTimer(Timer::CANCEL_ON_DESTROY),
+      m_nudFunction(nullptr),
+      m_nudTimerRunning(false),
       m_lastReachabilityConfirmation(Seconds(0.0)),
       m_nsRetransmit(0)
 {
     NS_LOG_FUNCTION(this);
 }
 
+NdiscCache::Entry::~Entry()
+{
+    CancelNudTimer();
+}
+
 void
 NdiscCache::Entry::SetRouter(bool router)
 {
@@ -283,6 +379,13 @@ void
 NdiscCache::Entry::FunctionReachableTimeout()
 {
     NS_LOG_FUNCTION(this);
+    // Rearm the timer if the reachability was confirmed in the meantime
+    Time expiry = m_lastReachabilityConfirmation + m_nudDelay;
+    if (m_state == REACHABLE && expiry > Simulator::Now())
+    {
+        ScheduleNudTimer(expiry);
+        return;
+    }
     this->MarkStale();
 }
 
@@ -458,15 +561,9 @@ void
 NdiscCache::Entry::StartReachableTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
     m_lastReachabilityConfirmation = Simulator::Now();
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionReachableTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetReachableTime());
-    m_nudTimer.Schedule();
+    StartNudTimer(&NdiscCache::Entry::FunctionReachableTimeout,
+                  m_ndCache->m_icmpv6->GetReachableTime());
 }
 
 void
@@ -477,11 +574,10 @@ NdiscCache::Entry::UpdateReachableTimer()
     if (m_state == REACHABLE)
     {
         m_lastReachabilityConfirmation = Simulator::Now();
-        if (m_nudTimer.IsRunning())
+        if (!m_nudTimerRunning && m_nudFunction)
         {
-            m_nudTimer.Cancel();
+            ScheduleNudTimer(Simulator::Now() + m_nudDelay);
         }
-        m_nudTimer.Schedule();
     }
 }
 
@@ -489,52 +585,72 @@ void
 NdiscCache::Entry::StartProbeTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionProbeTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetRetransmissionTime());
-    m_nudTimer.Schedule();
+    StartNudTimer(&NdiscCache::Entry::FunctionProbeTimeout,
+                  m_ndCache->m_icmpv6->GetRetransmissionTime());
 }
 
 void
 NdiscCache::Entry::StartDelayTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionDelayTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetDelayFirstProbe());
-    m_nudTimer.Schedule();
+    StartNudTimer(&NdiscCache::Entry::FunctionDelayTimeout,
+                  m_ndCache->m_icmpv6->GetDelayFirstProbe());
 }
 
 void
 NdiscCache::Entry::StartRetransmitTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionRetransmitTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetRetransmissionTime());
-    m_nudTimer.Schedule();
+    StartNudTimer(&NdiscCache::Entry::FunctionRetransmitTimeout,
+                  m_ndCache->m_icmpv6->GetRetransmissionTime());
 }
 
 void
 NdiscCache::Entry::StopNudTimer()
 {
     NS_LOG_FUNCTION(this);
-    m_nudTimer.Cancel();
+    CancelNudTimer();
     m_nsRetransmit = 0;
 }
 
+void
+NdiscCache::Entry::StartNudTimer(void (NdiscCache::Entry::*function)(), Time delay)
+{
+    NS_LOG_FUNCTION(this << delay);
+    m_nudFunction = function;
+    m_nudDelay = delay;
+    ScheduleNudTimer(Simulator::Now() + delay);
+}
+
+void
+NdiscCache::Entry::ScheduleNudTimer(Time expiry)
+{
+    NS_LOG_FUNCTION(this << expiry);
+    CancelNudTimer();
+    m_nudTimer = m_ndCache->m_nudTimers.emplace(expiry, this);
+    m_nudTimerRunning = true;
+    m_ndCache->ScheduleNudTimers();
+}
+
+void
+NdiscCache::Entry::CancelNudTimer()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_nudTimerRunning)
+    {
+        m_ndCache->m_nudTimers.erase(m_nudTimer);
+        m_nudTimerRunning = false;
+    }
+}
+
+void
+NdiscCache::Entry::FunctionNudTimeout()
+{
+    NS_LOG_FUNCTION(this);
+    CancelNudTimer();
+    (this->*m_nudFunction)();
+}
+
 void
 NdiscCache::Entry::MarkIncomplete(Ipv6PayloadHeaderPair p)
 {
@@ -552,7 +668,7 @@ NdiscCache::Entry::MarkReachable(Address mac)
 {
     NS_LOG_FUNCTION(this << mac);
     m_state = REACHABLE;
-    m_macAddress = mac;
+    SetMacAddress(mac);
     return m_waiting;
 }
 
@@ -582,7 +698,7 @@ NdiscCache::Entry::MarkStale(Address mac)
 {
     NS_LOG_FUNCTION(this << mac);
     m_state = STALE;
-    m_macAddress = mac;
+    SetMacAddress(mac);
     return m_waiting;
 }
 
@@ -669,7 +785,9 @@ void
 NdiscCache::Entry::SetMacAddress(Address mac)
 {
     NS_LOG_FUNCTION(this << mac << int(m_state));
+    m_ndCache->RemoveFromMacIndex(this);
     m_macAddress = mac;
+    m_ndCache->AddToMacIndex(this);
 }
 
 void
@@ -711,12 +829,206 @@ NdiscCache::RemoveAutoGeneratedEntries()
         if (i->second->IsAutoGenerated())
         {
             i->second->ClearWaitingPacket();
+            RemoveFromMacIndex(i->second);
             delete i->second;
-            m_ndCache.erase(i++);
+            i = m_ndCache.erase(i);
             continue;
         }
         i++;
     }
+    m_neighbors = nullptr;
+    m_removedNeighbors.clear();
+}
+
+void
+NdiscCache::SetNeighbors(Ptr<Neighbors> neighbors)
+{
+    NS_LOG_FUNCTION(this << neighbors);
+    m_neighbors = neighbors;
+    m_removedNeighbors.clear();
+    for (const auto& [address, entry] : m_ndCache)
+    {
+        const Neighbors::Neighbor* neighbor = FindNeighbor(address);
+        if (neighbor)
+        {
+            entry->SetMacAddress(neighbor->device->GetAddress());
+            entry->MarkAutoGenerated();
+        }
+    }
+}
+
+Ptr<NdiscCache::Neighbors>
+NdiscCache::GetNeighbors() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_neighbors;
+}
+
+void
+NdiscCache::RemoveNeighbor(Ipv6Address address)
+{
+    NS_LOG_FUNCTION(this << address);
+    auto it = m_ndCache.find(address);
+    if (it != m_ndCache.end())
+    {
+        Remove(it->second);
+    }
+    else if (m_neighbors && m_neighbors->Find(address, m_device))
+    {
+        m_removedNeighbors.insert(address);
+    }
+}
+
+void
+NdiscCache::UpdateNeighbor(Ipv6Address address)
+{
+    NS_LOG_FUNCTION(this << address);
+    m_removedNeighbors.erase(address);
+    auto it = m_ndCache.find(address);
+    const Neighbors::Neighbor* neighbor = FindNeighbor(address);
+    if (it != m_ndCache.end() && neighbor)
+    {
+        it->second->SetMacAddress(neighbor->device->GetAddress());
+        it->second->MarkAutoGenerated();
+    }
+}
+
+const NdiscCache::Neighbors::Neighbor*
+NdiscCache::FindNeighbor(Ipv6Address to) const
+{
+    NS_LOG_FUNCTION(this << to);
+    if (!m_neighbors || !m_interface)
+    {
+        return nullptr;
+    }
+    const Neighbors::Neighbor* neighbor = m_neighbors->Find(to, m_device);
+    if (!neighbor)
+    {
+        return nullptr;
+    }
+    for (uint32_t i = 0; i < m_interface->GetNAddresses(); ++i)
+    {
+        Ipv6InterfaceAddress ifAddr = m_interface->GetAddress(i);
+        for (const auto& subnet : neighbor->subnets)
+        {
+            if (ifAddr.IsInSameSubnet(subnet))
+            {
+                return neighbor;
+            }
+        }
+    }
+    return nullptr;
+}
+
+NdiscCache::Entry*
+NdiscCache::AddNeighbor(Ipv6Address to)
+{
+    NS_LOG_FUNCTION(this << to);
+    if (m_removedNeighbors.find(to) != m_removedNeighbors.end())
+    {
+        return nullptr;
+    }
+    const Neighbors::Neighbor* neighbor = FindNeighbor(to);
+    if (!neighbor)
+    {
+        return nullptr;
+    }
+    NdiscCache::Entry* entry = Add(to);
+    entry->SetMacAddress(neighbor->device->GetAddress());
+    entry->MarkAutoGenerated();
+    return entry;
+}
+
+void
+NdiscCache::Neighbors::Add(Ipv6Address address,
+                           Ptr<NetDevice> device,
+                           std::vector<Ipv6Address> subnets)
+{
+    NS_LOG_FUNCTION(this << address << device);
+    std::vector<Neighbor>& neighbors = m_neighbors[address];
+    for (auto& neighbor : neighbors)
+    {
+        if (neighbor.device == device)
+        {
+            neighbor.subnets = std::move(subnets);
+            return;
+        }
+    }
+    neighbors.push_back({device, std::move(subnets)});
+    m_addresses.emplace(device->GetAddress(), address);
+}
+
+void
+NdiscCache::Neighbors::Remove(Ipv6Address address, Ptr<NetDevice> device)
+{
+    NS_LOG_FUNCTION(this << address << device);
+    auto it = m_neighbors.find(address);
+    if (it == m_neighbors.end())
+    {
+        return;
+    }
+    auto position = std::find_if(it->second.begin(),
+                                 it->second.end(),
+                                 [device](const Neighbor& n) { return n.device == device; });
+    if (position == it->second.end())
+    {
+        return;
+    }
+    it->second.erase(position);
+    if (it->second.empty())
+    {
+        m_neighbors.erase(it);
+    }
+    auto range = m_addresses.equal_range(device->GetAddress());
+    for (auto i = range.first; i != range.second; i++)
+    {
+        if (i->second == address)
+        {
+            m_addresses.erase(i);
+            break;
+        }
+    }
+}
+
+const NdiscCache::Neighbors::Neighbor*
+NdiscCache::Neighbors::Find(Ipv6Address address, Ptr<NetDevice> device) const
+{
+    auto it = m_neighbors.find(address);
+    if (it == m_neighbors.end())
+    {
+        return nullptr;
+    }
+    for (auto i = it->second.rbegin(); i != it->second.rend(); i++)
+    {
+        if (i->device != device)
+        {
+            return &(*i);
+        }
+    }
+    return nullptr;
+}
+
+std::list<Ipv6Address>
+NdiscCache::Neighbors::GetAddresses(Address mac) const
+{
+    std::list<Ipv6Address> addresses;
+    auto range = m_addresses.equal_range(mac);
+    for (auto i = range.first; i != range.second; i++)
+    {
+        addresses.push_back(i->second);
+    }
+    return addresses;
+}
+
+std::list<Ipv6Address>
+NdiscCache::Neighbors::GetAddresses() const
+{
+    std::list<Ipv6Address> addresses;
+    for (const auto& neighbor : m_neighbors)
+    {
+        addresses.push_back(neighbor.first);
+    }
+    return addresses;
 }
 
 std::ostream&
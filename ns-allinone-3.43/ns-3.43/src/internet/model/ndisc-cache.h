@@ -15,11 +15,15 @@
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
-#include "ns3/timer.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
 
 #include <list>
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace ns3
 {
@@ -33,11 +37,22 @@ class Icmpv6L4Protocol;
  * \ingroup ipv6
  *
  * \brief IPv6 Neighbor Discovery cache.
+ *
+ * The entries are hashed by IPv6 address, and indexed by MAC address for
+ * the inverse lookups.  The NUD timers of the entries do not schedule events
+ * of their own: the cache keeps the running timers in order of expiration,
+ * and a single event per cache expires them.
+ *
+ * The caches of the devices of a channel can share the addresses of their
+ * neighbors (NdiscCache::Neighbors), filled once for the channel by the
+ * NeighborCacheHelper.  The auto-generated entries of the neighbors are then
+ * created when they are first looked up, inverse looked up or printed.
  */
 class NdiscCache : public Object
 {
   public:
     class Entry;
+    class Neighbors;
 
     /**
      * \brief Get the type ID
@@ -139,9 +154,44 @@ class NdiscCache : public Object
 
     /**
      * \brief Clear the NDISC cache of all Auto-Generated entries
+     *
+     * The cache also stops using the neighbors it shares.
      */
     void RemoveAutoGeneratedEntries();
 
+    /**
+     * \brief Use the addresses of the neighbors of the device.
+     *
+     * The neighbors on the subnets of the interface are auto-generated
+     * entries of the cache, which are created when they are needed.  The
+     * entries of the cache for these neighbors become auto-generated.
+     *
+     * \param neighbors the addresses of the devices of the channel
+     */
+    void SetNeighbors(Ptr<Neighbors> neighbors);
+
+    /**
+     * \brief Get the addresses of the neighbors used by the cache.
+     * \return the addresses of the neighbors, or nullptr
+     */
+    Ptr<Neighbors> GetNeighbors() const;
+
+    /**
+     * \brief Remove the entry of a neighbor.
+     *
+     * The entry is not created again from the neighbors, unless
+     * UpdateNeighbor is called for its address.
+     *
+     * \param address the IPv6 address of the neighbor
+     */
+    void RemoveNeighbor(Ipv6Address address);
+
+    /**
+     * \brief Update the entry of a neighbor, after a change of its address.
+     * \param address the IPv6 address of the neighbor
+     */
+    void UpdateNeighbor(Ipv6Address address);
+
     /**
      * \brief Pair of a packet and an Ipv4 header.
      */
@@ -161,7 +211,10 @@ class NdiscCache : public Object
          */
         Entry(NdiscCache* nd);
 
-        virtual ~Entry() = default;
+        /**
+         * \brief Destructor.
+         */
+        virtual ~Entry();
 
         /**
          * \brief The Entry state enumeration.
@@ -324,6 +377,10 @@ class NdiscCache : public Object
 
         /**
          * \brief Update the reachable timer.
+         *
+         * The timer is not rescheduled: the timeout rearms it when the
+         * reachability has been confirmed since it was started, so that the
+         * packets received from a neighbor do not cancel and schedule events.
          */
         void UpdateReachableTimer();
 
@@ -369,6 +426,11 @@ class NdiscCache : public Object
          */
         void FunctionDelayTimeout();
 
+        /**
+         * \brief Function called by the cache when the NUD timer expires.
+         */
+        void FunctionNudTimeout();
+
         /**
          * \brief Set the IPv6 address.
          * \param ipv6Address IPv6 address
@@ -422,9 +484,42 @@ class NdiscCache : public Object
         bool m_router;
 
         /**
-         * \brief Timer (used for NUD).
+         * \brief Start the NUD timer.
+         * \param function the function called when the timer expires
+         * \param delay the delay of the timer
          */
-        Timer m_nudTimer;
+        void StartNudTimer(void (NdiscCache::Entry::*function)(), Time delay);
+
+        /**
+         * \brief Schedule the NUD timer, with its current function and delay.
+         * \param expiry the expiration time of the timer
+         */
+        void ScheduleNudTimer(Time expiry);
+
+        /**
+         * \brief Cancel the NUD timer.
+         */
+        void CancelNudTimer();
+
+        /**
+         * \brief The function called when the NUD timer expires.
+         */
+        void (NdiscCache::Entry::*m_nudFunction)();
+
+        /**
+         * \brief The delay of the NUD timer.
+         */
+        Time m_nudDelay;
+
+        /**
+         * \brief The NUD timer, in the running timers of the cache.
+         */
+        std::multimap<Time, NdiscCache::Entry*>::iterator m_nudTimer;
+
+        /**
+         * \brief Whether the NUD timer is running.
+         */
+        bool m_nudTimerRunning;
 
         /**
          * \brief Last time we see a reachability confirmation.
@@ -437,6 +532,78 @@ class NdiscCache : public Object
         uint8_t m_nsRetransmit;
     };
 
+    /**
+     * \ingroup ipv6
+     *
+     * \brief The IPv6 addresses of the devices of a channel.
+     *
+     * The addresses are shared by the NDISC caches of the devices, which
+     * create the auto-generated entries of their neighbors from them.
+     */
+    class Neighbors : public SimpleRefCount<Neighbors>
+    {
+      public:
+        /**
+         * \brief A device owning an address.
+         */
+        struct Neighbor
+        {
+            Ptr<NetDevice> device; //!< the device
+            /// the entry is created by the caches with an address on one of these subnets
+            std::vector<Ipv6Address> subnets;
+        };
+
+        /**
+         * \brief Add an address of a device.
+         * \param address the IPv6 address
+         * \param device the device
+         * \param subnets the addresses of the subnets of the neighbors using the address
+         */
+        void Add(Ipv6Address address, Ptr<NetDevice> device, std::vector<Ipv6Address> subnets);
+
+        /**
+         * \brief Remove an address of a device.
+         * \param address the IPv6 address
+         * \param device the device
+         */
+        void Remove(Ipv6Address address, Ptr<NetDevice> device);
+
+        /**
+         * \brief Find the neighbor of a device owning an address.
+         *
+         * If several devices own the address, the last one added wins.
+         *
+         * \param address the IPv6 address
+         * \param device the device looking for its neighbor
+         * \return the neighbor, or nullptr
+         */
+        const Neighbor* Find(Ipv6Address address, Ptr<NetDevice> device) const;
+
+        /**
+         * \brief Get the addresses of the devices with a MAC address.
+         * \param mac the MAC address
+         * \return the IPv6 addresses
+         */
+        std::list<Ipv6Address> GetAddresses(Address mac) const;
+
+        /**
+         * \brief Get all the addresses.
+         * \return the IPv6 addresses
+         */
+        std::list<Ipv6Address> GetAddresses() const;
+
+      private:
+        /**
+         * \brief The devices owning each address, in order of addition.
+         */
+        std::unordered_map<Ipv6Address, std::vector<Neighbor>, Ipv6AddressHash> m_neighbors;
+
+        /**
+         * \brief The addresses, by MAC address of their devices.
+         */
+        std::multimap<Address, Ipv6Address> m_addresses;
+    };
+
   protected:
     /**
      * \brief Dispose this object.
@@ -446,11 +613,11 @@ class NdiscCache : public Object
     /**
      * \brief Neighbor Discovery Cache container
      */
-    typedef std::map<Ipv6Address, NdiscCache::Entry*> Cache;
+    typedef std::unordered_map<Ipv6Address, NdiscCache::Entry*, Ipv6AddressHash> Cache;
     /**
      * \brief Neighbor Discovery Cache container iterator
      */
-    typedef std::map<Ipv6Address, NdiscCache::Entry*>::iterator CacheI;
+    typedef Cache::iterator CacheI;
 
     /**
      * \brief A list of Entry.
@@ -458,6 +625,67 @@ class NdiscCache : public Object
     Cache m_ndCache;
 
   private:
+    /**
+     * \brief Add an entry to the index of MAC addresses.
+     * \param entry the entry
+     */
+    void AddToMacIndex(NdiscCache::Entry* entry);
+
+    /**
+     * \brief Remove an entry from the index of MAC addresses.
+     * \param entry the entry
+     */
+    void RemoveFromMacIndex(NdiscCache::Entry* entry);
+
+    /**
+     * \brief Schedule the expiration of the earliest NUD timer.
+     */
+    void ScheduleNudTimers();
+
+    /**
+     * \brief Expire the NUD timers.
+     */
+    void HandleNudTimers();
+
+    /**
+     * \brief Find a neighbor on the subnets of the interface.
+     * \param to the IPv6 address of the neighbor
+     * \return the neighbor, or nullptr
+     */
+    const Neighbors::Neighbor* FindNeighbor(Ipv6Address to) const;
+
+    /**
+     * \brief Create the auto-generated entry of a neighbor.
+     * \param to the IPv6 address of the neighbor
+     * \return the new entry, or nullptr if the address is not a neighbor
+     */
+    NdiscCache::Entry* AddNeighbor(Ipv6Address to);
+
+    /**
+     * \brief The entries, by MAC address.
+     */
+    std::multimap<Address, NdiscCache::Entry*> m_macIndex;
+
+    /**
+     * \brief The running NUD timers, by expiration time.
+     */
+    std::multimap<Time, NdiscCache::Entry*> m_nudTimers;
+
+    /**
+     * \brief The expiration of the earliest NUD timer.
+     */
+    EventId m_nudTimersEvent;
+
+    /**
+     * \brief The addresses of the neighbors of the device.
+     */
+    Ptr<Neighbors> m_neighbors;
+
+    /**
+     * \brief The neighbors whose entry was removed.
+     */
+    std::unordered_set<Ipv6Address, Ipv6AddressHash> m_removedNeighbors;
+
     /**
      * \brief The NetDevice.
      */
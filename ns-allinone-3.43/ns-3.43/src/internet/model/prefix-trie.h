@@ -0,0 +1,185 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef PREFIX_TRIE_H
+#define PREFIX_TRIE_H
+
+#include <array>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup ipv4Routing
+ * ns3::PrefixTrie declaration and implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief A multibit trie storing values by address prefix, for the longest
+ * prefix match of the routing tables.
+ *
+ * The addresses are given as arrays of bytes, in network order.  Each node of
+ * the trie consumes 4 bits of the address, so that a lookup examines at most
+ * Bits / 4 + 1 nodes, whatever the number of prefixes.  The prefixes whose
+ * length is not a multiple of 4 are stored in the node of their last complete
+ * 4-bit group.
+ *
+ * Several values can be stored with the same prefix: they are kept in order of
+ * insertion, so that the routing protocols can preserve the order of their
+ * routing tables, e.g., to choose among equal-cost routes.
+ *
+ * The trie is meant to be built from a routing table, and to be cleared and
+ * rebuilt when the routing table changes.
+ *
+ * \tparam T \explicit the type of the values
+ * \tparam Bits \explicit the length of the addresses, in bits
+ */
+template <typename T, uint8_t Bits>
+class PrefixTrie
+{
+  public:
+    /// Values stored with a prefix, in order of insertion
+    typedef std::vector<T> Values;
+
+    /**
+     * Store a value with a prefix.
+     *
+     * \param prefix the prefix (only its first length bits are used)
+     * \param length the length of the prefix, in bits
+     * \param value the value
+     */
+    void Insert(const uint8_t* prefix, uint8_t length, const T& value)
+    {
+        Node* node = &m_root;
+        uint8_t depth = 0;
+        for (; length - depth * STRIDE >= STRIDE; depth++)
+        {
+            std::unique_ptr<Node>& child = node->children[Nibble(prefix, depth)];
+            if (!child)
+            {
+                child = std::make_unique<Node>();
+            }
+            node = child.get();
+        }
+        uint8_t rest = length - depth * STRIDE;
+        uint8_t bits = rest ? Nibble(prefix, depth) & Mask(rest) : 0;
+        auto it = node->prefixes.begin();
+        for (; it != node->prefixes.end() && it->length <= length; it++)
+        {
+            if (it->length == length && it->bits == bits)
+            {
+                it->values.push_back(value);
+                return;
+            }
+        }
+        node->prefixes.insert(it, Prefix{length, bits, Values{value}});
+        m_empty = false;
+    }
+
+    /**
+     * Visit the values of the prefixes matching an address, from the longest
+     * prefix to the shortest one, until the visitor returns true.
+     *
+     * \param address the address
+     * \param visit the visitor, called with the values of each matching prefix
+     * and returning true to stop the lookup
+     * \return true if the visitor stopped the lookup
+     */
+    template <typename F>
+    bool Lookup(const uint8_t* address, F visit) const
+    {
+        std::array<const Node*, Bits / STRIDE + 1> path;
+        uint8_t depth = 0;
+        path[0] = &m_root;
+        while (depth * STRIDE < Bits)
+        {
+            const Node* child = path[depth]->children[Nibble(address, depth)].get();
+            if (!child)
+            {
+                break;
+            }
+            path[++depth] = child;
+        }
+        for (int d = depth; d >= 0; d--)
+        {
+            const std::vector<Prefix>& prefixes = path[d]->prefixes;
+            for (auto it = prefixes.rbegin(); it != prefixes.rend(); it++)
+            {
+                uint8_t rest = it->length - d * STRIDE;
+                if ((!rest || (Nibble(address, d) & Mask(rest)) == it->bits) && visit(it->values))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /// Remove all the prefixes
+    void Clear()
+    {
+        if (!m_empty)
+        {
+            m_root = Node();
+            m_empty = true;
+        }
+    }
+
+    /// \return true if no prefix is stored
+    bool IsEmpty() const
+    {
+        return m_empty;
+    }
+
+  private:
+    /// Number of address bits consumed by each node
+    static constexpr uint8_t STRIDE = 4;
+
+    /// A prefix ending in a node
+    struct Prefix
+    {
+        uint8_t length; //!< length of the prefix, in bits
+        uint8_t bits;   //!< bits of the prefix beyond the node, in the high bits of a nibble
+        Values values;  //!< values stored with the prefix
+    };
+
+    /// A node of the trie
+    struct Node
+    {
+        std::array<std::unique_ptr<Node>, 1 << STRIDE> children; //!< children, by next nibble
+        std::vector<Prefix> prefixes; //!< prefixes ending in this node, by increasing length
+    };
+
+    /**
+     * \param address an address
+     * \param index the index of a nibble
+     * \return the nibble of the address
+     */
+    static uint8_t Nibble(const uint8_t* address, uint8_t index)
+    {
+        return (address[index / 2] >> (index % 2 ? 0 : 4)) & 0xf;
+    }
+
+    /**
+     * \param length a number of bits, lower than 4
+     * \return the mask of the high bits of a nibble
+     */
+    static uint8_t Mask(uint8_t length)
+    {
+        return (0xf0 >> length) & 0xf;
+    }
+
+    Node m_root;        //!< root of the trie
+    bool m_empty{true}; //!< true if no prefix is stored
+};
+
+} // namespace ns3
+
+#endif /* PREFIX_TRIE_H */
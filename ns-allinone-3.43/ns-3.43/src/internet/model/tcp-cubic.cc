@@ -205,9 +205,14 @@ TcpCubic::IncreaseWindow(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
         // growth, when TcpSocket::DelAckCount==2, then the slow start will
         // not reach as large of an initial window as in Linux.  Therefore,
         // we can approximate the effect of QUICKACK by making this slow
-        // start phase perform Appropriate Byte Counting (RFC 3465)
-        tcb->m_cWnd += segmentsAcked * tcb->m_segmentSize;
-        segmentsAcked = 0;
+        // start phase perform Appropriate Byte Counting (RFC 3465).
+        // As tcp_slow_start() in Linux, the window does not grow beyond the
+        // slow start threshold, and the remaining segments of a stretch ACK
+        // are counted by the congestion avoidance
+        uint32_t sndCwnd = tcb->m_cWnd;
+        tcb->m_cWnd = std::min(sndCwnd + segmentsAcked * tcb->m_segmentSize,
+                               static_cast<uint32_t>(tcb->m_ssThresh));
+        segmentsAcked -= (tcb->m_cWnd - sndCwnd) / tcb->m_segmentSize;
 
         NS_LOG_INFO("In SlowStart, updated to cwnd " << tcb->m_cWnd << " ssthresh "
                                                      << tcb->m_ssThresh);
@@ -225,8 +230,10 @@ TcpCubic::IncreaseWindow(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
          */
         if (m_cWndCnt >= cnt)
         {
-            tcb->m_cWnd += tcb->m_segmentSize;
-            m_cWndCnt -= cnt;
+            // A stretch ACK may account for several increments
+            uint32_t delta = m_cWndCnt / cnt;
+            tcb->m_cWnd += delta * tcb->m_segmentSize;
+            m_cWndCnt -= delta * cnt;
             NS_LOG_INFO("In CongAvoid, updated to cwnd " << tcb->m_cWnd);
         }
         else
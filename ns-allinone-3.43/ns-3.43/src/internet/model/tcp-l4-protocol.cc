@@ -8,6 +8,7 @@
 
 #include "tcp-l4-protocol.h"
 
+#include "gso-tag.h"
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
 #include "ipv4-route.h"
@@ -35,6 +36,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 #include <unordered_map>
@@ -687,9 +689,15 @@ TcpL4Protocol::SendPacket(Ptr<Packet> pkt,
                           const TcpHeader& outgoing,
                           const Address& saddr,
                           const Address& daddr,
-                          Ptr<NetDevice> oif) const
+                          Ptr<NetDevice> oif,
+                          uint32_t segmentSize) const
 {
-    NS_LOG_FUNCTION(this << pkt << outgoing << saddr << daddr << oif);
+    NS_LOG_FUNCTION(this << pkt << outgoing << saddr << daddr << oif << segmentSize);
+    if (segmentSize > 0 && pkt->GetSize() > segmentSize)
+    {
+        uint32_t nSegments = (pkt->GetSize() + segmentSize - 1) / segmentSize;
+        pkt->AddPacketTag(GsoTag(segmentSize + outgoing.GetSerializedSize(), nSegments));
+    }
     if (Ipv4Address::IsMatchingType(saddr))
     {
         NS_ASSERT(Ipv4Address::IsMatchingType(daddr));
@@ -736,6 +744,51 @@ TcpL4Protocol::SendPacket(Ptr<Packet> pkt,
     NS_FATAL_ERROR("Trying to send a packet without IP addresses");
 }
 
+std::vector<Ptr<Packet>>
+TcpL4Protocol::SplitSuperSegment(Ptr<const Packet> superSegment,
+                                 const Address& saddr,
+                                 const Address& daddr)
+{
+    Ptr<Packet> payload = superSegment->Copy();
+    GsoTag gsoTag;
+    bool found = payload->RemovePacketTag(gsoTag);
+    NS_ASSERT_MSG(found, "The packet is not a super-segment");
+
+    // the checksum settings are not carried by the header deserialized from the packet
+    TcpHeader outgoing;
+    payload->RemoveHeader(outgoing);
+    if (Node::ChecksumEnabled())
+    {
+        outgoing.EnableChecksums();
+    }
+    outgoing.InitializeChecksum(saddr, daddr, PROT_NUMBER);
+
+    uint32_t segmentSize = gsoTag.GetSegmentSize() - outgoing.GetSerializedSize();
+    uint32_t size = payload->GetSize();
+    std::vector<Ptr<Packet>> segments;
+    segments.reserve(gsoTag.GetNSegments());
+    for (uint32_t offset = 0; offset < size; offset += segmentSize)
+    {
+        uint32_t length = std::min(segmentSize, size - offset);
+        TcpHeader header = outgoing;
+        uint8_t flags = outgoing.GetFlags();
+        if (offset > 0)
+        {
+            flags &= ~TcpHeader::CWR;
+        }
+        if (offset + length < size)
+        {
+            flags &= ~(TcpHeader::PSH | TcpHeader::FIN);
+        }
+        header.SetFlags(flags);
+        header.SetSequenceNumber(outgoing.GetSequenceNumber() + SequenceNumber32(offset));
+        Ptr<Packet> segment = payload->CreateFragment(offset, length);
+        segment->AddHeader(header);
+        segments.push_back(segment);
+    }
+    return segments;
+}
+
 void
 TcpL4Protocol::AddSocket(Ptr<TcpSocketBase> socket)
 {
@@ -769,6 +822,24 @@ TcpL4Protocol::RemoveSocket(Ptr<TcpSocketBase> socket)
     return false;
 }
 
+TcpL4Protocol::SocketIterator
+TcpL4Protocol::SocketsBegin() const
+{
+    return m_sockets.begin();
+}
+
+TcpL4Protocol::SocketIterator
+TcpL4Protocol::SocketsEnd() const
+{
+    return m_sockets.end();
+}
+
+uint32_t
+TcpL4Protocol::GetNSockets() const
+{
+    return m_sockets.size();
+}
+
 void
 TcpL4Protocol::SetDownTarget(IpL4Protocol::DownTargetCallback callback)
 {
@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 #include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -206,17 +207,44 @@ class TcpL4Protocol : public IpL4Protocol
     /**
      * \brief Send a packet via TCP (IP-agnostic)
      *
+     * If segmentSize is not zero, the packet is a super-segment built by a
+     * socket using segmentation offload: it is tagged with a GsoTag and goes
+     * through the IP layer as a single packet, and it is split into segments of
+     * at most segmentSize bytes by the traffic control layer of the outgoing
+     * device (see SplitSuperSegment).
+     *
      * \param pkt The packet to send
      * \param outgoing The packet header
      * \param saddr The source Ipv4Address
      * \param daddr The destination Ipv4Address
      * \param oif The output interface bound. Defaults to null (unspecified).
+     * \param segmentSize The size of the segments sent on the wire, or 0 to
+     * send the packet as is. Defaults to 0.
      */
     void SendPacket(Ptr<Packet> pkt,
                     const TcpHeader& outgoing,
                     const Address& saddr,
                     const Address& daddr,
-                    Ptr<NetDevice> oif = nullptr) const;
+                    Ptr<NetDevice> oif = nullptr,
+                    uint32_t segmentSize = 0) const;
+
+    /**
+     * \brief Split a super-segment into the segments transmitted on the wire
+     *
+     * The sequence number of each segment follows its offset in the
+     * super-segment, the CWR flag is only set on the first segment, and the PSH
+     * and FIN flags only on the last one. The checksum of each segment is
+     * computed if the checksums are enabled.
+     *
+     * \param superSegment the super-segment, starting with its TCP header and
+     * carrying a GsoTag
+     * \param saddr The source address
+     * \param daddr The destination address
+     * \return the segments, each one with its own TCP header
+     */
+    static std::vector<Ptr<Packet>> SplitSuperSegment(Ptr<const Packet> superSegment,
+                                                      const Address& saddr,
+                                                      const Address& daddr);
 
     /**
      * \brief Make a socket fully operational
@@ -235,6 +263,33 @@ class TcpL4Protocol : public IpL4Protocol
      */
     bool RemoveSocket(Ptr<TcpSocketBase> socket);
 
+    /// Iterator over the sockets, as pairs of socket ID and socket
+    typedef std::unordered_map<uint64_t, Ptr<TcpSocketBase>>::const_iterator SocketIterator;
+
+    /**
+     * \brief Get an iterator to the first socket of this stack
+     *
+     * The sockets are those of the SocketList attribute, keyed by the same
+     * socket IDs, in no particular order. The iterators are invalidated when
+     * a socket is added or removed, hence the sockets must not be iterated
+     * over while sockets are created, accepted or closed.
+     *
+     * \return an iterator to the first socket
+     */
+    SocketIterator SocketsBegin() const;
+
+    /**
+     * \brief Get an iterator past the last socket of this stack
+     * \return an iterator past the last socket
+     */
+    SocketIterator SocketsEnd() const;
+
+    /**
+     * \brief Get the number of sockets of this stack
+     * \return the number of sockets
+     */
+    uint32_t GetNSockets() const;
+
     /**
      * \brief Remove an IPv4 Endpoint.
      * \param endPoint the end point to remove
@@ -11,6 +11,9 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace ns3
 {
 
@@ -160,70 +163,59 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             headSeq = tailSeq;
         }
     }
-    // Remove overlapped bytes from packet
-    auto i = m_data.begin();
-    while (i != m_data.end() && i->first <= tailSeq)
-    {
-        SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
-        if (lastByteSeq > headSeq)
-        {
-            if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-                m_size -= i->second->GetSize();
-                m_data.erase(i++);
-                continue;
-            }
-            if (i->first <= headSeq)
-            { // Incoming head is overlapped
-                headSeq = lastByteSeq;
-            }
-            if (lastByteSeq >= tailSeq)
-            { // Incoming tail is overlapped
-                tailSeq = i->first;
-            }
-        }
-        ++i;
-    }
-    // We now know how much we are going to store, trim the packet
     if (headSeq >= tailSeq)
     {
         NS_LOG_LOGIC("Nothing to buffer");
         return false; // Nothing to buffer anyway
     }
-    else
-    {
-        uint32_t start = static_cast<uint32_t>(headSeq - tcph.GetSequenceNumber());
-        auto length = static_cast<uint32_t>(tailSeq - headSeq);
-        p = p->CreateFragment(start, length);
-        NS_ASSERT(length == p->GetSize());
-    }
-    // Insert packet into buffer
-    NS_ASSERT(m_data.find(headSeq) == m_data.end()); // Shouldn't be there yet
-    m_data[headSeq] = p;
 
-    if (headSeq > m_nextRxSeq)
+    // Find the out-of-order ranges overlapping or touching the incoming bytes:
+    // only the holes between them are stored, and they are merged into one range
+    auto first = m_ranges.upper_bound(headSeq);
+    if (first != m_ranges.begin() && std::prev(first)->second >= headSeq)
     {
-        // Generate a new SACK block
-        UpdateSackList(headSeq, tailSeq);
+        --first;
     }
-
-    NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize());
-    // Update variables
-    m_size += p->GetSize(); // Occupancy
-    for (i = m_data.begin(); i != m_data.end(); ++i)
+    SequenceNumber32 rangeHead = headSeq;
+    SequenceNumber32 rangeTail = tailSeq;
+    SequenceNumber32 cur = headSeq;
+    uint32_t stored = 0;
+    auto last = first;
+    for (; last != m_ranges.end() && last->first <= tailSeq; ++last)
     {
-        if (i->first < m_nextRxSeq)
+        if (cur < last->first)
         {
-            continue;
+            stored += StoreFragment(p, tcph.GetSequenceNumber(), cur, last->first);
         }
-        else if (i->first > m_nextRxSeq)
-        {
-            break;
-        };
-        m_nextRxSeq = i->first + SequenceNumber32(i->second->GetSize());
-        m_availBytes += i->second->GetSize();
+        cur = std::max(cur, last->second);
+        rangeHead = std::min(rangeHead, last->first);
+        rangeTail = std::max(rangeTail, last->second);
+    }
+    if (cur < tailSeq)
+    {
+        stored += StoreFragment(p, tcph.GetSequenceNumber(), cur, tailSeq);
+    }
+    if (stored == 0)
+    {
+        NS_LOG_LOGIC("Nothing to buffer");
+        return false; // All the bytes are already buffered
+    }
+    m_ranges.erase(first, last);
+    m_size += stored; // Occupancy
+
+    if (rangeHead == m_nextRxSeq)
+    {
+        // The range is now in order: it is available to the application
+        m_availBytes += static_cast<uint32_t>(rangeTail - m_nextRxSeq);
+        m_nextRxSeq = rangeTail;
         ClearSackList(m_nextRxSeq);
     }
+    else
+    {
+        m_ranges[rangeHead] = rangeTail;
+        // Generate a new SACK block
+        UpdateSackList(rangeHead, rangeTail);
+    }
     NS_LOG_LOGIC("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
     if (m_gotFin && m_nextRxSeq == m_finSeq)
     { // Account for the FIN packet
@@ -232,6 +224,22 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     return true;
 }
 
+uint32_t
+TcpRxBuffer::StoreFragment(Ptr<Packet> p,
+                           const SequenceNumber32& pktSeq,
+                           const SequenceNumber32& head,
+                           const SequenceNumber32& tail)
+{
+    NS_LOG_FUNCTION(this << p << pktSeq << head << tail);
+
+    uint32_t start = static_cast<uint32_t>(head - pktSeq);
+    auto length = static_cast<uint32_t>(tail - head);
+    NS_ASSERT(m_data.find(head) == m_data.end()); // Shouldn't be there yet
+    m_data[head] = p->CreateFragment(start, length);
+    NS_LOG_LOGIC("Buffered packet of seqno=" << head << " len=" << length);
+    return length;
+}
+
 uint32_t
 TcpRxBuffer::GetSackListSize() const
 {
@@ -278,50 +286,19 @@ TcpRxBuffer::UpdateSackList(const SequenceNumber32& head, const SequenceNumber32
 
     m_sackList.push_front(current);
 
-    // We have inserted the block at the beginning of the list. Now, we should
-    // check if any existing blocks overlap with that.
-    bool updated = false;
-    auto it = m_sackList.begin();
-    TcpOptionSack::SackBlock begin = *it;
-    TcpOptionSack::SackBlock merged;
-    ++it;
-
-    // Iterates until we examined all blocks in the list (maximum 4)
-    while (it != m_sackList.end())
+    // We have inserted the block at the beginning of the list. The other blocks
+    // lie within the ranges of stored data, and "current" is a whole range: the
+    // blocks overlapping with it are subsets of it, and they are removed.
+    for (auto it = std::next(m_sackList.begin()); it != m_sackList.end();)
     {
-        current = *it;
-
-        // This is a left merge:
-        // [current_first; current_second] [beg_first; beg_second]
-        if (begin.first == current.second)
+        if (current.first <= it->first && it->second <= current.second)
         {
-            NS_ASSERT(current.first < begin.second);
-            merged = TcpOptionSack::SackBlock(current.first, begin.second);
-            updated = true;
-        }
-        // while this is a right merge
-        // [begin_first; begin_second] [current_first; current_second]
-        else if (begin.second == current.first)
-        {
-            NS_ASSERT(begin.first < current.second);
-            merged = TcpOptionSack::SackBlock(begin.first, current.second);
-            updated = true;
+            it = m_sackList.erase(it);
         }
-
-        // If we have merged the blocks (and the result is in merged) we should
-        // delete the current block (it), the first block, and insert the merged
-        // one at the beginning.
-        if (updated)
+        else
         {
-            m_sackList.erase(it);
-            m_sackList.pop_front();
-            m_sackList.push_front(merged);
-            it = m_sackList.begin();
-            begin = *it;
-            updated = false;
+            ++it;
         }
-
-        ++it;
     }
 
     // Since the maximum blocks that fits into a TCP header are 4, there's no
@@ -330,11 +307,6 @@ TcpRxBuffer::UpdateSackList(const SequenceNumber32& head, const SequenceNumber32
     {
         m_sackList.pop_back();
     }
-
-    // Please note that, if a block b is discarded and then a block contiguous
-    // to b is received, only that new block (without the b part) is reported.
-    // This is perfectly fine for the RFC point (a), given that we do not report any
-    // overlapping blocks shortly after.
 }
 
 void
@@ -377,7 +349,7 @@ TcpRxBuffer::Extract(uint32_t maxSize)
         return nullptr; // No contiguous block to return
     }
     NS_ASSERT(!m_data.empty());            // At least we have something to extract
-    Ptr<Packet> outPkt = Create<Packet>(); // The packet that contains all the data to return
+    Ptr<Packet> outPkt; // The packet that contains all the data to return
     BufIterator i;
     while (extractSize)
     { // Check the buffered data for delivery
@@ -387,7 +359,15 @@ TcpRxBuffer::Extract(uint32_t maxSize)
         uint32_t pktSize = i->second->GetSize();
         if (pktSize <= extractSize)
         { // Whole packet is extracted
-            outPkt->AddAtEnd(i->second);
+            if (!outPkt)
+            { // The stored fragment is handed over as is, without copying its bytes
+                outPkt = i->second;
+                outPkt->RemoveAllPacketTags();
+            }
+            else
+            {
+                outPkt->AddAtEnd(i->second);
+            }
             m_data.erase(i);
             m_size -= pktSize;
             m_availBytes -= pktSize;
@@ -395,7 +375,16 @@ TcpRxBuffer::Extract(uint32_t maxSize)
         }
         else
         { // Partial is extracted and done
-            outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
+            Ptr<Packet> fragment = i->second->CreateFragment(0, extractSize);
+            if (!outPkt)
+            {
+                outPkt = fragment;
+                outPkt->RemoveAllPacketTags();
+            }
+            else
+            {
+                outPkt->AddAtEnd(fragment);
+            }
             m_data[i->first + SequenceNumber32(extractSize)] =
                 i->second->CreateFragment(extractSize, pktSize - extractSize);
             m_data.erase(i);
@@ -404,7 +393,7 @@ TcpRxBuffer::Extract(uint32_t maxSize)
             extractSize = 0;
         }
     }
-    if (outPkt->GetSize() == 0)
+    if (!outPkt || outPkt->GetSize() == 0)
     {
         NS_LOG_LOGIC("Nothing extracted.");
         return nullptr;
@@ -58,6 +58,20 @@ class Packet;
  * For more information about the SACK list, please check the documentation of
  * the method GetSackList.
  *
+ * Out-of-order data
+ * -----------------
+ *
+ * Besides the stored segments, the buffer keeps the ranges of contiguous
+ * out-of-order bytes, merged as soon as they touch. An incoming segment only
+ * looks up the ranges it overlaps, only the holes between them are stored,
+ * and the SACK block reporting it is the whole range which contains it. When
+ * a segment fills the hole at NextRxSequence, the following range becomes
+ * available in one step, without walking the stored segments.
+ *
+ * The stored segments are fragments of the received packets, and Extract
+ * returns them without copying their bytes when the request covers the
+ * first one.
+ *
  * \see GetSackList
  * \see UpdateSackList
  */
@@ -196,6 +210,20 @@ class TcpRxBuffer : public Object
      */
     void UpdateSackList(const SequenceNumber32& head, const SequenceNumber32& tail);
 
+    /**
+     * \brief Store a fragment of a received packet
+     *
+     * \param p the received packet
+     * \param pktSeq sequence number of the first byte of the packet
+     * \param head sequence number of the first byte of the fragment
+     * \param tail sequence number following the last byte of the fragment
+     * \return the number of bytes stored
+     */
+    uint32_t StoreFragment(Ptr<Packet> p,
+                           const SequenceNumber32& pktSeq,
+                           const SequenceNumber32& head,
+                           const SequenceNumber32& tail);
+
     /**
      * \brief Remove old blocks from the sack list
      *
@@ -221,6 +249,8 @@ class TcpRxBuffer : public Object
     uint32_t m_maxBuffer;  //!< Upper bound of the number of data bytes in buffer (RCV.WND)
     uint32_t m_availBytes; //!< Number of bytes available to read, i.e. contiguous block at head
     std::map<SequenceNumber32, Ptr<Packet>> m_data; //!< Corresponding data (may be null)
+    /// Ranges of contiguous out-of-order bytes, from their first sequence to their end
+    std::map<SequenceNumber32, SequenceNumber32> m_ranges;
 };
 
 } // namespace ns3
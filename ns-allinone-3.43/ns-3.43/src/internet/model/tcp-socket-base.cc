@@ -184,6 +184,26 @@ TcpSocketBase::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&TcpSocketBase::m_limitedTx),
                           MakeBooleanChecker())
+            .AddAttribute("GsoMaxSegments",
+                          "Maximum number of segments of new data sent at once as a single "
+                          "super-segment, which is split into wire segments by the traffic "
+                          "control layer (segmentation offload). 1 disables segmentation offload.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&TcpSocketBase::m_gsoMaxSegments),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("AckCoalescing",
+                          "Coalesce the pure ACKs of new data received in a burst, and process "
+                          "them as a single cumulative ACK.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpSocketBase::m_ackCoalescing),
+                          MakeBooleanChecker())
+            .AddAttribute("AckCoalescingDelay",
+                          "Time the first ACK of a burst waits for the next ones, when "
+                          "AckCoalescing is enabled. 0 coalesces the ACKs received at the "
+                          "same time.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&TcpSocketBase::m_ackCoalescingDelay),
+                          MakeTimeChecker(Seconds(0)))
             .AddAttribute("UseEcn",
                           "Parameter to set ECN functionality",
                           EnumValue(TcpSocketState::Off),
@@ -403,6 +423,9 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
       m_recoverActive(sock.m_recoverActive),
       m_retxThresh(sock.m_retxThresh),
       m_limitedTx(sock.m_limitedTx),
+      m_gsoMaxSegments(sock.m_gsoMaxSegments),
+      m_ackCoalescing(sock.m_ackCoalescing),
+      m_ackCoalescingDelay(sock.m_ackCoalescingDelay),
       m_isFirstPartialAck(sock.m_isFirstPartialAck),
       m_txTrace(sock.m_txTrace),
       m_rxTrace(sock.m_rxTrace),
@@ -1244,7 +1267,10 @@ TcpSocketBase::ForwardUp(Ptr<Packet> packet,
         m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_ECN_NO_CE);
     }
 
-    DoForwardUp(packet, fromAddress, toAddress);
+    if (!m_ackCoalescing || !CoalesceAck(packet, fromAddress, toAddress))
+    {
+        DoForwardUp(packet, fromAddress, toAddress);
+    }
 }
 
 void
@@ -1283,7 +1309,10 @@ TcpSocketBase::ForwardUp6(Ptr<Packet> packet,
         m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_ECN_NO_CE);
     }
 
-    DoForwardUp(packet, fromAddress, toAddress);
+    if (!m_ackCoalescing || !CoalesceAck(packet, fromAddress, toAddress))
+    {
+        DoForwardUp(packet, fromAddress, toAddress);
+    }
 }
 
 void
@@ -1522,6 +1551,71 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
     }
 }
 
+bool
+TcpSocketBase::CoalesceAck(Ptr<Packet> packet, const Address& fromAddress, const Address& toAddress)
+{
+    NS_LOG_FUNCTION(this << packet);
+    TcpHeader tcpHeader;
+    uint32_t headerSize = packet->PeekHeader(tcpHeader);
+    uint8_t flags = tcpHeader.GetFlags() & ~(TcpHeader::PSH | TcpHeader::URG);
+    SequenceNumber32 ackNumber = tcpHeader.GetAckNumber();
+
+    // Only the pure ACKs of new data can be coalesced: the duplicate ACKs,
+    // the SACK blocks and the data are processed one by one
+    auto canCoalesce = [&]() {
+        return m_state == ESTABLISHED && packet->GetSize() == headerSize &&
+               (flags & ~TcpHeader::ECE) == TcpHeader::ACK &&
+               !tcpHeader.HasOption(TcpOption::SACK) && ackNumber > m_txBuffer->HeadSequence() &&
+               ackNumber <= m_tcb->m_highTxMark;
+    };
+
+    if (m_coalescedAck)
+    {
+        TcpHeader pendingHeader;
+        m_coalescedAck->PeekHeader(pendingHeader);
+        if (flags == (pendingHeader.GetFlags() & ~(TcpHeader::PSH | TcpHeader::URG)) &&
+            ackNumber > pendingHeader.GetAckNumber() && canCoalesce())
+        {
+            NS_LOG_LOGIC("ACK " << ackNumber << " replaces ACK " << pendingHeader.GetAckNumber());
+            m_coalescedAck = packet;
+            m_coalescedAckFrom = fromAddress;
+            m_coalescedAckTo = toAddress;
+            m_coalescedAckTime = Simulator::Now();
+            return true;
+        }
+        FlushCoalescedAck();
+    }
+
+    if (!canCoalesce())
+    {
+        return false;
+    }
+    NS_LOG_LOGIC("ACK " << ackNumber << " waits " << m_ackCoalescingDelay.As(Time::S));
+    m_coalescedAck = packet;
+    m_coalescedAckFrom = fromAddress;
+    m_coalescedAckTo = toAddress;
+    m_coalescedAckTime = Simulator::Now();
+    m_ackCoalescingEvent =
+        Simulator::Schedule(m_ackCoalescingDelay, &TcpSocketBase::FlushCoalescedAck, this);
+    return true;
+}
+
+void
+TcpSocketBase::FlushCoalescedAck()
+{
+    NS_LOG_FUNCTION(this);
+    m_ackCoalescingEvent.Cancel();
+    if (m_coalescedAck)
+    {
+        Ptr<Packet> packet = m_coalescedAck;
+        m_coalescedAck = nullptr;
+        // The RTT is sampled at the arrival of the ACK, not when it is processed
+        m_ackHoldTime = Simulator::Now() - m_coalescedAckTime;
+        DoForwardUp(packet, m_coalescedAckFrom, m_coalescedAckTo);
+        m_ackHoldTime = Time(0);
+    }
+}
+
 /* Received a packet upon ESTABLISHED state. This function is mimicking the
     role of tcp_rcv_established() in tcp_input.c in Linux kernel. */
 void
@@ -3189,12 +3283,27 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     NS_LOG_FUNCTION(this << seq << maxSize << withAck);
 
     bool isStartOfTransmission = BytesInFlight() == 0U;
-    TcpTxItem* outItem = m_txBuffer->CopyFromSequence(maxSize, seq);
+    bool isSuperSegment = m_gsoMaxSegments > 1 && maxSize > m_tcb->m_segmentSize;
+    TcpTxItem* outItem =
+        m_txBuffer->CopyFromSequence(isSuperSegment ? m_tcb->m_segmentSize : maxSize, seq);
 
     m_rateOps->SkbSent(outItem, isStartOfTransmission);
 
     bool isRetransmission = outItem->IsRetrans();
     Ptr<Packet> p = outItem->GetPacketCopy();
+
+    // A super-segment is made of one item of the Tx buffer per segment, as if
+    // the segments had been sent one by one, so that SACK and loss recovery
+    // still work on wire segments
+    while (isSuperSegment && p->GetSize() < maxSize &&
+           m_txBuffer->SizeFromSequence(seq + SequenceNumber32(p->GetSize())) > 0)
+    {
+        outItem = m_txBuffer->CopyFromSequence(std::min(maxSize - p->GetSize(),
+                                                        m_tcb->m_segmentSize),
+                                               seq + SequenceNumber32(p->GetSize()));
+        m_rateOps->SkbSent(outItem, false);
+        p->AddAtEnd(outItem->GetPacketCopy());
+    }
     uint32_t sz = p->GetSize(); // Size of packet
     uint8_t flags = withAck ? TcpHeader::ACK : 0;
     uint32_t remainingData = m_txBuffer->SizeFromSequence(seq + SequenceNumber32(sz));
@@ -3287,6 +3396,7 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     m_txTrace(p, header, this);
     if (isRetransmission)
     {
+        m_totalRetrans++;
         if (m_endPoint)
         {
             m_retransmissionTrace(p,
@@ -3311,7 +3421,8 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
                           header,
                           m_endPoint->GetLocalAddress(),
                           m_endPoint->GetPeerAddress(),
-                          m_boundnetdevice);
+                          m_boundnetdevice,
+                          isSuperSegment ? m_tcb->m_segmentSize : 0);
         NS_LOG_DEBUG("Send segment of size "
                      << sz << " with remaining data " << remainingData << " via TcpL4Protocol to "
                      << m_endPoint->GetPeerAddress() << ". Header " << header);
@@ -3322,7 +3433,8 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
                           header,
                           m_endPoint6->GetLocalAddress(),
                           m_endPoint6->GetPeerAddress(),
-                          m_boundnetdevice);
+                          m_boundnetdevice,
+                          isSuperSegment ? m_tcb->m_segmentSize : 0);
         NS_LOG_DEBUG("Send segment of size "
                      << sz << " with remaining data " << remainingData << " via TcpL4Protocol to "
                      << m_endPoint6->GetPeerAddress() << ". Header " << header);
@@ -3468,6 +3580,16 @@ TcpSocketBase::SendPendingData(bool withAck)
             // NextSeg () may have further constrained the segment size
             auto maxSizeToSend = static_cast<uint32_t>(nextHigh - next);
             s = std::min(s, maxSizeToSend);
+            // With segmentation offload, the full segments of new data allowed
+            // by the window are sent at once, as a single super-segment
+            if (m_gsoMaxSegments > 1 && !IsPacingEnabled() && s == m_tcb->m_segmentSize &&
+                next >= m_tcb->m_highTxMark)
+            {
+                // the super-segment must fit an IP datagram, with the largest
+                // IP and TCP headers (60 bytes each)
+                uint32_t segments = std::min({availableWindow, availableData, 65535U - 120}) / s;
+                s *= std::clamp(segments, 1U, m_gsoMaxSegments);
+            }
 
             // (C.2) If any of the data octets sent in (C.1) are below HighData,
             //       HighRxt MUST be set to the highest sequence number of the
@@ -3734,8 +3856,8 @@ TcpSocketBase::CalculateRttSample(const TcpHeader& tcpHeader, const RttHistory&
         {
             Ptr<const TcpOptionTS> ts;
             ts = DynamicCast<const TcpOptionTS>(tcpHeader.GetOption(TcpOption::TS));
-            rtt = TcpOptionTS::ElapsedTimeFromTsValue(ts->GetEcho());
-            if (rtt.IsZero())
+            rtt = TcpOptionTS::ElapsedTimeFromTsValue(ts->GetEcho()) - m_ackHoldTime;
+            if (!rtt.IsStrictlyPositive())
             {
                 NS_LOG_LOGIC("TcpSocketBase::EstimateRtt - RTT calculated from TcpOption::TS "
                              "is zero, approximating to 1us.");
@@ -3746,7 +3868,7 @@ TcpSocketBase::CalculateRttSample(const TcpHeader& tcpHeader, const RttHistory&
         else if (!rttHistory.retx)
         {
             // Elapsed time since the packet was transmitted
-            rtt = Simulator::Now() - rttHistory.time;
+            rtt = Simulator::Now() - m_ackHoldTime - rttHistory.time;
         }
     }
     return rtt;
@@ -4127,6 +4249,8 @@ TcpSocketBase::CancelAllTimers()
     m_timewaitEvent.Cancel();
     m_sendPendingDataEvent.Cancel();
     m_pacingTimer.Cancel();
+    m_ackCoalescingEvent.Cancel();
+    m_coalescedAck = nullptr;
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -4581,6 +4705,35 @@ TcpSocketBase::GetRxBuffer() const
     return m_tcb->m_rxBuffer;
 }
 
+TcpInfo
+TcpSocketBase::GetTcpInfo() const
+{
+    TcpInfo info;
+    info.state = m_state;
+    info.congState = m_tcb->m_congState;
+    info.ecnState = m_tcb->m_ecnState;
+    info.segmentSize = m_tcb->m_segmentSize;
+    info.cWnd = m_tcb->m_cWnd;
+    info.ssThresh = m_tcb->m_ssThresh;
+    info.bytesInFlight = m_tcb->m_bytesInFlight;
+    info.rWnd = m_rWnd;
+    info.sacked = m_txBuffer->GetSacked();
+    info.lost = m_txBuffer->GetLost();
+    info.retransOut = m_txBuffer->GetRetransmitsCount();
+    info.totalRetrans = m_totalRetrans;
+    info.delivered = m_rateOps->GetConnectionRate().m_delivered;
+    info.lastRtt = m_tcb->m_lastRtt;
+    info.srtt = m_tcb->m_srtt;
+    if (m_rtt)
+    {
+        info.rttVar = m_rtt->GetVariation();
+    }
+    info.minRtt = m_tcb->m_minRtt;
+    info.rto = m_rto;
+    info.pacingRate = m_tcb->m_pacingRate;
+    return info;
+}
+
 void
 TcpSocketBase::SetRetxThresh(uint32_t retxThresh)
 {
@@ -69,6 +69,41 @@ class RttHistory
     bool retx;            //!< True if this has been retransmitted
 };
 
+/**
+ * \ingroup tcp
+ *
+ * \brief A snapshot of the state of a TCP socket, similar to the tcp_info
+ * structure of Linux
+ *
+ * The snapshot is filled on demand by TcpSocketBase::GetTcpInfo, so that the
+ * state of many sockets can be sampled periodically without connecting to the
+ * trace sources of each socket.
+ */
+struct TcpInfo
+{
+    TcpSocket::TcpStates_t state{TcpSocket::CLOSED};                   //!< TCP state
+    TcpSocketState::TcpCongState_t congState{TcpSocketState::CA_OPEN}; //!< Congestion state
+    TcpSocketState::EcnState_t ecnState{TcpSocketState::ECN_DISABLED}; //!< ECN state
+
+    uint32_t segmentSize{0};   //!< Segment size, in bytes
+    uint32_t cWnd{0};          //!< Congestion window, in bytes
+    uint32_t ssThresh{0};      //!< Slow start threshold, in bytes
+    uint32_t bytesInFlight{0}; //!< Bytes in flight
+    uint32_t rWnd{0};          //!< Receiver window of the peer, in bytes
+    uint32_t sacked{0};        //!< Bytes SACKed and not cumulatively ACKed
+    uint32_t lost{0};          //!< Bytes considered lost
+    uint32_t retransOut{0};    //!< Bytes retransmitted and not yet ACKed
+    uint32_t totalRetrans{0};  //!< Segments retransmitted since the connection started
+    uint64_t delivered{0};     //!< Bytes delivered to the peer, including the SACKed ones
+
+    Time lastRtt;             //!< RTT of the last (S)ACKed segment
+    Time srtt;                //!< Smoothed RTT
+    Time rttVar;              //!< RTT variation estimated by the RTT estimator
+    Time minRtt{Time::Max()}; //!< Minimum RTT, or Time::Max () without RTT samples
+    Time rto;                 //!< Retransmission timeout
+    DataRate pacingRate;      //!< Pacing rate
+};
+
 /**
  * \ingroup socket
  * \ingroup tcp
@@ -204,6 +239,39 @@ class RttHistory
  * you need more information. The reference paper is
  * https://dl.acm.org/citation.cfm?id=3067666.
  *
+ * Segmentation offload
+ * --------------------
+ *
+ * With the attribute "GsoMaxSegments" greater than 1, and pacing disabled, the
+ * full segments of new data allowed by the window are sent at once, as a single
+ * super-segment, like with the TSO/GSO of the Linux kernel. The Tx buffer still
+ * holds one item per segment. The super-segment, tagged with a GsoTag, goes
+ * through TcpL4Protocol and the IP layer (routing, ARP/NDISC, IP traces) as a
+ * single packet, and it is split into wire segments when it is handed to the
+ * traffic control layer of the outgoing device (see QueueDiscItem::Segment):
+ * the queue discs, the devices and the receiver see the same segments as
+ * without segmentation offload, while the socket and the IP layer process one
+ * packet per super-segment. Round-trip time samples are taken per
+ * super-segment, as in Linux. As a consequence, the IP-level traces (and the
+ * FlowMonitor) see the super-segments, and the super-segments delivered
+ * locally (e.g., through a loopback device) are not split. The super-segments
+ * whose wire segments do not fit the MTU of the outgoing device are fragmented
+ * by the IP layer.
+ *
+ * ACK coalescing
+ * --------------
+ *
+ * With the attribute "AckCoalescing" enabled, the pure ACKs acknowledging new
+ * data are not processed on arrival: the socket waits "AckCoalescingDelay"
+ * (0 by default, i.e., the end of the current time step) for further ACKs,
+ * and processes only the last one, as a single cumulative ACK, like the GRO of
+ * the Linux kernel. The congestion control and the rate sampling see the
+ * acknowledged segments through the segmentsAcked argument of PktsAcked and
+ * the delivered data, as with stretch ACKs; the ACKs carrying SACK blocks or
+ * data, the duplicate ACKs and the ACKs with different ECN flags are never
+ * coalesced, so that the loss recovery and the ECN feedback are unchanged.
+ * Only the last ACK of a burst is traced through "Rx" and gives an RTT sample.
+ *
  */
 class TcpSocketBase : public TcpSocket
 {
@@ -315,6 +383,16 @@ class TcpSocketBase : public TcpSocket
      */
     Ptr<TcpRxBuffer> GetRxBuffer() const;
 
+    /**
+     * \brief Get a snapshot of the state of the socket
+     *
+     * The snapshot is built from the socket state, the Tx buffer and the RTT
+     * estimator when called, hence it does not cost anything between calls.
+     *
+     * \return the snapshot of the state of the socket
+     */
+    TcpInfo GetTcpInfo() const;
+
     /**
      * \brief Set the retransmission threshold (dup ack threshold for a fast retransmit)
      * \param retxThresh the threshold
@@ -808,6 +886,28 @@ class TcpSocketBase : public TcpSocket
                              const Address& fromAddress,
                              const Address& toAddress);
 
+    /**
+     * \brief Coalesce an incoming packet with the pending ACK, if both are
+     * pure ACKs of new data.
+     *
+     * If the packet cannot be coalesced, the pending ACK is processed first.
+     *
+     * \param packet the incoming packet
+     * \param fromAddress the address of the sender of packet
+     * \param toAddress the address of the receiver of packet
+     * \return true if the packet is kept as the pending ACK, false if it must
+     * be processed now
+     */
+    bool CoalesceAck(Ptr<Packet> packet, const Address& fromAddress, const Address& toAddress);
+
+    /**
+     * \brief Process the pending coalesced ACK, if any.
+     *
+     * The RTT is sampled at the arrival time of the ACK, not at the time it is
+     * processed.
+     */
+    void FlushCoalescedAck();
+
     /**
      * \brief Called by the L3 protocol when it received an ICMP packet to pass on to TCP.
      *
@@ -1363,6 +1463,7 @@ class TcpSocketBase : public TcpSocket
     uint32_t m_synRetries{0};    //!< Number of connection attempts
     uint32_t m_dataRetrCount{0}; //!< Count of remaining data retransmission attempts
     uint32_t m_dataRetries{0};   //!< Number of data retransmission attempts
+    uint32_t m_totalRetrans{0};  //!< Count of segments retransmitted
 
     // Timeouts
     TracedValue<Time> m_rto{Seconds(0.0)};   //!< Retransmit timeout
@@ -1430,6 +1531,19 @@ class TcpSocketBase : public TcpSocket
     uint32_t m_retxThresh{3};    //!< Fast Retransmit threshold
     bool m_limitedTx{true};      //!< perform limited transmit
 
+    // Segmentation offload
+    uint32_t m_gsoMaxSegments{1}; //!< Max number of segments of a super-segment
+
+    // ACK coalescing
+    bool m_ackCoalescing{false};         //!< Coalesce the pure ACKs received in a burst
+    Time m_ackCoalescingDelay{0};        //!< Time the first ACK of a burst waits for the others
+    EventId m_ackCoalescingEvent{};      //!< Event processing the pending coalesced ACK
+    Ptr<Packet> m_coalescedAck{nullptr}; //!< Last ACK of the burst, not processed yet
+    Address m_coalescedAckFrom;          //!< Address of the sender of the pending ACK
+    Address m_coalescedAckTo;            //!< Address of the receiver of the pending ACK
+    Time m_coalescedAckTime{0};          //!< Arrival time of the pending ACK
+    Time m_ackHoldTime{0};               //!< Time the ACK being processed was held
+
     // Transmission Control Block
     Ptr<TcpSocketState> m_tcb;                 //!< Congestion control information
     Ptr<TcpCongestionOps> m_congestionControl; //!< Congestion control
@@ -164,7 +164,9 @@ TcpTxBuffer::SetHeadSequence(const SequenceNumber32& seq)
     // if you change the head with data already sent, something bad will happen
     NS_ASSERT(m_sentList.empty());
     m_sackSeen = false;
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = SequenceNumber32(0);
+    m_lostFrontier = seq;
+    m_nextSegHint = seq;
 }
 
 bool
@@ -299,13 +301,13 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(!m_sentList.empty());
 
-    auto it = m_sentList.begin();
+    auto it = FindSentItem(seq);
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    if (it != m_sentList.end())
     {
         if ((*it)->m_startSeq == seq)
         {
@@ -329,7 +331,6 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
             {
                 s = std::min(s, (*it)->m_packet->GetSize());
             }
-            break;
         }
     }
 
@@ -344,6 +345,30 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     return item;
 }
 
+TcpTxBuffer::PacketList::const_iterator
+TcpTxBuffer::FindSentItem(const SequenceNumber32& seq) const
+{
+    NS_LOG_FUNCTION(this << seq);
+
+    // First item starting after seq; the item before it, if any, may contain seq
+    auto it = std::upper_bound(m_sentList.begin(),
+                               m_sentList.end(),
+                               seq,
+                               [](const SequenceNumber32& s, const TcpTxItem* item) {
+                                   return s < item->m_startSeq;
+                               });
+    if (it == m_sentList.begin())
+    {
+        return m_sentList.end();
+    }
+    --it;
+    if (seq < (*it)->m_startSeq + (*it)->m_packet->GetSize())
+    {
+        return it;
+    }
+    return m_sentList.end();
+}
+
 std::pair<TcpTxBuffer::PacketList::const_iterator, SequenceNumber32>
 TcpTxBuffer::FindHighestSacked() const
 {
@@ -428,11 +453,22 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     auto it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+    // The items of the sent list know their sequence number: skip the ones before seq
+    if (&list == &m_sentList)
+    {
+        auto found = FindSentItem(seq);
+        if (found != m_sentList.end())
+        {
+            it += found - m_sentList.begin();
+            beginOfCurrentPacket = (*it)->m_startSeq;
+        }
+    }
+
     while (it != list.end())
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(&list != &m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -589,6 +625,10 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
     // be updated in MarkTransmittedSegment.
     if (t1->m_retrans != t2->m_retrans)
     {
+        if (m_nextSegHint > t1->m_startSeq)
+        {
+            m_nextSegHint = t1->m_startSeq;
+        }
         if (t1->m_retrans)
         {
             auto self = const_cast<TcpTxBuffer*>(this);
@@ -640,9 +680,11 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    // Only the item containing the byte before ack can end at ack
+    auto it = FindSentItem(ack - 1);
+    if (it != m_sentList.end())
     {
-        TcpTxItem* item = it;
+        TcpTxItem* item = *it;
         Ptr<Packet> p = item->m_packet;
         if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
         {
@@ -755,10 +797,10 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
                                               << " this is the result: " << *this);
     }
 
-    if (m_highestSack.second <= m_firstByteSeq)
+    if (m_highestSack <= m_firstByteSeq)
     {
         m_sackSeen = false;
-        m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+        m_highestSack = SequenceNumber32(0);
     }
 
     NS_LOG_DEBUG("Discarded up to " << seq << " lost: " << m_lostOut << " retrans: " << m_retrans
@@ -779,15 +821,26 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
     {
-        auto item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
             return bytesSacked;
         }
 
+        // Only the items starting inside the block can be sacked: begin the
+        // walk from the first of them
+        auto item_it = std::lower_bound(m_sentList.begin(),
+                                        m_sentList.end(),
+                                        (*option_it).first,
+                                        [](const TcpTxItem* item, const SequenceNumber32& s) {
+                                            return item->m_startSeq < s;
+                                        });
+        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq + m_sentSize;
+        if (item_it != m_sentList.end())
+        {
+            beginOfCurrentPacket = (*item_it)->m_startSeq;
+        }
+
         while (item_it != m_sentList.end())
         {
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
@@ -819,17 +872,16 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                     m_sackedOut += (*item_it)->m_packet->GetSize();
                     bytesSacked += (*item_it)->m_packet->GetSize();
 
-                    if (m_highestSack.first == m_sentList.end() ||
-                        m_highestSack.second <= beginOfCurrentPacket + pktSize)
+                    if (!m_sackSeen || m_highestSack <= beginOfCurrentPacket + pktSize)
                     {
                         m_sackSeen = true;
-                        m_highestSack = std::make_pair(item_it, beginOfCurrentPacket);
+                        m_highestSack = beginOfCurrentPacket;
                     }
 
                     NS_LOG_INFO("Received block "
                                 << *option_it << ", checking sentList for block " << *(*item_it)
                                 << ", found in the sackboard, sacking, current highSack: "
-                                << m_highestSack.second);
+                                << m_highestSack);
 
                     if (!sackedCb.IsNull())
                     {
@@ -852,7 +904,7 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     if (bytesSacked > 0)
     {
-        NS_ASSERT_MSG(m_highestSack.first != m_sentList.end(), "Buffer status: " << *this);
+        NS_ASSERT_MSG(m_sackSeen, "Buffer status: " << *this);
         UpdateLostCount();
     }
 
@@ -868,45 +920,57 @@ void
 TcpTxBuffer::UpdateLostCount()
 {
     NS_LOG_FUNCTION(this);
-    uint32_t sacked = 0;
-    SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
-    if (m_highestSack.first == m_sentList.end())
+    NS_LOG_INFO("Status before the update: " << *this << ", highest SACK at " << m_highestSack);
+
+    auto highest = FindSentItem(m_highestSack);
+    if (!m_sackSeen || highest == m_sentList.end())
     {
-        NS_LOG_INFO("Status before the update: " << *this
-                                                 << ", will start from the latest sent item");
+        return;
     }
-    else
+
+    // Walk down from the highest sacked item, excluding the head, until
+    // dupAckThresh sacked items are found: the items below the last one
+    // found are lost, if they are not sacked.
+    std::size_t threshold = highest - m_sentList.begin() + 1;
+    uint32_t sacked = 0;
+    while (threshold > 1 && sacked < m_dupAckThresh)
     {
-        NS_LOG_INFO("Status before the update: " << *this << ", will start from item "
-                                                 << *(*m_highestSack.first));
+        --threshold;
+        if (m_sentList[threshold]->m_sacked)
+        {
+            sacked++;
+        }
     }
 
-    for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
+    if (sacked >= m_dupAckThresh)
     {
-        TcpTxItem* item = *it;
-        if (item->m_sacked)
+        TcpTxItem* item = *m_sentList.begin();
+        if (!item->m_lost)
         {
-            sacked++;
+            item->m_lost = true;
+            m_lostOut += item->m_packet->GetSize();
         }
 
-        if (sacked >= m_dupAckThresh)
+        // The items below m_lostFrontier have been marked by a previous update
+        std::size_t index = 1;
+        auto frontier = FindSentItem(m_lostFrontier);
+        if (frontier != m_sentList.end())
+        {
+            index = std::max<std::size_t>(index, frontier - m_sentList.begin());
+        }
+        for (; index < threshold; ++index)
         {
+            item = m_sentList[index];
             if (!item->m_sacked && !item->m_lost)
             {
                 item->m_lost = true;
                 m_lostOut += item->m_packet->GetSize();
             }
         }
-        beginOfCurrentPacket -= item->m_packet->GetSize();
-    }
-
-    if (sacked >= m_dupAckThresh)
-    {
-        TcpTxItem* item = *m_sentList.begin();
-        if (!item->m_lost)
+        SequenceNumber32 reached = m_sentList[threshold - 1]->m_startSeq;
+        if (reached > m_lostFrontier)
         {
-            item->m_lost = true;
-            m_lostOut += item->m_packet->GetSize();
+            m_lostFrontier = reached;
         }
     }
     NS_LOG_INFO("Status after the update: " << *this);
@@ -918,29 +982,24 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
 {
     NS_LOG_FUNCTION(this << seq);
 
-    if (seq >= m_highestSack.second)
+    if (seq >= m_highestSack)
     {
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    auto it = FindSentItem(seq);
+    if (it != m_sentList.end())
     {
-        // Search for the right iterator before calling IsLost()
-        if ((*it)->m_startSeq <= seq && seq < (*it)->m_startSeq + (*it)->m_packet->GetSize())
+        if ((*it)->m_lost)
         {
-            if ((*it)->m_lost)
-            {
-                NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
-                return true;
-            }
+            NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
+            return true;
+        }
 
-            if ((*it)->m_sacked)
-            {
-                NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
-                return false;
-            }
+        if ((*it)->m_sacked)
+        {
+            NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
+            return false;
         }
     }
 
@@ -968,16 +1027,35 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
     TcpTxItem* item;
     SequenceNumber32 seqPerRule3;
     bool isSeqPerRule3Valid = false;
-    SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
+    bool isHintValid = false;
 
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // The items below m_nextSegHint are retransmitted or sacked: skip them
+    auto it = m_sentList.begin();
+    if (m_nextSegHint > m_firstByteSeq)
+    {
+        it = FindSentItem(m_nextSegHint);
+    }
+
+    for (; it != m_sentList.end(); ++it)
     {
         item = *it;
+        SequenceNumber32 beginOfCurrentPkt = item->m_startSeq;
+
+        // Condition 1.b: no item above the highest SACK can match
+        if (m_sackSeen && beginOfCurrentPkt >= m_highestSack)
+        {
+            break;
+        }
 
         // Condition 1.a , 1.b , and 1.c
-        if (!item->m_retrans && !item->m_sacked &&
-            ((m_sackSeen && item->m_startSeq < m_highestSack.second) || !m_sackSeen))
+        if (!item->m_retrans && !item->m_sacked)
         {
+            if (!isHintValid)
+            {
+                isHintValid = true;
+                m_nextSegHint = beginOfCurrentPkt;
+            }
+
             if (item->m_lost)
             {
                 NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
@@ -985,16 +1063,25 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
                 *seqHigh = *seq + m_segmentSize;
                 return true;
             }
-            else if (seqPerRule3.GetValue() == 0 && isRecovery)
+            else if (!isSeqPerRule3Valid && isRecovery)
             {
                 NS_LOG_INFO("Saving for rule 3 the seq " << beginOfCurrentPkt);
                 isSeqPerRule3Valid = true;
                 seqPerRule3 = beginOfCurrentPkt;
             }
+
+            // Without lost items, only the item for rule 3 is needed
+            if (m_lostOut == 0 && (isSeqPerRule3Valid || !isRecovery))
+            {
+                break;
+            }
         }
+    }
 
-        // Nothing found, iterate
-        beginOfCurrentPkt += item->m_packet->GetSize();
+    if (!isHintValid)
+    {
+        m_nextSegHint =
+            it == m_sentList.end() ? m_firstByteSeq.Get() + m_sentSize : (*it)->m_startSeq;
     }
 
     /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1173,7 +1260,7 @@ TcpTxBuffer::IsLostRFC(const SequenceNumber32& seq, const PacketList::const_iter
             }
         }
 
-        if (beginOfCurrentPacket >= m_highestSack.second)
+        if (beginOfCurrentPacket >= m_highestSack)
         {
             if (item->m_lost && !item->m_retrans)
             {
@@ -1186,11 +1273,8 @@ TcpTxBuffer::IsLostRFC(const SequenceNumber32& seq, const PacketList::const_iter
 
         beginOfCurrentPacket += current->GetSize();
     }
-    if (it == m_highestSack.first)
-    {
-        NS_LOG_INFO("seq=" << seq << " is not lost because there are no sacked segment ahead "
-                           << m_highestSack.second);
-    }
+    NS_LOG_INFO("seq=" << seq << " is not lost because there are no sacked segment ahead "
+                       << m_highestSack);
     return false;
 }
 
@@ -1205,8 +1289,10 @@ TcpTxBuffer::ResetRenoSack()
         (*it)->m_sacked = false;
     }
 
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = SequenceNumber32(0);
     m_sackSeen = false;
+    m_lostFrontier = m_firstByteSeq;
+    m_nextSegHint = m_firstByteSeq;
 }
 
 void
@@ -1236,7 +1322,9 @@ TcpTxBuffer::ResetSentList()
     m_retrans = 0;
     m_sackedOut = 0;
     m_sackSeen = false;
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = SequenceNumber32(0);
+    m_lostFrontier = m_firstByteSeq;
+    m_nextSegHint = m_firstByteSeq;
 }
 
 void
@@ -1269,7 +1357,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
         m_sackedOut = 0;
         m_lostOut = m_sentSize;
         m_sackSeen = false;
-        m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+        m_highestSack = SequenceNumber32(0);
     }
     else
     {
@@ -1300,6 +1388,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
 
         (*it)->m_retrans = false;
     }
+    m_nextSegHint = m_firstByteSeq;
 
     NS_LOG_INFO("Set sent list lost, status: " << *this);
     NS_ASSERT_MSG(m_sentSize >= m_sackedOut + m_lostOut, *this);
@@ -1334,6 +1423,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead()
         m_sentList.front()->m_retrans = false;
         m_retrans -= m_sentList.front()->m_packet->GetSize();
     }
+    m_nextSegHint = m_firstByteSeq;
     ConsistencyCheck();
 }
 
@@ -1362,6 +1452,7 @@ TcpTxBuffer::MarkHeadAsLost()
             m_sentList.front()->m_lost = true;
             m_lostOut += m_sentList.front()->m_packet->GetSize();
         }
+        m_nextSegHint = m_firstByteSeq;
     }
     ConsistencyCheck();
 }
@@ -1397,7 +1488,7 @@ TcpTxBuffer::AddRenoSack()
         (*it)->m_sacked = true;
         m_sackedOut += (*it)->m_packet->GetSize();
         m_sackSeen = true;
-        m_highestSack = std::make_pair(it, (*it)->m_startSeq);
+        m_highestSack = (*it)->m_startSeq;
         NS_LOG_INFO("Added a Reno SACK, status: " << *this);
     }
     else
@@ -14,6 +14,7 @@
 #include "tcp-tx-item.h"
 
 #include "ns3/object.h"
+#include "ns3/ring-buffer.h"
 #include "ns3/sequence-number.h"
 #include "ns3/traced-value.h"
 
@@ -60,8 +61,18 @@ class Packet;
  * associated with every segment sent. This is done through the use of the
  * class TcpTxItem: instead of storing a list of packets, we store a list of
  * TcpTxItem. Each item has different flags (check the corresponding
- * documentation) and maintaining the scoreboard is a matter of travelling the
- * list and set the SACK flag on the corresponding segment sent.
+ * documentation) and maintaining the scoreboard is a matter of finding the
+ * segments covered by a SACK block and setting their SACK flag.
+ *
+ * Both lists are RingBuffer containers: the items of the SentList are stored
+ * in a contiguous array, sorted by sequence number, so that the item holding
+ * a given sequence number is found with a binary search instead of a walk
+ * from the head of the list. The lost segments are marked incrementally, from
+ * the point reached by the previous update (\see UpdateLostCount), and
+ * NextSeg starts its search after the segments which are already
+ * retransmitted or SACKed. The cost of processing an ACK is therefore
+ * logarithmic in the number of segments in flight, plus the number of
+ * segments whose flags change, instead of linear.
  *
  * Item properties
  * ---------------
@@ -400,7 +411,7 @@ class TcpTxBuffer : public Object
   private:
     friend std::ostream& operator<<(std::ostream& os, const TcpTxBuffer& tcpTxBuf);
 
-    typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+    typedef RingBuffer<TcpTxItem*> PacketList; //!< container for data stored in the buffer
 
     /**
      * \brief Update the lost count
@@ -417,8 +428,10 @@ class TcpTxBuffer : public Object
      * The {New}Reno cases, for now, are managed in TcpSocketBase through the
      * call to MarkHeadAsLost.
      * This function is, therefore, called after a SACK option has been received,
-     * and updates the lost count. It can be probably optimized by not walking
-     * the entire list, but a subset.
+     * and updates the lost count. Only the segments between the highest SACKed
+     * segment and the dupAckThresh-th SACKed segment below it are counted, and
+     * only the segments above the point reached by the previous update
+     * (m_lostFrontier) are marked as lost.
      *
      */
     void UpdateLostCount();
@@ -585,6 +598,18 @@ class TcpTxBuffer : public Object
      */
     void ConsistencyCheck() const;
 
+    /**
+     * \brief Find the item of the SentList which contains a sequence number
+     *
+     * The items of the SentList are contiguous and sorted by sequence number,
+     * so a binary search is performed.
+     *
+     * \param seq the sequence number
+     * \return an iterator to the item containing seq, or the end of the
+     * SentList if seq is not in the SentList
+     */
+    PacketList::const_iterator FindSentItem(const SequenceNumber32& seq) const;
+
     /**
      * \brief Find the highest SACK byte
      * \return a pair with the highest byte and an iterator inside m_sentList
@@ -600,7 +625,10 @@ class TcpTxBuffer : public Object
 
     TracedValue<SequenceNumber32>
         m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
-    std::pair<PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
+
+    SequenceNumber32 m_highestSack{0};         //!< Start of the highest SACKed segment, or 0
+    SequenceNumber32 m_lostFrontier{0};        //!< Non-SACKed segments below are marked lost
+    mutable SequenceNumber32 m_nextSegHint{0}; //!< Segments below are retransmitted or SACKed
 
     uint32_t m_lostOut{0};   //!< Number of lost bytes
     uint32_t m_sackedOut{0}; //!< Number of sacked bytes
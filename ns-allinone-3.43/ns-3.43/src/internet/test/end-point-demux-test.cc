@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief End point demux test: the end points whose peer is only partially
+ * specified (a peer address with any peer port, or any peer address with a
+ * peer port) are found by Lookup and SimpleLookup as by a scan of all the end
+ * points, and do not shadow the listening end point.
+ *
+ * \tparam Address the address type (Ipv4Address or Ipv6Address)
+ * \tparam Demux the demux type (Ipv4EndPointDemux or Ipv6EndPointDemux)
+ */
+template <typename Address, typename Demux>
+class EndPointDemuxTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param name the name of the test case
+     * \param local the address of the node
+     * \param peer the address of the peer
+     */
+    EndPointDemuxTestCase(const std::string& name, Address local, Address peer)
+        : TestCase(name),
+          m_local(local),
+          m_peer(peer)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    Address m_local; //!< Address of the node
+    Address m_peer;  //!< Address of the peer
+};
+
+template <typename Address, typename Demux>
+void
+EndPointDemuxTestCase<Address, Demux>::DoRun()
+{
+    const Address any = Address::GetAny();
+    Demux demux;
+
+    auto listening = demux.Allocate(nullptr, any, 80);
+    auto addressOnly = demux.Allocate(nullptr, any, 80, m_peer, 0);
+    auto portOnly = demux.Allocate(nullptr, any, 80, any, 1234);
+    NS_TEST_ASSERT_MSG_NE(listening, nullptr, "Listening end point not allocated");
+    NS_TEST_ASSERT_MSG_NE(addressOnly, nullptr, "End point with a peer address not allocated");
+    NS_TEST_ASSERT_MSG_NE(portOnly, nullptr, "End point with a peer port not allocated");
+
+    // The end points with a partially specified peer match neither exactly nor
+    // as wildcards: the packet goes to the listening end point
+    auto endPoints = demux.Lookup(m_local, 80, m_peer, 1234, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(endPoints.size(), 1, "Wrong number of end points");
+    NS_TEST_ASSERT_MSG_EQ(endPoints.front(), listening, "Wrong end point");
+
+    // With a null source port, the peer of the first end point matches exactly
+    endPoints = demux.Lookup(m_local, 80, m_peer, 0, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(endPoints.size(), 1, "Wrong number of end points");
+    NS_TEST_ASSERT_MSG_EQ(endPoints.front(), addressOnly, "Wrong end point");
+
+    // With a null source address, the peer of the second end point matches exactly
+    endPoints = demux.Lookup(m_local, 80, any, 1234, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(endPoints.size(), 1, "Wrong number of end points");
+    NS_TEST_ASSERT_MSG_EQ(endPoints.front(), portOnly, "Wrong end point");
+
+    // A connected end point takes precedence over all of them
+    auto connected = demux.Allocate(nullptr, m_local, 80, m_peer, 1234);
+    NS_TEST_ASSERT_MSG_NE(connected, nullptr, "Connected end point not allocated");
+    endPoints = demux.Lookup(m_local, 80, m_peer, 1234, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(endPoints.size(), 1, "Wrong number of end points");
+    NS_TEST_ASSERT_MSG_EQ(endPoints.front(), connected, "Wrong end point");
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(m_local, 80, m_peer, 1234),
+                          connected,
+                          "Wrong exact match");
+    demux.DeAllocate(connected);
+
+    // SimpleLookup returns the first of the least generic end points on the
+    // port: the end point with a peer address, then the listening end point
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(m_local, 80, m_peer, 1234),
+                          addressOnly,
+                          "Wrong generic match");
+    demux.DeAllocate(addressOnly);
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(m_local, 80, m_peer, 1234),
+                          listening,
+                          "Wrong generic match");
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(m_local, 81, m_peer, 1234),
+                          nullptr,
+                          "Match on a port without end points");
+
+    demux.DeAllocate(listening);
+    NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(m_local, 80, m_peer, 1234),
+                          portOnly,
+                          "Wrong generic match");
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(80), true, "Port not in use");
+    demux.DeAllocate(portOnly);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(80), false, "Port still in use");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief End point demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+  public:
+    EndPointDemuxTestSuite()
+        : TestSuite("end-point-demux", Type::UNIT)
+    {
+        AddTestCase(new EndPointDemuxTestCase<Ipv4Address, Ipv4EndPointDemux>(
+                        "IPv4 end points with a partially specified peer",
+                        Ipv4Address("10.0.0.1"),
+                        Ipv4Address("10.0.0.2")),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new EndPointDemuxTestCase<Ipv6Address, Ipv6EndPointDemux>(
+                        "IPv6 end points with a partially specified peer",
+                        Ipv6Address("2001::1"),
+                        Ipv6Address("2001::2")),
+                    TestCase::Duration::QUICK);
+    }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
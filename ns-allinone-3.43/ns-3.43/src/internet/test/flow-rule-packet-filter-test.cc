@@ -0,0 +1,281 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/flow-rule-packet-filter.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/ipv6-queue-disc-item.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-header.h"
+#include "ns3/test.h"
+#include "ns3/udp-header.h"
+
+#include <random>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Create an IPv4 queue disc item carrying a UDP or TCP header
+ *
+ * \param src the source address
+ * \param dst the destination address
+ * \param protocol the L4 protocol number (6 or 17)
+ * \param srcPort the source port
+ * \param dstPort the destination port
+ * \param tos the type of service
+ * \return the queue disc item
+ */
+static Ptr<Ipv4QueueDiscItem>
+CreateIpv4Item(Ipv4Address src,
+               Ipv4Address dst,
+               uint8_t protocol,
+               uint16_t srcPort,
+               uint16_t dstPort,
+               uint8_t tos = 0)
+{
+    Ptr<Packet> p = Create<Packet>(100);
+    if (protocol == 6)
+    {
+        TcpHeader tcpHdr;
+        tcpHdr.SetSourcePort(srcPort);
+        tcpHdr.SetDestinationPort(dstPort);
+        p->AddHeader(tcpHdr);
+    }
+    else
+    {
+        UdpHeader udpHdr;
+        udpHdr.SetSourcePort(srcPort);
+        udpHdr.SetDestinationPort(dstPort);
+        p->AddHeader(udpHdr);
+    }
+    Ipv4Header hdr;
+    hdr.SetSource(src);
+    hdr.SetDestination(dst);
+    hdr.SetProtocol(protocol);
+    hdr.SetTos(tos);
+    hdr.SetPayloadSize(p->GetSize());
+    return Create<Ipv4QueueDiscItem>(p, Address(), 0x0800, hdr);
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Flow rule packet filter test case: the first matching rule classifies
+ * the packets, the cached flow descriptor follows the ECN marking, and IPv4
+ * rules do not match IPv6 packets.
+ */
+class FlowRulePacketFilterTestCase : public TestCase
+{
+  public:
+    FlowRulePacketFilterTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FlowRulePacketFilterTestCase::FlowRulePacketFilterTestCase()
+    : TestCase("Sanity check on the flow rule packet filter")
+{
+}
+
+void
+FlowRulePacketFilterTestCase::DoRun()
+{
+    using Rule = FlowRulePacketFilter::Rule;
+
+    Ptr<FlowRulePacketFilter> filter = CreateObject<FlowRulePacketFilter>();
+    filter->AddRule(Rule().SetProtocol(6).SetDestinationPort(80), 1);
+    filter->AddRule(Rule().SetSource(Ipv4Address("10.1.0.0"), Ipv4Mask("/16")), 2);
+    filter->AddRule(Rule().SetDscp(Ipv4Header::DSCP_EF), 3);
+    filter->AddRule(Rule()
+                        .SetSource(Ipv4Address("10.1.1.1"))
+                        .SetDestination(Ipv4Address("10.2.2.2"))
+                        .SetProtocol(17)
+                        .SetSourcePort(5000)
+                        .SetDestinationPort(6000),
+                    4);
+    filter->AddRule(Rule()
+                        .SetSource(Ipv4Address("10.3.1.1"))
+                        .SetDestination(Ipv4Address("10.2.2.2"))
+                        .SetProtocol(17)
+                        .SetSourcePort(5000)
+                        .SetDestinationPort(6000),
+                    5);
+    filter->AddRule(Rule().SetEcn(Ipv4Header::ECN_CE), 6);
+    filter->AddRule(Rule().SetSource(Ipv6Address("2001:db8::"), Ipv6Prefix(32)), 7);
+    NS_TEST_ASSERT_MSG_EQ(filter->GetNRules(), 7, "Wrong number of rules");
+
+    Ipv4Address a("10.1.1.1");
+    Ipv4Address b("10.2.2.2");
+    Ipv4Address c("10.3.1.1");
+
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(CreateIpv4Item(c, b, 6, 1234, 80)),
+                          1,
+                          "The packet should match the TCP port rule");
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(CreateIpv4Item(a, b, 6, 1234, 80)),
+                          1,
+                          "The first matching rule must classify the packet");
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(CreateIpv4Item(a, b, 17, 1234, 80)),
+                          2,
+                          "The packet should match the source prefix rule");
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(CreateIpv4Item(a, b, 17, 5000, 6000)),
+                          2,
+                          "The source prefix rule precedes the 5-tuple rule");
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(CreateIpv4Item(c, b, 17, 5000, 6000, 0xb8)),
+                          3,
+                          "The DSCP rule precedes the 5-tuple rule");
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(CreateIpv4Item(c, b, 17, 5000, 6000)),
+                          5,
+                          "The packet should match the 5-tuple rule");
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(CreateIpv4Item(c, b, 17, 5000, 6001)),
+                          PacketFilter::PF_NO_MATCH,
+                          "The packet should not match any rule");
+
+    // the flow descriptor is parsed again after the packet is marked
+    Ptr<Ipv4QueueDiscItem> item = CreateIpv4Item(c, b, 17, 5000, 6001, Ipv4Header::ECN_ECT0);
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(item),
+                          PacketFilter::PF_NO_MATCH,
+                          "The packet should not match any rule");
+    NS_TEST_ASSERT_MSG_EQ(item->Mark(), true, "The packet should be marked");
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(item), 6, "The packet should match the ECN rule");
+
+    // IPv6 packets only match the IPv6 rules and the rules without addresses
+    Ipv6Header hdr;
+    hdr.SetSource(Ipv6Address("2001:db8::1"));
+    hdr.SetDestination(Ipv6Address("2001:db9::1"));
+    hdr.SetNextHeader(17);
+    UdpHeader udpHdr;
+    udpHdr.SetSourcePort(1234);
+    udpHdr.SetDestinationPort(80);
+    Ptr<Packet> p = Create<Packet>(100);
+    p->AddHeader(udpHdr);
+    hdr.SetPayloadLength(p->GetSize());
+    Ptr<Ipv6QueueDiscItem> item6 = Create<Ipv6QueueDiscItem>(p, Address(), 0x86DD, hdr);
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(item6), 7, "The packet should match the IPv6 rule");
+    hdr.SetSource(Ipv6Address("2001:db9::1"));
+    hdr.SetDscp(Ipv6Header::DSCP_EF);
+    item6 = Create<Ipv6QueueDiscItem>(p, Address(), 0x86DD, hdr);
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(item6), 3, "The packet should match the DSCP rule");
+    hdr.SetDscp(Ipv6Header::DscpDefault);
+    item6 = Create<Ipv6QueueDiscItem>(p, Address(), 0x86DD, hdr);
+    NS_TEST_ASSERT_MSG_EQ(filter->Classify(item6),
+                          PacketFilter::PF_NO_MATCH,
+                          "The packet should not match any rule");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Flow rule packet filter test case: on random rules and packets, the
+ * filter returns the value of the first matching rule, as found by evaluating
+ * every rule in turn.
+ */
+class FlowRulePacketFilterRandomTestCase : public TestCase
+{
+  public:
+    FlowRulePacketFilterRandomTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FlowRulePacketFilterRandomTestCase::FlowRulePacketFilterRandomTestCase()
+    : TestCase("Check the flow rule packet filter against a sequential evaluation of the rules")
+{
+}
+
+void
+FlowRulePacketFilterRandomTestCase::DoRun()
+{
+    /// The fields of a rule, 0 meaning any value
+    struct RuleFields
+    {
+        uint32_t srcNet;  //!< the source /24 prefix
+        uint8_t protocol; //!< the L4 protocol
+        uint16_t dstPort; //!< the destination port
+        uint8_t tos;      //!< the type of service
+    };
+
+    std::mt19937 rng(1);
+    auto draw = [&rng](uint32_t n) -> uint32_t { return rng() % n; };
+
+    Ptr<FlowRulePacketFilter> filter = CreateObject<FlowRulePacketFilter>();
+    std::vector<RuleFields> rules;
+    for (int32_t i = 0; i < 200; i++)
+    {
+        RuleFields r{draw(2) ? 0x0a000000 + (draw(8) << 8) : 0,
+                     static_cast<uint8_t>(draw(2) ? (draw(2) ? 6 : 17) : 0),
+                     static_cast<uint16_t>(draw(2) ? 1 + draw(8) : 0),
+                     static_cast<uint8_t>(draw(4) ? 0 : (1 + draw(3)) << 2)};
+        FlowRulePacketFilter::Rule rule;
+        if (r.srcNet)
+        {
+            rule.SetSource(Ipv4Address(r.srcNet), Ipv4Mask("/24"));
+        }
+        if (r.protocol)
+        {
+            rule.SetProtocol(r.protocol);
+        }
+        if (r.dstPort)
+        {
+            rule.SetDestinationPort(r.dstPort);
+        }
+        if (r.tos)
+        {
+            rule.SetDscp(r.tos >> 2);
+        }
+        filter->AddRule(rule, i);
+        rules.push_back(r);
+    }
+
+    for (uint32_t n = 0; n < 2000; n++)
+    {
+        uint32_t src = 0x0a000000 + (draw(10) << 8) + draw(4);
+        uint8_t protocol = draw(2) ? 6 : 17;
+        uint16_t dstPort = 1 + draw(10);
+        uint8_t tos = draw(4) << 2;
+
+        int32_t expected = PacketFilter::PF_NO_MATCH;
+        for (uint32_t i = 0; i < rules.size(); i++)
+        {
+            const RuleFields& r = rules[i];
+            if ((!r.srcNet || r.srcNet == (src & 0xffffff00)) &&
+                (!r.protocol || r.protocol == protocol) && (!r.dstPort || r.dstPort == dstPort) &&
+                (!r.tos || r.tos == tos))
+            {
+                expected = i;
+                break;
+            }
+        }
+        Ptr<Ipv4QueueDiscItem> item = CreateIpv4Item(Ipv4Address(src),
+                                                     Ipv4Address("10.255.0.1"),
+                                                     protocol,
+                                                     1024,
+                                                     dstPort,
+                                                     tos);
+        NS_TEST_ASSERT_MSG_EQ(filter->Classify(item), expected, "Wrong rule for packet " << n);
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Flow rule packet filter test suite
+ */
+static class FlowRulePacketFilterTestSuite : public TestSuite
+{
+  public:
+    FlowRulePacketFilterTestSuite()
+        : TestSuite("flow-rule-packet-filter", Type::UNIT)
+    {
+        AddTestCase(new FlowRulePacketFilterTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new FlowRulePacketFilterRandomTestCase(), TestCase::Duration::QUICK);
+    }
+} g_flowRulePacketFilterTestSuite; ///< the test suite
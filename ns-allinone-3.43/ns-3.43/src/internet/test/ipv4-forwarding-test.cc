@@ -13,6 +13,7 @@
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv4-routing-helper.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-static-routing.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
@@ -39,6 +40,8 @@ using namespace ns3;
 class Ipv4ForwardingTest : public TestCase
 {
     Ptr<Packet> m_receivedPacket; //!< Received packet
+    bool m_routeCache;            //!< Enable the route cache of the forwarding node
+    uint32_t m_cacheHits;         //!< Packets forwarded through the route cache
 
     /**
      * \brief Send data.
@@ -55,18 +58,42 @@ class Ipv4ForwardingTest : public TestCase
 
   public:
     void DoRun() override;
-    Ipv4ForwardingTest();
+
+    /**
+     * Constructor.
+     * \param routeCache Enable the route cache of the forwarding node.
+     */
+    Ipv4ForwardingTest(bool routeCache);
 
     /**
      * \brief Receive data.
      * \param socket The receiving socket.
      */
     void ReceivePkt(Ptr<Socket> socket);
+
+    /**
+     * \brief Count the packets forwarded through the route cache.
+     * \param header The IPv4 header of the packet.
+     * \param packet The packet.
+     * \param interface The input interface.
+     */
+    void RouteCacheHit(const Ipv4Header& header, Ptr<const Packet> packet, uint32_t interface);
 };
 
-Ipv4ForwardingTest::Ipv4ForwardingTest()
-    : TestCase("UDP socket implementation")
+Ipv4ForwardingTest::Ipv4ForwardingTest(bool routeCache)
+    : TestCase(routeCache ? "UDP socket implementation with route cache"
+                          : "UDP socket implementation"),
+      m_routeCache(routeCache),
+      m_cacheHits(0)
+{
+}
+
+void
+Ipv4ForwardingTest::RouteCacheHit(const Ipv4Header& header,
+                                  Ptr<const Packet> packet,
+                                  uint32_t interface)
 {
+    m_cacheHits++;
 }
 
 void
@@ -129,6 +156,11 @@ Ipv4ForwardingTest::DoRun()
     Ptr<Node> fwNode = CreateObject<Node>();
 
     internet.Install(fwNode);
+    fwNode->GetObject<Ipv4L3Protocol>()->SetAttribute("EnableRouteCache",
+                                                      BooleanValue(m_routeCache));
+    fwNode->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+        "RouteCacheHit",
+        MakeCallback(&Ipv4ForwardingTest::RouteCacheHit, this));
     Ptr<SimpleNetDevice> fwDev1;
     Ptr<SimpleNetDevice> fwDev2;
     { // first interface
@@ -201,10 +233,48 @@ Ipv4ForwardingTest::DoRun()
     // Unicast test
     SendData(txSocket, "10.0.0.2");
     NS_TEST_EXPECT_MSG_EQ(m_receivedPacket->GetSize(), 123, "IPv4 Forwarding on");
+    NS_TEST_EXPECT_MSG_EQ(m_cacheHits, 0, "The first packet is routed by the routing protocol");
 
     m_receivedPacket->RemoveAllByteTags();
     m_receivedPacket = nullptr;
 
+    // Same destination, through the route cache if it is enabled
+    SendData(txSocket, "10.0.0.2");
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPacket->GetSize(), 123, "IPv4 Forwarding on (second packet)");
+    NS_TEST_EXPECT_MSG_EQ(m_cacheHits,
+                          (m_routeCache ? 1 : 0),
+                          "The second packet is forwarded through the route cache");
+
+    // A new route towards an unreachable gateway must take effect at once
+    Ptr<Ipv4StaticRouting> fwStaticRouting = Ipv4RoutingHelper::GetRouting<Ipv4StaticRouting>(
+        fwNode->GetObject<Ipv4>()->GetRoutingProtocol());
+    fwStaticRouting->AddHostRouteTo(Ipv4Address("10.0.0.2"), Ipv4Address("10.1.0.99"), 2);
+    SendData(txSocket, "10.0.0.2");
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPacket->GetSize(), 0, "IPv4 Forwarding with a new route");
+    NS_TEST_EXPECT_MSG_EQ(m_cacheHits,
+                          (m_routeCache ? 1 : 0),
+                          "The new route flushes the route cache");
+
+    for (uint32_t i = 0; i < fwStaticRouting->GetNRoutes(); i++)
+    {
+        if (fwStaticRouting->GetRoute(i).GetGateway() == Ipv4Address("10.1.0.99"))
+        {
+            fwStaticRouting->RemoveRoute(i);
+            break;
+        }
+    }
+    SendData(txSocket, "10.0.0.2");
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPacket->GetSize(), 123, "IPv4 Forwarding with the old route");
+    NS_TEST_EXPECT_MSG_EQ(m_cacheHits,
+                          (m_routeCache ? 1 : 0),
+                          "The removed route flushes the route cache");
+
+    SendData(txSocket, "10.0.0.2");
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPacket->GetSize(), 123, "IPv4 Forwarding with the old route");
+    NS_TEST_EXPECT_MSG_EQ(m_cacheHits,
+                          (m_routeCache ? 2 : 0),
+                          "The old route is cached again");
+
     Ptr<Ipv4> ipv4 = fwNode->GetObject<Ipv4>();
     ipv4->SetAttribute("IpForward", BooleanValue(false));
     SendData(txSocket, "10.0.0.2");
@@ -229,7 +299,8 @@ class Ipv4ForwardingTestSuite : public TestSuite
 Ipv4ForwardingTestSuite::Ipv4ForwardingTestSuite()
     : TestSuite("ipv4-forwarding", Type::UNIT)
 {
-    AddTestCase(new Ipv4ForwardingTest, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4ForwardingTest(false), TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4ForwardingTest(true), TestCase::Duration::QUICK);
 }
 
 static Ipv4ForwardingTestSuite
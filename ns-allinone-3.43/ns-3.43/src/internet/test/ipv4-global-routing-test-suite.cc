@@ -5,6 +5,8 @@
 #include "ns3/boolean.h"
 #include "ns3/bridge-helper.h"
 #include "ns3/config.h"
+#include "ns3/global-route-manager-impl.h"
+#include "ns3/global-route-manager.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -23,6 +25,7 @@
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simple-net-device.h"
+#include "ns3/simulation-singleton.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
 #include "ns3/string.h"
@@ -30,6 +33,7 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <sstream>
 #include <vector>
 
 using namespace ns3;
@@ -1300,6 +1304,178 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting incremental recomputation test
+ *
+ * Six routers form a ring (hence equal cost paths between the opposite
+ * routers), a seventh router is attached to the first one by a stub link, an
+ * eighth router shares a LAN with the third and the fourth ones and the second
+ * router has a stub network. After each
+ * change of the interfaces (or of their metric), the routes computed by
+ * RecomputeRoutingTables must be those of a full computation.
+ */
+class Ipv4GlobalRoutingIncrementalTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingIncrementalTestCase();
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+
+    /**
+     * \brief Get the global routing tables of all the nodes
+     * \return the routing table of each node, one route per line
+     */
+    std::vector<std::string> GetRoutes() const;
+
+    /**
+     * \brief Recompute the routes and check them against a full computation
+     * \param change the description of the last change
+     * \param maxSpf the maximum number of SPF calculations expected
+     */
+    void CheckRecompute(const std::string& change, uint32_t maxSpf);
+
+    NodeContainer m_nodes; //!< Nodes used in the test.
+};
+
+Ipv4GlobalRoutingIncrementalTestCase::Ipv4GlobalRoutingIncrementalTestCase()
+    : TestCase("Global routing incremental recomputation")
+{
+}
+
+void
+Ipv4GlobalRoutingIncrementalTestCase::DoSetup()
+{
+    m_nodes.Create(8);
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.252");
+    std::vector<std::pair<uint32_t, uint32_t>> links = {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5},
+                                                        {5, 0}, {0, 6}};
+    for (const auto& [a, b] : links)
+    {
+        Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+        NetDeviceContainer net = simpleHelper.Install(m_nodes.Get(a), channel);
+        net.Add(simpleHelper.Install(m_nodes.Get(b), channel));
+        ipv4.Assign(net);
+        ipv4.NewNetwork();
+    }
+
+    SimpleNetDeviceHelper lanHelper;
+    NetDeviceContainer lan = lanHelper.Install(
+        NodeContainer(m_nodes.Get(2), m_nodes.Get(3), m_nodes.Get(7)));
+    ipv4.SetBase("10.2.1.0", "255.255.255.0");
+    ipv4.Assign(lan);
+
+    NetDeviceContainer stub = lanHelper.Install(m_nodes.Get(1));
+    ipv4.SetBase("10.3.1.0", "255.255.255.0");
+    ipv4.Assign(stub);
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingIncrementalTestCase::GetRoutes() const
+{
+    std::vector<std::string> routes;
+    for (auto it = m_nodes.Begin(); it != m_nodes.End(); it++)
+    {
+        Ptr<Ipv4RoutingProtocol> routing = (*it)->GetObject<Ipv4L3Protocol>()->GetRoutingProtocol();
+        Ptr<Ipv4GlobalRouting> globalRouting = routing->GetObject<Ipv4GlobalRouting>();
+        std::ostringstream oss;
+        for (uint32_t i = 0; i < globalRouting->GetNRoutes(); i++)
+        {
+            oss << *globalRouting->GetRoute(i) << std::endl;
+        }
+        routes.push_back(oss.str());
+    }
+    return routes;
+}
+
+void
+Ipv4GlobalRoutingIncrementalTestCase::CheckRecompute(const std::string& change, uint32_t maxSpf)
+{
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    uint32_t nSpf = SimulationSingleton<GlobalRouteManagerImpl>::Get()->GetNSpfCalculations();
+    std::vector<std::string> routes = GetRoutes();
+
+    GlobalRouteManager::DeleteGlobalRoutes();
+    GlobalRouteManager::BuildGlobalRoutingDatabase();
+    GlobalRouteManager::InitializeRoutes();
+    std::vector<std::string> expected = GetRoutes();
+
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(routes[i],
+                              expected[i],
+                              "Wrong routes of node " << i << " after " << change);
+    }
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(nSpf,
+                                maxSpf,
+                                "Too many SPF calculations after " << change);
+}
+
+void
+Ipv4GlobalRoutingIncrementalTestCase::DoRun()
+{
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ(SimulationSingleton<GlobalRouteManagerImpl>::Get()->GetNSpfCalculations(),
+                          m_nodes.GetN() - 1,
+                          "Every router but the stub one runs the SPF calculation");
+
+    Ptr<Ipv4> ip0 = m_nodes.Get(0)->GetObject<Ipv4>();
+    Ptr<Ipv4> ip1 = m_nodes.Get(1)->GetObject<Ipv4>();
+    Ptr<Ipv4> ip2 = m_nodes.Get(2)->GetObject<Ipv4>();
+    Ptr<Ipv4> ip6 = m_nodes.Get(6)->GetObject<Ipv4>();
+
+    // Nothing changed: no SPF calculation
+    CheckRecompute("no change", 0);
+
+    // The routes to a stub network change, but no shortest path tree does:
+    // only the router of the network and its neighbors (whose next hops are
+    // read from its link records) run the SPF calculation again
+    ip1->SetDown(3);
+    CheckRecompute("stub network down", 3);
+    ip1->SetUp(3);
+    CheckRecompute("stub network up", 3);
+
+    // The shortest path trees reaching the stub router change
+    ip6->SetDown(1);
+    CheckRecompute("stub link down", m_nodes.GetN());
+    ip6->SetUp(1);
+    CheckRecompute("stub link up", m_nodes.GetN());
+
+    // A link of the ring breaks the equal cost paths
+    ip0->SetDown(1);
+    CheckRecompute("ring link down", m_nodes.GetN());
+    ip0->SetUp(1);
+    CheckRecompute("ring link up", m_nodes.GetN());
+
+    // A higher metric moves the traffic away from a link of the ring
+    ip2->SetMetric(2, 5);
+    CheckRecompute("ring link metric increase", m_nodes.GetN());
+    ip2->SetMetric(2, 1);
+    CheckRecompute("ring link metric decrease", m_nodes.GetN());
+
+    // The same routes are computed by a single thread
+    Config::SetGlobal("GlobalRoutingSpfThreads", UintegerValue(1));
+    ip0->SetDown(1);
+    CheckRecompute("ring link down, single thread", m_nodes.GetN());
+    ip0->SetUp(1);
+    CheckRecompute("ring link up, single thread", m_nodes.GetN());
+    Config::SetGlobal("GlobalRoutingSpfThreads", UintegerValue(0));
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1322,6 +1498,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::Duration::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::Duration::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingIncrementalTestCase, TestCase::Duration::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
@@ -1210,6 +1210,192 @@ DynamicPartialTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief Neighbor Cache Lookup on a Large Channel Test
+ */
+class LargeChannelTest : public TestCase
+{
+  public:
+    void DoRun() override;
+    LargeChannelTest();
+
+  private:
+    NodeContainer m_nodes; //!< Nodes used in the test.
+};
+
+LargeChannelTest::LargeChannelTest()
+    : TestCase("The LargeChannelTest checks the direct and inverse lookups of the neighbor "
+               "caches populated for a channel shared by many nodes.")
+{
+}
+
+void
+LargeChannelTest::DoRun()
+{
+    const uint32_t nNodes = 64;
+    m_nodes.Create(nNodes);
+
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    SimpleNetDeviceHelper simpleHelper;
+    NetDeviceContainer net = simpleHelper.Install(m_nodes, channel);
+
+    InternetStackHelper internet;
+    internet.Install(m_nodes);
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer i = ipv4.Assign(net);
+    Ipv6AddressHelper ipv6;
+    ipv6.SetBase(Ipv6Address("2001:0::"), Ipv6Prefix(64));
+    Ipv6InterfaceContainer icv6 = ipv6.Assign(net);
+
+    NeighborCacheHelper neighborCache;
+    neighborCache.PopulateNeighborCache(channel);
+
+    Ptr<ArpCache> arpCache =
+        m_nodes.Get(0)->GetObject<Ipv4L3Protocol>()->GetInterface(1)->GetArpCache();
+    Ptr<NdiscCache> ndiscCache =
+        m_nodes.Get(0)->GetObject<Ipv6L3Protocol>()->GetInterface(1)->GetNdiscCache();
+    // The caches of the channel share the addresses of its devices
+    NS_TEST_ASSERT_MSG_NE(arpCache->GetNeighbors(), nullptr, "Missing ARP neighbors");
+    NS_TEST_ASSERT_MSG_NE(ndiscCache->GetNeighbors(), nullptr, "Missing NDISC neighbors");
+    for (uint32_t n = 1; n < nNodes; n++)
+    {
+        Ptr<Node> node = m_nodes.Get(n);
+        NS_TEST_EXPECT_MSG_EQ(
+            node->GetObject<Ipv4L3Protocol>()->GetInterface(1)->GetArpCache()->GetNeighbors(),
+            arpCache->GetNeighbors(),
+            "ARP neighbors not shared by node " << n);
+        NS_TEST_EXPECT_MSG_EQ(
+            node->GetObject<Ipv6L3Protocol>()->GetInterface(1)->GetNdiscCache()->GetNeighbors(),
+            ndiscCache->GetNeighbors(),
+            "NDISC neighbors not shared by node " << n);
+    }
+    for (uint32_t n = 1; n < nNodes; n++)
+    {
+        Address mac = net.Get(n)->GetAddress();
+        ArpCache::Entry* entry = arpCache->Lookup(i.GetAddress(n));
+        NS_TEST_ASSERT_MSG_NE(entry, nullptr, "Missing ARP entry for node " << n);
+        NS_TEST_EXPECT_MSG_EQ(entry->GetMacAddress(), mac, "Wrong ARP entry for node " << n);
+        std::list<ArpCache::Entry*> arpEntries = arpCache->LookupInverse(mac);
+        NS_TEST_ASSERT_MSG_EQ(arpEntries.size(), 1, "Wrong inverse ARP lookup for node " << n);
+        NS_TEST_EXPECT_MSG_EQ(arpEntries.front(), entry, "Wrong inverse ARP lookup for node " << n);
+        // global and link-local addresses
+        NS_TEST_EXPECT_MSG_EQ(ndiscCache->LookupInverse(mac).size(),
+                              2,
+                              "Wrong inverse NDISC lookup for node " << n);
+    }
+    NS_TEST_EXPECT_MSG_EQ(arpCache->LookupInverse(net.Get(0)->GetAddress()).size(),
+                          0,
+                          "Own ARP entry found");
+
+    // The index of MAC addresses follows the changes of the entries
+    Address mac1 = net.Get(1)->GetAddress();
+    Address mac2 = net.Get(2)->GetAddress();
+    arpCache->Lookup(i.GetAddress(1))->SetMacAddress(mac2);
+    NS_TEST_EXPECT_MSG_EQ(arpCache->LookupInverse(mac1).size(), 0, "Stale inverse ARP lookup");
+    NS_TEST_EXPECT_MSG_EQ(arpCache->LookupInverse(mac2).size(), 2, "Wrong inverse ARP lookup");
+    arpCache->Remove(arpCache->Lookup(i.GetAddress(2)));
+    NS_TEST_EXPECT_MSG_EQ(arpCache->Lookup(i.GetAddress(2)), nullptr, "ARP entry not removed");
+    NS_TEST_EXPECT_MSG_EQ(arpCache->LookupInverse(mac2).size(), 1, "Removed ARP entry found");
+    ndiscCache->Remove(ndiscCache->Lookup(icv6.GetAddress(1, 1)));
+    NS_TEST_EXPECT_MSG_EQ(ndiscCache->LookupInverse(mac1).size(), 1, "Removed NDISC entry found");
+
+    neighborCache.FlushAutoGenerated();
+    NS_TEST_EXPECT_MSG_EQ(arpCache->LookupInverse(mac2).size(), 0, "ARP cache not flushed");
+    NS_TEST_EXPECT_MSG_EQ(ndiscCache->LookupInverse(mac1).size(), 0, "NDISC cache not flushed");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief NDISC NUD Timers Test
+ */
+class NudTimerTest : public TestCase
+{
+  public:
+    void DoRun() override;
+    NudTimerTest();
+
+  private:
+    /**
+     * \brief Check the state of the NDISC entries.
+     * \param stale1 True if the first entry must be stale.
+     * \param stale2 True if the second entry must be stale.
+     */
+    void CheckStates(bool stale1, bool stale2);
+
+    Ptr<NdiscCache> m_ndiscCache; //!< NDISC cache of the node.
+    NdiscCache::Entry* m_entry1;  //!< Entry confirmed at the start.
+    NdiscCache::Entry* m_entry2;  //!< Entry confirmed again after 10 seconds.
+};
+
+NudTimerTest::NudTimerTest()
+    : TestCase("The NudTimerTest checks that the NUD timers of the NDISC entries expire in "
+               "order and follow the reachability confirmations.")
+{
+}
+
+void
+NudTimerTest::CheckStates(bool stale1, bool stale2)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_entry1->IsStale(), stale1, "Wrong state of the first entry");
+    NS_TEST_EXPECT_MSG_EQ(m_entry1->IsReachable(), !stale1, "Wrong state of the first entry");
+    NS_TEST_EXPECT_MSG_EQ(m_entry2->IsStale(), stale2, "Wrong state of the second entry");
+    NS_TEST_EXPECT_MSG_EQ(m_entry2->IsReachable(), !stale2, "Wrong state of the second entry");
+}
+
+void
+NudTimerTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(1);
+
+    SimpleNetDeviceHelper simpleHelper;
+    NetDeviceContainer net = simpleHelper.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.SetIpv4StackInstall(false);
+    internet.Install(nodes);
+
+    Ipv6AddressHelper ipv6;
+    ipv6.SetBase(Ipv6Address("2001:0::"), Ipv6Prefix(64));
+    ipv6.Assign(net);
+
+    m_ndiscCache = nodes.Get(0)->GetObject<Ipv6L3Protocol>()->GetInterface(1)->GetNdiscCache();
+
+    // The default reachable time is 30 seconds
+    Mac48Address mac = Mac48Address::Allocate();
+    m_entry1 = m_ndiscCache->Add(Ipv6Address("2001::100"));
+    m_entry1->MarkReachable(mac);
+    m_entry1->StartReachableTimer();
+    m_entry2 = m_ndiscCache->Add(Ipv6Address("2001::101"));
+    m_entry2->MarkReachable(mac);
+    m_entry2->StartReachableTimer();
+    NdiscCache::Entry* entry3 = m_ndiscCache->Add(Ipv6Address("2001::102"));
+    entry3->MarkReachable(mac);
+    entry3->StartReachableTimer();
+
+    // An entry can be removed while its timer is running
+    Simulator::Schedule(Seconds(5), &NdiscCache::Remove, m_ndiscCache, entry3);
+    Simulator::Schedule(Seconds(10), &NdiscCache::Entry::UpdateReachableTimer, m_entry2);
+    Simulator::Schedule(Seconds(29), &NudTimerTest::CheckStates, this, false, false);
+    Simulator::Schedule(Seconds(31), &NudTimerTest::CheckStates, this, true, false);
+    Simulator::Schedule(Seconds(39), &NudTimerTest::CheckStates, this, true, false);
+    Simulator::Schedule(Seconds(41), &NudTimerTest::CheckStates, this, true, true);
+
+    Simulator::Stop(Seconds(45));
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_ndiscCache->Lookup(Ipv6Address("2001::102")),
+                          nullptr,
+                          "NDISC entry not removed");
+    m_ndiscCache = nullptr;
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1228,6 +1414,8 @@ class NeighborCacheTestSuite : public TestSuite
         AddTestCase(new FlushTest, TestCase::Duration::QUICK);
         AddTestCase(new DuplicateTest, TestCase::Duration::QUICK);
         AddTestCase(new DynamicPartialTest, TestCase::Duration::QUICK);
+        AddTestCase(new LargeChannelTest, TestCase::Duration::QUICK);
+        AddTestCase(new NudTimerTest, TestCase::Duration::QUICK);
     }
 };
 
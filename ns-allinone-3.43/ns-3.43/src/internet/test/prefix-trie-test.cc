@@ -0,0 +1,240 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/prefix-trie.h"
+#include "ns3/test.h"
+
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief PrefixTrie test: the matching prefixes are visited from the longest
+ * one to the shortest one, with their values in order of insertion.
+ */
+class PrefixTrieOrderTestCase : public TestCase
+{
+  public:
+    PrefixTrieOrderTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Look up an IPv4 address, and return the first value of each matching prefix.
+     * \param trie the trie
+     * \param address the address
+     * \return the values
+     */
+    static std::vector<int> Lookup(const PrefixTrie<int, 32>& trie, const char* address);
+
+    /**
+     * Store a value with an IPv4 prefix.
+     * \param trie the trie
+     * \param network the prefix
+     * \param length the length of the prefix
+     * \param value the value
+     */
+    static void Insert(PrefixTrie<int, 32>& trie, const char* network, uint8_t length, int value);
+};
+
+PrefixTrieOrderTestCase::PrefixTrieOrderTestCase()
+    : TestCase("Order of the matching prefixes and of their values")
+{
+}
+
+std::vector<int>
+PrefixTrieOrderTestCase::Lookup(const PrefixTrie<int, 32>& trie, const char* address)
+{
+    uint8_t buf[4];
+    Ipv4Address(address).Serialize(buf);
+    std::vector<int> values;
+    trie.Lookup(buf, [&values](const std::vector<int>& v) {
+        values.push_back(v.front());
+        return false;
+    });
+    return values;
+}
+
+void
+PrefixTrieOrderTestCase::Insert(PrefixTrie<int, 32>& trie,
+                                const char* network,
+                                uint8_t length,
+                                int value)
+{
+    uint8_t buf[4];
+    Ipv4Address(network).Serialize(buf);
+    trie.Insert(buf, length, value);
+}
+
+void
+PrefixTrieOrderTestCase::DoRun()
+{
+    PrefixTrie<int, 32> trie;
+    NS_TEST_ASSERT_MSG_EQ(trie.IsEmpty(), true, "A new trie is empty");
+    NS_TEST_ASSERT_MSG_EQ(Lookup(trie, "10.1.2.3").empty(), true, "Empty trie matches");
+
+    Insert(trie, "0.0.0.0", 0, 0);
+    Insert(trie, "10.0.0.0", 8, 8);
+    Insert(trie, "10.1.2.0", 23, 23);
+    Insert(trie, "10.1.2.0", 24, 24);
+    Insert(trie, "10.1.2.3", 32, 32);
+    Insert(trie, "10.1.3.0", 24, 124);
+    NS_TEST_ASSERT_MSG_EQ(trie.IsEmpty(), false, "Trie is empty after insertions");
+
+    NS_TEST_ASSERT_MSG_EQ((Lookup(trie, "10.1.2.3") == std::vector<int>{32, 24, 23, 8, 0}),
+                          true,
+                          "Wrong matches for a host route");
+    NS_TEST_ASSERT_MSG_EQ((Lookup(trie, "10.1.3.3") == std::vector<int>{124, 23, 8, 0}),
+                          true,
+                          "Wrong matches for a /23 network");
+    NS_TEST_ASSERT_MSG_EQ((Lookup(trie, "10.1.4.3") == std::vector<int>{8, 0}),
+                          true,
+                          "Wrong matches for a /8 network");
+    NS_TEST_ASSERT_MSG_EQ((Lookup(trie, "192.168.0.1") == std::vector<int>{0}),
+                          true,
+                          "Wrong matches for the default route");
+
+    // Values stored with the same prefix are kept in order of insertion, and
+    // the bits beyond the prefix length are ignored
+    Insert(trie, "10.1.2.255", 24, 1024);
+    uint8_t buf[4];
+    Ipv4Address("10.1.2.7").Serialize(buf);
+    std::vector<int> values;
+    bool stopped = trie.Lookup(buf, [&values](const std::vector<int>& v) {
+        values = v;
+        return true;
+    });
+    NS_TEST_ASSERT_MSG_EQ(stopped, true, "Lookup not stopped by the visitor");
+    NS_TEST_ASSERT_MSG_EQ((values == std::vector<int>{24, 1024}),
+                          true,
+                          "Values not in order of insertion");
+
+    trie.Clear();
+    NS_TEST_ASSERT_MSG_EQ(trie.IsEmpty(), true, "Trie not empty after Clear");
+    NS_TEST_ASSERT_MSG_EQ(Lookup(trie, "10.1.2.3").empty(), true, "Cleared trie matches");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief PrefixTrie test: the longest prefix match agrees with a linear scan
+ * of random IPv4 and IPv6 prefixes.
+ */
+class PrefixTrieRandomTestCase : public TestCase
+{
+  public:
+    PrefixTrieRandomTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PrefixTrieRandomTestCase::PrefixTrieRandomTestCase()
+    : TestCase("Longest prefix match of random prefixes")
+{
+}
+
+void
+PrefixTrieRandomTestCase::DoRun()
+{
+    std::mt19937 rng(1);
+
+    // IPv4: prefixes of random lengths within 10.0.0.0/8, so that they overlap
+    std::vector<std::pair<Ipv4Address, Ipv4Mask>> routes4;
+    PrefixTrie<uint32_t, 32> trie4;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        Ipv4Address network((10 << 24) | (rng() & 0xffffff));
+        Ipv4Mask mask(("/" + std::to_string(8 + rng() % 25)).c_str());
+        uint8_t buf[4];
+        network.Serialize(buf);
+        trie4.Insert(buf, mask.GetPrefixLength(), i);
+        routes4.emplace_back(network, mask);
+    }
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        // pick addresses close to the prefixes, to have long matches
+        Ipv4Address address(routes4[rng() % routes4.size()].first.Get() ^ (rng() & 0xff));
+        int expected = -1;
+        for (uint32_t j = 0; j < routes4.size(); j++)
+        {
+            if (routes4[j].second.IsMatch(address, routes4[j].first) &&
+                (expected < 0 ||
+                 routes4[j].second.GetPrefixLength() > routes4[expected].second.GetPrefixLength()))
+            {
+                expected = j;
+            }
+        }
+        uint8_t buf[4];
+        address.Serialize(buf);
+        int found = -1;
+        trie4.Lookup(buf, [&found](const std::vector<uint32_t>& values) {
+            found = values.front();
+            return true;
+        });
+        NS_TEST_ASSERT_MSG_EQ(found, expected, "Wrong longest prefix match for " << address);
+    }
+
+    // IPv6: prefixes of random lengths within 2001:db8::/32
+    std::vector<std::pair<Ipv6Address, Ipv6Prefix>> routes6;
+    PrefixTrie<uint32_t, 128> trie6;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        uint8_t buf[16] = {0x20, 0x01, 0x0d, 0xb8};
+        for (uint32_t b = 4; b < 16; b++)
+        {
+            buf[b] = rng();
+        }
+        Ipv6Prefix prefix(32 + rng() % 97);
+        trie6.Insert(buf, prefix.GetPrefixLength(), i);
+        routes6.emplace_back(Ipv6Address(buf), prefix);
+    }
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        uint8_t buf[16];
+        routes6[rng() % routes6.size()].first.GetBytes(buf);
+        buf[4 + rng() % 12] ^= 1 << (rng() % 8);
+        Ipv6Address address(buf);
+        int expected = -1;
+        for (uint32_t j = 0; j < routes6.size(); j++)
+        {
+            if (routes6[j].second.IsMatch(address, routes6[j].first) &&
+                (expected < 0 ||
+                 routes6[j].second.GetPrefixLength() > routes6[expected].second.GetPrefixLength()))
+            {
+                expected = j;
+            }
+        }
+        int found = -1;
+        trie6.Lookup(buf, [&found](const std::vector<uint32_t>& values) {
+            found = values.front();
+            return true;
+        });
+        NS_TEST_ASSERT_MSG_EQ(found, expected, "Wrong longest prefix match for " << address);
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief PrefixTrie TestSuite
+ */
+class PrefixTrieTestSuite : public TestSuite
+{
+  public:
+    PrefixTrieTestSuite()
+        : TestSuite("prefix-trie", Type::UNIT)
+    {
+        AddTestCase(new PrefixTrieOrderTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new PrefixTrieRandomTestCase(), TestCase::Duration::QUICK);
+    }
+};
+
+static PrefixTrieTestSuite g_prefixTrieTestSuite; //!< Static variable for test initialization
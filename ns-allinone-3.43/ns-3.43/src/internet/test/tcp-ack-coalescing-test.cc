@@ -0,0 +1,429 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include "tcp-general-test.h"
+
+#include "ns3/boolean.h"
+#include "ns3/error-model.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simple-channel.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/tcp-bbr.h"
+#include "ns3/tcp-cubic.h"
+#include "ns3/tcp-dctcp.h"
+#include "ns3/uinteger.h"
+
+#include <map>
+#include <memory>
+#include <set>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpAckCoalescingTestSuite");
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the ACK coalescing of TcpSocketBase
+ *
+ * The receiver acknowledges every segment, and the segments of a window reach
+ * it at the same time. With ACK coalescing, the sender must process fewer
+ * ACKs than the receiver sends, while all the data is delivered, and a loss is
+ * recovered through SACK, without a retransmission timeout.
+ */
+class TcpAckCoalescingTestCase : public TcpGeneralTest
+{
+  public:
+    /**
+     * Constructor.
+     * \param desc Test description.
+     * \param ackCoalescing Enable the ACK coalescing of the sender.
+     * \param lostPacket Index of the packet dropped at the receiver (0 for none).
+     */
+    TcpAckCoalescingTestCase(const std::string& desc, bool ackCoalescing, uint32_t lostPacket)
+        : TcpGeneralTest(desc),
+          m_ackCoalescing(ackCoalescing),
+          m_lostPacket(lostPacket)
+    {
+    }
+
+  protected:
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+    Ptr<TcpSocketMsgBase> CreateReceiverSocket(Ptr<Node> node) override;
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    void ConfigureEnvironment() override;
+    void ConfigureProperties() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who) override;
+    void FinalChecks() override;
+
+  private:
+    /**
+     * \param p a packet
+     * \param h its TCP header
+     * \return true if the packet is a pure ACK
+     */
+    static bool IsPureAck(const Ptr<const Packet> p, const TcpHeader& h);
+
+    bool m_ackCoalescing;     //!< Enable the ACK coalescing of the sender
+    uint32_t m_lostPacket;    //!< Index of the packet dropped at the receiver
+    uint32_t m_acksSent{0};   //!< Number of pure ACKs sent by the receiver
+    uint32_t m_acksRcvd{0};   //!< Number of pure ACKs processed by the sender
+    uint32_t m_rtoExpired{0}; //!< Number of retransmission timeouts
+};
+
+void
+TcpAckCoalescingTestCase::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetPropagationDelay(MilliSeconds(10)); // Keep the RTT well below the minimum RTO
+    SetAppPktCount(200);
+    SetAppPktSize(500);
+    SetAppPktInterval(MicroSeconds(1));
+}
+
+void
+TcpAckCoalescingTestCase::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetSegmentSize(SENDER, 500);
+    SetSegmentSize(RECEIVER, 500);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpAckCoalescingTestCase::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    socket->SetAttribute("AckCoalescing", BooleanValue(m_ackCoalescing));
+    return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpAckCoalescingTestCase::CreateReceiverSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket(node);
+    socket->SetAttribute("DelAckCount", UintegerValue(1));
+    return socket;
+}
+
+Ptr<ErrorModel>
+TcpAckCoalescingTestCase::CreateReceiverErrorModel()
+{
+    if (m_lostPacket == 0)
+    {
+        return nullptr;
+    }
+    Ptr<ReceiveListErrorModel> rem = CreateObject<ReceiveListErrorModel>();
+    rem->SetList({m_lostPacket});
+    return rem;
+}
+
+bool
+TcpAckCoalescingTestCase::IsPureAck(const Ptr<const Packet> p, const TcpHeader& h)
+{
+    return p->GetSize() == 0 && (h.GetFlags() & ~TcpHeader::ECE) == TcpHeader::ACK;
+}
+
+void
+TcpAckCoalescingTestCase::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == RECEIVER && IsPureAck(p, h))
+    {
+        ++m_acksSent;
+    }
+}
+
+void
+TcpAckCoalescingTestCase::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == SENDER && IsPureAck(p, h))
+    {
+        ++m_acksRcvd;
+    }
+}
+
+void
+TcpAckCoalescingTestCase::AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+    ++m_rtoExpired;
+}
+
+void
+TcpAckCoalescingTestCase::FinalChecks()
+{
+    if (m_ackCoalescing)
+    {
+        NS_TEST_ASSERT_MSG_LT(m_acksRcvd, m_acksSent, "No ACK coalesced");
+    }
+    else
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_acksRcvd, m_acksSent, "ACK coalesced without ACK coalescing");
+    }
+    // The receiver got all the data, and the FIN
+    NS_TEST_ASSERT_MSG_EQ(GetRxBuffer(RECEIVER)->NextRxSequence(),
+                          SequenceNumber32(GetPktSize() * GetPktCount() + 2),
+                          "Data not delivered");
+    NS_TEST_ASSERT_MSG_EQ(GetTxBuffer(SENDER)->Size(), 0, "Data not acknowledged");
+    NS_TEST_ASSERT_MSG_EQ(m_rtoExpired, 0, "Loss not recovered with SACK");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Evolution of the congestion window and of the RTT of a sender
+ *
+ * Only the last value set at each time is kept, as a coalesced ACK skips the
+ * intermediate values that the ACKs of its burst set at the same time.
+ */
+struct TcpSenderEvolution
+{
+    std::map<Time, uint32_t> cWnd; //!< Congestion window at each time it changes
+    std::map<Time, Time> rtt;      //!< RTT of the last ACKed segment at each time it changes
+    uint32_t acks{0};              //!< Number of ACKs processed by the sender
+};
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that the ACK coalescing keeps the sender behavior
+ *
+ * The segments of a window reach the receiver at the same time, and their
+ * ACKs reach the sender at the same time, while the propagation delay grows
+ * twice. The test case without ACK coalescing records the evolution of the
+ * congestion window and of the RTT samples of the sender; the test case with
+ * ACK coalescing, run next with the same congestion control, checks that it
+ * processes fewer ACKs with the same evolution. When the ACKs wait for the
+ * coalescing delay, the window evolves later, but the RTT samples must not
+ * include the wait.
+ */
+class TcpAckCoalescingEvolutionTestCase : public TcpGeneralTest
+{
+  public:
+    /**
+     * Constructor.
+     * \param desc Test description.
+     * \param congControl Congestion control of the sender.
+     * \param ackCoalescing Enable the ACK coalescing of the sender.
+     * \param delay ACK coalescing delay.
+     * \param evolution Evolution recorded without ACK coalescing.
+     */
+    TcpAckCoalescingEvolutionTestCase(const std::string& desc,
+                                      TypeId congControl,
+                                      bool ackCoalescing,
+                                      Time delay,
+                                      std::shared_ptr<TcpSenderEvolution> evolution)
+        : TcpGeneralTest(desc),
+          m_congControl(congControl),
+          m_ackCoalescing(ackCoalescing),
+          m_delay(delay),
+          m_reference(evolution)
+    {
+    }
+
+  protected:
+    Ptr<SimpleChannel> CreateChannel() override;
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+    Ptr<TcpSocketMsgBase> CreateReceiverSocket(Ptr<Node> node) override;
+    void ConfigureEnvironment() override;
+    void ConfigureProperties() override;
+    void CWndTrace(uint32_t oldValue, uint32_t newValue) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+  private:
+    /**
+     * \brief Record the RTT of the last ACKed segment.
+     * \param oldValue old value
+     * \param newValue new value
+     */
+    void LastRttTrace(Time oldValue, Time newValue);
+
+    TypeId m_congControl;                            //!< Congestion control of the sender
+    bool m_ackCoalescing;                            //!< Enable the ACK coalescing
+    Time m_delay;                                    //!< ACK coalescing delay
+    std::shared_ptr<TcpSenderEvolution> m_reference; //!< Evolution without ACK coalescing
+    TcpSenderEvolution m_evolution;                  //!< Evolution of this test case
+};
+
+void
+TcpAckCoalescingEvolutionTestCase::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetCongestionControl(m_congControl);
+    SetPropagationDelay(MilliSeconds(10));
+    // The application fills the transmission buffer for one second
+    SetAppPktCount(100000);
+    SetAppPktSize(500);
+    SetAppPktInterval(MicroSeconds(10));
+}
+
+void
+TcpAckCoalescingEvolutionTestCase::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetSegmentSize(SENDER, 500);
+    SetSegmentSize(RECEIVER, 500);
+    // Leave the slow start after a few windows
+    SetInitialSsThresh(SENDER, 40 * 500);
+    if (m_congControl == TcpDctcp::GetTypeId())
+    {
+        SetUseEcn(SENDER, TcpSocketState::On);
+        SetUseEcn(RECEIVER, TcpSocketState::On);
+    }
+}
+
+Ptr<SimpleChannel>
+TcpAckCoalescingEvolutionTestCase::CreateChannel()
+{
+    Ptr<SimpleChannel> channel = TcpGeneralTest::CreateChannel();
+    // The delay only grows, so that the segments are not reordered
+    Simulator::Schedule(GetStartTime() + MilliSeconds(100),
+                        &SimpleChannel::SetAttribute,
+                        channel,
+                        "Delay",
+                        TimeValue(MilliSeconds(12)));
+    Simulator::Schedule(GetStartTime() + MilliSeconds(250),
+                        &SimpleChannel::SetAttribute,
+                        channel,
+                        "Delay",
+                        TimeValue(MilliSeconds(15)));
+    return channel;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpAckCoalescingEvolutionTestCase::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    socket->SetAttribute("AckCoalescing", BooleanValue(m_ackCoalescing));
+    socket->SetAttribute("AckCoalescingDelay", TimeValue(m_delay));
+    // Sample the RTT from the transmission times, without the rounding of the timestamps
+    socket->SetAttribute("Timestamp", BooleanValue(false));
+    socket->TraceConnectWithoutContext(
+        "LastRTT",
+        MakeCallback(&TcpAckCoalescingEvolutionTestCase::LastRttTrace, this));
+    return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpAckCoalescingEvolutionTestCase::CreateReceiverSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket(node);
+    socket->SetAttribute("DelAckCount", UintegerValue(1));
+    return socket;
+}
+
+void
+TcpAckCoalescingEvolutionTestCase::CWndTrace(uint32_t oldValue, uint32_t newValue)
+{
+    // Once the application stops, the growth of the window depends on the
+    // bytes in flight when each ACK is processed
+    if (Simulator::Now() < GetStartTime() + MilliSeconds(500))
+    {
+        m_evolution.cWnd[Simulator::Now()] = newValue;
+    }
+}
+
+void
+TcpAckCoalescingEvolutionTestCase::LastRttTrace(Time oldValue, Time newValue)
+{
+    m_evolution.rtt[Simulator::Now()] = newValue;
+}
+
+void
+TcpAckCoalescingEvolutionTestCase::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == SENDER)
+    {
+        ++m_evolution.acks;
+    }
+}
+
+void
+TcpAckCoalescingEvolutionTestCase::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_EQ(GetTxBuffer(SENDER)->Size(), 0, "Data not acknowledged");
+    if (!m_ackCoalescing)
+    {
+        *m_reference = m_evolution;
+        return;
+    }
+    // The ACKs of a paced sender do not arrive at the same time
+    if (!m_delay.IsZero() || !GetTcb(SENDER)->m_pacing)
+    {
+        NS_TEST_EXPECT_MSG_LT(m_evolution.acks, m_reference->acks, "No ACK coalesced");
+    }
+    if (m_delay.IsZero())
+    {
+        NS_TEST_EXPECT_MSG_EQ((m_evolution.cWnd == m_reference->cWnd),
+                              true,
+                              "Congestion window changed by the ACK coalescing");
+        NS_TEST_EXPECT_MSG_EQ((m_evolution.rtt == m_reference->rtt),
+                              true,
+                              "RTT changed by the ACK coalescing");
+        return;
+    }
+    std::set<Time> rtts;
+    for (const auto& [time, rtt] : m_reference->rtt)
+    {
+        rtts.insert(rtt);
+    }
+    for (const auto& [time, rtt] : m_evolution.rtt)
+    {
+        NS_TEST_EXPECT_MSG_EQ(rtts.count(rtt), 1, "RTT sample " << rtt << " includes the delay");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TestSuite: ACK coalescing
+ */
+class TcpAckCoalescingTestSuite : public TestSuite
+{
+  public:
+    TcpAckCoalescingTestSuite()
+        : TestSuite("tcp-ack-coalescing", Type::UNIT)
+    {
+        AddTestCase(new TcpAckCoalescingTestCase("No ACK coalescing", false, 0),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpAckCoalescingTestCase("No ACK coalescing with a loss", false, 30),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpAckCoalescingTestCase("ACK coalescing", true, 0),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpAckCoalescingTestCase("ACK coalescing with a loss", true, 30),
+                    TestCase::Duration::QUICK);
+        for (TypeId congControl :
+             {TcpCubic::GetTypeId(), TcpBbr::GetTypeId(), TcpDctcp::GetTypeId()})
+        {
+            // The evolution is recorded by the first test case, and checked by the others
+            auto evolution = std::make_shared<TcpSenderEvolution>();
+            std::string name = congControl.GetName();
+            AddTestCase(new TcpAckCoalescingEvolutionTestCase("No ACK coalescing with " + name,
+                                                              congControl,
+                                                              false,
+                                                              Time(0),
+                                                              evolution),
+                        TestCase::Duration::QUICK);
+            AddTestCase(new TcpAckCoalescingEvolutionTestCase("ACK coalescing with " + name,
+                                                              congControl,
+                                                              true,
+                                                              Time(0),
+                                                              evolution),
+                        TestCase::Duration::QUICK);
+            AddTestCase(new TcpAckCoalescingEvolutionTestCase("ACK coalescing delay with " + name,
+                                                              congControl,
+                                                              true,
+                                                              MilliSeconds(1),
+                                                              evolution),
+                        TestCase::Duration::QUICK);
+        }
+    }
+};
+
+static TcpAckCoalescingTestSuite
+    g_tcpAckCoalescingTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,235 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ */
+
+#include "tcp-general-test.h"
+
+#include "ns3/error-model.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/tcp-header.h"
+#include "ns3/uinteger.h"
+
+#include <set>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpGsoTestSuite");
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the segmentation offload of TcpSocketBase
+ *
+ * The sender sends super-segments of up to GsoMaxSegments segments, which must
+ * go through the IP layer of the sender as single packets, larger than the MTU,
+ * and reach the receiver as segments of at most one segment size, each one with
+ * its own IP identification. All the data must be delivered, and a loss inside
+ * a super-segment must be recovered through SACK, without a retransmission
+ * timeout.
+ */
+class TcpGsoTestCase : public TcpGeneralTest
+{
+  public:
+    /**
+     * Constructor.
+     * \param desc Test description.
+     * \param gsoMaxSegments Maximum number of segments of a super-segment.
+     * \param lostPacket Index of the packet dropped at the receiver (0 for none).
+     */
+    TcpGsoTestCase(const std::string& desc, uint32_t gsoMaxSegments, uint32_t lostPacket)
+        : TcpGeneralTest(desc),
+          m_gsoMaxSegments(gsoMaxSegments),
+          m_lostPacket(lostPacket)
+    {
+    }
+
+  protected:
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+    Ptr<TcpSocketMsgBase> CreateReceiverSocket(Ptr<Node> node) override;
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    void ConfigureEnvironment() override;
+    void ConfigureProperties() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who) override;
+    void FinalChecks() override;
+
+  private:
+    /**
+     * \brief Trace the packets sent by the IP layer of the sender
+     * \param p the packet, with its IP header
+     * \param ipv4 the IP layer
+     * \param interface the interface index
+     */
+    void IpTx(Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+    /**
+     * \brief Trace the packets received by the IP layer of the receiver
+     * \param p the packet, with its IP header
+     * \param ipv4 the IP layer
+     * \param interface the interface index
+     */
+    void IpRx(Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+
+    uint32_t m_gsoMaxSegments;    //!< Maximum number of segments of a super-segment
+    uint32_t m_lostPacket;        //!< Index of the packet dropped at the receiver
+    uint32_t m_superSegments{0};  //!< Number of super-segments sent
+    uint32_t m_maxTxSize{0};      //!< Largest packet sent by the sender socket
+    uint32_t m_maxRxSize{0};      //!< Largest segment received by the receiver socket
+    uint32_t m_rtoExpired{0};     //!< Number of retransmission timeouts
+    uint32_t m_maxIpTxSize{0};    //!< Largest packet sent by the IP layer of the sender
+    uint32_t m_maxIpRxSize{0};    //!< Largest packet received by the IP layer of the receiver
+    uint32_t m_ipRxPackets{0};    //!< Number of packets received by the IP layer of the receiver
+    std::set<uint16_t> m_ipRxIds; //!< Identifications of the packets received
+};
+
+void
+TcpGsoTestCase::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetPropagationDelay(MilliSeconds(10)); // Keep the RTT well below the minimum RTO
+    SetAppPktCount(200);
+    SetAppPktSize(500);
+    SetAppPktInterval(MicroSeconds(1));
+}
+
+void
+TcpGsoTestCase::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetSegmentSize(SENDER, 500);
+    SetSegmentSize(RECEIVER, 500);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpGsoTestCase::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    socket->SetAttribute("GsoMaxSegments", UintegerValue(m_gsoMaxSegments));
+    node->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+        "Tx",
+        MakeCallback(&TcpGsoTestCase::IpTx, this));
+    return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpGsoTestCase::CreateReceiverSocket(Ptr<Node> node)
+{
+    node->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+        "Rx",
+        MakeCallback(&TcpGsoTestCase::IpRx, this));
+    return TcpGeneralTest::CreateReceiverSocket(node);
+}
+
+void
+TcpGsoTestCase::IpTx(Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    m_maxIpTxSize = std::max(m_maxIpTxSize, p->GetSize());
+}
+
+void
+TcpGsoTestCase::IpRx(Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    m_maxIpRxSize = std::max(m_maxIpRxSize, p->GetSize());
+    Ipv4Header header;
+    p->PeekHeader(header);
+    m_ipRxIds.insert(header.GetIdentification());
+    ++m_ipRxPackets;
+}
+
+Ptr<ErrorModel>
+TcpGsoTestCase::CreateReceiverErrorModel()
+{
+    if (m_lostPacket == 0)
+    {
+        return nullptr;
+    }
+    Ptr<ReceiveListErrorModel> rem = CreateObject<ReceiveListErrorModel>();
+    rem->SetList({m_lostPacket});
+    return rem;
+}
+
+void
+TcpGsoTestCase::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == SENDER)
+    {
+        m_maxTxSize = std::max(m_maxTxSize, p->GetSize());
+        if (p->GetSize() > GetSegSize(SENDER))
+        {
+            ++m_superSegments;
+        }
+    }
+}
+
+void
+TcpGsoTestCase::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == RECEIVER)
+    {
+        m_maxRxSize = std::max(m_maxRxSize, p->GetSize());
+    }
+}
+
+void
+TcpGsoTestCase::AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+    ++m_rtoExpired;
+}
+
+void
+TcpGsoTestCase::FinalChecks()
+{
+    if (m_gsoMaxSegments > 1)
+    {
+        NS_TEST_ASSERT_MSG_GT(m_superSegments, 0, "No super-segment sent");
+        NS_TEST_ASSERT_MSG_GT(m_maxIpTxSize,
+                              GetMtu(),
+                              "Super-segments split before the IP layer");
+    }
+    else
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_superSegments, 0, "Super-segment sent without offload");
+    }
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(m_maxIpRxSize, GetMtu(), "Packet larger than the MTU on the wire");
+    NS_TEST_ASSERT_MSG_EQ(m_ipRxIds.size(),
+                          m_ipRxPackets,
+                          "Wire segments sharing an IP identification");
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(m_maxTxSize,
+                                m_gsoMaxSegments * GetSegSize(SENDER),
+                                "Super-segment larger than allowed");
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(m_maxRxSize,
+                                GetSegSize(SENDER),
+                                "Super-segment not split into wire segments");
+    // The receiver got all the data, and the FIN
+    NS_TEST_ASSERT_MSG_EQ(GetRxBuffer(RECEIVER)->NextRxSequence(),
+                          SequenceNumber32(GetPktSize() * GetPktCount() + 2),
+                          "Data not delivered");
+    NS_TEST_ASSERT_MSG_EQ(m_rtoExpired, 0, "Loss not recovered with SACK");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TestSuite: segmentation offload
+ */
+class TcpGsoTestSuite : public TestSuite
+{
+  public:
+    TcpGsoTestSuite()
+        : TestSuite("tcp-gso", Type::UNIT)
+    {
+        AddTestCase(new TcpGsoTestCase("No segmentation offload", 1, 0),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpGsoTestCase("No segmentation offload with a loss", 1, 30),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpGsoTestCase("Segmentation offload", 8, 0), TestCase::Duration::QUICK);
+        AddTestCase(new TcpGsoTestCase("Segmentation offload with a loss", 8, 30),
+                    TestCase::Duration::QUICK);
+    }
+};
+
+static TcpGsoTestSuite g_tcpGsoTestSuite; //!< Static variable for test initialization
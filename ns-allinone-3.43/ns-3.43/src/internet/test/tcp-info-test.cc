@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "tcp-error-model.h"
+#include "tcp-general-test.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-tx-buffer.h"
+
+#include <set>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpInfoTestSuite");
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that the snapshot returned by GetTcpInfo matches the state of
+ * the sender socket after each ACK, including during the recovery of a lost
+ * segment, and that the sockets of the stacks can be iterated over.
+ */
+class TcpInfoTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param desc Test description.
+     */
+    TcpInfoTest(const std::string& desc);
+
+  protected:
+    void ConfigureEnvironment() override;
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    void ProcessedAck(const Ptr<const TcpSocketState> tcb,
+                      const TcpHeader& h,
+                      SocketWho who) override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+  private:
+    /**
+     * \brief Check that a socket is among the sockets of its stack
+     * \param socket the socket
+     * \return true if the socket has been found
+     */
+    bool FindSocket(Ptr<TcpSocketBase> socket);
+
+    std::set<SequenceNumber32> m_sent; //!< Sequence numbers of the data segments sent
+    uint32_t m_nRetrans{0};            //!< Number of data segments sent more than once
+    uint32_t m_nAcks{0};               //!< Number of ACKs processed by the sender
+    bool m_recoverySeen{false};        //!< Whether the sender entered the recovery
+    bool m_socketsChecked{false};      //!< Whether the sockets have been iterated over
+    bool m_senderFound{false};         //!< Whether the sender socket has been found
+    bool m_receiverFound{false};       //!< Whether the receiver socket has been found
+};
+
+TcpInfoTest::TcpInfoTest(const std::string& desc)
+    : TcpGeneralTest(desc)
+{
+}
+
+void
+TcpInfoTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(20);
+    SetMTU(500);
+}
+
+Ptr<ErrorModel>
+TcpInfoTest::CreateReceiverErrorModel()
+{
+    Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel>();
+    errorModel->AddSeqToKill(SequenceNumber32(2001));
+    return errorModel;
+}
+
+void
+TcpInfoTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == SENDER && p->GetSize() > 0 && !m_sent.insert(h.GetSequenceNumber()).second)
+    {
+        m_nRetrans++;
+    }
+}
+
+bool
+TcpInfoTest::FindSocket(Ptr<TcpSocketBase> socket)
+{
+    Ptr<TcpL4Protocol> tcp = socket->GetNode()->GetObject<TcpL4Protocol>();
+    uint32_t n = 0;
+    bool found = false;
+    for (auto it = tcp->SocketsBegin(); it != tcp->SocketsEnd(); it++)
+    {
+        found |= (it->second == socket);
+        n++;
+    }
+    NS_TEST_EXPECT_MSG_EQ(n, tcp->GetNSockets(), "Wrong number of sockets");
+    return found;
+}
+
+void
+TcpInfoTest::ProcessedAck(const Ptr<const TcpSocketState> tcb, const TcpHeader& h, SocketWho who)
+{
+    if (who != SENDER)
+    {
+        return;
+    }
+
+    m_nAcks++;
+    TcpInfo info = GetSenderSocket()->GetTcpInfo();
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(info.state,
+                                TcpSocket::ESTABLISHED,
+                                "The connection should be established");
+    NS_TEST_ASSERT_MSG_EQ(info.congState, tcb->m_congState.Get(), "Wrong congestion state");
+    NS_TEST_ASSERT_MSG_EQ(info.segmentSize, tcb->m_segmentSize, "Wrong segment size");
+    NS_TEST_ASSERT_MSG_EQ(info.cWnd, tcb->m_cWnd.Get(), "Wrong congestion window");
+    NS_TEST_ASSERT_MSG_EQ(info.ssThresh, tcb->m_ssThresh.Get(), "Wrong slow start threshold");
+    NS_TEST_ASSERT_MSG_EQ(info.bytesInFlight,
+                          tcb->m_bytesInFlight.Get(),
+                          "Wrong bytes in flight");
+    NS_TEST_ASSERT_MSG_EQ(info.srtt, tcb->m_srtt.Get(), "Wrong smoothed RTT");
+    NS_TEST_ASSERT_MSG_EQ(info.lastRtt, tcb->m_lastRtt.Get(), "Wrong last RTT");
+    NS_TEST_ASSERT_MSG_EQ(info.minRtt, tcb->m_minRtt, "Wrong minimum RTT");
+    NS_TEST_ASSERT_MSG_EQ(info.rttVar,
+                          GetRttEstimator(SENDER)->GetVariation(),
+                          "Wrong RTT variation");
+    NS_TEST_ASSERT_MSG_EQ(info.rto, GetRto(SENDER), "Wrong RTO");
+    NS_TEST_ASSERT_MSG_EQ(info.sacked, GetTxBuffer(SENDER)->GetSacked(), "Wrong SACKed bytes");
+    NS_TEST_ASSERT_MSG_EQ(info.lost, GetTxBuffer(SENDER)->GetLost(), "Wrong lost bytes");
+    NS_TEST_ASSERT_MSG_EQ(info.retransOut,
+                          GetTxBuffer(SENDER)->GetRetransmitsCount(),
+                          "Wrong retransmitted bytes");
+    NS_TEST_ASSERT_MSG_EQ(info.rWnd, GetRWnd(SENDER), "Wrong receiver window");
+
+    if (info.congState == TcpSocketState::CA_RECOVERY)
+    {
+        m_recoverySeen = true;
+        NS_TEST_ASSERT_MSG_GT(info.sacked, 0, "SACKed bytes expected during the recovery");
+    }
+
+    // both sockets of the connection are known to their stack
+    if (!m_socketsChecked)
+    {
+        m_socketsChecked = true;
+        m_senderFound = FindSocket(GetSenderSocket());
+        m_receiverFound = FindSocket(GetReceiverSocket());
+    }
+}
+
+void
+TcpInfoTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_GT(m_nAcks, 0, "No ACK processed");
+    NS_TEST_ASSERT_MSG_EQ(m_recoverySeen, true, "The lost segment did not trigger a recovery");
+    NS_TEST_ASSERT_MSG_EQ(m_senderFound, true, "The sender socket has not been found");
+    NS_TEST_ASSERT_MSG_EQ(m_receiverFound, true, "The receiver socket has not been found");
+
+    TcpInfo info = GetSenderSocket()->GetTcpInfo();
+    NS_TEST_ASSERT_MSG_GT(m_nRetrans, 0, "The lost segment has not been retransmitted");
+    NS_TEST_ASSERT_MSG_EQ(info.totalRetrans, m_nRetrans, "Wrong number of retransmissions");
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(info.delivered,
+                                GetPktCount() * GetPktSize(),
+                                "Not all the bytes have been delivered");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TcpInfo TestSuite
+ */
+class TcpInfoTestSuite : public TestSuite
+{
+  public:
+    TcpInfoTestSuite()
+        : TestSuite("tcp-info", Type::UNIT)
+    {
+        AddTestCase(new TcpInfoTest("GetTcpInfo and socket iteration with a lost segment"),
+                    TestCase::Duration::QUICK);
+    }
+};
+
+static TcpInfoTestSuite g_tcpInfoTestSuite; //!< Static variable for test initialization
@@ -8,6 +8,8 @@
 #include "ns3/tcp-rx-buffer.h"
 #include "ns3/test.h"
 
+#include <vector>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("TcpRxBufferTestSuite");
@@ -31,6 +33,11 @@ class TcpRxBufferTestCase : public TestCase
      * \brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+
+    /**
+     * \brief Test the reassembly of overlapping segments received out of order.
+     */
+    void TestReordering();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -42,6 +49,7 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestReordering();
 }
 
 void
@@ -277,6 +285,83 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestReordering()
+{
+    const uint32_t segments = 200;
+    const uint32_t segmentSize = 10;
+    std::vector<uint8_t> data(segments * segmentSize + segmentSize);
+    for (uint32_t i = 0; i < data.size(); i++)
+    {
+        data[i] = i % 251;
+    }
+
+    TcpRxBuffer rxBuf;
+    rxBuf.SetMaxBufferSize(data.size());
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+    TcpHeader h;
+
+    // 73 is coprime with 200: every segment is received once, in a scrambled
+    // order. Every segment also overlaps half of the next one, and every
+    // fourth one is received twice.
+    for (uint32_t k = 0; k < segments; k++)
+    {
+        uint32_t i = (k * 73) % segments;
+        uint32_t offset = i * segmentSize;
+        Ptr<Packet> p = Create<Packet>(&data[offset], segmentSize + segmentSize / 2);
+        h.SetSequenceNumber(SequenceNumber32(1 + offset));
+        rxBuf.Add(p, h);
+        if (k % 4 == 0)
+        {
+            NS_TEST_ASSERT_MSG_EQ(rxBuf.Add(p->Copy(), h), false, "Duplicate segment stored");
+        }
+
+        // The first block contains the segment, and the blocks do not touch
+        TcpOptionSack::SackList sackList = rxBuf.GetSackList();
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(sackList.size(), 4, "Too many SACK blocks");
+        if (SequenceNumber32(1 + offset) > rxBuf.NextRxSequence())
+        {
+            NS_TEST_ASSERT_MSG_EQ(sackList.empty(), false, "SACK block missing");
+            NS_TEST_ASSERT_MSG_LT_OR_EQ(sackList.front().first,
+                                        SequenceNumber32(1 + offset),
+                                        "Segment not in the first SACK block");
+            NS_TEST_ASSERT_MSG_GT_OR_EQ(sackList.front().second,
+                                        SequenceNumber32(1 + offset + segmentSize),
+                                        "Segment not in the first SACK block");
+        }
+        for (auto a = sackList.begin(); a != sackList.end(); ++a)
+        {
+            NS_TEST_ASSERT_MSG_GT(a->first, rxBuf.NextRxSequence(), "Stale SACK block");
+            for (auto b = std::next(a); b != sackList.end(); ++b)
+            {
+                bool apart = a->second < b->first || b->second < a->first;
+                NS_TEST_ASSERT_MSG_EQ(apart, true, "SACK blocks not merged");
+            }
+        }
+    }
+
+    uint32_t total = segments * segmentSize + segmentSize / 2;
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(1 + total),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackListSize(), 0, "SACK list should be empty");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), total, "Bytes stored more than once");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), total, "Bytes not available");
+
+    // Extract the data in chunks which do not match the segment boundaries
+    std::vector<uint8_t> received;
+    while (Ptr<Packet> p = rxBuf.Extract(37))
+    {
+        uint32_t size = received.size();
+        received.resize(size + p->GetSize());
+        p->CopyData(&received[size], p->GetSize());
+    }
+    NS_TEST_ASSERT_MSG_EQ(received.size(), total, "Wrong number of bytes extracted");
+    bool same = std::equal(received.begin(), received.end(), data.begin());
+    NS_TEST_ASSERT_MSG_EQ(same, true, "Extracted bytes differ from the sent ones");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "Buffer should be empty");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
@@ -10,6 +10,7 @@
 #include "ns3/test.h"
 
 #include <limits>
+#include <vector>
 
 using namespace ns3;
 
@@ -42,6 +43,8 @@ class TcpTxBufferTestCase : public TestCase
     /** \brief Test the logic of merging items in GetTransmittedSegment()
      * which is triggered by CopyFromSequence()*/
     void TestMergeItemsWhenGetTransmittedSegment();
+    /** \brief Test the scoreboard with a large window and many holes */
+    void TestLargeScoreboard();
     /**
      * \brief Callback to provide a value of receiver window
      * \returns the receiver window size
@@ -89,6 +92,13 @@ TcpTxBufferTestCase::DoRun()
                         &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment,
                         this);
 
+    /*
+     * Scoreboard with a thousand segments in flight, every other one being
+     * SACKed: the lost segments are marked incrementally, and NextSeg must
+     * return them in order.
+     */
+    Simulator::Schedule(Seconds(0.0), &TcpTxBufferTestCase::TestLargeScoreboard, this);
+
     Simulator::Run();
     Simulator::Destroy();
 }
@@ -409,6 +419,104 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment()
     txBuf.CopyFromSequence(2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestLargeScoreboard()
+{
+    const uint32_t segments = 1000;
+    const uint32_t segmentSize = 100;
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferTestCase::GetRWnd, this));
+    txBuf->SetMaxBufferSize(segments * segmentSize);
+    txBuf->SetHeadSequence(SequenceNumber32(1));
+    txBuf->SetSegmentSize(segmentSize);
+    txBuf->SetDupAckThresh(3);
+    txBuf->Add(Create<Packet>(segments * segmentSize));
+
+    auto start = [segmentSize](uint32_t segment) {
+        return SequenceNumber32(1 + segment * segmentSize);
+    };
+
+    for (uint32_t i = 0; i < segments; ++i)
+    {
+        txBuf->CopyFromSequence(segmentSize, start(i));
+    }
+
+    // SACK the even segments, one at a time, and compare the lost segments
+    // with the RFC 6675 rule: a segment is lost when three SACKed segments
+    // are above it.
+    std::vector<bool> sacked(segments, false);
+    for (uint32_t i = 2; i < segments - 1; i += 2)
+    {
+        TcpOptionSack::SackList list;
+        list.emplace_back(start(i), start(i + 1));
+        NS_TEST_ASSERT_MSG_EQ(txBuf->Update(list), segmentSize, "Segment " << i << " not SACKed");
+        sacked[i] = true;
+
+        uint32_t lost = 0;
+        uint32_t sackedAbove = 0;
+        for (uint32_t j = segments; j-- > 0;)
+        {
+            if (sacked[j])
+            {
+                ++sackedAbove;
+            }
+            else if (sackedAbove >= 3)
+            {
+                ++lost;
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(),
+                              lost * segmentSize,
+                              "Wrong lost count after SACKing segment " << i);
+        NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(),
+                              (i / 2) * segmentSize,
+                              "Wrong SACKed count after SACKing segment " << i);
+    }
+
+    // Segments 0, 1 and the odd ones up to 993 are lost; 995 and 997 are
+    // holes below the highest SACK, but without three SACKs above them
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(start(993)), true, "Segment 993 should be lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(start(995)), false, "Segment 995 is not lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(start(994)), false, "A SACKed segment is not lost");
+
+    std::vector<uint32_t> expected{0, 1};
+    for (uint32_t i = 3; i <= 993; i += 2)
+    {
+        expected.push_back(i);
+    }
+    SequenceNumber32 seq;
+    SequenceNumber32 seqHigh;
+    for (uint32_t i : expected)
+    {
+        NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&seq, &seqHigh, true), true, "No NextSeg");
+        NS_TEST_ASSERT_MSG_EQ(seq, start(i), "NextSeg should return lost segment " << i);
+        txBuf->CopyFromSequence(segmentSize, seq);
+    }
+    // Rule 3: the first hole which is not lost
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&seq, &seqHigh, true), true, "No NextSeg for rule 3");
+    NS_TEST_ASSERT_MSG_EQ(seq, start(995), "NextSeg should return segment 995 per rule 3");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&seq, &seqHigh, false),
+                          false,
+                          "NextSeg should not apply rule 3 outside recovery");
+
+    uint32_t lost = expected.size() * segmentSize;
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(), lost, "Wrong retransmitted count");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->BytesInFlight(),
+                          segments * segmentSize - 499 * segmentSize,
+                          "Wrong bytes in flight");
+
+    // Cumulative ACK up to segment 501
+    txBuf->DiscardUpTo(start(501));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), 249 * segmentSize, "Wrong SACKed count after ACK");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 247 * segmentSize, "Wrong lost count after ACK");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(),
+                          247 * segmentSize,
+                          "Wrong retransmitted count after ACK");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(start(502)),
+                          true,
+                          "Segment 501 was retransmitted");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock()
 {
@@ -350,7 +350,7 @@ LrWpanHelper::EnablePcapInternal(std::string prefix,
         return;
     }
 
-    PcapHelper pcapHelper;
+    PcapHelper pcapHelper = GetPcapHelper();
 
     std::string filename;
     if (explicitFilename)
@@ -8,6 +8,7 @@
 
 #include "ns3/abort.h"
 #include "ns3/assert.h"
+#include "ns3/callback.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/net-device.h"
@@ -25,6 +26,13 @@ namespace ns3
 NS_LOG_COMPONENT_DEFINE("TraceHelper");
 
 PcapHelper::PcapHelper()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    m_fileFactory.SetTypeId(PcapFileWrapper::GetTypeId());
+}
+
+PcapHelper::PcapHelper(const ObjectFactory& fileFactory)
+    : m_fileFactory(fileFactory)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -43,7 +51,7 @@ PcapHelper::CreateFile(std::string filename,
 {
     NS_LOG_FUNCTION(filename << filemode << dataLinkType << snapLen << tzCorrection);
 
-    Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper>();
+    Ptr<PcapFileWrapper> file = m_fileFactory.Create<PcapFileWrapper>();
     file->Open(filename, filemode);
     NS_ABORT_MSG_IF(file->Fail(), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -424,6 +432,24 @@ PcapHelperForDevice::EnablePcap(std::string prefix,
     EnablePcap(prefix, nd, promiscuous, explicitFilename);
 }
 
+PcapHelper
+PcapHelperForDevice::GetPcapHelper() const
+{
+    return PcapHelper(m_pcapFileFactory);
+}
+
+void
+PcapHelperForDevice::SetPcapFileAttribute(std::string name, const AttributeValue& value)
+{
+    m_pcapFileFactory.Set(name, value);
+}
+
+void
+PcapHelperForDevice::SetPcapCaptureFilter(PcapFileWrapper::CaptureFilterCallback filter)
+{
+    m_pcapFileFactory.Set("CaptureFilter", CallbackValue(filter));
+}
+
 void
 PcapHelperForDevice::EnablePcap(std::string prefix, NetDeviceContainer d, bool promiscuous)
 {
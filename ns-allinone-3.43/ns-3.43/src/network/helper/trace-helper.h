@@ -11,6 +11,7 @@
 #include "node-container.h"
 
 #include "ns3/assert.h"
+#include "ns3/object-factory.h"
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/pcap-file-wrapper.h"
 #include "ns3/simulator.h"
@@ -57,6 +58,17 @@ class PcapHelper
      */
     PcapHelper();
 
+    /**
+     * @brief Create a pcap helper whose files are created by the given factory.
+     *
+     * This allows setting the attributes (e.g., sampling and snap length
+     * settings) of the PcapFileWrapper objects created by CreateFile.
+     *
+     * @param fileFactory the factory of the pcap file wrappers, whose TypeId
+     * must be PcapFileWrapper
+     */
+    explicit PcapHelper(const ObjectFactory& fileFactory);
+
     /**
      * @brief Destroy a pcap helper.
      */
@@ -140,6 +152,8 @@ class PcapHelper
     static void SinkWithHeader(Ptr<PcapFileWrapper> file,
                                const Header& header,
                                Ptr<const Packet> p);
+
+    ObjectFactory m_fileFactory; //!< Factory of the pcap file wrappers
 };
 
 template <typename T>
@@ -617,6 +631,7 @@ class PcapHelperForDevice
      */
     PcapHelperForDevice()
     {
+        m_pcapFileFactory.SetTypeId(PcapFileWrapper::GetTypeId());
     }
 
     /**
@@ -708,6 +723,46 @@ class PcapHelperForDevice
      * @param promiscuous If true capture all possible packets available at the device.
      */
     void EnablePcapAll(std::string prefix, bool promiscuous = false);
+
+    /**
+     * @brief Set an attribute of the PcapFileWrapper objects created by the
+     * subsequent EnablePcap calls of this helper.
+     *
+     * This allows, e.g., capturing only the headers of one packet out of
+     * every hundred on a bottleneck device:
+     * \code{.cpp}
+     * helper.SetPcapFileAttribute("HeaderOnly", BooleanValue(true));
+     * helper.SetPcapFileAttribute("SampleEvery", UintegerValue(100));
+     * helper.EnablePcap("bottleneck", device);
+     * \endcode
+     *
+     * @param name the name of the PcapFileWrapper attribute to set
+     * @param value the value of the attribute
+     */
+    void SetPcapFileAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * @brief Set a predicate deciding which packets are recorded by the pcap
+     * files created by the subsequent EnablePcap calls of this helper.
+     *
+     * @param filter the predicate, which returns true for the packets to record
+     */
+    void SetPcapCaptureFilter(PcapFileWrapper::CaptureFilterCallback filter);
+
+  protected:
+    /**
+     * @brief Get a pcap helper creating the pcap files with the attributes set
+     * through SetPcapFileAttribute and SetPcapCaptureFilter.
+     *
+     * Implementations of EnablePcapInternal use this helper to create their
+     * pcap files.
+     *
+     * @returns the pcap helper
+     */
+    PcapHelper GetPcapHelper() const;
+
+  private:
+    ObjectFactory m_pcapFileFactory; //!< Factory of the pcap file wrappers
 };
 
 /**
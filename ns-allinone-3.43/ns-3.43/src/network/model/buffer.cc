@@ -8,6 +8,7 @@
 #include "buffer.h"
 
 #include "ns3/assert.h"
+#include "ns3/ip-checksum.h"
 #include "ns3/log.h"
 
 #define LOG_INTERNAL_STATE(y)                                                                      \
@@ -1131,17 +1132,37 @@ uint16_t
 Buffer::Iterator::CalculateIpChecksum(uint16_t size, uint32_t initialChecksum)
 {
     NS_LOG_FUNCTION(this << size << initialChecksum);
-    /* see RFC 1071 to understand this code. */
-    uint32_t sum = initialChecksum;
-
-    for (int j = 0; j < size / 2; j++)
+    NS_ASSERT_MSG(m_current >= m_dataStart && m_current + size <= m_dataEnd,
+                  GetReadErrorMessage());
+    /* see RFC 1071 to understand this code. The bytes before and after the
+     * virtual zero area are summed separately by the vectorized IpChecksumAdd,
+     * and the zero area itself adds nothing to the sum.  A sum which starts
+     * at an odd offset is byte-swapped, as per section 2 (B) of RFC 1071.
+     */
+    uint64_t sum = initialChecksum;
+    uint32_t start = m_current;
+    uint32_t end = m_current + size;
+
+    if (m_current < m_zeroStart)
     {
-        sum += ReadU16();
+        uint32_t chunkEnd = std::min(end, m_zeroStart);
+        sum += IpChecksumAdd(m_data + m_current, chunkEnd - m_current);
+        m_current = chunkEnd;
     }
-
-    if (size & 1)
+    if (m_current < m_zeroEnd)
+    {
+        m_current = std::min(end, m_zeroEnd);
+    }
+    if (m_current < end)
     {
-        sum += ReadU8();
+        uint16_t partial =
+            IpChecksumAdd(m_data + m_current - (m_zeroEnd - m_zeroStart), end - m_current);
+        if ((m_current - start) & 1)
+        {
+            partial = (partial << 8) | (partial >> 8);
+        }
+        sum += partial;
+        m_current = end;
     }
 
     while (sum >> 16)
@@ -479,6 +479,17 @@ class Buffer
      */
     inline uint32_t GetSize() const;
 
+    /**
+     * \return the number of bytes stored in front of the "virtual zero
+     * area", or the size of the buffer if it has no virtual zero area.
+     *
+     * For a buffer created with a zero-filled payload, these are the bytes
+     * which were added at the start of the buffer afterwards, typically
+     * protocol headers.  Obtaining this value does not require the zero
+     * area to be materialized.
+     */
+    inline uint32_t GetZeroAreaOffset() const;
+
     /**
      * \return a pointer to the start of the internal
      * byte buffer.
@@ -1059,6 +1070,16 @@ Buffer::GetSize() const
     return m_end - m_start;
 }
 
+uint32_t
+Buffer::GetZeroAreaOffset() const
+{
+    if (m_zeroAreaStart == m_zeroAreaEnd)
+    {
+        return GetSize();
+    }
+    return m_zeroAreaStart - m_start;
+}
+
 Buffer::Iterator
 Buffer::Begin() const
 {
@@ -297,6 +297,15 @@ class Packet : public SimpleRefCount<Packet>
      * \returns the size in bytes of the packet
      */
     inline uint32_t GetSize() const;
+    /**
+     * \brief Returns the number of bytes in front of the zero-filled initial
+     * payload, i.e., the size of the headers added to a packet created
+     * with a zero-filled payload.
+     *
+     * \returns the number of bytes in front of the zero-filled payload, or
+     * the size of the packet if it has no zero-filled payload
+     */
+    inline uint32_t GetZeroAreaOffset() const;
     /**
      * \brief Add header to this packet.
      *
@@ -852,6 +861,12 @@ Packet::GetSize() const
     return m_buffer.GetSize();
 }
 
+uint32_t
+Packet::GetZeroAreaOffset() const
+{
+    return m_buffer.GetZeroAreaOffset();
+}
+
 } // namespace ns3
 
 #endif /* PACKET_H */
@@ -7,10 +7,15 @@
  */
 
 #include "ns3/buffer.h"
+#include "ns3/crc32.h"
 #include "ns3/double.h"
+#include "ns3/ip-checksum.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
 
+#include <random>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -384,6 +389,137 @@ BufferTest::DoRun()
     NS_TEST_ASSERT_MSG_EQ(val1, val2, "Bad ReadNtohU16()");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Checksum and CRC-32 unit tests: every implementation must give the same
+ * results as the reference one.
+ */
+class ChecksumTest : public TestCase
+{
+  public:
+    ChecksumTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Byte-wise computation of the Internet checksum of a buffer region
+     * \param i iterator to the start of the region
+     * \param size size of the region
+     * \returns the checksum
+     */
+    static uint16_t ReferenceIpChecksum(Buffer::Iterator i, uint16_t size);
+};
+
+ChecksumTest::ChecksumTest()
+    : TestCase("Checksum and CRC-32 implementations")
+{
+}
+
+uint16_t
+ChecksumTest::ReferenceIpChecksum(Buffer::Iterator i, uint16_t size)
+{
+    uint32_t sum = 0;
+    for (int j = 0; j < size / 2; j++)
+    {
+        sum += i.ReadU16();
+    }
+    if (size & 1)
+    {
+        sum += i.ReadU8();
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return ~sum;
+}
+
+void
+ChecksumTest::DoRun()
+{
+    std::mt19937 rng(1);
+    std::vector<uint8_t> data(4100);
+    for (auto& byte : data)
+    {
+        byte = rng();
+    }
+    // all-ones words stress the carries
+    std::vector<uint8_t> ones(1100000, 0xff);
+
+    IpChecksumAddFunction reference = GetIpChecksumAddImplementation("reference");
+    for (const auto& name : GetIpChecksumAddImplementations())
+    {
+        IpChecksumAddFunction impl = GetIpChecksumAddImplementation(name);
+        NS_TEST_ASSERT_MSG_NE(impl, nullptr, "Implementation " << name << " not found");
+        for (uint32_t offset = 0; offset < 4; offset++)
+        {
+            for (uint32_t length = 0; length + offset <= data.size(); length += 1 + length / 8)
+            {
+                NS_TEST_EXPECT_MSG_EQ(impl(data.data() + offset, length),
+                                      reference(data.data() + offset, length),
+                                      name << " sum of " << length << " bytes at " << offset);
+            }
+        }
+        NS_TEST_EXPECT_MSG_EQ(impl(ones.data(), ones.size()),
+                              reference(ones.data(), ones.size()),
+                              name << " sum of all-ones words");
+    }
+
+    // checksum of buffer regions overlapping the virtual zero area
+    for (uint32_t before = 0; before < 40; before += 3)
+    {
+        for (uint32_t after = 0; after < 40; after += 5)
+        {
+            Buffer buffer(37);
+            buffer.AddAtStart(before);
+            buffer.Begin().Write(data.data(), before);
+            buffer.AddAtEnd(after);
+            Buffer::Iterator end = buffer.End();
+            end.Prev(after);
+            end.Write(data.data() + before, after);
+            for (uint32_t start = 0; start < buffer.GetSize(); start += 7)
+            {
+                for (uint32_t size = 0; start + size <= buffer.GetSize(); size += 3)
+                {
+                    Buffer::Iterator i = buffer.Begin();
+                    i.Next(start);
+                    uint16_t expected = ReferenceIpChecksum(i, size);
+                    NS_TEST_EXPECT_MSG_EQ(i.CalculateIpChecksum(size),
+                                          expected,
+                                          "Checksum of " << size << " bytes at " << start);
+                    NS_TEST_EXPECT_MSG_EQ(i.GetDistanceFrom(buffer.Begin()),
+                                          start + size,
+                                          "Iterator not moved past the region");
+                }
+            }
+        }
+    }
+
+    CRC32Function crcReference = GetCRC32Implementation("table");
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    for (const auto& name : GetCRC32Implementations())
+    {
+        CRC32Function impl = GetCRC32Implementation(name);
+        NS_TEST_ASSERT_MSG_NE(impl, nullptr, "Implementation " << name << " not found");
+        NS_TEST_EXPECT_MSG_EQ(impl(check, sizeof(check)), 0xcbf43926, name << " check value");
+        for (uint32_t offset = 0; offset < 4; offset++)
+        {
+            for (uint32_t length = 0; length + offset <= data.size(); length += 1 + length / 8)
+            {
+                NS_TEST_EXPECT_MSG_EQ(impl(data.data() + offset, static_cast<int>(length)),
+                                      crcReference(data.data() + offset, static_cast<int>(length)),
+                                      name << " CRC of " << length << " bytes at " << offset);
+            }
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(CRC32Calculate(data.data(), data.size()),
+                          crcReference(data.data(), data.size()),
+                          "CRC32Calculate does not match the reference");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -400,6 +536,7 @@ BufferTestSuite::BufferTestSuite()
     : TestSuite("buffer", Type::UNIT)
 {
     AddTestCase(new BufferTest, TestCase::Duration::QUICK);
+    AddTestCase(new ChecksumTest, TestCase::Duration::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
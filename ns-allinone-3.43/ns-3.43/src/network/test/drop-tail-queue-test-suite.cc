@@ -5,9 +5,13 @@
  */
 
 #include "ns3/drop-tail-queue.h"
+#include "ns3/object-factory.h"
+#include "ns3/ring-buffer.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
 
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -76,6 +80,111 @@ DropTailQueueTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(packet, nullptr, "There are really no packets in there");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * RingBuffer unit tests.
+ */
+class RingBufferTestCase : public TestCase
+{
+  public:
+    RingBufferTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Check the content of a buffer
+     * \param buffer the buffer
+     * \param expected the expected elements, from front to back
+     */
+    void CheckContent(const RingBuffer<int>& buffer, const std::vector<int>& expected);
+};
+
+RingBufferTestCase::RingBufferTestCase()
+    : TestCase("Sanity check on the ring buffer used as queue container")
+{
+}
+
+void
+RingBufferTestCase::CheckContent(const RingBuffer<int>& buffer, const std::vector<int>& expected)
+{
+    NS_TEST_ASSERT_MSG_EQ(buffer.size(), expected.size(), "Unexpected number of elements");
+    auto it = buffer.begin();
+    for (std::size_t i = 0; i < expected.size(); ++i, ++it)
+    {
+        NS_TEST_EXPECT_MSG_EQ(*it, expected[i], "Unexpected element at position " << i);
+    }
+    NS_TEST_EXPECT_MSG_EQ((it == buffer.end()), true, "Iterator should be at the end");
+}
+
+void
+RingBufferTestCase::DoRun()
+{
+    RingBuffer<int> buffer;
+    NS_TEST_EXPECT_MSG_EQ(buffer.empty(), true, "The buffer should be empty");
+
+    // fill the buffer, then make the elements wrap around the end of the storage
+    buffer.reserve(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        buffer.insert(buffer.end(), i);
+    }
+    NS_TEST_EXPECT_MSG_EQ(buffer.capacity(), 4, "No reallocation expected");
+    buffer.erase(buffer.begin());
+    buffer.erase(buffer.begin());
+    buffer.insert(buffer.end(), 4);
+    buffer.insert(buffer.end(), 5);
+    NS_TEST_EXPECT_MSG_EQ(buffer.capacity(), 4, "No reallocation expected");
+    CheckContent(buffer, {2, 3, 4, 5});
+
+    // grow while wrapped around
+    buffer.insert(buffer.end(), 6);
+    NS_TEST_EXPECT_MSG_GT(buffer.capacity(), 4, "The buffer should have grown");
+    CheckContent(buffer, {2, 3, 4, 5, 6});
+
+    // insertion and removal at any position
+    auto it = buffer.insert(buffer.begin() + 2, 10);
+    NS_TEST_EXPECT_MSG_EQ(*it, 10, "Iterator should point to the inserted element");
+    buffer.insert(buffer.begin(), 11);
+    CheckContent(buffer, {11, 2, 3, 10, 4, 5, 6});
+    it = buffer.erase(buffer.begin() + 3);
+    NS_TEST_EXPECT_MSG_EQ(*it, 4, "Iterator should point to the following element");
+    it = buffer.erase(buffer.end() - 1);
+    NS_TEST_EXPECT_MSG_EQ((it == buffer.end()), true, "Iterator should be at the end");
+    CheckContent(buffer, {11, 2, 3, 4, 5});
+
+    buffer.clear();
+    CheckContent(buffer, {});
+
+    // a queue with a maximum size in packets sizes its container once
+    Ptr<DropTailQueue<Packet>> queue =
+        CreateObjectWithAttributes<DropTailQueue<Packet>>("MaxSize", StringValue("1000p"));
+    for (uint32_t i = 0; i < 1999; ++i)
+    {
+        queue->Enqueue(Create<Packet>(100));
+        if (i % 2 == 1)
+        {
+            queue->Dequeue();
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(), 1000, "The queue should be full");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetTotalDroppedPackets(), 0, "No packet should be dropped");
+
+    // a queue with a maximum size in bytes grows its container on demand
+    queue = CreateObjectWithAttributes<DropTailQueue<Packet>>("MaxSize", StringValue("100000B"));
+    for (uint32_t i = 0; i < 2000; ++i)
+    {
+        queue->Enqueue(Create<Packet>(100));
+    }
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(), 1000, "The queue should be full");
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        NS_TEST_ASSERT_MSG_NE(queue->Dequeue(), nullptr, "The queue should not be empty");
+    }
+    NS_TEST_EXPECT_MSG_EQ(queue->Dequeue(), nullptr, "The queue should be empty");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -89,6 +198,7 @@ class DropTailQueueTestSuite : public TestSuite
         : TestSuite("drop-tail-queue", Type::UNIT)
     {
         AddTestCase(new DropTailQueueTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new RingBufferTestCase(), TestCase::Duration::QUICK);
     }
 };
 
@@ -4,15 +4,32 @@
  * Author:  Craig Dowell (craigdo@ee.washington.edu)
  */
 
+#include "ns3/boolean.h"
+#include "ns3/callback.h"
+#include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
+#include "ns3/mapped-pcap-file.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/pcap-file-wrapper.h"
 #include "ns3/pcap-file.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/trace-helper.h"
+#include "ns3/uinteger.h"
 
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace ns3;
 
@@ -48,6 +65,13 @@ CheckFileExists(std::string filename)
     return true;
 }
 
+static std::string
+ReadFileContents(std::string filename)
+{
+    std::ifstream in(filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
 static bool
 CheckFileLength(std::string filename, long sizeExpected)
 {
@@ -1364,6 +1388,417 @@ DiffTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that batched (background thread) writes,
+ * with and without compression, produce the same file as synchronous writes.
+ */
+class BatchedWriteTestCase : public TestCase
+{
+  public:
+    BatchedWriteTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Write the known packets to a file.
+     * \param filename file name
+     * \param batchSize batch size, 0 for synchronous writes
+     * \param compression compression of the written file
+     */
+    void WriteKnownPackets(std::string filename,
+                           uint32_t batchSize,
+                           PcapBatchWriter::Compression compression);
+};
+
+BatchedWriteTestCase::BatchedWriteTestCase()
+    : TestCase("Check that batched PcapFile writes match synchronous writes")
+{
+}
+
+void
+BatchedWriteTestCase::WriteKnownPackets(std::string filename,
+                                        uint32_t batchSize,
+                                        PcapBatchWriter::Compression compression)
+{
+    PcapFile f;
+    f.EnableBatching(batchSize, compression);
+    f.Open(filename, std::ios::out);
+    NS_TEST_ASSERT_MSG_EQ(f.Fail(), false, "Open (" << filename << ") returns error");
+    f.Init(1, N_PACKET_BYTES);
+    for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+        const PacketEntry& p = knownPackets[i];
+        f.Write(p.tsSec, p.tsUsec, (const uint8_t*)p.data, p.origLen);
+        NS_TEST_EXPECT_MSG_EQ(f.Fail(), false, "Write must not fail");
+    }
+    f.Close();
+    NS_TEST_EXPECT_MSG_EQ(f.Fail(), false, "Close must not fail");
+}
+
+void
+BatchedWriteTestCase::DoRun()
+{
+    std::string syncFilename = CreateTempDirFilename("sync.pcap");
+    std::string batchedFilename = CreateTempDirFilename("batched.pcap");
+
+    WriteKnownPackets(syncFilename, 0, PcapBatchWriter::COMPRESSION_NONE);
+    // A batch size smaller than most records forces one hand-over per record
+    WriteKnownPackets(batchedFilename, 64, PcapBatchWriter::COMPRESSION_NONE);
+
+    std::string expected = ReadFileContents(syncFilename);
+    NS_TEST_ASSERT_MSG_EQ(expected.empty(), false, "Synchronous file is empty");
+    NS_TEST_EXPECT_MSG_EQ((ReadFileContents(batchedFilename) == expected),
+                          true,
+                          "Batched file differs from synchronous file");
+
+    WriteKnownPackets(batchedFilename, 1 << 20, PcapBatchWriter::COMPRESSION_NONE);
+    NS_TEST_EXPECT_MSG_EQ((ReadFileContents(batchedFilename) == expected),
+                          true,
+                          "Single-batch file differs from synchronous file");
+
+#ifdef HAVE_ZLIB
+    std::string gzFilename = CreateTempDirFilename("batched.pcap.gz");
+    WriteKnownPackets(gzFilename, 256, PcapBatchWriter::COMPRESSION_GZIP);
+    gzFile gz = gzopen(gzFilename.c_str(), "rb");
+    NS_TEST_ASSERT_MSG_NE(gz, nullptr, "Unable to open " << gzFilename);
+    std::string inflated;
+    char chunk[4096];
+    int n;
+    while ((n = gzread(gz, chunk, sizeof(chunk))) > 0)
+    {
+        inflated.append(chunk, n);
+    }
+    gzclose(gz);
+    NS_TEST_EXPECT_MSG_EQ((inflated == expected),
+                          true,
+                          "Decompressed file differs from synchronous file");
+    remove(gzFilename.c_str());
+#endif
+
+    remove(syncFilename.c_str());
+    remove(batchedFilename.c_str());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that several PcapFileWrapper objects can
+ * share a single pcapng file.
+ */
+class PcapNgSharedFileTestCase : public TestCase
+{
+  public:
+    PcapNgSharedFileTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PcapNgSharedFileTestCase::PcapNgSharedFileTestCase()
+    : TestCase("Check that PcapFileWrapper objects can share a pcapng file")
+{
+}
+
+void
+PcapNgSharedFileTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("shared.pcapng");
+
+    {
+        auto first = CreateObject<PcapFileWrapper>();
+        first->SetAttribute("PcapNgFile", StringValue(filename));
+        first->SetAttribute("BatchSize", UintegerValue(128));
+        first->Open("first", std::ios::out);
+        first->Init(1, 100);
+        NS_TEST_ASSERT_MSG_EQ(first->IsPcapNg(), true, "Wrapper should write to pcapng");
+
+        auto second = CreateObject<PcapFileWrapper>();
+        second->SetAttribute("PcapNgFile", StringValue(filename));
+        second->Open("second", std::ios::out);
+        second->Init(9, 40);
+
+        first->Write(NanoSeconds(1), Create<Packet>(60));
+        second->Write(NanoSeconds(2), Create<Packet>(61));
+        first->Write(Seconds(5), Create<Packet>(200));
+        NS_TEST_EXPECT_MSG_EQ(first->Fail(), false, "Write must not fail");
+        NS_TEST_EXPECT_MSG_EQ(second->Fail(), false, "Write must not fail");
+        // the file is closed once the last wrapper goes away
+    }
+
+    std::string contents = ReadFileContents(filename);
+    auto read32 = [&contents](std::size_t offset) {
+        uint32_t value = 0;
+        std::memcpy(&value, contents.data() + offset, sizeof(value));
+        return value;
+    };
+
+    std::vector<uint32_t> blockTypes;
+    std::vector<uint32_t> packetInterfaces;
+    std::vector<uint32_t> capturedLengths;
+    std::size_t offset = 0;
+    while (offset + 12 <= contents.size())
+    {
+        uint32_t type = read32(offset);
+        uint32_t length = read32(offset + 4);
+        NS_TEST_ASSERT_MSG_EQ((length >= 12 && length % 4 == 0), true, "Invalid block length");
+        NS_TEST_ASSERT_MSG_EQ(read32(offset + length - 4), length, "Block length mismatch");
+        blockTypes.push_back(type);
+        if (type == 6)
+        {
+            packetInterfaces.push_back(read32(offset + 8));
+            capturedLengths.push_back(read32(offset + 20));
+        }
+        offset += length;
+    }
+    NS_TEST_EXPECT_MSG_EQ(offset, contents.size(), "Trailing garbage in the file");
+
+    std::vector<uint32_t> expectedTypes = {0x0a0d0d0a, 1, 1, 6, 6, 6};
+    NS_TEST_EXPECT_MSG_EQ((blockTypes == expectedTypes), true, "Unexpected block sequence");
+    std::vector<uint32_t> expectedInterfaces = {0, 1, 0};
+    NS_TEST_EXPECT_MSG_EQ((packetInterfaces == expectedInterfaces),
+                          true,
+                          "Packets written on the wrong interface");
+    // The snap length of each interface is honored
+    std::vector<uint32_t> expectedLengths = {60, 40, 100};
+    NS_TEST_EXPECT_MSG_EQ((capturedLengths == expectedLengths),
+                          true,
+                          "Unexpected captured lengths");
+
+    remove(filename.c_str());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that the sampling, capture filter and
+ * header-only attributes of PcapFileWrapper select the recorded packets.
+ */
+class SampledCaptureTestCase : public TestCase
+{
+  public:
+    SampledCaptureTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Read back the lengths of the records of a pcap file.
+     * \param filename file name
+     * \returns the (included length, original length) of each record
+     */
+    std::vector<std::pair<uint32_t, uint32_t>> ReadRecordLengths(std::string filename);
+
+    /**
+     * Capture filter used by the test.
+     * \param p the packet
+     * \returns true unless the packet is 100 bytes long
+     */
+    static bool RejectHundredBytes(Ptr<const Packet> p);
+};
+
+SampledCaptureTestCase::SampledCaptureTestCase()
+    : TestCase("Check that PcapFileWrapper sampling and header-only capture work")
+{
+}
+
+bool
+SampledCaptureTestCase::RejectHundredBytes(Ptr<const Packet> p)
+{
+    return p->GetSize() != 100;
+}
+
+std::vector<std::pair<uint32_t, uint32_t>>
+SampledCaptureTestCase::ReadRecordLengths(std::string filename)
+{
+    std::vector<std::pair<uint32_t, uint32_t>> lengths;
+    PcapFile f;
+    f.Open(filename, std::ios::in);
+    uint8_t data[2048];
+    uint32_t tsSec;
+    uint32_t tsUsec;
+    uint32_t inclLen;
+    uint32_t origLen;
+    uint32_t readLen;
+    while (true)
+    {
+        f.Read(data, sizeof(data), tsSec, tsUsec, inclLen, origLen, readLen);
+        if (f.Fail())
+        {
+            break;
+        }
+        lengths.emplace_back(inclLen, origLen);
+    }
+    f.Close();
+    return lengths;
+}
+
+void
+SampledCaptureTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("sampled.pcap");
+
+    // One packet out of every three, starting with the first one, in a file
+    // created by a pcap helper with a file factory
+    {
+        ObjectFactory factory;
+        factory.SetTypeId(PcapFileWrapper::GetTypeId());
+        factory.Set("SampleEvery", UintegerValue(3));
+        PcapHelper helper(factory);
+        auto file = helper.CreateFile(filename, std::ios::out, PcapHelper::DLT_EN10MB);
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            file->Write(MilliSeconds(i), Create<Packet>(10 + i));
+        }
+        NS_TEST_EXPECT_MSG_EQ(file->GetNSkippedPackets(),
+                              5,
+                              "Unexpected number of skipped packets");
+    }
+    auto lengths = ReadRecordLengths(filename);
+    NS_TEST_ASSERT_MSG_EQ(lengths.size(), 3, "Unexpected number of recorded packets");
+    NS_TEST_EXPECT_MSG_EQ(lengths[0].second, 10, "First packet not recorded");
+    NS_TEST_EXPECT_MSG_EQ(lengths[1].second, 13, "Fourth packet not recorded");
+    NS_TEST_EXPECT_MSG_EQ(lengths[2].second, 16, "Seventh packet not recorded");
+
+    // The first 2 ms of every 10 ms, and a capture filter
+    {
+        auto file = CreateObject<PcapFileWrapper>();
+        file->SetAttribute("SampleWindowPeriod", TimeValue(MilliSeconds(10)));
+        file->SetAttribute("SampleWindowDuration", TimeValue(MilliSeconds(2)));
+        file->SetAttribute("CaptureFilter", CallbackValue(MakeCallback(&RejectHundredBytes)));
+        file->Open(filename, std::ios::out);
+        file->Init(1);
+        file->Write(MilliSeconds(0), Create<Packet>(20));
+        file->Write(MilliSeconds(1), Create<Packet>(100));
+        file->Write(MilliSeconds(3), Create<Packet>(21));
+        file->Write(MilliSeconds(10), Create<Packet>(22));
+        file->Write(MilliSeconds(15), Create<Packet>(23));
+        file->Write(MilliSeconds(21), Create<Packet>(24));
+    }
+    lengths = ReadRecordLengths(filename);
+    NS_TEST_ASSERT_MSG_EQ(lengths.size(), 3, "Unexpected number of recorded packets");
+    NS_TEST_EXPECT_MSG_EQ(lengths[0].second, 20, "Unexpected recorded packet");
+    NS_TEST_EXPECT_MSG_EQ(lengths[1].second, 22, "Unexpected recorded packet");
+    NS_TEST_EXPECT_MSG_EQ(lengths[2].second, 24, "Unexpected recorded packet");
+
+    // Only the headers in front of the zero-filled payload
+    {
+        auto file = CreateObject<PcapFileWrapper>();
+        file->SetAttribute("HeaderOnly", BooleanValue(true));
+        file->Open(filename, std::ios::out);
+        file->Init(1);
+        Ptr<Packet> p = Create<Packet>(1000);
+        LlcSnapHeader llc;
+        p->AddHeader(llc);
+        file->Write(Seconds(1), p);
+        file->Write(Seconds(2), llc, Create<Packet>(500));
+        uint8_t data[30] = {};
+        file->Write(Seconds(3), Create<Packet>(data, sizeof(data)));
+    }
+    lengths = ReadRecordLengths(filename);
+    NS_TEST_ASSERT_MSG_EQ(lengths.size(), 3, "Unexpected number of recorded packets");
+    NS_TEST_EXPECT_MSG_EQ(lengths[0].first, 8, "Only the LLC/SNAP header should be recorded");
+    NS_TEST_EXPECT_MSG_EQ(lengths[0].second, 1008, "Original length must not change");
+    NS_TEST_EXPECT_MSG_EQ(lengths[1].first, 8, "Only the LLC/SNAP header should be recorded");
+    NS_TEST_EXPECT_MSG_EQ(lengths[1].second, 508, "Original length must not change");
+    NS_TEST_EXPECT_MSG_EQ(lengths[2].first, 30, "Packets without zero payload are recorded");
+
+    remove(filename.c_str());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that MappedPcapFile indexes and reads the
+ * records written by PcapFile, in both byte orders.
+ */
+class MappedPcapFileTestCase : public TestCase
+{
+  public:
+    MappedPcapFileTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MappedPcapFileTestCase::MappedPcapFileTestCase()
+    : TestCase("Check that MappedPcapFile indexes and reads pcap files")
+{
+}
+
+void
+MappedPcapFileTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("mapped.pcap");
+    uint8_t data[64];
+    for (uint32_t i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = i;
+    }
+
+    for (bool swapMode : {false, true})
+    {
+        PcapFile f;
+        f.Open(filename, std::ios::out);
+        f.Init(1, 48, PcapFile::ZONE_DEFAULT, swapMode);
+        f.Write(10, 0, data, 20);
+        f.Write(10, 250, data, 64);
+        f.Write(12, 999999, data, 1);
+        f.Close();
+
+        MappedPcapFile mapped;
+        NS_TEST_ASSERT_MSG_EQ(mapped.Open(filename), true, "Unable to map " << filename);
+        NS_TEST_EXPECT_MSG_EQ(mapped.GetSwapMode(), swapMode, "Wrong byte order");
+        NS_TEST_EXPECT_MSG_EQ(mapped.GetDataLinkType(), 1, "Wrong data link type");
+        NS_TEST_EXPECT_MSG_EQ(mapped.GetSnapLen(), 48, "Wrong snap length");
+        NS_TEST_ASSERT_MSG_EQ(mapped.GetNRecords(), 3, "Wrong number of records");
+        NS_TEST_EXPECT_MSG_EQ(mapped.GetTimestamp(0), 10000000000ULL, "Wrong timestamp");
+        NS_TEST_EXPECT_MSG_EQ(mapped.GetTimestamp(1), 10000250000ULL, "Wrong timestamp");
+        NS_TEST_EXPECT_MSG_EQ(mapped.GetTimestamp(2), 12999999000ULL, "Wrong timestamp");
+        NS_TEST_EXPECT_MSG_EQ(mapped.GetCapturedLength(1), 48, "Wrong captured length");
+        NS_TEST_EXPECT_MSG_EQ(mapped.GetOriginalLength(1), 64, "Wrong original length");
+        NS_TEST_EXPECT_MSG_EQ(std::memcmp(mapped.GetData(1), data, 48), 0, "Wrong record data");
+
+        Ptr<Packet> p = mapped.GetPacket(1);
+        NS_TEST_EXPECT_MSG_EQ(p->GetSize(), 48, "Wrong packet size");
+        p = mapped.GetPacket(1, true);
+        NS_TEST_EXPECT_MSG_EQ(p->GetSize(), 64, "Wrong padded packet size");
+        uint8_t copy[64];
+        p->CopyData(copy, sizeof(copy));
+        NS_TEST_EXPECT_MSG_EQ(std::memcmp(copy, data, 48), 0, "Wrong packet data");
+        NS_TEST_EXPECT_MSG_EQ(copy[63], 0, "Padding must be zero");
+
+        NS_TEST_EXPECT_MSG_EQ(mapped.Find(0), 0, "Wrong record found");
+        NS_TEST_EXPECT_MSG_EQ(mapped.Find(10000000001ULL), 1, "Wrong record found");
+        NS_TEST_EXPECT_MSG_EQ(mapped.Find(12999999000ULL), 2, "Wrong record found");
+        NS_TEST_EXPECT_MSG_EQ(mapped.Find(13000000000ULL), 3, "Wrong record found");
+    }
+
+    // A truncated last record is ignored
+    std::ifstream in(filename, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out.write(content.data(), content.size() - 1);
+    out.close();
+    MappedPcapFile mapped;
+    NS_TEST_ASSERT_MSG_EQ(mapped.Open(filename), true, "Unable to map " << filename);
+    NS_TEST_EXPECT_MSG_EQ(mapped.GetNRecords(), 2, "Truncated record not ignored");
+    mapped.Close();
+
+    NS_TEST_EXPECT_MSG_EQ(mapped.Open(CreateTempDirFilename("missing.pcap")),
+                          false,
+                          "Mapped a missing file");
+
+    remove(filename.c_str());
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1387,6 +1822,10 @@ PcapFileTestSuite::PcapFileTestSuite()
     AddTestCase(new RecordHeaderTestCase, TestCase::Duration::QUICK);
     AddTestCase(new ReadFileTestCase, TestCase::Duration::QUICK);
     AddTestCase(new DiffTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new BatchedWriteTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new PcapNgSharedFileTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new SampledCaptureTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new MappedPcapFileTestCase, TestCase::Duration::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
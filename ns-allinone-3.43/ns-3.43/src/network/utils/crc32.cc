@@ -13,7 +13,15 @@
  * COPYRIGHT (C) 1986 Gary S. Brown.  You may use this program, or
  * code or tables extracted from it, as desired without restriction.
  */
-#include <stdint.h>
+#include "crc32.h"
+
+#include <array>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NS3_CRC32_X86
+#include <immintrin.h>
+#endif
 
 namespace ns3
 {
@@ -56,16 +64,257 @@ static uint32_t crc32table[256] = {
     0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
 };
 
-uint32_t
-CRC32Calculate(const uint8_t* data, int length)
+/// Tables of the slicing-by-8 implementation
+typedef std::array<std::array<uint32_t, 256>, 8> CRC32SliceTables;
+
+/**
+ * Build the tables of the slicing-by-8 implementation: entry i of table k
+ * is the CRC-32 register after processing byte i followed by k zero bytes.
+ *
+ * \returns the tables
+ */
+static CRC32SliceTables
+CRC32MakeSliceTables()
 {
-    uint32_t crc = 0xffffffff;
+    CRC32SliceTables tables;
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        tables[0][i] = crc32table[i];
+    }
+    for (uint32_t k = 1; k < 8; k++)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t previous = tables[k - 1][i];
+            tables[k][i] = (previous >> 8) ^ crc32table[previous & 0xff];
+        }
+    }
+    return tables;
+}
+
+/// Tables of the slicing-by-8 implementation
+static const CRC32SliceTables crc32SliceTables = CRC32MakeSliceTables();
 
+/**
+ * Update a CRC-32 register one byte at a time.
+ *
+ * \param crc the CRC-32 register
+ * \param data the bytes to process
+ * \param length the number of bytes to process
+ * \returns the updated register
+ */
+static uint32_t
+CRC32UpdateTable(uint32_t crc, const uint8_t* data, uint32_t length)
+{
     while (length--)
     {
         crc = (crc >> 8) ^ crc32table[(crc & 0xFF) ^ *data++];
     }
-    return ~crc;
+    return crc;
+}
+
+/**
+ * Update a CRC-32 register eight bytes at a time (slicing-by-8).
+ *
+ * \param crc the CRC-32 register
+ * \param data the bytes to process
+ * \param length the number of bytes to process
+ * \returns the updated register
+ */
+static uint32_t
+CRC32UpdateSlice8(uint32_t crc, const uint8_t* data, uint32_t length)
+{
+    const auto& t = crc32SliceTables;
+    for (; length >= 8; data += 8, length -= 8)
+    {
+        uint32_t low = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
+        uint32_t high = data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24);
+        crc = t[7][low & 0xff] ^ t[6][(low >> 8) & 0xff] ^ t[5][(low >> 16) & 0xff] ^
+              t[4][low >> 24] ^ t[3][high & 0xff] ^ t[2][(high >> 8) & 0xff] ^
+              t[1][(high >> 16) & 0xff] ^ t[0][high >> 24];
+    }
+    return CRC32UpdateTable(crc, data, length);
+}
+
+#ifdef NS3_CRC32_X86
+
+/**
+ * Fold a 128-bit accumulator into the next 16 bytes of input.
+ *
+ * \param acc the accumulator
+ * \param next the next 16 bytes
+ * \param k the folding constants
+ * \returns the new accumulator
+ */
+__attribute__((target("pclmul,sse4.1"))) static inline __m128i
+CRC32Fold(__m128i acc, __m128i next, __m128i k)
+{
+    return _mm_xor_si128(
+        _mm_xor_si128(_mm_clmulepi64_si128(acc, k, 0x11), _mm_clmulepi64_si128(acc, k, 0x00)),
+        next);
+}
+
+/**
+ * Load 16 bytes of input.
+ *
+ * \param data the input
+ * \returns the 16 bytes
+ */
+__attribute__((target("pclmul,sse4.1"))) static inline __m128i
+CRC32Load(const uint8_t* data)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+/**
+ * Update a CRC-32 register by folding 64 bytes at a time with carry-less
+ * multiplications.  See "Fast CRC Computation for Generic Polynomials
+ * Using PCLMULQDQ Instruction", V. Gopal et al., Intel, 2009; the
+ * constants are those given for the bit-reflected CRC-32 at the end of
+ * the paper.  The bytes which do not fill a 16-byte block are processed
+ * with the slicing-by-8 implementation.
+ *
+ * \param crc the CRC-32 register
+ * \param data the bytes to process
+ * \param length the number of bytes to process
+ * \returns the updated register
+ */
+__attribute__((target("pclmul,sse4.1"))) static uint32_t
+CRC32UpdatePclmul(uint32_t crc, const uint8_t* data, uint32_t length)
+{
+    if (length < 64)
+    {
+        return CRC32UpdateSlice8(crc, data, length);
+    }
+
+    alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+    uint32_t tail = length & 15;
+    length -= tail;
+
+    // fold 64 bytes at a time into four 128-bit accumulators
+    __m128i x1 = _mm_xor_si128(CRC32Load(data), _mm_cvtsi32_si128(crc));
+    __m128i x2 = CRC32Load(data + 16);
+    __m128i x3 = CRC32Load(data + 32);
+    __m128i x4 = CRC32Load(data + 48);
+    __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    data += 64;
+    length -= 64;
+    for (; length >= 64; data += 64, length -= 64)
+    {
+        x1 = CRC32Fold(x1, CRC32Load(data), k);
+        x2 = CRC32Fold(x2, CRC32Load(data + 16), k);
+        x3 = CRC32Fold(x3, CRC32Load(data + 32), k);
+        x4 = CRC32Fold(x4, CRC32Load(data + 48), k);
+    }
+
+    // fold the accumulators, then the remaining 16-byte blocks, into one
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    x1 = CRC32Fold(x1, x2, k);
+    x1 = CRC32Fold(x1, x3, k);
+    x1 = CRC32Fold(x1, x4, k);
+    for (; length >= 16; data += 16, length -= 16)
+    {
+        x1 = CRC32Fold(x1, CRC32Load(data), k);
+    }
+
+    // reduce 128 bits to 64 bits
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00), x2);
+
+    // Barrett reduction to 32 bits
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    crc = _mm_extract_epi32(x1, 1);
+
+    return CRC32UpdateSlice8(crc, data, tail);
+}
+
+#endif /* NS3_CRC32_X86 */
+
+/**
+ * \copydoc CRC32Calculate
+ *
+ * Reference implementation, processing one byte at a time.
+ */
+static uint32_t
+CRC32CalculateTable(const uint8_t* data, int length)
+{
+    return ~CRC32UpdateTable(0xffffffff, data, length);
+}
+
+/**
+ * \copydoc CRC32Calculate
+ *
+ * Slicing-by-8 implementation.
+ */
+static uint32_t
+CRC32CalculateSlice8(const uint8_t* data, int length)
+{
+    return ~CRC32UpdateSlice8(0xffffffff, data, length);
+}
+
+#ifdef NS3_CRC32_X86
+/**
+ * \copydoc CRC32Calculate
+ *
+ * Carry-less multiplication implementation.
+ */
+static uint32_t
+CRC32CalculatePclmul(const uint8_t* data, int length)
+{
+    return ~CRC32UpdatePclmul(0xffffffff, data, length);
+}
+#endif
+
+std::vector<std::string>
+GetCRC32Implementations()
+{
+    std::vector<std::string> names{"table", "slice8"};
+#ifdef NS3_CRC32_X86
+    if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"))
+    {
+        names.emplace_back("pclmul");
+    }
+#endif
+    return names;
+}
+
+CRC32Function
+GetCRC32Implementation(const std::string& name)
+{
+    if (name == "table")
+    {
+        return &CRC32CalculateTable;
+    }
+    if (name == "slice8")
+    {
+        return &CRC32CalculateSlice8;
+    }
+#ifdef NS3_CRC32_X86
+    if (name == "pclmul" && __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"))
+    {
+        return &CRC32CalculatePclmul;
+    }
+#endif
+    return nullptr;
+}
+
+uint32_t
+CRC32Calculate(const uint8_t* data, int length)
+{
+    // the last implementation listed is the fastest one
+    static const CRC32Function impl = GetCRC32Implementation(GetCRC32Implementations().back());
+    return impl(data, length);
 }
 
 } // namespace ns3
@@ -8,6 +8,8 @@
 #ifndef CRC32_H
 #define CRC32_H
 #include <stdint.h>
+#include <string>
+#include <vector>
 
 namespace ns3
 {
@@ -22,6 +24,24 @@ namespace ns3
  */
 uint32_t CRC32Calculate(const uint8_t* data, int length);
 
+/// Signature of the implementations of CRC32Calculate
+typedef uint32_t (*CRC32Function)(const uint8_t* data, int length);
+
+/**
+ * \returns the names of the implementations of CRC32Calculate supported by
+ * the CPU, the reference implementation first
+ */
+std::vector<std::string> GetCRC32Implementations();
+
+/**
+ * Get an implementation of CRC32Calculate, to test or benchmark it.
+ * CRC32Calculate uses the fastest implementation supported by the CPU.
+ *
+ * \param name the name of the implementation ("table", "slice8" or "pclmul")
+ * \returns the implementation, or nullptr if it is not supported
+ */
+CRC32Function GetCRC32Implementation(const std::string& name);
+
 } // namespace ns3
 
 #endif
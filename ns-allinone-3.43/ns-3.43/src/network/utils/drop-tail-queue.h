@@ -67,6 +67,13 @@ DropTailQueue<Item>::GetTypeId()
                           "The max queue size",
                           QueueSizeValue(QueueSize("100p")),
                           MakeQueueSizeAccessor(&QueueBase::SetMaxSize, &QueueBase::GetMaxSize),
+                          MakeQueueSizeChecker())
+            .AddAttribute("MarkThreshold",
+                          "The queue occupancy (packets or bytes) above which the packets sent "
+                          "to the queue are ECN marked. A null threshold disables the marking.",
+                          QueueSizeValue(QueueSize("0p")),
+                          MakeQueueSizeAccessor(&QueueBase::SetMarkThreshold,
+                                                &QueueBase::GetMarkThreshold),
                           MakeQueueSizeChecker());
     return tid;
 }
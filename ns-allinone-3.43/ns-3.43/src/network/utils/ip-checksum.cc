@@ -0,0 +1,209 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ip-checksum.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NS3_IP_CHECKSUM_X86
+#include <immintrin.h>
+#endif
+
+namespace ns3
+{
+
+/**
+ * Fold a wide sum of 16-bit words into a 16-bit one's complement sum.
+ *
+ * \param sum the sum
+ * \returns the folded sum
+ */
+static uint16_t
+IpChecksumFold(uint64_t sum)
+{
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return sum;
+}
+
+/**
+ * Add the remaining bytes, two at a time.
+ *
+ * \param sum the sum so far
+ * \param data the bytes to add
+ * \param length the number of bytes to add
+ * \returns the updated sum
+ */
+static uint64_t
+IpChecksumAddTail(uint64_t sum, const uint8_t* data, uint32_t length)
+{
+    for (; length >= 2; data += 2, length -= 2)
+    {
+        sum += data[0] | (data[1] << 8);
+    }
+    if (length)
+    {
+        sum += data[0];
+    }
+    return sum;
+}
+
+/**
+ * \copydoc IpChecksumAdd
+ *
+ * Reference implementation, adding one word at a time.
+ */
+static uint16_t
+IpChecksumAddReference(const uint8_t* data, uint32_t length)
+{
+    return IpChecksumFold(IpChecksumAddTail(0, data, length));
+}
+
+/**
+ * \copydoc IpChecksumAdd
+ *
+ * Portable implementation, adding 64 bits at a time.  Since 2^16 is 1
+ * modulo 2^16 - 1, each 32-bit half of a 64-bit word can be added as a
+ * whole and folded at the end.
+ */
+static uint16_t
+IpChecksumAddScalar(const uint8_t* data, uint32_t length)
+{
+    uint64_t sum = 0;
+    for (; length >= 8; data += 8, length -= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        sum += (word & 0xffffffff) + (word >> 32);
+    }
+    return IpChecksumFold(IpChecksumAddTail(sum, data, length));
+}
+
+#ifdef NS3_IP_CHECKSUM_X86
+
+/**
+ * Maximum number of vectors added in 32-bit lanes before they are
+ * widened, so that the lanes do not overflow.
+ */
+const uint32_t IP_CHECKSUM_MAX_VECTORS = 32768;
+
+/**
+ * \copydoc IpChecksumAdd
+ *
+ * SSE2 implementation, adding 16 bytes at a time in 32-bit lanes.
+ */
+__attribute__((target("sse2"))) static uint16_t
+IpChecksumAddSse2(const uint8_t* data, uint32_t length)
+{
+    uint64_t sum = 0;
+    const __m128i zero = _mm_setzero_si128();
+    while (length >= 16)
+    {
+        uint32_t vectors = std::min(length / 16, IP_CHECKSUM_MAX_VECTORS);
+        __m128i acc = _mm_setzero_si128();
+        for (uint32_t i = 0; i < vectors; i++, data += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+            acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(v, zero));
+            acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(v, zero));
+        }
+        length -= vectors * 16;
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        sum += static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+    return IpChecksumFold(IpChecksumAddTail(sum, data, length));
+}
+
+/**
+ * \copydoc IpChecksumAdd
+ *
+ * AVX2 implementation, adding 32 bytes at a time in 32-bit lanes.
+ */
+__attribute__((target("avx2"))) static uint16_t
+IpChecksumAddAvx2(const uint8_t* data, uint32_t length)
+{
+    uint64_t sum = 0;
+    const __m256i zero = _mm256_setzero_si256();
+    while (length >= 32)
+    {
+        uint32_t vectors = std::min(length / 32, IP_CHECKSUM_MAX_VECTORS);
+        __m256i acc = _mm256_setzero_si256();
+        for (uint32_t i = 0; i < vectors; i++, data += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+            acc = _mm256_add_epi32(acc, _mm256_unpacklo_epi16(v, zero));
+            acc = _mm256_add_epi32(acc, _mm256_unpackhi_epi16(v, zero));
+        }
+        length -= vectors * 32;
+        alignas(32) uint32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        for (uint32_t lane : lanes)
+        {
+            sum += lane;
+        }
+    }
+    return IpChecksumFold(IpChecksumAddTail(sum, data, length));
+}
+
+#endif /* NS3_IP_CHECKSUM_X86 */
+
+std::vector<std::string>
+GetIpChecksumAddImplementations()
+{
+    std::vector<std::string> names{"reference", "scalar"};
+#ifdef NS3_IP_CHECKSUM_X86
+    if (__builtin_cpu_supports("sse2"))
+    {
+        names.emplace_back("sse2");
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        names.emplace_back("avx2");
+    }
+#endif
+    return names;
+}
+
+IpChecksumAddFunction
+GetIpChecksumAddImplementation(const std::string& name)
+{
+    if (name == "reference")
+    {
+        return &IpChecksumAddReference;
+    }
+    if (name == "scalar")
+    {
+        return &IpChecksumAddScalar;
+    }
+#ifdef NS3_IP_CHECKSUM_X86
+    if (name == "sse2" && __builtin_cpu_supports("sse2"))
+    {
+        return &IpChecksumAddSse2;
+    }
+    if (name == "avx2" && __builtin_cpu_supports("avx2"))
+    {
+        return &IpChecksumAddAvx2;
+    }
+#endif
+    return nullptr;
+}
+
+uint16_t
+IpChecksumAdd(const uint8_t* data, uint32_t length)
+{
+    // the last implementation listed is the fastest one
+    static const IpChecksumAddFunction impl =
+        GetIpChecksumAddImplementation(GetIpChecksumAddImplementations().back());
+    return impl(data, length);
+}
+
+} // namespace ns3
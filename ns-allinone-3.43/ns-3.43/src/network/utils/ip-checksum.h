@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef IP_CHECKSUM_H
+#define IP_CHECKSUM_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * Add the 16-bit words of a byte array with one's complement arithmetic,
+ * as needed to compute an Internet checksum (RFC 1071).
+ *
+ * The words are read with the same byte order as Buffer::Iterator::ReadU16,
+ * i.e., the first byte of each word is its least significant byte, and a
+ * trailing odd byte is added as the least significant byte of a word.
+ *
+ * The implementation is selected at the first call, according to the
+ * instruction sets supported by the CPU.
+ *
+ * \param data the bytes to add
+ * \param length the number of bytes to add
+ * \returns the 16-bit one's complement sum of the words, not complemented
+ */
+uint16_t IpChecksumAdd(const uint8_t* data, uint32_t length);
+
+/// Signature of the implementations of IpChecksumAdd
+typedef uint16_t (*IpChecksumAddFunction)(const uint8_t* data, uint32_t length);
+
+/**
+ * \ingroup network
+ *
+ * \returns the names of the implementations of IpChecksumAdd supported by
+ * the CPU, the reference implementation first
+ */
+std::vector<std::string> GetIpChecksumAddImplementations();
+
+/**
+ * \ingroup network
+ *
+ * Get an implementation of IpChecksumAdd, to test or benchmark it.
+ *
+ * \param name the name of the implementation ("reference", "scalar",
+ * "sse2" or "avx2")
+ * \returns the implementation, or nullptr if it is not supported
+ */
+IpChecksumAddFunction GetIpChecksumAddImplementation(const std::string& name);
+
+} // namespace ns3
+
+#endif /* IP_CHECKSUM_H */
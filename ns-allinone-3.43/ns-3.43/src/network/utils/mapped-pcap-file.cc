@@ -0,0 +1,274 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "mapped-pcap-file.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __WIN32__
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MappedPcapFile");
+
+/// Magic number of a pcap file with microsecond timestamps
+const uint32_t MAPPED_PCAP_MAGIC = 0xa1b2c3d4;
+/// Magic number of a pcap file with microsecond timestamps, in the opposite byte order
+const uint32_t MAPPED_PCAP_SWAPPED_MAGIC = 0xd4c3b2a1;
+/// Magic number of a pcap file with nanosecond timestamps
+const uint32_t MAPPED_PCAP_NS_MAGIC = 0xa1b23c4d;
+/// Magic number of a pcap file with nanosecond timestamps, in the opposite byte order
+const uint32_t MAPPED_PCAP_NS_SWAPPED_MAGIC = 0x4d3cb2a1;
+
+const std::size_t MAPPED_PCAP_FILE_HEADER_SIZE = 24;   //!< Size of the pcap file header
+const std::size_t MAPPED_PCAP_RECORD_HEADER_SIZE = 16; //!< Size of a pcap record header
+
+MappedPcapFile::MappedPcapFile()
+    : m_data(nullptr),
+      m_size(0),
+      m_swapMode(false),
+      m_nanosecMode(false),
+      m_dataLinkType(0),
+      m_snapLen(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MappedPcapFile::~MappedPcapFile()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+bool
+MappedPcapFile::Open(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    Close();
+
+#ifdef __WIN32__
+    // No mmap(); fall back to reading the whole file in memory
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+    std::size_t size = file.tellg();
+    if (size < MAPPED_PCAP_FILE_HEADER_SIZE)
+    {
+        return false;
+    }
+    auto data = new uint8_t[size];
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data), size))
+    {
+        delete[] data;
+        return false;
+    }
+    m_data = data;
+    m_size = size;
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        NS_LOG_LOGIC("Cannot open " << filename << ": " << std::strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < MAPPED_PCAP_FILE_HEADER_SIZE)
+    {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid once the descriptor is closed
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        NS_LOG_LOGIC("Cannot map " << filename << ": " << std::strerror(errno));
+        return false;
+    }
+    // replay mostly walks the file forward
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = st.st_size;
+#endif
+
+    uint32_t magic;
+    std::memcpy(&magic, m_data, sizeof(magic));
+    if (magic != MAPPED_PCAP_MAGIC && magic != MAPPED_PCAP_SWAPPED_MAGIC &&
+        magic != MAPPED_PCAP_NS_MAGIC && magic != MAPPED_PCAP_NS_SWAPPED_MAGIC)
+    {
+        NS_LOG_LOGIC(filename << " is not a pcap file");
+        Close();
+        return false;
+    }
+    m_swapMode = (magic == MAPPED_PCAP_SWAPPED_MAGIC || magic == MAPPED_PCAP_NS_SWAPPED_MAGIC);
+    m_nanosecMode = (magic == MAPPED_PCAP_NS_MAGIC || magic == MAPPED_PCAP_NS_SWAPPED_MAGIC);
+    m_snapLen = Read32(16);
+    m_dataLinkType = Read32(20);
+
+    BuildIndex();
+    NS_LOG_LOGIC("Indexed " << m_index.size() << " records in " << filename);
+    return true;
+}
+
+void
+MappedPcapFile::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_data == nullptr)
+    {
+        return;
+    }
+#ifdef __WIN32__
+    delete[] m_data;
+#else
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_index.clear();
+    m_index.shrink_to_fit();
+}
+
+bool
+MappedPcapFile::IsOpen() const
+{
+    return m_data != nullptr;
+}
+
+uint32_t
+MappedPcapFile::Read32(std::size_t offset) const
+{
+    uint32_t value;
+    std::memcpy(&value, m_data + offset, sizeof(value));
+    if (m_swapMode)
+    {
+        value = ((value >> 24) & 0x000000ff) | ((value >> 8) & 0x0000ff00) |
+                ((value << 8) & 0x00ff0000) | ((value << 24) & 0xff000000);
+    }
+    return value;
+}
+
+void
+MappedPcapFile::BuildIndex()
+{
+    NS_LOG_FUNCTION(this);
+    m_index.clear();
+    const uint64_t fractionScale = m_nanosecMode ? 1 : 1000;
+    std::size_t offset = MAPPED_PCAP_FILE_HEADER_SIZE;
+    while (offset + MAPPED_PCAP_RECORD_HEADER_SIZE <= m_size)
+    {
+        uint32_t inclLen = Read32(offset + 8);
+        if (m_size - offset - MAPPED_PCAP_RECORD_HEADER_SIZE < inclLen)
+        {
+            NS_LOG_LOGIC("Ignoring truncated record at offset " << offset);
+            break;
+        }
+        uint64_t timestamp = Read32(offset) * 1000000000ULL + Read32(offset + 4) * fractionScale;
+        m_index.push_back({timestamp, offset});
+        offset += MAPPED_PCAP_RECORD_HEADER_SIZE + inclLen;
+    }
+}
+
+uint32_t
+MappedPcapFile::GetDataLinkType() const
+{
+    return m_dataLinkType;
+}
+
+uint32_t
+MappedPcapFile::GetSnapLen() const
+{
+    return m_snapLen;
+}
+
+bool
+MappedPcapFile::GetSwapMode() const
+{
+    return m_swapMode;
+}
+
+bool
+MappedPcapFile::IsNanoSecMode() const
+{
+    return m_nanosecMode;
+}
+
+std::size_t
+MappedPcapFile::GetNRecords() const
+{
+    return m_index.size();
+}
+
+uint64_t
+MappedPcapFile::GetTimestamp(std::size_t i) const
+{
+    NS_ASSERT(i < m_index.size());
+    return m_index[i].timestamp;
+}
+
+uint32_t
+MappedPcapFile::GetCapturedLength(std::size_t i) const
+{
+    NS_ASSERT(i < m_index.size());
+    return Read32(m_index[i].offset + 8);
+}
+
+uint32_t
+MappedPcapFile::GetOriginalLength(std::size_t i) const
+{
+    NS_ASSERT(i < m_index.size());
+    return Read32(m_index[i].offset + 12);
+}
+
+const uint8_t*
+MappedPcapFile::GetData(std::size_t i) const
+{
+    NS_ASSERT(i < m_index.size());
+    return m_data + m_index[i].offset + MAPPED_PCAP_RECORD_HEADER_SIZE;
+}
+
+Ptr<Packet>
+MappedPcapFile::GetPacket(std::size_t i, bool pad) const
+{
+    NS_LOG_FUNCTION(this << i << pad);
+    uint32_t inclLen = GetCapturedLength(i);
+    auto p = Create<Packet>(GetData(i), inclLen);
+    uint32_t origLen = GetOriginalLength(i);
+    if (pad && origLen > inclLen)
+    {
+        // appending a zero-filled packet extends the virtual zero area of the buffer
+        p->AddAtEnd(Create<Packet>(origLen - inclLen));
+    }
+    return p;
+}
+
+std::size_t
+MappedPcapFile::Find(uint64_t timestamp) const
+{
+    auto it = std::lower_bound(
+        m_index.begin(),
+        m_index.end(),
+        timestamp,
+        [](const IndexEntry& entry, uint64_t value) { return entry.timestamp < value; });
+    return it - m_index.begin();
+}
+
+} // namespace ns3
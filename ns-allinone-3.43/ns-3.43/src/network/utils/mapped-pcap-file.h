@@ -0,0 +1,168 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef MAPPED_PCAP_FILE_H
+#define MAPPED_PCAP_FILE_H
+
+#include "ns3/ptr.h"
+
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+
+/**
+ * \ingroup network
+ *
+ * \brief A read-only, memory-mapped pcap file with a record index.
+ *
+ * PcapFile reads records one at a time through a std::fstream, copying
+ * every record into a caller-supplied buffer.  For trace-driven replay of
+ * large captures this class instead maps the file into the address space
+ * and scans it once to build an index holding the timestamp and the file
+ * offset of every record.  Records can then be accessed in any order, and
+ * their bytes are read straight from the mapping: the only copy made is
+ * the one into the Packet buffer by GetPacket().
+ *
+ * Only the index (16 bytes per record) is held in memory; the operating
+ * system pages the file in and out as records are accessed, so captures
+ * much larger than the available memory can be replayed.
+ *
+ * Both byte orders and both the microsecond and nanosecond variants of the
+ * pcap format are supported.  A truncated last record is ignored.
+ */
+class MappedPcapFile
+{
+  public:
+    MappedPcapFile();
+    ~MappedPcapFile();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    MappedPcapFile(const MappedPcapFile&) = delete;
+    MappedPcapFile& operator=(const MappedPcapFile&) = delete;
+
+    /**
+     * Map a pcap file and index its records.  Any previously opened file is
+     * closed first.
+     *
+     * \param filename name of the file
+     * \return true on success; false if the file cannot be mapped or is not
+     * a pcap file
+     */
+    bool Open(const std::string& filename);
+
+    /**
+     * Unmap the file and drop the index.
+     */
+    void Close();
+
+    /**
+     * \return true if a file is mapped
+     */
+    bool IsOpen() const;
+
+    /**
+     * \return the data link type of the file
+     */
+    uint32_t GetDataLinkType() const;
+
+    /**
+     * \return the maximum number of octets saved per record
+     */
+    uint32_t GetSnapLen() const;
+
+    /**
+     * \return true if the file is stored in the opposite byte order
+     */
+    bool GetSwapMode() const;
+
+    /**
+     * \return true if the timestamps of the file have a nanosecond resolution
+     */
+    bool IsNanoSecMode() const;
+
+    /**
+     * \return the number of records in the file
+     */
+    std::size_t GetNRecords() const;
+
+    /**
+     * \param i record index
+     * \return the timestamp of the record, in nanoseconds
+     */
+    uint64_t GetTimestamp(std::size_t i) const;
+
+    /**
+     * \param i record index
+     * \return the number of octets of the record saved in the file
+     */
+    uint32_t GetCapturedLength(std::size_t i) const;
+
+    /**
+     * \param i record index
+     * \return the length of the packet when it was captured
+     */
+    uint32_t GetOriginalLength(std::size_t i) const;
+
+    /**
+     * \param i record index
+     * \return the saved octets of the record, valid until the file is closed
+     */
+    const uint8_t* GetData(std::size_t i) const;
+
+    /**
+     * Build a packet from the saved octets of a record.  When the record was
+     * truncated by the snap length, the packet is padded with zeros up to
+     * the original length if requested; the padding does not use memory.
+     *
+     * \param i record index
+     * \param pad true to pad the packet to its original length
+     * \return the packet
+     */
+    Ptr<Packet> GetPacket(std::size_t i, bool pad = false) const;
+
+    /**
+     * \param timestamp a timestamp, in nanoseconds
+     * \return the index of the first record whose timestamp is not earlier
+     * than the given one, or GetNRecords() if there is none.  Records are
+     * assumed to be sorted by timestamp.
+     */
+    std::size_t Find(uint64_t timestamp) const;
+
+  private:
+    /**
+     * \brief Index entry of a record
+     */
+    struct IndexEntry
+    {
+        uint64_t timestamp; //!< record timestamp, nanoseconds
+        uint64_t offset;    //!< offset of the record header in the file
+    };
+
+    /**
+     * \param offset offset in the mapping
+     * \return the 32-bit value stored at the given offset, in host byte order
+     */
+    uint32_t Read32(std::size_t offset) const;
+
+    /// Scan the mapped file and fill m_index
+    void BuildIndex();
+
+    const uint8_t* m_data;           //!< start of the mapping
+    std::size_t m_size;              //!< size of the mapping
+    bool m_swapMode;                 //!< file stored in the opposite byte order
+    bool m_nanosecMode;              //!< timestamps in nanoseconds
+    uint32_t m_dataLinkType;         //!< data link type of the file
+    uint32_t m_snapLen;              //!< snap length of the file
+    std::vector<IndexEntry> m_index; //!< one entry per record
+};
+
+} // namespace ns3
+
+#endif /* MAPPED_PCAP_FILE_H */
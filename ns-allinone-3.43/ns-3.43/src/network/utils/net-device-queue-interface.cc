@@ -53,6 +53,13 @@ NetDeviceQueue::IsStopped() const
     return m_stoppedByDevice || m_stoppedByQueueLimits;
 }
 
+bool
+NetDeviceQueue::IsMarkThresholdReached() const
+{
+    NS_LOG_FUNCTION(this);
+    return !m_markCallback.IsNull() && m_markCallback();
+}
+
 void
 NetDeviceQueue::Start()
 {
@@ -83,6 +83,17 @@ class NetDeviceQueue : public Object
      */
     virtual bool IsStopped() const;
 
+    /**
+     * \brief Check whether the packets sent to the device transmission queue are
+     *        to be ECN marked.
+     * \return true if the queue of the device has reached its mark threshold.
+     *
+     * Called by the traffic control layer, when no queue disc is installed on the
+     * device, to mark the packets sent to the device as a queue disc marking the
+     * packets above a fixed threshold would do.
+     */
+    bool IsMarkThresholdReached() const;
+
     /**
      * \brief Notify this NetDeviceQueue that the NetDeviceQueueInterface was
      *        aggregated to an object.
@@ -188,6 +199,7 @@ class NetDeviceQueue : public Object
      *        - "Enqueue", "Dequeue", "DropBeforeEnqueue" traces
      *        - an ItemType typedef for the type of stored items
      *        - GetCurrentSize and GetMaxSize methods
+     *        - an IsMarkThresholdReached method
      * \param queue the queue
      */
     template <typename QueueType>
@@ -199,6 +211,7 @@ class NetDeviceQueue : public Object
     Ptr<QueueLimits> m_queueLimits; //!< Queue limits object
     WakeCallback m_wakeCallback;    //!< Wake callback
     Ptr<NetDevice> m_device;        //!< the netdevice aggregated to the NetDeviceQueueInterface
+    Callback<bool> m_markCallback;  //!< Check the mark threshold of the device queue
 
     NS_LOG_TEMPLATE_DECLARE; //!< redefinition of the log component
 };
@@ -323,6 +336,7 @@ NetDeviceQueue::ConnectQueueTraces(Ptr<QueueType> queue)
     queue->TraceConnectWithoutContext(
         "DropBeforeEnqueue",
         MakeCallback(&NetDeviceQueue::PacketDiscarded<QueueType>, this).Bind(PeekPointer(queue)));
+    m_markCallback = MakeCallback(&QueueType::IsMarkThresholdReached, PeekPointer(queue));
 }
 
 template <typename QueueType>
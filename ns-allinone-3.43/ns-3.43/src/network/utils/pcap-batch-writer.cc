@@ -0,0 +1,271 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "pcap-batch-writer.h"
+
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+
+#include <cstring>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PcapBatchWriter");
+
+/**
+ * \brief Compression state owned by the writer thread
+ */
+struct PcapBatchWriter::GzipState
+{
+#ifdef HAVE_ZLIB
+    z_stream stream;            //!< zlib deflate stream, in gzip mode
+    std::vector<uint8_t> chunk; //!< Compressed output scratch area
+#endif
+};
+
+PcapBatchWriter::PcapBatchWriter(const std::string& filename,
+                                 uint32_t batchSize,
+                                 Compression compression,
+                                 uint32_t maxPendingBatches)
+    : m_batchSize(batchSize),
+      m_compression(compression),
+      m_maxPending(maxPendingBatches),
+      m_closing(false),
+      m_failed(false)
+{
+    NS_LOG_FUNCTION(this << filename << batchSize << compression << maxPendingBatches);
+    NS_ASSERT(maxPendingBatches > 0);
+
+    if (!IsCompressionSupported(compression))
+    {
+        NS_FATAL_ERROR("PcapBatchWriter: compressed output requested for "
+                       << filename << " but ns-3 was built without zlib");
+    }
+
+    m_file.open(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (m_file.fail())
+    {
+        m_failed = true;
+        return;
+    }
+
+#ifdef HAVE_ZLIB
+    if (m_compression == COMPRESSION_GZIP)
+    {
+        m_gzip = std::make_unique<GzipState>();
+        std::memset(&m_gzip->stream, 0, sizeof(m_gzip->stream));
+        // windowBits 15 + 16 selects a gzip wrapper instead of a raw zlib one
+        if (deflateInit2(&m_gzip->stream,
+                         Z_DEFAULT_COMPRESSION,
+                         Z_DEFLATED,
+                         15 + 16,
+                         8,
+                         Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            m_failed = true;
+            m_file.close();
+            m_gzip.reset();
+            return;
+        }
+        m_gzip->chunk.resize(256 * 1024);
+    }
+#endif
+
+    m_batch.reserve(m_batchSize);
+    m_thread = std::thread(&PcapBatchWriter::Run, this);
+}
+
+PcapBatchWriter::~PcapBatchWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+bool
+PcapBatchWriter::IsCompressionSupported(Compression compression)
+{
+    switch (compression)
+    {
+    case COMPRESSION_NONE:
+        return true;
+    case COMPRESSION_GZIP:
+#ifdef HAVE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+bool
+PcapBatchWriter::Fail() const
+{
+    return m_failed;
+}
+
+void
+PcapBatchWriter::Append(const void* data, uint32_t length)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    m_batch.insert(m_batch.end(), bytes, bytes + length);
+}
+
+uint8_t*
+PcapBatchWriter::Reserve(uint32_t length)
+{
+    std::size_t offset = m_batch.size();
+    m_batch.resize(offset + length);
+    return m_batch.data() + offset;
+}
+
+void
+PcapBatchWriter::EndRecord()
+{
+    if (m_batch.size() >= m_batchSize)
+    {
+        Flush();
+    }
+}
+
+void
+PcapBatchWriter::Flush()
+{
+    NS_LOG_FUNCTION(this << m_batch.size());
+    if (!m_thread.joinable())
+    {
+        // the file could not be opened or has been closed; nothing to write to
+        m_batch.clear();
+        return;
+    }
+    if (m_batch.empty())
+    {
+        return;
+    }
+
+    std::vector<uint8_t> next;
+    next.reserve(m_batchSize);
+    {
+        std::unique_lock lock(m_mutex);
+        m_producerCv.wait(lock, [this] { return m_pending.size() < m_maxPending; });
+        m_pending.emplace_back(std::move(m_batch));
+    }
+    m_writerCv.notify_one();
+    m_batch = std::move(next);
+}
+
+void
+PcapBatchWriter::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    Flush();
+    {
+        std::lock_guard lock(m_mutex);
+        m_closing = true;
+    }
+    m_writerCv.notify_one();
+    m_thread.join();
+
+    FinishCompression();
+    m_file.close();
+    if (m_file.fail())
+    {
+        m_failed = true;
+    }
+}
+
+void
+PcapBatchWriter::Run()
+{
+    while (true)
+    {
+        std::vector<uint8_t> batch;
+        {
+            std::unique_lock lock(m_mutex);
+            m_writerCv.wait(lock, [this] { return m_closing || !m_pending.empty(); });
+            if (m_pending.empty())
+            {
+                // m_closing is set and everything has been written
+                return;
+            }
+            batch = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+        m_producerCv.notify_one();
+        WriteBatch(batch);
+    }
+}
+
+void
+PcapBatchWriter::WriteBatch(const std::vector<uint8_t>& batch)
+{
+    if (m_failed)
+    {
+        return;
+    }
+
+#ifdef HAVE_ZLIB
+    if (m_gzip)
+    {
+        z_stream& zs = m_gzip->stream;
+        zs.next_in = const_cast<Bytef*>(batch.data());
+        zs.avail_in = static_cast<uInt>(batch.size());
+        do
+        {
+            zs.next_out = m_gzip->chunk.data();
+            zs.avail_out = static_cast<uInt>(m_gzip->chunk.size());
+            deflate(&zs, Z_NO_FLUSH);
+            m_file.write(reinterpret_cast<const char*>(m_gzip->chunk.data()),
+                         m_gzip->chunk.size() - zs.avail_out);
+        } while (zs.avail_out == 0);
+    }
+    else
+#endif
+    {
+        m_file.write(reinterpret_cast<const char*>(batch.data()), batch.size());
+    }
+
+    if (m_file.fail())
+    {
+        m_failed = true;
+    }
+}
+
+void
+PcapBatchWriter::FinishCompression()
+{
+#ifdef HAVE_ZLIB
+    if (!m_gzip)
+    {
+        return;
+    }
+    z_stream& zs = m_gzip->stream;
+    zs.next_in = nullptr;
+    zs.avail_in = 0;
+    int ret;
+    do
+    {
+        zs.next_out = m_gzip->chunk.data();
+        zs.avail_out = static_cast<uInt>(m_gzip->chunk.size());
+        ret = deflate(&zs, Z_FINISH);
+        m_file.write(reinterpret_cast<const char*>(m_gzip->chunk.data()),
+                     m_gzip->chunk.size() - zs.avail_out);
+    } while (ret == Z_OK);
+    deflateEnd(&zs);
+    m_gzip.reset();
+#endif
+}
+
+} // namespace ns3
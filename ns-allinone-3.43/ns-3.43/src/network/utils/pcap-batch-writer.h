@@ -0,0 +1,143 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef PCAP_BATCH_WRITER_H
+#define PCAP_BATCH_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * \brief Batched, background-thread output sink for capture files.
+ *
+ * Records are serialized by the simulator thread into an in-memory batch.
+ * Once the batch grows past the configured size it is handed over to a
+ * writer thread, which (optionally compresses and) writes it to disk while
+ * the simulation keeps running.  The number of batches waiting for the
+ * writer thread is bounded, so a slow disk eventually throttles the
+ * simulation instead of exhausting memory.
+ *
+ * The file is created synchronously by the constructor so that open
+ * failures can be reported to the caller immediately.
+ */
+class PcapBatchWriter
+{
+  public:
+    /// Compression applied by the writer thread to the output stream
+    enum Compression
+    {
+        COMPRESSION_NONE, //!< Raw output
+        COMPRESSION_GZIP, //!< gzip stream (requires ns-3 to be built with zlib)
+    };
+
+    /**
+     * Create the output file and start the writer thread.
+     *
+     * \param filename name of the file to create (truncated if it exists)
+     * \param batchSize size in bytes at which a batch is handed to the writer thread
+     * \param compression compression applied to the output stream
+     * \param maxPendingBatches maximum number of batches queued for the writer thread
+     */
+    PcapBatchWriter(const std::string& filename,
+                    uint32_t batchSize,
+                    Compression compression = COMPRESSION_NONE,
+                    uint32_t maxPendingBatches = 4);
+    ~PcapBatchWriter();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    PcapBatchWriter(const PcapBatchWriter&) = delete;
+    PcapBatchWriter& operator=(const PcapBatchWriter&) = delete;
+
+    /**
+     * \param compression the compression to check
+     * \return true if this build of ns-3 supports the given compression
+     */
+    static bool IsCompressionSupported(Compression compression);
+
+    /**
+     * \return true if the file could not be created or a write failed
+     */
+    bool Fail() const;
+
+    /**
+     * Append bytes to the current batch.
+     *
+     * \param data the bytes to append
+     * \param length number of bytes to append
+     */
+    void Append(const void* data, uint32_t length);
+
+    /**
+     * Grow the current batch by the given number of bytes, so that the
+     * caller can serialize directly into it.
+     *
+     * \param length number of bytes to reserve
+     * \return pointer to the first reserved byte, valid until the next call
+     *         to any method of this object
+     */
+    uint8_t* Reserve(uint32_t length);
+
+    /**
+     * Mark the end of a record.  Batches are only handed to the writer
+     * thread on record boundaries.
+     */
+    void EndRecord();
+
+    /**
+     * Hand the current batch (if any) to the writer thread.
+     */
+    void Flush();
+
+    /**
+     * Flush the current batch, wait for the writer thread to drain all
+     * pending batches and close the file.  Called by the destructor.
+     */
+    void Close();
+
+  private:
+    struct GzipState;
+
+    /// Writer thread main loop
+    void Run();
+
+    /**
+     * Write a batch to the file (writer thread only).
+     * \param batch the batch to write
+     */
+    void WriteBatch(const std::vector<uint8_t>& batch);
+
+    /// Terminate the compressed stream, if any (writer thread only).
+    void FinishCompression();
+
+    std::ofstream m_file;                       //!< Output file (writer thread once started)
+    std::vector<uint8_t> m_batch;               //!< Batch being filled by the simulator thread
+    uint32_t m_batchSize;                       //!< Batch hand-over threshold, in bytes
+    Compression m_compression;                  //!< Output compression
+    std::unique_ptr<GzipState> m_gzip;          //!< Compression state (writer thread only)
+    std::deque<std::vector<uint8_t>> m_pending; //!< Batches waiting for the writer thread
+    uint32_t m_maxPending;                      //!< Bound on m_pending
+    std::mutex m_mutex;                         //!< Protects m_pending and m_closing
+    std::condition_variable m_writerCv;         //!< Wakes up the writer thread
+    std::condition_variable m_producerCv;       //!< Wakes up a throttled simulator thread
+    bool m_closing;                             //!< Writer thread exits once m_pending drains
+    std::atomic<bool> m_failed;                 //!< Sticky failure flag
+    std::thread m_thread;                       //!< Writer thread
+};
+
+} // namespace ns3
+
+#endif /* PCAP_BATCH_WRITER_H */
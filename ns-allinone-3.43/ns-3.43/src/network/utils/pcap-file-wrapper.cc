@@ -8,8 +8,11 @@
 
 #include "ns3/boolean.h"
 #include "ns3/buffer.h"
+#include "ns3/callback.h"
+#include "ns3/enum.h"
 #include "ns3/header.h"
 #include "ns3/log.h"
+#include "ns3/string.h"
 #include "ns3/uinteger.h"
 
 namespace ns3
@@ -37,11 +40,68 @@ PcapFileWrapper::GetTypeId()
                           "microseconds(default).",
                           BooleanValue(false),
                           MakeBooleanAccessor(&PcapFileWrapper::m_nanosecMode),
+                          MakeBooleanChecker())
+            .AddAttribute("BatchSize",
+                          "Size in bytes of the in-memory batches of records handed to a "
+                          "background writer thread. Zero (the default) writes every record "
+                          "synchronously.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&PcapFileWrapper::m_batchSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute(
+                "Compression",
+                "Compression of the written file. Only available with batched writes.",
+                EnumValue(PcapBatchWriter::COMPRESSION_NONE),
+                MakeEnumAccessor<PcapBatchWriter::Compression>(&PcapFileWrapper::m_compression),
+                MakeEnumChecker(PcapBatchWriter::COMPRESSION_NONE,
+                                "None",
+                                PcapBatchWriter::COMPRESSION_GZIP,
+                                "Gzip"))
+            .AddAttribute("PcapNgFile",
+                          "If not empty, the name of a pcapng file shared by all the wrappers "
+                          "with the same value, to which packets are written instead of the "
+                          "file given to Open().",
+                          StringValue(""),
+                          MakeStringAccessor(&PcapFileWrapper::m_pcapNgFilename),
+                          MakeStringChecker())
+            .AddAttribute("SampleEvery",
+                          "Record only one packet out of every N packets (the first one, "
+                          "then the N+1-th, and so on).",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&PcapFileWrapper::m_sampleEvery),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("SampleWindowPeriod",
+                          "If strictly positive, record only packets whose timestamp modulo "
+                          "this period is lower than SampleWindowDuration.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&PcapFileWrapper::m_windowPeriod),
+                          MakeTimeChecker())
+            .AddAttribute("SampleWindowDuration",
+                          "Duration of the periodic capture window (see SampleWindowPeriod).",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&PcapFileWrapper::m_windowDuration),
+                          MakeTimeChecker())
+            .AddAttribute("CaptureFilter",
+                          "Callback deciding whether a packet is recorded, called after the "
+                          "sampling checks. See CaptureFilterCallback.",
+                          CallbackValue(),
+                          MakeCallbackAccessor(&PcapFileWrapper::m_captureFilter),
+                          MakeCallbackChecker())
+            .AddAttribute("HeaderOnly",
+                          "Record only the bytes preceding the zero-filled payload of the "
+                          "packets (typically, their headers), without materializing the "
+                          "payload. Packets without a zero-filled payload are recorded up to "
+                          "the capture size.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PcapFileWrapper::m_headerOnly),
                           MakeBooleanChecker());
     return tid;
 }
 
 PcapFileWrapper::PcapFileWrapper()
+    : m_interfaceId(0),
+      m_sampleCount(0),
+      m_skipped(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -56,6 +116,10 @@ bool
 PcapFileWrapper::Fail() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_pcapNg)
+    {
+        return m_pcapNg->Fail();
+    }
     return m_file.Fail();
 }
 
@@ -77,6 +141,8 @@ void
 PcapFileWrapper::Close()
 {
     NS_LOG_FUNCTION(this);
+    // The shared pcapng file is closed when its last wrapper lets it go
+    m_pcapNg = nullptr;
     m_file.Close();
 }
 
@@ -84,9 +150,35 @@ void
 PcapFileWrapper::Open(const std::string& filename, std::ios::openmode mode)
 {
     NS_LOG_FUNCTION(this << filename << mode);
+
+    // Batched output needs a non-zero batch size; default to 1 MiB when the
+    // user asks for compression or pcapng output without choosing one
+    uint32_t batchSize = m_batchSize;
+    if (batchSize == 0 &&
+        (m_compression != PcapBatchWriter::COMPRESSION_NONE || !m_pcapNgFilename.empty()))
+    {
+        batchSize = 1024 * 1024;
+    }
+
+    if (!m_pcapNgFilename.empty() && (mode & std::ios::in) == 0)
+    {
+        m_pcapNg = PcapNgFile::OpenShared(m_pcapNgFilename, batchSize, m_compression);
+        m_interfaceName = filename;
+        return;
+    }
+    if ((mode & std::ios::in) == 0)
+    {
+        m_file.EnableBatching(batchSize, m_compression);
+    }
     m_file.Open(filename, mode);
 }
 
+bool
+PcapFileWrapper::IsPcapNg() const
+{
+    return m_pcapNg != nullptr;
+}
+
 void
 PcapFileWrapper::Init(uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrection)
 {
@@ -96,6 +188,15 @@ PcapFileWrapper::Init(uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrect
     // a snaplen, we use the one provided.
     //
     NS_LOG_FUNCTION(this << dataLinkType << snapLen << tzCorrection);
+    if (m_pcapNg)
+    {
+        // pcapng timestamps are always UTC, tzCorrection does not apply
+        m_interfaceId = m_pcapNg->AddInterface(
+            dataLinkType,
+            snapLen != std::numeric_limits<uint32_t>::max() ? snapLen : m_snapLen,
+            m_interfaceName);
+        return;
+    }
     if (snapLen != std::numeric_limits<uint32_t>::max())
     {
         m_file.Init(dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
@@ -106,23 +207,70 @@ PcapFileWrapper::Init(uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrect
     }
 }
 
+bool
+PcapFileWrapper::Sample(Time t, Ptr<const Packet> p)
+{
+    if (m_windowPeriod.IsStrictlyPositive() && (t % m_windowPeriod) >= m_windowDuration)
+    {
+        ++m_skipped;
+        return false;
+    }
+    if (m_sampleEvery > 1 && (m_sampleCount++ % m_sampleEvery) != 0)
+    {
+        ++m_skipped;
+        return false;
+    }
+    if (p && !m_captureFilter.IsNull() && !m_captureFilter(p))
+    {
+        ++m_skipped;
+        return false;
+    }
+    return true;
+}
+
+uint32_t
+PcapFileWrapper::GetCaptureLength(Ptr<const Packet> p, uint32_t headerSize) const
+{
+    if (!m_headerOnly)
+    {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    return headerSize + p->GetZeroAreaOffset();
+}
+
+uint64_t
+PcapFileWrapper::GetNSkippedPackets() const
+{
+    return m_skipped;
+}
+
 void
 PcapFileWrapper::Write(Time t, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << t << p);
+    if (!Sample(t, p))
+    {
+        return;
+    }
+    uint32_t captureLen = GetCaptureLength(p);
+    if (m_pcapNg)
+    {
+        m_pcapNg->Write(m_interfaceId, t.GetNanoSeconds(), p, captureLen);
+        return;
+    }
     if (m_file.IsNanoSecMode())
     {
         uint64_t current = t.GetNanoSeconds();
         uint64_t s = current / 1000000000;
         uint64_t ns = current % 1000000000;
-        m_file.Write(s, ns, p);
+        m_file.Write(s, ns, p, captureLen);
     }
     else
     {
         uint64_t current = t.GetMicroSeconds();
         uint64_t s = current / 1000000;
         uint64_t us = current % 1000000;
-        m_file.Write(s, us, p);
+        m_file.Write(s, us, p, captureLen);
     }
 }
 
@@ -130,19 +278,29 @@ void
 PcapFileWrapper::Write(Time t, const Header& header, Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(this << t << &header << p);
+    if (!Sample(t, p))
+    {
+        return;
+    }
+    uint32_t captureLen = GetCaptureLength(p, header.GetSerializedSize());
+    if (m_pcapNg)
+    {
+        m_pcapNg->Write(m_interfaceId, t.GetNanoSeconds(), header, p, captureLen);
+        return;
+    }
     if (m_file.IsNanoSecMode())
     {
         uint64_t current = t.GetNanoSeconds();
         uint64_t s = current / 1000000000;
         uint64_t ns = current % 1000000000;
-        m_file.Write(s, ns, header, p);
+        m_file.Write(s, ns, header, p, captureLen);
     }
     else
     {
         uint64_t current = t.GetMicroSeconds();
         uint64_t s = current / 1000000;
         uint64_t us = current % 1000000;
-        m_file.Write(s, us, header, p);
+        m_file.Write(s, us, header, p, captureLen);
     }
 }
 
@@ -150,6 +308,15 @@ void
 PcapFileWrapper::Write(Time t, const uint8_t* buffer, uint32_t length)
 {
     NS_LOG_FUNCTION(this << t << &buffer << length);
+    if (!Sample(t, nullptr))
+    {
+        return;
+    }
+    if (m_pcapNg)
+    {
+        m_pcapNg->Write(m_interfaceId, t.GetNanoSeconds(), buffer, length);
+        return;
+    }
     if (m_file.IsNanoSecMode())
     {
         uint64_t current = t.GetNanoSeconds();
@@ -169,6 +336,7 @@ PcapFileWrapper::Write(Time t, const uint8_t* buffer, uint32_t length)
 Ptr<Packet>
 PcapFileWrapper::Read(Time& t)
 {
+    NS_ASSERT_MSG(!m_pcapNg, "Reading is not supported on pcapng output files");
     uint32_t tsSec;
     uint32_t tsUsec;
     uint32_t inclLen;
@@ -8,7 +8,9 @@
 #define PCAP_FILE_WRAPPER_H
 
 #include "pcap-file.h"
+#include "pcapng-file.h"
 
+#include "ns3/callback.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/packet.h"
@@ -26,6 +28,31 @@ namespace ns3
  * ns-3 interface to the low-level public methods of PcapFile.  Users are
  * encouraged to use this object instead of class ns3::PcapFile in ns-3
  * public APIs.
+ *
+ * By default every record is written synchronously to the file.  Setting
+ * the "BatchSize" attribute makes the wrapper serialize records into
+ * in-memory batches that are written (and optionally compressed, see the
+ * "Compression" attribute) by a background thread.  Setting the
+ * "PcapNgFile" attribute redirects the output of the wrapper to a pcapng
+ * file shared with all the other wrappers using the same name; the file
+ * name given to Open() is then only used as the interface name recorded in
+ * the shared file.  As the trace helpers create their files through this
+ * class, e.g. Config::SetDefault ("ns3::PcapFileWrapper::PcapNgFile",
+ * StringValue ("all.pcapng")) sends the output of EnablePcapAll() to a
+ * single file.
+ *
+ * The wrapper can also record only a subset of the packets it is given,
+ * which makes capturing long simulations affordable:
+ *  - "SampleWindowPeriod" and "SampleWindowDuration" restrict the capture
+ *    to a time window repeated periodically;
+ *  - "SampleEvery" records one packet out of every N packets (falling in
+ *    the time window, if any);
+ *  - "CaptureFilter" is a predicate called with every remaining packet;
+ *  - "HeaderOnly" truncates each recorded packet to the bytes preceding its
+ *    zero-filled payload, i.e., to its headers.
+ *
+ * These checks are made, in this order, before anything is serialized, so
+ * that skipped packets cost little more than a comparison.
  */
 class PcapFileWrapper : public Object
 {
@@ -140,6 +167,13 @@ class PcapFileWrapper : public Object
      */
     Ptr<Packet> Read(Time& t);
 
+    /**
+     * \return true if the output goes to a shared pcapng file (see the
+     * "PcapNgFile" attribute).  The pcap header accessors below are
+     * meaningless in this case.
+     */
+    bool IsPcapNg() const;
+
     /**
      * \brief Returns the magic number of the pcap file as defined by the magic_number
      * field in the pcap global header.
@@ -210,10 +244,53 @@ class PcapFileWrapper : public Object
      */
     uint32_t GetDataLinkType();
 
+    /**
+     * \return the number of packets given to Write() which were not recorded
+     * because of the sampling attributes or of the capture filter.
+     */
+    uint64_t GetNSkippedPackets() const;
+
+    /**
+     * Callback signature for the "CaptureFilter" attribute.
+     *
+     * \param [in] packet The packet about to be recorded.
+     * \returns true if the packet must be recorded.
+     */
+    typedef Callback<bool, Ptr<const Packet>> CaptureFilterCallback;
+
   private:
-    PcapFile m_file;    //!< Pcap file
-    uint32_t m_snapLen; //!< max length of saved packets
-    bool m_nanosecMode; //!< Timestamps in nanosecond mode
+    /**
+     * Apply the sampling attributes and capture filter to a packet.
+     *
+     * \param t Packet timestamp
+     * \param p Packet, or nullptr if only raw data is available
+     * \returns true if the packet must be recorded
+     */
+    bool Sample(Time t, Ptr<const Packet> p);
+
+    /**
+     * \param p packet about to be recorded
+     * \param headerSize size of a header written in front of the packet
+     * \returns the number of octets of the packet to record
+     */
+    uint32_t GetCaptureLength(Ptr<const Packet> p, uint32_t headerSize = 0) const;
+
+    PcapFile m_file;                            //!< Pcap file
+    uint32_t m_snapLen;                         //!< max length of saved packets
+    bool m_nanosecMode;                         //!< Timestamps in nanosecond mode
+    uint32_t m_batchSize;                       //!< Batch size for background writes, 0 if disabled
+    PcapBatchWriter::Compression m_compression; //!< Compression of the written file
+    std::string m_pcapNgFilename;               //!< Shared pcapng file name, empty if disabled
+    Ptr<PcapNgFile> m_pcapNg;                   //!< Shared pcapng file, if in use
+    std::string m_interfaceName;                //!< Interface name in the shared pcapng file
+    uint32_t m_interfaceId;                     //!< Interface id in the shared pcapng file
+    uint32_t m_sampleEvery;                     //!< Record one packet out of every N
+    uint64_t m_sampleCount;                     //!< Packets considered for 1-in-N sampling
+    Time m_windowPeriod;                        //!< Period of the capture window, zero if disabled
+    Time m_windowDuration;                      //!< Duration of the capture window
+    CaptureFilterCallback m_captureFilter;      //!< Capture filter, if any
+    bool m_headerOnly;                          //!< Record the headers only
+    uint64_t m_skipped;                         //!< Packets not recorded
 };
 
 } // namespace ns3
@@ -17,6 +17,7 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 
@@ -43,7 +44,9 @@ const uint16_t VERSION_MINOR = 4; /**< Minor version of supported pcap file form
 PcapFile::PcapFile()
     : m_file(),
       m_swapMode(false),
-      m_nanosecMode(false)
+      m_nanosecMode(false),
+      m_batchSize(0),
+      m_compression(PcapBatchWriter::COMPRESSION_NONE)
 {
     NS_LOG_FUNCTION(this);
     FatalImpl::RegisterStream(&m_file);
@@ -60,7 +63,7 @@ bool
 PcapFile::Fail() const
 {
     NS_LOG_FUNCTION(this);
-    return m_file.fail();
+    return m_file.fail() || (m_writer && m_writer->Fail());
 }
 
 bool
@@ -81,6 +84,17 @@ void
 PcapFile::Close()
 {
     NS_LOG_FUNCTION(this);
+    if (m_writer)
+    {
+        m_writer->Close();
+        if (m_writer->Fail())
+        {
+            m_file.setstate(std::ios::failbit);
+        }
+        m_writer.reset();
+        // the file stream was never opened
+        return;
+    }
     m_file.close();
 }
 
@@ -198,9 +212,13 @@ PcapFile::WriteFileHeader()
     NS_LOG_FUNCTION(this);
     //
     // If we're initializing the file, we need to write the pcap file header
-    // at the start of the file.
+    // at the start of the file.  A batched file is always freshly created, so
+    // the header is the first thing written to it.
     //
-    m_file.seekp(0, std::ios::beg);
+    if (!m_writer)
+    {
+        m_file.seekp(0, std::ios::beg);
+    }
 
     //
     // We have the ability to write out the pcap file header in a foreign endian
@@ -228,13 +246,26 @@ PcapFile::WriteFileHeader()
     // Watch out for memory alignment differences between machines, so write
     // them all individually.
     //
-    m_file.write((const char*)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-    m_file.write((const char*)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-    m_file.write((const char*)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-    m_file.write((const char*)&headerOut->m_zone, sizeof(headerOut->m_zone));
-    m_file.write((const char*)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-    m_file.write((const char*)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-    m_file.write((const char*)&headerOut->m_type, sizeof(headerOut->m_type));
+    WriteBytes(&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+    WriteBytes(&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+    WriteBytes(&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+    WriteBytes(&headerOut->m_zone, sizeof(headerOut->m_zone));
+    WriteBytes(&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+    WriteBytes(&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+    WriteBytes(&headerOut->m_type, sizeof(headerOut->m_type));
+}
+
+void
+PcapFile::WriteBytes(const void* data, uint32_t length)
+{
+    if (m_writer)
+    {
+        m_writer->Append(data, length);
+    }
+    else
+    {
+        m_file.write(static_cast<const char*>(data), length);
+    }
 }
 
 void
@@ -328,6 +359,20 @@ PcapFile::Open(const std::string& filename, std::ios::openmode mode)
     mode |= std::ios::binary;
 
     m_filename = filename;
+    if (m_batchSize > 0 && (mode & std::ios::in) == 0)
+    {
+        //
+        // The batch writer creates the file itself; the file stream stays
+        // closed and only carries the fail bit.
+        //
+        m_writer = std::make_unique<PcapBatchWriter>(filename, m_batchSize, m_compression);
+        if (m_writer->Fail())
+        {
+            m_writer.reset();
+            m_file.setstate(std::ios::failbit);
+        }
+        return;
+    }
     m_file.open(filename, mode);
     if (mode & std::ios::in)
     {
@@ -336,6 +381,17 @@ PcapFile::Open(const std::string& filename, std::ios::openmode mode)
     }
 }
 
+void
+PcapFile::EnableBatching(uint32_t batchSize, PcapBatchWriter::Compression compression)
+{
+    NS_LOG_FUNCTION(this << batchSize << compression);
+    NS_ASSERT_MSG(!m_writer && !m_file.is_open(), "Batching must be enabled before Open()");
+    NS_ASSERT_MSG(batchSize > 0 || compression == PcapBatchWriter::COMPRESSION_NONE,
+                  "Compression requires batched writes");
+    m_batchSize = batchSize;
+    m_compression = compression;
+}
+
 void
 PcapFile::Init(uint32_t dataLinkType,
                uint32_t snapLen,
@@ -399,12 +455,15 @@ PcapFile::Init(uint32_t dataLinkType,
 }
 
 uint32_t
-PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
+PcapFile::WritePacketHeader(uint32_t tsSec,
+                            uint32_t tsUsec,
+                            uint32_t totalLen,
+                            uint32_t captureLen)
 {
-    NS_LOG_FUNCTION(this << tsSec << tsUsec << totalLen);
-    NS_ASSERT(m_file.good());
+    NS_LOG_FUNCTION(this << tsSec << tsUsec << totalLen << captureLen);
+    NS_ASSERT(m_writer || m_file.good());
 
-    uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
+    uint32_t inclLen = std::min({totalLen, m_fileHeader.m_snapLen, captureLen});
 
     PcapRecordHeader header;
     header.m_tsSec = tsSec;
@@ -421,11 +480,14 @@ PcapFile::WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
     // Watch out for memory alignment differences between machines, so write
     // them all individually.
     //
-    m_file.write((const char*)&header.m_tsSec, sizeof(header.m_tsSec));
-    m_file.write((const char*)&header.m_tsUsec, sizeof(header.m_tsUsec));
-    m_file.write((const char*)&header.m_inclLen, sizeof(header.m_inclLen));
-    m_file.write((const char*)&header.m_origLen, sizeof(header.m_origLen));
-    NS_BUILD_DEBUG(m_file.flush());
+    WriteBytes(&header.m_tsSec, sizeof(header.m_tsSec));
+    WriteBytes(&header.m_tsUsec, sizeof(header.m_tsUsec));
+    WriteBytes(&header.m_inclLen, sizeof(header.m_inclLen));
+    WriteBytes(&header.m_origLen, sizeof(header.m_origLen));
+    if (!m_writer)
+    {
+        NS_BUILD_DEBUG(m_file.flush());
+    }
     return inclLen;
 }
 
@@ -434,31 +496,55 @@ PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const uint8_t* const data, uint
 {
     NS_LOG_FUNCTION(this << tsSec << tsUsec << &data << totalLen);
     uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalLen);
+    if (m_writer)
+    {
+        m_writer->Append(data, inclLen);
+        m_writer->EndRecord();
+        return;
+    }
     m_file.write((const char*)data, inclLen);
     NS_BUILD_DEBUG(m_file.flush());
 }
 
 void
-PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
+PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p, uint32_t captureLen)
 {
-    NS_LOG_FUNCTION(this << tsSec << tsUsec << p);
-    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, p->GetSize());
+    NS_LOG_FUNCTION(this << tsSec << tsUsec << p << captureLen);
+    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, p->GetSize(), captureLen);
+    if (m_writer)
+    {
+        p->CopyData(m_writer->Reserve(inclLen), inclLen);
+        m_writer->EndRecord();
+        return;
+    }
     p->CopyData(&m_file, inclLen);
     NS_BUILD_DEBUG(m_file.flush());
 }
 
 void
-PcapFile::Write(uint32_t tsSec, uint32_t tsUsec, const Header& header, Ptr<const Packet> p)
+PcapFile::Write(uint32_t tsSec,
+                uint32_t tsUsec,
+                const Header& header,
+                Ptr<const Packet> p,
+                uint32_t captureLen)
 {
-    NS_LOG_FUNCTION(this << tsSec << tsUsec << &header << p);
+    NS_LOG_FUNCTION(this << tsSec << tsUsec << &header << p << captureLen);
     uint32_t headerSize = header.GetSerializedSize();
     uint32_t totalSize = headerSize + p->GetSize();
-    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalSize);
+    uint32_t inclLen = WritePacketHeader(tsSec, tsUsec, totalSize, captureLen);
 
     Buffer headerBuffer;
     headerBuffer.AddAtStart(headerSize);
     header.Serialize(headerBuffer.Begin());
     uint32_t toCopy = std::min(headerSize, inclLen);
+    if (m_writer)
+    {
+        headerBuffer.CopyData(m_writer->Reserve(toCopy), toCopy);
+        inclLen -= toCopy;
+        p->CopyData(m_writer->Reserve(inclLen), inclLen);
+        m_writer->EndRecord();
+        return;
+    }
     headerBuffer.CopyData(&m_file, toCopy);
     inclLen -= toCopy;
     p->CopyData(&m_file, inclLen);
@@ -9,9 +9,13 @@
 #ifndef PCAP_FILE_H
 #define PCAP_FILE_H
 
+#include "pcap-batch-writer.h"
+
 #include "ns3/ptr.h"
 
 #include <fstream>
+#include <limits>
+#include <memory>
 #include <stdint.h>
 #include <string>
 
@@ -70,6 +74,22 @@ class PcapFile
      */
     void Open(const std::string& filename, std::ios::openmode mode);
 
+    /**
+     * Write records through a PcapBatchWriter instead of synchronously
+     * through the file stream.  Records are accumulated in memory and
+     * written (and optionally compressed) by a background thread.  This only
+     * applies to files subsequently opened for writing, and the resulting
+     * file content is identical to the synchronous path, apart from the
+     * optional compression.
+     *
+     * \param batchSize size in bytes of the batches handed to the writer
+     * thread.  Zero restores the synchronous behavior.
+     * \param compression compression applied to the written file.
+     */
+    void EnableBatching(
+        uint32_t batchSize,
+        PcapBatchWriter::Compression compression = PcapBatchWriter::COMPRESSION_NONE);
+
     /**
      * Close the underlying file.
      */
@@ -127,9 +147,14 @@ class PcapFile
      * \param tsSec       Packet timestamp, seconds
      * \param tsUsec      Packet timestamp, microseconds
      * \param p           Packet to write
+     * \param captureLen  Maximum number of octets of the packet to record,
+     *                    in addition to the snap length of the file
      *
      */
-    void Write(uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p);
+    void Write(uint32_t tsSec,
+               uint32_t tsUsec,
+               Ptr<const Packet> p,
+               uint32_t captureLen = std::numeric_limits<uint32_t>::max());
     /**
      * \brief Write next packet to file
      *
@@ -137,9 +162,15 @@ class PcapFile
      * \param tsUsec      Packet timestamp, microseconds
      * \param header      Header to write, in front of packet
      * \param p           Packet to write
+     * \param captureLen  Maximum number of octets of the header and packet
+     *                    to record, in addition to the snap length of the file
      *
      */
-    void Write(uint32_t tsSec, uint32_t tsUsec, const Header& header, Ptr<const Packet> p);
+    void Write(uint32_t tsSec,
+               uint32_t tsUsec,
+               const Header& header,
+               Ptr<const Packet> p,
+               uint32_t captureLen = std::numeric_limits<uint32_t>::max());
 
     /**
      * \brief Read next packet from file
@@ -353,20 +384,34 @@ class PcapFile
      * \param tsSec Time stamp (seconds part)
      * \param tsUsec Time stamp (microseconds part)
      * \param totalLen total packet length
+     * \param captureLen maximum number of octets to record, in addition to the snap length
      * \returns the length of the packet to write in the Pcap file
      */
-    uint32_t WritePacketHeader(uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+    uint32_t WritePacketHeader(uint32_t tsSec,
+                               uint32_t tsUsec,
+                               uint32_t totalLen,
+                               uint32_t captureLen = std::numeric_limits<uint32_t>::max());
+
+    /**
+     * \brief Write raw bytes, either to the file stream or to the current batch
+     * \param data the bytes to write
+     * \param length the number of bytes to write
+     */
+    void WriteBytes(const void* data, uint32_t length);
 
     /**
      * \brief Read and verify a Pcap file header
      */
     void ReadAndVerifyFileHeader();
 
-    std::string m_filename;      //!< file name
-    std::fstream m_file;         //!< file stream
-    PcapFileHeader m_fileHeader; //!< file header
-    bool m_swapMode;             //!< swap mode
-    bool m_nanosecMode;          //!< nanosecond timestamp mode
+    std::string m_filename;                     //!< file name
+    std::fstream m_file;                        //!< file stream
+    PcapFileHeader m_fileHeader;                //!< file header
+    bool m_swapMode;                            //!< swap mode
+    bool m_nanosecMode;                         //!< nanosecond timestamp mode
+    uint32_t m_batchSize;                       //!< batch size for batched writes, 0 if disabled
+    PcapBatchWriter::Compression m_compression; //!< compression for batched writes
+    std::unique_ptr<PcapBatchWriter> m_writer;  //!< batched writer, if in use
 };
 
 } // namespace ns3
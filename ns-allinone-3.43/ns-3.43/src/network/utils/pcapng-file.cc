@@ -0,0 +1,259 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "pcapng-file.h"
+
+#include "ns3/assert.h"
+#include "ns3/buffer.h"
+#include "ns3/header.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+
+#include <algorithm>
+#include <map>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PcapNgFile");
+
+const uint32_t PCAPNG_SHB_TYPE = 0x0a0d0d0a;   //!< Section Header Block type
+const uint32_t PCAPNG_IDB_TYPE = 0x00000001;   //!< Interface Description Block type
+const uint32_t PCAPNG_EPB_TYPE = 0x00000006;   //!< Enhanced Packet Block type
+const uint32_t PCAPNG_BYTE_ORDER = 0x1a2b3c4d; //!< Byte-order magic, written in host order
+const uint16_t PCAPNG_VERSION_MAJOR = 1;       //!< Major version of the section format
+const uint16_t PCAPNG_VERSION_MINOR = 0;       //!< Minor version of the section format
+
+const uint16_t PCAPNG_OPT_ENDOFOPT = 0; //!< End of options marker
+const uint16_t PCAPNG_OPT_IF_NAME = 2;  //!< Interface name option
+const uint16_t PCAPNG_OPT_TSRESOL = 9;  //!< Interface timestamp resolution option
+
+/**
+ * \brief Files opened through PcapNgFile::OpenShared, by file name.
+ *
+ * The map does not hold references; a file removes itself from the map
+ * when its last reference goes away.
+ *
+ * \returns the registry
+ */
+static std::map<std::string, PcapNgFile*>&
+GetSharedFiles()
+{
+    static std::map<std::string, PcapNgFile*> files;
+    return files;
+}
+
+/**
+ * \param length a length in octets
+ * \returns the length rounded up to a multiple of 32 bits
+ */
+static uint32_t
+PadTo32(uint32_t length)
+{
+    return (length + 3) & ~3U;
+}
+
+PcapNgFile::PcapNgFile(const std::string& filename,
+                       uint32_t batchSize,
+                       PcapBatchWriter::Compression compression)
+    : m_filename(filename),
+      m_writer(filename, batchSize, compression)
+{
+    NS_LOG_FUNCTION(this << filename << batchSize << compression);
+
+    // Section Header Block, without options and with an unspecified section length
+    const uint32_t blockLength = 28;
+    Write32(PCAPNG_SHB_TYPE);
+    Write32(blockLength);
+    Write32(PCAPNG_BYTE_ORDER);
+    m_writer.Append(&PCAPNG_VERSION_MAJOR, sizeof(PCAPNG_VERSION_MAJOR));
+    m_writer.Append(&PCAPNG_VERSION_MINOR, sizeof(PCAPNG_VERSION_MINOR));
+    int64_t sectionLength = -1;
+    m_writer.Append(&sectionLength, sizeof(sectionLength));
+    Write32(blockLength);
+    m_writer.EndRecord();
+}
+
+PcapNgFile::~PcapNgFile()
+{
+    NS_LOG_FUNCTION(this);
+    auto& files = GetSharedFiles();
+    auto it = files.find(m_filename);
+    if (it != files.end() && it->second == this)
+    {
+        files.erase(it);
+    }
+    Close();
+}
+
+Ptr<PcapNgFile>
+PcapNgFile::OpenShared(const std::string& filename,
+                       uint32_t batchSize,
+                       PcapBatchWriter::Compression compression)
+{
+    NS_LOG_FUNCTION(filename << batchSize << compression);
+    auto& files = GetSharedFiles();
+    auto it = files.find(filename);
+    if (it != files.end())
+    {
+        return Ptr<PcapNgFile>(it->second);
+    }
+    auto file = Create<PcapNgFile>(filename, batchSize, compression);
+    files[filename] = PeekPointer(file);
+    return file;
+}
+
+bool
+PcapNgFile::Fail() const
+{
+    return m_writer.Fail();
+}
+
+std::string
+PcapNgFile::GetFilename() const
+{
+    return m_filename;
+}
+
+void
+PcapNgFile::Write32(uint32_t value)
+{
+    m_writer.Append(&value, sizeof(value));
+}
+
+uint32_t
+PcapNgFile::AddInterface(uint32_t dataLinkType, uint32_t snapLen, const std::string& name)
+{
+    NS_LOG_FUNCTION(this << dataLinkType << snapLen << name);
+
+    uint32_t nameLength = name.size();
+    uint32_t optionsLength = 4 + 4 + 4; // if_tsresol + opt_endofopt
+    if (nameLength > 0)
+    {
+        optionsLength += 4 + PadTo32(nameLength);
+    }
+    uint32_t blockLength = 20 + optionsLength;
+
+    Write32(PCAPNG_IDB_TYPE);
+    Write32(blockLength);
+    uint16_t linkType = dataLinkType;
+    uint16_t reserved = 0;
+    m_writer.Append(&linkType, sizeof(linkType));
+    m_writer.Append(&reserved, sizeof(reserved));
+    Write32(snapLen);
+
+    uint16_t optionHeader[2];
+    if (nameLength > 0)
+    {
+        optionHeader[0] = PCAPNG_OPT_IF_NAME;
+        optionHeader[1] = nameLength;
+        m_writer.Append(optionHeader, sizeof(optionHeader));
+        m_writer.Append(name.data(), nameLength);
+        uint8_t* padding = m_writer.Reserve(PadTo32(nameLength) - nameLength);
+        std::fill(padding, padding + PadTo32(nameLength) - nameLength, 0);
+    }
+    // Timestamps are in units of 10^-9 seconds
+    optionHeader[0] = PCAPNG_OPT_TSRESOL;
+    optionHeader[1] = 1;
+    m_writer.Append(optionHeader, sizeof(optionHeader));
+    uint8_t tsresol[4] = {9, 0, 0, 0};
+    m_writer.Append(tsresol, sizeof(tsresol));
+    optionHeader[0] = PCAPNG_OPT_ENDOFOPT;
+    optionHeader[1] = 0;
+    m_writer.Append(optionHeader, sizeof(optionHeader));
+
+    Write32(blockLength);
+    m_writer.EndRecord();
+
+    m_interfaceSnaps.push_back(snapLen);
+    return m_interfaceSnaps.size() - 1;
+}
+
+uint32_t
+PcapNgFile::GetNInterfaces() const
+{
+    return m_interfaceSnaps.size();
+}
+
+uint32_t
+PcapNgFile::WritePacketBlockHeader(uint32_t interfaceId,
+                                   uint64_t tsNs,
+                                   uint32_t totalLen,
+                                   uint32_t captureLen)
+{
+    NS_ASSERT_MSG(interfaceId < m_interfaceSnaps.size(), "Unknown interface " << interfaceId);
+    uint32_t snapLen = m_interfaceSnaps[interfaceId];
+    uint32_t inclLen = std::min(totalLen, captureLen);
+    if (snapLen != 0)
+    {
+        inclLen = std::min(inclLen, snapLen);
+    }
+
+    Write32(PCAPNG_EPB_TYPE);
+    Write32(32 + PadTo32(inclLen));
+    Write32(interfaceId);
+    Write32(static_cast<uint32_t>(tsNs >> 32));
+    Write32(static_cast<uint32_t>(tsNs & 0xffffffff));
+    Write32(inclLen);
+    Write32(totalLen);
+    return inclLen;
+}
+
+void
+PcapNgFile::WritePacketBlockTrailer(uint32_t inclLen)
+{
+    uint32_t padLength = PadTo32(inclLen) - inclLen;
+    uint8_t* padding = m_writer.Reserve(padLength);
+    std::fill(padding, padding + padLength, 0);
+    Write32(32 + PadTo32(inclLen));
+    m_writer.EndRecord();
+}
+
+void
+PcapNgFile::Write(uint32_t interfaceId, uint64_t tsNs, const uint8_t* data, uint32_t totalLen)
+{
+    NS_LOG_FUNCTION(this << interfaceId << tsNs << &data << totalLen);
+    uint32_t inclLen = WritePacketBlockHeader(interfaceId, tsNs, totalLen);
+    m_writer.Append(data, inclLen);
+    WritePacketBlockTrailer(inclLen);
+}
+
+void
+PcapNgFile::Write(uint32_t interfaceId, uint64_t tsNs, Ptr<const Packet> p, uint32_t captureLen)
+{
+    NS_LOG_FUNCTION(this << interfaceId << tsNs << p << captureLen);
+    uint32_t inclLen = WritePacketBlockHeader(interfaceId, tsNs, p->GetSize(), captureLen);
+    p->CopyData(m_writer.Reserve(inclLen), inclLen);
+    WritePacketBlockTrailer(inclLen);
+}
+
+void
+PcapNgFile::Write(uint32_t interfaceId,
+                  uint64_t tsNs,
+                  const Header& header,
+                  Ptr<const Packet> p,
+                  uint32_t captureLen)
+{
+    NS_LOG_FUNCTION(this << interfaceId << tsNs << &header << p << captureLen);
+    uint32_t headerSize = header.GetSerializedSize();
+    uint32_t inclLen =
+        WritePacketBlockHeader(interfaceId, tsNs, headerSize + p->GetSize(), captureLen);
+
+    Buffer headerBuffer;
+    headerBuffer.AddAtStart(headerSize);
+    header.Serialize(headerBuffer.Begin());
+    uint32_t toCopy = std::min(headerSize, inclLen);
+    headerBuffer.CopyData(m_writer.Reserve(toCopy), toCopy);
+    p->CopyData(m_writer.Reserve(inclLen - toCopy), inclLen - toCopy);
+    WritePacketBlockTrailer(inclLen);
+}
+
+void
+PcapNgFile::Close()
+{
+    NS_LOG_FUNCTION(this);
+    m_writer.Close();
+}
+
+} // namespace ns3
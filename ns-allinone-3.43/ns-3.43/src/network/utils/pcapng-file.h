@@ -0,0 +1,174 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include "pcap-batch-writer.h"
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+#include <limits>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+class Header;
+
+/**
+ * \ingroup network
+ *
+ * \brief A pcapng capture file shared by several interfaces.
+ *
+ * Unlike the classic pcap format handled by PcapFile, a pcapng file can
+ * hold packets captured on many interfaces, each with its own data link
+ * type and snap length.  This allows all the devices of a simulation to be
+ * traced into a single file.  Each interface is described by an Interface
+ * Description Block written when the interface is added, and packets are
+ * written as Enhanced Packet Blocks with nanosecond timestamps.
+ *
+ * Output always goes through a PcapBatchWriter, so records are serialized
+ * in memory and written to disk by a background thread.
+ *
+ * See https://www.ietf.org/archive/id/draft-ietf-opsawg-pcapng-02.html
+ */
+class PcapNgFile : public SimpleRefCount<PcapNgFile>
+{
+  public:
+    /**
+     * Create a new pcapng file and write its Section Header Block.
+     *
+     * \param filename name of the file to create
+     * \param batchSize size in bytes of the batches handed to the writer thread
+     * \param compression compression applied to the written file
+     */
+    PcapNgFile(const std::string& filename,
+               uint32_t batchSize,
+               PcapBatchWriter::Compression compression = PcapBatchWriter::COMPRESSION_NONE);
+    ~PcapNgFile();
+
+    /**
+     * Get the pcapng file with the given name, creating it if it is not
+     * already open.  The file stays open as long as a reference to it
+     * exists, so that all the callers share the same file.
+     *
+     * \param filename name of the file
+     * \param batchSize batch size used if the file has to be created
+     * \param compression compression used if the file has to be created
+     * \returns the shared file
+     */
+    static Ptr<PcapNgFile> OpenShared(
+        const std::string& filename,
+        uint32_t batchSize,
+        PcapBatchWriter::Compression compression = PcapBatchWriter::COMPRESSION_NONE);
+
+    /**
+     * \return true if the file could not be created or a write failed
+     */
+    bool Fail() const;
+
+    /**
+     * \return the name of the file
+     */
+    std::string GetFilename() const;
+
+    /**
+     * Describe a new capture interface.
+     *
+     * \param dataLinkType data link type of the packets captured on the interface
+     * \param snapLen maximum number of octets saved per packet
+     * \param name interface name stored in the file (may be empty)
+     * \returns the interface id to pass to Write()
+     */
+    uint32_t AddInterface(uint32_t dataLinkType, uint32_t snapLen, const std::string& name);
+
+    /**
+     * \return the number of interfaces described in the file
+     */
+    uint32_t GetNInterfaces() const;
+
+    /**
+     * \brief Write next packet to file
+     *
+     * \param interfaceId interface the packet was captured on
+     * \param tsNs packet timestamp, nanoseconds
+     * \param data data buffer
+     * \param totalLen total packet length
+     */
+    void Write(uint32_t interfaceId, uint64_t tsNs, const uint8_t* data, uint32_t totalLen);
+
+    /**
+     * \brief Write next packet to file
+     *
+     * \param interfaceId interface the packet was captured on
+     * \param tsNs packet timestamp, nanoseconds
+     * \param p packet to write
+     * \param captureLen maximum number of octets of the packet to record, in
+     * addition to the snap length of the interface
+     */
+    void Write(uint32_t interfaceId,
+               uint64_t tsNs,
+               Ptr<const Packet> p,
+               uint32_t captureLen = std::numeric_limits<uint32_t>::max());
+
+    /**
+     * \brief Write next packet to file
+     *
+     * \param interfaceId interface the packet was captured on
+     * \param tsNs packet timestamp, nanoseconds
+     * \param header header to write, in front of packet
+     * \param p packet to write
+     * \param captureLen maximum number of octets of the header and packet to
+     * record, in addition to the snap length of the interface
+     */
+    void Write(uint32_t interfaceId,
+               uint64_t tsNs,
+               const Header& header,
+               Ptr<const Packet> p,
+               uint32_t captureLen = std::numeric_limits<uint32_t>::max());
+
+    /**
+     * Flush all pending records and close the file.
+     */
+    void Close();
+
+  private:
+    /**
+     * \brief Write the header of an Enhanced Packet Block
+     * \param interfaceId interface the packet was captured on
+     * \param tsNs packet timestamp, nanoseconds
+     * \param totalLen total packet length
+     * \param captureLen maximum number of octets to record
+     * \returns the number of packet octets to write in the block
+     */
+    uint32_t WritePacketBlockHeader(uint32_t interfaceId,
+                                    uint64_t tsNs,
+                                    uint32_t totalLen,
+                                    uint32_t captureLen = std::numeric_limits<uint32_t>::max());
+
+    /**
+     * \brief Pad the packet data and write the trailer of an Enhanced Packet Block
+     * \param inclLen the number of packet octets written in the block
+     */
+    void WritePacketBlockTrailer(uint32_t inclLen);
+
+    /**
+     * \brief Write a 32-bit value in host byte order
+     * \param value the value
+     */
+    void Write32(uint32_t value);
+
+    std::string m_filename;                 //!< file name
+    PcapBatchWriter m_writer;               //!< batched output
+    std::vector<uint32_t> m_interfaceSnaps; //!< snap length of each interface
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
@@ -67,7 +67,8 @@ QueueDiscItem::QueueDiscItem(Ptr<Packet> p, const Address& addr, uint16_t protoc
     : QueueItem(p),
       m_address(addr),
       m_protocol(protocol),
-      m_txq(0)
+      m_txq(0),
+      m_flowDescriptorState(FlowDescriptorState::UNPARSED)
 {
     NS_LOG_FUNCTION(this << p << addr << protocol);
 }
@@ -135,4 +136,35 @@ QueueDiscItem::Hash(uint32_t perturbation) const
     return 0;
 }
 
+std::vector<Ptr<QueueDiscItem>>
+QueueDiscItem::Segment() const
+{
+    return {};
+}
+
+const FlowDescriptor*
+QueueDiscItem::GetFlowDescriptor() const
+{
+    if (m_flowDescriptorState == FlowDescriptorState::UNPARSED)
+    {
+        m_flowDescriptor = FlowDescriptor();
+        m_flowDescriptorState = ParseFlowDescriptor(m_flowDescriptor)
+                                    ? FlowDescriptorState::VALID
+                                    : FlowDescriptorState::INVALID;
+    }
+    return m_flowDescriptorState == FlowDescriptorState::VALID ? &m_flowDescriptor : nullptr;
+}
+
+bool
+QueueDiscItem::ParseFlowDescriptor(FlowDescriptor& descriptor) const
+{
+    return false;
+}
+
+void
+QueueDiscItem::ResetFlowDescriptor()
+{
+    m_flowDescriptorState = FlowDescriptorState::UNPARSED;
+}
+
 } // namespace ns3
@@ -13,6 +13,9 @@
 #include "ns3/simple-ref-count.h"
 #include <ns3/address.h>
 
+#include <array>
+#include <vector>
+
 namespace ns3
 {
 
@@ -110,6 +113,28 @@ class QueueItem : public SimpleRefCount<QueueItem>
  */
 std::ostream& operator<<(std::ostream& os, const QueueItem& item);
 
+/**
+ * \ingroup network
+ *
+ * \brief The L3 and L4 fields of a packet that are used to classify it and to
+ * compute its flow hash.
+ *
+ * IPv4 addresses are stored in the first 4 bytes of the address arrays, while
+ * the remaining bytes are zero. The port numbers are zero if the packet does
+ * not carry a TCP or UDP header (e.g., a non-first fragment).
+ */
+struct FlowDescriptor
+{
+    std::array<uint8_t, 16> srcAddress{}; //!< source address, in network order
+    std::array<uint8_t, 16> dstAddress{}; //!< destination address, in network order
+    uint16_t l3Protocol{0};               //!< L3 protocol number
+    uint16_t srcPort{0};                  //!< L4 source port
+    uint16_t dstPort{0};                  //!< L4 destination port
+    uint8_t l4Protocol{0};                //!< L4 protocol number
+    uint8_t dscp{0};                      //!< DiffServ codepoint
+    uint8_t ecn{0};                       //!< ECN codepoint
+};
+
 /**
  * \ingroup network
  *
@@ -206,11 +231,66 @@ class QueueDiscItem : public QueueItem
      */
     virtual uint32_t Hash(uint32_t perturbation = 0) const;
 
+    /**
+     * \brief Split a super-segment into the packets transmitted on the wire
+     *
+     * A sender using segmentation offload hands a single super-segment to the
+     * network layer, which is split into wire packets by the traffic control layer
+     * before being enqueued in the queue disc or in the device. This method just
+     * returns an empty list, i.e., the packet is transmitted as is. Subclasses
+     * should implement it for the protocols supporting segmentation offload.
+     *
+     * \return the items containing the wire packets, or an empty list if the
+     *         packet is not a super-segment
+     */
+    virtual std::vector<Ptr<QueueDiscItem>> Segment() const;
+
+    /**
+     * \brief Get the L3 and L4 fields of the packet
+     *
+     * The packet headers are parsed on the first call only, so that the packet
+     * filters and the flow hash of the queue discs share a single parsing of
+     * each packet.
+     *
+     * \return the fields of the packet, or a null pointer if the subclass
+     *         cannot parse the headers of the packet
+     */
+    const FlowDescriptor* GetFlowDescriptor() const;
+
+  protected:
+    /**
+     * \brief Parse the L3 and L4 fields of the packet
+     *
+     * This method just returns false. Subclasses should implement it for their
+     * protocol type.
+     *
+     * \param [out] descriptor the fields of the packet
+     * \return true if the packet has been parsed
+     */
+    virtual bool ParseFlowDescriptor(FlowDescriptor& descriptor) const;
+
+    /**
+     * \brief Discard the parsed fields of the packet, which are parsed again
+     * when next requested. Subclasses shall call this method whenever they
+     * modify the packet headers (e.g., when marking the packet).
+     */
+    void ResetFlowDescriptor();
+
   private:
-    Address m_address;   //!< MAC destination address
-    uint16_t m_protocol; //!< L3 Protocol number
-    uint8_t m_txq;       //!< Transmission queue index
-    Time m_tstamp;       //!< timestamp when the packet was enqueued
+    /// State of the parsed fields of the packet
+    enum class FlowDescriptorState : uint8_t
+    {
+        UNPARSED,
+        VALID,
+        INVALID
+    };
+
+    Address m_address;                                 //!< MAC destination address
+    uint16_t m_protocol;                               //!< L3 Protocol number
+    uint8_t m_txq;                                     //!< Transmission queue index
+    Time m_tstamp;                                     //!< timestamp when the packet was enqueued
+    mutable FlowDescriptorState m_flowDescriptorState; //!< state of the parsed fields
+    mutable FlowDescriptor m_flowDescriptor;           //!< parsed fields of the packet
 };
 
 } // namespace ns3
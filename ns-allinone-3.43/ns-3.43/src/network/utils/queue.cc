@@ -51,6 +51,7 @@ QueueBase::QueueBase()
 {
     NS_LOG_FUNCTION(this);
     m_maxSize = QueueSize(QueueSizeUnit::PACKETS, std::numeric_limits<uint32_t>::max());
+    m_markThreshold = QueueSize(QueueSizeUnit::PACKETS, 0);
 }
 
 QueueBase::~QueueBase()
@@ -222,4 +223,35 @@ QueueBase::WouldOverflow(uint32_t nPackets, uint32_t nBytes) const
     }
 }
 
+void
+QueueBase::SetMarkThreshold(QueueSize threshold)
+{
+    NS_LOG_FUNCTION(this << threshold);
+    m_markThreshold = threshold;
+}
+
+QueueSize
+QueueBase::GetMarkThreshold() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_markThreshold;
+}
+
+bool
+QueueBase::IsMarkThresholdReached() const
+{
+    if (!m_markThreshold.GetValue())
+    {
+        return false;
+    }
+    if (m_markThreshold.GetUnit() == QueueSizeUnit::PACKETS)
+    {
+        return (m_nPackets >= m_markThreshold.GetValue());
+    }
+    else
+    {
+        return (m_nBytes >= m_markThreshold.GetValue());
+    }
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 #include "ns3/traced-callback.h"
 #include "ns3/traced-value.h"
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <type_traits>
@@ -179,6 +180,33 @@ class QueueBase : public Object
      */
     bool WouldOverflow(uint32_t nPackets, uint32_t nBytes) const;
 
+    /**
+     * \brief Set the occupancy above which the packets sent to this queue are
+     * to be ECN marked
+     *
+     * The queue does not mark the packets itself, as it may store items that
+     * cannot be marked: the threshold is checked through IsMarkThresholdReached
+     * by the layer that enqueues the packets (e.g., the traffic control layer,
+     * when no queue disc is installed on the device). A null threshold (the
+     * default) disables the marking.
+     *
+     * \param threshold the mark threshold, in packets or bytes
+     */
+    void SetMarkThreshold(QueueSize threshold);
+
+    /**
+     * \return the occupancy above which the packets are to be ECN marked
+     */
+    QueueSize GetMarkThreshold() const;
+
+    /**
+     * \brief Check if a packet enqueued now is to be ECN marked
+     * Note: the check is performed in the unit (bytes or packets) of the mark threshold.
+     * \return true if the mark threshold is not null and the occupancy of the
+     *         queue is at least the mark threshold, false otherwise.
+     */
+    bool IsMarkThresholdReached() const;
+
 #if 0
   // average calculation requires keeping around
   // a buffer with the date of arrival of past received packets
@@ -215,7 +243,8 @@ class QueueBase : public Object
     uint32_t m_nTotalDroppedPacketsBeforeEnqueue; //!< Total dropped packets before enqueue
     uint32_t m_nTotalDroppedPacketsAfterDequeue;  //!< Total dropped packets after dequeue
 
-    QueueSize m_maxSize; //!< max queue size
+    QueueSize m_maxSize;       //!< max queue size
+    QueueSize m_markThreshold; //!< occupancy above which the packets are to be marked
 };
 
 /**
@@ -235,7 +264,11 @@ class QueueBase : public Object
  * container used internally to store queue items. The container type must provide
  * the methods insert(), erase() and clear() and define the iterator and const_iterator
  * types, following the usual syntax of C++ containers. The default container type
- * is std::list (as defined in queue-fwd.h). In case the container is such that
+ * is RingBuffer (as defined in queue-fwd.h), which does not allocate memory on
+ * enqueue and dequeue once it has grown to the maximum queue length. If the
+ * container provides the capacity() and reserve() methods, the container is
+ * sized to the maximum queue size the first time it fills up, when the maximum
+ * size is expressed in packets. In case the container is such that
  * an object stored within the queue is obtained from a container element through
  * an operation other than dereferencing an iterator pointing to the container
  * element, the container has to provide a public method named GetItem that
@@ -420,6 +453,53 @@ class Queue : public QueueBase
         }
     };
 
+    /**
+     * Struct providing a static method that makes room in the container for the
+     * maximum number of packets in the queue, if known.  This method is used when
+     * the container does not define the capacity and reserve methods and does
+     * nothing.
+     */
+    template <class, class = void>
+    struct MakeReserve
+    {
+        /**
+         * \param maxSize the maximum queue size
+         */
+        static void Reserve(Container&, QueueSize maxSize)
+        {
+        }
+    };
+
+    /**
+     * Struct providing a static method that makes room in the container for the
+     * maximum number of packets in the queue, if known.  This method is used when
+     * the container defines the capacity and reserve methods; the container is
+     * only sized once it is full, and up to a bound, so that queues with a large
+     * maximum size do not allocate memory they never use.
+     */
+    template <class T>
+    struct MakeReserve<T,
+                       std::void_t<decltype(std::declval<T>().capacity()),
+                                   decltype(std::declval<T>().reserve(std::size_t()))>>
+    {
+        /**
+         * \param container the container
+         * \param maxSize the maximum queue size
+         */
+        static void Reserve(Container& container, QueueSize maxSize)
+        {
+            // Bound on the number of elements reserved upfront
+            const std::size_t maxReserved = 1 << 16;
+
+            if (container.size() == container.capacity() &&
+                maxSize.GetUnit() == QueueSizeUnit::PACKETS &&
+                container.capacity() < std::min<std::size_t>(maxSize.GetValue(), maxReserved))
+            {
+                container.reserve(std::min<std::size_t>(maxSize.GetValue(), maxReserved));
+            }
+        }
+    };
+
     Container m_packets;     //!< the items in the queue
     NS_LOG_TEMPLATE_DECLARE; //!< the log component
 
@@ -516,6 +596,7 @@ Queue<Item, Container>::DoEnqueue(ConstIterator pos, Ptr<Item> item, Iterator& r
         return false;
     }
 
+    MakeReserve<Container>::Reserve(m_packets, GetMaxSize());
     ret = m_packets.insert(pos, item);
 
     uint32_t size = item->GetSize();
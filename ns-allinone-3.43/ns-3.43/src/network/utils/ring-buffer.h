@@ -0,0 +1,495 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup queue
+ * ns3::RingBuffer declaration and implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup queue
+ *
+ * \brief A sequence container storing its elements in a circular array.
+ *
+ * RingBuffer provides the subset of the std::list interface used by the
+ * Queue class template, so that it can be used as the Queue container.
+ * Elements live in a contiguous array which is only reallocated when it is
+ * full, so that, once the array has grown to the maximum queue length,
+ * inserting and removing elements at either end does not allocate memory.
+ * Inserting or removing elements elsewhere requires moving the elements
+ * between the given position and the closest end of the buffer.
+ *
+ * Unlike with std::list, iterators are positions in the buffer: they are
+ * invalidated by any insertion or removal.
+ *
+ * \tparam T \explicit the type of the stored elements
+ */
+template <typename T>
+class RingBuffer
+{
+  private:
+    /**
+     * \brief Iterator over the elements of a RingBuffer
+     * \tparam Const true for a const iterator
+     */
+    template <bool Const>
+    class IteratorImpl
+    {
+      public:
+        /// Iterator category
+        using iterator_category = std::random_access_iterator_tag;
+        /// Type of the elements
+        using value_type = T;
+        /// Type of the distance between two iterators
+        using difference_type = std::ptrdiff_t;
+        /// Type of a pointer to an element
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        /// Type of a reference to an element
+        using reference = std::conditional_t<Const, const T&, T&>;
+        /// Type of a pointer to the buffer
+        using BufferPointer = std::conditional_t<Const, const RingBuffer*, RingBuffer*>;
+
+        IteratorImpl()
+            : m_buffer(nullptr),
+              m_index(0)
+        {
+        }
+
+        /**
+         * \param buffer the buffer
+         * \param index the position in the buffer (0 is the front)
+         */
+        IteratorImpl(BufferPointer buffer, std::size_t index)
+            : m_buffer(buffer),
+              m_index(index)
+        {
+        }
+
+        /**
+         * Convert an iterator into a const iterator
+         * \param other the iterator
+         */
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        IteratorImpl(const IteratorImpl<false>& other)
+            : m_buffer(other.m_buffer),
+              m_index(other.m_index)
+        {
+        }
+
+        /// \return a reference to the element
+        reference operator*() const
+        {
+            return m_buffer->At(m_index);
+        }
+
+        /// \return a pointer to the element
+        pointer operator->() const
+        {
+            return &m_buffer->At(m_index);
+        }
+
+        /// \return this iterator, moved to the next element
+        IteratorImpl& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        /// \return a copy of this iterator, which is moved to the next element
+        IteratorImpl operator++(int)
+        {
+            IteratorImpl tmp = *this;
+            ++m_index;
+            return tmp;
+        }
+
+        /// \return this iterator, moved to the previous element
+        IteratorImpl& operator--()
+        {
+            --m_index;
+            return *this;
+        }
+
+        /// \return a copy of this iterator, which is moved to the previous element
+        IteratorImpl operator--(int)
+        {
+            IteratorImpl tmp = *this;
+            --m_index;
+            return tmp;
+        }
+
+        /**
+         * \param n number of positions
+         * \return this iterator, moved forward by n positions
+         */
+        IteratorImpl& operator+=(difference_type n)
+        {
+            m_index += n;
+            return *this;
+        }
+
+        /**
+         * \param n number of positions
+         * \return an iterator n positions after this one
+         */
+        IteratorImpl operator+(difference_type n) const
+        {
+            return IteratorImpl(m_buffer, m_index + n);
+        }
+
+        /**
+         * \param n number of positions
+         * \return an iterator n positions before this one
+         */
+        IteratorImpl operator-(difference_type n) const
+        {
+            return IteratorImpl(m_buffer, m_index - n);
+        }
+
+        /**
+         * \param other another iterator on the same buffer
+         * \return the distance between the two iterators
+         */
+        difference_type operator-(const IteratorImpl& other) const
+        {
+            return static_cast<difference_type>(m_index) -
+                   static_cast<difference_type>(other.m_index);
+        }
+
+        /**
+         * \param other another iterator
+         * \return true if the iterators point to the same position
+         */
+        bool operator==(const IteratorImpl& other) const
+        {
+            return m_buffer == other.m_buffer && m_index == other.m_index;
+        }
+
+        /**
+         * \param other another iterator
+         * \return true if the iterators point to different positions
+         */
+        bool operator!=(const IteratorImpl& other) const
+        {
+            return !(*this == other);
+        }
+
+        /**
+         * \param other another iterator on the same buffer
+         * \return true if this iterator precedes the other one
+         */
+        bool operator<(const IteratorImpl& other) const
+        {
+            return m_index < other.m_index;
+        }
+
+      private:
+        friend class RingBuffer;
+        friend class IteratorImpl<true>;
+
+        BufferPointer m_buffer; //!< the buffer
+        std::size_t m_index;    //!< the position in the buffer
+    };
+
+  public:
+    /// Type of the stored elements
+    using value_type = T;
+    /// Type of sizes
+    using size_type = std::size_t;
+    /// Iterator
+    using iterator = IteratorImpl<false>;
+    /// Const iterator
+    using const_iterator = IteratorImpl<true>;
+
+    RingBuffer()
+        : m_head(0),
+          m_size(0)
+    {
+    }
+
+    /// \return an iterator to the first element
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    /// \return a const iterator to the first element
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    /// \return an iterator past the last element
+    iterator end()
+    {
+        return iterator(this, m_size);
+    }
+
+    /// \return a const iterator past the last element
+    const_iterator end() const
+    {
+        return const_iterator(this, m_size);
+    }
+
+    /// \return the number of elements
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    /// \return true if there are no elements
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /// \return the number of elements that can be held without reallocating
+    size_type capacity() const
+    {
+        return m_storage.size();
+    }
+
+    /**
+     * \param index a position in the buffer (0 is the front)
+     * \return a reference to the element at that position
+     */
+    T& operator[](size_type index)
+    {
+        return At(index);
+    }
+
+    /**
+     * \param index a position in the buffer (0 is the front)
+     * \return a const reference to the element at that position
+     */
+    const T& operator[](size_type index) const
+    {
+        return At(index);
+    }
+
+    /// \return a reference to the first element
+    T& front()
+    {
+        return At(0);
+    }
+
+    /// \return a const reference to the first element
+    const T& front() const
+    {
+        return At(0);
+    }
+
+    /// \return a reference to the last element
+    T& back()
+    {
+        return At(m_size - 1);
+    }
+
+    /// \return a const reference to the last element
+    const T& back() const
+    {
+        return At(m_size - 1);
+    }
+
+    /**
+     * Make room for the given number of elements, so that no reallocation
+     * happens until the buffer holds more elements.
+     *
+     * \param n the number of elements
+     */
+    void reserve(size_type n)
+    {
+        if (n > m_storage.size())
+        {
+            Reallocate(n);
+        }
+    }
+
+    /**
+     * \param value the element to append
+     */
+    void push_back(T value)
+    {
+        GrowIfFull();
+        m_storage[Slot(m_size)] = std::move(value);
+        ++m_size;
+    }
+
+    /**
+     * \param value the element to prepend
+     */
+    void push_front(T value)
+    {
+        GrowIfFull();
+        m_head = (m_head == 0 ? m_storage.size() : m_head) - 1;
+        m_storage[m_head] = std::move(value);
+        ++m_size;
+    }
+
+    /// Remove the first element
+    void pop_front()
+    {
+        m_storage[m_head] = T();
+        m_head = Slot(1);
+        --m_size;
+    }
+
+    /// Remove the last element
+    void pop_back()
+    {
+        m_storage[Slot(m_size - 1)] = T();
+        --m_size;
+    }
+
+    /**
+     * Insert an element before the given position
+     *
+     * \param pos the position
+     * \param value the element
+     * \return an iterator to the inserted element
+     */
+    iterator insert(const_iterator pos, T value)
+    {
+        std::size_t index = pos.m_index;
+        if (index == m_size)
+        {
+            push_back(std::move(value));
+        }
+        else if (index == 0)
+        {
+            push_front(std::move(value));
+        }
+        else if (index < m_size / 2)
+        {
+            push_front(T());
+            for (std::size_t i = 0; i < index; ++i)
+            {
+                At(i) = std::move(At(i + 1));
+            }
+            At(index) = std::move(value);
+        }
+        else
+        {
+            push_back(T());
+            for (std::size_t i = m_size - 1; i > index; --i)
+            {
+                At(i) = std::move(At(i - 1));
+            }
+            At(index) = std::move(value);
+        }
+        return iterator(this, index);
+    }
+
+    /**
+     * Remove the element at the given position
+     *
+     * \param pos the position
+     * \return an iterator to the element following the removed one
+     */
+    iterator erase(const_iterator pos)
+    {
+        std::size_t index = pos.m_index;
+        if (index < m_size / 2)
+        {
+            for (std::size_t i = index; i > 0; --i)
+            {
+                At(i) = std::move(At(i - 1));
+            }
+            pop_front();
+        }
+        else
+        {
+            for (std::size_t i = index; i + 1 < m_size; ++i)
+            {
+                At(i) = std::move(At(i + 1));
+            }
+            pop_back();
+        }
+        return iterator(this, index);
+    }
+
+    /// Remove all the elements, keeping the allocated memory
+    void clear()
+    {
+        while (!empty())
+        {
+            pop_back();
+        }
+        m_head = 0;
+    }
+
+  private:
+    /**
+     * \param index a position in the buffer (0 is the front)
+     * \return the index of the corresponding slot of the storage
+     */
+    std::size_t Slot(std::size_t index) const
+    {
+        std::size_t slot = m_head + index;
+        return slot < m_storage.size() ? slot : slot - m_storage.size();
+    }
+
+    /**
+     * \param index a position in the buffer (0 is the front)
+     * \return a reference to the element at that position
+     */
+    T& At(std::size_t index)
+    {
+        return m_storage[Slot(index)];
+    }
+
+    /**
+     * \param index a position in the buffer (0 is the front)
+     * \return a const reference to the element at that position
+     */
+    const T& At(std::size_t index) const
+    {
+        return m_storage[Slot(index)];
+    }
+
+    /// Double the capacity if the buffer is full
+    void GrowIfFull()
+    {
+        if (m_size == m_storage.size())
+        {
+            Reallocate(m_storage.empty() ? 16 : 2 * m_storage.size());
+        }
+    }
+
+    /**
+     * Move the elements to a new storage, starting at its first slot
+     * \param n the capacity of the new storage
+     */
+    void Reallocate(std::size_t n)
+    {
+        std::vector<T> storage(n);
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            storage[i] = std::move(At(i));
+        }
+        m_storage.swap(storage);
+        m_head = 0;
+    }
+
+    std::vector<T> m_storage; //!< circular array of elements
+    std::size_t m_head;       //!< slot of the first element
+    std::size_t m_size;       //!< number of elements
+};
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_H */
@@ -14,19 +14,37 @@
 #include "nix-vector-routing.h"
 
 #include "ns3/abort.h"
+#include "ns3/global-value.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
 #include "ns3/loopback-net-device.h"
 #include "ns3/names.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
+#include <limits>
 #include <queue>
+#include <set>
+#include <thread>
 
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("NixVectorRouting");
 
+/**
+ * \ingroup nix-vector-routing
+ * \brief The maximum number of nix-vectors cached for all the nodes
+ */
+static GlobalValue g_nixVectorCacheSize("NixVectorCacheSize",
+                                        "The maximum number of nix-vectors cached for all the "
+                                        "nodes, beyond which the least recently used ones are "
+                                        "evicted (0 for no limit)",
+                                        UintegerValue(0),
+                                        MakeUintegerChecker<uint32_t>());
+
 NS_OBJECT_TEMPLATE_CLASS_DEFINE(NixVectorRouting, Ipv4RoutingProtocol);
 NS_OBJECT_TEMPLATE_CLASS_DEFINE(NixVectorRouting, Ipv6RoutingProtocol);
 
@@ -44,6 +62,18 @@ template <typename T>
 typename NixVectorRouting<T>::NetDeviceToIpInterfaceMap
     NixVectorRouting<T>::g_netdeviceToIpInterfaceMap;
 
+template <typename T>
+typename NixVectorRouting<T>::NetDeviceToAdjacentMap NixVectorRouting<T>::g_adjacentNetDevicesMap;
+
+template <typename T>
+typename NixVectorRouting<T>::NixMap_t NixVectorRouting<T>::g_nixCache;
+
+template <typename T>
+std::vector<Ptr<NetDevice>> NixVectorRouting<T>::g_changedDevices;
+
+template <typename T>
+typename NixVectorRouting<T>::CacheStats NixVectorRouting<T>::g_cacheStats;
+
 template <typename T>
 TypeId
 NixVectorRouting<T>::GetTypeId()
@@ -60,7 +90,15 @@ NixVectorRouting<T>::GetTypeId()
     static TypeId tid = TypeId("ns3::" + name + "NixVectorRouting")
                             .SetParent<T>()
                             .SetGroupName("NixVectorRouting")
-                            .template AddConstructor<NixVectorRouting<T>>();
+                            .template AddConstructor<NixVectorRouting<T>>()
+                            .AddAttribute(
+                                "MaxCacheSize",
+                                "The maximum number of destinations whose route is cached by "
+                                "the node (0 for no limit).",
+                                UintegerValue(0),
+                                MakeUintegerAccessor(&NixVectorRouting<T>::SetMaxCacheSize,
+                                                     &NixVectorRouting<T>::GetMaxCacheSize),
+                                MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
@@ -122,6 +160,13 @@ NixVectorRouting<T>::DoDispose()
     m_node = nullptr;
     m_ip = nullptr;
 
+    // The caches shared by all the nodes refer to the nodes being disposed
+    g_nixCache.Clear();
+    g_changedDevices.clear();
+    g_ipAddressToNodeMap.clear();
+    g_netdeviceToIpInterfaceMap.clear();
+    g_adjacentNetDevicesMap.clear();
+
     T::DoDispose();
 }
 
@@ -134,6 +179,46 @@ NixVectorRouting<T>::SetNode(Ptr<Node> node)
     m_node = node;
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::SetMaxCacheSize(uint32_t maxCacheSize)
+{
+    NS_LOG_FUNCTION(this << maxCacheSize);
+
+    g_cacheStats.evictions += m_ipRouteCache.SetMaxSize(maxCacheSize);
+}
+
+template <typename T>
+uint32_t
+NixVectorRouting<T>::GetMaxCacheSize() const
+{
+    return m_ipRouteCache.GetMaxSize();
+}
+
+template <typename T>
+typename NixVectorRouting<T>::CacheStats
+NixVectorRouting<T>::GetCacheStats()
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    CacheStats stats = g_cacheStats;
+    for (const auto& entry : g_nixCache.GetMap())
+    {
+        stats.memoryBytes += sizeof(NixVector) + entry.second.value.nixVector->GetSerializedSize() +
+                             entry.second.value.path.size() * sizeof(uint32_t);
+    }
+    stats.nixVectors = g_nixCache.GetSize();
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<NixVectorRouting<T>> rp = (*i)->GetObject<NixVectorRouting>();
+        if (rp)
+        {
+            stats.routes += rp->m_ipRouteCache.GetSize();
+        }
+    }
+    return stats;
+}
+
 template <typename T>
 void
 NixVectorRouting<T>::FlushGlobalNixRoutingCache() const
@@ -149,22 +234,172 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache() const
             continue;
         }
         NS_LOG_LOGIC("Flushing Nix caches.");
-        rp->FlushNixCache();
         rp->FlushIpRouteCache();
         rp->m_totalNeighbors = 0;
     }
+    g_nixCache.Clear();
+    g_changedDevices.clear();
 
     // IP address to node mapping is potentially invalid so clear it.
     // Will be repopulated in lazy evaluation when mapping is needed.
     g_ipAddressToNodeMap.clear();
+    // Same for the adjacent net devices, which depend on the state and
+    // on the addresses of the interfaces
+    g_adjacentNetDevicesMap.clear();
 }
 
 template <typename T>
 void
-NixVectorRouting<T>::FlushNixCache() const
+NixVectorRouting<T>::FlushChangedNixRoutingCache() const
 {
     NS_LOG_FUNCTION_NOARGS();
-    m_nixCache.clear();
+
+    if (std::find(g_changedDevices.begin(), g_changedDevices.end(), nullptr) !=
+        g_changedDevices.end())
+    {
+        FlushGlobalNixRoutingCache();
+        return;
+    }
+
+    // The neighbors (and their nix index) of the nodes attached to the
+    // channels of the changed interfaces can have changed, as well as those
+    // of the nodes bridged to these channels
+    uint32_t nNodes = NodeList::GetNNodes();
+    std::vector<bool> changed(nNodes, false);
+    std::vector<Ptr<Channel>> channels;
+    std::set<Ptr<Channel>> visited;
+    for (const auto& device : g_changedDevices)
+    {
+        changed[device->GetNode()->GetId()] = true;
+        if (device->GetChannel())
+        {
+            channels.push_back(device->GetChannel());
+        }
+    }
+    g_changedDevices.clear();
+    while (!channels.empty())
+    {
+        Ptr<Channel> channel = channels.back();
+        channels.pop_back();
+        if (!visited.insert(channel).second)
+        {
+            continue;
+        }
+        for (std::size_t i = 0; i < channel->GetNDevices(); i++)
+        {
+            Ptr<NetDevice> device = channel->GetDevice(i);
+            changed[device->GetNode()->GetId()] = true;
+            Ptr<BridgeNetDevice> bd = NetDeviceIsBridged(device);
+            for (uint32_t j = 0; bd && j < bd->GetNBridgePorts(); j++)
+            {
+                if (bd->GetBridgePort(j)->GetChannel())
+                {
+                    channels.push_back(bd->GetBridgePort(j)->GetChannel());
+                }
+            }
+        }
+    }
+
+    // The addresses and the state of the interfaces may have changed
+    g_ipAddressToNodeMap.clear();
+    g_netdeviceToIpInterfaceMap.clear();
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        Ptr<Node> node = NodeList::GetNode(i);
+        if (changed[i])
+        {
+            for (uint32_t j = 0; j < node->GetNDevices(); j++)
+            {
+                g_adjacentNetDevicesMap.erase(node->GetDevice(j));
+            }
+        }
+        Ptr<NixVectorRouting<T>> rp = node->GetObject<NixVectorRouting>();
+        if (rp)
+        {
+            // The routes are built from the nix-vectors without any BFS, and
+            // the routes of the transit nodes do not depend on their source
+            rp->FlushIpRouteCache();
+            if (changed[i])
+            {
+                rp->m_totalNeighbors = 0;
+            }
+        }
+    }
+
+    // A path can only be shortened by the links of the changed nodes: a
+    // path from s to d through them is at least as long as the distance
+    // from s to the closest changed node, plus one hop, plus the distance
+    // from the closest changed node to d
+    const uint32_t unreachable = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> distance(nNodes, unreachable);
+    std::queue<uint32_t> queue;
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        if (changed[i])
+        {
+            distance[i] = 0;
+            queue.push(i);
+        }
+    }
+    std::vector<uint32_t> neighbors;
+    while (!queue.empty())
+    {
+        uint32_t u = queue.front();
+        queue.pop();
+        GetNeighborNodes(NodeList::GetNode(u), neighbors);
+        for (uint32_t v : neighbors)
+        {
+            if (distance[v] == unreachable)
+            {
+                distance[v] = distance[u] + 1;
+                queue.push(v);
+            }
+        }
+    }
+
+    std::vector<typename NixMap_t::Map::key_type> flushed;
+    for (const auto& [key, entry] : g_nixCache.GetMap())
+    {
+        const std::vector<uint32_t>& path = entry.value.path;
+        Ptr<Node> destNode = GetNodeByIp(key.second);
+        bool flush = !destNode || destNode->GetId() != path.back();
+        for (std::size_t i = 0; !flush && i + 1 < path.size(); i++)
+        {
+            flush = changed[path[i]];
+        }
+        if (!flush && distance[path.front()] != unreachable && distance[path.back()] != unreachable)
+        {
+            flush = uint64_t(distance[path.front()]) + 1 + distance[path.back()] < path.size() - 1;
+        }
+        if (flush)
+        {
+            flushed.push_back(key);
+        }
+        else
+        {
+            // The packets carrying the nix-vector are still routed along its path
+            entry.value.nixVector->SetEpoch(g_epoch);
+        }
+    }
+    NS_LOG_LOGIC("Flushing " << flushed.size() << " of " << g_nixCache.GetSize()
+                             << " nix-vectors.");
+    for (const auto& key : flushed)
+    {
+        g_nixCache.Erase(key);
+    }
+    g_cacheStats.flushes += flushed.size();
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::NotifyInterfaceChange(uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << interface);
+
+    // An unknown interface flushes all the caches
+    g_changedDevices.push_back(interface < m_ip->GetNInterfaces() ? m_ip->GetNetDevice(interface)
+                                                                  : nullptr);
+    g_isCacheDirty = true;
 }
 
 template <typename T>
@@ -172,14 +407,17 @@ void
 NixVectorRouting<T>::FlushIpRouteCache() const
 {
     NS_LOG_FUNCTION_NOARGS();
-    m_ipRouteCache.clear();
+    m_ipRouteCache.Clear();
 }
 
 template <typename T>
 Ptr<NixVector>
-NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevice> oif) const
+NixVectorRouting<T>::GetNixVector(Ptr<Node> source,
+                                  IpAddress dest,
+                                  Ptr<NetDevice> oif,
+                                  std::vector<uint32_t>* path) const
 {
-    NS_LOG_FUNCTION(this << source << dest << oif);
+    NS_LOG_FUNCTION(this << source << dest << oif << path);
 
     Ptr<NixVector> nixVector = Create<NixVector>();
     nixVector->SetEpoch(g_epoch);
@@ -212,6 +450,15 @@ NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevic
         {
             if (BuildNixVector(parentVector, source->GetId(), destNode->GetId(), nixVector))
             {
+                if (path)
+                {
+                    path->assign(1, destNode->GetId());
+                    while (path->back() != source->GetId())
+                    {
+                        path->push_back(parentVector.at(path->back())->GetId());
+                    }
+                    std::reverse(path->begin(), path->end());
+                }
                 return nixVector;
             }
             else
@@ -230,25 +477,44 @@ NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevic
 
 template <typename T>
 Ptr<NixVector>
-NixVectorRouting<T>::GetNixVectorInCache(const IpAddress& address, bool& foundInCache) const
+NixVectorRouting<T>::GetNixVectorInCache(Ptr<Node> source,
+                                         const IpAddress& address,
+                                         bool& foundInCache) const
 {
-    NS_LOG_FUNCTION(this << address);
+    NS_LOG_FUNCTION(this << source << address);
 
     CheckCacheStateAndFlush();
 
-    auto iter = m_nixCache.find(address);
-    if (iter != m_nixCache.end())
+    const NixCacheEntry* entry = g_nixCache.Find({source->GetId(), address});
+    if (entry)
     {
         NS_LOG_LOGIC("Found Nix-vector in cache.");
+        g_cacheStats.hits++;
         foundInCache = true;
-        return iter->second;
+        return entry->nixVector;
     }
 
     // not in cache
+    g_cacheStats.misses++;
     foundInCache = false;
     return nullptr;
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::InsertNixVectorInCache(uint32_t source,
+                                            const IpAddress& address,
+                                            Ptr<NixVector> nixVector,
+                                            const std::vector<uint32_t>& path) const
+{
+    NS_LOG_FUNCTION(this << source << address << nixVector);
+
+    UintegerValue maxSize;
+    g_nixVectorCacheSize.GetValue(maxSize);
+    g_cacheStats.evictions += g_nixCache.SetMaxSize(maxSize.Get());
+    g_cacheStats.evictions += g_nixCache.Insert({source, address}, {nixVector, path});
+}
+
 template <typename T>
 Ptr<typename NixVectorRouting<T>::IpRoute>
 NixVectorRouting<T>::GetIpRouteInCache(IpAddress address)
@@ -257,11 +523,11 @@ NixVectorRouting<T>::GetIpRouteInCache(IpAddress address)
 
     CheckCacheStateAndFlush();
 
-    auto iter = m_ipRouteCache.find(address);
-    if (iter != m_ipRouteCache.end())
+    const Ptr<IpRoute>* route = m_ipRouteCache.Find(address);
+    if (route)
     {
         NS_LOG_LOGIC("Found IpRoute in cache.");
-        return iter->second;
+        return *route;
     }
 
     // not in cache
@@ -313,8 +579,8 @@ NixVectorRouting<T>::BuildNixVector(const std::vector<Ptr<Node>>& parentVector,
 
         // this function takes in the local net dev, and channel, and
         // writes to the netDeviceContainer the adjacent net devs
-        NetDeviceContainer netDeviceContainer;
-        GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
+        const NetDeviceContainer& netDeviceContainer =
+            GetCachedAdjacentNetDevices(localNetDevice, channel);
 
         // Finally we can get the adjacent nodes
         // and scan through them.  If we find the
@@ -446,6 +712,21 @@ NixVectorRouting<T>::GetAdjacentNetDevices(Ptr<NetDevice> netDevice,
     }
 }
 
+template <typename T>
+const NetDeviceContainer&
+NixVectorRouting<T>::GetCachedAdjacentNetDevices(Ptr<NetDevice> netDevice,
+                                                 Ptr<Channel> channel) const
+{
+    NS_LOG_FUNCTION(this << netDevice << channel);
+
+    auto [iter, inserted] = g_adjacentNetDevicesMap.try_emplace(netDevice);
+    if (inserted)
+    {
+        GetAdjacentNetDevices(netDevice, channel, iter->second);
+    }
+    return iter->second;
+}
+
 template <typename T>
 void
 NixVectorRouting<T>::BuildIpAddressToNodeMap() const
@@ -556,6 +837,60 @@ NixVectorRouting<T>::GetInterfaceByNetDevice(Ptr<NetDevice> netDevice) const
     return ipInterface;
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::GetNeighborNodes(Ptr<Node> node, std::vector<uint32_t>& neighbors) const
+{
+    NS_LOG_FUNCTION(this << node);
+
+    neighbors.clear();
+    Ptr<IpL3Protocol> ip = node->GetObject<IpL3Protocol>();
+    for (uint32_t i = 0; i < node->GetNDevices(); i++)
+    {
+        // Get a net device from the node
+        // as well as the channel, and figure
+        // out the adjacent net device
+        Ptr<NetDevice> localNetDevice = node->GetDevice(i);
+
+        // make sure that we can go this way
+        if (ip)
+        {
+            uint32_t interfaceIndex = (ip)->GetInterfaceForDevice(localNetDevice);
+            if (!(ip->IsUp(interfaceIndex)))
+            {
+                NS_LOG_LOGIC("IpInterface is down");
+                continue;
+            }
+        }
+        if (!(localNetDevice->IsLinkUp()))
+        {
+            NS_LOG_LOGIC("Link is down.");
+            continue;
+        }
+        Ptr<Channel> channel = localNetDevice->GetChannel();
+        if (!channel)
+        {
+            continue;
+        }
+
+        // this function takes in the local net dev, and channel, and
+        // writes to the netDeviceContainer the adjacent net devs
+        const NetDeviceContainer& netDeviceContainer =
+            GetCachedAdjacentNetDevices(localNetDevice, channel);
+
+        for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End(); iter++)
+        {
+            Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice(*iter);
+            if (!remoteIpInterface || !(remoteIpInterface->IsUp()))
+            {
+                NS_LOG_LOGIC("IpInterface either doesn't exist or is down");
+                continue;
+            }
+            neighbors.push_back((*iter)->GetNode()->GetId());
+        }
+    }
+}
+
 template <typename T>
 uint32_t
 NixVectorRouting<T>::FindTotalNeighbors(Ptr<Node> node) const
@@ -581,8 +916,8 @@ NixVectorRouting<T>::FindTotalNeighbors(Ptr<Node> node) const
 
         // this function takes in the local net dev, and channel, and
         // writes to the netDeviceContainer the adjacent net devs
-        NetDeviceContainer netDeviceContainer;
-        GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
+        const NetDeviceContainer& netDeviceContainer =
+            GetCachedAdjacentNetDevices(localNetDevice, channel);
 
         totalNeighbors += netDeviceContainer.GetN();
     }
@@ -661,8 +996,8 @@ NixVectorRouting<T>::FindNetDeviceForNixIndex(Ptr<Node> node,
 
         // this function takes in the local net dev, and channel, and
         // writes to the netDeviceContainer the adjacent net devs
-        NetDeviceContainer netDeviceContainer;
-        GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
+        const NetDeviceContainer& netDeviceContainer =
+            GetCachedAdjacentNetDevices(localNetDevice, channel);
 
         // check how many neighbors we have
         if (nodeIndex < (totalNeighbors + netDeviceContainer.GetN()))
@@ -738,7 +1073,7 @@ NixVectorRouting<T>::RouteOutput(Ptr<Packet> p,
     }
     // Check the Nix cache
     bool foundInCache = false;
-    nixVectorInCache = GetNixVectorInCache(destAddress, foundInCache);
+    nixVectorInCache = GetNixVectorInCache(m_node, destAddress, foundInCache);
 
     // not in cache
     if (!foundInCache)
@@ -746,11 +1081,12 @@ NixVectorRouting<T>::RouteOutput(Ptr<Packet> p,
         NS_LOG_LOGIC("Nix-vector not in cache, build: ");
         // Build the nix-vector, given this node and the
         // dest IP address
-        nixVectorInCache = GetNixVector(m_node, destAddress, oif);
+        std::vector<uint32_t> path;
+        nixVectorInCache = GetNixVector(m_node, destAddress, oif, &path);
         if (nixVectorInCache)
         {
             // cache it
-            m_nixCache.insert(typename NixMap_t::value_type(destAddress, nixVectorInCache));
+            InsertNixVectorInCache(m_node->GetId(), destAddress, nixVectorInCache, path);
         }
     }
 
@@ -788,7 +1124,7 @@ NixVectorRouting<T>::RouteOutput(Ptr<Packet> p,
             // rtentry from the map
             if (rtentry)
             {
-                m_ipRouteCache.erase(destAddress);
+                m_ipRouteCache.Erase(destAddress);
             }
 
             NS_LOG_LOGIC("IpRoute not in cache, build: ");
@@ -828,7 +1164,7 @@ NixVectorRouting<T>::RouteOutput(Ptr<Packet> p,
             sockerr = Socket::ERROR_NOTERROR;
 
             // add rtentry to cache
-            m_ipRouteCache.insert(typename IpRouteMap_t::value_type(destAddress, rtentry));
+            g_cacheStats.evictions += m_ipRouteCache.Insert(destAddress, rtentry);
         }
 
         NS_LOG_LOGIC("Nix-vector contents: " << *nixVectorInCache << " : Remaining bits: "
@@ -961,7 +1297,7 @@ NixVectorRouting<T>::RouteInput(Ptr<const Packet> p,
         rtentry->SetOutputDevice(m_ip->GetNetDevice(interfaceIndex));
 
         // add rtentry to cache
-        m_ipRouteCache.insert(typename IpRouteMap_t::value_type(destAddress, rtentry));
+        g_cacheStats.evictions += m_ipRouteCache.Insert(destAddress, rtentry);
     }
 
     NS_LOG_LOGIC("At Node " << m_node->GetId() << ", Extracting " << numberOfBits
@@ -1002,18 +1338,20 @@ NixVectorRouting<T>::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Un
         << ", Local time: " << m_node->GetLocalTime().As(unit) << ", Nix Routing" << std::endl;
 
     *os << "NixCache:" << std::endl;
-    if (m_nixCache.size() > 0)
+    auto first = g_nixCache.GetMap().lower_bound({m_node->GetId(), IpAddress::GetZero()});
+    if (first != g_nixCache.GetMap().end() && first->first.first == m_node->GetId())
     {
         *os << std::setw(30) << "Destination";
         *os << "NixVector" << std::endl;
-        for (auto it = m_nixCache.begin(); it != m_nixCache.end(); it++)
+        for (auto it = first; it != g_nixCache.GetMap().end() && it->first.first == m_node->GetId();
+             it++)
         {
             std::ostringstream dest;
-            dest << it->first;
+            dest << it->first.second;
             *os << std::setw(30) << dest.str();
-            if (it->second)
+            if (it->second.value.nixVector)
             {
-                *os << *(it->second) << std::endl;
+                *os << *(it->second.value.nixVector) << std::endl;
             }
             else
             {
@@ -1023,31 +1361,32 @@ NixVectorRouting<T>::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Un
     }
 
     *os << "IpRouteCache:" << std::endl;
-    if (m_ipRouteCache.size() > 0)
+    if (m_ipRouteCache.GetSize() > 0)
     {
         *os << std::setw(30) << "Destination";
         *os << std::setw(30) << "Gateway";
         *os << std::setw(30) << "Source";
         *os << "OutputDevice" << std::endl;
-        for (auto it = m_ipRouteCache.begin(); it != m_ipRouteCache.end(); it++)
+        for (auto it = m_ipRouteCache.GetMap().begin(); it != m_ipRouteCache.GetMap().end(); it++)
         {
+            Ptr<IpRoute> route = it->second.value;
             std::ostringstream dest;
             std::ostringstream gw;
             std::ostringstream src;
-            dest << it->second->GetDestination();
+            dest << route->GetDestination();
             *os << std::setw(30) << dest.str();
-            gw << it->second->GetGateway();
+            gw << route->GetGateway();
             *os << std::setw(30) << gw.str();
-            src << it->second->GetSource();
+            src << route->GetSource();
             *os << std::setw(30) << src.str();
             *os << "  ";
-            if (Names::FindName(it->second->GetOutputDevice()) != "")
+            if (Names::FindName(route->GetOutputDevice()) != "")
             {
-                *os << Names::FindName(it->second->GetOutputDevice());
+                *os << Names::FindName(route->GetOutputDevice());
             }
             else
             {
-                *os << it->second->GetOutputDevice()->GetIfIndex();
+                *os << route->GetOutputDevice()->GetIfIndex();
             }
             *os << std::endl;
         }
@@ -1062,28 +1401,28 @@ template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceUp(uint32_t i)
 {
-    g_isCacheDirty = true;
+    NotifyInterfaceChange(i);
 }
 
 template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceDown(uint32_t i)
 {
-    g_isCacheDirty = true;
+    NotifyInterfaceChange(i);
 }
 
 template <typename T>
 void
 NixVectorRouting<T>::NotifyAddAddress(uint32_t interface, IpInterfaceAddress address)
 {
-    g_isCacheDirty = true;
+    NotifyInterfaceChange(interface);
 }
 
 template <typename T>
 void
 NixVectorRouting<T>::NotifyRemoveAddress(uint32_t interface, IpInterfaceAddress address)
 {
-    g_isCacheDirty = true;
+    NotifyInterfaceChange(interface);
 }
 
 template <typename T>
@@ -1094,7 +1433,7 @@ NixVectorRouting<T>::NotifyAddRoute(IpAddress dst,
                                     uint32_t interface,
                                     IpAddress prefixToUse)
 {
-    g_isCacheDirty = true;
+    NotifyInterfaceChange(interface);
 }
 
 template <typename T>
@@ -1105,7 +1444,7 @@ NixVectorRouting<T>::NotifyRemoveRoute(IpAddress dst,
                                        uint32_t interface,
                                        IpAddress prefixToUse)
 {
-    g_isCacheDirty = true;
+    NotifyInterfaceChange(interface);
 }
 
 template <typename T>
@@ -1120,6 +1459,7 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
 
     NS_LOG_LOGIC("Going from Node " << source->GetId() << " to Node " << dest->GetId());
     std::queue<Ptr<Node>> greyNodeList; // discovered nodes with unexplored children
+    std::vector<uint32_t> neighbors;    // neighbors of the current node
 
     // reset the parent vector
     parentVector.assign(numberOfNodes, nullptr); // initialize to 0
@@ -1133,6 +1473,7 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
     {
         Ptr<Node> currNode = greyNodeList.front();
         Ptr<IpL3Protocol> ip = currNode->GetObject<IpL3Protocol>();
+        g_cacheStats.bfsVisits++;
 
         if (currNode == dest)
         {
@@ -1168,8 +1509,8 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
 
             // this function takes in the local net dev, and channel, and
             // writes to the netDeviceContainer the adjacent net devs
-            NetDeviceContainer netDeviceContainer;
-            GetAdjacentNetDevices(oif, channel, netDeviceContainer);
+            const NetDeviceContainer& netDeviceContainer =
+                GetCachedAdjacentNetDevices(oif, channel);
 
             // Finally we can get the adjacent nodes
             // and scan through them.  We push them
@@ -1200,63 +1541,17 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
         {
             // Iterate over the current node's adjacent vertices
             // and push them into the queue
-            for (uint32_t i = 0; i < (currNode->GetNDevices()); i++)
+            GetNeighborNodes(currNode, neighbors);
+            for (uint32_t remoteNodeId : neighbors)
             {
-                // Get a net device from the node
-                // as well as the channel, and figure
-                // out the adjacent net device
-                Ptr<NetDevice> localNetDevice = currNode->GetDevice(i);
-
-                // make sure that we can go this way
-                if (ip)
-                {
-                    uint32_t interfaceIndex = (ip)->GetInterfaceForDevice(currNode->GetDevice(i));
-                    if (!(ip->IsUp(interfaceIndex)))
-                    {
-                        NS_LOG_LOGIC("IpInterface is down");
-                        continue;
-                    }
-                }
-                if (!(localNetDevice->IsLinkUp()))
-                {
-                    NS_LOG_LOGIC("Link is down.");
-                    continue;
-                }
-                Ptr<Channel> channel = localNetDevice->GetChannel();
-                if (!channel)
+                // check to see if this node has been pushed before
+                // by checking to see if it has a parent
+                // if it doesn't (null or 0), then set its parent and
+                // push to the queue
+                if (!parentVector.at(remoteNodeId))
                 {
-                    continue;
-                }
-
-                // this function takes in the local net dev, and channel, and
-                // writes to the netDeviceContainer the adjacent net devs
-                NetDeviceContainer netDeviceContainer;
-                GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
-
-                // Finally we can get the adjacent nodes
-                // and scan through them.  We push them
-                // to the greyNode queue, if they aren't
-                // already there.
-                for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End();
-                     iter++)
-                {
-                    Ptr<Node> remoteNode = (*iter)->GetNode();
-                    Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice(*iter);
-                    if (!remoteIpInterface || !(remoteIpInterface->IsUp()))
-                    {
-                        NS_LOG_LOGIC("IpInterface either doesn't exist or is down");
-                        continue;
-                    }
-
-                    // check to see if this node has been pushed before
-                    // by checking to see if it has a parent
-                    // if it doesn't (null or 0), then set its parent and
-                    // push to the queue
-                    if (!parentVector.at(remoteNode->GetId()))
-                    {
-                        parentVector.at(remoteNode->GetId()) = currNode;
-                        greyNodeList.push(remoteNode);
-                    }
+                    parentVector.at(remoteNodeId) = currNode;
+                    greyNodeList.push(NodeList::GetNode(remoteNodeId));
                 }
             }
         }
@@ -1305,7 +1600,7 @@ NixVectorRouting<T>::PrintRoutingPath(Ptr<Node> source,
 
     // Check the Nix cache
     bool foundInCache = true;
-    nixVectorInCache = GetNixVectorInCache(dest, foundInCache);
+    nixVectorInCache = GetNixVectorInCache(source, dest, foundInCache);
 
     // not in cache
     if (!foundInCache)
@@ -1325,7 +1620,7 @@ NixVectorRouting<T>::PrintRoutingPath(Ptr<Node> source,
         {
             // Make a NixVector copy to work with. This is because
             // we don't want to extract the bits from nixVectorInCache
-            // which is stored in the m_nixCache.
+            // which is stored in the g_nixCache.
             nixVector = nixVectorInCache->Copy();
 
             *os << *nixVector;
@@ -1405,14 +1700,148 @@ NixVectorRouting<T>::PrintRoutingPath(Ptr<Node> source,
     (*os).copyfmt(oldState);
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::PrecomputeNixVectors(uint32_t nThreads) const
+{
+    NS_LOG_FUNCTION(this << nThreads);
+
+    CheckCacheStateAndFlush();
+    if (g_ipAddressToNodeMap.empty())
+    {
+        BuildIpAddressToNodeMap();
+    }
+
+    // Snapshot of the neighbors of the nodes, in the order the BFS visits
+    // them, which the threads read without touching any ns-3 object
+    uint32_t nNodes = NodeList::GetNNodes();
+    std::vector<uint32_t> neighborBegin(1, 0);
+    std::vector<uint32_t> neighbors;
+    std::vector<uint32_t> nodeNeighbors;
+    std::vector<uint32_t> sources;
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        Ptr<Node> node = NodeList::GetNode(i);
+        GetNeighborNodes(node, nodeNeighbors);
+        neighbors.insert(neighbors.end(), nodeNeighbors.begin(), nodeNeighbors.end());
+        neighborBegin.push_back(neighbors.size());
+        if (node->GetObject<NixVectorRouting>())
+        {
+            sources.push_back(i);
+        }
+    }
+
+    std::vector<std::vector<IpAddress>> addresses(nNodes);
+    for (const auto& [address, node] : g_ipAddressToNodeMap)
+    {
+        addresses[node->GetId()].push_back(address);
+    }
+    for (auto& nodeAddresses : addresses)
+    {
+        std::sort(nodeAddresses.begin(), nodeAddresses.end());
+    }
+
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    // The BFS of the sources run by batches, to bound the memory used by
+    // their parent vectors
+    const uint32_t unreachable = std::numeric_limits<uint32_t>::max();
+    const std::size_t batchSize = 64;
+    for (std::size_t first = 0; first < sources.size(); first += batchSize)
+    {
+        std::size_t last = std::min(sources.size(), first + batchSize);
+        std::vector<std::vector<uint32_t>> parents(last - first);
+        std::vector<uint64_t> visits(last - first, 0);
+        std::atomic<std::size_t> next{first};
+
+        auto work = [&]() {
+            std::queue<uint32_t> queue;
+            for (std::size_t i; (i = next++) < last;)
+            {
+                std::vector<uint32_t>& parent = parents[i - first];
+                parent.assign(nNodes, unreachable);
+                parent[sources[i]] = sources[i];
+                queue.push(sources[i]);
+                while (!queue.empty())
+                {
+                    uint32_t u = queue.front();
+                    queue.pop();
+                    visits[i - first]++;
+                    for (uint32_t j = neighborBegin[u]; j < neighborBegin[u + 1]; j++)
+                    {
+                        if (parent[neighbors[j]] == unreachable)
+                        {
+                            parent[neighbors[j]] = u;
+                            queue.push(neighbors[j]);
+                        }
+                    }
+                }
+            }
+        };
+
+        std::size_t nWorkers = std::min<std::size_t>(last - first, nThreads);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 1; t < nWorkers; t++)
+        {
+            threads.emplace_back(work);
+        }
+        work();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (std::size_t i = first; i < last; i++)
+        {
+            uint32_t source = sources[i];
+            const std::vector<uint32_t>& parent = parents[i - first];
+            g_cacheStats.bfsVisits += visits[i - first];
+
+            std::vector<Ptr<Node>> parentVector(nNodes);
+            for (uint32_t j = 0; j < nNodes; j++)
+            {
+                if (parent[j] != unreachable)
+                {
+                    parentVector[j] = NodeList::GetNode(parent[j]);
+                }
+            }
+
+            std::vector<uint32_t> path;
+            for (uint32_t dest = 0; dest < nNodes; dest++)
+            {
+                if (dest == source || parent[dest] == unreachable || addresses[dest].empty())
+                {
+                    continue;
+                }
+                Ptr<NixVector> nixVector = Create<NixVector>();
+                nixVector->SetEpoch(g_epoch);
+                BuildNixVector(parentVector, source, dest, nixVector);
+                path.assign(1, dest);
+                while (path.back() != source)
+                {
+                    path.push_back(parent[path.back()]);
+                }
+                std::reverse(path.begin(), path.end());
+                for (const auto& address : addresses[dest])
+                {
+                    InsertNixVectorInCache(source, address, nixVector, path);
+                }
+            }
+        }
+    }
+}
+
 template <typename T>
 void
 NixVectorRouting<T>::CheckCacheStateAndFlush() const
 {
     if (g_isCacheDirty)
     {
-        FlushGlobalNixRoutingCache();
         g_epoch++;
+        FlushChangedNixRoutingCache();
         g_isCacheDirty = false;
     }
 }
@@ -1432,5 +1861,15 @@ template void NixVectorRouting<Ipv6RoutingProtocol>::PrintRoutingPath(
     IpAddress dest,
     Ptr<OutputStreamWrapper> stream,
     Time::Unit unit) const;
+template void NixVectorRouting<Ipv4RoutingProtocol>::PrecomputeNixVectors(uint32_t nThreads) const;
+template void NixVectorRouting<Ipv6RoutingProtocol>::PrecomputeNixVectors(uint32_t nThreads) const;
+template void NixVectorRouting<Ipv4RoutingProtocol>::SetMaxCacheSize(uint32_t maxCacheSize);
+template void NixVectorRouting<Ipv6RoutingProtocol>::SetMaxCacheSize(uint32_t maxCacheSize);
+template uint32_t NixVectorRouting<Ipv4RoutingProtocol>::GetMaxCacheSize() const;
+template uint32_t NixVectorRouting<Ipv6RoutingProtocol>::GetMaxCacheSize() const;
+template NixVectorRouting<Ipv4RoutingProtocol>::CacheStats
+NixVectorRouting<Ipv4RoutingProtocol>::GetCacheStats();
+template NixVectorRouting<Ipv6RoutingProtocol>::CacheStats
+NixVectorRouting<Ipv6RoutingProtocol>::GetCacheStats();
 
 } // namespace ns3
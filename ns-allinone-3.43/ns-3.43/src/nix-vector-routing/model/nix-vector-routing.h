@@ -30,8 +30,11 @@
 #include "ns3/node-list.h"
 #include "ns3/nstime.h"
 
+#include <list>
 #include <map>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 // NOLINTBEGIN(modernize-use-override)
 
@@ -45,6 +48,149 @@ namespace ns3
  * intended for large network topologies.
  */
 
+/**
+ * \ingroup nix-vector-routing
+ * Map holding a bounded number of entries, which evicts its least recently
+ * used entries when it is full.
+ *
+ * The entries are kept in key order, as in a std::map, so that the caches
+ * of the routing protocol are printed in the same order whatever their
+ * bound.
+ *
+ * \tparam K \explicit the type of the keys
+ * \tparam V \explicit the type of the values
+ */
+template <typename K, typename V>
+class NixLruMap
+{
+  public:
+    /// Entry of the map
+    struct Entry
+    {
+        V value;                               //!< the value
+        typename std::list<K>::iterator usage; //!< position in the usage list
+    };
+
+    /// Map of keys to entries, in key order
+    typedef std::map<K, Entry> Map;
+
+    /**
+     * Set the maximum number of entries, and evict the least recently used
+     * entries beyond it.
+     * \param maxSize the maximum number of entries (0 for no limit)
+     * \return the number of evicted entries
+     */
+    uint32_t SetMaxSize(uint32_t maxSize)
+    {
+        m_maxSize = maxSize;
+        return Evict();
+    }
+
+    /**
+     * \return the maximum number of entries (0 for no limit)
+     */
+    uint32_t GetMaxSize() const
+    {
+        return m_maxSize;
+    }
+
+    /**
+     * Look up a key, and mark its entry as the most recently used one
+     * \param key the key
+     * \return a pointer to the value of the key, or nullptr if not found
+     */
+    const V* Find(const K& key)
+    {
+        auto it = m_map.find(key);
+        if (it == m_map.end())
+        {
+            return nullptr;
+        }
+        m_usage.splice(m_usage.begin(), m_usage, it->second.usage);
+        return &it->second.value;
+    }
+
+    /**
+     * Insert or replace the value of a key, mark its entry as the most
+     * recently used one, and evict the least recently used entries beyond
+     * the maximum number of entries
+     * \param key the key
+     * \param value the value
+     * \return the number of evicted entries
+     */
+    uint32_t Insert(const K& key, const V& value)
+    {
+        auto it = m_map.find(key);
+        if (it != m_map.end())
+        {
+            it->second.value = value;
+            m_usage.splice(m_usage.begin(), m_usage, it->second.usage);
+            return 0;
+        }
+        m_usage.push_front(key);
+        m_map.emplace(key, Entry{value, m_usage.begin()});
+        return Evict();
+    }
+
+    /**
+     * Remove the entry of a key, if any
+     * \param key the key
+     */
+    void Erase(const K& key)
+    {
+        auto it = m_map.find(key);
+        if (it != m_map.end())
+        {
+            m_usage.erase(it->second.usage);
+            m_map.erase(it);
+        }
+    }
+
+    /// Remove all the entries
+    void Clear()
+    {
+        m_map.clear();
+        m_usage.clear();
+    }
+
+    /**
+     * \return the number of entries
+     */
+    std::size_t GetSize() const
+    {
+        return m_map.size();
+    }
+
+    /**
+     * \return the entries, in key order
+     */
+    const Map& GetMap() const
+    {
+        return m_map;
+    }
+
+  private:
+    /**
+     * Evict the least recently used entries beyond the maximum number of entries
+     * \return the number of evicted entries
+     */
+    uint32_t Evict()
+    {
+        uint32_t evicted = 0;
+        while (m_maxSize > 0 && m_map.size() > m_maxSize)
+        {
+            m_map.erase(m_usage.back());
+            m_usage.pop_back();
+            evicted++;
+        }
+        return evicted;
+    }
+
+    Map m_map;             //!< entries, in key order
+    std::list<K> m_usage;  //!< keys, from the most recently used to the least recently used
+    uint32_t m_maxSize{0}; //!< maximum number of entries (0 for no limit)
+};
+
 /**
  * \ingroup nix-vector-routing
  * Nix-vector routing protocol
@@ -105,9 +251,12 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     void SetNode(Ptr<Node> node);
 
     /**
-     * @brief Called when run-time link topology change occurs
-     * which iterates through the node list and flushes any
-     * nix vector caches
+     * @brief Flushes all the nix-vectors and routes cached by all
+     * the nodes
+     *
+     * On run-time link topology changes, only the nix-vectors which
+     * can have changed are flushed, hence this method is only needed
+     * to flush the caches entirely.
      *
      * \internal
      * \c const is used here due to need to potentially flush the cache
@@ -131,13 +280,63 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
                           Ptr<OutputStreamWrapper> stream,
                           Time::Unit unit) const;
 
-  private:
     /**
-     * Flushes the cache which stores nix-vector based on
-     * destination IP
+     * @brief Compute and cache the nix-vectors from every node to every
+     * destination address
+     *
+     * The BFS of the source nodes run on several threads over a snapshot
+     * of the neighbors of the nodes, and the nix-vectors are built and
+     * cached afterwards.  This avoids running the BFS when the packets
+     * are sent, if the topology does not change.  The nix-vectors beyond
+     * the NixVectorCacheSize global value are evicted.
+     *
+     * \param nThreads the number of threads (0 for the number of hardware threads)
+     */
+    void PrecomputeNixVectors(uint32_t nThreads = 0) const;
+
+    /**
+     * @brief Set the maximum number of destinations whose route is cached
+     * by this node, evicting the least recently used ones beyond it
+     *
+     * \param maxCacheSize the maximum number of destinations (0 for no limit)
+     */
+    void SetMaxCacheSize(uint32_t maxCacheSize);
+
+    /**
+     * @brief Get the maximum number of destinations whose route is cached
+     * by this node
+     *
+     * \return the maximum number of destinations (0 for no limit)
+     */
+    uint32_t GetMaxCacheSize() const;
+
+    /**
+     * @brief Statistics of the nix-vector caches of all the nodes
+     */
+    struct CacheStats
+    {
+        uint64_t hits{0};        //!< Lookups of nix-vectors found in the caches
+        uint64_t misses{0};      //!< Lookups of nix-vectors not found in the caches
+        uint64_t evictions{0};   //!< Nix-vectors and routes evicted from the bounded caches
+        uint64_t flushes{0};     //!< Nix-vectors flushed by topology changes
+        uint64_t bfsVisits{0};   //!< Nodes visited by the BFS computing nix-vectors
+        uint64_t nixVectors{0};  //!< Nix-vectors currently cached
+        uint64_t routes{0};      //!< Routes currently cached
+        uint64_t memoryBytes{0}; //!< Approximate memory used by the cached nix-vectors
+    };
+
+    /**
+     * @brief Get the statistics of the nix-vector caches of all the nodes
+     *
+     * The counters are cumulative since the start of the program, while the
+     * number of cached entries and their memory are computed from the current
+     * caches.
+     *
+     * \return the statistics
      */
-    void FlushNixCache() const;
+    static CacheStats GetCacheStats();
 
+  private:
     /**
      * Flushes the cache which stores the Ip route
      * based on the destination IP
@@ -151,25 +350,60 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     void ResetTotalNeighbors();
 
+    /**
+     * Flushes the nix-vectors whose path crosses a node whose neighbors
+     * changed since the last flush, or may be longer than a path through
+     * such a node, and the routes cached by all the nodes
+     */
+    void FlushChangedNixRoutingCache() const;
+
+    /**
+     * Records a change of an interface, to flush the caches before they
+     * are used
+     * \param interface the index of the interface
+     */
+    void NotifyInterfaceChange(uint32_t interface);
+
     /**
      * Takes in the source node and dest IP and calls GetNodeByIp,
      * BFS, accounting for any output interface specified, and finally
      * BuildNixVector to return the built nix-vector
      *
-     * \param source Source node
-     * \param dest Destination node address
-     * \param oif Preferred output interface
+     * \param [in] source Source node
+     * \param [in] dest Destination node address
+     * \param [in] oif Preferred output interface
+     * \param [out] path if not null, the IDs of the nodes from the source to the destination
      * \returns The NixVector to be used in routing.
      */
-    Ptr<NixVector> GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevice> oif) const;
+    Ptr<NixVector> GetNixVector(Ptr<Node> source,
+                                IpAddress dest,
+                                Ptr<NetDevice> oif,
+                                std::vector<uint32_t>* path = nullptr) const;
 
     /**
-     * Checks the cache based on dest IP for the nix-vector
+     * Checks the cache based on source node and dest IP for the nix-vector
+     * \param source Source node
      * \param address Address to check
      * \param foundInCache Address found in cache
      * \returns The NixVector to be used in routing.
      */
-    Ptr<NixVector> GetNixVectorInCache(const IpAddress& address, bool& foundInCache) const;
+    Ptr<NixVector> GetNixVectorInCache(Ptr<Node> source,
+                                       const IpAddress& address,
+                                       bool& foundInCache) const;
+
+    /**
+     * Caches the nix-vector from a source node to a destination address,
+     * evicting the least recently used nix-vectors beyond the
+     * NixVectorCacheSize global value
+     * \param source Source node ID
+     * \param address Destination address
+     * \param nixVector the nix-vector
+     * \param path the IDs of the nodes from the source to the destination
+     */
+    void InsertNixVectorInCache(uint32_t source,
+                                const IpAddress& address,
+                                Ptr<NixVector> nixVector,
+                                const std::vector<uint32_t>& path) const;
 
     /**
      * Checks the cache based on dest IP for the IpRoute
@@ -189,6 +423,17 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
                                Ptr<Channel> channel,
                                NetDeviceContainer& netDeviceContainer) const;
 
+    /**
+     * Given a net-device returns all the adjacent net-devices, from the
+     * cache of adjacent net-devices shared by all the nodes.  The cache is
+     * filled by GetAdjacentNetDevices() and flushed with the nix-vector caches.
+     * \param [in] netDevice the NetDevice attached to the channel.
+     * \param [in] channel the channel to check
+     * \return the NetDeviceContainer of the NetDevices in the channel.
+     */
+    const NetDeviceContainer& GetCachedAdjacentNetDevices(Ptr<NetDevice> netDevice,
+                                                          Ptr<Channel> channel) const;
+
     /**
      * Iterates through the node list and finds the one
      * corresponding to the given IpAddress
@@ -218,6 +463,14 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
                         uint32_t dest,
                         Ptr<NixVector> nixVector) const;
 
+    /**
+     * Finds the nodes the BFS reaches in one hop from a node, through its
+     * interfaces and links that are up, in the order the BFS visits them
+     * \param [in] node node pointer
+     * \param [out] neighbors the IDs of the neighbor nodes
+     */
+    void GetNeighborNodes(Ptr<Node> node, std::vector<uint32_t>& neighbors) const;
+
     /**
      * Simply iterates through the nodes net-devices and determines
      * how many neighbors the node has.
@@ -272,10 +525,17 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     void DoDispose();
 
-    /// Map of IpAddress to NixVector
-    typedef std::map<IpAddress, Ptr<NixVector>> NixMap_t;
-    /// Map of IpAddress to IpRoute
-    typedef std::map<IpAddress, Ptr<IpRoute>> IpRouteMap_t;
+    /// Nix-vector cached for a source node and a destination address
+    struct NixCacheEntry
+    {
+        Ptr<NixVector> nixVector;   //!< the nix-vector
+        std::vector<uint32_t> path; //!< IDs of the nodes from the source to the destination
+    };
+
+    /// Bounded map of source node ID and destination IpAddress to NixVector
+    typedef NixLruMap<std::pair<uint32_t, IpAddress>, NixCacheEntry> NixMap_t;
+    /// Bounded map of IpAddress to IpRoute
+    typedef NixLruMap<IpAddress, Ptr<IpRoute>> IpRouteMap_t;
 
     /// Callback for IPv4 unicast packets to be forwarded
     typedef Callback<void, Ptr<IpRoute>, Ptr<const Packet>, const IpHeader&>
@@ -480,8 +740,11 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     static uint32_t g_epoch;
 
-    /** Cache stores nix-vectors based on destination ip */
-    mutable NixMap_t m_nixCache;
+    /** Cache stores nix-vectors based on source node and destination ip */
+    static NixMap_t g_nixCache;
+
+    /** Net devices whose interface changed since the last flush */
+    static std::vector<Ptr<NetDevice>> g_changedDevices;
 
     /** Cache stores IpRoutes based on destination ip */
     mutable IpRouteMap_t m_ipRouteCache;
@@ -506,6 +769,13 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     typedef std::unordered_map<Ptr<NetDevice>, Ptr<IpInterface>> NetDeviceToIpInterfaceMap;
     static NetDeviceToIpInterfaceMap
         g_netdeviceToIpInterfaceMap; //!< NetDevice pointer to IpInterface pointer map
+
+    /// Mapping of Ptr<NetDevice> to its adjacent net-devices.
+    typedef std::unordered_map<Ptr<NetDevice>, NetDeviceContainer> NetDeviceToAdjacentMap;
+    static NetDeviceToAdjacentMap
+        g_adjacentNetDevicesMap; //!< NetDevice pointer to adjacent NetDevices map
+
+    static CacheStats g_cacheStats; //!< Cumulative statistics of the caches
 };
 
 /**
@@ -6,6 +6,7 @@
  * Author: Ameya Deshpande <ameyanrd@outlook.com>
  */
 
+#include "ns3/config.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
@@ -14,6 +15,8 @@
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
+#include "ns3/output-stream-wrapper.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
@@ -21,6 +24,9 @@
 #include "ns3/test.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <sstream>
 
 using namespace ns3;
 
@@ -382,6 +388,326 @@ NixVectorRoutingTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * The topology is of the form:
+ * \verbatim
+    nSrc -- nA -- nB -- nC
+   \endverbatim
+ *
+ * Following are the tests in this test case:
+ * - Test the eviction order of NixLruMap.
+ * - Limit the nix-vector cache to one nix-vector, and the route cache of
+ *   nSrc to one destination.
+ * - Send packets from nSrc to nB, nC and nB again.
+ * - Test that the packets are received, and that each destination evicts
+ *   the nix-vector and the route of the previous one.
+ *
+ * \brief IPv4 Nix-Vector Routing bounded cache Test
+ */
+class NixVectorRoutingCacheTest : public TestCase
+{
+    uint32_t m_receivedPackets{0}; //!< Number of received packets
+
+    /**
+     * \brief Send data immediately after being called.
+     * \param socket The sending socket.
+     * \param to IPv4 Destination address.
+     */
+    void DoSendData(Ptr<Socket> socket, Ipv4Address to);
+
+    void DoRun() override;
+
+  public:
+    /**
+     * \brief Receive data.
+     * \param socket The receiving socket.
+     */
+    void ReceivePkt(Ptr<Socket> socket);
+
+    NixVectorRoutingCacheTest();
+};
+
+NixVectorRoutingCacheTest::NixVectorRoutingCacheTest()
+    : TestCase("bounded nix-vector cache test")
+{
+}
+
+void
+NixVectorRoutingCacheTest::ReceivePkt(Ptr<Socket> socket)
+{
+    while (socket->Recv())
+    {
+        m_receivedPackets++;
+    }
+}
+
+void
+NixVectorRoutingCacheTest::DoSendData(Ptr<Socket> socket, Ipv4Address to)
+{
+    socket->SendTo(Create<Packet>(123), 0, InetSocketAddress(to, 1234));
+}
+
+void
+NixVectorRoutingCacheTest::DoRun()
+{
+    NixLruMap<uint32_t, uint32_t> lru;
+    lru.SetMaxSize(2);
+    NS_TEST_EXPECT_MSG_EQ(lru.Insert(1, 10), 0, "No eviction below the maximum size");
+    NS_TEST_EXPECT_MSG_EQ(lru.Insert(2, 20), 0, "No eviction below the maximum size");
+    NS_TEST_EXPECT_MSG_EQ(*lru.Find(1), 10, "Wrong value");
+    NS_TEST_EXPECT_MSG_EQ(lru.Insert(3, 30), 1, "One entry should have been evicted");
+    NS_TEST_EXPECT_MSG_EQ(lru.Find(2), nullptr, "The least recently used entry is evicted");
+    NS_TEST_EXPECT_MSG_EQ(*lru.Find(1), 10, "The recently used entry is kept");
+    NS_TEST_EXPECT_MSG_EQ(lru.SetMaxSize(1), 1, "One entry should have been evicted");
+    NS_TEST_EXPECT_MSG_EQ(lru.Find(3), nullptr, "The least recently used entry is evicted");
+    NS_TEST_EXPECT_MSG_EQ(lru.GetSize(), 1, "Wrong number of entries");
+
+    NodeContainer nodes;
+    nodes.Create(4);
+
+    Ipv4NixVectorHelper nixRouting;
+    InternetStackHelper stack;
+    stack.SetRoutingHelper(nixRouting);
+    stack.SetIpv6StackInstall(false);
+    stack.Install(nodes);
+
+    SimpleNetDeviceHelper devHelper;
+    devHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces;
+    for (uint32_t i = 0; i + 1 < nodes.GetN(); i++)
+    {
+        NodeContainer link(nodes.Get(i), nodes.Get(i + 1));
+        interfaces.Add(address.Assign(devHelper.Install(link)));
+        address.NewNetwork();
+    }
+    Ipv4Address addrB = interfaces.GetAddress(3);
+    Ipv4Address addrC = interfaces.GetAddress(5);
+
+    for (uint32_t i = 2; i < nodes.GetN(); i++)
+    {
+        Ptr<Socket> rxSocket = nodes.Get(i)->GetObject<UdpSocketFactory>()->CreateSocket();
+        NS_TEST_EXPECT_MSG_EQ(rxSocket->Bind(InetSocketAddress(Ipv4Address::GetAny(), 1234)),
+                              0,
+                              "trivial");
+        rxSocket->SetRecvCallback(MakeCallback(&NixVectorRoutingCacheTest::ReceivePkt, this));
+    }
+
+    Ptr<Node> nSrc = nodes.Get(0);
+    Ptr<Ipv4NixVectorRouting> nix =
+        DynamicCast<Ipv4NixVectorRouting>(nSrc->GetObject<Ipv4>()->GetRoutingProtocol());
+    NS_TEST_ASSERT_MSG_NE(nix, nullptr, "Nix-vector routing not installed");
+    nix->SetAttribute("MaxCacheSize", UintegerValue(1));
+    Config::SetGlobal("NixVectorCacheSize", UintegerValue(1));
+
+    Ptr<Socket> txSocket = nSrc->GetObject<UdpSocketFactory>()->CreateSocket();
+    Ipv4NixVectorRouting::CacheStats before = Ipv4NixVectorRouting::GetCacheStats();
+    Simulator::ScheduleWithContext(nSrc->GetId(),
+                                   Seconds(1),
+                                   &NixVectorRoutingCacheTest::DoSendData,
+                                   this,
+                                   txSocket,
+                                   addrB);
+    Simulator::ScheduleWithContext(nSrc->GetId(),
+                                   Seconds(2),
+                                   &NixVectorRoutingCacheTest::DoSendData,
+                                   this,
+                                   txSocket,
+                                   addrC);
+    Simulator::ScheduleWithContext(nSrc->GetId(),
+                                   Seconds(3),
+                                   &NixVectorRoutingCacheTest::DoSendData,
+                                   this,
+                                   txSocket,
+                                   addrB);
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    Ipv4NixVectorRouting::CacheStats after = Ipv4NixVectorRouting::GetCacheStats();
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPackets, 3, "All the packets should have been received.");
+    NS_TEST_EXPECT_MSG_EQ(after.misses - before.misses, 3, "Evicted nix-vectors are rebuilt.");
+    NS_TEST_EXPECT_MSG_EQ(after.hits - before.hits, 0, "Evicted nix-vectors are not found.");
+    NS_TEST_EXPECT_MSG_EQ(after.evictions - before.evictions,
+                          4,
+                          "Each destination evicts the nix-vector and route of the previous one.");
+    NS_TEST_EXPECT_MSG_GT(after.bfsVisits, before.bfsVisits, "The BFS should have run.");
+    NS_TEST_EXPECT_MSG_EQ(after.nixVectors, 1, "Only nSrc caches one nix-vector.");
+    NS_TEST_EXPECT_MSG_GT(after.memoryBytes, 0, "The cached nix-vector uses memory.");
+
+    Config::SetGlobal("NixVectorCacheSize", UintegerValue(0));
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * The topology is of the form:
+ * \verbatim
+    n4    n2 -- n3
+     |   /       |
+    n1 -- n0     |
+           |     |
+          n5 -- n6
+   \endverbatim
+ *
+ * The link between n6 and n3 is down at first.
+ *
+ * Following are the tests in this test case:
+ * - Precompute the nix-vectors of all the nodes, and test that sending
+ *   packets only hits the cache.
+ * - Set the interface of n4 down, and test that only the nix-vectors whose
+ *   path crosses n1 are flushed.
+ * - Set the link between n6 and n3 up, and test that the nix-vector from n5
+ *   to n3, whose path crosses neither n6 nor n3, is flushed for the shorter
+ *   path through n6.
+ *
+ * \brief IPv4 Nix-Vector Routing cache flush and precomputation Test
+ */
+class NixVectorRoutingFlushTest : public TestCase
+{
+    uint32_t m_receivedPackets{0}; //!< Number of received packets
+
+    /**
+     * \brief Send data immediately after being called.
+     * \param socket The sending socket.
+     * \param to IPv4 Destination address.
+     */
+    void DoSendData(Ptr<Socket> socket, Ipv4Address to);
+
+    void DoRun() override;
+
+  public:
+    /**
+     * \brief Receive data.
+     * \param socket The receiving socket.
+     */
+    void ReceivePkt(Ptr<Socket> socket);
+
+    NixVectorRoutingFlushTest();
+};
+
+NixVectorRoutingFlushTest::NixVectorRoutingFlushTest()
+    : TestCase("nix-vector cache flush and precomputation test")
+{
+}
+
+void
+NixVectorRoutingFlushTest::ReceivePkt(Ptr<Socket> socket)
+{
+    while (socket->Recv())
+    {
+        m_receivedPackets++;
+    }
+}
+
+void
+NixVectorRoutingFlushTest::DoSendData(Ptr<Socket> socket, Ipv4Address to)
+{
+    socket->SendTo(Create<Packet>(123), 0, InetSocketAddress(to, 1234));
+}
+
+void
+NixVectorRoutingFlushTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(7);
+
+    Ipv4NixVectorHelper nixRouting;
+    InternetStackHelper stack;
+    stack.SetRoutingHelper(nixRouting);
+    stack.SetIpv6StackInstall(false);
+    stack.Install(nodes);
+
+    SimpleNetDeviceHelper devHelper;
+    devHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.0.0", "255.255.255.0");
+    std::vector<std::pair<uint32_t, uint32_t>> links = {{0, 1},
+                                                        {1, 2},
+                                                        {2, 3},
+                                                        {1, 4},
+                                                        {0, 5},
+                                                        {5, 6},
+                                                        {6, 3}};
+    std::vector<Ipv4InterfaceContainer> interfaces;
+    for (const auto& [a, b] : links)
+    {
+        NodeContainer link(nodes.Get(a), nodes.Get(b));
+        interfaces.push_back(address.Assign(devHelper.Install(link)));
+        address.NewNetwork();
+    }
+    Ipv4Address addr3 = interfaces[2].GetAddress(1);
+    Ipv4Address addr6 = interfaces[5].GetAddress(1);
+    Ptr<Ipv4> ip4 = nodes.Get(4)->GetObject<Ipv4>();
+    Ptr<Ipv4> ip6 = nodes.Get(6)->GetObject<Ipv4>();
+    ip6->SetDown(2);
+
+    for (uint32_t i : {3, 6})
+    {
+        Ptr<Socket> rxSocket = nodes.Get(i)->GetObject<UdpSocketFactory>()->CreateSocket();
+        NS_TEST_EXPECT_MSG_EQ(rxSocket->Bind(InetSocketAddress(Ipv4Address::GetAny(), 1234)),
+                              0,
+                              "trivial");
+        rxSocket->SetRecvCallback(MakeCallback(&NixVectorRoutingFlushTest::ReceivePkt, this));
+    }
+    Ptr<Socket> txSocket0 = nodes.Get(0)->GetObject<UdpSocketFactory>()->CreateSocket();
+    Ptr<Socket> txSocket5 = nodes.Get(5)->GetObject<UdpSocketFactory>()->CreateSocket();
+
+    Ptr<Ipv4NixVectorRouting> nix =
+        DynamicCast<Ipv4NixVectorRouting>(nodes.Get(5)->GetObject<Ipv4>()->GetRoutingProtocol());
+    NS_TEST_ASSERT_MSG_NE(nix, nullptr, "Nix-vector routing not installed");
+
+    // Each of the 7 nodes reaches the 14 addresses, except its own addresses
+    nix->PrecomputeNixVectors(2);
+    Ipv4NixVectorRouting::CacheStats before = Ipv4NixVectorRouting::GetCacheStats();
+    NS_TEST_EXPECT_MSG_EQ(before.nixVectors, 7 * 14 - 14, "All the pairs should be cached.");
+
+    Simulator::Schedule(Seconds(1), &NixVectorRoutingFlushTest::DoSendData, this, txSocket0, addr3);
+    Simulator::Schedule(Seconds(1), &NixVectorRoutingFlushTest::DoSendData, this, txSocket5, addr6);
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+
+    Ipv4NixVectorRouting::CacheStats after = Ipv4NixVectorRouting::GetCacheStats();
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPackets, 2, "All the packets should have been received.");
+    NS_TEST_EXPECT_MSG_GT(after.hits, before.hits, "The precomputed nix-vectors are used.");
+    NS_TEST_EXPECT_MSG_EQ(after.misses, before.misses, "All the nix-vectors are precomputed.");
+    NS_TEST_EXPECT_MSG_EQ(after.bfsVisits, before.bfsVisits, "The BFS should not have run.");
+
+    // The paths from n0 to n3, from n5 to n3 and from n5 to n6 do not cross
+    // n4, but the former two cross n1, whose neighbors changed
+    ip4->SetDown(1);
+    before = after;
+    Simulator::Schedule(Seconds(1), &NixVectorRoutingFlushTest::DoSendData, this, txSocket0, addr3);
+    Simulator::Schedule(Seconds(1), &NixVectorRoutingFlushTest::DoSendData, this, txSocket5, addr3);
+    Simulator::Schedule(Seconds(1), &NixVectorRoutingFlushTest::DoSendData, this, txSocket5, addr6);
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+
+    after = Ipv4NixVectorRouting::GetCacheStats();
+    NS_TEST_EXPECT_MSG_EQ(m_receivedPackets, 5, "All the packets should have been received.");
+    NS_TEST_EXPECT_MSG_GT(after.flushes, before.flushes, "Some nix-vectors are flushed.");
+    // The 31 nix-vectors from n0, n5 and n6 to n0, n1, n5 and n6, and from
+    // n2 and n3 to n1, n2 and n3 are kept, and the two to n3 are rebuilt
+    NS_TEST_EXPECT_MSG_EQ(after.nixVectors, 33, "Only the paths crossing n1 are flushed.");
+    NS_TEST_EXPECT_MSG_EQ(after.misses - before.misses, 2, "Only the paths to n3 are rebuilt.");
+
+    // The path from n5 to n3 does not cross n6 or n3, but is longer than the
+    // path through the new link
+    ip6->SetUp(2);
+    std::ostringstream oss;
+    nix->PrintRoutingPath(nodes.Get(5), addr3, Create<OutputStreamWrapper>(&oss), Time::S);
+    std::string path = oss.str();
+    NS_TEST_EXPECT_MSG_NE(path.find("(Node 6)"), std::string::npos, "Wrong path " << path);
+    NS_TEST_EXPECT_MSG_EQ(path.find("(Node 0)"), std::string::npos, "Wrong path " << path);
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup nix-vector-routing-test
  * \ingroup tests
@@ -395,6 +721,8 @@ class NixVectorRoutingTestSuite : public TestSuite
         : TestSuite("nix-vector-routing", Type::UNIT)
     {
         AddTestCase(new NixVectorRoutingTest(), TestCase::Duration::QUICK);
+        AddTestCase(new NixVectorRoutingCacheTest(), TestCase::Duration::QUICK);
+        AddTestCase(new NixVectorRoutingFlushTest(), TestCase::Duration::QUICK);
     }
 };
 
@@ -75,7 +75,7 @@ PointToPointHelper::EnablePcapInternal(std::string prefix,
         return;
     }
 
-    PcapHelper pcapHelper;
+    PcapHelper pcapHelper = GetPcapHelper();
 
     std::string filename;
     if (explicitFilename)
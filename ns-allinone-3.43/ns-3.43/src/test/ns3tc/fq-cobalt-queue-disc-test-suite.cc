@@ -137,16 +137,12 @@ FqCobaltQueueDiscNoSuitableFilter::DoRun()
     Address dest;
     item = Create<Ipv6QueueDiscItem>(p, dest, 0, ipv6Header);
     queueDisc->Enqueue(item);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(),
-                          0,
-                          "no flow queue should have been created");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNFlows(), 0, "no flow queue should have been created");
 
     p = Create<Packet>(reinterpret_cast<const uint8_t*>("hello, world"), 12);
     item = Create<Ipv6QueueDiscItem>(p, dest, 0, ipv6Header);
     queueDisc->Enqueue(item);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(),
-                          0,
-                          "no flow queue should have been created");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNFlows(), 0, "no flow queue should have been created");
 
     Simulator::Destroy();
 }
@@ -214,7 +210,7 @@ FqCobaltQueueDiscIPFlowsSeparationAndPacketLimit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the flow queue");
 
@@ -225,10 +221,10 @@ FqCobaltQueueDiscIPFlowsSeparationAndPacketLimit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the flow queue");
     // Add the second packet that causes two packets to be dropped from the fat flow (max backlog =
@@ -237,10 +233,10 @@ FqCobaltQueueDiscIPFlowsSeparationAndPacketLimit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           2,
                           "unexpected number of packets in the flow queue");
 
@@ -305,10 +301,10 @@ FqCobaltQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           1,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow queue");
-    Ptr<FqCobaltFlow> flow1 = StaticCast<FqCobaltFlow>(queueDisc->GetQueueDiscClass(0));
+    const FqCobaltFlow* flow1 = queueDisc->GetFlow(0);
     NS_TEST_ASSERT_MSG_EQ(flow1->GetDeficit(),
                           static_cast<int32_t>(queueDisc->GetQuantum()),
                           "the deficit of the first flow must equal the quantum");
@@ -320,7 +316,7 @@ FqCobaltQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           0,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           0,
                           "unexpected number of packets in the first flow queue");
     // the deficit for the first flow becomes 90 - (100+20) = -30
@@ -332,7 +328,7 @@ FqCobaltQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           2,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue");
     NS_TEST_ASSERT_MSG_EQ(flow1->GetStatus(),
@@ -346,13 +342,13 @@ FqCobaltQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           2,
                           "unexpected number of packets in the second flow queue");
-    Ptr<FqCobaltFlow> flow2 = StaticCast<FqCobaltFlow>(queueDisc->GetQueueDiscClass(1));
+    const FqCobaltFlow* flow2 = queueDisc->GetFlow(1);
     NS_TEST_ASSERT_MSG_EQ(flow2->GetDeficit(),
                           static_cast<int32_t>(queueDisc->GetQuantum()),
                           "the deficit of the second flow must equal the quantum");
@@ -365,10 +361,10 @@ FqCobaltQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
     // the first flow got a quantum of deficit (-30+90=60) and has been moved to the end of the list
@@ -388,10 +384,10 @@ FqCobaltQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           2,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
     // the first flow has a negative deficit (60-(100+20)= -60) and stays in the list of old queues
@@ -411,10 +407,10 @@ FqCobaltQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           1,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           0,
                           "unexpected number of packets in the second flow queue");
     // the first flow got a quantum of deficit (-60+90=30) and has been moved to the end of the list
@@ -434,10 +430,10 @@ FqCobaltQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           0,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           0,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           0,
                           "unexpected number of packets in the second flow queue");
     // the first flow has a negative deficit (30-(100+20)= -90)
@@ -542,7 +538,7 @@ FqCobaltQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
 
@@ -552,10 +548,10 @@ FqCobaltQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
 
@@ -565,13 +561,13 @@ FqCobaltQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           5,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
 
@@ -582,16 +578,16 @@ FqCobaltQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           7,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(3)->GetNPackets(),
                           2,
                           "unexpected number of packets in the third flow queue");
 
@@ -667,7 +663,7 @@ FqCobaltQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
 
@@ -677,10 +673,10 @@ FqCobaltQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
 
@@ -690,13 +686,13 @@ FqCobaltQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           5,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
 
@@ -707,16 +703,16 @@ FqCobaltQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           7,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(3)->GetNPackets(),
                           2,
                           "unexpected number of packets in the third flow queue");
 
@@ -810,9 +806,7 @@ FqCobaltQueueDiscEcnMarking::AddPacket(Ptr<FqCobaltQueueDisc> queue,
         Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem>(p, dest, 0, hdr);
         queue->Enqueue(item);
     }
-    NS_TEST_EXPECT_MSG_EQ(queue->GetNQueueDiscClasses(),
-                          nQueueFlows,
-                          "unexpected number of flow queues");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNFlows(), nQueueFlows, "unexpected number of flow queues");
     NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(),
                           nPktEnqueued,
                           "unexpected number of enqueued packets");
@@ -821,14 +815,13 @@ FqCobaltQueueDiscEcnMarking::AddPacket(Ptr<FqCobaltQueueDisc> queue,
 void
 FqCobaltQueueDiscEcnMarking::Dequeue(Ptr<FqCobaltQueueDisc> queue, uint32_t nPkt)
 {
-    Ptr<CobaltQueueDisc> q3 =
-        queue->GetQueueDiscClass(3)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
+    const FqCobaltFlow* q3 = queue->GetFlow(3);
 
     // Trace DropNext after the first dequeue as m_dropNext value is set after the first dequeue
     if (q3->GetNPackets() == 19)
     {
-        q3->TraceConnectWithoutContext(
-            "DropNext",
+        queue->TraceConnectFlowDropNext(
+            3,
             MakeCallback(&FqCobaltQueueDiscEcnMarking::DropNextTracer, this));
     }
 
@@ -947,19 +940,14 @@ FqCobaltQueueDiscEcnMarking::DoRun()
     DequeueWithDelay(queueDisc, 0.11, 60);
     Simulator::Run();
     Simulator::Stop(Seconds(8.0));
-    Ptr<CobaltQueueDisc> q0 =
-        queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    Ptr<CobaltQueueDisc> q1 =
-        queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    Ptr<CobaltQueueDisc> q2 =
-        queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    Ptr<CobaltQueueDisc> q3 =
-        queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    Ptr<CobaltQueueDisc> q4 =
-        queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
+    const FqCobaltFlow* q0 = queueDisc->GetFlow(0);
+    const FqCobaltFlow* q1 = queueDisc->GetFlow(1);
+    const FqCobaltFlow* q2 = queueDisc->GetFlow(2);
+    const FqCobaltFlow* q3 = queueDisc->GetFlow(3);
+    const FqCobaltFlow* q4 = queueDisc->GetFlow(4);
 
     // As packets in flow queues are ECN capable
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
                           19,
                           "There should be 19 marked packets."
                           "As there is no CoDel minBytes parameter so all the packets apart from "
@@ -967,41 +955,41 @@ FqCobaltQueueDiscEcnMarking::DoRun()
                           "NotEct packets and the queue delay is much higher than 5ms so the queue "
                           "gets empty pretty quickly so more"
                           "packets from q0 can be dequeued.");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
                           16,
                           "There should be 16 marked packets"
                           "As there is no CoDel minBytes parameter so all the packets apart from "
                           "the first one until no more packets are dequeued"
                           "are marked.");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q2->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q2->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
                           12,
                           "There should be 12 marked packets"
                           "Each packet size is 120 bytes and the quantum is 1500 bytes so in the "
                           "first turn (1514/120 = 12.61) 13 packets are"
                           "dequeued and apart from the first one, all the packets are marked.");
-    NS_TEST_EXPECT_MSG_EQ(q2->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q2->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
 
     // As packets in flow queues are not ECN capable
-    NS_TEST_EXPECT_MSG_EQ(q3->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q3->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           m_dropNextCount,
                           "The number of drops should"
                           "be equal to the number of times m_dropNext is updated");
-    NS_TEST_EXPECT_MSG_EQ(q3->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q3->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
                           0,
                           "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q4->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           m_dropNextCount,
                           "The number of drops should"
                           "be equal to the number of times m_dropNext is updated");
-    NS_TEST_EXPECT_MSG_EQ(q4->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
                           0,
                           "There should not be any marked packets");
 
@@ -1079,57 +1067,55 @@ FqCobaltQueueDiscEcnMarking::DoRun()
     DequeueWithDelay(queueDisc, 0.0001, 60);
     Simulator::Run();
     Simulator::Stop(Seconds(8.0));
-    q0 = queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    q1 = queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    q2 = queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    q3 = queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    q4 = queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
+    q0 = queueDisc->GetFlow(0);
+    q1 = queueDisc->GetFlow(1);
+    q2 = queueDisc->GetFlow(2);
+    q3 = queueDisc->GetFlow(3);
+    q4 = queueDisc->GetFlow(4);
 
     // As packets in flow queues are ECN capable
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q0->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q0->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         0,
         "There should not be any marked packets"
         "with quantum of 1514, 13 packets of size 120 bytes can be dequeued. sojourn time of 13th "
         "packet is 1.3ms which is"
         "less than CE threshold");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q1->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q1->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         6,
         "There should be 6 marked packets"
         "with quantum of 1514, 13 packets of size 120 bytes can be dequeued. sojourn time of 8th "
         "packet is 2.1ms which is greater"
         "than CE threshold and subsequent packet also have sojourn time more 8th packet hence "
         "remaining packet are marked.");
-    NS_TEST_EXPECT_MSG_EQ(q2->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q2->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q2->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q2->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         13,
         "There should be 13 marked packets"
         "with quantum of 1514, 13 packets of size 120 bytes can be dequeued and all of them have "
         "sojourn time more than CE threshold");
 
     // As packets in flow queues are not ECN capable
-    NS_TEST_EXPECT_MSG_EQ(
-        q3->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
-        0,
-        "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q3->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q3->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+                          0,
+                          "There should not be any marked packets");
+    NS_TEST_EXPECT_MSG_EQ(q3->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(
-        q4->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
-        0,
-        "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q4->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+                          0,
+                          "There should not be any marked packets");
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           1,
                           "There should 1 dropped packet. As the queue"
                           "delay for the first dequeue is greater than the target (5ms), Cobalt "
@@ -1217,58 +1203,56 @@ FqCobaltQueueDiscEcnMarking::DoRun()
     DequeueWithDelay(queueDisc, 0.110, 60);
     Simulator::Run();
     Simulator::Stop(Seconds(8.0));
-    q0 = queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    q1 = queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    q2 = queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    q3 = queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    q4 = queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
+    q0 = queueDisc->GetFlow(0);
+    q1 = queueDisc->GetFlow(1);
+    q2 = queueDisc->GetFlow(2);
+    q3 = queueDisc->GetFlow(3);
+    q4 = queueDisc->GetFlow(4);
 
     // As packets in flow queues are ECN capable
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q0->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
-            q0->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+        q0->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
+            q0->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
         20 - q0->GetNPackets(),
         "Number of CE threshold"
         " exceeded marks plus Number of Target exceeded marks should be equal to total number of "
         "packets dequeued");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q1->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
-            q1->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+        q1->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
+            q1->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
         20 - q1->GetNPackets(),
         "Number of CE threshold"
         " exceeded marks plus Number of Target exceeded marks should be equal to total number of "
         "packets dequeued");
-    NS_TEST_EXPECT_MSG_EQ(q2->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q2->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q2->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
-            q2->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+        q2->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
+            q2->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
         20 - q2->GetNPackets(),
         "Number of CE threshold"
         " exceeded marks plus Number of Target exceeded marks should be equal to total number of "
         "packets dequeued");
 
     // As packets in flow queues are not ECN capable
-    NS_TEST_EXPECT_MSG_EQ(
-        q3->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
-        0,
-        "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q3->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q3->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+                          0,
+                          "There should not be any marked packets");
+    NS_TEST_EXPECT_MSG_EQ(q3->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           m_dropNextCount,
                           "The number of drops should"
                           "be equal to the number of times m_dropNext is updated");
-    NS_TEST_EXPECT_MSG_EQ(
-        q4->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
-        0,
-        "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q4->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+                          0,
+                          "There should not be any marked packets");
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           m_dropNextCount,
                           "The number of drops should"
                           "be equal to the number of times m_dropNext is updated");
@@ -1376,38 +1360,38 @@ FqCobaltQueueDiscSetLinearProbing::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           11,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           2,
                           "unexpected number of packets in the second flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(3)->GetNPackets(),
                           1,
                           "unexpected number of packets in the fourth flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(4)->GetNPackets(),
                           2,
                           "unexpected number of packets in the fifth flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(5)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(5)->GetNPackets(),
                           1,
                           "unexpected number of packets in the sixth flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(6)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(6)->GetNPackets(),
                           1,
                           "unexpected number of packets in the seventh flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(7)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(7)->GetNPackets(),
                           1,
                           "unexpected number of packets in the eighth flow queue of set one");
     g_hash = 1025;
     AddPacket(queueDisc, hdr);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow of set one");
     g_hash = 10;
     AddPacket(queueDisc, hdr);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(8)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(8)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow of set two");
     Simulator::Destroy();
@@ -1587,13 +1571,11 @@ FqCobaltQueueDiscL4sMode::DoRun()
     DequeueWithDelay(queueDisc, delay, 140);
     Simulator::Run();
     Simulator::Stop(Seconds(8.0));
-    Ptr<CobaltQueueDisc> q0 =
-        queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    Ptr<CobaltQueueDisc> q1 =
-        queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
+    const FqCobaltFlow* q0 = queueDisc->GetFlow(0);
+    const FqCobaltFlow* q1 = queueDisc->GetFlow(1);
 
     NS_TEST_EXPECT_MSG_EQ(
-        q0->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q0->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         66,
         "There should be 66 marked packets"
         "4th packet is enqueued at 2ms and dequeued at 4ms hence the delay of 2ms which not "
@@ -1601,13 +1583,13 @@ FqCobaltQueueDiscL4sMode::DoRun()
         "5th packet is enqueued at 2.5ms and dequeued at 5ms hence the delay of 2.5ms and "
         "subsequent packet also do have delay"
         "greater than CE threshold so all the packets after 4th packet are marked");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
                           0,
                           "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
                           2,
                           "There should be 2 marked packets. Packets are dequeued"
                           "from q0 first, which leads to delay greater than 5ms for the first "
@@ -1616,7 +1598,7 @@ FqCobaltQueueDiscL4sMode::DoRun()
                           "second dequeue count increases to 2, drop_next becomes now plus around"
                           "70ms which is less than the running time(140), and as the queue delay "
                           "is persistently higher than 5ms, second packet is marked.");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
 
@@ -1673,11 +1655,11 @@ FqCobaltQueueDiscL4sMode::DoRun()
     DequeueWithDelay(queueDisc, delay, 140);
     Simulator::Run();
     Simulator::Stop(Seconds(8.0));
-    q0 = queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
-    q0 = queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CobaltQueueDisc>();
+    q0 = queueDisc->GetFlow(0);
+    q0 = queueDisc->GetFlow(0);
 
     NS_TEST_EXPECT_MSG_EQ(
-        q0->GetStats().GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q0->GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         68,
         "There should be 68 marked packets"
         "2nd ECT1 packet is enqueued at 1.5ms and dequeued at 3ms hence the delay of 1.5ms which "
@@ -1685,10 +1667,10 @@ FqCobaltQueueDiscL4sMode::DoRun()
         "3rd packet is enqueued at 2.5ms and dequeued at 5ms hence the delay of 2.5ms and "
         "subsequent packet also do have delay"
         "greater than CE threshold so all the packets after 2nd packet are marked");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
                           1,
                           "There should be 1 marked packets");
 
@@ -135,16 +135,12 @@ FqCoDelQueueDiscNoSuitableFilter::DoRun()
     Address dest;
     item = Create<Ipv6QueueDiscItem>(p, dest, 0, ipv6Header);
     queueDisc->Enqueue(item);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(),
-                          0,
-                          "no flow queue should have been created");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNFlows(), 0, "no flow queue should have been created");
 
     p = Create<Packet>(reinterpret_cast<const uint8_t*>("hello, world"), 12);
     item = Create<Ipv6QueueDiscItem>(p, dest, 0, ipv6Header);
     queueDisc->Enqueue(item);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(),
-                          0,
-                          "no flow queue should have been created");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNFlows(), 0, "no flow queue should have been created");
 
     Simulator::Destroy();
 }
@@ -211,7 +207,7 @@ FqCoDelQueueDiscIPFlowsSeparationAndPacketLimit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the flow queue");
 
@@ -222,10 +218,10 @@ FqCoDelQueueDiscIPFlowsSeparationAndPacketLimit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the flow queue");
     // Add the second packet that causes two packets to be dropped from the fat flow (max backlog =
@@ -234,10 +230,10 @@ FqCoDelQueueDiscIPFlowsSeparationAndPacketLimit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           2,
                           "unexpected number of packets in the flow queue");
 
@@ -302,10 +298,10 @@ FqCoDelQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           1,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow queue");
-    Ptr<FqCoDelFlow> flow1 = StaticCast<FqCoDelFlow>(queueDisc->GetQueueDiscClass(0));
+    const FqCoDelFlow* flow1 = queueDisc->GetFlow(0);
     NS_TEST_ASSERT_MSG_EQ(flow1->GetDeficit(),
                           static_cast<int32_t>(queueDisc->GetQuantum()),
                           "the deficit of the first flow must equal the quantum");
@@ -317,7 +313,7 @@ FqCoDelQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           0,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           0,
                           "unexpected number of packets in the first flow queue");
     // the deficit for the first flow becomes 90 - (100+20) = -30
@@ -329,7 +325,7 @@ FqCoDelQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           2,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue");
     NS_TEST_ASSERT_MSG_EQ(flow1->GetStatus(),
@@ -343,13 +339,13 @@ FqCoDelQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           2,
                           "unexpected number of packets in the second flow queue");
-    Ptr<FqCoDelFlow> flow2 = StaticCast<FqCoDelFlow>(queueDisc->GetQueueDiscClass(1));
+    const FqCoDelFlow* flow2 = queueDisc->GetFlow(1);
     NS_TEST_ASSERT_MSG_EQ(flow2->GetDeficit(),
                           static_cast<int32_t>(queueDisc->GetQuantum()),
                           "the deficit of the second flow must equal the quantum");
@@ -362,10 +358,10 @@ FqCoDelQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
     // the first flow got a quantum of deficit (-30+90=60) and has been moved to the end of the list
@@ -385,10 +381,10 @@ FqCoDelQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           2,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
     // the first flow has a negative deficit (60-(100+20)= -60) and stays in the list of old queues
@@ -408,10 +404,10 @@ FqCoDelQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           1,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           0,
                           "unexpected number of packets in the second flow queue");
     // the first flow got a quantum of deficit (-60+90=30) and has been moved to the end of the list
@@ -431,10 +427,10 @@ FqCoDelQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           0,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           0,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           0,
                           "unexpected number of packets in the second flow queue");
     // the first flow has a negative deficit (30-(100+20)= -90)
@@ -539,7 +535,7 @@ FqCoDelQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
 
@@ -549,10 +545,10 @@ FqCoDelQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
 
@@ -562,13 +558,13 @@ FqCoDelQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           5,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
 
@@ -579,16 +575,16 @@ FqCoDelQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           7,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(3)->GetNPackets(),
                           2,
                           "unexpected number of packets in the third flow queue");
 
@@ -664,7 +660,7 @@ FqCoDelQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
 
@@ -674,10 +670,10 @@ FqCoDelQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
 
@@ -687,13 +683,13 @@ FqCoDelQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           5,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
 
@@ -704,16 +700,16 @@ FqCoDelQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           7,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(3)->GetNPackets(),
                           2,
                           "unexpected number of packets in the third flow queue");
 
@@ -787,9 +783,7 @@ FqCoDelQueueDiscECNMarking::AddPacket(Ptr<FqCoDelQueueDisc> queue,
         Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem>(p, dest, 0, hdr);
         queue->Enqueue(item);
     }
-    NS_TEST_EXPECT_MSG_EQ(queue->GetNQueueDiscClasses(),
-                          nQueueFlows,
-                          "unexpected number of flow queues");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNFlows(), nQueueFlows, "unexpected number of flow queues");
     NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(),
                           nPktEnqueued,
                           "unexpected number of enqueued packets");
@@ -906,37 +900,32 @@ FqCoDelQueueDiscECNMarking::DoRun()
     DequeueWithDelay(queueDisc, 0.11, 60);
     Simulator::Run();
     Simulator::Stop(Seconds(8.0));
-    Ptr<CoDelQueueDisc> q0 =
-        queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    Ptr<CoDelQueueDisc> q1 =
-        queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    Ptr<CoDelQueueDisc> q2 =
-        queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    Ptr<CoDelQueueDisc> q3 =
-        queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    Ptr<CoDelQueueDisc> q4 =
-        queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
+    const FqCoDelFlow* q0 = queueDisc->GetFlow(0);
+    const FqCoDelFlow* q1 = queueDisc->GetFlow(1);
+    const FqCoDelFlow* q2 = queueDisc->GetFlow(2);
+    const FqCoDelFlow* q3 = queueDisc->GetFlow(3);
+    const FqCoDelFlow* q4 = queueDisc->GetFlow(4);
 
     // Ensure there are some remaining packets in the flow queues to check for flow queues with ECN
     // capable packets
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(0)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(1)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(2)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(3)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(4)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
 
     // As packets in flow queues are ECN capable
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
                           6,
                           "There should be 6 marked packets"
                           "with 20 packets, total bytes in the queue = 120 * 20 = 2400. First "
@@ -953,25 +942,25 @@ FqCoDelQueueDiscECNMarking::DoRun()
                           "number of bytes in queue = 120 * 12 = 1440"
                           "which is less m_minBytes(test's default value 1500 bytes) hence the "
                           "packets stop getting marked");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
                           6,
                           "There should be 6 marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q2->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q2->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
                           6,
                           "There should be 6 marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q2->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q2->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
 
     // As packets in flow queues are not ECN capable
     NS_TEST_EXPECT_MSG_EQ(
-        q3->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+        q3->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
         4,
         "There should be 4 dropped packets"
         "with 20 packets, total bytes in the queue = 120 * 20 = 2400. First packet dequeues at "
@@ -989,13 +978,13 @@ FqCoDelQueueDiscECNMarking::DoRun()
         "12 Packets remaining in the queue, total number of bytes int the queue = 120 * 12 = 1440 "
         "which is less"
         "m_minBytes(test's default value 1500 bytes) hence the packets stop getting dropped");
-    NS_TEST_EXPECT_MSG_EQ(q3->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q3->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
                           0,
                           "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q4->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           4,
                           "There should be 4 dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q4->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
                           0,
                           "There should not be any marked packets");
     // Ensure flow queue 0,1 and 2 have ECN capable packets
@@ -1087,75 +1076,73 @@ FqCoDelQueueDiscECNMarking::DoRun()
     DequeueWithDelay(queueDisc, 0.0001, 60);
     Simulator::Run();
     Simulator::Stop(Seconds(8.0));
-    q0 = queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    q1 = queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    q2 = queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    q3 = queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    q4 = queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
+    q0 = queueDisc->GetFlow(0);
+    q1 = queueDisc->GetFlow(1);
+    q2 = queueDisc->GetFlow(2);
+    q3 = queueDisc->GetFlow(3);
+    q4 = queueDisc->GetFlow(4);
 
     // Ensure there are some remaining packets in the flow queues to check for flow queues with ECN
     // capable packets
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(0)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(1)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(2)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(3)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(4)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
 
     // As packets in flow queues are ECN capable
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q0->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q0->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         0,
         "There should not be any marked packets"
         "with quantum of 1514, 13 packets of size 120 bytes can be dequeued. sojourn time of 13th "
         "packet is 1.3ms which is"
         "less than CE threshold");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q1->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q1->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         6,
         "There should be 6 marked packets"
         "with quantum of 1514, 13 packets of size 120 bytes can be dequeued. sojourn time of 8th "
         "packet is 2.1ms which is greater"
         "than CE threshold and subsequent packet also have sojourn time more 8th packet hence "
         "remaining packet are marked.");
-    NS_TEST_EXPECT_MSG_EQ(q2->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q2->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q2->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q2->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         13,
         "There should be 13 marked packets"
         "with quantum of 1514, 13 packets of size 120 bytes can be dequeued and all of them have "
         "sojourn time more than CE threshold");
 
     // As packets in flow queues are not ECN capable
-    NS_TEST_EXPECT_MSG_EQ(
-        q3->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
-        0,
-        "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q3->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q3->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+                          0,
+                          "There should not be any marked packets");
+    NS_TEST_EXPECT_MSG_EQ(q3->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(
-        q4->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
-        0,
-        "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q4->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+                          0,
+                          "There should not be any marked packets");
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
 
@@ -1248,77 +1235,75 @@ FqCoDelQueueDiscECNMarking::DoRun()
     DequeueWithDelay(queueDisc, 0.110, 60);
     Simulator::Run();
     Simulator::Stop(Seconds(8.0));
-    q0 = queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    q1 = queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    q2 = queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    q3 = queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    q4 = queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
+    q0 = queueDisc->GetFlow(0);
+    q1 = queueDisc->GetFlow(1);
+    q2 = queueDisc->GetFlow(2);
+    q3 = queueDisc->GetFlow(3);
+    q4 = queueDisc->GetFlow(4);
 
     // Ensure there are some remaining packets in the flow queues to check for flow queues with ECN
     // capable packets
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(0)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(1)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(2)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(3)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
-    NS_TEST_EXPECT_MSG_NE(queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_EXPECT_MSG_NE(queueDisc->GetFlow(4)->GetNPackets(),
                           0,
                           "There should be some remaining packets");
 
     // As packets in flow queues are ECN capable
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q0->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
-            q0->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+        q0->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
+            q0->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
         20 - q0->GetNPackets(),
         "Number of CE threshold"
         " exceeded marks plus Number of Target exceeded marks should be equal to total number of "
         "packets dequeued");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q1->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
-            q1->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+        q1->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
+            q1->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
         20 - q1->GetNPackets(),
         "Number of CE threshold"
         " exceeded marks plus Number of Target exceeded marks should be equal to total number of "
         "packets dequeued");
-    NS_TEST_EXPECT_MSG_EQ(q2->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q2->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q2->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
-            q2->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+        q2->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK) +
+            q2->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
         20 - q2->GetNPackets(),
         "Number of CE threshold"
         " exceeded marks plus Number of Target exceeded marks should be equal to total number of "
         "packets dequeued");
 
     // As packets in flow queues are not ECN capable
+    NS_TEST_EXPECT_MSG_EQ(q3->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+                          0,
+                          "There should not be any marked packets");
     NS_TEST_EXPECT_MSG_EQ(
-        q3->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
-        0,
-        "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(
-        q3->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+        q3->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
         4,
         "There should be 4 dropped packets"
         " As queue delay is same as in test case 1, number of dropped packets should also be same");
-    NS_TEST_EXPECT_MSG_EQ(
-        q4->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
-        0,
-        "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q4->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+                          0,
+                          "There should not be any marked packets");
+    NS_TEST_EXPECT_MSG_EQ(q4->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           4,
                           "There should be 4 dropped packets");
 
@@ -1440,38 +1425,38 @@ FqCoDelQueueDiscSetLinearProbing::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           11,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           2,
                           "unexpected number of packets in the second flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(3)->GetNPackets(),
                           1,
                           "unexpected number of packets in the fourth flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(4)->GetNPackets(),
                           2,
                           "unexpected number of packets in the fifth flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(5)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(5)->GetNPackets(),
                           1,
                           "unexpected number of packets in the sixth flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(6)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(6)->GetNPackets(),
                           1,
                           "unexpected number of packets in the seventh flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(7)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(7)->GetNPackets(),
                           1,
                           "unexpected number of packets in the eighth flow queue of set one");
     g_hash = 1025;
     AddPacket(queueDisc, hdr);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow of set one");
     g_hash = 10;
     AddPacket(queueDisc, hdr);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(8)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(8)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow of set two");
     Simulator::Destroy();
@@ -1644,13 +1629,11 @@ FqCoDelQueueDiscL4sMode::DoRun()
     DequeueWithDelay(queueDisc, delay, 140);
     Simulator::Run();
     Simulator::Stop(Seconds(8.0));
-    Ptr<CoDelQueueDisc> q0 =
-        queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
-    Ptr<CoDelQueueDisc> q1 =
-        queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
+    const FqCoDelFlow* q0 = queueDisc->GetFlow(0);
+    const FqCoDelFlow* q1 = queueDisc->GetFlow(1);
 
     NS_TEST_EXPECT_MSG_EQ(
-        q0->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q0->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         66,
         "There should be 66 marked packets"
         "4th packet is enqueued at 2ms and dequeued at 4ms hence the delay of 2ms which not "
@@ -1658,16 +1641,16 @@ FqCoDelQueueDiscL4sMode::DoRun()
         "5th packet is enqueued at 2.5ms and dequeued at 5ms hence the delay of 2.5ms and "
         "subsequent packet also do have delay"
         "greater than CE threshold so all the packets after 4th packet are marked");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
                           0,
                           "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
                           1,
                           "There should be 1 marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
 
@@ -1724,10 +1707,10 @@ FqCoDelQueueDiscL4sMode::DoRun()
     DequeueWithDelay(queueDisc, delay, 140);
     Simulator::Run();
     Simulator::Stop(Seconds(8.0));
-    q0 = queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<CoDelQueueDisc>();
+    q0 = queueDisc->GetFlow(0);
 
     NS_TEST_EXPECT_MSG_EQ(
-        q0->GetStats().GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q0->GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         68,
         "There should be 68 marked packets"
         "2nd ECT1 packet is enqueued at 1.5ms and dequeued at 3ms hence the delay of 1.5ms which "
@@ -1735,10 +1718,10 @@ FqCoDelQueueDiscL4sMode::DoRun()
         "3rd packet is enqueued at 2.5ms and dequeued at 5ms hence the delay of 2.5ms and "
         "subsequent packet also do have delay"
         "greater than CE threshold so all the packets after 2nd packet are marked");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
                           0,
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
                           1,
                           "There should be 1 marked packets");
 
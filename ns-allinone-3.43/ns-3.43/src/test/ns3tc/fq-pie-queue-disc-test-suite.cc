@@ -142,16 +142,12 @@ FqPieQueueDiscNoSuitableFilter::DoRun()
     Address dest;
     item = Create<Ipv6QueueDiscItem>(p, dest, 0, ipv6Header);
     queueDisc->Enqueue(item);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(),
-                          0,
-                          "no flow queue should have been created");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNFlows(), 0, "no flow queue should have been created");
 
     p = Create<Packet>(reinterpret_cast<const uint8_t*>("hello, world"), 12);
     item = Create<Ipv6QueueDiscItem>(p, dest, 0, ipv6Header);
     queueDisc->Enqueue(item);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(),
-                          0,
-                          "no flow queue should have been created");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNFlows(), 0, "no flow queue should have been created");
 
     Simulator::Destroy();
 }
@@ -217,7 +213,7 @@ FqPieQueueDiscIPFlowsSeparationAndPacketLimit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the flow queue");
 
@@ -228,10 +224,10 @@ FqPieQueueDiscIPFlowsSeparationAndPacketLimit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the flow queue");
     // Add the second packet that causes two packets to be dropped from the fat flow (max backlog =
@@ -240,10 +236,10 @@ FqPieQueueDiscIPFlowsSeparationAndPacketLimit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           2,
                           "unexpected number of packets in the flow queue");
 
@@ -308,10 +304,10 @@ FqPieQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           1,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow queue");
-    Ptr<FqPieFlow> flow1 = StaticCast<FqPieFlow>(queueDisc->GetQueueDiscClass(0));
+    const FqPieFlow* flow1 = queueDisc->GetFlow(0);
     NS_TEST_ASSERT_MSG_EQ(flow1->GetDeficit(),
                           static_cast<int32_t>(queueDisc->GetQuantum()),
                           "the deficit of the first flow must equal the quantum");
@@ -323,7 +319,7 @@ FqPieQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           0,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           0,
                           "unexpected number of packets in the first flow queue");
     // the deficit for the first flow becomes 90 - (100+20) = -30
@@ -335,7 +331,7 @@ FqPieQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           2,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue");
     NS_TEST_ASSERT_MSG_EQ(flow1->GetStatus(),
@@ -349,13 +345,13 @@ FqPieQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           2,
                           "unexpected number of packets in the second flow queue");
-    Ptr<FqPieFlow> flow2 = StaticCast<FqPieFlow>(queueDisc->GetQueueDiscClass(1));
+    const FqPieFlow* flow2 = queueDisc->GetFlow(1);
     NS_TEST_ASSERT_MSG_EQ(flow2->GetDeficit(),
                           static_cast<int32_t>(queueDisc->GetQuantum()),
                           "the deficit of the second flow must equal the quantum");
@@ -368,10 +364,10 @@ FqPieQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
     // the first flow got a quantum of deficit (-30+90=60) and has been moved to the end of the list
@@ -391,10 +387,10 @@ FqPieQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           2,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
     // the first flow has a negative deficit (60-(100+20)= -60) and stays in the list of old queues
@@ -414,10 +410,10 @@ FqPieQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           1,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           0,
                           "unexpected number of packets in the second flow queue");
     // the first flow got a quantum of deficit (-60+90=30) and has been moved to the end of the list
@@ -437,10 +433,10 @@ FqPieQueueDiscDeficit::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           0,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           0,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           0,
                           "unexpected number of packets in the second flow queue");
     // the first flow has a negative deficit (30-(100+20)= -90)
@@ -545,7 +541,7 @@ FqPieQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
 
@@ -555,10 +551,10 @@ FqPieQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
 
@@ -568,13 +564,13 @@ FqPieQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           5,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
 
@@ -585,16 +581,16 @@ FqPieQueueDiscTCPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           7,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(3)->GetNPackets(),
                           2,
                           "unexpected number of packets in the third flow queue");
 
@@ -670,7 +666,7 @@ FqPieQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           3,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
 
@@ -680,10 +676,10 @@ FqPieQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           4,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
 
@@ -693,13 +689,13 @@ FqPieQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           5,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
 
@@ -710,16 +706,16 @@ FqPieQueueDiscUDPFlowsSeparation::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           7,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           1,
                           "unexpected number of packets in the second flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(3)->GetNPackets(),
                           2,
                           "unexpected number of packets in the third flow queue");
 
@@ -827,38 +823,38 @@ FqPieQueueDiscSetLinearProbing::DoRun()
     NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
                           11,
                           "unexpected number of packets in the queue disc");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           2,
                           "unexpected number of packets in the first flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(1)->GetNPackets(),
                           2,
                           "unexpected number of packets in the second flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(2)->GetNPackets(),
                           1,
                           "unexpected number of packets in the third flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(3)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(3)->GetNPackets(),
                           1,
                           "unexpected number of packets in the fourth flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(4)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(4)->GetNPackets(),
                           2,
                           "unexpected number of packets in the fifth flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(5)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(5)->GetNPackets(),
                           1,
                           "unexpected number of packets in the sixth flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(6)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(6)->GetNPackets(),
                           1,
                           "unexpected number of packets in the seventh flow queue of set one");
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(7)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(7)->GetNPackets(),
                           1,
                           "unexpected number of packets in the eighth flow queue of set one");
     g_hash = 1025;
     AddPacket(queueDisc, hdr);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(0)->GetNPackets(),
                           3,
                           "unexpected number of packets in the first flow of set one");
     g_hash = 10;
     AddPacket(queueDisc, hdr);
-    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(8)->GetQueueDisc()->GetNPackets(),
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlow(8)->GetNPackets(),
                           1,
                           "unexpected number of packets in the first flow of set two");
     Simulator::Destroy();
@@ -1033,13 +1029,11 @@ FqPieQueueDiscL4sMode::DoRun()
     Simulator::Stop(Seconds(10.0));
     Simulator::Run();
 
-    Ptr<PieQueueDisc> q0 =
-        queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<PieQueueDisc>();
-    Ptr<PieQueueDisc> q1 =
-        queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetObject<PieQueueDisc>();
+    const FqPieFlow* q0 = queueDisc->GetFlow(0);
+    const FqPieFlow* q1 = queueDisc->GetFlow(1);
 
     NS_TEST_EXPECT_MSG_EQ(
-        q0->GetStats().GetNMarkedPackets(PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q0->GetNMarkedPackets(PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         66,
         "There should be 66 marked packets"
         "4th packet is enqueued at 2ms and dequeued at 4ms hence the delay of 2ms which not "
@@ -1047,17 +1041,17 @@ FqPieQueueDiscL4sMode::DoRun()
         "5th packet is enqueued at 2.5ms and dequeued at 5ms hence the delay of 2.5ms and "
         "subsequent packet also do have delay"
         "greater than CE threshold so all the packets after 4th packet are marked");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(PieQueueDisc::UNFORCED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(PieQueueDisc::UNFORCED_DROP),
                           0,
                           "Queue delay is less than max burst allowance so"
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNMarkedPackets(PieQueueDisc::UNFORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNMarkedPackets(PieQueueDisc::UNFORCED_MARK),
                           0,
                           "There should not be any marked packets");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNMarkedPackets(PieQueueDisc::UNFORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNMarkedPackets(PieQueueDisc::UNFORCED_MARK),
                           0,
                           "There should not be marked packets.");
-    NS_TEST_EXPECT_MSG_EQ(q1->GetStats().GetNDroppedPackets(PieQueueDisc::UNFORCED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q1->GetNDroppedPackets(PieQueueDisc::UNFORCED_DROP),
                           0,
                           "There should not be any dropped packets");
 
@@ -1114,11 +1108,11 @@ FqPieQueueDiscL4sMode::DoRun()
     DequeueWithDelay(queueDisc, delay, 140);
     Simulator::Stop(Seconds(1.0));
     Simulator::Run();
-    q0 = queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<PieQueueDisc>();
-    q0 = queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetObject<PieQueueDisc>();
+    q0 = queueDisc->GetFlow(0);
+    q0 = queueDisc->GetFlow(0);
 
     NS_TEST_EXPECT_MSG_EQ(
-        q0->GetStats().GetNMarkedPackets(PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        q0->GetNMarkedPackets(PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
         68,
         "There should be 68 marked packets"
         "2nd ECT1 packet is enqueued at 1.5ms and dequeued at 3ms hence the delay of 1.5ms which "
@@ -1126,11 +1120,11 @@ FqPieQueueDiscL4sMode::DoRun()
         "3rd packet is enqueued at 2.5ms and dequeued at 5ms hence the delay of 2.5ms and "
         "subsequent packet also do have delay"
         "greater than CE threshold so all the packets after 2nd packet are marked");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNDroppedPackets(PieQueueDisc::UNFORCED_DROP),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNDroppedPackets(PieQueueDisc::UNFORCED_DROP),
                           0,
                           "Queue delay is less than max burst allowance so"
                           "There should not be any dropped packets");
-    NS_TEST_EXPECT_MSG_EQ(q0->GetStats().GetNMarkedPackets(PieQueueDisc::UNFORCED_MARK),
+    NS_TEST_EXPECT_MSG_EQ(q0->GetNMarkedPackets(PieQueueDisc::UNFORCED_MARK),
                           0,
                           "There should not be any marked packets");
 
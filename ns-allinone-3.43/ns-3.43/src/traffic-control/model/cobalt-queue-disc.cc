@@ -166,8 +166,7 @@ CobaltQueueDisc::InitializeParams()
 {
     // Cobalt parameters
     NS_LOG_FUNCTION(this);
-    m_recInvSqrtCache[0] = ~0;
-    CacheInit();
+    CacheInit(m_recInvSqrtCache);
     m_count = 0;
     m_dropping = false;
     m_recInvSqrt = ~0U;
@@ -211,53 +210,62 @@ CobaltQueueDisc::GetDropNext() const
     return m_dropNext;
 }
 
-void
-CobaltQueueDisc::NewtonStep()
+CobaltQueueDisc::Params
+CobaltQueueDisc::GetParams() const
 {
-    NS_LOG_FUNCTION(this);
-    uint32_t invsqrt = ((uint32_t)m_recInvSqrt);
+    return Params{Time2CoDel(m_interval),
+                  Time2CoDel(m_target),
+                  Time2CoDel(m_ceThreshold),
+                  Time2CoDel(m_blueThreshold),
+                  m_useEcn,
+                  m_useL4s,
+                  m_increment,
+                  m_decrement,
+                  m_recInvSqrtCache};
+}
+
+uint32_t
+CobaltQueueDisc::NewtonStep(uint32_t recInvSqrt, uint32_t count)
+{
+    uint32_t invsqrt = recInvSqrt;
     uint32_t invsqrt2 = ((uint64_t)invsqrt * invsqrt) >> 32;
-    uint64_t val = (3LL << 32) - ((uint64_t)m_count * invsqrt2);
+    uint64_t val = (3LL << 32) - ((uint64_t)count * invsqrt2);
 
     val >>= 2; /* avoid overflow */
     val = (val * invsqrt) >> (32 - 2 + 1);
-    m_recInvSqrt = val;
+    return val;
 }
 
 void
-CobaltQueueDisc::CacheInit()
+CobaltQueueDisc::CacheInit(uint32_t (&cache)[REC_INV_SQRT_CACHE])
 {
-    m_recInvSqrt = ~0U;
-    m_recInvSqrtCache[0] = m_recInvSqrt;
+    uint32_t recInvSqrt = ~0U;
+    cache[0] = recInvSqrt;
 
-    for (m_count = 1; m_count < (uint32_t)(REC_INV_SQRT_CACHE); m_count++)
+    for (uint32_t count = 1; count < (uint32_t)(REC_INV_SQRT_CACHE); count++)
     {
-        NewtonStep();
-        NewtonStep();
-        NewtonStep();
-        NewtonStep();
-        m_recInvSqrtCache[m_count] = m_recInvSqrt;
+        recInvSqrt = NewtonStep(recInvSqrt, count);
+        recInvSqrt = NewtonStep(recInvSqrt, count);
+        recInvSqrt = NewtonStep(recInvSqrt, count);
+        recInvSqrt = NewtonStep(recInvSqrt, count);
+        cache[count] = recInvSqrt;
     }
 }
 
-void
-CobaltQueueDisc::InvSqrt()
+uint32_t
+CobaltQueueDisc::InvSqrt(uint32_t recInvSqrt, uint32_t count, const uint32_t* cache)
 {
-    if (m_count < (uint32_t)REC_INV_SQRT_CACHE)
+    if (count < (uint32_t)REC_INV_SQRT_CACHE)
     {
-        m_recInvSqrt = m_recInvSqrtCache[m_count];
-    }
-    else
-    {
-        NewtonStep();
+        return cache[count];
     }
+    return NewtonStep(recInvSqrt, count);
 }
 
 int64_t
-CobaltQueueDisc::ControlLaw(int64_t t)
+CobaltQueueDisc::ControlLaw(int64_t t, int64_t interval, uint32_t recInvSqrt)
 {
-    NS_LOG_FUNCTION(this);
-    return t + ReciprocalDivide(Time2CoDel(m_interval), m_recInvSqrt);
+    return t + ReciprocalDivide(interval, recInvSqrt);
 }
 
 void
@@ -327,7 +335,7 @@ CobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         NS_LOG_LOGIC("Queue full -- dropping pkt");
         int64_t now = CoDelGetTime();
         // Call this to update Blue's drop probability
-        CobaltQueueFull(now);
+        QueueFull(GetParams(), *this, now);
         DropBeforeEnqueue(item, OVERLIMIT_DROP);
         return false;
     }
@@ -358,7 +366,7 @@ CobaltQueueDisc::DoDequeue()
             NS_LOG_LOGIC("Queue empty");
             int64_t now = CoDelGetTime();
             // Call this to update Blue's drop probability
-            CobaltQueueEmpty(now);
+            QueueEmpty(GetParams(), *this, now);
             return nullptr;
         }
 
@@ -368,9 +376,17 @@ CobaltQueueDisc::DoDequeue()
         NS_LOG_LOGIC("Number packets remaining " << GetInternalQueue(0)->GetNPackets());
         NS_LOG_LOGIC("Number bytes remaining " << GetInternalQueue(0)->GetNBytes());
 
+        NS_LOG_INFO("Sojourn time " << (Simulator::Now() - item->GetTimeStamp()).As(Time::S));
+
         // Determine if item should be dropped
         // ECN marking happens inside this function, so it need not be done here
-        bool drop = CobaltShouldDrop(item, now);
+        bool drop = ShouldDrop(GetParams(),
+                               *this,
+                               item,
+                               now,
+                               [this](Ptr<QueueDiscItem> packet, const char* reason) {
+                                   return Mark(packet, reason);
+                               });
 
         if (drop)
         {
@@ -383,168 +399,4 @@ CobaltQueueDisc::DoDequeue()
     }
 }
 
-// Call this when a packet had to be dropped due to queue overflow.
-void
-CobaltQueueDisc::CobaltQueueFull(int64_t now)
-{
-    NS_LOG_FUNCTION(this);
-    NS_LOG_LOGIC("Outside IF block");
-    if (CoDelTimeAfter((now - m_lastUpdateTimeBlue), Time2CoDel(m_target)))
-    {
-        NS_LOG_LOGIC("inside IF block");
-        m_pDrop = std::min(m_pDrop + m_increment, 1.0);
-        m_lastUpdateTimeBlue = now;
-    }
-    m_dropping = true;
-    m_dropNext = now;
-    if (!m_count)
-    {
-        m_count = 1;
-    }
-}
-
-// Call this when the queue was serviced but turned out to be empty.
-void
-CobaltQueueDisc::CobaltQueueEmpty(int64_t now)
-{
-    NS_LOG_FUNCTION(this);
-    if (m_pDrop && CoDelTimeAfter((now - m_lastUpdateTimeBlue), Time2CoDel(m_target)))
-    {
-        m_pDrop = std::max(m_pDrop - m_decrement, 0.0);
-        m_lastUpdateTimeBlue = now;
-    }
-    m_dropping = false;
-
-    if (m_count && CoDelTimeAfterEq((now - m_dropNext), 0))
-    {
-        m_count--;
-        InvSqrt();
-        m_dropNext = ControlLaw(m_dropNext);
-    }
-}
-
-// Determines if Cobalt should drop the packet
-bool
-CobaltQueueDisc::CobaltShouldDrop(Ptr<QueueDiscItem> item, int64_t now)
-{
-    NS_LOG_FUNCTION(this);
-    bool drop = false;
-
-    /* Simplified Codel implementation */
-    Time delta = Simulator::Now() - item->GetTimeStamp();
-    NS_LOG_INFO("Sojourn time " << delta.As(Time::S));
-    int64_t sojournTime = Time2CoDel(delta);
-    int64_t schedule = now - m_dropNext;
-    bool over_target = CoDelTimeAfter(sojournTime, Time2CoDel(m_target));
-    bool next_due = m_count && schedule >= 0;
-    bool isMarked = false;
-
-    // If L4S mode is enabled then check if the packet is ECT1 or CE and
-    // if sojourn time is greater than CE threshold then the packet is marked.
-    // If packet is marked successfully then the CoDel steps can be skipped.
-    if (item && m_useL4s)
-    {
-        uint8_t tosByte = 0;
-        if (item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
-            (((tosByte & 0x3) == 1) || (tosByte & 0x3) == 3))
-        {
-            if ((tosByte & 0x3) == 1)
-            {
-                NS_LOG_DEBUG("ECT1 packet " << static_cast<uint16_t>(tosByte & 0x3));
-            }
-            else
-            {
-                NS_LOG_DEBUG("CE packet " << static_cast<uint16_t>(tosByte & 0x3));
-            }
-            if (CoDelTimeAfter(sojournTime, Time2CoDel(m_ceThreshold)) &&
-                Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
-            {
-                NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
-            }
-            return false;
-        }
-    }
-
-    if (over_target)
-    {
-        if (!m_dropping)
-        {
-            m_dropping = true;
-            m_dropNext = ControlLaw(now);
-        }
-        if (!m_count)
-        {
-            m_count = 1;
-        }
-    }
-    else if (m_dropping)
-    {
-        m_dropping = false;
-    }
-
-    if (next_due && m_dropping)
-    {
-        /* Check for marking possibility only if BLUE decides NOT to drop. */
-        /* Check if router and packet, both have ECN enabled. Only if this is true, mark the packet.
-         */
-        isMarked = (m_useEcn && Mark(item, FORCED_MARK));
-        drop = !isMarked;
-
-        m_count = std::max(m_count, m_count + 1);
-
-        InvSqrt();
-        m_dropNext = ControlLaw(m_dropNext);
-        schedule = now - m_dropNext;
-    }
-    else
-    {
-        while (next_due)
-        {
-            m_count--;
-            InvSqrt();
-            m_dropNext = ControlLaw(m_dropNext);
-            schedule = now - m_dropNext;
-            next_due = m_count && schedule >= 0;
-        }
-    }
-
-    // If CE threshold is enabled then isMarked flag is used to determine whether
-    // packet is marked and if the packet is marked then a second attempt at marking should be
-    // suppressed. If UseL4S attribute is enabled then ECT0 packets should not be marked.
-    if (!isMarked && !m_useL4s && m_useEcn &&
-        CoDelTimeAfter(sojournTime, Time2CoDel(m_ceThreshold)) &&
-        Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
-    {
-        NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
-    }
-
-    // Enable Blue Enhancement if sojourn time is greater than blueThreshold and its been m_target
-    // time until the last time blue was updated
-    if (CoDelTimeAfter(sojournTime, Time2CoDel(m_blueThreshold)) &&
-        CoDelTimeAfter((now - m_lastUpdateTimeBlue), Time2CoDel(m_target)))
-    {
-        m_pDrop = std::min(m_pDrop + m_increment, 1.0);
-        m_lastUpdateTimeBlue = now;
-    }
-
-    /* Simple BLUE implementation. Lack of ECN is deliberate. */
-    if (m_pDrop)
-    {
-        double u = m_uv->GetValue();
-        drop = drop || (u < m_pDrop);
-    }
-
-    /* Overload the drop_next field as an activity timeout */
-    if (!m_count)
-    {
-        m_dropNext = now + Time2CoDel(m_interval);
-    }
-    else if (schedule > 0 && !drop)
-    {
-        m_dropNext = now;
-    }
-
-    return drop;
-}
-
 } // namespace ns3
@@ -28,6 +28,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traced-value.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -123,57 +125,51 @@ class CobaltQueueDisc : public QueueDisc
      */
     int64_t Time2CoDel(Time t) const;
 
-  protected:
-    /**
-     * \brief Dispose of the object
-     */
-    void DoDispose() override;
-
-  private:
-    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
-    Ptr<QueueDiscItem> DoDequeue() override;
-    Ptr<const QueueDiscItem> DoPeek() override;
-    bool CheckConfig() override;
-
-    /**
-     * \brief Initialize the queue parameters.
-     */
-    void InitializeParams() override;
-
     /**
-     * \brief Calculate the reciprocal square root of m_count by using Newton's method
+     * \brief Calculate the reciprocal square root of count by using Newton's method
      *  http://en.wikipedia.org/wiki/Methods_of_computing_square_roots#Iterative_methods_for_reciprocal_square_roots
-     * m_recInvSqrt (new) = (m_recInvSqrt (old) / 2) * (3 - m_count * m_recInvSqrt^2)
+     * recInvSqrt (new) = (recInvSqrt (old) / 2) * (3 - count * recInvSqrt^2)
+     * \param recInvSqrt reciprocal value of sqrt (count)
+     * \param count count value
+     * \return The new recInvSqrt value
      */
-    void NewtonStep();
+    static uint32_t NewtonStep(uint32_t recInvSqrt, uint32_t count);
 
     /**
-     * \brief Determine the time for next drop
-     * CoDel control law is t + m_interval/sqrt(m_count).
-     * Here, we use m_recInvSqrt calculated by Newton's method in NewtonStep() to avoid
-     * both sqrt() and divide operations
+     * There is a big difference in timing between the accurate values placed in
+     * the cache and the approximations given by a single Newton step for small
+     * count values, particularly when stepping from count 1 to 2 or vice versa.
+     * Above 16, a single Newton step gives sufficient accuracy in either
+     * direction, given the precision stored.
      *
-     * \param t Current next drop time
-     * \returns The new next drop time:
+     * The magnitude of the error when stepping up to count 2 is such as to give
+     * the value that *should* have been produced at count 4.
+     *
+     * \param cache the cache to fill with the initial values of InvSqrt
      */
-    int64_t ControlLaw(int64_t t);
+    static void CacheInit(uint32_t (&cache)[REC_INV_SQRT_CACHE]);
 
     /**
      * \brief Updates the inverse square root
+     * \param recInvSqrt reciprocal value of sqrt (count) before count was updated
+     * \param count count value
+     * \param cache the initial values of InvSqrt, filled by CacheInit
+     * \return The new recInvSqrt value
      */
-    void InvSqrt();
+    static uint32_t InvSqrt(uint32_t recInvSqrt, uint32_t count, const uint32_t* cache);
 
     /**
-     * There is a big difference in timing between the accurate values placed in
-     * the cache and the approximations given by a single Newton step for small
-     * count values, particularly when stepping from count 1 to 2 or vice versa.
-     * Above 16, a single Newton step gives sufficient accuracy in either
-     * direction, given the precision stored.
+     * \brief Determine the time for next drop
+     * CoDel control law is t + interval/sqrt(count).
+     * Here, we use recInvSqrt calculated by Newton's method in NewtonStep() to avoid
+     * both sqrt() and divide operations
      *
-     * The magnitude of the error when stepping up to count 2 is such as to give
-     * the value that *should* have been produced at count 4.
+     * \param t Current next drop time (in units of CoDel time)
+     * \param interval interval (in units of CoDel time)
+     * \param recInvSqrt reciprocal value of sqrt (count)
+     * \return The new next drop time (in units of CoDel time)
      */
-    void CacheInit();
+    static int64_t ControlLaw(int64_t t, int64_t interval, uint32_t recInvSqrt);
 
     /**
      * Check if CoDel time a is successive to b
@@ -181,8 +177,7 @@ class CobaltQueueDisc : public QueueDisc
      * @param b right operand
      * @return true if a is greater than b
      */
-
-    bool CoDelTimeAfter(int64_t a, int64_t b);
+    static bool CoDelTimeAfter(int64_t a, int64_t b);
 
     /**
      * Check if CoDel time a is successive or equal to b
@@ -190,29 +185,92 @@ class CobaltQueueDisc : public QueueDisc
      * @param b right operand
      * @return true if a is greater than or equal to b
      */
-    bool CoDelTimeAfterEq(int64_t a, int64_t b);
+    static bool CoDelTimeAfterEq(int64_t a, int64_t b);
 
     /**
-     * Called when the queue becomes full to alter the drop probabilities of Blue
-     * \param now time in CoDel time units (microseconds)
+     * \brief The parameters of the COBALT algorithm
+     *
+     * The COBALT algorithm is run by this queue disc on its queue and by
+     * FqCobaltQueueDisc on each flow queue, through the static methods below.
+     * These methods update the state of the queue held by a CobaltQueueDisc or
+     * an FqCobaltFlow, i.e., the members named as those of CobaltQueueDisc.
      */
-    void CobaltQueueFull(int64_t now);
+    struct Params
+    {
+        int64_t interval;                //!< sliding minimum time window width, in CoDel time
+        int64_t target;                  //!< target queue delay, in CoDel time
+        int64_t ceThreshold;             //!< Threshold above which to CE mark, in CoDel time
+        int64_t blueThreshold;           //!< Threshold to enable blue enhancement, in CoDel time
+        bool useEcn;                     //!< True if ECN is used
+        bool useL4s;                     //!< True if L4S is used
+        double increment;                //!< increment value for marking probability
+        double decrement;                //!< decrement value for marking probability
+        const uint32_t* recInvSqrtCache; //!< Initial values of InvSqrt, filled by CacheInit
+    };
 
     /**
-     * Called when the queue becomes empty to alter the drop probabilities of Blue
-     * \param now time in CoDel time units (microseconds)
+     * Called when a queue becomes full to alter the drop probabilities of Blue
+     * \tparam Queue the type holding the state of the queue
+     * \param params the parameters of the algorithm
+     * \param queue the state of the queue
+     * \param now time in CoDel time units (nanoseconds)
      */
-    void CobaltQueueEmpty(int64_t now);
+    template <class Queue>
+    static void QueueFull(const Params& params, Queue& queue, int64_t now);
 
     /**
-     * Called to decide whether the current packet should be dropped based on decisions taken by
-     * Blue and Codel working parallelly
+     * Called when a queue becomes empty to alter the drop probabilities of Blue
+     * \tparam Queue the type holding the state of the queue
+     * \param params the parameters of the algorithm
+     * \param queue the state of the queue
+     * \param now time in CoDel time units (nanoseconds)
+     */
+    template <class Queue>
+    static void QueueEmpty(const Params& params, Queue& queue, int64_t now);
+
+    /**
+     * Called to decide whether the packet dequeued from a queue should be
+     * dropped based on decisions taken by Blue and Codel working parallelly
      *
-     * \return true if the packet should be dropped, false otherwise
+     * \tparam Queue the type holding the state of the queue
+     * \tparam MarkFn the type of the function marking packets
+     * \param params the parameters of the algorithm
+     * \param queue the state of the queue
      * \param item current packet
-     * \param now time in CoDel time units (microseconds)
+     * \param now time in CoDel time units (nanoseconds)
+     * \param mark the function called to mark the packet with the given reason,
+     *             returning true if the packet was marked
+     * \return true if the packet should be dropped, false otherwise
+     */
+    template <class Queue, class MarkFn>
+    static bool ShouldDrop(const Params& params,
+                           Queue& queue,
+                           Ptr<QueueDiscItem> item,
+                           int64_t now,
+                           MarkFn mark);
+
+  protected:
+    /**
+     * \brief Dispose of the object
+     */
+    void DoDispose() override;
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    Ptr<const QueueDiscItem> DoPeek() override;
+    bool CheckConfig() override;
+
+    /**
+     * \brief Initialize the queue parameters.
      */
-    bool CobaltShouldDrop(Ptr<QueueDiscItem> item, int64_t now);
+    void InitializeParams() override;
+
+    /**
+     * \brief Get the parameters of the algorithm, from the attributes
+     * \return the parameters of the algorithm
+     */
+    Params GetParams() const;
 
     // Common to CoDel and Blue
     // Maintained by Cobalt
@@ -246,6 +304,161 @@ class CobaltQueueDisc : public QueueDisc
     double m_pDrop;     //!< Drop Probability
 };
 
+// Call this when a packet had to be dropped due to queue overflow.
+template <class Queue>
+void
+CobaltQueueDisc::QueueFull(const Params& params, Queue& queue, int64_t now)
+{
+    if (CoDelTimeAfter((now - queue.m_lastUpdateTimeBlue), params.target))
+    {
+        queue.m_pDrop = std::min(queue.m_pDrop + params.increment, 1.0);
+        queue.m_lastUpdateTimeBlue = now;
+    }
+    queue.m_dropping = true;
+    queue.m_dropNext = now;
+    if (!queue.m_count)
+    {
+        queue.m_count = 1;
+    }
+}
+
+// Call this when the queue was serviced but turned out to be empty.
+template <class Queue>
+void
+CobaltQueueDisc::QueueEmpty(const Params& params, Queue& queue, int64_t now)
+{
+    if (queue.m_pDrop && CoDelTimeAfter((now - queue.m_lastUpdateTimeBlue), params.target))
+    {
+        queue.m_pDrop = std::max(queue.m_pDrop - params.decrement, 0.0);
+        queue.m_lastUpdateTimeBlue = now;
+    }
+    queue.m_dropping = false;
+
+    if (queue.m_count && CoDelTimeAfterEq((now - queue.m_dropNext), 0))
+    {
+        queue.m_count--;
+        queue.m_recInvSqrt = InvSqrt(queue.m_recInvSqrt, queue.m_count, params.recInvSqrtCache);
+        queue.m_dropNext = ControlLaw(queue.m_dropNext, params.interval, queue.m_recInvSqrt);
+    }
+}
+
+// Determines if Cobalt should drop the packet
+template <class Queue, class MarkFn>
+bool
+CobaltQueueDisc::ShouldDrop(const Params& params,
+                            Queue& queue,
+                            Ptr<QueueDiscItem> item,
+                            int64_t now,
+                            MarkFn mark)
+{
+    bool drop = false;
+
+    /* Simplified Codel implementation */
+    int64_t sojournTime = (Simulator::Now() - item->GetTimeStamp()).GetNanoSeconds();
+    int64_t schedule = now - queue.m_dropNext;
+    bool over_target = CoDelTimeAfter(sojournTime, params.target);
+    bool next_due = queue.m_count && schedule >= 0;
+    bool isMarked = false;
+
+    // If L4S mode is enabled then check if the packet is ECT1 or CE and
+    // if sojourn time is greater than CE threshold then the packet is marked.
+    // If packet is marked successfully then the CoDel steps can be skipped.
+    if (params.useL4s)
+    {
+        uint8_t tosByte = 0;
+        if (item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
+            (((tosByte & 0x3) == 1) || (tosByte & 0x3) == 3))
+        {
+            if (CoDelTimeAfter(sojournTime, params.ceThreshold))
+            {
+                mark(item, CE_THRESHOLD_EXCEEDED_MARK);
+            }
+            return false;
+        }
+    }
+
+    if (over_target)
+    {
+        if (!queue.m_dropping)
+        {
+            queue.m_dropping = true;
+            queue.m_dropNext = ControlLaw(now, params.interval, queue.m_recInvSqrt);
+        }
+        if (!queue.m_count)
+        {
+            queue.m_count = 1;
+        }
+    }
+    else if (queue.m_dropping)
+    {
+        queue.m_dropping = false;
+    }
+
+    if (next_due && queue.m_dropping)
+    {
+        /* Check for marking possibility only if BLUE decides NOT to drop. */
+        /* Check if router and packet, both have ECN enabled. Only if this is true, mark the packet.
+         */
+        isMarked = (params.useEcn && mark(item, FORCED_MARK));
+        drop = !isMarked;
+
+        queue.m_count = std::max(queue.m_count, queue.m_count + 1);
+
+        queue.m_recInvSqrt = InvSqrt(queue.m_recInvSqrt, queue.m_count, params.recInvSqrtCache);
+        queue.m_dropNext = ControlLaw(queue.m_dropNext, params.interval, queue.m_recInvSqrt);
+        schedule = now - queue.m_dropNext;
+    }
+    else
+    {
+        while (next_due)
+        {
+            queue.m_count--;
+            queue.m_recInvSqrt =
+                InvSqrt(queue.m_recInvSqrt, queue.m_count, params.recInvSqrtCache);
+            queue.m_dropNext = ControlLaw(queue.m_dropNext, params.interval, queue.m_recInvSqrt);
+            schedule = now - queue.m_dropNext;
+            next_due = queue.m_count && schedule >= 0;
+        }
+    }
+
+    // If CE threshold is enabled then isMarked flag is used to determine whether
+    // packet is marked and if the packet is marked then a second attempt at marking should be
+    // suppressed. If UseL4S attribute is enabled then ECT0 packets should not be marked.
+    if (!isMarked && !params.useL4s && params.useEcn &&
+        CoDelTimeAfter(sojournTime, params.ceThreshold))
+    {
+        mark(item, CE_THRESHOLD_EXCEEDED_MARK);
+    }
+
+    // Enable Blue Enhancement if sojourn time is greater than blueThreshold and its been m_target
+    // time until the last time blue was updated
+    if (CoDelTimeAfter(sojournTime, params.blueThreshold) &&
+        CoDelTimeAfter((now - queue.m_lastUpdateTimeBlue), params.target))
+    {
+        queue.m_pDrop = std::min(queue.m_pDrop + params.increment, 1.0);
+        queue.m_lastUpdateTimeBlue = now;
+    }
+
+    /* Simple BLUE implementation. Lack of ECN is deliberate. */
+    if (queue.m_pDrop)
+    {
+        double u = queue.m_uv->GetValue();
+        drop = drop || (u < queue.m_pDrop);
+    }
+
+    /* Overload the drop_next field as an activity timeout */
+    if (!queue.m_count)
+    {
+        queue.m_dropNext = now + params.interval;
+    }
+    else if (schedule > 0 && !drop)
+    {
+        queue.m_dropNext = now;
+    }
+
+    return drop;
+}
+
 } // namespace ns3
 
 #endif /* COBALT_H */
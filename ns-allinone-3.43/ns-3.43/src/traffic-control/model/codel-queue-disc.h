@@ -89,6 +89,29 @@ class CoDelQueueDisc : public QueueDisc
      */
     uint32_t GetDropNext();
 
+    /**
+     * \brief Calculate the reciprocal square root of m_count by using Newton's method
+     *  http://en.wikipedia.org/wiki/Methods_of_computing_square_roots#Iterative_methods_for_reciprocal_square_roots
+     * m_recInvSqrt (new) = (m_recInvSqrt (old) / 2) * (3 - m_count * m_recInvSqrt^2)
+     * \param recInvSqrt reciprocal value of sqrt (count)
+     * \param count count value
+     * \return The new recInvSqrt value
+     */
+    static uint16_t NewtonStep(uint16_t recInvSqrt, uint32_t count);
+
+    /**
+     * \brief Determine the time for next drop
+     * CoDel control law is t + m_interval/sqrt(m_count).
+     * Here, we use m_recInvSqrt calculated by Newton's method in NewtonStep() to avoid
+     * both sqrt() and divide operations
+     *
+     * \param t Current next drop time (in units of CoDel time)
+     * \param interval interval (in units of CoDel time)
+     * \param recInvSqrt reciprocal value of sqrt (count)
+     * \return The new next drop time (in units of CoDel time)
+     */
+    static uint32_t ControlLaw(uint32_t t, uint32_t interval, uint32_t recInvSqrt);
+
     // Reasons for dropping packets
     static constexpr const char* TARGET_EXCEEDED_DROP =
         "Target exceeded drop";                                     //!< Sojourn time above target
@@ -123,29 +146,6 @@ class CoDelQueueDisc : public QueueDisc
 
     bool CheckConfig() override;
 
-    /**
-     * \brief Calculate the reciprocal square root of m_count by using Newton's method
-     *  http://en.wikipedia.org/wiki/Methods_of_computing_square_roots#Iterative_methods_for_reciprocal_square_roots
-     * m_recInvSqrt (new) = (m_recInvSqrt (old) / 2) * (3 - m_count * m_recInvSqrt^2)
-     * \param recInvSqrt reciprocal value of sqrt (count)
-     * \param count count value
-     * \return The new recInvSqrt value
-     */
-    static uint16_t NewtonStep(uint16_t recInvSqrt, uint32_t count);
-
-    /**
-     * \brief Determine the time for next drop
-     * CoDel control law is t + m_interval/sqrt(m_count).
-     * Here, we use m_recInvSqrt calculated by Newton's method in NewtonStep() to avoid
-     * both sqrt() and divide operations
-     *
-     * \param t Current next drop time (in units of CoDel time)
-     * \param interval interval (in units of CoDel time)
-     * \param recInvSqrt reciprocal value of sqrt (count)
-     * \return The new next drop time (in units of CoDel time)
-     */
-    static uint32_t ControlLaw(uint32_t t, uint32_t interval, uint32_t recInvSqrt);
-
     /**
      * \brief Determine whether a packet is OK to be dropped. The packet
      * may not be actually dropped (depending on the drop state)
@@ -0,0 +1,177 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ecn-threshold-queue-disc.h"
+
+#include "ns3/boolean.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/log.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("EcnThresholdQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED(EcnThresholdQueueDisc);
+
+TypeId
+EcnThresholdQueueDisc::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::EcnThresholdQueueDisc")
+            .SetParent<QueueDisc>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<EcnThresholdQueueDisc>()
+            .AddAttribute("MaxSize",
+                          "The max queue size",
+                          QueueSizeValue(QueueSize("1000p")),
+                          MakeQueueSizeAccessor(&QueueDisc::SetMaxSize, &QueueDisc::GetMaxSize),
+                          MakeQueueSizeChecker())
+            .AddAttribute("MarkThreshold",
+                          "The queue occupancy (packets or bytes) above which the packets are "
+                          "marked when enqueued. A null threshold disables the marking.",
+                          QueueSizeValue(QueueSize("20p")),
+                          MakeQueueSizeAccessor(&EcnThresholdQueueDisc::m_markThreshold),
+                          MakeQueueSizeChecker())
+            .AddAttribute("CeThreshold",
+                          "The sojourn time above which the packets are marked when dequeued",
+                          TimeValue(Time::Max()),
+                          MakeTimeAccessor(&EcnThresholdQueueDisc::m_ceThreshold),
+                          MakeTimeChecker())
+            .AddAttribute("DropNonEct",
+                          "True to drop the packets that cannot be marked above the MarkThreshold",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&EcnThresholdQueueDisc::m_dropNonEct),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+EcnThresholdQueueDisc::EcnThresholdQueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::SINGLE_INTERNAL_QUEUE)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+EcnThresholdQueueDisc::~EcnThresholdQueueDisc()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+bool
+EcnThresholdQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    if (GetCurrentSize() + item > GetMaxSize())
+    {
+        NS_LOG_LOGIC("Queue full -- dropping pkt");
+        DropBeforeEnqueue(item, LIMIT_EXCEEDED_DROP);
+        return false;
+    }
+
+    Ptr<QueueDisc::InternalQueue> queue = GetInternalQueue(0);
+    uint32_t occupancy = (m_markThreshold.GetUnit() == QueueSizeUnit::PACKETS)
+                             ? queue->GetNPackets()
+                             : queue->GetNBytes();
+
+    if (m_markThreshold.GetValue() > 0 && occupancy >= m_markThreshold.GetValue() &&
+        !Mark(item, THRESHOLD_EXCEEDED_MARK) && m_dropNonEct)
+    {
+        NS_LOG_LOGIC("Mark threshold exceeded -- dropping non-ECT pkt");
+        DropBeforeEnqueue(item, THRESHOLD_EXCEEDED_DROP);
+        return false;
+    }
+
+    bool retval = queue->Enqueue(item);
+
+    // If Queue::Enqueue fails, QueueDisc::DropBeforeEnqueue is called by the
+    // internal queue because QueueDisc::AddInternalQueue sets the trace callback
+
+    NS_LOG_LOGIC("Number packets " << queue->GetNPackets());
+    NS_LOG_LOGIC("Number bytes " << queue->GetNBytes());
+
+    return retval;
+}
+
+Ptr<QueueDiscItem>
+EcnThresholdQueueDisc::DoDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    Ptr<QueueDiscItem> item = GetInternalQueue(0)->Dequeue();
+
+    if (!item)
+    {
+        NS_LOG_LOGIC("Queue empty");
+        return nullptr;
+    }
+
+    if (m_ceThreshold != Time::Max() &&
+        Simulator::Now() - item->GetTimeStamp() > m_ceThreshold &&
+        Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
+    {
+        NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
+    }
+
+    return item;
+}
+
+Ptr<const QueueDiscItem>
+EcnThresholdQueueDisc::DoPeek()
+{
+    NS_LOG_FUNCTION(this);
+
+    Ptr<const QueueDiscItem> item = GetInternalQueue(0)->Peek();
+
+    if (!item)
+    {
+        NS_LOG_LOGIC("Queue empty");
+        return nullptr;
+    }
+
+    return item;
+}
+
+bool
+EcnThresholdQueueDisc::CheckConfig()
+{
+    NS_LOG_FUNCTION(this);
+    if (GetNQueueDiscClasses() > 0)
+    {
+        NS_LOG_ERROR("EcnThresholdQueueDisc cannot have classes");
+        return false;
+    }
+
+    if (GetNPacketFilters() > 0)
+    {
+        NS_LOG_ERROR("EcnThresholdQueueDisc needs no packet filter");
+        return false;
+    }
+
+    if (GetNInternalQueues() == 0)
+    {
+        // add a DropTail queue
+        AddInternalQueue(
+            CreateObjectWithAttributes<DropTailQueue<QueueDiscItem>>("MaxSize",
+                                                                     QueueSizeValue(GetMaxSize())));
+    }
+
+    if (GetNInternalQueues() != 1)
+    {
+        NS_LOG_ERROR("EcnThresholdQueueDisc needs 1 internal queue");
+        return false;
+    }
+
+    return true;
+}
+
+void
+EcnThresholdQueueDisc::InitializeParams()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+} // namespace ns3
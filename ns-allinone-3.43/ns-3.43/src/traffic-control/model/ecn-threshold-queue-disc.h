@@ -0,0 +1,73 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef ECN_THRESHOLD_QUEUE_DISC_H
+#define ECN_THRESHOLD_QUEUE_DISC_H
+
+#include "queue-disc.h"
+
+#include "ns3/nstime.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A FIFO queue disc that marks the packets above a fixed threshold
+ *
+ * The queue disc implements the step marking used by DCTCP: a packet is
+ * marked if, when it is enqueued, the instantaneous occupancy of the queue
+ * disc, in the unit of the MarkThreshold (packets or bytes), is at least the
+ * MarkThreshold. Alternatively, or in addition, a packet is marked when it is
+ * dequeued if its sojourn time exceeds the CeThreshold. Unlike RED configured
+ * with equal thresholds, no average queue length is computed, hence the cost
+ * of the enqueue and dequeue operations is that of a FIFO queue disc.
+ *
+ * The packets that cannot be marked (i.e., that are not ECN capable) are
+ * enqueued, unless DropNonEct is set, in which case the packets that are not
+ * ECN capable and exceed the MarkThreshold are dropped, as RED does when ECN is
+ * enabled. The packets that exceed the MaxSize are dropped.
+ */
+class EcnThresholdQueueDisc : public QueueDisc
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief EcnThresholdQueueDisc constructor
+     */
+    EcnThresholdQueueDisc();
+
+    ~EcnThresholdQueueDisc() override;
+
+    // Reasons for dropping packets
+    static constexpr const char* LIMIT_EXCEEDED_DROP =
+        "Queue disc limit exceeded"; //!< Packet dropped due to queue disc limit exceeded
+    static constexpr const char* THRESHOLD_EXCEEDED_DROP =
+        "Mark threshold exceeded drop"; //!< Non-ECT packet dropped above the mark threshold
+    // Reasons for marking packets
+    static constexpr const char* THRESHOLD_EXCEEDED_MARK =
+        "Mark threshold exceeded mark"; //!< Packet marked above the mark threshold
+    static constexpr const char* CE_THRESHOLD_EXCEEDED_MARK =
+        "CE threshold exceeded mark"; //!< Packet marked due to the sojourn time
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    Ptr<const QueueDiscItem> DoPeek() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+
+    QueueSize m_markThreshold; //!< the occupancy above which the packets are marked
+    Time m_ceThreshold;        //!< the sojourn time above which the packets are marked
+    bool m_dropNonEct;         //!< whether to drop the non-ECT packets above the threshold
+};
+
+} // namespace ns3
+
+#endif /* ECN_THRESHOLD_QUEUE_DISC_H */
@@ -0,0 +1,401 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "fluid-background-queue-disc.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FluidBackgroundQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED(FluidBackgroundQueueDisc);
+
+TypeId
+FluidBackgroundQueueDisc::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::FluidBackgroundQueueDisc")
+            .SetParent<QueueDisc>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<FluidBackgroundQueueDisc>()
+            .AddAttribute("MaxSize",
+                          "The max queue size, shared by the packets and the background fluid",
+                          QueueSizeValue(QueueSize("1000p")),
+                          MakeQueueSizeAccessor(&QueueDisc::SetMaxSize, &QueueDisc::GetMaxSize),
+                          MakeQueueSizeChecker())
+            .AddAttribute("LinkRate",
+                          "The rate of the link. If zero, the DataRate of the device is used",
+                          DataRateValue(DataRate("0bps")),
+                          MakeDataRateAccessor(&FluidBackgroundQueueDisc::m_linkRate),
+                          MakeDataRateChecker())
+            .AddAttribute("Interval",
+                          "The time between the updates of the background flows",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&FluidBackgroundQueueDisc::m_interval),
+                          MakeTimeChecker(Time(0)))
+            .AddAttribute("PacketSize",
+                          "The size of the packets of the background flows, in bytes",
+                          UintegerValue(1500),
+                          MakeUintegerAccessor(&FluidBackgroundQueueDisc::m_packetSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxWindow",
+                          "The maximum window of the background flows, in packets",
+                          DoubleValue(10000),
+                          MakeDoubleAccessor(&FluidBackgroundQueueDisc::m_maxWindow),
+                          MakeDoubleChecker<double>(1))
+            .AddTraceSource("BackgroundRate",
+                            "The rate of the background flows, in bytes per second",
+                            MakeTraceSourceAccessor(&FluidBackgroundQueueDisc::m_backgroundRate),
+                            "ns3::TracedValueCallback::Double")
+            .AddTraceSource("LossProbability",
+                            "The fraction of the bytes dropped in the last Interval",
+                            MakeTraceSourceAccessor(&FluidBackgroundQueueDisc::m_lossProbability),
+                            "ns3::TracedValueCallback::Double");
+    return tid;
+}
+
+FluidBackgroundQueueDisc::FluidBackgroundQueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::SINGLE_INTERNAL_QUEUE),
+      m_backgroundRate(0),
+      m_lossProbability(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_uv = CreateObject<UniformRandomVariable>();
+}
+
+FluidBackgroundQueueDisc::~FluidBackgroundQueueDisc()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FluidBackgroundQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_updateEvent.Cancel();
+    m_wakeEvent.Cancel();
+    m_groups.clear();
+    m_lossHistory.clear();
+    m_departures.clear();
+    m_uv = nullptr;
+    QueueDisc::DoDispose();
+}
+
+uint32_t
+FluidBackgroundQueueDisc::AddBackgroundFlows(uint32_t nFlows, Time rtt)
+{
+    NS_LOG_FUNCTION(this << nFlows << rtt);
+    NS_ABORT_MSG_IF(!rtt.IsStrictlyPositive(), "The round trip time must be positive");
+
+    UpdateWork();
+    m_groups.push_back({nFlows, rtt});
+    if (!m_updateEvent.IsPending())
+    {
+        m_updateEvent =
+            Simulator::Schedule(m_interval, &FluidBackgroundQueueDisc::UpdateBackground, this);
+    }
+    return m_groups.size() - 1;
+}
+
+void
+FluidBackgroundQueueDisc::SetNBackgroundFlows(uint32_t group, uint32_t nFlows)
+{
+    NS_LOG_FUNCTION(this << group << nFlows);
+    NS_ABORT_MSG_IF(group >= m_groups.size(), "Invalid group of background flows " << group);
+    m_groups[group].nFlows = nFlows;
+}
+
+uint32_t
+FluidBackgroundQueueDisc::GetNBackgroundGroups() const
+{
+    return m_groups.size();
+}
+
+double
+FluidBackgroundQueueDisc::GetBackgroundWindow(uint32_t group) const
+{
+    NS_ABORT_MSG_IF(group >= m_groups.size(), "Invalid group of background flows " << group);
+    return m_groups[group].window;
+}
+
+DataRate
+FluidBackgroundQueueDisc::GetBackgroundRate() const
+{
+    return DataRate(static_cast<uint64_t>(m_backgroundRate * 8));
+}
+
+double
+FluidBackgroundQueueDisc::GetLossProbability() const
+{
+    return m_lossProbability;
+}
+
+uint32_t
+FluidBackgroundQueueDisc::GetUnfinishedWork()
+{
+    UpdateWork();
+    return static_cast<uint32_t>(m_work);
+}
+
+int64_t
+FluidBackgroundQueueDisc::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_uv->SetStream(stream);
+    return 1;
+}
+
+double
+FluidBackgroundQueueDisc::GetLimitBytes() const
+{
+    QueueSize maxSize = GetMaxSize();
+    if (maxSize.GetUnit() == QueueSizeUnit::PACKETS)
+    {
+        return static_cast<double>(maxSize.GetValue()) * m_packetSize;
+    }
+    return maxSize.GetValue();
+}
+
+void
+FluidBackgroundQueueDisc::UpdateWork()
+{
+    Time now = Simulator::Now();
+    double dt = (now - m_lastUpdate).GetSeconds();
+    m_lastUpdate = now;
+    if (dt <= 0)
+    {
+        return;
+    }
+
+    // the background fluid arrives at the background rate, and the FIFO is
+    // served at the link rate; the fluid in excess of the limit is dropped
+    double offered = m_backgroundRate * dt;
+    m_offered += offered;
+    m_work += offered - m_linkRate.GetBitRate() / 8.0 * dt;
+    double limit = GetLimitBytes();
+    if (m_work > limit)
+    {
+        m_dropped += m_work - limit;
+        m_work = limit;
+    }
+    else if (m_work < 0)
+    {
+        m_work = 0;
+    }
+}
+
+void
+FluidBackgroundQueueDisc::UpdateBackground()
+{
+    NS_LOG_FUNCTION(this);
+
+    UpdateWork();
+    m_lossProbability = (m_offered > 0 ? m_dropped / m_offered : 0);
+    m_offered = 0;
+    m_dropped = 0;
+
+    double dt = m_interval.GetSeconds();
+    double queueDelay = m_work / (m_linkRate.GetBitRate() / 8.0);
+
+    // record the rate at which each flow sees losses, which the flows react to
+    // one round trip time later
+    std::vector<double> lossRates(m_groups.size());
+    for (std::size_t i = 0; i < m_groups.size(); i++)
+    {
+        double rtt = m_groups[i].rtt.GetSeconds() + queueDelay;
+        lossRates[i] = m_groups[i].window / rtt * m_lossProbability;
+    }
+    m_lossHistory.push_front(std::move(lossRates));
+
+    // dW/dt = 1/R - W/2 * W(t-R)/R(t-R) * p(t-R), after an exponential
+    // increase until the first loss
+    double rate = 0;
+    double maxRtt = 0;
+    for (std::size_t i = 0; i < m_groups.size(); i++)
+    {
+        FlowGroup& group = m_groups[i];
+        double rtt = group.rtt.GetSeconds() + queueDelay;
+        std::size_t delay = std::min<std::size_t>(std::llround(rtt / dt), m_lossHistory.size() - 1);
+        const std::vector<double>& pastLossRates = m_lossHistory[delay];
+        double lossRate = (i < pastLossRates.size() ? pastLossRates[i] : 0);
+
+        if (group.slowStart && lossRate == 0)
+        {
+            group.window += group.window / rtt * dt;
+        }
+        else
+        {
+            group.slowStart = false;
+            group.window += (1 / rtt - group.window / 2 * lossRate) * dt;
+        }
+        group.window = std::clamp(group.window, 1.0, m_maxWindow);
+
+        rate += group.nFlows * group.window * m_packetSize / rtt;
+        maxRtt = std::max(maxRtt, rtt);
+    }
+    m_backgroundRate = rate;
+
+    // keep the history of the longest round trip time, which is bounded by the
+    // largest base round trip time plus the delay of a full queue
+    std::size_t historyLength = std::llround(maxRtt / dt) + 1;
+    while (m_lossHistory.size() > historyLength)
+    {
+        m_lossHistory.pop_back();
+    }
+
+    NS_LOG_LOGIC("Background rate " << rate << " B/s, loss probability " << m_lossProbability
+                                    << ", unfinished work " << m_work);
+
+    m_updateEvent =
+        Simulator::Schedule(m_interval, &FluidBackgroundQueueDisc::UpdateBackground, this);
+}
+
+bool
+FluidBackgroundQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    UpdateWork();
+    uint32_t size = item->GetSize();
+    m_offered += size;
+
+    // a packet that does not fit in a full queue is dropped as the background
+    // fluid, unless there is not enough fluid to push out
+    double limit = GetLimitBytes();
+    double fluid = m_work - GetInternalQueue(0)->GetNBytes();
+    if (GetCurrentSize() + item > GetMaxSize() ||
+        (m_work + size > limit && (fluid < size || m_uv->GetValue() < m_lossProbability)))
+    {
+        NS_LOG_LOGIC("Queue full -- dropping pkt");
+        m_dropped += size;
+        DropBeforeEnqueue(item, LIMIT_EXCEEDED_DROP);
+        return false;
+    }
+
+    bool retval = GetInternalQueue(0)->Enqueue(item);
+
+    // If Queue::Enqueue fails, QueueDisc::DropBeforeEnqueue is called by the
+    // internal queue because QueueDisc::AddInternalQueue sets the trace callback
+
+    if (retval)
+    {
+        double excess = std::max(m_work + size - limit, 0.0);
+        m_dropped += excess;
+        m_work -= excess;
+        // the packet leaves once the work queued before it has been served
+        m_departures.push_back(Simulator::Now() +
+                               Seconds(m_work / (m_linkRate.GetBitRate() / 8.0)));
+        m_work += size;
+    }
+
+    NS_LOG_LOGIC("Number packets " << GetInternalQueue(0)->GetNPackets());
+    NS_LOG_LOGIC("Unfinished work " << m_work);
+
+    return retval;
+}
+
+Ptr<QueueDiscItem>
+FluidBackgroundQueueDisc::DoDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_departures.empty())
+    {
+        NS_LOG_LOGIC("Queue empty");
+        return nullptr;
+    }
+
+    Time now = Simulator::Now();
+    if (m_departures.front() > now)
+    {
+        // the background fluid queued ahead of the packet is still being served
+        m_wakeEvent.Cancel();
+        m_wakeEvent = Simulator::Schedule(m_departures.front() - now, &QueueDisc::Run, this);
+        NS_LOG_LOGIC("Waking Event Scheduled in " << (m_departures.front() - now).As(Time::S));
+        return nullptr;
+    }
+
+    m_departures.pop_front();
+    return GetInternalQueue(0)->Dequeue();
+}
+
+bool
+FluidBackgroundQueueDisc::CheckConfig()
+{
+    NS_LOG_FUNCTION(this);
+    if (GetNQueueDiscClasses() > 0)
+    {
+        NS_LOG_ERROR("FluidBackgroundQueueDisc cannot have classes");
+        return false;
+    }
+
+    if (GetNPacketFilters() > 0)
+    {
+        NS_LOG_ERROR("FluidBackgroundQueueDisc needs no packet filter");
+        return false;
+    }
+
+    if (GetNInternalQueues() == 0)
+    {
+        // add a DropTail queue
+        AddInternalQueue(
+            CreateObjectWithAttributes<DropTailQueue<QueueDiscItem>>("MaxSize",
+                                                                     QueueSizeValue(GetMaxSize())));
+    }
+
+    if (GetNInternalQueues() != 1)
+    {
+        NS_LOG_ERROR("FluidBackgroundQueueDisc needs 1 internal queue");
+        return false;
+    }
+
+    if (m_linkRate.GetBitRate() == 0)
+    {
+        Ptr<NetDeviceQueueInterface> ndqi = GetNetDeviceQueueInterface();
+        Ptr<NetDevice> dev;
+        DataRateValue rate;
+        // if the NetDeviceQueueInterface object is aggregated to a
+        // NetDevice, get the data rate of such NetDevice
+        if (ndqi && (dev = ndqi->GetObject<NetDevice>()) &&
+            dev->GetAttributeFailSafe("DataRate", rate))
+        {
+            m_linkRate = rate.Get();
+        }
+    }
+
+    if (m_linkRate.GetBitRate() == 0)
+    {
+        NS_LOG_ERROR("FluidBackgroundQueueDisc needs a non-null link rate");
+        return false;
+    }
+
+    if (m_interval.IsZero())
+    {
+        NS_LOG_ERROR("FluidBackgroundQueueDisc needs a non-null update interval");
+        return false;
+    }
+
+    return true;
+}
+
+void
+FluidBackgroundQueueDisc::InitializeParams()
+{
+    NS_LOG_FUNCTION(this);
+    m_lastUpdate = Simulator::Now();
+}
+
+} // namespace ns3
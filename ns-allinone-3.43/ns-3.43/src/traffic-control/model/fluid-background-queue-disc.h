@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef FLUID_BACKGROUND_QUEUE_DISC_H
+#define FLUID_BACKGROUND_QUEUE_DISC_H
+
+#include "queue-disc.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-value.h"
+
+#include <deque>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A FIFO queue disc shared by packets and fluid background TCP flows
+ *
+ * The queue disc models a drop-tail FIFO bottleneck whose traffic is made of
+ * the packets enqueued in the queue disc (the foreground traffic) and of
+ * groups of long-lived background TCP flows, modeled as fluids. The window
+ * of the flows of a group follows the fluid model of TCP of Misra, Gong and
+ * Towsley: it increases by one packet per round trip time and halves on
+ * every loss, where the losses are those of the fluid queue one round trip
+ * time earlier. The windows, and hence the background rate, are updated
+ * every Interval, so the cost of the background traffic does not depend on
+ * the number of background flows.
+ *
+ * The queue disc tracks the unfinished work of the FIFO served at the
+ * LinkRate, i.e., the bytes of the packets and of the background fluid that
+ * are queued. The background fluid adds to the unfinished work at the
+ * background rate and is dropped when the unfinished work reaches the
+ * MaxSize of the queue disc. A packet that does not fit in the MaxSize is
+ * dropped with the loss probability of the last Interval, as the fluid, and
+ * otherwise pushes out background fluid; it is always dropped if there is not
+ * enough background fluid queued. A packet is dequeued once the unfinished
+ * work queued before it has been served, so the packets are delayed by the
+ * background queue and share the link capacity with the background flows.
+ *
+ * The LinkRate must be the rate of the device the queue disc is installed
+ * on, which is read from the DataRate attribute of the device (e.g., a
+ * PointToPointNetDevice) if the LinkRate is not set.
+ */
+class FluidBackgroundQueueDisc : public QueueDisc
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief FluidBackgroundQueueDisc constructor
+     */
+    FluidBackgroundQueueDisc();
+
+    ~FluidBackgroundQueueDisc() override;
+
+    // Reasons for dropping packets
+    static constexpr const char* LIMIT_EXCEEDED_DROP = "Queue disc limit exceeded"; //!< Full queue
+
+    /**
+     * \brief Add a group of background flows
+     *
+     * \param nFlows the number of flows of the group
+     * \param rtt the round trip time of the flows, without the queueing delay
+     *        of this queue disc
+     * \return the index of the group
+     */
+    uint32_t AddBackgroundFlows(uint32_t nFlows, Time rtt);
+
+    /**
+     * \brief Set the number of flows of a group of background flows
+     *
+     * \param group the index of the group
+     * \param nFlows the number of flows of the group
+     */
+    void SetNBackgroundFlows(uint32_t group, uint32_t nFlows);
+
+    /**
+     * \brief Get the number of groups of background flows
+     * \return the number of groups
+     */
+    uint32_t GetNBackgroundGroups() const;
+
+    /**
+     * \brief Get the window of the flows of a group of background flows
+     * \param group the index of the group
+     * \return the window of each flow of the group, in packets
+     */
+    double GetBackgroundWindow(uint32_t group) const;
+
+    /**
+     * \brief Get the rate of the background flows
+     * \return the sum of the sending rates of the background flows
+     */
+    DataRate GetBackgroundRate() const;
+
+    /**
+     * \brief Get the fraction of the bytes dropped in the last Interval
+     * \return the loss probability
+     */
+    double GetLossProbability() const;
+
+    /**
+     * \brief Get the unfinished work of the FIFO
+     * \return the bytes of the packets and of the background fluid queued
+     */
+    uint32_t GetUnfinishedWork();
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+
+    /**
+     * \brief A group of background flows with the same round trip time
+     */
+    struct FlowGroup
+    {
+        uint32_t nFlows;      //!< the number of flows
+        Time rtt;             //!< the round trip time, without the queueing delay
+        double window{1};     //!< the window of each flow, in packets
+        bool slowStart{true}; //!< whether the flows have not seen a loss yet
+    };
+
+    /**
+     * \brief Advance the unfinished work to the current time, adding the
+     * background fluid and dropping the fluid that exceeds the limit
+     */
+    void UpdateWork();
+
+    /**
+     * \brief Update the windows and the rate of the background flows, and
+     * schedule the next update
+     */
+    void UpdateBackground();
+
+    /**
+     * \brief Get the limit of the unfinished work
+     * \return the limit, in bytes
+     */
+    double GetLimitBytes() const;
+
+    DataRate m_linkRate;   //!< the rate of the link
+    Time m_interval;       //!< the time between background updates
+    uint32_t m_packetSize; //!< the size of the background packets, in bytes
+    double m_maxWindow;    //!< the maximum window of the background flows, in packets
+
+    std::vector<FlowGroup> m_groups;               //!< the groups of background flows
+    std::deque<std::vector<double>> m_lossHistory; //!< the loss rates per flow, newest first
+    std::deque<Time> m_departures;                 //!< the departure times of the packets
+    double m_work{0};                              //!< the unfinished work, in bytes
+    Time m_lastUpdate;                             //!< the time the unfinished work was updated
+    double m_offered{0};                           //!< the bytes offered since the last update
+    double m_dropped{0};                           //!< the bytes dropped since the last update
+    TracedValue<double> m_backgroundRate;          //!< the background rate, in bytes per second
+    TracedValue<double> m_lossProbability;         //!< the loss probability
+    EventId m_updateEvent;                         //!< the next background update
+    EventId m_wakeEvent;                           //!< the event to dequeue the next packet
+    Ptr<UniformRandomVariable> m_uv;               //!< rng stream for the drops of the packets
+};
+
+} // namespace ns3
+
+#endif /* FLUID_BACKGROUND_QUEUE_DISC_H */
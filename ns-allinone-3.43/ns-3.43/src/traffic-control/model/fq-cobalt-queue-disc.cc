@@ -15,89 +15,41 @@
 
 #include "fq-cobalt-queue-disc.h"
 
-#include "cobalt-queue-disc.h"
-
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
-#include "ns3/queue.h"
+#include "ns3/simulator.h"
 #include "ns3/string.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("FqCobaltQueueDisc");
 
-NS_OBJECT_ENSURE_REGISTERED(FqCobaltFlow);
-
-TypeId
-FqCobaltFlow::GetTypeId()
-{
-    static TypeId tid = TypeId("ns3::FqCobaltFlow")
-                            .SetParent<QueueDiscClass>()
-                            .SetGroupName("TrafficControl")
-                            .AddConstructor<FqCobaltFlow>();
-    return tid;
-}
-
-FqCobaltFlow::FqCobaltFlow()
-    : m_deficit(0),
-      m_status(INACTIVE),
-      m_index(0)
-{
-    NS_LOG_FUNCTION(this);
-}
-
-FqCobaltFlow::~FqCobaltFlow()
-{
-    NS_LOG_FUNCTION(this);
-}
-
-void
-FqCobaltFlow::SetDeficit(uint32_t deficit)
-{
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit = deficit;
-}
-
-int32_t
-FqCobaltFlow::GetDeficit() const
-{
-    NS_LOG_FUNCTION(this);
-    return m_deficit;
-}
-
-void
-FqCobaltFlow::IncreaseDeficit(int32_t deficit)
-{
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit += deficit;
-}
-
-void
-FqCobaltFlow::SetStatus(FlowStatus status)
+/**
+ * Returns the current time translated in CoDel time representation
+ * \return the current time
+ */
+static int64_t
+CoDelGetTime()
 {
-    NS_LOG_FUNCTION(this);
-    m_status = status;
-}
+    Time time = Simulator::Now();
+    int64_t ns = time.GetNanoSeconds();
 
-FqCobaltFlow::FlowStatus
-FqCobaltFlow::GetStatus() const
-{
-    NS_LOG_FUNCTION(this);
-    return m_status;
+    return ns;
 }
 
-void
-FqCobaltFlow::SetIndex(uint32_t index)
+int64_t
+FqCobaltFlow::GetDropNext() const
 {
-    NS_LOG_FUNCTION(this);
-    m_index = index;
+    return m_dropNext;
 }
 
-uint32_t
-FqCobaltFlow::GetIndex() const
+double
+FqCobaltFlow::GetPdrop() const
 {
-    return m_index;
+    return m_pDrop;
 }
 
 NS_OBJECT_ENSURE_REGISTERED(FqCobaltQueueDisc);
@@ -214,6 +166,27 @@ FqCobaltQueueDisc::GetQuantum() const
     return m_quantum;
 }
 
+std::size_t
+FqCobaltQueueDisc::GetNFlows() const
+{
+    return m_flowList.size();
+}
+
+const FqCobaltFlow*
+FqCobaltQueueDisc::GetFlow(std::size_t i) const
+{
+    NS_ASSERT_MSG(i < m_flowList.size(), "Flow queue index out of range");
+    return m_flowList[i];
+}
+
+void
+FqCobaltQueueDisc::TraceConnectFlowDropNext(std::size_t i, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(this << i);
+    NS_ASSERT_MSG(i < m_flowList.size(), "Flow queue index out of range");
+    m_flowList[i]->m_dropNext.ConnectWithoutContext(cb);
+}
+
 uint32_t
 FqCobaltQueueDisc::SetAssociativeHash(uint32_t flowHash)
 {
@@ -225,15 +198,10 @@ FqCobaltQueueDisc::SetAssociativeHash(uint32_t flowHash)
 
     for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
     {
-        auto it = m_flowsIndices.find(i);
-
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqCobaltFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
-                FqCobaltFlow::INACTIVE)
+        if (m_tags[i] == flowHash || m_flowTable[i].GetStatus() == FqCobaltFlow::INACTIVE)
         {
-            // this queue has not been created yet or is associated with this flow
-            // or is inactive, hence we can use it
+            // this queue is associated with this flow or is inactive (e.g., it
+            // has not been used yet), hence we can use it
             m_tags[i] = flowHash;
             return i;
         }
@@ -244,6 +212,23 @@ FqCobaltQueueDisc::SetAssociativeHash(uint32_t flowHash)
     return outerHash;
 }
 
+void
+FqCobaltQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_newFlows.Clear();
+    m_oldFlows.Clear();
+    for (auto flow : m_flowList)
+    {
+        flow->m_uv = nullptr;
+    }
+    m_flowList.clear();
+    m_flowTable.clear();
+    m_tags.clear();
+    m_itemPool.Clear();
+    QueueDisc::DoDispose();
+}
+
 bool
 FqCobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
@@ -281,43 +266,28 @@ FqCobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         h = flowHash % m_flows;
     }
 
-    Ptr<FqCobaltFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
-    {
-        NS_LOG_DEBUG("Creating a new flow queue with index " << h);
-        flow = m_flowFactory.Create<FqCobaltFlow>();
-        Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc>();
-        // If Cobalt, Set values of CobaltQueueDisc to match this QueueDisc
-        Ptr<CobaltQueueDisc> cobalt = qd->GetObject<CobaltQueueDisc>();
-        if (cobalt)
-        {
-            cobalt->SetAttribute("UseEcn", BooleanValue(m_useEcn));
-            cobalt->SetAttribute("CeThreshold", TimeValue(m_ceThreshold));
-            cobalt->SetAttribute("UseL4s", BooleanValue(m_useL4s));
-            cobalt->SetAttribute("BlueThreshold", TimeValue(m_blueThreshold));
-        }
-        qd->Initialize();
-        flow->SetQueueDisc(qd);
-        flow->SetIndex(h);
-        AddQueueDiscClass(flow);
-
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
-    }
-    else
+    FqCobaltFlow* flow = &m_flowTable[h];
+    if (!flow->IsUsed())
     {
-        flow = StaticCast<FqCobaltFlow>(GetQueueDiscClass(m_flowsIndices[h]));
+        NS_LOG_DEBUG("Using the flow queue with index " << h);
+        flow->SetUsed();
+        m_flowList.push_back(flow);
+        CobaltStart(flow);
     }
 
     if (flow->GetStatus() == FqCobaltFlow::INACTIVE)
     {
         flow->SetStatus(FqCobaltFlow::NEW_FLOW);
         flow->SetDeficit(m_quantum);
-        m_newFlows.push_back(flow);
+        m_newFlows.PushBack(flow);
     }
 
-    flow->GetQueueDisc()->Enqueue(item);
+    if (!CobaltEnqueue(flow, item))
+    {
+        return false;
+    }
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    NS_LOG_DEBUG("Packet enqueued into flow " << h);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -333,24 +303,24 @@ FqCobaltQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<FqCobaltFlow> flow;
+    FqCobaltFlow* flow = nullptr;
     Ptr<QueueDiscItem> item;
 
     do
     {
         bool found = false;
 
-        while (!found && !m_newFlows.empty())
+        while (!found && !m_newFlows.IsEmpty())
         {
-            flow = m_newFlows.front();
+            flow = m_newFlows.Front();
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
                 flow->SetStatus(FqCobaltFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_newFlows.PopFront();
+                m_oldFlows.PushBack(flow);
             }
             else
             {
@@ -359,16 +329,16 @@ FqCobaltQueueDisc::DoDequeue()
             }
         }
 
-        while (!found && !m_oldFlows.empty())
+        while (!found && !m_oldFlows.IsEmpty())
         {
-            flow = m_oldFlows.front();
+            flow = m_oldFlows.Front();
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
-                m_oldFlows.push_back(flow);
-                m_oldFlows.pop_front();
+                m_oldFlows.PopFront();
+                m_oldFlows.PushBack(flow);
             }
             else
             {
@@ -383,21 +353,21 @@ FqCobaltQueueDisc::DoDequeue()
             return nullptr;
         }
 
-        item = flow->GetQueueDisc()->Dequeue();
+        item = CobaltDequeue(flow);
 
         if (!item)
         {
             NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
-            if (!m_newFlows.empty())
+            if (!m_newFlows.IsEmpty())
             {
                 flow->SetStatus(FqCobaltFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_newFlows.PopFront();
+                m_oldFlows.PushBack(flow);
             }
             else
             {
                 flow->SetStatus(FqCobaltFlow::INACTIVE);
-                m_oldFlows.pop_front();
+                m_oldFlows.PopFront();
             }
         }
         else
@@ -471,15 +441,27 @@ FqCobaltQueueDisc::InitializeParams()
 {
     NS_LOG_FUNCTION(this);
 
-    m_flowFactory.SetTypeId("ns3::FqCobaltFlow");
+    m_flowTable.assign(m_flows, FqCobaltFlow());
+    m_flowList.clear();
+    m_flowList.reserve(m_flows);
+    m_tags.assign(m_flows, 0);
 
-    m_queueDiscFactory.SetTypeId("ns3::CobaltQueueDisc");
-    m_queueDiscFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
-    m_queueDiscFactory.Set("Interval", StringValue(m_interval));
-    m_queueDiscFactory.Set("Target", StringValue(m_target));
-    m_queueDiscFactory.Set("Pdrop", DoubleValue(m_Pdrop));
-    m_queueDiscFactory.Set("Increment", DoubleValue(m_increment));
-    m_queueDiscFactory.Set("Decrement", DoubleValue(m_decrement));
+    for (uint32_t i = 0; i < m_flows; i++)
+    {
+        m_flowTable[i].SetIndex(i);
+        m_flowTable[i].SetItemPool(&m_itemPool);
+    }
+
+    CobaltQueueDisc::CacheInit(m_recInvSqrtCache);
+    m_cobaltParams = CobaltQueueDisc::Params{Time(m_interval).GetNanoSeconds(),
+                                             Time(m_target).GetNanoSeconds(),
+                                             m_ceThreshold.GetNanoSeconds(),
+                                             m_blueThreshold.GetNanoSeconds(),
+                                             m_useEcn,
+                                             m_useL4s,
+                                             m_increment,
+                                             m_decrement,
+                                             m_recInvSqrtCache};
 }
 
 uint32_t
@@ -489,13 +471,11 @@ FqCobaltQueueDisc::FqCobaltDrop()
 
     uint32_t maxBacklog = 0;
     uint32_t index = 0;
-    Ptr<QueueDisc> qd;
 
     /* Queue is full! Find the fat flow and drop packet(s) from it */
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
+    for (uint32_t i = 0; i < m_flowList.size(); i++)
     {
-        qd = GetQueueDiscClass(i)->GetQueueDisc();
-        uint32_t bytes = qd->GetNBytes();
+        uint32_t bytes = m_flowList[i]->GetNBytes();
         if (bytes > maxBacklog)
         {
             maxBacklog = bytes;
@@ -507,19 +487,119 @@ FqCobaltQueueDisc::FqCobaltDrop()
     uint32_t len = 0;
     uint32_t count = 0;
     uint32_t threshold = maxBacklog >> 1;
-    qd = GetQueueDiscClass(index)->GetQueueDisc();
+    FqCobaltFlow* flow = m_flowList[index];
     Ptr<QueueDiscItem> item;
 
     do
     {
         NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
                                                        << " threshold: " << threshold);
-        item = qd->GetInternalQueue(0)->Dequeue();
+        item = FlowDequeue(flow);
         DropAfterDequeue(item, OVERLIMIT_DROP);
+        flow->NotifyDrop(OVERLIMIT_DROP);
         len += item->GetSize();
     } while (++count < m_dropBatchSize && len < threshold);
 
     return index;
 }
 
+Ptr<QueueDiscItem>
+FqCobaltQueueDisc::FlowDequeue(FqCobaltFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+
+    Ptr<QueueDiscItem> item = flow->Dequeue();
+    if (item)
+    {
+        PacketDequeued(item);
+        NS_LOG_LOGIC("Popped " << item);
+        NS_LOG_LOGIC("Number packets remaining " << flow->GetNPackets());
+        NS_LOG_LOGIC("Number bytes remaining " << flow->GetNBytes());
+    }
+    return item;
+}
+
+void
+FqCobaltQueueDisc::CobaltStart(FqCobaltFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+    flow->m_uv = CreateObject<UniformRandomVariable>();
+    flow->m_pDrop = m_Pdrop;
+}
+
+bool
+FqCobaltQueueDisc::CobaltEnqueue(FqCobaltFlow* flow, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << flow << item);
+    if (flow->GetCurrentSize(GetMaxSize().GetUnit()) + item > GetMaxSize())
+    {
+        NS_LOG_LOGIC("Flow queue full -- dropping pkt");
+        int64_t now = CoDelGetTime();
+        // Call this to update Blue's drop probability
+        CobaltQueueDisc::QueueFull(m_cobaltParams, *flow, now);
+        DropBeforeEnqueue(item, CobaltQueueDisc::OVERLIMIT_DROP);
+        flow->NotifyDrop(CobaltQueueDisc::OVERLIMIT_DROP);
+        return false;
+    }
+
+    flow->Enqueue(item);
+    PacketEnqueued(item);
+
+    NS_LOG_LOGIC("Number packets " << flow->GetNPackets());
+    NS_LOG_LOGIC("Number bytes " << flow->GetNBytes());
+
+    return true;
+}
+
+Ptr<QueueDiscItem>
+FqCobaltQueueDisc::CobaltDequeue(FqCobaltFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+
+    while (true)
+    {
+        Ptr<QueueDiscItem> item = FlowDequeue(flow);
+        if (!item)
+        {
+            // Leave dropping state when queue is empty (derived from Codel)
+            flow->m_dropping = false;
+            NS_LOG_LOGIC("Queue empty");
+            int64_t now = CoDelGetTime();
+            // Call this to update Blue's drop probability
+            CobaltQueueDisc::QueueEmpty(m_cobaltParams, *flow, now);
+            return nullptr;
+        }
+
+        int64_t now = CoDelGetTime();
+
+        NS_LOG_INFO("Sojourn time " << (Simulator::Now() - item->GetTimeStamp()).As(Time::S));
+
+        // Determine if item should be dropped
+        // ECN marking happens inside this function, so it need not be done here
+        bool drop = CobaltQueueDisc::ShouldDrop(
+            m_cobaltParams,
+            *flow,
+            item,
+            now,
+            [this, flow](Ptr<QueueDiscItem> packet, const char* reason) {
+                if (Mark(packet, reason))
+                {
+                    flow->NotifyMark(reason);
+                    return true;
+                }
+                return false;
+            });
+
+        if (drop)
+        {
+            DropAfterDequeue(item, CobaltQueueDisc::TARGET_EXCEEDED_DROP);
+            flow->NotifyDrop(CobaltQueueDisc::TARGET_EXCEEDED_DROP);
+        }
+        else
+        {
+            return item;
+        }
+    }
+}
+
 } // namespace ns3
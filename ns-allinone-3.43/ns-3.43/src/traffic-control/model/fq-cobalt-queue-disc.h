@@ -16,12 +16,11 @@
 #ifndef FQ_COBALT_QUEUE_DISC
 #define FQ_COBALT_QUEUE_DISC
 
+#include "cobalt-queue-disc.h"
+#include "fq-flow.h"
 #include "queue-disc.h"
 
-#include "ns3/object-factory.h"
-
-#include <list>
-#include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -30,74 +29,36 @@ namespace ns3
  * \ingroup traffic-control
  *
  * \brief A flow queue used by the FqCobalt queue disc
+ *
+ * The flow holds the state of the COBALT algorithm run by the FqCobalt queue
+ * disc on the packets of the flow.
  */
 
-class FqCobaltFlow : public QueueDiscClass
+class FqCobaltFlow : public FqFlow
 {
   public:
     /**
-     * \brief Get the type ID.
-     * \return the object TypeId
-     */
-    static TypeId GetTypeId();
-    /**
-     * \brief FqCobaltFlow constructor
-     */
-    FqCobaltFlow();
-
-    ~FqCobaltFlow() override;
-
-    /**
-     * \enum FlowStatus
-     * \brief Used to determine the status of this flow queue
-     */
-    enum FlowStatus
-    {
-        INACTIVE,
-        NEW_FLOW,
-        OLD_FLOW
-    };
-
-    /**
-     * \brief Set the deficit for this flow
-     * \param deficit the deficit for this flow
-     */
-    void SetDeficit(uint32_t deficit);
-    /**
-     * \brief Get the deficit for this flow
-     * \return the deficit for this flow
-     */
-    int32_t GetDeficit() const;
-    /**
-     * \brief Increase the deficit for this flow
-     * \param deficit the amount by which the deficit is to be increased
-     */
-    void IncreaseDeficit(int32_t deficit);
-    /**
-     * \brief Set the status for this flow
-     * \param status the status for this flow
-     */
-    void SetStatus(FlowStatus status);
-    /**
-     * \brief Get the status of this flow
-     * \return the status of this flow
-     */
-    FlowStatus GetStatus() const;
-    /**
-     * \brief Set the index for this flow
-     * \param index the index for this flow
+     * \brief Get the time to drop the next packet of this flow
+     * \return the time to drop the next packet, in CoDel time units (nanoseconds)
      */
-    void SetIndex(uint32_t index);
+    int64_t GetDropNext() const;
     /**
-     * \brief Get the index of this flow
-     * \return the index of this flow
+     * \brief Get the drop probability of Blue for this flow
+     * \return the current value of Blue's drop probability
      */
-    uint32_t GetIndex() const;
+    double GetPdrop() const;
 
   private:
-    int32_t m_deficit;   //!< the deficit for this flow
-    FlowStatus m_status; //!< the status of this flow
-    uint32_t m_index;    //!< the index for this flow
+    friend class FqCobaltQueueDisc;
+    friend class CobaltQueueDisc; // runs the COBALT algorithm on the flow
+
+    uint32_t m_count{0};                //!< Number of packets dropped since entering drop state
+    TracedValue<int64_t> m_dropNext{0}; //!< Time to drop next packet
+    bool m_dropping{false};             //!< True if in dropping state
+    uint32_t m_recInvSqrt{~0U};         //!< Reciprocal inverse square root
+    uint32_t m_lastUpdateTimeBlue{0};   //!< Blue's last update time for drop probability
+    double m_pDrop{0};                  //!< Drop Probability
+    Ptr<UniformRandomVariable> m_uv;    //!< Rng stream
 };
 
 /**
@@ -137,12 +98,35 @@ class FqCobaltQueueDisc : public QueueDisc
      */
     uint32_t GetQuantum() const;
 
+    /**
+     * \brief Get the number of flow queues that received packets
+     * \return the number of flow queues that received packets
+     */
+    std::size_t GetNFlows() const;
+
+    /**
+     * \brief Get a flow queue that received packets
+     * \param i the index of the flow queue, in the order of their first packet
+     * \return the flow queue
+     */
+    const FqCobaltFlow* GetFlow(std::size_t i) const;
+
+    /**
+     * \brief Connect a callback to the changes of the time to drop the next
+     * packet of a flow queue that received packets
+     * \param i the index of the flow queue, in the order of their first packet
+     * \param cb the callback, invoked with the old and the new time to drop the
+     *           next packet, in CoDel time units (nanoseconds)
+     */
+    void TraceConnectFlowDropNext(std::size_t i, const CallbackBase& cb);
+
     // Reasons for dropping packets
     static constexpr const char* UNCLASSIFIED_DROP =
         "Unclassified drop"; //!< No packet filter able to classify packet
     static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Overlimit dropped packets
 
   private:
+    void DoDispose() override;
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
     Ptr<QueueDiscItem> DoDequeue() override;
     bool CheckConfig() override;
@@ -154,6 +138,34 @@ class FqCobaltQueueDisc : public QueueDisc
      */
     uint32_t FqCobaltDrop();
 
+    /**
+     * \brief Initialize the COBALT state of a flow, when it receives its first packet
+     * \param flow the flow
+     */
+    void CobaltStart(FqCobaltFlow* flow);
+
+    /**
+     * \brief Run COBALT on a packet to be enqueued into a flow
+     * \param flow the flow
+     * \param item the packet
+     * \return true if the packet has been enqueued, false if it has been dropped
+     */
+    bool CobaltEnqueue(FqCobaltFlow* flow, Ptr<QueueDiscItem> item);
+
+    /**
+     * \brief Dequeue a packet from a flow, dropping the packets COBALT decides to drop
+     * \param flow the flow
+     * \return the packet, or a null pointer if the flow is empty
+     */
+    Ptr<QueueDiscItem> CobaltDequeue(FqCobaltFlow* flow);
+
+    /**
+     * \brief Dequeue a packet from a flow and update the statistics
+     * \param flow the flow
+     * \return the packet, or a null pointer if the flow is empty
+     */
+    Ptr<QueueDiscItem> FlowDequeue(FqCobaltFlow* flow);
+
     /**
      * Compute the index of the queue for the flow having the given flowHash,
      * according to the set associative hash approach.
@@ -179,14 +191,18 @@ class FqCobaltQueueDisc : public QueueDisc
     double m_Pdrop;       //!< Drop Probability
     Time m_blueThreshold; //!< Threshold to enable blue enhancement
 
-    std::list<Ptr<FqCobaltFlow>> m_newFlows; //!< The list of new flows
-    std::list<Ptr<FqCobaltFlow>> m_oldFlows; //!< The list of old flows
+    FqFlowList<FqCobaltFlow> m_newFlows; //!< The list of new flows
+    FqFlowList<FqCobaltFlow> m_oldFlows; //!< The list of old flows
+
+    CobaltQueueDisc::Params m_cobaltParams; //!< Parameters of the COBALT algorithm
 
-    std::map<uint32_t, uint32_t> m_flowsIndices; //!< Map with the index of class for each flow
-    std::map<uint32_t, uint32_t> m_tags;         //!< Tags used by set associative hash
+    uint32_t m_recInvSqrtCache[REC_INV_SQRT_CACHE] = {
+        0}; //!< Cache of the initial values of InvSqrt, shared by the flows
 
-    ObjectFactory m_flowFactory;      //!< Factory to create a new flow
-    ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
+    std::vector<FqCobaltFlow> m_flowTable; //!< The flow queue of each index
+    std::vector<FqCobaltFlow*> m_flowList; //!< The flow queues that received packets
+    std::vector<uint32_t> m_tags;          //!< Tags used by set associative hash
+    FqItemPool m_itemPool;                 //!< The packets of the flow queues
 };
 
 } // namespace ns3
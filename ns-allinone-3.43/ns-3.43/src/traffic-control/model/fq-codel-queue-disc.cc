@@ -9,11 +9,9 @@
 
 #include "fq-codel-queue-disc.h"
 
-#include "codel-queue-disc.h"
-
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
-#include "ns3/queue.h"
+#include "ns3/simulator.h"
 #include "ns3/string.h"
 
 namespace ns3
@@ -21,77 +19,67 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("FqCoDelQueueDisc");
 
-NS_OBJECT_ENSURE_REGISTERED(FqCoDelFlow);
-
-TypeId
-FqCoDelFlow::GetTypeId()
-{
-    static TypeId tid = TypeId("ns3::FqCoDelFlow")
-                            .SetParent<QueueDiscClass>()
-                            .SetGroupName("TrafficControl")
-                            .AddConstructor<FqCoDelFlow>();
-    return tid;
-}
-
-FqCoDelFlow::FqCoDelFlow()
-    : m_deficit(0),
-      m_status(INACTIVE),
-      m_index(0)
-{
-    NS_LOG_FUNCTION(this);
-}
-
-FqCoDelFlow::~FqCoDelFlow()
-{
-    NS_LOG_FUNCTION(this);
-}
-
-void
-FqCoDelFlow::SetDeficit(uint32_t deficit)
-{
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit = deficit;
-}
-
-int32_t
-FqCoDelFlow::GetDeficit() const
+/**
+ * Returns the current time translated in CoDel time representation
+ * \return the current time
+ */
+static uint32_t
+CoDelGetTime()
 {
-    NS_LOG_FUNCTION(this);
-    return m_deficit;
+    return static_cast<uint32_t>(Simulator::Now().GetNanoSeconds() >> CODEL_SHIFT);
 }
 
-void
-FqCoDelFlow::IncreaseDeficit(int32_t deficit)
+/**
+ * Return the unsigned 32-bit integer representation of the input Time object
+ * \param t the input Time Object
+ * \return the unsigned 32-bit integer representation
+ */
+static uint32_t
+Time2CoDel(Time t)
 {
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit += deficit;
+    return static_cast<uint32_t>(t.GetNanoSeconds() >> CODEL_SHIFT);
 }
 
-void
-FqCoDelFlow::SetStatus(FlowStatus status)
+/**
+ * Check if CoDel time a is successive to b
+ * \param a left operand
+ * \param b right operand
+ * \return true if a is greater than b
+ */
+static bool
+CoDelTimeAfter(uint32_t a, uint32_t b)
 {
-    NS_LOG_FUNCTION(this);
-    m_status = status;
+    return ((int64_t)(a) - (int64_t)(b) > 0);
 }
 
-FqCoDelFlow::FlowStatus
-FqCoDelFlow::GetStatus() const
+/**
+ * Check if CoDel time a is successive or equal to b
+ * \param a left operand
+ * \param b right operand
+ * \return true if a is greater than or equal to b
+ */
+static bool
+CoDelTimeAfterEq(uint32_t a, uint32_t b)
 {
-    NS_LOG_FUNCTION(this);
-    return m_status;
+    return ((int64_t)(a) - (int64_t)(b) >= 0);
 }
 
-void
-FqCoDelFlow::SetIndex(uint32_t index)
+/**
+ * Check if CoDel time a is preceding b
+ * \param a left operand
+ * \param b right operand
+ * \return true if a is less than to b
+ */
+static bool
+CoDelTimeBefore(uint32_t a, uint32_t b)
 {
-    NS_LOG_FUNCTION(this);
-    m_index = index;
+    return ((int64_t)(a) - (int64_t)(b) < 0);
 }
 
 uint32_t
-FqCoDelFlow::GetIndex() const
+FqCoDelFlow::GetDropNext() const
 {
-    return m_index;
+    return m_dropNext;
 }
 
 NS_OBJECT_ENSURE_REGISTERED(FqCoDelQueueDisc);
@@ -119,6 +107,11 @@ FqCoDelQueueDisc::GetTypeId()
                           StringValue("5ms"),
                           MakeStringAccessor(&FqCoDelQueueDisc::m_target),
                           MakeStringChecker())
+            .AddAttribute("MinBytes",
+                          "The CoDel algorithm minbytes parameter for each FQCoDel queue",
+                          UintegerValue(1500),
+                          MakeUintegerAccessor(&FqCoDelQueueDisc::m_minBytes),
+                          MakeUintegerChecker<uint32_t>())
             .AddAttribute("MaxSize",
                           "The maximum number of packets accepted by this queue disc",
                           QueueSizeValue(QueueSize("10240p")),
@@ -188,6 +181,19 @@ FqCoDelQueueDisc::GetQuantum() const
     return m_quantum;
 }
 
+std::size_t
+FqCoDelQueueDisc::GetNFlows() const
+{
+    return m_flowList.size();
+}
+
+const FqCoDelFlow*
+FqCoDelQueueDisc::GetFlow(std::size_t i) const
+{
+    NS_ASSERT_MSG(i < m_flowList.size(), "Flow queue index out of range");
+    return m_flowList[i];
+}
+
 uint32_t
 FqCoDelQueueDisc::SetAssociativeHash(uint32_t flowHash)
 {
@@ -199,15 +205,10 @@ FqCoDelQueueDisc::SetAssociativeHash(uint32_t flowHash)
 
     for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
     {
-        auto it = m_flowsIndices.find(i);
-
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqCoDelFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
-                FqCoDelFlow::INACTIVE)
+        if (m_tags[i] == flowHash || m_flowTable[i].GetStatus() == FqCoDelFlow::INACTIVE)
         {
-            // this queue has not been created yet or is associated with this flow
-            // or is inactive, hence we can use it
+            // this queue is associated with this flow or is inactive (e.g., it
+            // has not been used yet), hence we can use it
             m_tags[i] = flowHash;
             return i;
         }
@@ -218,6 +219,19 @@ FqCoDelQueueDisc::SetAssociativeHash(uint32_t flowHash)
     return outerHash;
 }
 
+void
+FqCoDelQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_newFlows.Clear();
+    m_oldFlows.Clear();
+    m_flowList.clear();
+    m_flowTable.clear();
+    m_tags.clear();
+    m_itemPool.Clear();
+    QueueDisc::DoDispose();
+}
+
 bool
 FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
@@ -255,42 +269,33 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         h = flowHash % m_flows;
     }
 
-    Ptr<FqCoDelFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
-    {
-        NS_LOG_DEBUG("Creating a new flow queue with index " << h);
-        flow = m_flowFactory.Create<FqCoDelFlow>();
-        Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc>();
-        // If CoDel, Set values of CoDelQueueDisc to match this QueueDisc
-        Ptr<CoDelQueueDisc> codel = qd->GetObject<CoDelQueueDisc>();
-        if (codel)
-        {
-            codel->SetAttribute("UseEcn", BooleanValue(m_useEcn));
-            codel->SetAttribute("CeThreshold", TimeValue(m_ceThreshold));
-            codel->SetAttribute("UseL4s", BooleanValue(m_useL4s));
-        }
-        qd->Initialize();
-        flow->SetQueueDisc(qd);
-        flow->SetIndex(h);
-        AddQueueDiscClass(flow);
-
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
-    }
-    else
+    FqCoDelFlow* flow = &m_flowTable[h];
+    if (!flow->IsUsed())
     {
-        flow = StaticCast<FqCoDelFlow>(GetQueueDiscClass(m_flowsIndices[h]));
+        NS_LOG_DEBUG("Using the flow queue with index " << h);
+        flow->SetUsed();
+        m_flowList.push_back(flow);
     }
 
     if (flow->GetStatus() == FqCoDelFlow::INACTIVE)
     {
         flow->SetStatus(FqCoDelFlow::NEW_FLOW);
         flow->SetDeficit(m_quantum);
-        m_newFlows.push_back(flow);
+        m_newFlows.PushBack(flow);
+    }
+
+    if (flow->GetCurrentSize(GetMaxSize().GetUnit()) + item > GetMaxSize())
+    {
+        NS_LOG_LOGIC("Flow queue full -- dropping pkt");
+        DropBeforeEnqueue(item, CoDelQueueDisc::OVERLIMIT_DROP);
+        flow->NotifyDrop(CoDelQueueDisc::OVERLIMIT_DROP);
+        return false;
     }
 
-    flow->GetQueueDisc()->Enqueue(item);
+    flow->Enqueue(item);
+    PacketEnqueued(item);
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    NS_LOG_DEBUG("Packet enqueued into flow " << h);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -306,23 +311,24 @@ FqCoDelQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<FqCoDelFlow> flow;
+    FqCoDelFlow* flow = nullptr;
     Ptr<QueueDiscItem> item;
 
     do
     {
         bool found = false;
 
-        while (!found && !m_newFlows.empty())
+        while (!found && !m_newFlows.IsEmpty())
         {
-            flow = m_newFlows.front();
+            flow = m_newFlows.Front();
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
                 flow->SetStatus(FqCoDelFlow::OLD_FLOW);
-                m_oldFlows.splice(m_oldFlows.end(), m_newFlows, m_newFlows.begin());
+                m_newFlows.PopFront();
+                m_oldFlows.PushBack(flow);
             }
             else
             {
@@ -331,15 +337,16 @@ FqCoDelQueueDisc::DoDequeue()
             }
         }
 
-        while (!found && !m_oldFlows.empty())
+        while (!found && !m_oldFlows.IsEmpty())
         {
-            flow = m_oldFlows.front();
+            flow = m_oldFlows.Front();
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
-                m_oldFlows.splice(m_oldFlows.end(), m_oldFlows, m_oldFlows.begin());
+                m_oldFlows.PopFront();
+                m_oldFlows.PushBack(flow);
             }
             else
             {
@@ -354,21 +361,21 @@ FqCoDelQueueDisc::DoDequeue()
             return nullptr;
         }
 
-        item = flow->GetQueueDisc()->Dequeue();
+        item = CoDelDequeue(flow);
 
         if (!item)
         {
             NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
-            if (!m_newFlows.empty())
+            if (!m_newFlows.IsEmpty())
             {
                 flow->SetStatus(FqCoDelFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_newFlows.PopFront();
+                m_oldFlows.PushBack(flow);
             }
             else
             {
                 flow->SetStatus(FqCoDelFlow::INACTIVE);
-                m_oldFlows.pop_front();
+                m_oldFlows.PopFront();
             }
         }
         else
@@ -442,12 +449,19 @@ FqCoDelQueueDisc::InitializeParams()
 {
     NS_LOG_FUNCTION(this);
 
-    m_flowFactory.SetTypeId("ns3::FqCoDelFlow");
+    m_flowTable.assign(m_flows, FqCoDelFlow());
+    m_flowList.clear();
+    m_flowList.reserve(m_flows);
+    m_tags.assign(m_flows, 0);
+    for (uint32_t i = 0; i < m_flows; i++)
+    {
+        m_flowTable[i].SetIndex(i);
+        m_flowTable[i].SetItemPool(&m_itemPool);
+    }
 
-    m_queueDiscFactory.SetTypeId("ns3::CoDelQueueDisc");
-    m_queueDiscFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
-    m_queueDiscFactory.Set("Interval", StringValue(m_interval));
-    m_queueDiscFactory.Set("Target", StringValue(m_target));
+    m_codelInterval = Time2CoDel(Time(m_interval));
+    m_codelTarget = Time2CoDel(Time(m_target));
+    m_codelCeThreshold = Time2CoDel(m_ceThreshold);
 }
 
 uint32_t
@@ -457,13 +471,11 @@ FqCoDelQueueDisc::FqCoDelDrop()
 
     uint32_t maxBacklog = 0;
     uint32_t index = 0;
-    Ptr<QueueDisc> qd;
 
     /* Queue is full! Find the fat flow and drop packet(s) from it */
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
+    for (uint32_t i = 0; i < m_flowList.size(); i++)
     {
-        qd = GetQueueDiscClass(i)->GetQueueDisc();
-        uint32_t bytes = qd->GetNBytes();
+        uint32_t bytes = m_flowList[i]->GetNBytes();
         if (bytes > maxBacklog)
         {
             maxBacklog = bytes;
@@ -475,19 +487,247 @@ FqCoDelQueueDisc::FqCoDelDrop()
     uint32_t len = 0;
     uint32_t count = 0;
     uint32_t threshold = maxBacklog >> 1;
-    qd = GetQueueDiscClass(index)->GetQueueDisc();
+    FqCoDelFlow* flow = m_flowList[index];
     Ptr<QueueDiscItem> item;
 
     do
     {
         NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
                                                        << " threshold: " << threshold);
-        item = qd->GetInternalQueue(0)->Dequeue();
+        item = FlowDequeue(flow);
         DropAfterDequeue(item, OVERLIMIT_DROP);
+        flow->NotifyDrop(OVERLIMIT_DROP);
         len += item->GetSize();
     } while (++count < m_dropBatchSize && len < threshold);
 
     return index;
 }
 
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::FlowDequeue(FqCoDelFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+
+    Ptr<QueueDiscItem> item = flow->Dequeue();
+    if (item)
+    {
+        PacketDequeued(item);
+        NS_LOG_LOGIC("Popped " << item);
+        NS_LOG_LOGIC("Number packets remaining " << flow->GetNPackets());
+        NS_LOG_LOGIC("Number bytes remaining " << flow->GetNBytes());
+    }
+    return item;
+}
+
+bool
+FqCoDelQueueDisc::CoDelOkToDrop(FqCoDelFlow* flow, Ptr<QueueDiscItem> item, uint32_t now)
+{
+    NS_LOG_FUNCTION(this << flow);
+    bool okToDrop;
+
+    if (!item)
+    {
+        flow->m_firstAboveTime = 0;
+        return false;
+    }
+
+    Time delta = Simulator::Now() - item->GetTimeStamp();
+    NS_LOG_INFO("Sojourn time " << delta.As(Time::MS));
+    uint32_t sojournTime = Time2CoDel(delta);
+
+    if (CoDelTimeBefore(sojournTime, m_codelTarget) || flow->GetNBytes() < m_minBytes)
+    {
+        // went below so we'll stay below for at least q->interval
+        NS_LOG_LOGIC("Sojourn time is below target or number of bytes in queue is less than "
+                     "minBytes; packet should not be dropped");
+        flow->m_firstAboveTime = 0;
+        return false;
+    }
+    okToDrop = false;
+    if (flow->m_firstAboveTime == 0)
+    {
+        /* just went above from below. If we stay above
+         * for at least q->interval we'll say it's ok to drop
+         */
+        NS_LOG_LOGIC("Sojourn time has just gone above target from below, need to stay above for "
+                     "at least q->interval before packet can be dropped. ");
+        flow->m_firstAboveTime = now + m_codelInterval;
+    }
+    else if (CoDelTimeAfter(now, flow->m_firstAboveTime))
+    {
+        NS_LOG_LOGIC("Sojourn time has been above target for at least q->interval; it's OK to "
+                     "(possibly) drop packet.");
+        okToDrop = true;
+    }
+    return okToDrop;
+}
+
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::CoDelDequeue(FqCoDelFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+
+    Ptr<QueueDiscItem> item = FlowDequeue(flow);
+    if (!item)
+    {
+        // Leave dropping state when queue is empty
+        flow->m_dropping = false;
+        NS_LOG_LOGIC("Queue empty");
+        return nullptr;
+    }
+    uint32_t ldelay = Time2CoDel(Simulator::Now() - item->GetTimeStamp());
+    if (m_useL4s)
+    {
+        uint8_t tosByte = 0;
+        if (item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
+            (((tosByte & 0x3) == 1) || (tosByte & 0x3) == 3))
+        {
+            if ((tosByte & 0x3) == 1)
+            {
+                NS_LOG_DEBUG("ECT1 packet " << static_cast<uint16_t>(tosByte & 0x3));
+            }
+            else
+            {
+                NS_LOG_DEBUG("CE packet " << static_cast<uint16_t>(tosByte & 0x3));
+            }
+
+            if (CoDelTimeAfter(ldelay, m_codelCeThreshold) &&
+                Mark(item, CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK))
+            {
+                NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
+                flow->NotifyMark(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK);
+            }
+            return item;
+        }
+    }
+
+    uint32_t now = CoDelGetTime();
+
+    // Determine if item should be dropped
+    bool okToDrop = CoDelOkToDrop(flow, item, now);
+    bool isMarked = false;
+
+    if (flow->m_dropping)
+    { // In the dropping state (sojourn time has gone above target and hasn't come down yet)
+        // Check if we can leave the dropping state or next drop should occur
+        NS_LOG_LOGIC("In dropping state, check if it's OK to leave or next drop should occur");
+        if (!okToDrop)
+        {
+            /* sojourn time fell below target - leave dropping state */
+            NS_LOG_LOGIC("Sojourn time goes below target, it's OK to leave dropping state.");
+            flow->m_dropping = false;
+        }
+        else if (CoDelTimeAfterEq(now, flow->m_dropNext))
+        {
+            while (flow->m_dropping && CoDelTimeAfterEq(now, flow->m_dropNext))
+            {
+                ++flow->m_count;
+                flow->m_recInvSqrt = CoDelQueueDisc::NewtonStep(flow->m_recInvSqrt, flow->m_count);
+                // It's time for the next drop. Drop the current packet and
+                // dequeue the next. The dequeue might take us out of dropping
+                // state. If not, schedule the next drop.
+                // A large amount of packets in queue might result in drop
+                // rates so high that the next drop should happen now,
+                // hence the while loop.
+                if (m_useEcn && Mark(item, CoDelQueueDisc::TARGET_EXCEEDED_MARK))
+                {
+                    isMarked = true;
+                    flow->NotifyMark(CoDelQueueDisc::TARGET_EXCEEDED_MARK);
+                    NS_LOG_LOGIC("Sojourn time is still above target and it's time for next drop "
+                                 "or mark; marking "
+                                 << item);
+                    flow->m_dropNext = CoDelQueueDisc::ControlLaw(now,
+                                                                  m_codelInterval,
+                                                                  flow->m_recInvSqrt);
+                    NS_LOG_LOGIC("Scheduled next drop at " << (double)flow->m_dropNext / 1000000);
+                    goto end;
+                }
+                NS_LOG_LOGIC(
+                    "Sojourn time is still above target and it's time for next drop; dropping "
+                    << item);
+                DropAfterDequeue(item, CoDelQueueDisc::TARGET_EXCEEDED_DROP);
+                flow->NotifyDrop(CoDelQueueDisc::TARGET_EXCEEDED_DROP);
+
+                item = FlowDequeue(flow);
+
+                if (!CoDelOkToDrop(flow, item, now))
+                {
+                    /* leave dropping state */
+                    NS_LOG_LOGIC("Leaving dropping state");
+                    flow->m_dropping = false;
+                }
+                else
+                {
+                    /* schedule the next drop */
+                    flow->m_dropNext = CoDelQueueDisc::ControlLaw(flow->m_dropNext,
+                                                                  m_codelInterval,
+                                                                  flow->m_recInvSqrt);
+                    NS_LOG_LOGIC("Scheduled next drop at " << (double)flow->m_dropNext / 1000000);
+                }
+            }
+        }
+    }
+    else
+    {
+        // Not in the dropping state
+        // Decide if we have to enter the dropping state and drop the first packet
+        NS_LOG_LOGIC("Not in dropping state; decide if we have to enter the state and drop the "
+                     "first packet");
+        if (okToDrop)
+        {
+            if (m_useEcn && Mark(item, CoDelQueueDisc::TARGET_EXCEEDED_MARK))
+            {
+                isMarked = true;
+                flow->NotifyMark(CoDelQueueDisc::TARGET_EXCEEDED_MARK);
+                NS_LOG_LOGIC("Sojourn time goes above target, marking the first packet "
+                             << item << " and entering the dropping state");
+            }
+            else
+            {
+                // Drop the first packet and enter dropping state unless the queue is empty
+                NS_LOG_LOGIC("Sojourn time goes above target, dropping the first packet "
+                             << item << " and entering the dropping state");
+                DropAfterDequeue(item, CoDelQueueDisc::TARGET_EXCEEDED_DROP);
+                flow->NotifyDrop(CoDelQueueDisc::TARGET_EXCEEDED_DROP);
+                item = FlowDequeue(flow);
+                CoDelOkToDrop(flow, item, now);
+            }
+            flow->m_dropping = true;
+            /*
+             * if min went above target close to when we last went below it
+             * assume that the drop rate that controlled the queue on the
+             * last cycle is a good starting point to control it now.
+             */
+            int delta = flow->m_count - flow->m_lastCount;
+            if (delta > 1 && CoDelTimeBefore(now - flow->m_dropNext, 16 * m_codelInterval))
+            {
+                flow->m_count = delta;
+                flow->m_recInvSqrt = CoDelQueueDisc::NewtonStep(flow->m_recInvSqrt, flow->m_count);
+            }
+            else
+            {
+                flow->m_count = 1;
+                flow->m_recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
+            }
+            flow->m_lastCount = flow->m_count;
+            flow->m_dropNext =
+                CoDelQueueDisc::ControlLaw(now, m_codelInterval, flow->m_recInvSqrt);
+            NS_LOG_LOGIC("Scheduled next drop at " << (double)flow->m_dropNext / 1000000 << " now "
+                                                   << (double)now / 1000000);
+        }
+    }
+end:
+    // In Linux, this branch of code is executed even if the packet has been marked
+    // according to the target delay above. The isMarked flag suppresses a second
+    // attempt at marking, which would result in two counts of mark in the statistics.
+    if (!isMarked && item && !m_useL4s && m_useEcn &&
+        CoDelTimeAfter(Time2CoDel(Simulator::Now() - item->GetTimeStamp()), m_codelCeThreshold) &&
+        Mark(item, CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK))
+    {
+        NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
+        flow->NotifyMark(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK);
+    }
+    return item;
+}
+
 } // namespace ns3
@@ -10,12 +10,11 @@
 #ifndef FQ_CODEL_QUEUE_DISC
 #define FQ_CODEL_QUEUE_DISC
 
+#include "codel-queue-disc.h"
+#include "fq-flow.h"
 #include "queue-disc.h"
 
-#include "ns3/object-factory.h"
-
-#include <list>
-#include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -24,74 +23,29 @@ namespace ns3
  * \ingroup traffic-control
  *
  * \brief A flow queue used by the FqCoDel queue disc
+ *
+ * The flow holds the state of the CoDel algorithm run by the FqCoDel queue
+ * disc on the packets of the flow.
  */
 
-class FqCoDelFlow : public QueueDiscClass
+class FqCoDelFlow : public FqFlow
 {
   public:
     /**
-     * \brief Get the type ID.
-     * \return the object TypeId
-     */
-    static TypeId GetTypeId();
-    /**
-     * \brief FqCoDelFlow constructor
-     */
-    FqCoDelFlow();
-
-    ~FqCoDelFlow() override;
-
-    /**
-     * \enum FlowStatus
-     * \brief Used to determine the status of this flow queue
-     */
-    enum FlowStatus
-    {
-        INACTIVE,
-        NEW_FLOW,
-        OLD_FLOW
-    };
-
-    /**
-     * \brief Set the deficit for this flow
-     * \param deficit the deficit for this flow
-     */
-    void SetDeficit(uint32_t deficit);
-    /**
-     * \brief Get the deficit for this flow
-     * \return the deficit for this flow
-     */
-    int32_t GetDeficit() const;
-    /**
-     * \brief Increase the deficit for this flow
-     * \param deficit the amount by which the deficit is to be increased
-     */
-    void IncreaseDeficit(int32_t deficit);
-    /**
-     * \brief Set the status for this flow
-     * \param status the status for this flow
-     */
-    void SetStatus(FlowStatus status);
-    /**
-     * \brief Get the status of this flow
-     * \return the status of this flow
-     */
-    FlowStatus GetStatus() const;
-    /**
-     * \brief Set the index for this flow
-     * \param index the index for this flow
+     * \brief Get the time for next packet drop while in the dropping state
+     * \return the time for next packet drop, in CoDel time units
      */
-    void SetIndex(uint32_t index);
-    /**
-     * \brief Get the index of this flow
-     * \return the index of this flow
-     */
-    uint32_t GetIndex() const;
+    uint32_t GetDropNext() const;
 
   private:
-    int32_t m_deficit;   //!< the deficit for this flow
-    FlowStatus m_status; //!< the status of this flow
-    uint32_t m_index;    //!< the index for this flow
+    friend class FqCoDelQueueDisc;
+
+    uint32_t m_count{0};                              //!< Packets dropped since entering drop state
+    uint32_t m_lastCount{0};                          //!< Count at the last entry in drop state
+    bool m_dropping{false};                           //!< True if in dropping state
+    uint16_t m_recInvSqrt{~0U >> REC_INV_SQRT_SHIFT}; //!< Reciprocal inverse square root
+    uint32_t m_firstAboveTime{0};                     //!< Time to declare sojourn time above target
+    uint32_t m_dropNext{0};                           //!< Time to drop next packet
 };
 
 /**
@@ -131,12 +85,26 @@ class FqCoDelQueueDisc : public QueueDisc
      */
     uint32_t GetQuantum() const;
 
+    /**
+     * \brief Get the number of flow queues that received packets
+     * \return the number of flow queues that received packets
+     */
+    std::size_t GetNFlows() const;
+
+    /**
+     * \brief Get a flow queue that received packets
+     * \param i the index of the flow queue, in the order of their first packet
+     * \return the flow queue
+     */
+    const FqCoDelFlow* GetFlow(std::size_t i) const;
+
     // Reasons for dropping packets
     static constexpr const char* UNCLASSIFIED_DROP =
         "Unclassified drop"; //!< No packet filter able to classify packet
     static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Overlimit dropped packets
 
   private:
+    void DoDispose() override;
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
     Ptr<QueueDiscItem> DoDequeue() override;
     bool CheckConfig() override;
@@ -148,6 +116,29 @@ class FqCoDelQueueDisc : public QueueDisc
      */
     uint32_t FqCoDelDrop();
 
+    /**
+     * \brief Dequeue a packet from a flow, according to the CoDel algorithm
+     * \param flow the flow
+     * \return the packet, or a null pointer if the flow is empty
+     */
+    Ptr<QueueDiscItem> CoDelDequeue(FqCoDelFlow* flow);
+
+    /**
+     * \brief Determine whether a packet dequeued from a flow is OK to be dropped
+     * \param flow the flow
+     * \param item the packet
+     * \param now the current time in CoDel time units
+     * \return true if the sojourn time is above target for at least interval
+     */
+    bool CoDelOkToDrop(FqCoDelFlow* flow, Ptr<QueueDiscItem> item, uint32_t now);
+
+    /**
+     * \brief Dequeue a packet from a flow and notify the dequeue
+     * \param flow the flow
+     * \return the packet, or a null pointer if the flow is empty
+     */
+    Ptr<QueueDiscItem> FlowDequeue(FqCoDelFlow* flow);
+
     bool m_useEcn; //!< True if ECN is used (packets are marked instead of being dropped)
     /**
      * Compute the index of the queue for the flow having the given flowHash,
@@ -160,6 +151,10 @@ class FqCoDelQueueDisc : public QueueDisc
 
     std::string m_interval;          //!< CoDel interval attribute
     std::string m_target;            //!< CoDel target attribute
+    uint32_t m_minBytes;             //!< Minimum bytes in a flow to allow a packet drop
+    uint32_t m_codelInterval;        //!< CoDel interval, in CoDel time units
+    uint32_t m_codelTarget;          //!< CoDel target, in CoDel time units
+    uint32_t m_codelCeThreshold;     //!< CE threshold, in CoDel time units
     uint32_t m_quantum;              //!< Deficit assigned to flows at each round
     uint32_t m_flows;                //!< Number of flow queues
     uint32_t m_setWays;              //!< size of a set of queues (used by set associative hash)
@@ -169,14 +164,13 @@ class FqCoDelQueueDisc : public QueueDisc
     bool m_enableSetAssociativeHash; //!< whether to enable set associative hash
     bool m_useL4s; //!< True if L4S is used (ECT1 packets are marked at CE threshold)
 
-    std::list<Ptr<FqCoDelFlow>> m_newFlows; //!< The list of new flows
-    std::list<Ptr<FqCoDelFlow>> m_oldFlows; //!< The list of old flows
-
-    std::map<uint32_t, uint32_t> m_flowsIndices; //!< Map with the index of class for each flow
-    std::map<uint32_t, uint32_t> m_tags;         //!< Tags used by set associative hash
+    FqFlowList<FqCoDelFlow> m_newFlows; //!< The list of new flows
+    FqFlowList<FqCoDelFlow> m_oldFlows; //!< The list of old flows
 
-    ObjectFactory m_flowFactory;      //!< Factory to create a new flow
-    ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
+    std::vector<FqCoDelFlow> m_flowTable; //!< The flow queue of each index
+    std::vector<FqCoDelFlow*> m_flowList; //!< The flow queues that received packets
+    std::vector<uint32_t> m_tags;         //!< Tags used by set associative hash
+    FqItemPool m_itemPool;                //!< The packets of the flow queues
 };
 
 } // namespace ns3
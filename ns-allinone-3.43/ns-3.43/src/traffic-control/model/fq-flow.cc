@@ -0,0 +1,229 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "fq-flow.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FqFlow");
+
+void
+FqItemPool::PushBack(FqFlow* flow, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << flow << item);
+
+    uint32_t slot = m_free;
+    if (slot == NO_SLOT)
+    {
+        slot = m_slots.size();
+        m_slots.push_back({nullptr, NO_SLOT});
+    }
+    else
+    {
+        m_free = m_slots[slot].next;
+    }
+
+    m_slots[slot].next = NO_SLOT;
+    if (flow->m_tail == NO_SLOT)
+    {
+        flow->m_head = slot;
+    }
+    else
+    {
+        m_slots[flow->m_tail].next = slot;
+    }
+    flow->m_tail = slot;
+    flow->m_nPackets++;
+    flow->m_nBytes += item->GetSize();
+    m_slots[slot].item = item;
+}
+
+Ptr<QueueDiscItem>
+FqItemPool::PopFront(FqFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+
+    uint32_t slot = flow->m_head;
+    if (slot == NO_SLOT)
+    {
+        return nullptr;
+    }
+
+    Ptr<QueueDiscItem> item = m_slots[slot].item;
+    m_slots[slot].item = nullptr;
+    flow->m_head = m_slots[slot].next;
+    if (flow->m_head == NO_SLOT)
+    {
+        flow->m_tail = NO_SLOT;
+    }
+    flow->m_nPackets--;
+    flow->m_nBytes -= item->GetSize();
+
+    m_slots[slot].next = m_free;
+    m_free = slot;
+    return item;
+}
+
+Ptr<const QueueDiscItem>
+FqItemPool::Front(const FqFlow* flow) const
+{
+    if (flow->m_head == NO_SLOT)
+    {
+        return nullptr;
+    }
+    return m_slots[flow->m_head].item;
+}
+
+void
+FqItemPool::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    m_slots.clear();
+    m_free = NO_SLOT;
+}
+
+void
+FqFlow::SetDeficit(uint32_t deficit)
+{
+    NS_LOG_FUNCTION(this << deficit);
+    m_deficit = deficit;
+}
+
+int32_t
+FqFlow::GetDeficit() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_deficit;
+}
+
+void
+FqFlow::IncreaseDeficit(int32_t deficit)
+{
+    NS_LOG_FUNCTION(this << deficit);
+    m_deficit += deficit;
+}
+
+void
+FqFlow::SetStatus(FlowStatus status)
+{
+    NS_LOG_FUNCTION(this);
+    m_status = status;
+}
+
+FqFlow::FlowStatus
+FqFlow::GetStatus() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_status;
+}
+
+void
+FqFlow::SetIndex(uint32_t index)
+{
+    NS_LOG_FUNCTION(this);
+    m_index = index;
+}
+
+uint32_t
+FqFlow::GetIndex() const
+{
+    return m_index;
+}
+
+void
+FqFlow::SetNext(FqFlow* next)
+{
+    m_next = next;
+}
+
+FqFlow*
+FqFlow::GetNext() const
+{
+    return m_next;
+}
+
+void
+FqFlow::SetItemPool(FqItemPool* pool)
+{
+    m_pool = pool;
+}
+
+void
+FqFlow::SetUsed()
+{
+    m_used = true;
+}
+
+bool
+FqFlow::IsUsed() const
+{
+    return m_used;
+}
+
+void
+FqFlow::Enqueue(Ptr<QueueDiscItem> item)
+{
+    m_pool->PushBack(this, item);
+}
+
+Ptr<QueueDiscItem>
+FqFlow::Dequeue()
+{
+    return m_pool->PopFront(this);
+}
+
+Ptr<const QueueDiscItem>
+FqFlow::Peek() const
+{
+    return m_pool->Front(this);
+}
+
+uint32_t
+FqFlow::GetNPackets() const
+{
+    return m_nPackets;
+}
+
+uint32_t
+FqFlow::GetNBytes() const
+{
+    return m_nBytes;
+}
+
+QueueSize
+FqFlow::GetCurrentSize(QueueSizeUnit unit) const
+{
+    return QueueSize(unit, unit == QueueSizeUnit::PACKETS ? m_nPackets : m_nBytes);
+}
+
+void
+FqFlow::NotifyDrop(const char* reason)
+{
+    m_nDroppedPackets[reason]++;
+}
+
+void
+FqFlow::NotifyMark(const char* reason)
+{
+    m_nMarkedPackets[reason]++;
+}
+
+uint32_t
+FqFlow::GetNDroppedPackets(std::string reason) const
+{
+    auto it = m_nDroppedPackets.find(reason);
+    return it != m_nDroppedPackets.end() ? it->second : 0;
+}
+
+uint32_t
+FqFlow::GetNMarkedPackets(std::string reason) const
+{
+    auto it = m_nMarkedPackets.find(reason);
+    return it != m_nMarkedPackets.end() ? it->second : 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,313 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef FQ_FLOW_H
+#define FQ_FLOW_H
+
+#include "queue-disc.h"
+
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup traffic-control
+ * ns3::FqFlow, ns3::FqItemPool and ns3::FqFlowList declarations.
+ */
+
+namespace ns3
+{
+
+class FqFlow;
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The packets queued in the flows of a flow queueing discipline.
+ *
+ * The packets of all the flows of a queue disc are stored in a single array
+ * of slots, each flow being a linked list of slots. The slots released by
+ * the dequeued packets are reused, hence the array only grows up to the
+ * largest number of packets ever held by the queue disc, and enqueuing or
+ * dequeuing a packet does not allocate memory afterwards.
+ */
+class FqItemPool
+{
+  public:
+    /**
+     * Append a packet to the tail of a flow.
+     * \param flow the flow
+     * \param item the packet
+     */
+    void PushBack(FqFlow* flow, Ptr<QueueDiscItem> item);
+
+    /**
+     * Remove the packet at the head of a flow.
+     * \param flow the flow
+     * \return the packet, or a null pointer if the flow is empty
+     */
+    Ptr<QueueDiscItem> PopFront(FqFlow* flow);
+
+    /**
+     * Get the packet at the head of a flow.
+     * \param flow the flow
+     * \return the packet, or a null pointer if the flow is empty
+     */
+    Ptr<const QueueDiscItem> Front(const FqFlow* flow) const;
+
+    /// Release all the slots and the packets they hold
+    void Clear();
+
+    /// Index of no slot
+    static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+  private:
+    /// A slot holding a packet of a flow
+    struct Slot
+    {
+        Ptr<QueueDiscItem> item; //!< the packet
+        uint32_t next;           //!< the next slot of the flow, or of the free slots
+    };
+
+    std::vector<Slot> m_slots; //!< the slots
+    uint32_t m_free{NO_SLOT};  //!< the first free slot
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A flow queue of a flow queueing discipline.
+ *
+ * A flow holds the state of the deficit round robin scheduler and the list
+ * of its packets, stored in the FqItemPool of the queue disc. The flows are
+ * entries of a flat table owned by the queue disc and are not objects: the
+ * queue discs derive from this class to add the state of the AQM algorithm
+ * run on each flow (e.g., FqCoDelFlow), and count the packets dropped or
+ * marked by such algorithm in the flow.
+ */
+class FqFlow
+{
+  public:
+    /**
+     * \enum FlowStatus
+     * \brief Used to determine the status of this flow queue
+     */
+    enum FlowStatus
+    {
+        INACTIVE,
+        NEW_FLOW,
+        OLD_FLOW
+    };
+
+    /**
+     * \brief Set the deficit for this flow
+     * \param deficit the deficit for this flow
+     */
+    void SetDeficit(uint32_t deficit);
+    /**
+     * \brief Get the deficit for this flow
+     * \return the deficit for this flow
+     */
+    int32_t GetDeficit() const;
+    /**
+     * \brief Increase the deficit for this flow
+     * \param deficit the amount by which the deficit is to be increased
+     */
+    void IncreaseDeficit(int32_t deficit);
+    /**
+     * \brief Set the status for this flow
+     * \param status the status for this flow
+     */
+    void SetStatus(FlowStatus status);
+    /**
+     * \brief Get the status of this flow
+     * \return the status of this flow
+     */
+    FlowStatus GetStatus() const;
+    /**
+     * \brief Set the index for this flow
+     * \param index the index for this flow
+     */
+    void SetIndex(uint32_t index);
+    /**
+     * \brief Get the index of this flow
+     * \return the index of this flow
+     */
+    uint32_t GetIndex() const;
+    /**
+     * \brief Set the flow following this one in the list of new or old flows
+     * \param next the next flow
+     */
+    void SetNext(FqFlow* next);
+    /**
+     * \brief Get the flow following this one in the list of new or old flows
+     * \return the next flow
+     */
+    FqFlow* GetNext() const;
+
+    /**
+     * \brief Set the pool storing the packets of this flow
+     * \param pool the pool of the queue disc
+     */
+    void SetItemPool(FqItemPool* pool);
+    /**
+     * \brief Mark this flow as used, once it has received its first packet
+     */
+    void SetUsed();
+    /**
+     * \brief Check whether this flow has ever received a packet
+     * \return true if this flow has been used
+     */
+    bool IsUsed() const;
+
+    /**
+     * \brief Append a packet to this flow
+     * \param item the packet
+     */
+    void Enqueue(Ptr<QueueDiscItem> item);
+    /**
+     * \brief Remove the packet at the head of this flow
+     * \return the packet, or a null pointer if this flow is empty
+     */
+    Ptr<QueueDiscItem> Dequeue();
+    /**
+     * \brief Get the packet at the head of this flow
+     * \return the packet, or a null pointer if this flow is empty
+     */
+    Ptr<const QueueDiscItem> Peek() const;
+    /**
+     * \brief Get the number of packets in this flow
+     * \return the number of packets in this flow
+     */
+    uint32_t GetNPackets() const;
+    /**
+     * \brief Get the number of bytes in this flow
+     * \return the number of bytes in this flow
+     */
+    uint32_t GetNBytes() const;
+    /**
+     * \brief Get the current size of this flow, in the unit of the given size
+     * \param unit the unit
+     * \return the current size of this flow
+     */
+    QueueSize GetCurrentSize(QueueSizeUnit unit) const;
+
+    /**
+     * \brief Count a packet of this flow dropped for the given reason
+     * \param reason the reason why the packet was dropped
+     */
+    void NotifyDrop(const char* reason);
+    /**
+     * \brief Count a packet of this flow marked for the given reason
+     * \param reason the reason why the packet was marked
+     */
+    void NotifyMark(const char* reason);
+    /**
+     * \brief Get the number of packets of this flow dropped for the given reason
+     * \param reason the reason why packets were dropped
+     * \return the number of packets dropped for the given reason
+     */
+    uint32_t GetNDroppedPackets(std::string reason) const;
+    /**
+     * \brief Get the number of packets of this flow marked for the given reason
+     * \param reason the reason why packets were marked
+     * \return the number of packets marked for the given reason
+     */
+    uint32_t GetNMarkedPackets(std::string reason) const;
+
+  private:
+    friend class FqItemPool;
+
+    int32_t m_deficit{0};                              //!< the deficit for this flow
+    FlowStatus m_status{INACTIVE};                     //!< the status of this flow
+    uint32_t m_index{0};                               //!< the index for this flow
+    bool m_used{false};                                //!< whether this flow has received packets
+    FqFlow* m_next{nullptr};                           //!< the next flow in its list of flows
+    FqItemPool* m_pool{nullptr};                       //!< the pool storing the packets
+    uint32_t m_head{FqItemPool::NO_SLOT};              //!< the slot of the first packet
+    uint32_t m_tail{FqItemPool::NO_SLOT};              //!< the slot of the last packet
+    uint32_t m_nPackets{0};                            //!< the number of packets
+    uint32_t m_nBytes{0};                              //!< the number of bytes
+    std::map<std::string, uint32_t> m_nDroppedPackets; //!< dropped packets, for each reason
+    std::map<std::string, uint32_t> m_nMarkedPackets;  //!< marked packets, for each reason
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief An intrusive FIFO list of flow queues, used by the flow queueing
+ * disciplines for their lists of new and old flows.
+ *
+ * The flows are linked through their own next pointer, accessed with
+ * SetNext and GetNext, so that moving a flow between the lists never
+ * allocates memory. A flow belongs to at most one list at a time. The list
+ * does not own the flows, which are owned by the flow table of the queue disc.
+ *
+ * \tparam Flow \explicit the type of the flow queues, derived from FqFlow
+ */
+template <typename Flow>
+class FqFlowList
+{
+  public:
+    /// \return true if the list is empty
+    bool IsEmpty() const
+    {
+        return m_head == nullptr;
+    }
+
+    /// \return the flow at the head of the list, which must not be empty
+    Flow* Front() const
+    {
+        return m_head;
+    }
+
+    /**
+     * Append a flow to the list.
+     * \param flow the flow, which must not belong to a list
+     */
+    void PushBack(Flow* flow)
+    {
+        flow->SetNext(nullptr);
+        if (m_tail)
+        {
+            m_tail->SetNext(flow);
+        }
+        else
+        {
+            m_head = flow;
+        }
+        m_tail = flow;
+    }
+
+    /// Remove the flow at the head of the list, which must not be empty
+    void PopFront()
+    {
+        Flow* flow = m_head;
+        m_head = static_cast<Flow*>(flow->GetNext());
+        if (!m_head)
+        {
+            m_tail = nullptr;
+        }
+        flow->SetNext(nullptr);
+    }
+
+    /// Remove all the flows from the list
+    void Clear()
+    {
+        while (m_head)
+        {
+            PopFront();
+        }
+    }
+
+  private:
+    Flow* m_head{nullptr}; //!< first flow of the list
+    Flow* m_tail{nullptr}; //!< last flow of the list
+};
+
+} // namespace ns3
+
+#endif /* FQ_FLOW_H */
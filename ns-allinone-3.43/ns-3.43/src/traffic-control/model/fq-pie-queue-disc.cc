@@ -14,11 +14,9 @@
 
 #include "fq-pie-queue-disc.h"
 
-#include "pie-queue-disc.h"
-
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
-#include "ns3/queue.h"
+#include "ns3/simulator.h"
 #include "ns3/string.h"
 
 namespace ns3
@@ -26,77 +24,22 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("FqPieQueueDisc");
 
-NS_OBJECT_ENSURE_REGISTERED(FqPieFlow);
-
-TypeId
-FqPieFlow::GetTypeId()
-{
-    static TypeId tid = TypeId("ns3::FqPieFlow")
-                            .SetParent<QueueDiscClass>()
-                            .SetGroupName("TrafficControl")
-                            .AddConstructor<FqPieFlow>();
-    return tid;
-}
-
 FqPieFlow::FqPieFlow()
-    : m_deficit(0),
-      m_status(INACTIVE),
-      m_index(0)
+    : m_burstState(PieQueueDisc::NO_BURST),
+      m_dqCount(std::numeric_limits<uint64_t>::max())
 {
-    NS_LOG_FUNCTION(this);
 }
 
-FqPieFlow::~FqPieFlow()
+Time
+FqPieFlow::GetQueueDelay() const
 {
-    NS_LOG_FUNCTION(this);
+    return m_qDelay;
 }
 
-void
-FqPieFlow::SetDeficit(uint32_t deficit)
+double
+FqPieFlow::GetDropProbability() const
 {
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit = deficit;
-}
-
-int32_t
-FqPieFlow::GetDeficit() const
-{
-    NS_LOG_FUNCTION(this);
-    return m_deficit;
-}
-
-void
-FqPieFlow::IncreaseDeficit(int32_t deficit)
-{
-    NS_LOG_FUNCTION(this << deficit);
-    m_deficit += deficit;
-}
-
-void
-FqPieFlow::SetStatus(FlowStatus status)
-{
-    NS_LOG_FUNCTION(this);
-    m_status = status;
-}
-
-FqPieFlow::FlowStatus
-FqPieFlow::GetStatus() const
-{
-    NS_LOG_FUNCTION(this);
-    return m_status;
-}
-
-void
-FqPieFlow::SetIndex(uint32_t index)
-{
-    NS_LOG_FUNCTION(this);
-    m_index = index;
-}
-
-uint32_t
-FqPieFlow::GetIndex() const
-{
-    return m_index;
+    return m_dropProb;
 }
 
 NS_OBJECT_ENSURE_REGISTERED(FqPieQueueDisc);
@@ -189,6 +132,12 @@ FqPieQueueDisc::GetTypeId()
                           BooleanValue(false),
                           MakeBooleanAccessor(&FqPieQueueDisc::m_useDerandomization),
                           MakeBooleanChecker())
+            .AddAttribute("UseLazyUpdate",
+                          "Update the drop probability of a flow at enqueue and dequeue time, "
+                          "instead of scheduling an update event every Tupdate",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FqPieQueueDisc::m_useLazyUpdate),
+                          MakeBooleanChecker())
             .AddAttribute("Flows",
                           "The number of queues into which the incoming packets are classified",
                           UintegerValue(1024),
@@ -243,6 +192,19 @@ FqPieQueueDisc::GetQuantum() const
     return m_quantum;
 }
 
+std::size_t
+FqPieQueueDisc::GetNFlows() const
+{
+    return m_flowList.size();
+}
+
+const FqPieFlow*
+FqPieQueueDisc::GetFlow(std::size_t i) const
+{
+    NS_ASSERT_MSG(i < m_flowList.size(), "Flow queue index out of range");
+    return m_flowList[i];
+}
+
 uint32_t
 FqPieQueueDisc::SetAssociativeHash(uint32_t flowHash)
 {
@@ -254,15 +216,10 @@ FqPieQueueDisc::SetAssociativeHash(uint32_t flowHash)
 
     for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
     {
-        auto it = m_flowsIndices.find(i);
-
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqPieFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
-                FqPieFlow::INACTIVE)
+        if (m_tags[i] == flowHash || m_flowTable[i].GetStatus() == FqPieFlow::INACTIVE)
         {
-            // this queue has not been created yet or is associated with this flow
-            // or is inactive, hence we can use it
+            // this queue is associated with this flow or is inactive (e.g., it
+            // has not been used yet), hence we can use it
             m_tags[i] = flowHash;
             return i;
         }
@@ -273,6 +230,24 @@ FqPieQueueDisc::SetAssociativeHash(uint32_t flowHash)
     return outerHash;
 }
 
+void
+FqPieQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_newFlows.Clear();
+    m_oldFlows.Clear();
+    for (auto flow : m_flowList)
+    {
+        flow->m_rtrsEvent.Cancel();
+        flow->m_uv = nullptr;
+    }
+    m_flowList.clear();
+    m_flowTable.clear();
+    m_tags.clear();
+    m_itemPool.Clear();
+    QueueDisc::DoDispose();
+}
+
 bool
 FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
@@ -310,42 +285,28 @@ FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         h = flowHash % m_flows;
     }
 
-    Ptr<FqPieFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
-    {
-        NS_LOG_DEBUG("Creating a new flow queue with index " << h);
-        flow = m_flowFactory.Create<FqPieFlow>();
-        Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc>();
-        // If Pie, Set values of PieQueueDisc to match this QueueDisc
-        Ptr<PieQueueDisc> pie = qd->GetObject<PieQueueDisc>();
-        if (pie)
-        {
-            pie->SetAttribute("UseEcn", BooleanValue(m_useEcn));
-            pie->SetAttribute("CeThreshold", TimeValue(m_ceThreshold));
-            pie->SetAttribute("UseL4s", BooleanValue(m_useL4s));
-        }
-        qd->Initialize();
-        flow->SetQueueDisc(qd);
-        flow->SetIndex(h);
-        AddQueueDiscClass(flow);
-
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
-    }
-    else
+    FqPieFlow* flow = &m_flowTable[h];
+    if (!flow->IsUsed())
     {
-        flow = StaticCast<FqPieFlow>(GetQueueDiscClass(m_flowsIndices[h]));
+        NS_LOG_DEBUG("Using the flow queue with index " << h);
+        flow->SetUsed();
+        m_flowList.push_back(flow);
+        PieStart(flow);
     }
 
     if (flow->GetStatus() == FqPieFlow::INACTIVE)
     {
         flow->SetStatus(FqPieFlow::NEW_FLOW);
         flow->SetDeficit(m_quantum);
-        m_newFlows.push_back(flow);
+        m_newFlows.PushBack(flow);
     }
 
-    flow->GetQueueDisc()->Enqueue(item);
+    if (!PieEnqueue(flow, item))
+    {
+        return false;
+    }
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    NS_LOG_DEBUG("Packet enqueued into flow " << h);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -361,24 +322,24 @@ FqPieQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<FqPieFlow> flow;
+    FqPieFlow* flow = nullptr;
     Ptr<QueueDiscItem> item;
 
     do
     {
         bool found = false;
 
-        while (!found && !m_newFlows.empty())
+        while (!found && !m_newFlows.IsEmpty())
         {
-            flow = m_newFlows.front();
+            flow = m_newFlows.Front();
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
                 flow->SetStatus(FqPieFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_newFlows.PopFront();
+                m_oldFlows.PushBack(flow);
             }
             else
             {
@@ -387,16 +348,16 @@ FqPieQueueDisc::DoDequeue()
             }
         }
 
-        while (!found && !m_oldFlows.empty())
+        while (!found && !m_oldFlows.IsEmpty())
         {
-            flow = m_oldFlows.front();
+            flow = m_oldFlows.Front();
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
-                m_oldFlows.push_back(flow);
-                m_oldFlows.pop_front();
+                m_oldFlows.PopFront();
+                m_oldFlows.PushBack(flow);
             }
             else
             {
@@ -411,21 +372,21 @@ FqPieQueueDisc::DoDequeue()
             return nullptr;
         }
 
-        item = flow->GetQueueDisc()->Dequeue();
+        item = PieDequeue(flow);
 
         if (!item)
         {
             NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
-            if (!m_newFlows.empty())
+            if (!m_newFlows.IsEmpty())
             {
                 flow->SetStatus(FqPieFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_newFlows.PopFront();
+                m_oldFlows.PushBack(flow);
             }
             else
             {
                 flow->SetStatus(FqPieFlow::INACTIVE);
-                m_oldFlows.pop_front();
+                m_oldFlows.PopFront();
             }
         }
         else
@@ -499,21 +460,16 @@ FqPieQueueDisc::InitializeParams()
 {
     NS_LOG_FUNCTION(this);
 
-    m_flowFactory.SetTypeId("ns3::FqPieFlow");
-
-    m_queueDiscFactory.SetTypeId("ns3::PieQueueDisc");
-    m_queueDiscFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
-    m_queueDiscFactory.Set("MeanPktSize", UintegerValue(m_meanPktSize));
-    m_queueDiscFactory.Set("A", DoubleValue(m_a));
-    m_queueDiscFactory.Set("B", DoubleValue(m_b));
-    m_queueDiscFactory.Set("Tupdate", TimeValue(m_tUpdate));
-    m_queueDiscFactory.Set("Supdate", TimeValue(m_sUpdate));
-    m_queueDiscFactory.Set("DequeueThreshold", UintegerValue(m_dqThreshold));
-    m_queueDiscFactory.Set("QueueDelayReference", TimeValue(m_qDelayRef));
-    m_queueDiscFactory.Set("MaxBurstAllowance", TimeValue(m_maxBurst));
-    m_queueDiscFactory.Set("UseDequeueRateEstimator", BooleanValue(m_useDqRateEstimator));
-    m_queueDiscFactory.Set("UseCapDropAdjustment", BooleanValue(m_isCapDropAdjustment));
-    m_queueDiscFactory.Set("UseDerandomization", BooleanValue(m_useDerandomization));
+    m_flowTable.assign(m_flows, FqPieFlow());
+    m_flowList.clear();
+    m_flowList.reserve(m_flows);
+    m_tags.assign(m_flows, 0);
+
+    for (uint32_t i = 0; i < m_flows; i++)
+    {
+        m_flowTable[i].SetIndex(i);
+        m_flowTable[i].SetItemPool(&m_itemPool);
+    }
 }
 
 uint32_t
@@ -523,13 +479,11 @@ FqPieQueueDisc::FqPieDrop()
 
     uint32_t maxBacklog = 0;
     uint32_t index = 0;
-    Ptr<QueueDisc> qd;
 
     /* Queue is full! Find the fat flow and drop packet(s) from it */
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
+    for (uint32_t i = 0; i < m_flowList.size(); i++)
     {
-        qd = GetQueueDiscClass(i)->GetQueueDisc();
-        uint32_t bytes = qd->GetNBytes();
+        uint32_t bytes = m_flowList[i]->GetNBytes();
         if (bytes > maxBacklog)
         {
             maxBacklog = bytes;
@@ -541,19 +495,197 @@ FqPieQueueDisc::FqPieDrop()
     uint32_t len = 0;
     uint32_t count = 0;
     uint32_t threshold = maxBacklog >> 1;
-    qd = GetQueueDiscClass(index)->GetQueueDisc();
+    FqPieFlow* flow = m_flowList[index];
     Ptr<QueueDiscItem> item;
 
     do
     {
         NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
                                                        << " threshold: " << threshold);
-        item = qd->GetInternalQueue(0)->Dequeue();
+        item = FlowDequeue(flow);
         DropAfterDequeue(item, OVERLIMIT_DROP);
+        flow->NotifyDrop(OVERLIMIT_DROP);
         len += item->GetSize();
     } while (++count < m_dropBatchSize && len < threshold);
 
     return index;
 }
 
+Ptr<QueueDiscItem>
+FqPieQueueDisc::FlowDequeue(FqPieFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+
+    Ptr<QueueDiscItem> item = flow->Dequeue();
+    if (item)
+    {
+        PacketDequeued(item);
+        NS_LOG_LOGIC("Popped " << item);
+        NS_LOG_LOGIC("Number packets remaining " << flow->GetNPackets());
+        NS_LOG_LOGIC("Number bytes remaining " << flow->GetNBytes());
+    }
+    return item;
+}
+
+void
+FqPieQueueDisc::PieStart(FqPieFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+
+    flow->m_uv = CreateObject<UniformRandomVariable>();
+    if (m_useLazyUpdate)
+    {
+        // the updates are run at enqueue and dequeue time
+        flow->m_nextUpdate = Now() + m_sUpdate;
+    }
+    else
+    {
+        flow->m_rtrsEvent =
+            Simulator::Schedule(m_sUpdate, &FqPieQueueDisc::CalculateP, this, flow);
+    }
+}
+
+bool
+FqPieQueueDisc::PieEnqueue(FqPieFlow* flow, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << flow << item);
+
+    if (m_useLazyUpdate)
+    {
+        PieQueueDisc::RunDueUpdates(GetPieParams(), *flow, flow->GetNBytes());
+    }
+
+    QueueSize nQueued = flow->GetCurrentSize(GetMaxSize().GetUnit());
+    // If L4S is enabled, then check if the packet is ECT1, and if it is then set isEct true
+    bool isEct1 = false;
+    if (m_useL4s)
+    {
+        uint8_t tosByte = 0;
+        if (item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
+            (((tosByte & 0x3) == 1) || (tosByte & 0x3) == 3))
+        {
+            if ((tosByte & 0x3) == 1)
+            {
+                NS_LOG_DEBUG("Enqueueing ECT1 packet " << static_cast<uint16_t>(tosByte & 0x3));
+            }
+            else
+            {
+                NS_LOG_DEBUG("Enqueueing CE packet " << static_cast<uint16_t>(tosByte & 0x3));
+            }
+            isEct1 = true;
+        }
+    }
+
+    if (nQueued + item > GetMaxSize())
+    {
+        // Drops due to queue limit: reactive
+        DropBeforeEnqueue(item, PieQueueDisc::FORCED_DROP);
+        flow->NotifyDrop(PieQueueDisc::FORCED_DROP);
+        flow->m_accuProb = 0;
+        return false;
+    }
+    // isEct1 will be true only if L4S enabled as well as the packet is ECT1.
+    // If L4S is enabled and packet is ECT1 then directly enqueue the packet.
+    else if (!isEct1 && PieQueueDisc::ShouldDropEarly(GetPieParams(),
+                                                      *flow,
+                                                      item->GetSize(),
+                                                      nQueued.GetValue()))
+    {
+        if (!m_useEcn || flow->m_dropProb >= m_markEcnTh ||
+            !Mark(item, PieQueueDisc::UNFORCED_MARK))
+        {
+            // Early probability drop: proactive
+            DropBeforeEnqueue(item, PieQueueDisc::UNFORCED_DROP);
+            flow->NotifyDrop(PieQueueDisc::UNFORCED_DROP);
+            flow->m_accuProb = 0;
+            return false;
+        }
+        flow->NotifyMark(PieQueueDisc::UNFORCED_MARK);
+    }
+
+    // No drop
+    flow->Enqueue(item);
+    PacketEnqueued(item);
+
+    NS_LOG_LOGIC("\t bytesInQueue  " << flow->GetNBytes());
+    NS_LOG_LOGIC("\t packetsInQueue  " << flow->GetNPackets());
+
+    return true;
+}
+
+Ptr<QueueDiscItem>
+FqPieQueueDisc::PieDequeue(FqPieFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+
+    if (m_useLazyUpdate)
+    {
+        PieQueueDisc::RunDueUpdates(GetPieParams(), *flow, flow->GetNBytes());
+    }
+
+    Ptr<QueueDiscItem> item = FlowDequeue(flow);
+    if (!item)
+    {
+        NS_LOG_LOGIC("Queue empty");
+        return nullptr;
+    }
+
+    // If L4S is enabled and packet is ECT1, then check if delay is greater
+    // than CE threshold and if it is then mark the packet,
+    // skip PIE steps, and return the item.
+    if (m_useL4s)
+    {
+        uint8_t tosByte = 0;
+        if (item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
+            (((tosByte & 0x3) == 1) || (tosByte & 0x3) == 3))
+        {
+            if ((tosByte & 0x3) == 1)
+            {
+                NS_LOG_DEBUG("ECT1 packet " << static_cast<uint16_t>(tosByte & 0x3));
+            }
+            else
+            {
+                NS_LOG_DEBUG("CE packet " << static_cast<uint16_t>(tosByte & 0x3));
+            }
+            if ((Now() - item->GetTimeStamp() > m_ceThreshold) &&
+                Mark(item, PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK))
+            {
+                NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
+                flow->NotifyMark(PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK);
+            }
+            return item;
+        }
+    }
+
+    PieQueueDisc::MeasureDequeue(GetPieParams(), *flow, item, flow->GetNBytes());
+    NS_LOG_DEBUG("Average Dequeue Rate after Dequeue: " << flow->m_avgDqRate);
+    return item;
+}
+
+PieQueueDisc::Params
+FqPieQueueDisc::GetPieParams() const
+{
+    return PieQueueDisc::Params{m_tUpdate,
+                                m_qDelayRef,
+                                m_meanPktSize,
+                                m_maxBurst,
+                                m_a,
+                                m_b,
+                                m_dqThreshold,
+                                m_useDqRateEstimator,
+                                m_isCapDropAdjustment,
+                                m_useDerandomization,
+                                GetMaxSize().GetUnit()};
+}
+
+void
+FqPieQueueDisc::CalculateP(FqPieFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+    PieQueueDisc::UpdateDropProb(GetPieParams(), *flow, flow->GetNBytes());
+    NS_LOG_DEBUG("Queue delay while calculating probability: "
+                 << flow->m_qDelayOld.GetMilliSeconds() << "ms");
+    flow->m_rtrsEvent = Simulator::Schedule(m_tUpdate, &FqPieQueueDisc::CalculateP, this, flow);
+}
+
 } // namespace ns3
@@ -15,12 +15,11 @@
 #ifndef FQ_PIE_QUEUE_DISC
 #define FQ_PIE_QUEUE_DISC
 
+#include "fq-flow.h"
+#include "pie-queue-disc.h"
 #include "queue-disc.h"
 
-#include "ns3/object-factory.h"
-
-#include <list>
-#include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -29,74 +28,48 @@ namespace ns3
  * \ingroup traffic-control
  *
  * \brief A flow queue used by the FqPie queue disc
+ *
+ * The flow holds the state of the PIE algorithm run by the FqPie queue disc
+ * on the packets of the flow.
  */
 
-class FqPieFlow : public QueueDiscClass
+class FqPieFlow : public FqFlow
 {
   public:
-    /**
-     * \brief Get the type ID.
-     * \return the object TypeId
-     */
-    static TypeId GetTypeId();
     /**
      * \brief FqPieFlow constructor
      */
     FqPieFlow();
 
-    ~FqPieFlow() override;
-
-    /**
-     * \enum FlowStatus
-     * \brief Used to determine the status of this flow queue
-     */
-    enum FlowStatus
-    {
-        INACTIVE,
-        NEW_FLOW,
-        OLD_FLOW
-    };
-
     /**
-     * \brief Set the deficit for this flow
-     * \param deficit the deficit for this flow
+     * \brief Get the current queue delay of this flow
+     * \return the current queue delay
      */
-    void SetDeficit(uint32_t deficit);
+    Time GetQueueDelay() const;
     /**
-     * \brief Get the deficit for this flow
-     * \return the deficit for this flow
+     * \brief Get the current drop probability of this flow
+     * \return the current drop probability
      */
-    int32_t GetDeficit() const;
-    /**
-     * \brief Increase the deficit for this flow
-     * \param deficit the amount by which the deficit is to be increased
-     */
-    void IncreaseDeficit(int32_t deficit);
-    /**
-     * \brief Set the status for this flow
-     * \param status the status for this flow
-     */
-    void SetStatus(FlowStatus status);
-    /**
-     * \brief Get the status of this flow
-     * \return the status of this flow
-     */
-    FlowStatus GetStatus() const;
-    /**
-     * \brief Set the index for this flow
-     * \param index the index for this flow
-     */
-    void SetIndex(uint32_t index);
-    /**
-     * \brief Get the index of this flow
-     * \return the index of this flow
-     */
-    uint32_t GetIndex() const;
+    double GetDropProbability() const;
 
   private:
-    int32_t m_deficit;   //!< the deficit for this flow
-    FlowStatus m_status; //!< the status of this flow
-    uint32_t m_index;    //!< the index for this flow
+    friend class FqPieQueueDisc;
+    friend class PieQueueDisc; // runs the PIE algorithm on the flow
+
+    double m_dropProb{0};                   //!< Variable used in calculation of drop probability
+    Time m_qDelayOld;                       //!< Old value of queue delay
+    Time m_qDelay;                          //!< Current value of queue delay
+    Time m_burstAllowance;                  //!< Current max burst allowed before random drops
+    uint32_t m_burstReset{0};               //!< Used to reset value of burst allowance
+    PieQueueDisc::BurstStateT m_burstState; //!< Used to determine the current state of burst
+    bool m_inMeasurement{false};            //!< Indicates whether we are in a measurement cycle
+    double m_avgDqRate{0};                  //!< Time averaged dequeue rate
+    Time m_dqStart;                         //!< Start timestamp of current measurement cycle
+    uint64_t m_dqCount;                     //!< Number of bytes departed since the cycle starts
+    double m_accuProb{0};                   //!< Accumulated drop probability
+    Time m_nextUpdate;                      //!< Time of the next update of the drop probability
+    EventId m_rtrsEvent;                    //!< Event of the next update of the drop probability
+    Ptr<UniformRandomVariable> m_uv;        //!< Rng stream
 };
 
 /**
@@ -136,12 +109,26 @@ class FqPieQueueDisc : public QueueDisc
      */
     uint32_t GetQuantum() const;
 
+    /**
+     * \brief Get the number of flow queues that received packets
+     * \return the number of flow queues that received packets
+     */
+    std::size_t GetNFlows() const;
+
+    /**
+     * \brief Get a flow queue that received packets
+     * \param i the index of the flow queue, in the order of their first packet
+     * \return the flow queue
+     */
+    const FqPieFlow* GetFlow(std::size_t i) const;
+
     // Reasons for dropping packets
     static constexpr const char* UNCLASSIFIED_DROP =
         "Unclassified drop"; //!< No packet filter able to classify packet
     static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Overlimit dropped packets
 
   private:
+    void DoDispose() override;
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
     Ptr<QueueDiscItem> DoDequeue() override;
     bool CheckConfig() override;
@@ -153,6 +140,46 @@ class FqPieQueueDisc : public QueueDisc
      */
     uint32_t FqPieDrop();
 
+    /**
+     * \brief Start running the PIE algorithm on a flow that receives its first packet
+     * \param flow the flow
+     */
+    void PieStart(FqPieFlow* flow);
+
+    /**
+     * \brief Enqueue a packet into a flow, unless dropped by the PIE algorithm
+     * \param flow the flow
+     * \param item the packet
+     * \return true if the packet was enqueued
+     */
+    bool PieEnqueue(FqPieFlow* flow, Ptr<QueueDiscItem> item);
+
+    /**
+     * \brief Dequeue a packet from a flow, according to the PIE algorithm
+     * \param flow the flow
+     * \return the packet, or a null pointer if the flow is empty
+     */
+    Ptr<QueueDiscItem> PieDequeue(FqPieFlow* flow);
+
+    /**
+     * \brief Get the parameters of the PIE algorithm, from the attributes
+     * \return the parameters of the PIE algorithm
+     */
+    PieQueueDisc::Params GetPieParams() const;
+
+    /**
+     * Periodically update the drop probability of a flow based on the delay samples
+     * \param flow the flow
+     */
+    void CalculateP(FqPieFlow* flow);
+
+    /**
+     * \brief Dequeue a packet from a flow and notify the dequeue
+     * \param flow the flow
+     * \return the packet, or a null pointer if the flow is empty
+     */
+    Ptr<QueueDiscItem> FlowDequeue(FqPieFlow* flow);
+
     /**
      * Compute the index of the queue for the flow having the given flowHash,
      * according to the set associative hash approach.
@@ -180,6 +207,7 @@ class FqPieQueueDisc : public QueueDisc
     bool
         m_isCapDropAdjustment; //!< Enable/Disable Cap Drop Adjustment feature mentioned in RFC 8033
     bool m_useDerandomization; //!< Enable Derandomization feature mentioned in RFC 8033
+    bool m_useLazyUpdate;      //!< True to update the drop probability at enqueue/dequeue time
 
     // Fq parameters
     uint32_t m_quantum;              //!< Deficit assigned to flows at each round
@@ -189,14 +217,13 @@ class FqPieQueueDisc : public QueueDisc
     uint32_t m_perturbation;         //!< hash perturbation value
     bool m_enableSetAssociativeHash; //!< whether to enable set associative hash
 
-    std::list<Ptr<FqPieFlow>> m_newFlows; //!< The list of new flows
-    std::list<Ptr<FqPieFlow>> m_oldFlows; //!< The list of old flows
-
-    std::map<uint32_t, uint32_t> m_flowsIndices; //!< Map with the index of class for each flow
-    std::map<uint32_t, uint32_t> m_tags;         //!< Tags used by set associative hash
+    FqFlowList<FqPieFlow> m_newFlows; //!< The list of new flows
+    FqFlowList<FqPieFlow> m_oldFlows; //!< The list of old flows
 
-    ObjectFactory m_flowFactory;      //!< Factory to create a new flow
-    ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
+    std::vector<FqPieFlow> m_flowTable; //!< The flow queue of each index
+    std::vector<FqPieFlow*> m_flowList; //!< The flow queues that received packets
+    std::vector<uint32_t> m_tags;       //!< Tags used by set associative hash
+    FqItemPool m_itemPool;              //!< The packets of the flow queues
 };
 
 } // namespace ns3
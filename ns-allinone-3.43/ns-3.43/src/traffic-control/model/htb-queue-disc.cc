@@ -0,0 +1,625 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "htb-queue-disc.h"
+
+#include "ns3/integer.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("HtbQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED(HtbClass);
+NS_OBJECT_ENSURE_REGISTERED(HtbQueueDisc);
+
+/// The maximum time over which tokens are accumulated or owed
+static const Time HTB_MAX_BUFFER = Seconds(60);
+/// The minimum tokens of a bucket, i.e., the maximum time owed
+static const Time HTB_MIN_TOKENS = Seconds(-60);
+
+TypeId
+HtbClass::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::HtbClass")
+            .SetParent<QueueDiscClass>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<HtbClass>()
+            .AddAttribute("Rate",
+                          "The rate assured to the class",
+                          DataRateValue(DataRate("1Mbps")),
+                          MakeDataRateAccessor(&HtbClass::m_rate),
+                          MakeDataRateChecker())
+            .AddAttribute("Ceil",
+                          "The maximum rate of the class, borrowing from its ancestors. "
+                          "If null, it is equal to the Rate",
+                          DataRateValue(DataRate("0bps")),
+                          MakeDataRateAccessor(&HtbClass::m_ceil),
+                          MakeDataRateChecker())
+            .AddAttribute("Burst",
+                          "The bytes that the class can send at once at the maximum rate",
+                          UintegerValue(1600),
+                          MakeUintegerAccessor(&HtbClass::m_burst),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Cburst",
+                          "The bytes that the class can send at once at the link rate",
+                          UintegerValue(1600),
+                          MakeUintegerAccessor(&HtbClass::m_cburst),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Quantum",
+                          "The bytes that the class sends in a round when sharing borrowed "
+                          "tokens. If null, it is a tenth of the bytes sent per second at "
+                          "the Rate, between 1000 and 200000",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&HtbClass::m_quantum),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Priority",
+                          "The priority of the class when borrowing tokens (0 is the highest)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&HtbClass::m_priority),
+                          MakeUintegerChecker<uint8_t>(0, N_PRIO - 1))
+            .AddAttribute("Parent",
+                          "The index of the parent class in the list of classes of the "
+                          "queue disc, or -1 for a top-level class",
+                          IntegerValue(-1),
+                          MakeIntegerAccessor(&HtbClass::m_parentIndex),
+                          MakeIntegerChecker<int32_t>(-1));
+    return tid;
+}
+
+HtbClass::HtbClass()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+HtbClass::~HtbClass()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+HtbClass::Mode
+HtbClass::GetMode() const
+{
+    return m_mode;
+}
+
+uint32_t
+HtbClass::GetLevel() const
+{
+    return m_level;
+}
+
+uint64_t
+HtbClass::GetNBorrowed() const
+{
+    return m_nBorrowed;
+}
+
+TypeId
+HtbQueueDisc::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::HtbQueueDisc")
+            .SetParent<QueueDisc>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<HtbQueueDisc>()
+            .AddAttribute("DefaultClass",
+                          "The index of the leaf class of the packets that the packet filters "
+                          "do not classify into a leaf class, or -1 to drop such packets",
+                          IntegerValue(-1),
+                          MakeIntegerAccessor(&HtbQueueDisc::m_defaultClass),
+                          MakeIntegerChecker<int32_t>(-1));
+    return tid;
+}
+
+HtbQueueDisc::HtbQueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::NO_LIMITS)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+HtbQueueDisc::~HtbQueueDisc()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+HtbQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_id);
+    m_classes.clear();
+    m_rows.clear();
+    m_rowMask.clear();
+    m_waitQueue.clear();
+    QueueDisc::DoDispose();
+}
+
+HtbClass::Mode
+HtbQueueDisc::ClassMode(const HtbClass* cl, Time now, Time& wait)
+{
+    Time diff = std::min(now - cl->m_checkpoint, HTB_MAX_BUFFER);
+
+    Time toks = cl->m_ctokens + diff;
+    if (toks.IsStrictlyNegative())
+    {
+        wait = Abs(toks);
+        return HtbClass::CANT_SEND;
+    }
+
+    toks = cl->m_tokens + diff;
+    if (!toks.IsStrictlyNegative())
+    {
+        return HtbClass::CAN_SEND;
+    }
+
+    wait = Abs(toks);
+    return HtbClass::MAY_BORROW;
+}
+
+void
+HtbQueueDisc::UpdateClassMode(HtbClass* cl, Time now)
+{
+    Time wait;
+    HtbClass::Mode mode = ClassMode(cl, now, wait);
+
+    if (mode != cl->m_mode)
+    {
+        NS_LOG_LOGIC("Class " << cl << " changes mode from " << cl->m_mode << " to " << mode);
+        if (cl->m_prioActivity)
+        {
+            DeactivatePrios(cl);
+            cl->m_mode = mode;
+            ActivatePrios(cl);
+        }
+        else
+        {
+            cl->m_mode = mode;
+        }
+    }
+
+    if (cl->m_waiting)
+    {
+        m_waitQueue.erase(cl->m_waitPos);
+        cl->m_waiting = false;
+    }
+    if (mode != HtbClass::CAN_SEND)
+    {
+        cl->m_waitPos = m_waitQueue.emplace(now + wait, cl);
+        cl->m_waiting = true;
+    }
+}
+
+void
+HtbQueueDisc::Activate(HtbClass* cl)
+{
+    NS_LOG_FUNCTION(this << cl);
+    NS_ASSERT(cl->m_prioActivity == 0);
+    cl->m_prioActivity = 1 << cl->m_priority;
+    ActivatePrios(cl);
+}
+
+void
+HtbQueueDisc::Deactivate(HtbClass* cl)
+{
+    NS_LOG_FUNCTION(this << cl);
+    NS_ASSERT(cl->m_prioActivity != 0);
+    DeactivatePrios(cl);
+    cl->m_prioActivity = 0;
+}
+
+void
+HtbQueueDisc::ActivatePrios(HtbClass* cl)
+{
+    HtbClass* p = cl->m_parent;
+    uint8_t m = cl->m_prioActivity;
+
+    // a class that borrows is attached to its parent, which becomes active at the
+    // priorities of the class, and so on up to the first class that can send
+    while (cl->m_mode == HtbClass::MAY_BORROW && p && m)
+    {
+        uint8_t mask = m;
+        for (uint8_t prio = 0; prio < HtbClass::N_PRIO; prio++)
+        {
+            if (m & (1 << prio))
+            {
+                if (!p->m_feed[prio].classes.empty())
+                {
+                    // the parent is already active at this priority
+                    mask &= ~(1 << prio);
+                }
+                p->m_feed[prio].classes.emplace(cl->m_index, cl);
+            }
+        }
+        p->m_prioActivity |= mask;
+        cl = p;
+        p = cl->m_parent;
+        m = mask;
+    }
+
+    if (cl->m_mode == HtbClass::CAN_SEND && m)
+    {
+        for (uint8_t prio = 0; prio < HtbClass::N_PRIO; prio++)
+        {
+            if (m & (1 << prio))
+            {
+                m_rows[cl->m_level][prio].classes.emplace(cl->m_index, cl);
+                m_rowMask[cl->m_level] |= 1 << prio;
+            }
+        }
+    }
+}
+
+void
+HtbQueueDisc::DeactivatePrios(HtbClass* cl)
+{
+    HtbClass* p = cl->m_parent;
+    uint8_t m = cl->m_prioActivity;
+
+    while (cl->m_mode == HtbClass::MAY_BORROW && p && m)
+    {
+        uint8_t mask = 0;
+        for (uint8_t prio = 0; prio < HtbClass::N_PRIO; prio++)
+        {
+            if (m & (1 << prio))
+            {
+                p->m_feed[prio].classes.erase(cl->m_index);
+                if (p->m_feed[prio].classes.empty())
+                {
+                    // the parent is no longer active at this priority
+                    mask |= 1 << prio;
+                }
+            }
+        }
+        p->m_prioActivity &= ~mask;
+        cl = p;
+        p = cl->m_parent;
+        m = mask;
+    }
+
+    if (cl->m_mode == HtbClass::CAN_SEND && m)
+    {
+        for (uint8_t prio = 0; prio < HtbClass::N_PRIO; prio++)
+        {
+            if (m & (1 << prio))
+            {
+                HtbClass::ActiveList& row = m_rows[cl->m_level][prio];
+                row.classes.erase(cl->m_index);
+                if (row.classes.empty())
+                {
+                    m_rowMask[cl->m_level] &= ~(1 << prio);
+                }
+            }
+        }
+    }
+}
+
+void
+HtbQueueDisc::Charge(HtbClass* cl, uint32_t level, uint32_t bytes)
+{
+    NS_LOG_FUNCTION(this << cl << level << bytes);
+
+    Time now = Simulator::Now();
+
+    for (; cl; cl = cl->m_parent)
+    {
+        Time diff = std::min(now - cl->m_checkpoint, HTB_MAX_BUFFER);
+
+        cl->m_tokens = std::min(cl->m_tokens + diff, cl->m_buffer);
+        if (cl->m_level >= level)
+        {
+            // the class sent the packet with its own tokens
+            cl->m_tokens = std::max(cl->m_tokens - cl->m_rate.CalculateBytesTxTime(bytes),
+                                    HTB_MIN_TOKENS);
+        }
+        else
+        {
+            cl->m_nBorrowed++;
+        }
+        cl->m_ctokens = std::max(std::min(cl->m_ctokens + diff, cl->m_cbuffer) -
+                                     cl->m_ceil.CalculateBytesTxTime(bytes),
+                                 HTB_MIN_TOKENS);
+        cl->m_checkpoint = now;
+
+        UpdateClassMode(cl, now);
+    }
+}
+
+void
+HtbQueueDisc::DoEvents(Time now)
+{
+    while (!m_waitQueue.empty() && m_waitQueue.begin()->first <= now)
+    {
+        HtbClass* cl = m_waitQueue.begin()->second;
+        m_waitQueue.erase(m_waitQueue.begin());
+        cl->m_waiting = false;
+        UpdateClassMode(cl, now);
+    }
+}
+
+bool
+HtbQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    HtbClass* cl = nullptr;
+    int32_t ret = Classify(item);
+
+    if (ret >= 0 && static_cast<uint32_t>(ret) < m_classes.size() &&
+        m_classes[ret]->m_nChildren == 0)
+    {
+        cl = m_classes[ret];
+    }
+    else if (m_defaultClass >= 0)
+    {
+        NS_LOG_DEBUG("Packet filters returned " << ret << ", using the default class");
+        cl = m_classes[m_defaultClass];
+    }
+    else
+    {
+        NS_LOG_DEBUG("No filter has been able to classify this packet, drop it.");
+        DropBeforeEnqueue(item, UNCLASSIFIED_DROP);
+        return false;
+    }
+
+    bool retval = cl->GetQueueDisc()->Enqueue(item);
+
+    // If Queue::Enqueue fails, QueueDisc::Drop is called by the child queue disc
+    // because QueueDisc::AddQueueDiscClass sets the drop callback
+
+    if (cl->m_prioActivity == 0 && cl->GetQueueDisc()->GetNPackets() > 0)
+    {
+        Activate(cl);
+    }
+
+    return retval;
+}
+
+Ptr<QueueDiscItem>
+HtbQueueDisc::DequeueTree(uint8_t prio, uint32_t level)
+{
+    NS_LOG_FUNCTION(this << +prio << level);
+
+    HtbClass::ActiveList& row = m_rows[level][prio];
+
+    while (!row.classes.empty())
+    {
+        HtbClass* top = NextClass(row);
+        HtbClass* cl = top;
+        // descend through the children borrowing from the class to a leaf
+        while (cl->m_nChildren > 0)
+        {
+            NS_ASSERT(!cl->m_feed[prio].classes.empty());
+            cl = NextClass(cl->m_feed[prio]);
+        }
+
+        Ptr<QueueDiscItem> item = cl->GetQueueDisc()->Dequeue();
+
+        if (!item && cl->GetQueueDisc()->GetNPackets() == 0)
+        {
+            // the child queue disc dropped its packets
+            Deactivate(cl);
+            continue;
+        }
+
+        // move the cursors on the path past the classes served, to serve another
+        // leaf next, once the leaf used its quantum at this level or could not send
+        if (!item || (cl->m_deficit[level] -= item->GetSize()) < 0)
+        {
+            cl->m_deficit[level] += cl->m_quantum;
+            for (HtbClass* c = cl; c != top; c = c->m_parent)
+            {
+                c->m_parent->m_feed[prio].next = c->m_index + 1;
+            }
+            row.next = top->m_index + 1;
+        }
+
+        if (!item)
+        {
+            NS_LOG_WARN("The child queue disc of class " << cl << " is not work conserving");
+            return item;
+        }
+
+        if (cl->GetQueueDisc()->GetNPackets() == 0)
+        {
+            Deactivate(cl);
+        }
+
+        Charge(cl, level, item->GetSize());
+        return item;
+    }
+    return nullptr;
+}
+
+HtbClass*
+HtbQueueDisc::NextClass(HtbClass::ActiveList& list)
+{
+    NS_ASSERT(!list.classes.empty());
+    auto it = list.classes.lower_bound(list.next);
+    if (it == list.classes.end())
+    {
+        it = list.classes.begin();
+    }
+    list.next = it->first;
+    return it->second;
+}
+
+Ptr<QueueDiscItem>
+HtbQueueDisc::DoDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    Time now = Simulator::Now();
+    DoEvents(now);
+
+    for (uint32_t level = 0; level < m_rows.size(); level++)
+    {
+        for (uint8_t prio = 0; prio < HtbClass::N_PRIO && m_rowMask[level]; prio++)
+        {
+            if (m_rowMask[level] & (1 << prio))
+            {
+                Ptr<QueueDiscItem> item = DequeueTree(prio, level);
+                if (item)
+                {
+                    return item;
+                }
+            }
+        }
+    }
+
+    // No class can send now: wake up when the next class changes mode
+    if (GetNPackets() > 0 && !m_waitQueue.empty())
+    {
+        Time next = m_waitQueue.begin()->first;
+        if (!m_id.IsPending() || TimeStep(m_id.GetTs()) > next)
+        {
+            Simulator::Cancel(m_id);
+            m_id = Simulator::Schedule(next - now, &QueueDisc::Run, this);
+            NS_LOG_LOGIC("Waking Event Scheduled in " << (next - now).As(Time::S));
+        }
+    }
+
+    NS_LOG_LOGIC("No packet can be dequeued");
+    return nullptr;
+}
+
+bool
+HtbQueueDisc::CheckConfig()
+{
+    NS_LOG_FUNCTION(this);
+    if (GetNInternalQueues() > 0)
+    {
+        NS_LOG_ERROR("HtbQueueDisc cannot have internal queues");
+        return false;
+    }
+
+    uint32_t n = GetNQueueDiscClasses();
+    if (n == 0)
+    {
+        NS_LOG_ERROR("HtbQueueDisc needs at least one class");
+        return false;
+    }
+
+    std::vector<bool> leaf(n, true);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<HtbClass> cl = DynamicCast<HtbClass>(GetQueueDiscClass(i));
+        if (!cl)
+        {
+            NS_LOG_ERROR("The classes of HtbQueueDisc must be HtbClass objects");
+            return false;
+        }
+        if (cl->m_parentIndex >= static_cast<int32_t>(n) ||
+            cl->m_parentIndex == static_cast<int32_t>(i))
+        {
+            NS_LOG_ERROR("Class " << i << " has an invalid parent (" << cl->m_parentIndex << ")");
+            return false;
+        }
+        if (cl->m_parentIndex >= 0)
+        {
+            leaf[cl->m_parentIndex] = false;
+        }
+        if (cl->m_rate.GetBitRate() == 0)
+        {
+            NS_LOG_ERROR("The rate of class " << i << " cannot be null");
+            return false;
+        }
+        if (cl->m_ceil.GetBitRate() != 0 && cl->m_ceil < cl->m_rate)
+        {
+            NS_LOG_ERROR("The ceil of class " << i << " cannot be less than its rate");
+            return false;
+        }
+    }
+
+    // the parents must form a forest
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t p = i;
+        for (uint32_t depth = 0; p >= 0; depth++)
+        {
+            if (depth == n)
+            {
+                NS_LOG_ERROR("Class " << i << " is its own ancestor");
+                return false;
+            }
+            p = DynamicCast<HtbClass>(GetQueueDiscClass(p))->m_parentIndex;
+        }
+    }
+
+    if (m_defaultClass >= static_cast<int32_t>(n) ||
+        (m_defaultClass >= 0 && !leaf[m_defaultClass]))
+    {
+        NS_LOG_ERROR("The default class (" << m_defaultClass << ") must be a leaf class");
+        return false;
+    }
+
+    return true;
+}
+
+void
+HtbQueueDisc::InitializeParams()
+{
+    NS_LOG_FUNCTION(this);
+
+    Time now = Simulator::Now();
+
+    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
+    {
+        m_classes.push_back(PeekPointer(DynamicCast<HtbClass>(GetQueueDiscClass(i))));
+        m_classes.back()->m_index = i;
+    }
+
+    uint32_t maxLevel = 0;
+    for (HtbClass* cl : m_classes)
+    {
+        if (cl->m_parentIndex >= 0)
+        {
+            cl->m_parent = m_classes[cl->m_parentIndex];
+            cl->m_parent->m_nChildren++;
+        }
+        // the level of a class is its height in the hierarchy
+        HtbClass* p = cl;
+        for (uint32_t level = 0;; level++)
+        {
+            p->m_level = std::max(p->m_level, level);
+            maxLevel = std::max(maxLevel, level);
+            if (p->m_parentIndex < 0)
+            {
+                break;
+            }
+            p = m_classes[p->m_parentIndex];
+        }
+
+        if (cl->m_ceil.GetBitRate() == 0)
+        {
+            cl->m_ceil = cl->m_rate;
+        }
+        if (cl->m_quantum == 0)
+        {
+            cl->m_quantum = std::clamp<uint64_t>(cl->m_rate.GetBitRate() / 80, 1000, 200000);
+        }
+        cl->m_buffer = cl->m_rate.CalculateBytesTxTime(cl->m_burst);
+        cl->m_cbuffer = cl->m_ceil.CalculateBytesTxTime(cl->m_cburst);
+        cl->m_tokens = cl->m_buffer;
+        cl->m_ctokens = cl->m_cbuffer;
+        cl->m_checkpoint = now;
+        cl->m_mode = HtbClass::CAN_SEND;
+    }
+
+    for (HtbClass* cl : m_classes)
+    {
+        cl->m_deficit.assign(maxLevel + 1, cl->m_quantum);
+    }
+
+    m_rows.resize(maxLevel + 1);
+    m_rowMask.assign(maxLevel + 1, 0);
+}
+
+} // namespace ns3
@@ -0,0 +1,262 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef HTB_QUEUE_DISC_H
+#define HTB_QUEUE_DISC_H
+
+#include "queue-disc.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <array>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+class HtbQueueDisc;
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A class of the HTB queue disc
+ *
+ * Each class is shaped by two token buckets: the first one is filled at the
+ * assured rate (Rate) and holds up to Burst bytes, the second one is filled at
+ * the maximum rate (Ceil) and holds up to Cburst bytes. A class without
+ * tokens in the first bucket may borrow the unused tokens of its ancestors,
+ * as long as it has tokens in the second bucket.
+ *
+ * The class hierarchy is set through the Parent attribute, which is the index
+ * of the parent class in the list of classes of the queue disc. The classes
+ * that are not the parent of any class are the leaf classes, the only ones
+ * whose child queue disc stores packets.
+ */
+class HtbClass : public QueueDiscClass
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief HtbClass constructor
+     */
+    HtbClass();
+
+    ~HtbClass() override;
+
+    /// The number of priorities of the leaf classes
+    static constexpr uint8_t N_PRIO = 8;
+
+    /**
+     * \brief The mode of a class, determined by its token buckets
+     */
+    enum Mode
+    {
+        CANT_SEND,  //!< no tokens in the second bucket
+        MAY_BORROW, //!< no tokens in the first bucket, tokens in the second bucket
+        CAN_SEND    //!< tokens in both buckets
+    };
+
+    /**
+     * \brief Get the current mode of this class
+     * \return the mode of this class
+     */
+    Mode GetMode() const;
+
+    /**
+     * \brief Get the level of this class in the hierarchy
+     * \return 0 for the leaf classes, the maximum level of the children plus 1
+     *         for the inner classes
+     */
+    uint32_t GetLevel() const;
+
+    /**
+     * \brief Get the number of packets this class sent with tokens borrowed
+     * from an ancestor
+     * \return the number of borrowed transmissions
+     */
+    uint64_t GetNBorrowed() const;
+
+  private:
+    friend class HtbQueueDisc;
+
+    /**
+     * \brief The active classes of a level or of a parent at a priority
+     *
+     * The classes are served in round robin in the order of their index, from
+     * the next class to serve, which is not affected by the classes becoming
+     * active or inactive in the meantime.
+     */
+    struct ActiveList
+    {
+        std::map<uint32_t, HtbClass*> classes; //!< the active classes, by index
+        uint32_t next{0};                      //!< the index of the next class to serve
+    };
+
+    /// Queue of the classes waiting for a change of their mode, by time of change
+    typedef std::multimap<Time, HtbClass*> WaitQueue;
+
+    DataRate m_rate;       //!< the assured rate
+    DataRate m_ceil;       //!< the maximum rate
+    uint32_t m_burst;      //!< the size of the first bucket, in bytes
+    uint32_t m_cburst;     //!< the size of the second bucket, in bytes
+    uint32_t m_quantum;    //!< the bytes sent in a round when sharing borrowed tokens
+    uint8_t m_priority;    //!< the priority of the leaf class (0 is the highest)
+    int32_t m_parentIndex; //!< the index of the parent class, or -1
+
+    uint32_t m_index{0};                   //!< the index in the list of classes
+    HtbClass* m_parent{nullptr};           //!< the parent class
+    uint32_t m_nChildren{0};               //!< the number of children
+    uint32_t m_level{0};                   //!< the level in the hierarchy
+    Mode m_mode{CAN_SEND};                 //!< the current mode
+    Time m_buffer;                         //!< the first bucket size, in time
+    Time m_cbuffer;                        //!< the second bucket size, in time
+    Time m_tokens;                         //!< the first bucket tokens, in time
+    Time m_ctokens;                        //!< the second bucket tokens, in time
+    Time m_checkpoint;                     //!< the last update of the tokens
+    std::vector<int32_t> m_deficit;        //!< the deficit of the leaf class, by level
+    uint8_t m_prioActivity{0};             //!< the active priorities
+    std::array<ActiveList, N_PRIO> m_feed; //!< the children borrowing, by priority
+    WaitQueue::iterator m_waitPos;         //!< the position in the wait queue
+    bool m_waiting{false};                 //!< whether in the wait queue
+    uint64_t m_nBorrowed{0};               //!< the borrowed transmissions
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Hierarchical token bucket queue disc
+ *
+ * The HTB queue disc shapes the traffic of a hierarchy of classes, as the
+ * Linux queue disc of the same name. Packets are classified into the leaf
+ * classes by the packet filters, or into the DefaultClass if the filters do
+ * not return the index of a leaf class. A leaf class with tokens sends at its
+ * assured rate, and the leaf classes without tokens share the unused tokens of
+ * their ancestors, by priority and in round robin within a priority.
+ *
+ * The active classes are kept per level and priority, and the leaf classes
+ * that borrow are attached to their parent, so that dequeuing a packet or
+ * changing the mode of a class takes O(depth log(n)) operations for n classes.
+ * The classes waiting for a change of mode are kept in a single queue ordered
+ * by time, and a single event wakes the queue disc up when the next change is
+ * due.
+ */
+class HtbQueueDisc : public QueueDisc
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief HtbQueueDisc constructor
+     */
+    HtbQueueDisc();
+
+    ~HtbQueueDisc() override;
+
+    // Reasons for dropping packets
+    static constexpr const char* UNCLASSIFIED_DROP = "Unclassified drop"; //!< No leaf class found
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+
+    /**
+     * \brief Compute the mode of a class at the given time
+     * \param cl the class
+     * \param now the current time
+     * \param [out] wait the time until the mode changes, if not CAN_SEND
+     * \return the mode of the class
+     */
+    static HtbClass::Mode ClassMode(const HtbClass* cl, Time now, Time& wait);
+
+    /**
+     * \brief Update the mode of a class, moving it among the active lists and
+     * the wait queue as needed
+     * \param cl the class
+     * \param now the current time
+     */
+    void UpdateClassMode(HtbClass* cl, Time now);
+
+    /**
+     * \brief Make a backlogged leaf class active
+     * \param cl the leaf class
+     */
+    void Activate(HtbClass* cl);
+
+    /**
+     * \brief Make a leaf class with no packets inactive
+     * \param cl the leaf class
+     */
+    void Deactivate(HtbClass* cl);
+
+    /**
+     * \brief Add a class to the active list of its level, or to the lists of
+     * its parent if it borrows, for each of its active priorities
+     * \param cl the class
+     */
+    void ActivatePrios(HtbClass* cl);
+
+    /**
+     * \brief Remove a class from the lists it was added to by ActivatePrios
+     * \param cl the class
+     */
+    void DeactivatePrios(HtbClass* cl);
+
+    /**
+     * \brief Charge the classes from a leaf class up to the root for a packet
+     * \param cl the leaf class
+     * \param level the level of the class that provided the tokens
+     * \param bytes the size of the packet
+     */
+    void Charge(HtbClass* cl, uint32_t level, uint32_t bytes);
+
+    /**
+     * \brief Update the mode of the classes whose change of mode is due
+     * \param now the current time
+     */
+    void DoEvents(Time now);
+
+    /**
+     * \brief Dequeue a packet from the classes of a level and a priority
+     * \param prio the priority
+     * \param level the level
+     * \return the dequeued packet, if any
+     */
+    Ptr<QueueDiscItem> DequeueTree(uint8_t prio, uint32_t level);
+
+    /**
+     * \brief Get the next class to serve in a non-empty list of active classes
+     * \param list the list of active classes
+     * \return the first class whose index is not less than the next index to
+     *         serve, or the first class of the list
+     */
+    static HtbClass* NextClass(HtbClass::ActiveList& list);
+
+    int32_t m_defaultClass; //!< the index of the class of the unclassified packets
+
+    /// the active classes, by level and priority
+    std::vector<std::array<HtbClass::ActiveList, HtbClass::N_PRIO>> m_rows;
+    std::vector<HtbClass*> m_classes; //!< the classes
+    std::vector<uint8_t> m_rowMask;   //!< the priorities with active classes, by level
+    HtbClass::WaitQueue m_waitQueue;  //!< the classes waiting for a change of mode
+    EventId m_id;                     //!< the event to wake the queue disc up
+};
+
+} // namespace ns3
+
+#endif /* HTB_QUEUE_DISC_H */
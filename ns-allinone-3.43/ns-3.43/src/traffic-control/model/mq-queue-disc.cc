@@ -9,7 +9,10 @@
 
 #include "mq-queue-disc.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -24,12 +27,26 @@ MqQueueDisc::GetTypeId()
     static TypeId tid = TypeId("ns3::MqQueueDisc")
                             .SetParent<QueueDisc>()
                             .SetGroupName("TrafficControl")
-                            .AddConstructor<MqQueueDisc>();
+                            .AddConstructor<MqQueueDisc>()
+                            .AddAttribute("Sharding",
+                                          "True to shard the traffic of a single-queue device "
+                                          "among the child queue discs",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&MqQueueDisc::m_sharding),
+                                          MakeBooleanChecker())
+                            .AddAttribute("BatchSize",
+                                          "The maximum number of packets dequeued from a shard "
+                                          "before moving to the next one",
+                                          UintegerValue(16),
+                                          MakeUintegerAccessor(&MqQueueDisc::m_batchSize),
+                                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
 MqQueueDisc::MqQueueDisc()
-    : QueueDisc(QueueDiscSizePolicy::NO_LIMITS)
+    : QueueDisc(QueueDiscSizePolicy::NO_LIMITS),
+      m_currentShard(0),
+      m_batchCount(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -42,25 +59,90 @@ MqQueueDisc::~MqQueueDisc()
 MqQueueDisc::WakeMode
 MqQueueDisc::GetWakeMode() const
 {
-    return WAKE_CHILD;
+    return m_sharding ? WAKE_ROOT : WAKE_CHILD;
 }
 
 bool
 MqQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
-    NS_FATAL_ERROR("MqQueueDisc: DoEnqueue should never be called");
+    NS_LOG_FUNCTION(this << item);
+    NS_ABORT_MSG_UNLESS(m_sharding, "MqQueueDisc: DoEnqueue should never be called");
+
+    uint32_t nShards = GetNQueueDiscClasses();
+    uint32_t shard;
+    int32_t ret = Classify(item);
+
+    if (ret >= 0 && static_cast<uint32_t>(ret) < nShards)
+    {
+        shard = ret;
+    }
+    else
+    {
+        // Use the high bits of the flow hash, so that child queue discs hashing
+        // flows modulo their number of queues still use all of their queues
+        shard = (static_cast<uint64_t>(item->Hash()) * nShards) >> 32;
+    }
+
+    NS_LOG_LOGIC("Enqueue packet into shard " << shard);
+    return GetQueueDiscClass(shard)->GetQueueDisc()->Enqueue(item);
 }
 
 Ptr<QueueDiscItem>
 MqQueueDisc::DoDequeue()
 {
-    NS_FATAL_ERROR("MqQueueDisc: DoDequeue should never be called");
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_UNLESS(m_sharding, "MqQueueDisc: DoDequeue should never be called");
+
+    uint32_t nShards = GetNQueueDiscClasses();
+
+    // Visit each shard once, starting with the current one if it has not
+    // exhausted its batch
+    for (uint32_t i = 0; i <= nShards; i++)
+    {
+        if (m_batchCount < m_batchSize)
+        {
+            Ptr<QueueDiscItem> item = GetQueueDiscClass(m_currentShard)->GetQueueDisc()->Dequeue();
+            if (item)
+            {
+                m_batchCount++;
+                NS_LOG_LOGIC("Dequeued packet from shard " << m_currentShard);
+                return item;
+            }
+        }
+        m_currentShard = (m_currentShard + 1) % nShards;
+        m_batchCount = 0;
+    }
+
+    NS_LOG_LOGIC("Queue empty");
+    return nullptr;
 }
 
 Ptr<const QueueDiscItem>
 MqQueueDisc::DoPeek()
 {
-    NS_FATAL_ERROR("MqQueueDisc: DoPeek should never be called");
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_UNLESS(m_sharding, "MqQueueDisc: DoPeek should never be called");
+
+    uint32_t nShards = GetNQueueDiscClasses();
+    uint32_t shard = m_currentShard;
+    uint32_t batchCount = m_batchCount;
+
+    // Return the packet that DoDequeue would return
+    for (uint32_t i = 0; i <= nShards; i++)
+    {
+        if (batchCount < m_batchSize)
+        {
+            Ptr<const QueueDiscItem> item = GetQueueDiscClass(shard)->GetQueueDisc()->Peek();
+            if (item)
+            {
+                return item;
+            }
+        }
+        shard = (shard + 1) % nShards;
+        batchCount = 0;
+    }
+
+    return nullptr;
 }
 
 bool
@@ -68,7 +150,29 @@ MqQueueDisc::CheckConfig()
 {
     NS_LOG_FUNCTION(this);
 
-    if (GetNPacketFilters() > 0)
+    if (m_sharding)
+    {
+        if (GetNQueueDiscClasses() == 0)
+        {
+            NS_LOG_ERROR("MqQueueDisc needs at least a child queue disc to shard the traffic");
+            return false;
+        }
+
+        Ptr<NetDeviceQueueInterface> ndqi = GetNetDeviceQueueInterface();
+        if (ndqi && ndqi->GetNTxQueues() > 1)
+        {
+            NS_LOG_ERROR("MqQueueDisc can only shard the traffic of single-queue devices");
+            return false;
+        }
+
+        // the shards are not grafted to a device queue by the traffic control
+        // layer, but they may need the device (e.g., to get its MTU)
+        for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
+        {
+            GetQueueDiscClass(i)->GetQueueDisc()->SetNetDeviceQueueInterface(ndqi);
+        }
+    }
+    else if (GetNPacketFilters() > 0)
     {
         NS_LOG_ERROR("MqQueueDisc cannot have packet filters");
         return false;
@@ -21,6 +21,12 @@ namespace ns3
  * mq is a classful multi-queue aware dummy scheduler. It has as many child
  * queue discs as the number of device transmission queues. Packets are
  * directly enqueued into and dequeued from child queue discs.
+ *
+ * If the Sharding attribute is set, mq instead shards the traffic of a
+ * single-queue device among its child queue discs: packets are enqueued into
+ * the child selected by the packet filters or, by default, by the flow hash,
+ * and the children are drained in round robin, up to BatchSize packets at a
+ * time, whenever the device transmission queue is not stopped.
  */
 class MqQueueDisc : public QueueDisc
 {
@@ -49,6 +55,11 @@ class MqQueueDisc : public QueueDisc
     Ptr<const QueueDiscItem> DoPeek() override;
     bool CheckConfig() override;
     void InitializeParams() override;
+
+    bool m_sharding;         //!< True to shard the traffic among the child queue discs
+    uint32_t m_batchSize;    //!< Max number of packets dequeued at a time from a shard
+    uint32_t m_currentShard; //!< Index of the shard being drained
+    uint32_t m_batchCount;   //!< Number of packets dequeued from the current shard
 };
 
 } // namespace ns3
@@ -108,6 +108,13 @@ PieQueueDisc::GetTypeId()
                           BooleanValue(false),
                           MakeBooleanAccessor(&PieQueueDisc::m_useDerandomization),
                           MakeBooleanChecker())
+            .AddAttribute("UseLazyUpdate",
+                          "Update the drop probability at enqueue and dequeue time, for the "
+                          "Tupdate periods elapsed since the last update, instead of "
+                          "scheduling an update event every Tupdate",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PieQueueDisc::m_useLazyUpdate),
+                          MakeBooleanChecker())
             .AddAttribute("ActiveThreshold",
                           "Threshold for activating PIE (disabled by default)",
                           TimeValue(Time::Max()),
@@ -168,6 +175,11 @@ PieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
     NS_LOG_FUNCTION(this << item);
 
+    if (m_useLazyUpdate)
+    {
+        RunDueUpdates(GetParams(), *this, GetInternalQueue(0)->GetNBytes());
+    }
+
     QueueSize nQueued = GetCurrentSize();
     // If L4S is enabled, then check if the packet is ECT1, and if it is then set isEct true
     bool isEct1 = false;
@@ -199,7 +211,7 @@ PieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     // isEct1 will be true only if L4S enabled as well as the packet is ECT1.
     // If L4S is enabled and packet is ECT1 then directly enqueue the packet.
     else if ((m_activeThreshold == Time::Max() || m_active) && !isEct1 &&
-             DropEarly(item, nQueued.GetValue()))
+             ShouldDropEarly(GetParams(), *this, item->GetSize(), nQueued.GetValue()))
     {
         if (!m_useEcn || m_dropProb >= m_markEcnTh || !Mark(item, UNFORCED_MARK))
         {
@@ -258,202 +270,42 @@ PieQueueDisc::InitializeParams()
     m_qDelayOld = Seconds(0);
     m_accuProb = 0.0;
     m_active = false;
-}
 
-bool
-PieQueueDisc::DropEarly(Ptr<QueueDiscItem> item, uint32_t qSize)
-{
-    NS_LOG_FUNCTION(this << item << qSize);
-    if (m_burstAllowance.GetSeconds() > 0)
+    if (m_useLazyUpdate)
     {
-        // If there is still burst_allowance left, skip random early drop.
-        return false;
-    }
-
-    if (m_burstState == NO_BURST)
-    {
-        m_burstState = IN_BURST_PROTECTING;
-        m_burstAllowance = m_maxBurst;
-    }
-
-    double p = m_dropProb;
-
-    uint32_t packetSize = item->GetSize();
-
-    if (GetMaxSize().GetUnit() == QueueSizeUnit::BYTES)
-    {
-        p = p * packetSize / m_meanPktSize;
-    }
-
-    // Safeguard PIE to be work conserving (Section 4.1 of RFC 8033)
-    if ((m_qDelayOld.GetSeconds() < (0.5 * m_qDelayRef.GetSeconds()) && m_dropProb < 0.2) ||
-        (GetMaxSize().GetUnit() == QueueSizeUnit::BYTES && qSize <= 2 * m_meanPktSize) ||
-        (GetMaxSize().GetUnit() == QueueSizeUnit::PACKETS && qSize <= 2))
-    {
-        return false;
-    }
-
-    if (m_useDerandomization)
-    {
-        if (m_dropProb == 0)
-        {
-            m_accuProb = 0;
-        }
-        m_accuProb += m_dropProb;
-        if (m_accuProb < 0.85)
-        {
-            return false;
-        }
-        else if (m_accuProb >= 8.5)
-        {
-            return true;
-        }
+        // the updates due from now on are run at enqueue and dequeue time
+        m_nextUpdate = m_rtrsEvent.IsPending() ? TimeStep(m_rtrsEvent.GetTs()) : Now();
+        m_rtrsEvent.Cancel();
     }
+}
 
-    double u = m_uv->GetValue();
-    return u <= p;
+PieQueueDisc::Params
+PieQueueDisc::GetParams() const
+{
+    return Params{m_tUpdate,
+                  m_qDelayRef,
+                  m_meanPktSize,
+                  m_maxBurst,
+                  m_a,
+                  m_b,
+                  m_dqThreshold,
+                  m_useDqRateEstimator,
+                  m_isCapDropAdjustment,
+                  m_useDerandomization,
+                  GetMaxSize().GetUnit()};
 }
 
 void
 PieQueueDisc::CalculateP()
 {
     NS_LOG_FUNCTION(this);
-    Time qDelay;
-    double p = 0.0;
-    bool missingInitFlag = false;
-
-    if (m_useDqRateEstimator)
-    {
-        if (m_avgDqRate > 0)
-        {
-            qDelay = Seconds(GetInternalQueue(0)->GetNBytes() / m_avgDqRate);
-        }
-        else
-        {
-            qDelay = Seconds(0);
-            missingInitFlag = true;
-        }
-        m_qDelay = qDelay;
-    }
-    else
-    {
-        qDelay = m_qDelay;
-    }
-    NS_LOG_DEBUG("Queue delay while calculating probability: " << qDelay.GetMilliSeconds() << "ms");
-
-    if (m_burstAllowance.GetSeconds() > 0)
-    {
-        m_dropProb = 0;
-    }
-    else
-    {
-        p = m_a * (qDelay.GetSeconds() - m_qDelayRef.GetSeconds()) +
-            m_b * (qDelay.GetSeconds() - m_qDelayOld.GetSeconds());
-        if (m_dropProb < 0.000001)
-        {
-            p /= 2048;
-        }
-        else if (m_dropProb < 0.00001)
-        {
-            p /= 512;
-        }
-        else if (m_dropProb < 0.0001)
-        {
-            p /= 128;
-        }
-        else if (m_dropProb < 0.001)
-        {
-            p /= 32;
-        }
-        else if (m_dropProb < 0.01)
-        {
-            p /= 8;
-        }
-        else if (m_dropProb < 0.1)
-        {
-            p /= 2;
-        }
-        else
-        {
-            // The pseudocode in Section 4.2 of RFC 8033 suggests to use this for
-            // assignment of p, but this assignment causes build failure on Mac OS
-            // p = p;
-        }
-
-        // Cap Drop Adjustment (Section 5.5 of RFC 8033)
-        if (m_isCapDropAdjustment && (m_dropProb >= 0.1) && (p > 0.02))
-        {
-            p = 0.02;
-        }
-    }
-
-    p += m_dropProb;
-
-    // For non-linear drop in prob
-    // Decay the drop probability exponentially (Section 4.2 of RFC 8033)
-    if (qDelay.GetSeconds() == 0 && m_qDelayOld.GetSeconds() == 0)
+    UpdateDropProb(GetParams(), *this, GetInternalQueue(0)->GetNBytes());
+    NS_LOG_DEBUG("Queue delay while calculating probability: " << m_qDelayOld.GetMilliSeconds()
+                                                               << "ms");
+    if (!m_useLazyUpdate)
     {
-        p *= 0.98;
+        m_rtrsEvent = Simulator::Schedule(m_tUpdate, &PieQueueDisc::CalculateP, this);
     }
-
-    // bound the drop probability (Section 4.2 of RFC 8033)
-    if (p < 0)
-    {
-        m_dropProb = 0;
-    }
-    else if (p > 1)
-    {
-        m_dropProb = 1;
-    }
-    else
-    {
-        m_dropProb = p;
-    }
-
-    // Section 4.4 #2
-    if (m_burstAllowance < m_tUpdate)
-    {
-        m_burstAllowance = Seconds(0);
-    }
-    else
-    {
-        m_burstAllowance -= m_tUpdate;
-    }
-
-    auto burstResetLimit = static_cast<uint32_t>(BURST_RESET_TIMEOUT / m_tUpdate.GetSeconds());
-    if ((qDelay.GetSeconds() < 0.5 * m_qDelayRef.GetSeconds()) &&
-        (m_qDelayOld.GetSeconds() < (0.5 * m_qDelayRef.GetSeconds())) && (m_dropProb == 0) &&
-        !missingInitFlag)
-    {
-        m_dqCount = DQCOUNT_INVALID;
-        m_avgDqRate = 0.0;
-    }
-    if ((qDelay.GetSeconds() < 0.5 * m_qDelayRef.GetSeconds()) &&
-        (m_qDelayOld.GetSeconds() < (0.5 * m_qDelayRef.GetSeconds())) && (m_dropProb == 0) &&
-        (m_burstAllowance.GetSeconds() == 0))
-    {
-        if (m_burstState == IN_BURST_PROTECTING)
-        {
-            m_burstState = IN_BURST;
-            m_burstReset = 0;
-        }
-        else if (m_burstState == IN_BURST)
-        {
-            m_burstReset++;
-            if (m_burstReset > burstResetLimit)
-            {
-                m_burstReset = 0;
-                m_burstState = NO_BURST;
-            }
-        }
-    }
-    else if (m_burstState == IN_BURST)
-    {
-        m_burstReset = 0;
-    }
-
-    m_qDelayOld = qDelay;
-    m_rtrsEvent = Simulator::Schedule(m_tUpdate, &PieQueueDisc::CalculateP, this);
 }
 
 Ptr<QueueDiscItem>
@@ -461,6 +313,11 @@ PieQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
+    if (m_useLazyUpdate)
+    {
+        RunDueUpdates(GetParams(), *this, GetInternalQueue(0)->GetNBytes());
+    }
+
     if (GetInternalQueue(0)->IsEmpty())
     {
         NS_LOG_LOGIC("Queue empty");
@@ -496,63 +353,8 @@ PieQueueDisc::DoDequeue()
         }
     }
 
-    // if not in a measurement cycle and the queue has built up to dq_threshold,
-    // start the measurement cycle
-    if (m_useDqRateEstimator)
-    {
-        if ((GetInternalQueue(0)->GetNBytes() >= m_dqThreshold) && (!m_inMeasurement))
-        {
-            m_dqStart = Now();
-            m_dqCount = 0;
-            m_inMeasurement = true;
-        }
-
-        if (m_inMeasurement)
-        {
-            m_dqCount += item->GetSize();
-
-            // done with a measurement cycle
-            if (m_dqCount >= m_dqThreshold)
-            {
-                Time dqTime = Now() - m_dqStart;
-                if (dqTime > Seconds(0))
-                {
-                    if (m_avgDqRate == 0)
-                    {
-                        m_avgDqRate = m_dqCount / dqTime.GetSeconds();
-                    }
-                    else
-                    {
-                        m_avgDqRate =
-                            (0.5 * m_avgDqRate) + (0.5 * (m_dqCount / dqTime.GetSeconds()));
-                    }
-                }
-                NS_LOG_DEBUG("Average Dequeue Rate after Dequeue: " << m_avgDqRate);
-
-                // restart a measurement cycle if there is enough data
-                if (GetInternalQueue(0)->GetNBytes() > m_dqThreshold)
-                {
-                    m_dqStart = Now();
-                    m_dqCount = 0;
-                    m_inMeasurement = true;
-                }
-                else
-                {
-                    m_dqCount = 0;
-                    m_inMeasurement = false;
-                }
-            }
-        }
-    }
-    else
-    {
-        m_qDelay = Now() - item->GetTimeStamp();
-
-        if (GetInternalQueue(0)->GetNBytes() == 0)
-        {
-            m_qDelay = Seconds(0);
-        }
-    }
+    MeasureDequeue(GetParams(), *this, item, GetInternalQueue(0)->GetNBytes());
+    NS_LOG_DEBUG("Average Dequeue Rate after Dequeue: " << m_avgDqRate);
     return item;
 }
 
@@ -23,8 +23,11 @@
 #include "ns3/event-id.h"
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
 #include "ns3/timer.h"
 
+#include <tuple>
+
 #define BURST_RESET_TIMEOUT 1.5
 
 class PieQueueDiscTestCase; // Forward declaration for unit test
@@ -85,6 +88,81 @@ class PieQueueDisc : public QueueDisc
      */
     int64_t AssignStreams(int64_t stream);
 
+    /**
+     * \brief The parameters of the PIE algorithm
+     *
+     * The PIE algorithm is run by this queue disc on its queue and by
+     * FqPieQueueDisc on each flow queue, through the static methods below.
+     * These methods update the state of the queue held by a PieQueueDisc or an
+     * FqPieFlow, i.e., the members named as those of PieQueueDisc.
+     */
+    struct Params
+    {
+        Time tUpdate;             //!< Time period after which the drop probability is updated
+        Time qDelayRef;           //!< Desired queue delay
+        uint32_t meanPktSize;     //!< Average packet size in bytes
+        Time maxBurst;            //!< Maximum burst allowed before random early dropping kicks in
+        double a;                 //!< Parameter to pie controller
+        double b;                 //!< Parameter to pie controller
+        uint32_t dqThreshold;     //!< Minimum queue size in bytes before dequeue rate is measured
+        bool useDqRateEstimator;  //!< Use the dequeue rate estimator for the queue delay
+        bool isCapDropAdjustment; //!< Enable Cap Drop Adjustment feature mentioned in RFC 8033
+        bool useDerandomization;  //!< Enable Derandomization feature mentioned in RFC 8033
+        QueueSizeUnit unit;       //!< Unit of the size of the queue
+    };
+
+    /**
+     * \brief Check if a packet needs to be dropped due to probability drop
+     * \tparam Queue the type holding the state of the queue
+     * \param params the parameters of the algorithm
+     * \param queue the state of the queue
+     * \param packetSize the size of the packet, in bytes
+     * \param qSize the size of the queue, in the unit of the parameters
+     * \returns true if the packet has to be dropped
+     */
+    template <class Queue>
+    static bool ShouldDropEarly(const Params& params,
+                                Queue& queue,
+                                uint32_t packetSize,
+                                uint32_t qSize);
+
+    /**
+     * Update the drop probability of a queue based on the delay samples:
+     * not only the current delay sample but also the trend where the delay
+     * is going, up or down
+     * \tparam Queue the type holding the state of the queue
+     * \param params the parameters of the algorithm
+     * \param queue the state of the queue
+     * \param backlog the number of bytes in the queue
+     */
+    template <class Queue>
+    static void UpdateDropProb(const Params& params, Queue& queue, uint32_t backlog);
+
+    /**
+     * Run the updates of the drop probability of a queue that were due by now,
+     * when the updates are run at enqueue and dequeue time
+     * \tparam Queue the type holding the state of the queue
+     * \param params the parameters of the algorithm
+     * \param queue the state of the queue
+     * \param backlog the number of bytes in the queue
+     */
+    template <class Queue>
+    static void RunDueUpdates(const Params& params, Queue& queue, uint32_t backlog);
+
+    /**
+     * Update the dequeue rate or the queue delay of a queue after a packet is dequeued
+     * \tparam Queue the type holding the state of the queue
+     * \param params the parameters of the algorithm
+     * \param queue the state of the queue
+     * \param item the dequeued packet
+     * \param backlog the number of bytes left in the queue
+     */
+    template <class Queue>
+    static void MeasureDequeue(const Params& params,
+                               Queue& queue,
+                               Ptr<const QueueDiscItem> item,
+                               uint32_t backlog);
+
     // Reasons for dropping packets
     static constexpr const char* UNFORCED_DROP =
         "Unforced drop"; //!< Early probability drops: proactive
@@ -113,12 +191,10 @@ class PieQueueDisc : public QueueDisc
     void InitializeParams() override;
 
     /**
-     * \brief Check if a packet needs to be dropped due to probability drop
-     * \param item queue item
-     * \param qSize queue size
-     * \returns 0 for no drop, 1 for drop
+     * \brief Get the parameters of the algorithm, from the attributes
+     * \return the parameters of the algorithm
      */
-    bool DropEarly(Ptr<QueueDiscItem> item, uint32_t qSize);
+    Params GetParams() const;
 
     /**
      * Periodically update the drop probability based on the delay samples:
@@ -149,6 +225,7 @@ class PieQueueDisc : public QueueDisc
     Time m_activeThreshold;    //!< Threshold for activating PIE (disabled by default)
     Time m_ceThreshold;        //!< Threshold above which to CE mark
     bool m_useL4s;             //!< True if L4S is used (ECT1 packets are marked at CE threshold)
+    bool m_useLazyUpdate;      //!< True to update the drop probability at enqueue/dequeue time
 
     // ** Variables maintained by PIE
     double m_dropProb;        //!< Variable used in calculation of drop probability
@@ -167,8 +244,303 @@ class PieQueueDisc : public QueueDisc
     Ptr<UniformRandomVariable> m_uv; //!< Rng stream
     double m_accuProb;               //!< Accumulated drop probability
     bool m_active;                   //!< Indicates whether PIE is in active state or not
+    Time m_nextUpdate;               //!< Time of the next update of the drop probability
 };
 
+template <class Queue>
+bool
+PieQueueDisc::ShouldDropEarly(const Params& params,
+                              Queue& queue,
+                              uint32_t packetSize,
+                              uint32_t qSize)
+{
+    if (queue.m_burstAllowance.GetSeconds() > 0)
+    {
+        // If there is still burst_allowance left, skip random early drop.
+        return false;
+    }
+
+    if (queue.m_burstState == NO_BURST)
+    {
+        queue.m_burstState = IN_BURST_PROTECTING;
+        queue.m_burstAllowance = params.maxBurst;
+    }
+
+    double p = queue.m_dropProb;
+
+    if (params.unit == QueueSizeUnit::BYTES)
+    {
+        p = p * packetSize / params.meanPktSize;
+    }
+
+    // Safeguard PIE to be work conserving (Section 4.1 of RFC 8033)
+    if ((queue.m_qDelayOld.GetSeconds() < (0.5 * params.qDelayRef.GetSeconds()) &&
+         queue.m_dropProb < 0.2) ||
+        (params.unit == QueueSizeUnit::BYTES && qSize <= 2 * params.meanPktSize) ||
+        (params.unit == QueueSizeUnit::PACKETS && qSize <= 2))
+    {
+        return false;
+    }
+
+    if (params.useDerandomization)
+    {
+        if (queue.m_dropProb == 0)
+        {
+            queue.m_accuProb = 0;
+        }
+        queue.m_accuProb += queue.m_dropProb;
+        if (queue.m_accuProb < 0.85)
+        {
+            return false;
+        }
+        else if (queue.m_accuProb >= 8.5)
+        {
+            return true;
+        }
+    }
+
+    double u = queue.m_uv->GetValue();
+    return u <= p;
+}
+
+template <class Queue>
+void
+PieQueueDisc::UpdateDropProb(const Params& params, Queue& queue, uint32_t backlog)
+{
+    Time qDelay;
+    double p = 0.0;
+    bool missingInitFlag = false;
+
+    if (params.useDqRateEstimator)
+    {
+        if (queue.m_avgDqRate > 0)
+        {
+            qDelay = Seconds(backlog / queue.m_avgDqRate);
+        }
+        else
+        {
+            qDelay = Seconds(0);
+            missingInitFlag = true;
+        }
+        queue.m_qDelay = qDelay;
+    }
+    else
+    {
+        qDelay = queue.m_qDelay;
+    }
+
+    if (queue.m_burstAllowance.GetSeconds() > 0)
+    {
+        queue.m_dropProb = 0;
+    }
+    else
+    {
+        p = params.a * (qDelay.GetSeconds() - params.qDelayRef.GetSeconds()) +
+            params.b * (qDelay.GetSeconds() - queue.m_qDelayOld.GetSeconds());
+        if (queue.m_dropProb < 0.000001)
+        {
+            p /= 2048;
+        }
+        else if (queue.m_dropProb < 0.00001)
+        {
+            p /= 512;
+        }
+        else if (queue.m_dropProb < 0.0001)
+        {
+            p /= 128;
+        }
+        else if (queue.m_dropProb < 0.001)
+        {
+            p /= 32;
+        }
+        else if (queue.m_dropProb < 0.01)
+        {
+            p /= 8;
+        }
+        else if (queue.m_dropProb < 0.1)
+        {
+            p /= 2;
+        }
+        else
+        {
+            // The pseudocode in Section 4.2 of RFC 8033 suggests to use this for
+            // assignment of p, but this assignment causes build failure on Mac OS
+            // p = p;
+        }
+
+        // Cap Drop Adjustment (Section 5.5 of RFC 8033)
+        if (params.isCapDropAdjustment && (queue.m_dropProb >= 0.1) && (p > 0.02))
+        {
+            p = 0.02;
+        }
+    }
+
+    p += queue.m_dropProb;
+
+    // For non-linear drop in prob
+    // Decay the drop probability exponentially (Section 4.2 of RFC 8033)
+    if (qDelay.GetSeconds() == 0 && queue.m_qDelayOld.GetSeconds() == 0)
+    {
+        p *= 0.98;
+    }
+
+    // bound the drop probability (Section 4.2 of RFC 8033)
+    if (p < 0)
+    {
+        queue.m_dropProb = 0;
+    }
+    else if (p > 1)
+    {
+        queue.m_dropProb = 1;
+    }
+    else
+    {
+        queue.m_dropProb = p;
+    }
+
+    // Section 4.4 #2
+    if (queue.m_burstAllowance < params.tUpdate)
+    {
+        queue.m_burstAllowance = Seconds(0);
+    }
+    else
+    {
+        queue.m_burstAllowance -= params.tUpdate;
+    }
+
+    auto burstResetLimit = static_cast<uint32_t>(BURST_RESET_TIMEOUT / params.tUpdate.GetSeconds());
+    bool lowDelay = (qDelay.GetSeconds() < 0.5 * params.qDelayRef.GetSeconds()) &&
+                    (queue.m_qDelayOld.GetSeconds() < (0.5 * params.qDelayRef.GetSeconds())) &&
+                    (queue.m_dropProb == 0);
+    if (lowDelay && !missingInitFlag)
+    {
+        queue.m_dqCount = DQCOUNT_INVALID;
+        queue.m_avgDqRate = 0.0;
+    }
+    if (lowDelay && (queue.m_burstAllowance.GetSeconds() == 0))
+    {
+        if (queue.m_burstState == IN_BURST_PROTECTING)
+        {
+            queue.m_burstState = IN_BURST;
+            queue.m_burstReset = 0;
+        }
+        else if (queue.m_burstState == IN_BURST)
+        {
+            queue.m_burstReset++;
+            if (queue.m_burstReset > burstResetLimit)
+            {
+                queue.m_burstReset = 0;
+                queue.m_burstState = NO_BURST;
+            }
+        }
+    }
+    else if (queue.m_burstState == IN_BURST)
+    {
+        queue.m_burstReset = 0;
+    }
+
+    queue.m_qDelayOld = qDelay;
+}
+
+template <class Queue>
+void
+PieQueueDisc::RunDueUpdates(const Params& params, Queue& queue, uint32_t backlog)
+{
+    auto state = [&queue]() {
+        return std::make_tuple(queue.m_dropProb,
+                               queue.m_qDelayOld,
+                               queue.m_qDelay,
+                               queue.m_burstAllowance,
+                               queue.m_burstReset,
+                               queue.m_burstState,
+                               queue.m_avgDqRate,
+                               queue.m_dqCount);
+    };
+
+    Time now = Simulator::Now();
+    while (queue.m_nextUpdate <= now)
+    {
+        auto before = state();
+        UpdateDropProb(params, queue, backlog);
+        queue.m_nextUpdate += params.tUpdate;
+
+        // The queue does not change until now, hence an update that leaves the
+        // state unchanged (e.g., an idle queue with no drop probability left)
+        // would leave it unchanged at the following periods as well
+        if (state() == before && queue.m_nextUpdate <= now)
+        {
+            int64_t skipped =
+                (now - queue.m_nextUpdate).GetTimeStep() / params.tUpdate.GetTimeStep() + 1;
+            queue.m_nextUpdate += params.tUpdate * skipped;
+        }
+    }
+}
+
+template <class Queue>
+void
+PieQueueDisc::MeasureDequeue(const Params& params,
+                             Queue& queue,
+                             Ptr<const QueueDiscItem> item,
+                             uint32_t backlog)
+{
+    // if not in a measurement cycle and the queue has built up to dq_threshold,
+    // start the measurement cycle
+    if (params.useDqRateEstimator)
+    {
+        if ((backlog >= params.dqThreshold) && (!queue.m_inMeasurement))
+        {
+            queue.m_dqStart = Simulator::Now();
+            queue.m_dqCount = 0;
+            queue.m_inMeasurement = true;
+        }
+
+        if (queue.m_inMeasurement)
+        {
+            queue.m_dqCount += item->GetSize();
+
+            // done with a measurement cycle
+            if (queue.m_dqCount >= params.dqThreshold)
+            {
+                Time dqTime = Simulator::Now() - queue.m_dqStart;
+                if (dqTime > Seconds(0))
+                {
+                    if (queue.m_avgDqRate == 0)
+                    {
+                        queue.m_avgDqRate = queue.m_dqCount / dqTime.GetSeconds();
+                    }
+                    else
+                    {
+                        queue.m_avgDqRate = (0.5 * queue.m_avgDqRate) +
+                                            (0.5 * (queue.m_dqCount / dqTime.GetSeconds()));
+                    }
+                }
+
+                // restart a measurement cycle if there is enough data
+                if (backlog > params.dqThreshold)
+                {
+                    queue.m_dqStart = Simulator::Now();
+                    queue.m_dqCount = 0;
+                    queue.m_inMeasurement = true;
+                }
+                else
+                {
+                    queue.m_dqCount = 0;
+                    queue.m_inMeasurement = false;
+                }
+            }
+        }
+    }
+    else
+    {
+        queue.m_qDelay = Simulator::Now() - item->GetTimeStamp();
+
+        if (backlog == 0)
+        {
+            queue.m_qDelay = Seconds(0);
+        }
+    }
+}
+
 }; // namespace ns3
 
 #endif
@@ -561,6 +561,30 @@ class QueueDisc : public Object
      */
     bool Mark(Ptr<QueueDiscItem> item, const char* reason);
 
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet enqueue
+     *
+     * The internal queues and the child queue discs notify their queue disc
+     * through their Enqueue trace. A queue disc storing its packets otherwise
+     * (e.g., the flow queueing disciplines) calls this method explicitly.
+     *
+     * \param item item that was enqueued
+     */
+    void PacketEnqueued(Ptr<const QueueDiscItem> item);
+
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet dequeue
+     *
+     * As PacketEnqueued, this method has to be called explicitly for a packet
+     * not dequeued from an internal queue or a child queue disc, including a
+     * packet dequeued in order to be dropped.
+     *
+     * \param item item that was dequeued
+     */
+    void PacketDequeued(Ptr<const QueueDiscItem> item);
+
   private:
     /**
      * This function actually enqueues a packet into the queue disc.
@@ -659,20 +683,6 @@ class QueueDisc : public Object
      */
     bool Transmit(Ptr<QueueDiscItem> item);
 
-    /**
-     * \brief Perform the actions required when the queue disc is notified of
-     *        a packet enqueue
-     * \param item item that was enqueued
-     */
-    void PacketEnqueued(Ptr<const QueueDiscItem> item);
-
-    /**
-     * \brief Perform the actions required when the queue disc is notified of
-     *        a packet dequeue
-     * \param item item that was dequeued
-     */
-    void PacketDequeued(Ptr<const QueueDiscItem> item);
-
     /// Default quota (as in /proc/sys/net/core/dev_weight)
     static const uint32_t DEFAULT_QUOTA = 64;
 
@@ -544,6 +544,8 @@ RedQueueDisc::InitializeParams()
         m_qW = 1.0 - std::exp(-10.0 / m_ptc);
     }
 
+    TabulateDecay(m_qW);
+
     if (m_bottom == 0)
     {
         m_bottom = 0.01;
@@ -623,7 +625,12 @@ RedQueueDisc::Estimator(uint32_t nQueued, uint32_t m, double qAvg, double qW)
 {
     NS_LOG_FUNCTION(this << nQueued << m << qAvg << qW);
 
-    double newAve = qAvg * std::pow(1.0 - qW, m);
+    if (qW != m_tabulatedQW)
+    {
+        TabulateDecay(qW);
+    }
+
+    double newAve = qAvg * DecayFactor(m);
     newAve += qW * nQueued;
 
     Time now = Simulator::Now();
@@ -639,6 +646,37 @@ RedQueueDisc::Estimator(uint32_t nQueued, uint32_t m, double qAvg, double qW)
     return newAve;
 }
 
+void
+RedQueueDisc::TabulateDecay(double qW)
+{
+    NS_LOG_FUNCTION(this << qW);
+
+    // tabulate the powers of (1 - qW) used to decay the average queue size, so
+    // that no power is computed per packet
+    m_tabulatedQW = qW;
+    m_qWPowers[0] = 1.0 - qW;
+    for (std::size_t i = 1; i < m_qWPowers.size(); i++)
+    {
+        m_qWPowers[i] = m_qWPowers[i - 1] * m_qWPowers[i - 1];
+    }
+    m_cautiousFraction = std::pow(1.0 - qW, m_ptc * 0.05);
+}
+
+double
+RedQueueDisc::DecayFactor(uint32_t m) const
+{
+    // multiply the powers of (1 - qW) for the bits set in m
+    double factor = 1.0;
+    for (std::size_t i = 0; m != 0; i++, m >>= 1)
+    {
+        if (m & 1)
+        {
+            factor *= m_qWPowers[i];
+        }
+    }
+    return factor;
+}
+
 // Check if packet p needs to be dropped due to probability mark
 bool
 RedQueueDisc::DropEarly(Ptr<QueueDiscItem> item, uint32_t qSize)
@@ -654,12 +692,9 @@ RedQueueDisc::DropEarly(Ptr<QueueDiscItem> item, uint32_t qSize)
         /*
          * Don't drop/mark if the instantaneous queue is much below the average.
          * For experimental purposes only.
-         * pkts: the number of packets arriving in 50 ms
+         * m_cautiousFraction: the decay of the average over the packets arriving in 50 ms
          */
-        double pkts = m_ptc * 0.05;
-        double fraction = std::pow((1 - m_qW), pkts);
-
-        if ((double)qSize < fraction * m_qAvg)
+        if ((double)qSize < m_cautiousFraction * m_qAvg)
         {
             // Queue could have been empty for 0.05 seconds
             return false;
@@ -674,11 +709,9 @@ RedQueueDisc::DropEarly(Ptr<QueueDiscItem> item, uint32_t qSize)
          * Decrease the drop probability if the instantaneous
          * queue is much below the average.
          * For experimental purposes only.
-         * pkts: the number of packets arriving in 50 ms
+         * m_cautiousFraction: the decay of the average over the packets arriving in 50 ms
          */
-        double pkts = m_ptc * 0.05;
-        double fraction = std::pow((1 - m_qW), pkts);
-        double ratio = qSize / (fraction * m_qAvg);
+        double ratio = qSize / (m_cautiousFraction * m_qAvg);
 
         if (ratio < 1.0)
         {
@@ -56,6 +56,10 @@
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
 
+#include <array>
+
+class RedQueueDiscQueueWeightTestCase;
+
 namespace ns3
 {
 
@@ -196,6 +200,12 @@ class RedQueueDisc : public QueueDisc
     void DoDispose() override;
 
   private:
+    /**
+     * \brief RedQueueDiscQueueWeightTestCase friend class (for tests).
+     * \relates RedQueueDiscQueueWeightTestCase
+     */
+    friend class ::RedQueueDiscQueueWeightTestCase;
+
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
     Ptr<QueueDiscItem> DoDequeue() override;
     Ptr<const QueueDiscItem> DoPeek() override;
@@ -219,6 +229,21 @@ class RedQueueDisc : public QueueDisc
      * \returns new average queue size
      */
     double Estimator(uint32_t nQueued, uint32_t m, double qAvg, double qW);
+    /**
+     * \brief Tabulate the powers of (1 - qW) used to decay the average queue size
+     *
+     * Called whenever the queue weight differs from the one the powers were
+     * tabulated for, e.g., when the QW attribute is changed at run time.
+     *
+     * \param qW the queue weight
+     */
+    void TabulateDecay(double qW);
+    /**
+     * \brief Compute (1 - qW)^m from the tabulated powers of (1 - qW)
+     * \param m the exponent
+     * \returns (1 - qW)^m
+     */
+    double DecayFactor(uint32_t m) const;
     /**
      * \brief Update m_curMaxP
      * \param newAve new average queue length
@@ -301,6 +326,10 @@ class RedQueueDisc : public QueueDisc
     uint32_t m_cautious;
     Time m_idleTime; //!< Start of current idle period
 
+    double m_tabulatedQW;              //!< The queue weight m_qWPowers were tabulated for
+    std::array<double, 32> m_qWPowers; //!< (1 - qW)^(2^i), to decay m_qAvg over idle periods
+    double m_cautiousFraction;         //!< (1 - qW)^(packets arriving in 50 ms)
+
     Ptr<UniformRandomVariable> m_uv; //!< rng stream
 };
 
@@ -353,6 +353,18 @@ TrafficControlLayer::Send(Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
 
     NS_LOG_DEBUG("Send packet to device " << device << " protocol number " << item->GetProtocol());
 
+    // A super-segment built by a sender using segmentation offload goes through
+    // the network layer as a single packet and is split here, so that the queue
+    // disc and the device only see the packets transmitted on the wire
+    if (auto segments = item->Segment(); !segments.empty())
+    {
+        for (const auto& segment : segments)
+        {
+            Send(device, segment);
+        }
+        return;
+    }
+
     Ptr<NetDeviceQueueInterface> devQueueIface;
     auto ndi = m_netDevices.find(device);
 
@@ -379,7 +391,13 @@ TrafficControlLayer::Send(Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
     if (ndi == m_netDevices.end() || !ndi->second.m_rootQueueDisc)
     {
         // The device has no attached queue disc, thus add the header to the packet and
-        // send it directly to the device if the selected queue is not stopped
+        // send it directly to the device if the selected queue is not stopped. The
+        // packet is marked (before the header is added) if the device queue has
+        // reached its mark threshold
+        if (devQueueIface && devQueueIface->GetTxQueue(txq)->IsMarkThresholdReached())
+        {
+            item->Mark();
+        }
         item->AddHeader();
         if (!devQueueIface || !devQueueIface->GetTxQueue(txq)->IsStopped())
         {
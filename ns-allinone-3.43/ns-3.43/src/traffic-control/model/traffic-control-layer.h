@@ -195,6 +195,9 @@ class TrafficControlLayer : public Object
     /**
      * \brief Called from upper layer to queue a packet for the transmission.
      *
+     * A super-segment is split into the packets transmitted on the wire (see
+     * QueueDiscItem::Segment), which are queued one by one.
+     *
      * \param device the device the packet must be sent to
      * \param item a queue item including a packet and additional information
      */
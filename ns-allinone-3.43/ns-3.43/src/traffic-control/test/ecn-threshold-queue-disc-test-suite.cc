@@ -0,0 +1,313 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/ecn-threshold-queue-disc.h"
+#include "ns3/mac48-address.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/traffic-control-layer.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief ECN Threshold Queue Disc Test Item
+ */
+class EcnThresholdQueueDiscTestItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet
+     * \param ecnCapable whether the packet can be marked
+     */
+    EcnThresholdQueueDiscTestItem(Ptr<Packet> p, bool ecnCapable);
+    void AddHeader() override;
+    bool Mark() override;
+
+    /**
+     * \return true if the packet has been marked
+     */
+    bool IsMarked() const;
+
+  private:
+    bool m_ecnCapable; //!< whether the packet can be marked
+    bool m_marked;     //!< whether the packet has been marked
+};
+
+EcnThresholdQueueDiscTestItem::EcnThresholdQueueDiscTestItem(Ptr<Packet> p, bool ecnCapable)
+    : QueueDiscItem(p, Mac48Address(), 0),
+      m_ecnCapable(ecnCapable),
+      m_marked(false)
+{
+}
+
+void
+EcnThresholdQueueDiscTestItem::AddHeader()
+{
+}
+
+bool
+EcnThresholdQueueDiscTestItem::Mark()
+{
+    m_marked |= m_ecnCapable;
+    return m_ecnCapable;
+}
+
+bool
+EcnThresholdQueueDiscTestItem::IsMarked() const
+{
+    return m_marked;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief ECN Threshold Queue Disc Test Case: the packets are marked when
+ * enqueued if the occupancy of the queue disc, in packets or bytes, is at
+ * least the mark threshold, and the packets that cannot be marked are either
+ * enqueued or dropped.
+ */
+class EcnThresholdQueueDiscEnqueueTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param unit the unit of the mark threshold
+     * \param dropNonEct whether to drop the packets that cannot be marked
+     */
+    EcnThresholdQueueDiscEnqueueTestCase(QueueSizeUnit unit, bool dropNonEct);
+
+  private:
+    void DoRun() override;
+
+    QueueSizeUnit m_unit; //!< the unit of the mark threshold
+    bool m_dropNonEct;    //!< whether to drop the packets that cannot be marked
+};
+
+EcnThresholdQueueDiscEnqueueTestCase::EcnThresholdQueueDiscEnqueueTestCase(QueueSizeUnit unit,
+                                                                           bool dropNonEct)
+    : TestCase(std::string("Marking above a threshold in ") +
+               (unit == QueueSizeUnit::PACKETS ? "packets" : "bytes") +
+               (dropNonEct ? ", dropping" : ", enqueuing") + " the non-ECT packets"),
+      m_unit(unit),
+      m_dropNonEct(dropNonEct)
+{
+}
+
+void
+EcnThresholdQueueDiscEnqueueTestCase::DoRun()
+{
+    const uint32_t pktSize = 1000;
+
+    Ptr<EcnThresholdQueueDisc> qdisc = CreateObject<EcnThresholdQueueDisc>();
+    qdisc->SetAttribute("MaxSize", QueueSizeValue(QueueSize("6p")));
+    qdisc->SetAttribute("MarkThreshold",
+                        QueueSizeValue(m_unit == QueueSizeUnit::PACKETS ? QueueSize("3p")
+                                                                        : QueueSize("2500B")));
+    qdisc->SetAttribute("DropNonEct", BooleanValue(m_dropNonEct));
+    qdisc->Initialize();
+
+    // the first three packets are enqueued below the threshold
+    std::vector<Ptr<EcnThresholdQueueDiscTestItem>> items;
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        items.push_back(Create<EcnThresholdQueueDiscTestItem>(Create<Packet>(pktSize), true));
+        NS_TEST_EXPECT_MSG_EQ(qdisc->Enqueue(items.back()), true, "The packet should be enqueued");
+        NS_TEST_EXPECT_MSG_EQ(items.back()->IsMarked(), (i >= 3), "Wrong mark of packet " << i);
+    }
+
+    // a non-ECT packet above the threshold
+    Ptr<EcnThresholdQueueDiscTestItem> nonEct =
+        Create<EcnThresholdQueueDiscTestItem>(Create<Packet>(pktSize), false);
+    NS_TEST_EXPECT_MSG_EQ(qdisc->Enqueue(nonEct),
+                          !m_dropNonEct,
+                          "Wrong handling of the non-ECT packet");
+    NS_TEST_EXPECT_MSG_EQ(nonEct->IsMarked(), false, "A non-ECT packet cannot be marked");
+    NS_TEST_EXPECT_MSG_EQ(
+        qdisc->GetStats().GetNDroppedPackets(EcnThresholdQueueDisc::THRESHOLD_EXCEEDED_DROP),
+        (m_dropNonEct ? 1 : 0),
+        "Wrong number of non-ECT packets dropped");
+
+    // the queue disc is full if the non-ECT packet has been enqueued
+    qdisc->Enqueue(Create<EcnThresholdQueueDiscTestItem>(Create<Packet>(pktSize), true));
+    NS_TEST_EXPECT_MSG_EQ(qdisc->GetNPackets(), 6, "Wrong number of packets queued");
+    NS_TEST_EXPECT_MSG_EQ(
+        qdisc->GetStats().GetNDroppedPackets(EcnThresholdQueueDisc::LIMIT_EXCEEDED_DROP),
+        (m_dropNonEct ? 0 : 1),
+        "Wrong number of packets dropped because of the limit");
+    NS_TEST_EXPECT_MSG_EQ(
+        qdisc->GetStats().GetNMarkedPackets(EcnThresholdQueueDisc::THRESHOLD_EXCEEDED_MARK),
+        (m_dropNonEct ? 3 : 2),
+        "Wrong number of packets marked");
+
+    // the packets are dequeued in order and without further marks
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(qdisc->Dequeue(), items[i], "Wrong packet dequeued");
+    }
+    NS_TEST_EXPECT_MSG_EQ(
+        qdisc->GetStats().GetNMarkedPackets(EcnThresholdQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        0,
+        "No packet should be marked when dequeued");
+
+    qdisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief ECN Threshold Queue Disc Test Case: the packets are marked when
+ * dequeued if their sojourn time exceeds the CE threshold.
+ */
+class EcnThresholdQueueDiscSojournTestCase : public TestCase
+{
+  public:
+    EcnThresholdQueueDiscSojournTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+EcnThresholdQueueDiscSojournTestCase::EcnThresholdQueueDiscSojournTestCase()
+    : TestCase("Marking above a sojourn time threshold")
+{
+}
+
+void
+EcnThresholdQueueDiscSojournTestCase::DoRun()
+{
+    Ptr<EcnThresholdQueueDisc> qdisc = CreateObject<EcnThresholdQueueDisc>();
+    qdisc->SetAttribute("MarkThreshold", QueueSizeValue(QueueSize("0p")));
+    qdisc->SetAttribute("CeThreshold", TimeValue(MilliSeconds(5)));
+    qdisc->Initialize();
+
+    std::vector<Ptr<EcnThresholdQueueDiscTestItem>> items;
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        items.push_back(Create<EcnThresholdQueueDiscTestItem>(Create<Packet>(1000), true));
+        qdisc->Enqueue(items.back());
+    }
+
+    // no mark at enqueue if the mark threshold is null
+    NS_TEST_EXPECT_MSG_EQ(
+        qdisc->GetStats().GetNMarkedPackets(EcnThresholdQueueDisc::THRESHOLD_EXCEEDED_MARK),
+        0,
+        "No packet should be marked when enqueued");
+
+    // a packet is dequeued every millisecond
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        Simulator::Schedule(MilliSeconds(i), [&, i]() {
+            NS_TEST_EXPECT_MSG_EQ(qdisc->Dequeue(), items[i], "Wrong packet dequeued");
+            NS_TEST_EXPECT_MSG_EQ(items[i]->IsMarked(), (i > 5), "Wrong mark of packet " << i);
+        });
+    }
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(
+        qdisc->GetStats().GetNMarkedPackets(EcnThresholdQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        14,
+        "Wrong number of packets marked");
+
+    qdisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief ECN Threshold Queue Disc Test Case: when no queue disc is installed
+ * on a device, the traffic control layer marks the packets sent to the device
+ * if the device queue has reached its mark threshold.
+ */
+class EcnThresholdDeviceQueueTestCase : public TestCase
+{
+  public:
+    EcnThresholdDeviceQueueTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+EcnThresholdDeviceQueueTestCase::EcnThresholdDeviceQueueTestCase()
+    : TestCase("Marking above the threshold of a device queue without queue disc")
+{
+}
+
+void
+EcnThresholdDeviceQueueTestCase::DoRun()
+{
+    NodeContainer n;
+    n.Create(2);
+
+    n.Get(0)->AggregateObject(CreateObject<TrafficControlLayer>());
+    n.Get(1)->AggregateObject(CreateObject<TrafficControlLayer>());
+
+    SimpleNetDeviceHelper simple;
+    NetDeviceContainer rxDevC = simple.Install(n.Get(1));
+
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("1Mb/s")));
+    simple.SetQueue("ns3::DropTailQueue",
+                    "MaxSize",
+                    StringValue("10p"),
+                    "MarkThreshold",
+                    StringValue("3p"));
+    Ptr<NetDevice> txDev =
+        simple.Install(n.Get(0), DynamicCast<SimpleChannel>(rxDevC.Get(0)->GetChannel())).Get(0);
+
+    // the first packet is transmitted at once, the others are queued in the device
+    std::vector<Ptr<EcnThresholdQueueDiscTestItem>> items;
+    Simulator::ScheduleNow([&]() {
+        Ptr<TrafficControlLayer> tc = n.Get(0)->GetObject<TrafficControlLayer>();
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            items.push_back(Create<EcnThresholdQueueDiscTestItem>(Create<Packet>(1000), true));
+            tc->Send(txDev, items.back());
+        }
+    });
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(items.size(), 8, "Wrong number of packets sent");
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(items[i]->IsMarked(), (i >= 4), "Wrong mark of packet " << i);
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief ECN Threshold Queue Disc Test Suite
+ */
+static class EcnThresholdQueueDiscTestSuite : public TestSuite
+{
+  public:
+    EcnThresholdQueueDiscTestSuite()
+        : TestSuite("ecn-threshold-queue-disc", Type::UNIT)
+    {
+        AddTestCase(new EcnThresholdQueueDiscEnqueueTestCase(QueueSizeUnit::PACKETS, false),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new EcnThresholdQueueDiscEnqueueTestCase(QueueSizeUnit::BYTES, false),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new EcnThresholdQueueDiscEnqueueTestCase(QueueSizeUnit::PACKETS, true),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new EcnThresholdQueueDiscSojournTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new EcnThresholdDeviceQueueTestCase(), TestCase::Duration::QUICK);
+    }
+} g_ecnThresholdQueueDiscTestSuite; ///< the test suite
@@ -0,0 +1,242 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/data-rate.h"
+#include "ns3/fluid-background-queue-disc.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Fluid Background Queue Disc Test Item
+ */
+class FluidBackgroundQueueDiscTestItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet
+     */
+    FluidBackgroundQueueDiscTestItem(Ptr<Packet> p);
+    void AddHeader() override;
+    bool Mark() override;
+};
+
+FluidBackgroundQueueDiscTestItem::FluidBackgroundQueueDiscTestItem(Ptr<Packet> p)
+    : QueueDiscItem(p, Address(), 0)
+{
+}
+
+void
+FluidBackgroundQueueDiscTestItem::AddHeader()
+{
+}
+
+bool
+FluidBackgroundQueueDiscTestItem::Mark()
+{
+    return false;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Fluid Background Queue Disc Test Case: without background flows, the
+ * packets are dequeued once the packets ahead of them have been transmitted,
+ * and the packets that exceed the max size are dropped.
+ */
+class FluidBackgroundQueueDiscFifoTestCase : public TestCase
+{
+  public:
+    FluidBackgroundQueueDiscFifoTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FluidBackgroundQueueDiscFifoTestCase::FluidBackgroundQueueDiscFifoTestCase()
+    : TestCase("Sanity check on the departures of the fluid background queue disc")
+{
+}
+
+void
+FluidBackgroundQueueDiscFifoTestCase::DoRun()
+{
+    Ptr<FluidBackgroundQueueDisc> qdisc = CreateObject<FluidBackgroundQueueDisc>();
+    qdisc->SetAttribute("LinkRate", DataRateValue(DataRate("10Mbps")));
+    qdisc->SetAttribute("MaxSize", QueueSizeValue(QueueSize("2500B")));
+    std::vector<Time> departures;
+    qdisc->SetSendCallback([&](Ptr<QueueDiscItem> item) {
+        departures.push_back(Simulator::Now());
+    });
+    qdisc->Initialize();
+
+    // the first two packets fill the queue disc, which is served at 10 Mbps
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        qdisc->Enqueue(Create<FluidBackgroundQueueDiscTestItem>(Create<Packet>(1250)));
+    }
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetNPackets(), 2, "The third packet should have been dropped");
+    NS_TEST_ASSERT_MSG_EQ(
+        qdisc->GetStats().GetNDroppedPackets(FluidBackgroundQueueDisc::LIMIT_EXCEEDED_DROP),
+        1,
+        "The third packet should have been dropped");
+
+    // a packet enqueued when the first one has been transmitted fits again
+    Simulator::Schedule(MilliSeconds(1), [&]() {
+        qdisc->Enqueue(Create<FluidBackgroundQueueDiscTestItem>(Create<Packet>(1250)));
+        qdisc->Run();
+    });
+    Simulator::ScheduleNow(&QueueDisc::Run, qdisc);
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(departures.size(), 3, "Wrong number of packets sent");
+    NS_TEST_EXPECT_MSG_EQ(departures[0], Seconds(0), "Wrong departure of the first packet");
+    NS_TEST_EXPECT_MSG_EQ(departures[1], MilliSeconds(1), "Wrong departure of the second packet");
+    NS_TEST_EXPECT_MSG_EQ(departures[2], MilliSeconds(2), "Wrong departure of the third packet");
+    NS_TEST_EXPECT_MSG_EQ(qdisc->GetUnfinishedWork(), 1250, "Only the last packet should be left");
+
+    qdisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Fluid Background Queue Disc Test Case: the background flows, possibly
+ * sharing the link with a constant bit rate packet source, use the capacity
+ * left by the packets and fill the queue.
+ */
+class FluidBackgroundQueueDiscRateTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param name the name of the test case
+     * \param cbrRate the rate of the packet source
+     */
+    FluidBackgroundQueueDiscRateTestCase(std::string name, DataRate cbrRate);
+
+  private:
+    void DoRun() override;
+
+    DataRate m_cbrRate; //!< the rate of the packet source
+};
+
+FluidBackgroundQueueDiscRateTestCase::FluidBackgroundQueueDiscRateTestCase(std::string name,
+                                                                           DataRate cbrRate)
+    : TestCase(name),
+      m_cbrRate(cbrRate)
+{
+}
+
+void
+FluidBackgroundQueueDiscRateTestCase::DoRun()
+{
+    const uint32_t pktSize = 1000;
+    const DataRate linkRate("10Mbps");
+    const Time warmup = Seconds(5);
+    const Time duration = Seconds(20);
+
+    Ptr<FluidBackgroundQueueDisc> qdisc = CreateObject<FluidBackgroundQueueDisc>();
+    qdisc->SetAttribute("LinkRate", DataRateValue(linkRate));
+    qdisc->SetAttribute("MaxSize", QueueSizeValue(QueueSize("100p")));
+    qdisc->SetAttribute("PacketSize", UintegerValue(pktSize));
+    qdisc->SetAttribute("Interval", TimeValue(MilliSeconds(1)));
+    uint32_t group = qdisc->AddBackgroundFlows(5, MilliSeconds(20));
+    qdisc->AddBackgroundFlows(5, MilliSeconds(40));
+
+    // a 10 Mbps link runs the queue disc again at the end of each transmission
+    uint64_t sent = 0;
+    Time maxDelay;
+    qdisc->SetSendCallback([&](Ptr<QueueDiscItem> item) {
+        if (Simulator::Now() >= warmup)
+        {
+            sent += item->GetSize();
+        }
+        maxDelay = Max(maxDelay, Simulator::Now() - item->GetTimeStamp());
+        Simulator::Schedule(linkRate.CalculateBytesTxTime(item->GetSize()), &QueueDisc::Run, qdisc);
+    });
+    qdisc->Initialize();
+
+    std::function<void()> cbr = [&]() {
+        Ptr<QueueDiscItem> item = Create<FluidBackgroundQueueDiscTestItem>(Create<Packet>(pktSize));
+        qdisc->Enqueue(item);
+        qdisc->Run();
+        Simulator::Schedule(m_cbrRate.CalculateBytesTxTime(pktSize), cbr);
+    };
+    if (m_cbrRate.GetBitRate() > 0)
+    {
+        Simulator::ScheduleNow(cbr);
+    }
+
+    // sample the background rate and the queue after the warmup
+    double rateSum = 0;
+    double workSum = 0;
+    uint32_t samples = 0;
+    std::function<void()> sample = [&]() {
+        rateSum += qdisc->GetBackgroundRate().GetBitRate();
+        workSum += qdisc->GetUnfinishedWork();
+        samples++;
+        Simulator::Schedule(MilliSeconds(10), sample);
+    };
+    Simulator::Schedule(warmup, sample);
+    Simulator::Stop(duration);
+    Simulator::Run();
+
+    double background = rateSum / samples / 1e6;
+    double foreground = sent * 8 / (duration - warmup).GetSeconds() / 1e6;
+    double expected = (linkRate.GetBitRate() - m_cbrRate.GetBitRate()) / 1e6;
+    NS_TEST_EXPECT_MSG_EQ_TOL(background, expected, 0.15 * 10, "Wrong background rate");
+    NS_TEST_EXPECT_MSG_GT(workSum / samples, 0, "The background flows should fill the queue");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(workSum / samples,
+                                100 * pktSize,
+                                "The queue should not exceed its max size");
+    NS_TEST_EXPECT_MSG_GT(qdisc->GetBackgroundWindow(group), 1, "Wrong background window");
+    NS_TEST_EXPECT_MSG_LT(qdisc->GetBackgroundWindow(group), 100, "Wrong background window");
+
+    if (m_cbrRate.GetBitRate() > 0)
+    {
+        // the packets are lost and delayed as the background fluid
+        double cbr = m_cbrRate.GetBitRate() / 1e6;
+        NS_TEST_EXPECT_MSG_EQ_TOL(foreground, cbr, 0.15 * cbr, "Wrong rate of the packets");
+        NS_TEST_EXPECT_MSG_GT(maxDelay, MilliSeconds(10), "The packets should be queued");
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(maxDelay,
+                                    linkRate.CalculateBytesTxTime(100 * pktSize),
+                                    "The packets should not wait more than a full queue");
+    }
+
+    qdisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Fluid Background Queue Disc Test Suite
+ */
+static class FluidBackgroundQueueDiscTestSuite : public TestSuite
+{
+  public:
+    FluidBackgroundQueueDiscTestSuite()
+        : TestSuite("fluid-background-queue-disc", Type::UNIT)
+    {
+        AddTestCase(new FluidBackgroundQueueDiscFifoTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new FluidBackgroundQueueDiscRateTestCase("Background flows only",
+                                                             DataRate("0bps")),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new FluidBackgroundQueueDiscRateTestCase("Background flows and packets",
+                                                             DataRate("4Mbps")),
+                    TestCase::Duration::QUICK);
+    }
+} g_fluidBackgroundQueueDiscTestSuite; ///< the test suite
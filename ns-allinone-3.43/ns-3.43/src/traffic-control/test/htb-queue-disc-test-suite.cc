@@ -0,0 +1,349 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/data-rate.h"
+#include "ns3/fifo-queue-disc.h"
+#include "ns3/htb-queue-disc.h"
+#include "ns3/integer.h"
+#include "ns3/packet-filter.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Htb Queue Disc Test Item
+ */
+class HtbQueueDiscTestItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet
+     * \param cls the index of the class of the packet
+     */
+    HtbQueueDiscTestItem(Ptr<Packet> p, int32_t cls);
+    void AddHeader() override;
+    bool Mark() override;
+
+    /**
+     * \return the index of the class of the packet
+     */
+    int32_t GetClass() const;
+
+  private:
+    int32_t m_class; //!< the index of the class of the packet
+};
+
+HtbQueueDiscTestItem::HtbQueueDiscTestItem(Ptr<Packet> p, int32_t cls)
+    : QueueDiscItem(p, Address(), 0),
+      m_class(cls)
+{
+}
+
+void
+HtbQueueDiscTestItem::AddHeader()
+{
+}
+
+bool
+HtbQueueDiscTestItem::Mark()
+{
+    return false;
+}
+
+int32_t
+HtbQueueDiscTestItem::GetClass() const
+{
+    return m_class;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Htb Queue Disc Test Packet Filter, returning the class of the test items
+ */
+class HtbQueueDiscTestFilter : public PacketFilter
+{
+  private:
+    bool CheckProtocol(Ptr<QueueDiscItem> item) const override;
+    int32_t DoClassify(Ptr<QueueDiscItem> item) const override;
+};
+
+bool
+HtbQueueDiscTestFilter::CheckProtocol(Ptr<QueueDiscItem> item) const
+{
+    return bool(DynamicCast<HtbQueueDiscTestItem>(item));
+}
+
+int32_t
+HtbQueueDiscTestFilter::DoClassify(Ptr<QueueDiscItem> item) const
+{
+    return DynamicCast<HtbQueueDiscTestItem>(item)->GetClass();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Htb Queue Disc Test Case: the backlogged leaf classes of a hierarchy
+ * get the expected rates, when the queue disc is woken up by a link faster
+ * than the root class or by its own watchdog.
+ */
+class HtbQueueDiscRateTestCase : public TestCase
+{
+  public:
+    /// The configuration of a class
+    struct ClassConfig
+    {
+        int32_t parent;   //!< the index of the parent class, or -1
+        DataRate rate;    //!< the assured rate
+        DataRate ceil;    //!< the maximum rate
+        uint8_t priority; //!< the priority
+        bool backlogged;  //!< whether packets are enqueued in the class
+        double expected;  //!< the expected rate of a leaf class, in Mbps (0 to skip the check)
+    };
+
+    /**
+     * Constructor
+     *
+     * \param name the name of the test case
+     * \param classes the configuration of the classes
+     * \param total the expected rate of all the classes, in Mbps
+     */
+    HtbQueueDiscRateTestCase(std::string name, std::vector<ClassConfig> classes, double total);
+
+  private:
+    void DoRun() override;
+
+    std::vector<ClassConfig> m_classes; //!< the configuration of the classes
+    double m_total;                     //!< the expected rate of all the classes, in Mbps
+};
+
+HtbQueueDiscRateTestCase::HtbQueueDiscRateTestCase(std::string name,
+                                                   std::vector<ClassConfig> classes,
+                                                   double total)
+    : TestCase(name),
+      m_classes(classes),
+      m_total(total)
+{
+}
+
+void
+HtbQueueDiscRateTestCase::DoRun()
+{
+    const uint32_t pktSize = 1000;
+    const Time duration = Seconds(2);
+
+    Ptr<HtbQueueDisc> qdisc = CreateObject<HtbQueueDisc>();
+    for (const auto& config : m_classes)
+    {
+        Ptr<FifoQueueDisc> child = CreateObject<FifoQueueDisc>();
+        child->SetMaxSize(QueueSize("10000p"));
+        child->Initialize();
+        Ptr<HtbClass> c = CreateObject<HtbClass>();
+        c->SetAttribute("Parent", IntegerValue(config.parent));
+        c->SetAttribute("Rate", DataRateValue(config.rate));
+        c->SetAttribute("Ceil", DataRateValue(config.ceil));
+        c->SetAttribute("Priority", UintegerValue(config.priority));
+        c->SetAttribute("Quantum", UintegerValue(1500));
+        c->SetQueueDisc(child);
+        qdisc->AddQueueDiscClass(c);
+    }
+    qdisc->AddPacketFilter(CreateObject<HtbQueueDiscTestFilter>());
+
+    // a 100 Mbps link runs the queue disc again at the end of each transmission
+    DataRate linkRate("100Mbps");
+    std::vector<uint64_t> bytes(m_classes.size(), 0);
+    uint64_t sent = 0;
+    qdisc->SetQuota(1);
+    qdisc->SetSendCallback([&](Ptr<QueueDiscItem> item) {
+        bytes[DynamicCast<HtbQueueDiscTestItem>(item)->GetClass()] += item->GetSize();
+        sent++;
+        Simulator::Schedule(linkRate.CalculateBytesTxTime(item->GetSize()), &QueueDisc::Run, qdisc);
+    });
+    qdisc->Initialize();
+
+    for (uint32_t i = 0; i < m_classes.size(); i++)
+    {
+        if (m_classes[i].backlogged)
+        {
+            // enough packets to keep the class backlogged at its maximum rate
+            uint64_t n = m_classes[i].ceil.GetBitRate() * duration.GetSeconds() / pktSize / 8;
+            for (uint64_t k = 0; k < n + 10; k++)
+            {
+                qdisc->Enqueue(Create<HtbQueueDiscTestItem>(Create<Packet>(pktSize), i));
+            }
+        }
+    }
+
+    // the queue disc is run once, then woken up by the link or by its watchdog
+    Simulator::ScheduleNow(&QueueDisc::Run, qdisc);
+    Simulator::Stop(duration);
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_GT(sent, 0, "No packet has been sent");
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < m_classes.size(); i++)
+    {
+        double rate = bytes[i] * 8 / duration.GetSeconds() / 1e6;
+        total += bytes[i];
+        if (m_classes[i].expected > 0)
+        {
+            NS_TEST_EXPECT_MSG_EQ_TOL(rate,
+                                      m_classes[i].expected,
+                                      m_classes[i].expected * 0.05,
+                                      "Wrong rate for class " << i);
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ_TOL(total * 8 / duration.GetSeconds() / 1e6,
+                              m_total,
+                              m_total * 0.05,
+                              "Wrong total rate");
+
+    qdisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Htb Queue Disc Test Case: the packets that are not classified into a
+ * leaf class are enqueued into the default class, if any, or dropped.
+ */
+class HtbQueueDiscClassifyTestCase : public TestCase
+{
+  public:
+    HtbQueueDiscClassifyTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+HtbQueueDiscClassifyTestCase::HtbQueueDiscClassifyTestCase()
+    : TestCase("Sanity check on the classification of the htb queue disc")
+{
+}
+
+void
+HtbQueueDiscClassifyTestCase::DoRun()
+{
+    for (int32_t defaultClass : {-1, 2})
+    {
+        Ptr<HtbQueueDisc> qdisc = CreateObject<HtbQueueDisc>();
+        qdisc->SetAttribute("DefaultClass", IntegerValue(defaultClass));
+        // class 0 is the parent of classes 1 and 2
+        for (int32_t parent : {-1, 0, 0})
+        {
+            Ptr<FifoQueueDisc> child = CreateObject<FifoQueueDisc>();
+            child->Initialize();
+            Ptr<HtbClass> c = CreateObject<HtbClass>();
+            c->SetAttribute("Parent", IntegerValue(parent));
+            c->SetQueueDisc(child);
+            qdisc->AddQueueDiscClass(c);
+        }
+        qdisc->AddPacketFilter(CreateObject<HtbQueueDiscTestFilter>());
+        qdisc->Initialize();
+
+        NS_TEST_ASSERT_MSG_EQ(DynamicCast<HtbClass>(qdisc->GetQueueDiscClass(0))->GetLevel(),
+                              1,
+                              "Wrong level of the inner class");
+        NS_TEST_ASSERT_MSG_EQ(DynamicCast<HtbClass>(qdisc->GetQueueDiscClass(1))->GetLevel(),
+                              0,
+                              "Wrong level of a leaf class");
+
+        // packets for a leaf class, an inner class and a missing class
+        for (int32_t cls : {1, 0, 5})
+        {
+            qdisc->Enqueue(Create<HtbQueueDiscTestItem>(Create<Packet>(100), cls));
+        }
+        NS_TEST_ASSERT_MSG_EQ(qdisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+                              1,
+                              "The leaf class should have a packet");
+        NS_TEST_ASSERT_MSG_EQ(qdisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+                              0,
+                              "The inner class cannot have packets");
+        NS_TEST_ASSERT_MSG_EQ(qdisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+                              (defaultClass < 0 ? 0 : 2),
+                              "Wrong number of packets in the default class");
+        NS_TEST_ASSERT_MSG_EQ(
+            qdisc->GetStats().GetNDroppedPackets(HtbQueueDisc::UNCLASSIFIED_DROP),
+            (defaultClass < 0 ? 2 : 0),
+            "Wrong number of unclassified packets dropped");
+
+        // the buckets allow sending all the packets at once
+        uint32_t n = qdisc->GetNPackets();
+        for (uint32_t i = 0; i < n; i++)
+        {
+            NS_TEST_ASSERT_MSG_NE(qdisc->Dequeue(), nullptr, "A packet should be dequeued");
+        }
+        NS_TEST_ASSERT_MSG_EQ(qdisc->Dequeue(), nullptr, "The queue disc should be empty");
+
+        qdisc->Dispose();
+        Simulator::Destroy();
+    }
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Htb Queue Disc Test Suite
+ */
+static class HtbQueueDiscTestSuite : public TestSuite
+{
+  public:
+    HtbQueueDiscTestSuite()
+        : TestSuite("htb-queue-disc", Type::UNIT)
+    {
+        using Config = HtbQueueDiscRateTestCase::ClassConfig;
+        DataRate r2("2Mbps");
+        DataRate r5("5Mbps");
+        DataRate r10("10Mbps");
+
+        AddTestCase(new HtbQueueDiscClassifyTestCase(), TestCase::Duration::QUICK);
+        // a single class is shaped to its rate
+        AddTestCase(new HtbQueueDiscRateTestCase("Rate of a single class",
+                                                 {Config{-1, r5, r5, 0, true, 5}},
+                                                 5),
+                    TestCase::Duration::QUICK);
+        // a class borrows up to its ceil
+        AddTestCase(new HtbQueueDiscRateTestCase("Ceil of a class",
+                                                 {Config{-1, r10, r10, 0, false, 0},
+                                                  Config{0, r2, r5, 0, true, 5},
+                                                  Config{0, r2, r10, 0, false, 0}},
+                                                 5),
+                    TestCase::Duration::QUICK);
+        // the classes borrowing share the unused rate of the parent, which is
+        // bounded by the rate of the parent
+        AddTestCase(new HtbQueueDiscRateTestCase("Sharing of the rate of the parent",
+                                                 {Config{-1, DataRate("6Mbps"), r10, 0, false, 0},
+                                                  Config{0, r2, r10, 0, true, 3},
+                                                  Config{0, r2, r10, 0, true, 3}},
+                                                 6),
+                    TestCase::Duration::QUICK);
+        // the classes with the highest priority borrow first
+        AddTestCase(new HtbQueueDiscRateTestCase("Priority among the classes borrowing",
+                                                 {Config{-1, r10, r10, 0, false, 0},
+                                                  Config{0, r2, r10, 1, true, 2},
+                                                  Config{0, r2, r10, 0, true, 8}},
+                                                 10),
+                    TestCase::Duration::QUICK);
+        // two subtrees of 50 leaf classes each share the rate of the root
+        std::vector<Config> classes{Config{-1, r10, r10, 0, false, 0},
+                                    Config{0, r5, r10, 0, false, 0},
+                                    Config{0, r5, r10, 0, false, 0}};
+        for (int32_t i = 0; i < 100; i++)
+        {
+            classes.push_back(Config{1 + i % 2, DataRate("50kbps"), r10, 0, true, 0.1});
+        }
+        AddTestCase(new HtbQueueDiscRateTestCase("Sharing among many classes", classes, 10),
+                    TestCase::Duration::QUICK);
+    }
+} g_htbQueueDiscTestSuite; ///< the test suite
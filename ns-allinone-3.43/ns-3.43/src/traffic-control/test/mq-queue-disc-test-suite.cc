@@ -0,0 +1,216 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/fifo-queue-disc.h"
+#include "ns3/mq-queue-disc.h"
+#include "ns3/packet-filter.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <array>
+#include <queue>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Mq Queue Disc Test Item
+ */
+class MqQueueDiscTestItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet
+     * \param addr the address
+     * \param hash the flow hash of the packet
+     */
+    MqQueueDiscTestItem(Ptr<Packet> p, const Address& addr, uint32_t hash);
+    void AddHeader() override;
+    bool Mark() override;
+    uint32_t Hash(uint32_t perturbation) const override;
+
+  private:
+    uint32_t m_hash; //!< the flow hash of the packet
+};
+
+MqQueueDiscTestItem::MqQueueDiscTestItem(Ptr<Packet> p, const Address& addr, uint32_t hash)
+    : QueueDiscItem(p, addr, 0),
+      m_hash(hash)
+{
+}
+
+void
+MqQueueDiscTestItem::AddHeader()
+{
+}
+
+bool
+MqQueueDiscTestItem::Mark()
+{
+    return false;
+}
+
+uint32_t
+MqQueueDiscTestItem::Hash(uint32_t perturbation) const
+{
+    return m_hash;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Mq Queue Disc Test Packet Filter
+ */
+class MqQueueDiscTestFilter : public PacketFilter
+{
+  public:
+    /**
+     * \brief Set the value returned by DoClassify
+     *
+     * \param ret the value that DoClassify returns
+     */
+    void SetReturnValue(int32_t ret);
+
+  private:
+    bool CheckProtocol(Ptr<QueueDiscItem> item) const override;
+    int32_t DoClassify(Ptr<QueueDiscItem> item) const override;
+
+    int32_t m_ret{PF_NO_MATCH}; //!< the value that DoClassify returns
+};
+
+void
+MqQueueDiscTestFilter::SetReturnValue(int32_t ret)
+{
+    m_ret = ret;
+}
+
+bool
+MqQueueDiscTestFilter::CheckProtocol(Ptr<QueueDiscItem> item) const
+{
+    return true;
+}
+
+int32_t
+MqQueueDiscTestFilter::DoClassify(Ptr<QueueDiscItem> item) const
+{
+    return m_ret;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Mq Queue Disc Test Case: the traffic is sharded among the child queue
+ * discs by flow hash or by packet filter, and the shards are drained in round
+ * robin, by batches.
+ */
+class MqQueueDiscShardingTestCase : public TestCase
+{
+  public:
+    MqQueueDiscShardingTestCase();
+    void DoRun() override;
+};
+
+MqQueueDiscShardingTestCase::MqQueueDiscShardingTestCase()
+    : TestCase("Sanity check on the sharding of the mq queue disc")
+{
+}
+
+void
+MqQueueDiscShardingTestCase::DoRun()
+{
+    Address dest;
+    std::array<std::queue<uint64_t>, 4> uids;
+
+    Ptr<MqQueueDisc> qdisc = CreateObject<MqQueueDisc>();
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetWakeMode(), QueueDisc::WAKE_CHILD, "Wrong default wake mode");
+    qdisc->SetAttribute("Sharding", BooleanValue(true));
+    qdisc->SetAttribute("BatchSize", UintegerValue(2));
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetWakeMode(),
+                          QueueDisc::WAKE_ROOT,
+                          "The traffic control layer must enqueue into the root when sharding");
+
+    // add 4 child fifo queue discs
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        Ptr<FifoQueueDisc> child = CreateObject<FifoQueueDisc>();
+        child->Initialize();
+        Ptr<QueueDiscClass> c = CreateObject<QueueDiscClass>();
+        c->SetQueueDisc(child);
+        qdisc->AddQueueDiscClass(c);
+    }
+    Ptr<MqQueueDiscTestFilter> pf = CreateObject<MqQueueDiscTestFilter>();
+    qdisc->AddPacketFilter(pf);
+    qdisc->Initialize();
+
+    // the high bits of the flow hash select the shard
+    for (uint32_t n = 0; n < 3; n++)
+    {
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            Ptr<QueueDiscItem> item =
+                Create<MqQueueDiscTestItem>(Create<Packet>(100), dest, (i << 30) | n);
+            qdisc->Enqueue(item);
+            uids[i].push(item->GetPacket()->GetUid());
+        }
+    }
+
+    // a packet filter overrides the flow hash, unless it returns an invalid shard
+    pf->SetReturnValue(3);
+    Ptr<QueueDiscItem> item = Create<MqQueueDiscTestItem>(Create<Packet>(100), dest, 0);
+    qdisc->Enqueue(item);
+    uids[3].push(item->GetPacket()->GetUid());
+    pf->SetReturnValue(4);
+    item = Create<MqQueueDiscTestItem>(Create<Packet>(100), dest, 1u << 31);
+    qdisc->Enqueue(item);
+    uids[2].push(item->GetPacket()->GetUid());
+
+    uint32_t expected[] = {3, 3, 4, 4};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(qdisc->GetQueueDiscClass(i)->GetQueueDisc()->GetNPackets(),
+                              expected[i],
+                              "Wrong number of packets in shard " << i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetNPackets(), 14, "Wrong number of packets in the root");
+
+    // the shards are drained in round robin, two packets at a time, and a peeked
+    // packet is the next one dequeued
+    uint32_t order[] = {0, 0, 1, 1, 2, 2, 3, 3, 0, 1, 2, 2, 3, 3};
+    for (uint32_t i = 0; i < 14; i++)
+    {
+        Ptr<const QueueDiscItem> peeked = qdisc->Peek();
+        item = qdisc->Dequeue();
+        NS_TEST_ASSERT_MSG_NE(item, nullptr, "A packet should have been dequeued");
+        NS_TEST_ASSERT_MSG_EQ(peeked, item, "The dequeued packet is not the peeked one");
+        NS_TEST_ASSERT_MSG_EQ(item->GetPacket()->GetUid(),
+                              uids[order[i]].front(),
+                              "Packet " << i << " not dequeued from shard " << order[i]);
+        uids[order[i]].pop();
+    }
+    NS_TEST_ASSERT_MSG_EQ(qdisc->Dequeue(), nullptr, "The queue disc should be empty");
+    NS_TEST_ASSERT_MSG_EQ(qdisc->GetNPackets(), 0, "The root should be empty");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Mq Queue Disc Test Suite
+ */
+static class MqQueueDiscTestSuite : public TestSuite
+{
+  public:
+    MqQueueDiscTestSuite()
+        : TestSuite("mq-queue-disc", Type::UNIT)
+    {
+        AddTestCase(new MqQueueDiscShardingTestCase(), TestCase::Duration::QUICK);
+    }
+} g_mqQueueTestSuite; ///< the test suite
@@ -9,6 +9,7 @@
  *
  */
 
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
@@ -830,6 +831,98 @@ PieQueueDiscTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Pie Queue Disc Lazy Update Test Case: the drop decisions taken with
+ * the lazy update of the drop probability are those taken with the periodic
+ * update event
+ */
+class PieQueueDiscLazyUpdateTestCase : public TestCase
+{
+  public:
+    PieQueueDiscLazyUpdateTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Run a congestion episode followed by an idle period and a second episode
+     * \param useLazyUpdate whether the drop probability is updated lazily
+     * \param useDqRateEstimator whether the dequeue rate estimator is used
+     * \return the outcome of each enqueue operation
+     */
+    std::vector<bool> RunScenario(bool useLazyUpdate, bool useDqRateEstimator);
+};
+
+PieQueueDiscLazyUpdateTestCase::PieQueueDiscLazyUpdateTestCase()
+    : TestCase("Check the lazy update of the drop probability of the pie queue disc")
+{
+}
+
+std::vector<bool>
+PieQueueDiscLazyUpdateTestCase::RunScenario(bool useLazyUpdate, bool useDqRateEstimator)
+{
+    Ptr<PieQueueDisc> queue = CreateObject<PieQueueDisc>();
+    queue->SetAttribute("MaxSize", QueueSizeValue(QueueSize("1000p")));
+    queue->SetAttribute("UseLazyUpdate", BooleanValue(useLazyUpdate));
+    queue->SetAttribute("UseDequeueRateEstimator", BooleanValue(useDqRateEstimator));
+    queue->AssignStreams(1);
+    queue->Initialize();
+
+    std::vector<bool> enqueued;
+    Address dest;
+    // packets arrive every ms and leave every 1.2 ms for 3 seconds, twice, the
+    // two episodes being separated by 5 seconds of idle time. The times are
+    // offset so that no operation takes place at the time of an update
+    for (Time start : {Seconds(0), Seconds(8)})
+    {
+        for (uint32_t i = 0; i < 3000; i++)
+        {
+            Simulator::Schedule(start + MilliSeconds(i) + MicroSeconds(1), [=, &enqueued]() {
+                enqueued.push_back(
+                    queue->Enqueue(Create<PieQueueDiscTestItem>(Create<Packet>(1000), dest, false)));
+            });
+        }
+        for (uint32_t i = 0; i < 2500; i++)
+        {
+            Simulator::Schedule(start + MicroSeconds(1200 * i + 2),
+                                [=]() { queue->Dequeue(); });
+        }
+        // drain the queue at the end of the episode
+        Simulator::Schedule(start + Seconds(3.5), [=]() {
+            while (queue->Dequeue())
+            {
+            }
+        });
+    }
+
+    Simulator::Stop(Seconds(12));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_GT(queue->GetStats().GetNDroppedPackets(PieQueueDisc::UNFORCED_DROP),
+                          0,
+                          "There should be some unforced drops");
+    return enqueued;
+}
+
+void
+PieQueueDiscLazyUpdateTestCase::DoRun()
+{
+    for (bool useDqRateEstimator : {false, true})
+    {
+        std::vector<bool> periodic = RunScenario(false, useDqRateEstimator);
+        std::vector<bool> lazy = RunScenario(true, useDqRateEstimator);
+        NS_TEST_ASSERT_MSG_EQ(lazy.size(), periodic.size(), "Wrong number of enqueue operations");
+        for (std::size_t i = 0; i < lazy.size(); i++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(lazy[i],
+                                  periodic[i],
+                                  "Different outcome of enqueue operation " << i);
+        }
+    }
+}
+
 /**
  * \ingroup traffic-control-test
  *
@@ -842,5 +935,6 @@ static class PieQueueDiscTestSuite : public TestSuite
         : TestSuite("pie-queue-disc", Type::UNIT)
     {
         AddTestCase(new PieQueueDiscTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new PieQueueDiscLazyUpdateTestCase(), TestCase::Duration::QUICK);
     }
 } g_pieQueueTestSuite; ///< the test suite
@@ -17,6 +17,8 @@
 #include "ns3/test.h"
 #include "ns3/uinteger.h"
 
+#include <cmath>
+
 using namespace ns3;
 
 /**
@@ -602,6 +604,85 @@ RedQueueDiscTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Red Queue Disc Queue Weight Test Case: the decay of the average queue
+ * size over an idle period follows the queue weight set at run time
+ */
+class RedQueueDiscQueueWeightTestCase : public TestCase
+{
+  public:
+    RedQueueDiscQueueWeightTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Drain the queue disc, wait for the given time, set the queue weight and
+     * check the average queue size computed at the next arrival
+     * \param queue the queue disc
+     * \param idle the duration of the idle period
+     * \param qW the queue weight to set
+     */
+    void CheckDecay(Ptr<RedQueueDisc> queue, Time idle, double qW);
+};
+
+RedQueueDiscQueueWeightTestCase::RedQueueDiscQueueWeightTestCase()
+    : TestCase("Check the decay of the average queue size when the queue weight changes")
+{
+}
+
+void
+RedQueueDiscQueueWeightTestCase::CheckDecay(Ptr<RedQueueDisc> queue, Time idle, double qW)
+{
+    Address dest;
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        queue->Enqueue(Create<RedQueueDiscTestItem>(Create<Packet>(500), dest, false));
+    }
+    // the queue disc becomes idle at the dequeue attempt on the empty queue
+    while (queue->Dequeue())
+    {
+    }
+    double qAvg = queue->m_qAvg;
+    NS_TEST_ASSERT_MSG_GT(qAvg, 0, "The average queue size should be positive");
+
+    Simulator::Schedule(idle, [=, this]() {
+        queue->SetAttribute("QW", DoubleValue(qW));
+        queue->Enqueue(Create<RedQueueDiscTestItem>(Create<Packet>(500), dest, false));
+        // the enqueued packet is not counted, as the queue was empty at its arrival
+        auto m = static_cast<uint32_t>(queue->m_ptc * idle.GetSeconds()) + 1;
+        double expected = qAvg * std::pow(1.0 - qW, m);
+        NS_TEST_EXPECT_MSG_EQ_TOL(queue->m_qAvg,
+                                  expected,
+                                  expected * 1e-12,
+                                  "Wrong decay of the average queue size with weight " << qW);
+        queue->Dequeue();
+    });
+    Simulator::Run();
+}
+
+void
+RedQueueDiscQueueWeightTestCase::DoRun()
+{
+    Ptr<RedQueueDisc> queue = CreateObject<RedQueueDisc>();
+    queue->SetAttribute("MaxSize", QueueSizeValue(QueueSize("100p")));
+    queue->SetAttribute("MinTh", DoubleValue(50));
+    queue->SetAttribute("MaxTh", DoubleValue(80));
+    queue->SetAttribute("QW", DoubleValue(0.002));
+    queue->Initialize();
+
+    CheckDecay(queue, MilliSeconds(20), 0.002);
+    CheckDecay(queue, MilliSeconds(20), 0.05);
+    CheckDecay(queue, MilliSeconds(300), 0.01);
+    CheckDecay(queue, MilliSeconds(300), 0.002);
+
+    NS_TEST_EXPECT_MSG_EQ(queue->GetStats().nTotalDroppedPackets,
+                          0,
+                          "No packet should have been dropped");
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup traffic-control-test
  *
@@ -614,5 +695,6 @@ static class RedQueueDiscTestSuite : public TestSuite
         : TestSuite("red-queue-disc", Type::UNIT)
     {
         AddTestCase(new RedQueueDiscTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new RedQueueDiscQueueWeightTestCase(), TestCase::Duration::QUICK);
     }
 } g_redQueueTestSuite; ///< the test suite
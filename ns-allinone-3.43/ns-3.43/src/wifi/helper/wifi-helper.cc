@@ -213,8 +213,7 @@ WifiPhyHelper::GetOrCreatePcapFile(const std::shared_ptr<PcapFilesInfo>& info, u
             tmp.insert(pos, "-" + std::to_string(fileIdx));
         }
 
-        PcapHelper pcapHelper;
-        auto file = pcapHelper.CreateFile(tmp, std::ios::out, info->pcapDlt);
+        auto file = info->pcapHelper.CreateFile(tmp, std::ios::out, info->pcapDlt);
         info->files.emplace(fileIdx, file);
     }
 
@@ -646,7 +645,7 @@ WifiPhyHelper::EnablePcapInternal(std::string prefix,
     NS_ABORT_MSG_IF(device->GetPhys().empty(),
                     "WifiPhyHelper::EnablePcapInternal(): Phy layer in WifiNetDevice must be set");
 
-    PcapHelper pcapHelper;
+    PcapHelper pcapHelper = GetPcapHelper();
     std::string filename;
     if (explicitFilename)
     {
@@ -657,7 +656,8 @@ WifiPhyHelper::EnablePcapInternal(std::string prefix,
         filename = pcapHelper.GetFilenameFromDevice(prefix, device);
     }
 
-    auto info = std::make_shared<PcapFilesInfo>(filename, m_pcapDlt, m_pcapType, device);
+    auto info =
+        std::make_shared<PcapFilesInfo>(filename, m_pcapDlt, m_pcapType, device, pcapHelper);
     for (auto& phy : device->GetPhys())
     {
         phy->TraceConnectWithoutContext(
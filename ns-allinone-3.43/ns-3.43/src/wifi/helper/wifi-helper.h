@@ -192,15 +192,18 @@ class WifiPhyHelper : public PcapHelperForDevice, public AsciiTraceHelperForDevi
          * \param dlt the selected data link type of the pcap file
          * \param type the selected PCAP capture type
          * \param dev the WifiNetDevice for which the PCAP files are generated
+         * \param helper the helper creating the PCAP files
          */
         PcapFilesInfo(const std::string& filename,
                       PcapHelper::DataLinkType dlt,
                       WifiPhyHelper::PcapCaptureType type,
-                      Ptr<WifiNetDevice> dev)
+                      Ptr<WifiNetDevice> dev,
+                      const PcapHelper& helper)
             : commonFilename{filename},
               pcapDlt{dlt},
               pcapType{type},
               device{dev},
+              pcapHelper{helper},
               files{}
         {
         }
@@ -209,6 +212,7 @@ class WifiPhyHelper : public PcapHelperForDevice, public AsciiTraceHelperForDevi
         PcapHelper::DataLinkType pcapDlt;        ///< the selected data link type of the pcap file
         WifiPhyHelper::PcapCaptureType pcapType; ///< the selected PCAP capture type
         Ptr<WifiNetDevice> device; ///< the WifiNetDevice for which the PCAP files are generated
+        PcapHelper pcapHelper;     ///< the helper creating the PCAP files
         std::map<uint8_t, Ptr<PcapFileWrapper>> files; ///< PCAP files indexed by PHY ID
     };
 
@@ -655,7 +655,7 @@ WimaxHelper::EnablePcapInternal(std::string prefix,
     }
 
     Ptr<WimaxPhy> phy = device->GetPhy();
-    PcapHelper pcapHelper;
+    PcapHelper pcapHelper = GetPcapHelper();
     std::string filename;
     if (explicitFilename)
     {
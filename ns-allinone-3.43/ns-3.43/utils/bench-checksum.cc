@@ -0,0 +1,156 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program can be used to benchmark the implementations of the Internet
+// checksum and of the CRC-32 supported by the CPU, for various input sizes.
+// Sample usage:  ./ns3 run 'bench-checksum --bytes=100000000'
+
+#include "ns3/buffer.h"
+#include "ns3/command-line.h"
+#include "ns3/crc32.h"
+#include "ns3/ip-checksum.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdlib.h> // for exit ()
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/// Input sizes, in bytes
+static const uint32_t g_sizes[] = {20, 64, 576, 1500, 9000, 65535};
+
+/// Sink for the results, so that the computations are not optimized out
+static volatile uint32_t g_sink;
+
+/**
+ * Run a function enough times to process the given number of bytes, and
+ * return the smallest elapsed time over several iterations.
+ *
+ * \param fn the function, called with the number of bytes to process
+ * \param minIterations the number of iterations
+ * \returns the elapsed time, in milliseconds
+ */
+template <typename F>
+static uint64_t
+runBench(F fn, uint32_t minIterations)
+{
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        SystemWallClockMs time;
+        time.Start();
+        fn();
+        minDelay = std::min(minDelay, static_cast<uint64_t>(time.End()));
+    }
+    return std::max<uint64_t>(minDelay, 1);
+}
+
+/**
+ * Print a result line.
+ *
+ * \param name the name of the implementation
+ * \param size the input size
+ * \param bytes the number of bytes processed
+ * \param delay the elapsed time, in milliseconds
+ */
+static void
+printResult(const std::string& name, uint32_t size, uint64_t bytes, uint64_t delay)
+{
+    double gbps = bytes * 8.0 / delay / 1e6;
+    std::cout << std::setw(12) << name << std::setw(8) << size << std::setw(12) << std::fixed
+              << std::setprecision(2) << gbps << " Gb/s (" << delay << " ms elapsed)"
+              << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t bytes = 0;
+    uint32_t minIterations = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the Internet checksum and CRC-32 implementations");
+    cmd.AddValue("bytes", "number of bytes processed for each size", bytes);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    if (bytes == 0)
+    {
+        std::cerr << "Error-- number of bytes must be specified "
+                  << "by command-line argument --bytes=(number of bytes)" << std::endl;
+        exit(1);
+    }
+
+    std::vector<uint8_t> data(g_sizes[std::size(g_sizes) - 1]);
+    for (std::size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = i * 7 + 3;
+    }
+
+    std::cout << "Internet checksum (IpChecksumAdd)" << std::endl;
+    for (const auto& name : GetIpChecksumAddImplementations())
+    {
+        IpChecksumAddFunction impl = GetIpChecksumAddImplementation(name);
+        for (uint32_t size : g_sizes)
+        {
+            uint64_t n = bytes / size;
+            uint64_t delay = runBench(
+                [&]() {
+                    for (uint64_t i = 0; i < n; i++)
+                    {
+                        g_sink = impl(data.data(), size);
+                    }
+                },
+                minIterations);
+            printResult(name, size, n * size, delay);
+        }
+    }
+
+    std::cout << "Internet checksum (Buffer::Iterator::CalculateIpChecksum)" << std::endl;
+    for (uint32_t size : g_sizes)
+    {
+        // half of the bytes are written, the other half is a virtual zero area
+        Buffer buffer(size - size / 2);
+        buffer.AddAtStart(size / 2);
+        buffer.Begin().Write(data.data(), size / 2);
+        uint64_t n = bytes / size;
+        uint64_t delay = runBench(
+            [&]() {
+                for (uint64_t i = 0; i < n; i++)
+                {
+                    g_sink = buffer.Begin().CalculateIpChecksum(size);
+                }
+            },
+            minIterations);
+        printResult("buffer", size, n * size, delay);
+    }
+
+    std::cout << "CRC-32 (CRC32Calculate)" << std::endl;
+    for (const auto& name : GetCRC32Implementations())
+    {
+        CRC32Function impl = GetCRC32Implementation(name);
+        for (uint32_t size : g_sizes)
+        {
+            uint64_t n = bytes / size;
+            uint64_t delay = runBench(
+                [&]() {
+                    for (uint64_t i = 0; i < n; i++)
+                    {
+                        g_sink = impl(data.data(), size);
+                    }
+                },
+                minIterations);
+            printResult(name, size, n * size, delay);
+        }
+    }
+
+    return 0;
+}
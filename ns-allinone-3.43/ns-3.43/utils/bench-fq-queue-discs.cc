@@ -0,0 +1,125 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program can be used to benchmark the enqueue and dequeue operations of
+// the flow queueing disciplines (FqCoDel, FqPie and FqCobalt) with many
+// concurrent flows.
+// Sample usage:  ./ns3 run 'bench-fq-queue-discs --packets=1000000 --flows=1024'
+
+#include "ns3/command-line.h"
+#include "ns3/fq-cobalt-queue-disc.h"
+#include "ns3/fq-codel-queue-disc.h"
+#include "ns3/fq-pie-queue-disc.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/mac48-address.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/udp-header.h"
+#include "ns3/uinteger.h"
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdlib.h> // for exit ()
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Enqueue a backlog of packets spread over the given number of flows, then
+ * repeatedly dequeue a packet and enqueue it again, so that the backlog and
+ * the set of active flows stay constant.
+ *
+ * \tparam T the type of the queue disc
+ * \param name the name of the queue disc
+ * \param flows the number of flows
+ * \param backlog the number of packets in the queue disc
+ * \param packets the number of packets dequeued and enqueued again
+ */
+template <typename T>
+static void
+runBench(const std::string& name, uint32_t flows, uint32_t backlog, uint32_t packets)
+{
+    Ptr<T> queueDisc = CreateObject<T>();
+    queueDisc->SetAttribute("MaxSize", QueueSizeValue(QueueSize(QueueSizeUnit::PACKETS, backlog)));
+    // Enough flow queues for few hash collisions between the flows
+    queueDisc->SetAttribute("Flows", UintegerValue(4 * flows));
+    queueDisc->SetQuantum(1500);
+    queueDisc->Initialize();
+
+    // The items are created in advance and recycled, to only measure the queue disc
+    std::mt19937 rng(1);
+    std::vector<Ptr<QueueDiscItem>> pool;
+    for (uint32_t i = 0; i < backlog; i++)
+    {
+        uint32_t flow = rng() % flows;
+        Ptr<Packet> p = Create<Packet>(1000);
+        UdpHeader udpHdr;
+        udpHdr.SetSourcePort(1024 + flow % 50000);
+        udpHdr.SetDestinationPort(9);
+        p->AddHeader(udpHdr);
+        Ipv4Header hdr;
+        hdr.SetSource(Ipv4Address(0x0a000000 + flow / 50000));
+        hdr.SetDestination(Ipv4Address("10.255.0.1"));
+        hdr.SetProtocol(17);
+        hdr.SetPayloadSize(p->GetSize());
+        pool.push_back(Create<Ipv4QueueDiscItem>(p, Mac48Address::GetBroadcast(), 0, hdr));
+    }
+
+    SystemWallClockMs time;
+    time.Start();
+    for (const auto& item : pool)
+    {
+        queueDisc->Enqueue(item);
+    }
+    uint64_t dequeued = 0;
+    for (uint32_t i = 0; i < packets; i++)
+    {
+        Ptr<QueueDiscItem> item = queueDisc->Dequeue();
+        if (!item)
+        {
+            break;
+        }
+        dequeued++;
+        queueDisc->Enqueue(item);
+    }
+    uint64_t delay = std::max<uint64_t>(time.End(), 1);
+
+    std::cout << std::setw(10) << name << std::setw(12) << dequeued / delay << " packets/ms ("
+              << delay << " ms elapsed, " << queueDisc->GetNFlows() << " flow queues, "
+              << queueDisc->GetStats().nTotalDroppedPackets << " packets dropped)" << std::endl;
+
+    queueDisc->Dispose();
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t packets = 0;
+    uint32_t flows = 1024;
+    uint32_t backlog = 10000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the flow queueing disciplines (FqCoDel, FqPie and FqCobalt)");
+    cmd.AddValue("packets", "number of packets dequeued", packets);
+    cmd.AddValue("flows", "number of concurrent flows", flows);
+    cmd.AddValue("backlog", "number of packets in the queue disc", backlog);
+    cmd.Parse(argc, argv);
+
+    if (packets == 0 || flows == 0 || backlog == 0)
+    {
+        std::cerr << "Error-- number of packets must be specified "
+                  << "by command-line argument --packets=(number of packets)" << std::endl;
+        exit(1);
+    }
+
+    runBench<FqCoDelQueueDisc>("FqCoDel", flows, backlog, packets);
+    runBench<FqPieQueueDisc>("FqPie", flows, backlog, packets);
+    runBench<FqCobaltQueueDisc>("FqCobalt", flows, backlog, packets);
+
+    return 0;
+}
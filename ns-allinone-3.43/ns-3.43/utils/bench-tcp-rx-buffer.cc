@@ -0,0 +1,132 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program can be used to benchmark the TCP reassembly buffer with
+// in-order, reordered and lossy arrivals of segments.
+// Sample usage:  ./ns3 run 'bench-tcp-rx-buffer --segments=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-rx-buffer.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdlib.h> // for exit ()
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Feed a receive buffer with segments in the given order, extracting the
+ * in-order data as soon as it is available.
+ *
+ * \param name the name of the workload
+ * \param order the indices of the segments, in arrival order
+ * \param segmentSize the size of the segments
+ * \param window the size of the receive buffer, in segments
+ */
+static void
+runBench(const std::string& name,
+         const std::vector<uint32_t>& order,
+         uint32_t segmentSize,
+         uint32_t window)
+{
+    Ptr<TcpRxBuffer> rxBuf = CreateObject<TcpRxBuffer>();
+    rxBuf->SetMaxBufferSize(window * segmentSize);
+    rxBuf->SetNextRxSequence(SequenceNumber32(0));
+    Ptr<Packet> segment = Create<Packet>(segmentSize);
+    TcpHeader h;
+    uint64_t sackBlocks = 0;
+    uint64_t extracted = 0;
+
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i : order)
+    {
+        h.SetSequenceNumber(SequenceNumber32(i * segmentSize));
+        rxBuf->Add(segment, h);
+        sackBlocks += rxBuf->GetSackListSize();
+        if (rxBuf->Available() > 0)
+        {
+            extracted += rxBuf->Extract(rxBuf->Available())->GetSize();
+        }
+    }
+    uint64_t delay = std::max<uint64_t>(time.End(), 1);
+
+    std::cout << std::setw(12) << name << std::setw(12) << order.size() / delay << " segments/ms ("
+              << delay << " ms elapsed, " << extracted << " bytes extracted, "
+              << static_cast<double>(sackBlocks) / order.size() << " SACK blocks per segment)"
+              << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t segments = 0;
+    uint32_t segmentSize = 1448;
+    uint32_t window = 1000;
+    uint32_t lossInterval = 10;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the TCP reassembly buffer (TcpRxBuffer)");
+    cmd.AddValue("segments", "number of segments received", segments);
+    cmd.AddValue("segment-size", "size of the segments, in bytes", segmentSize);
+    cmd.AddValue("window", "size of the receive window, in segments", window);
+    cmd.AddValue("loss-interval", "one segment out of this many is lost once", lossInterval);
+    cmd.Parse(argc, argv);
+
+    if (segments == 0 || window < 2 || lossInterval == 0)
+    {
+        std::cerr << "Error-- number of segments must be specified "
+                  << "by command-line argument --segments=(number of segments)" << std::endl;
+        exit(1);
+    }
+
+    std::vector<uint32_t> order(segments);
+    for (uint32_t i = 0; i < segments; i++)
+    {
+        order[i] = i;
+    }
+    runBench("in-order", order, segmentSize, window);
+
+    // Shuffle the segments within consecutive blocks of half a window
+    std::mt19937 rng(1);
+    for (uint32_t i = 0; i < segments; i += window / 2)
+    {
+        std::shuffle(order.begin() + i,
+                     order.begin() + std::min(i + window / 2, segments),
+                     rng);
+    }
+    runBench("reordered", order, segmentSize, window);
+
+    // Lose segments once, and retransmit them after half a window: the
+    // buffer holds many out-of-order ranges
+    order.clear();
+    std::vector<uint32_t> lost;
+    for (uint32_t i = 0; i < segments; i++)
+    {
+        if (i % lossInterval == lossInterval / 2)
+        {
+            lost.push_back(i);
+        }
+        else
+        {
+            order.push_back(i);
+        }
+        if (!lost.empty() && lost.front() + window / 2 <= i)
+        {
+            order.push_back(lost.front());
+            lost.erase(lost.begin());
+        }
+    }
+    order.insert(order.end(), lost.begin(), lost.end());
+    runBench("lossy", order, segmentSize, window);
+
+    return 0;
+}